@@ -50,6 +50,7 @@
 #include "saischeduler.h"
 #include "saistp.h"
 #include "saiswitch.h"
+#include "saitelemetry.h"
 #include "saitunnel.h"
 #include "saiudf.h"
 #include "saivlan.h"
@@ -109,6 +110,7 @@ typedef enum _sai_api_t
     SAI_API_L2MC_GROUP       = 30, /**< sai_l2mc_group_api_t */
     SAI_API_IPMC_GROUP       = 31, /**< sai_ipmc_group_api_t */
     SAI_API_MCAST_FDB        = 32, /**< sai_mcast_fdb_api_t */
+    SAI_API_TELEMETRY        = 33, /**< sai_telemetry_api_t */
 } sai_api_t;
 
 /**
@@ -152,6 +152,28 @@ typedef sai_status_t(*sai_clear_ingress_priority_group_stats_fn)(
         _In_ const sai_ingress_priority_group_stat_t *counter_ids,
         _In_ uint32_t number_of_counters);
 
+/**
+ * @brief Get statistics counters of several ingress priority groups in one call.
+ *
+ * All the counters are read from one snapshot, so the values of the
+ * different priority groups and counters are consistent with each other.
+ *
+ * @param[in] number_of_pgs Number of ingress priority groups in the array
+ * @param[in] ingress_pg_ids Array of ingress priority group ids
+ * @param[in] counter_ids Specifies the array of counter ids, read for each priority group
+ * @param[in] number_of_counters Number of counters in the array
+ * @param[out] counters Matrix of resulting counter values, number_of_pgs
+ * rows of number_of_counters values, in the order of ingress_pg_ids and counter_ids
+ *
+ * @return #SAI_STATUS_SUCCESS on success Failure status code on error
+ */
+typedef sai_status_t(*sai_get_ingress_priority_group_stats_bulk_fn)(
+        _In_ uint32_t number_of_pgs,
+        _In_ const sai_object_id_t *ingress_pg_ids,
+        _In_ const sai_ingress_priority_group_stat_t *counter_ids,
+        _In_ uint32_t number_of_counters,
+        _Out_ uint64_t* counters);
+
 /**
  * @brief Enum defining buffer pool types.
  */
@@ -535,6 +557,7 @@ typedef struct _sai_buffer_api_t
     sai_remove_buffer_profile_fn               remove_buffer_profile;
     sai_set_buffer_profile_attr_fn             set_buffer_profile_attr;
     sai_get_buffer_profile_attr_fn             get_buffer_profile_attr;
+    sai_get_ingress_priority_group_stats_bulk_fn get_ingress_priority_group_stats_bulk;
 } sai_buffer_api_t;
 
 /**
@@ -416,6 +416,28 @@ typedef enum _sai_hostif_trap_attr_t
 
 } sai_hostif_trap_attr_t;
 
+/**
+ * @brief Enum defining host interface trap statistics
+ */
+typedef enum _sai_hostif_trap_stat_t
+{
+    /** Packets punted to the CPU [uint64_t] */
+    SAI_HOSTIF_TRAP_STAT_PACKETS = 0x00000000,
+
+    /** Packets dropped, the trap group being disabled [uint64_t] */
+    SAI_HOSTIF_TRAP_STAT_ADMIN_DROPPED_PACKETS = 0x00000001,
+
+    /** Packets dropped by the trap group policer [uint64_t] */
+    SAI_HOSTIF_TRAP_STAT_POLICER_DROPPED_PACKETS = 0x00000002,
+
+    /** Packets dropped, the CPU queue being full [uint64_t] */
+    SAI_HOSTIF_TRAP_STAT_QUEUE_DROPPED_PACKETS = 0x00000003,
+
+    /** Custom range base value */
+    SAI_HOSTIF_TRAP_STAT_CUSTOM_RANGE_BASE = 0x10000000
+
+} sai_hostif_trap_stat_t;
+
 /**
  * @brief Create host interface trap
  *
@@ -468,6 +490,22 @@ typedef sai_status_t(*sai_get_hostif_trap_attribute_fn)(
         _In_ uint32_t attr_count,
         _Inout_ sai_attribute_t *attr_list);
 
+/**
+ * @brief Get trap statistics.
+ *
+ * @param[in] hostif_trap_id Host interface trap id
+ * @param[in] counter_ids Array of counter ids
+ * @param[in] number_of_counters Number of counters in the array
+ * @param[out] counters Array of resulting counter values.
+ *
+ * @return #SAI_STATUS_SUCCESS on success Failure status code on error
+ */
+typedef sai_status_t(*sai_get_hostif_trap_stats_fn)(
+        _In_ sai_object_id_t hostif_trap_id,
+        _In_ const sai_hostif_trap_stat_t *counter_ids,
+        _In_ uint32_t number_of_counters,
+        _Out_ uint64_t *counters);
+
 /**
  * @brief Host interface user defined trap ID table range
  */
@@ -836,6 +874,50 @@ typedef sai_status_t(*sai_send_hostif_packet_fn)(
         _In_ uint32_t attr_count,
         _In_ sai_attribute_t *attr_list);
 
+/**
+ * @brief Packet buffer of the batched hostif receive and send functions
+ */
+typedef struct _sai_hostif_packet_t
+{
+    /** Packet buffer */
+    void *buffer;
+
+    /** Allocated buffer size on receive, packet size in bytes on send, set to the packet size on receive */
+    sai_size_t buffer_size;
+
+} sai_hostif_packet_t;
+
+/**
+ * @brief Hostif batched receive function, receiving the packets ready without waiting
+ *
+ * @param[in] hif_id Host interface id
+ * @param[inout] count Number of packets [in], number of packets received [out]
+ * @param[inout] packets Array of packet buffers, their buffer_size set to the packet size
+ *
+ * @return #SAI_STATUS_SUCCESS on success, count may be 0. #SAI_STATUS_BUFFER_OVERFLOW
+ * if the first packet is larger than its buffer, buffer_size will be filled with
+ * required size and the packet kept. Failure status code on error
+ */
+typedef sai_status_t(*sai_recv_hostif_packets_fn)(
+        _In_ sai_object_id_t hif_id,
+        _Inout_ uint32_t *count,
+        _Inout_ sai_hostif_packet_t *packets);
+
+/**
+ * @brief Hostif batched send function, sending the packets without waiting
+ *
+ * @param[in] hif_id Host interface id
+ * @param[inout] count Number of packets [in], number of packets sent [out]
+ * @param[in] packets Array of packet buffers and sizes
+ *
+ * @return #SAI_STATUS_SUCCESS on success, count is less than asked once the
+ * host interface can't take more. Failure status code on error
+ */
+typedef sai_status_t(*sai_send_hostif_packets_fn)(
+        _In_ sai_object_id_t hif_id,
+        _Inout_ uint32_t *count,
+        _In_ const sai_hostif_packet_t *packets);
+
 /**
  * @brief Hostif receive callback
  *
@@ -873,6 +955,9 @@ typedef struct _sai_hostif_api_t
     sai_get_hostif_user_defined_trap_attribute_fn  get_user_defined_trap_attribute;
     sai_recv_hostif_packet_fn                      recv_packet;
     sai_send_hostif_packet_fn                      send_packet;
+    sai_recv_hostif_packets_fn                     recv_packets;
+    sai_send_hostif_packets_fn                     send_packets;
+    sai_get_hostif_trap_stats_fn                   get_trap_stats;
 } sai_hostif_api_t;
 
 /**
@@ -109,8 +109,14 @@ typedef enum _sai_next_hop_group_member_attr_t
 
     /**
      * @brief Next hop id
+     *
+     * A next hop group may be used as member of another next hop group,
+     * creating a two level hierarchy. Changes to the member group then apply
+     * to all groups using it, without updating them. A group used as member
+     * can't have next hop group members itself.
+     *
      * @type sai_object_id_t
-     * @objects SAI_OBJECT_TYPE_NEXT_HOP
+     * @objects SAI_OBJECT_TYPE_NEXT_HOP, SAI_OBJECT_TYPE_NEXT_HOP_GROUP
      * @flags MANDATORY_ON_CREATE | CREATE_ONLY
      */
     SAI_NEXT_HOP_GROUP_MEMBER_ATTR_NEXT_HOP_ID,
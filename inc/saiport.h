@@ -1535,6 +1535,28 @@ typedef sai_status_t (*sai_clear_port_stats_fn)(
 typedef sai_status_t (*sai_clear_port_all_stats_fn)(
         _In_ sai_object_id_t port_id);
 
+/**
+ * @brief Get statistics counters of several ports in one call.
+ *
+ * All the counters are read from one snapshot, so the values of the
+ * different ports and counters are consistent with each other.
+ *
+ * @param[in] number_of_ports Number of ports in the array
+ * @param[in] port_ids Array of port ids
+ * @param[in] counter_ids Specifies the array of counter ids, read for each port
+ * @param[in] number_of_counters Number of counters in the array
+ * @param[out] counters Matrix of resulting counter values, number_of_ports
+ * rows of number_of_counters values, in the order of port_ids and counter_ids
+ *
+ * @return #SAI_STATUS_SUCCESS on success Failure status code on error
+ */
+typedef sai_status_t (*sai_get_port_stats_bulk_fn)(
+        _In_ uint32_t number_of_ports,
+        _In_ const sai_object_id_t *port_ids,
+        _In_ const sai_port_stat_t *counter_ids,
+        _In_ uint32_t number_of_counters,
+        _Out_ uint64_t *counters);
+
 /**
  * @brief Port state change notification
  *
@@ -1559,6 +1581,7 @@ typedef struct _sai_port_api_t
     sai_get_port_stats_fn           get_port_stats;
     sai_clear_port_stats_fn         clear_port_stats;
     sai_clear_port_all_stats_fn     clear_port_all_stats;
+    sai_get_port_stats_bulk_fn      get_port_stats_bulk;
 
 } sai_port_api_t;
 
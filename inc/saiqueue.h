@@ -242,6 +242,12 @@ typedef enum _sai_queue_stat_t
     /** get watermark queue shared occupancy in bytes [uint64_t] */
     SAI_QUEUE_STAT_SHARED_WATERMARK_BYTES = 0x0000001b,
 
+    /** get WRED ECN marked packets count [uint64_t] */
+    SAI_QUEUE_STAT_WRED_ECN_MARKED_PACKETS = 0x0000001c,
+
+    /** get WRED ECN marked bytes count [uint64_t] */
+    SAI_QUEUE_STAT_WRED_ECN_MARKED_BYTES = 0x0000001d,
+
     /** Custom range base value */
     SAI_QUEUE_STAT_CUSTOM_RANGE_BASE = 0x10000000
 
@@ -330,6 +336,28 @@ typedef sai_status_t (*sai_clear_queue_stats_fn)(
         _In_ const sai_queue_stat_t *counter_ids,
         _In_ uint32_t number_of_counters);
 
+/**
+ * @brief Get statistics counters of several queues in one call.
+ *
+ * All the counters are read from one snapshot, so the values of the
+ * different queues and counters are consistent with each other.
+ *
+ * @param[in] number_of_queues Number of queues in the array
+ * @param[in] queue_ids Array of queue ids
+ * @param[in] counter_ids Specifies the array of counter ids, read for each queue
+ * @param[in] number_of_counters Number of counters in the array
+ * @param[out] counters Matrix of resulting counter values, number_of_queues
+ * rows of number_of_counters values, in the order of queue_ids and counter_ids
+ *
+ * @return #SAI_STATUS_SUCCESS on success Failure status code on error
+ */
+typedef sai_status_t (*sai_get_queue_stats_bulk_fn)(
+        _In_ uint32_t number_of_queues,
+        _In_ const sai_object_id_t *queue_ids,
+        _In_ const sai_queue_stat_t *counter_ids,
+        _In_ uint32_t number_of_counters,
+        _Out_ uint64_t *counters);
+
 /**
  * @brief Qos methods table retrieved with sai_api_query()
  */
@@ -341,6 +369,7 @@ typedef struct _sai_queue_api_t
     sai_get_queue_attribute_fn   get_queue_attribute;
     sai_get_queue_stats_fn       get_queue_stats;
     sai_clear_queue_stats_fn     clear_queue_stats;
+    sai_get_queue_stats_bulk_fn  get_queue_stats_bulk;
 
 } sai_queue_api_t;
 
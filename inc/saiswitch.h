@@ -368,6 +368,10 @@ typedef enum _sai_switch_attr_t
     /**
      * @brief Oper state
      *
+     * Initialization may complete after switch initialize or connect
+     * returned. The oper state is then DOWN until it is done, and goes UP,
+     * or FAILED if it failed, with a switch state change notification.
+     *
      * @type sai_switch_oper_status_t
      * @flags READ_ONLY
      */
@@ -1197,6 +1201,28 @@ typedef enum _sai_switch_attr_t
     */
     SAI_SWITCH_ATTR_FAST_API_ENABLE,
 
+    /**
+     * @brief ECMP group sharing ratio
+     *
+     * Next hop groups with identical next hops and weights share a single
+     * ECMP group. Number of non empty next hop groups per ECMP group in use,
+     * in hundredths (100 when no group is shared).
+     *
+     * @type sai_uint32_t
+     * @flags READ_ONLY
+     */
+    SAI_SWITCH_ATTR_ECMP_GROUP_DEDUP_RATIO,
+
+    /**
+     * @brief Number of ECMP groups saved by sharing
+     *
+     * Non empty next hop groups minus ECMP groups in use.
+     *
+     * @type sai_uint32_t
+     * @flags READ_ONLY
+     */
+    SAI_SWITCH_ATTR_ECMP_GROUP_DEDUP_SAVED,
+
     /**
      * @brief End of attributes
      */
@@ -1347,6 +1373,10 @@ typedef void (*sai_switch_state_change_notification_fn)(
  *   ready for retrieval via sai_get_switch_attribute(). Same Switch Object id should be
  *   given for create/connect for each NPU.
  *
+ *   Initialization the SDK completes in the background is not reflected in the
+ *   returned status; its failure is reported by #SAI_SWITCH_ATTR_OPER_STATUS going
+ *   FAILED, with a switch state change notification.
+ *
  * @param[out] switch_id The Switch Object ID
  * @param[in] attr_count number of attributes
  * @param[in] attr_list Array of attributes
@@ -0,0 +1,237 @@
+/**
+ * Copyright (c) 2014 Microsoft Open Technologies, Inc.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ *    Microsoft would like to thank the following companies for their review and
+ *    assistance with these files: Intel Corporation, Mellanox Technologies Ltd,
+ *    Dell Products, L.P., Facebook, Inc
+ *
+ * @file    saitelemetry.h
+ *
+ * @brief   This module defines SAI Telemetry interface
+ *
+ * A telemetry subscription has the switch push the counters of a set of
+ * objects at a fixed interval, instead of the application polling them with
+ * the get stats functions. Each sample is sent as one record datagram to a
+ * local UNIX domain socket bound by the application.
+ *
+ * A record is a #sai_telemetry_record_header_t followed by one value per
+ * counter of each object, objects and counters in the order of the
+ * subscription lists. Each value is the difference with the value of the
+ * same counter in the previous record, zigzag encoded then written as an
+ * unsigned LEB128 varint, so counters which did not move take one byte.
+ * Values of a record flagged #SAI_TELEMETRY_RECORD_FLAG_KEYFRAME are
+ * differences with 0, that is the counter values themselves. The first
+ * record of a subscription is a keyframe, and so is the record following
+ * one the switch could not send, so a decoder only needs to keep the values
+ * of the last record.
+ *
+ * Watermark counters are kept per subscription: a record carries the
+ * watermark reached since the previous record of the subscription the
+ * switch could send, and the watermark then restarts from the current
+ * occupancy. Subscriptions on the same objects do not reset each other's
+ * watermarks, and no peak is lost with a record the switch could not send.
+ */
+
+#if !defined (__SAITELEMETRY_H_)
+#define __SAITELEMETRY_H_
+
+#include <saitypes.h>
+
+/**
+ * @defgroup SAITELEMETRY SAI - Telemetry specific public APIs and datastructures
+ *
+ * @{
+ */
+
+/**
+ * @brief Version of the telemetry record format
+ */
+#define SAI_TELEMETRY_RECORD_VERSION 1
+
+/**
+ * @brief Maximum length of the telemetry socket path, including the terminating null byte
+ */
+#define SAI_TELEMETRY_SOCKET_PATH_SIZE 32
+
+/**
+ * @brief Flags of a telemetry record
+ */
+typedef enum _sai_telemetry_record_flag_t
+{
+    /** Values are the counters themselves, not differences with the previous record */
+    SAI_TELEMETRY_RECORD_FLAG_KEYFRAME = 1 << 0,
+
+} sai_telemetry_record_flag_t;
+
+/**
+ * @brief Header of a telemetry record, in host byte order
+ */
+typedef struct _sai_telemetry_record_header_t
+{
+    /** Record format version, #SAI_TELEMETRY_RECORD_VERSION */
+    uint16_t version;
+
+    /** Record flags, #sai_telemetry_record_flag_t */
+    uint16_t flags;
+
+    /** Record sequence number in the subscription, a gap means records were lost */
+    uint32_t sequence;
+
+    /** Telemetry subscription id */
+    sai_object_id_t subscription_id;
+
+    /** Sampling time, in nanoseconds since the epoch */
+    uint64_t timestamp;
+
+    /** Number of objects in the record */
+    uint32_t object_count;
+
+    /** Number of counters per object in the record */
+    uint32_t counter_count;
+
+} sai_telemetry_record_header_t;
+
+/**
+ * @brief SAI attributes of telemetry subscription
+ */
+typedef enum _sai_telemetry_subscription_attr_t
+{
+    /**
+     * @brief Start of attributes
+     */
+    SAI_TELEMETRY_SUBSCRIPTION_ATTR_START,
+
+    /**
+     * @brief Objects whose counters are pushed
+     *
+     * All the objects must be of the same type.
+     *
+     * @type sai_object_list_t
+     * @flags MANDATORY_ON_CREATE | CREATE_ONLY
+     * @objects SAI_OBJECT_TYPE_PORT, SAI_OBJECT_TYPE_QUEUE, SAI_OBJECT_TYPE_INGRESS_PRIORITY_GROUP
+     */
+    SAI_TELEMETRY_SUBSCRIPTION_ATTR_OBJECT_LIST = SAI_TELEMETRY_SUBSCRIPTION_ATTR_START,
+
+    /**
+     * @brief Counters pushed for each object
+     *
+     * Counter ids of the objects type, #sai_port_stat_t for ports,
+     * #sai_queue_stat_t for queues and #sai_ingress_priority_group_stat_t
+     * for ingress priority groups.
+     *
+     * @type sai_s32_list_t
+     * @flags MANDATORY_ON_CREATE | CREATE_ONLY
+     */
+    SAI_TELEMETRY_SUBSCRIPTION_ATTR_COUNTER_LIST,
+
+    /**
+     * @brief Path of the UNIX domain datagram socket records are sent to [char[SAI_TELEMETRY_SOCKET_PATH_SIZE]]
+     *
+     * @type char
+     * @flags MANDATORY_ON_CREATE | CREATE_ONLY
+     */
+    SAI_TELEMETRY_SUBSCRIPTION_ATTR_SOCKET_PATH,
+
+    /**
+     * @brief Sampling interval in microseconds
+     *
+     * @type sai_uint32_t
+     * @flags CREATE_AND_SET
+     * @default 100000
+     */
+    SAI_TELEMETRY_SUBSCRIPTION_ATTR_INTERVAL,
+
+    /**
+     * @brief End of attributes
+     */
+    SAI_TELEMETRY_SUBSCRIPTION_ATTR_END,
+
+} sai_telemetry_subscription_attr_t;
+
+/**
+ * @brief Create telemetry subscription.
+ *
+ * The counters of the objects are read once on create, and the watermarks
+ * of the subscription start from the current occupancy.
+ *
+ * @param[out] subscription_id Telemetry subscription id
+ * @param[in] switch_id Switch id
+ * @param[in] attr_count Number of attributes
+ * @param[in] attr_list Value of attributes
+ *
+ * @return #SAI_STATUS_SUCCESS if operation is successful otherwise a different
+ * error code is returned.
+ */
+typedef sai_status_t (*sai_create_telemetry_subscription_fn)(
+        _Out_ sai_object_id_t *subscription_id,
+        _In_ sai_object_id_t switch_id,
+        _In_ uint32_t attr_count,
+        _In_ const sai_attribute_t *attr_list);
+
+/**
+ * @brief Remove telemetry subscription.
+ *
+ * @param[in] subscription_id Telemetry subscription id
+ *
+ * @return #SAI_STATUS_SUCCESS if operation is successful otherwise a different
+ * error code is returned.
+ */
+typedef sai_status_t (*sai_remove_telemetry_subscription_fn)(
+        _In_ sai_object_id_t subscription_id);
+
+/**
+ * @brief Set telemetry subscription attribute.
+ *
+ * @param[in] subscription_id Telemetry subscription id
+ * @param[in] attr Value of attribute
+ *
+ * @return #SAI_STATUS_SUCCESS if operation is successful otherwise a different
+ * error code is returned.
+ */
+typedef sai_status_t (*sai_set_telemetry_subscription_attribute_fn)(
+        _In_ sai_object_id_t subscription_id,
+        _In_ const sai_attribute_t *attr);
+
+/**
+ * @brief Get telemetry subscription attributes.
+ *
+ * @param[in] subscription_id Telemetry subscription id
+ * @param[in] attr_count Number of attributes
+ * @param[inout] attr_list Value of attribute
+ *
+ * @return #SAI_STATUS_SUCCESS if operation is successful otherwise a different
+ * error code is returned.
+ */
+typedef sai_status_t (*sai_get_telemetry_subscription_attribute_fn)(
+        _In_ sai_object_id_t subscription_id,
+        _In_ uint32_t attr_count,
+        _Inout_ sai_attribute_t *attr_list);
+
+/**
+ * @brief Telemetry method table retrieved with sai_api_query()
+ */
+typedef struct _sai_telemetry_api_t
+{
+    sai_create_telemetry_subscription_fn        create_telemetry_subscription;
+    sai_remove_telemetry_subscription_fn        remove_telemetry_subscription;
+    sai_set_telemetry_subscription_attribute_fn set_telemetry_subscription_attribute;
+    sai_get_telemetry_subscription_attribute_fn get_telemetry_subscription_attribute;
+
+} sai_telemetry_api_t;
+
+/**
+ * @}
+ */
+#endif /** __SAITELEMETRY_H_ */
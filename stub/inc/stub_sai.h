@@ -28,6 +28,7 @@
 #include <assert.h>
 
 extern service_method_table_t           g_services;
+extern sai_switch_notification_t        g_notification_callbacks;
 extern const sai_route_api_t            route_api;
 extern const sai_virtual_router_api_t   router_api;
 extern const sai_switch_api_t           switch_api;
@@ -39,6 +40,26 @@ extern const sai_next_hop_group_api_t   next_hop_group_api;
 extern const sai_router_interface_api_t router_interface_api;
 extern const sai_vlan_api_t             vlan_api;
 extern const sai_hostif_api_t           host_interface_api;
+extern const sai_policer_api_t          policer_api;
+extern const sai_wred_api_t             wred_api;
+extern const sai_queue_api_t            queue_api;
+extern const sai_scheduler_api_t        scheduler_api;
+extern const sai_scheduler_group_api_t  scheduler_group_api;
+extern const sai_buffer_api_t           buffer_api;
+extern const sai_qos_map_api_t          qos_map_api;
+extern const sai_samplepacket_api_t     samplepacket_api;
+extern const sai_mirror_api_t           mirror_api;
+extern const sai_tunnel_api_t           tunnel_api;
+extern const sai_udf_api_t              udf_api;
+extern const sai_rpf_group_api_t        rpf_group_api;
+extern const sai_ipmc_group_api_t       ipmc_group_api;
+extern const sai_l2mc_group_api_t       l2mc_group_api;
+extern const sai_ipmc_api_t             ipmc_api;
+extern const sai_l2mc_api_t             l2mc_api;
+extern const sai_mcast_fdb_api_t        mcast_fdb_api;
+extern const sai_stp_api_t              stp_api;
+extern const sai_lag_api_t              lag_api;
+extern const sai_telemetry_api_t        telemetry_api;
 
 /*
  *  SAI operation type
@@ -78,7 +99,10 @@ typedef enum _sai_attribute_value_type_t {
     SAI_ATTR_VAL_TYPE_VLANLIST,
     SAI_ATTR_VAL_TYPE_ACLFIELD,
     SAI_ATTR_VAL_TYPE_ACLACTION,
-    SAI_ATTR_VAL_TYPE_PORTBREAKOUT
+    SAI_ATTR_VAL_TYPE_PORTBREAKOUT,
+    SAI_ATTR_VAL_TYPE_QOSMAP,
+    SAI_ATTR_VAL_TYPE_TUNNELMAP,
+    SAI_ATTR_VAL_TYPE_U8LIST
 } sai_attribute_value_type_t;
 typedef struct _sai_attribute_entry_t {
     sai_attr_id_t              id;
@@ -103,13 +127,13 @@ static __attribute__((__used__)) const char *sai_type2str_arr[] = {
     /* SAI_OBJECT_TYPE_NULL = 0 */
     "NULL type",
 
-    /*SAI_OBJECT_TYPE_PORT = 1 */
+    /* SAI_OBJECT_TYPE_PORT = 1 */
     "Port type",
 
-    /*SAI_OBJECT_TYPE_LAG = 2 */
+    /* SAI_OBJECT_TYPE_LAG = 2 */
     "LAG type",
 
-    /*SAI_OBJECT_TYPE_VIRTUAL_ROUTER = 3 */
+    /* SAI_OBJECT_TYPE_VIRTUAL_ROUTER = 3 */
     "Virtual router type",
 
     /* SAI_OBJECT_TYPE_NEXT_HOP = 4 */
@@ -130,25 +154,157 @@ static __attribute__((__used__)) const char *sai_type2str_arr[] = {
     /* SAI_OBJECT_TYPE_ACL_COUNTER = 9 */
     "ACL counter type",
 
-    /* SAI_OBJECT_TYPE_HOST_INTERFACE = 10 */
+    /* SAI_OBJECT_TYPE_ACL_RANGE = 10 */
+    "ACL range type",
+
+    /* SAI_OBJECT_TYPE_ACL_TABLE_GROUP = 11 */
+    "ACL table group type",
+
+    /* SAI_OBJECT_TYPE_ACL_TABLE_GROUP_MEMBER = 12 */
+    "ACL table group member type",
+
+    /* SAI_OBJECT_TYPE_HOSTIF = 13 */
     "Host interface type",
 
-    /* SAI_OBJECT_TYPE_MIRROR = 11 */
+    /* SAI_OBJECT_TYPE_MIRROR_SESSION = 14 */
     "Mirror type",
 
-    /* SAI_OBJECT_TYPE_SAMPLEPACKET = 12 */
+    /* SAI_OBJECT_TYPE_SAMPLEPACKET = 15 */
     "Sample packet type",
 
-    /* SAI_OBJECT_TYPE_STP_INSTANCE = 13 */
-    "Stp instance type"
+    /* SAI_OBJECT_TYPE_STP = 16 */
+    "Stp instance type",
+
+    /* SAI_OBJECT_TYPE_HOSTIF_TRAP_GROUP = 17 */
+    "Host interface trap group type",
+
+    /* SAI_OBJECT_TYPE_POLICER = 18 */
+    "Policer type",
+
+    /* SAI_OBJECT_TYPE_WRED = 19 */
+    "WRED type",
+
+    /* SAI_OBJECT_TYPE_QOS_MAP = 20 */
+    "QoS map type",
+
+    /* SAI_OBJECT_TYPE_QUEUE = 21 */
+    "Queue type",
+
+    /* SAI_OBJECT_TYPE_SCHEDULER = 22 */
+    "Scheduler type",
+
+    /* SAI_OBJECT_TYPE_SCHEDULER_GROUP = 23 */
+    "Scheduler group type",
+
+    /* SAI_OBJECT_TYPE_BUFFER_POOL = 24 */
+    "Buffer pool type",
+
+    /* SAI_OBJECT_TYPE_BUFFER_PROFILE = 25 */
+    "Buffer profile type",
+
+    /* SAI_OBJECT_TYPE_INGRESS_PRIORITY_GROUP = 26 */
+    "Ingress priority group type",
+
+    /* SAI_OBJECT_TYPE_LAG_MEMBER = 27 */
+    "LAG member type",
+
+    /* SAI_OBJECT_TYPE_HASH = 28 */
+    "Hash type",
+
+    /* SAI_OBJECT_TYPE_UDF = 29 */
+    "UDF type",
+
+    /* SAI_OBJECT_TYPE_UDF_MATCH = 30 */
+    "UDF match type",
+
+    /* SAI_OBJECT_TYPE_UDF_GROUP = 31 */
+    "UDF group type",
+
+    /* SAI_OBJECT_TYPE_FDB_ENTRY = 32 */
+    "FDB entry type",
+
+    /* SAI_OBJECT_TYPE_SWITCH = 33 */
+    "Switch type",
+
+    /* SAI_OBJECT_TYPE_HOSTIF_TRAP = 34 */
+    "Host interface trap type",
+
+    /* SAI_OBJECT_TYPE_HOSTIF_USER_DEFINED_TRAP = 35 */
+    "Host interface user defined trap type",
+
+    /* SAI_OBJECT_TYPE_NEIGHBOR_ENTRY = 36 */
+    "Neighbor entry type",
+
+    /* SAI_OBJECT_TYPE_ROUTE_ENTRY = 37 */
+    "Route entry type",
+
+    /* SAI_OBJECT_TYPE_VLAN = 38 */
+    "Vlan type",
+
+    /* SAI_OBJECT_TYPE_VLAN_MEMBER = 39 */
+    "Vlan member type",
+
+    /* SAI_OBJECT_TYPE_HOSTIF_PACKET = 40 */
+    "Host interface packet type",
+
+    /* SAI_OBJECT_TYPE_TUNNEL_MAP = 41 */
+    "Tunnel map type",
+
+    /* SAI_OBJECT_TYPE_TUNNEL = 42 */
+    "Tunnel type",
+
+    /* SAI_OBJECT_TYPE_TUNNEL_TERM_TABLE_ENTRY = 43 */
+    "Tunnel term table entry type",
 
-    /* SAI_OBJECT_TYPE_MAX = 14 */
+    /* SAI_OBJECT_TYPE_FDB_FLUSH = 44 */
+    "FDB flush type",
+
+    /* SAI_OBJECT_TYPE_NEXT_HOP_GROUP_MEMBER = 45 */
+    "Next hop group member type",
+
+    /* SAI_OBJECT_TYPE_STP_PORT = 46 */
+    "Stp port type",
+
+    /* SAI_OBJECT_TYPE_RPF_GROUP = 47 */
+    "RPF group type",
+
+    /* SAI_OBJECT_TYPE_RPF_GROUP_MEMBER = 48 */
+    "RPF group member type",
+
+    /* SAI_OBJECT_TYPE_L2MC_GROUP = 49 */
+    "L2MC group type",
+
+    /* SAI_OBJECT_TYPE_L2MC_GROUP_MEMBER = 50 */
+    "L2MC group member type",
+
+    /* SAI_OBJECT_TYPE_IPMC_GROUP = 51 */
+    "IPMC group type",
+
+    /* SAI_OBJECT_TYPE_IPMC_GROUP_MEMBER = 52 */
+    "IPMC group member type",
+
+    /* SAI_OBJECT_TYPE_L2MC_ENTRY = 53 */
+    "L2MC entry type",
+
+    /* SAI_OBJECT_TYPE_IPMC_ENTRY = 54 */
+    "IPMC entry type",
+
+    /* SAI_OBJECT_TYPE_MCAST_FDB_ENTRY = 55 */
+    "Multicast FDB entry type",
+
+    /* SAI_OBJECT_TYPE_TELEMETRY_SUBSCRIPTION = 56 */
+    "Telemetry subscription type"
+
+    /* SAI_OBJECT_TYPE_MAX = 57 */
 };
 
 typedef union {
     const sai_fdb_entry_t          * fdb_entry;
     const sai_neighbor_entry_t     * neighbor_entry;
     const sai_unicast_route_entry_t* unicast_route_entry;
+    const sai_ipmc_entry_t         * ipmc_entry;
+    const sai_l2mc_entry_t         * l2mc_entry;
+    const sai_mcast_fdb_entry_t    * mcast_fdb_entry;
     const sai_vlan_id_t              vlan_id;
     const sai_object_id_t            object_id;
 } sai_object_key_t;
@@ -200,7 +356,12 @@ sai_status_t sai_get_attributes(_In_ const sai_object_key_t             *key,
 #define MAX_VALUE_STR_LEN      100
 #define MAX_LIST_VALUE_STR_LEN 1000
 
-#define PORT_NUMBER 32
+#define PORT_NUMBER 64
+
+/* Cores which may forward packets concurrently, each with its own core index */
+#define STUB_CORES      8
+/* Per core state is aligned to cache lines so that no two cores write the same line */
+#define CACHE_LINE_SIZE 64
 
 sai_status_t sai_value_to_str(_In_ sai_attribute_value_t      value,
                               _In_ sai_attribute_value_type_t type,
@@ -224,13 +385,623 @@ sai_status_t stub_object_to_type(sai_object_id_t object_id, sai_object_type_t ty
 sai_status_t stub_create_object(sai_object_type_t type, uint32_t data, sai_object_id_t *object_id);
 
 void db_init_next_hop_group();
-sai_status_t db_get_next_hop_group(_In_ uint32_t next_hop_group_id, _Out_ sai_object_list_t *next_hop_list);
+sai_status_t db_next_hop_group_select(_In_ uint32_t         next_hop_group_id,
+                                      _In_ uint32_t         hash,
+                                      _Out_ sai_object_id_t *next_hop_id);
+void db_next_hop_group_sharing_get(_Out_ uint32_t *group_count,
+                                   _Out_ uint32_t *ecmp_group_count,
+                                   _Out_ uint32_t *ecmp_group_capacity);
 void db_init_vlan();
+/* Flush the dynamic FDB entries of the VLANs set in the 4096 bit vlans bitmap, learned on the ports set in ports */
+void db_fdb_flush_vlans(_In_ const uint64_t *vlans, _In_ uint64_t ports);
+sai_status_t db_policer_meter(_In_ uint32_t                  policer_id,
+                              _In_ uint32_t                  core,
+                              _In_ uint64_t                  now_ns,
+                              _In_ uint32_t                  count,
+                              _In_ const uint32_t           *lengths,
+                              _In_ const sai_packet_color_t *in_colors,
+                              _Out_ sai_packet_color_t      *colors,
+                              _Out_ sai_packet_action_t     *actions);
+sai_status_t db_policer_ref(_In_ uint32_t policer_id, _In_ bool add);
+
+#define MAX_POLICER_NUMBER 256
+/* Policer counters are indexed by counter id */
+#define POLICER_STAT_ROW   (SAI_POLICER_STAT_RED_BYTES + 1)
+
+/* MAX_POLICER_NUMBER rows of POLICER_STAT_ROW counters */
+void db_policer_stats_all_get(_Out_ uint64_t *counters);
+
+sai_status_t db_port_speed_get(_In_ uint32_t port_id, _Out_ uint32_t *speed);
+
+/* Port counters are indexed by counter id, up to the last one counted */
+#define PORT_STAT_COUNT (SAI_PORT_STAT_IPV6_OUT_DISCARDS + 1)
+
+typedef enum _stub_port_cast_t {
+    PORT_CAST_UNICAST,
+    PORT_CAST_MULTICAST,
+    PORT_CAST_BROADCAST
+} stub_port_cast_t;
+
+sai_status_t db_port_stats_rx(_In_ uint32_t         core,
+                              _In_ uint32_t         port_id,
+                              _In_ uint32_t         length,
+                              _In_ stub_port_cast_t cast);
+sai_status_t db_port_stats_tx(_In_ uint32_t         core,
+                              _In_ uint32_t         port_id,
+                              _In_ uint32_t         length,
+                              _In_ stub_port_cast_t cast);
+sai_status_t db_port_stats_discard(_In_ uint32_t core, _In_ uint32_t port_id, _In_ bool ingress);
+/* PORT_NUMBER rows of PORT_STAT_COUNT counters */
+void db_port_stats_all_get(_Out_ uint64_t *counters);
+sai_status_t db_port_stats_sample(_In_ sai_object_id_t port_id,
+                                  _In_ uint32_t        subscription,
+                                  _In_ const int32_t  *counter_ids,
+                                  _In_ uint32_t        number_of_counters,
+                                  _Out_ uint64_t      *counters);
+sai_status_t db_port_watermarks_restart(_In_ sai_object_id_t port_id, _In_ uint32_t subscription);
+
+typedef enum _stub_wred_verdict_t {
+    STUB_WRED_ACCEPT,
+    STUB_WRED_MARK,
+    STUB_WRED_DROP
+} stub_wred_verdict_t;
+
+sai_status_t db_wred_check(_In_ uint32_t              wred_id,
+                           _In_ sai_packet_color_t    color,
+                           _In_ uint64_t              average_bytes,
+                           _In_ bool                  ecn_capable,
+                           _In_ uint32_t              random,
+                           _Out_ stub_wred_verdict_t *verdict);
+sai_status_t db_wred_weight_get(_In_ uint32_t wred_id, _Out_ uint8_t *weight);
+sai_status_t db_wred_ref(_In_ uint32_t wred_id, _In_ bool add);
+
+typedef struct _stub_packet_t {
+    uint32_t           length;
+    sai_packet_color_t color;
+    bool               ecn_capable;
+    bool               ecn_marked;
+    /* Set when the packet holds ingress buffer of a priority group, released when it leaves */
+    bool               ingress_accounted;
+    uint32_t           ingress_pg_id;
+    /* Mirror copy, not mirrored again */
+    bool               mirrored;
+} stub_packet_t;
+
+#define MAX_QUEUE_NUMBER 1024
+#define QUEUE_MAX_INDEX  16
+#define QUEUE_STAT_COUNT (SAI_QUEUE_STAT_WRED_ECN_MARKED_BYTES + 1)
+/* Queue counter rows hold the counters indexed by counter id, then the custom ones */
+#define QUEUE_STAT_ROW   (QUEUE_STAT_COUNT + 1)
+
+/* Custom queue counters */
+typedef enum _stub_queue_stat_t {
+    /* Transmitted bits per second since the counter was cleared */
+    STUB_QUEUE_STAT_TX_BANDWIDTH = SAI_QUEUE_STAT_CUSTOM_RANGE_BASE
+} stub_queue_stat_t;
+
+void db_init_port_queues();
+sai_status_t db_queue_find(_In_ uint32_t port_id, _In_ uint8_t index, _Out_ uint32_t *queue_id);
+sai_status_t db_queue_port_queues_get(_In_ uint32_t port_id, _Out_ uint32_t *queue_ids, _Inout_ uint32_t *count);
+sai_status_t db_queue_enqueue(_In_ uint32_t          queue_id,
+                              _Inout_ stub_packet_t *packet,
+                              _In_ uint32_t          random,
+                              _Out_ bool            *accepted);
+sai_status_t db_queue_dequeue(_In_ uint32_t queue_id, _Out_ stub_packet_t *packet, _Out_ bool *dequeued);
+sai_status_t db_queue_depth_get(_In_ uint32_t queue_id, _Out_ uint32_t *packets);
+sai_status_t db_queue_info_get(_In_ uint32_t          queue_id,
+                               _Out_ uint8_t         *index,
+                               _Out_ sai_object_id_t *parent,
+                               _Out_ sai_object_id_t *scheduler_profile);
+/* MAX_QUEUE_NUMBER rows of QUEUE_STAT_ROW counters */
+void db_queue_stats_all_get(_Out_ uint64_t *counters);
+sai_status_t db_queue_stats_sample(_In_ sai_object_id_t queue_id,
+                                   _In_ uint32_t        subscription,
+                                   _In_ const int32_t  *counter_ids,
+                                   _In_ uint32_t        number_of_counters,
+                                   _Out_ uint64_t      *counters);
+sai_status_t db_queue_watermarks_restart(_In_ sai_object_id_t queue_id, _In_ uint32_t subscription);
+uint64_t db_queue_port_watermark_sample(_In_ uint32_t port_id, _In_ uint32_t subscription);
+void db_queue_port_watermark_restart(_In_ uint32_t port_id, _In_ uint32_t subscription);
+
+typedef struct _stub_scheduler_params_t {
+    sai_scheduling_type_t type;
+    uint8_t               weight;
+    sai_meter_type_t      meter_type;
+    uint64_t              min_rate;
+    uint64_t              min_burst;
+    uint64_t              max_rate;
+    uint64_t              max_burst;
+} stub_scheduler_params_t;
+
+void db_scheduler_defaults(_Out_ stub_scheduler_params_t *params);
+sai_status_t db_scheduler_get(_In_ uint32_t scheduler_id, _Out_ stub_scheduler_params_t *params);
+sai_status_t db_scheduler_ref(_In_ uint32_t scheduler_id, _In_ bool add);
+
+#define SCHEDULER_GROUP_MAX_LEVELS 8
+#define SCHEDULER_GROUP_MAX_CHILDS 64
+
+sai_status_t db_scheduler_group_attach(_In_ sai_object_id_t group, _In_ uint32_t port_id, _In_ bool add);
+sai_status_t db_scheduler_group_port_groups_get(_In_ uint32_t    port_id,
+                                                _Out_ uint32_t  *group_ids,
+                                                _Inout_ uint32_t *count);
+sai_status_t db_scheduler_group_info_get(_In_ uint32_t          group_id,
+                                         _Out_ sai_object_id_t *parent,
+                                         _Out_ sai_object_id_t *scheduler_profile);
+
+void db_hqos_invalidate();
+sai_status_t db_hqos_queue_backlogged(_In_ uint32_t port_id, _In_ uint32_t queue_id, _In_ uint64_t now_ns);
+sai_status_t db_hqos_dequeue(_In_ uint32_t        port_id,
+                             _In_ uint64_t        now_ns,
+                             _Out_ stub_packet_t *packet,
+                             _Out_ bool          *dequeued,
+                             _Out_ uint64_t      *wakeup_ns);
+
+#define BUFFER_PG_PER_PORT 8
+#define BUFFER_PG_NUMBER   (PORT_NUMBER * BUFFER_PG_PER_PORT)
+/* Priority group counter rows hold the counters indexed by counter id, then the custom ones */
+#define BUFFER_PG_STAT_ROW (SAI_INGRESS_PRIORITY_GROUP_STAT_XOFF_ROOM_WATERMARK_BYTES + 3)
+
+/* Custom ingress priority group counters */
+typedef enum _stub_ingress_priority_group_stat_t {
+    /* Transitions to XOFF, each sending PFC pause to the peer */
+    STUB_INGRESS_PRIORITY_GROUP_STAT_XOFF_EVENTS = SAI_INGRESS_PRIORITY_GROUP_STAT_CUSTOM_RANGE_BASE,
+    /* Packets fitting neither the shared buffer nor the headroom */
+    STUB_INGRESS_PRIORITY_GROUP_STAT_DROPPED_PACKETS
+} stub_ingress_priority_group_stat_t;
+
+void db_init_buffer();
+sai_status_t db_buffer_port_priority_groups_get(_In_ uint32_t         port_id,
+                                                _Out_ sai_object_id_t *pgs,
+                                                _Inout_ uint32_t      *count);
+sai_status_t db_buffer_ingress_admit(_In_ uint32_t          port_id,
+                                     _In_ uint8_t           pg_index,
+                                     _Inout_ stub_packet_t *packet,
+                                     _Out_ bool            *admitted,
+                                     _Out_ bool            *xoff);
+void db_buffer_ingress_release(_In_ const stub_packet_t *packet);
+bool db_buffer_xon_pop(_Out_ uint32_t *port_id, _Out_ uint8_t *pg_index);
+sai_status_t db_buffer_egress_admit(_In_ uint32_t queue_id, _In_ uint32_t length, _Out_ bool *admitted);
+void db_buffer_egress_release(_In_ uint32_t queue_id, _In_ uint32_t length);
+sai_status_t db_buffer_queue_profile_set(_In_ uint32_t queue_id, _In_ sai_object_id_t profile);
+/* BUFFER_PG_NUMBER rows of BUFFER_PG_STAT_ROW counters */
+void db_buffer_pg_stats_all_get(_Out_ uint64_t *counters);
+sai_status_t db_buffer_pg_stats_sample(_In_ sai_object_id_t ingress_pg_id,
+                                       _In_ uint32_t        subscription,
+                                       _In_ const int32_t  *counter_ids,
+                                       _In_ uint32_t        number_of_counters,
+                                       _Out_ uint64_t      *counters);
+sai_status_t db_buffer_pg_watermarks_restart(_In_ sai_object_id_t ingress_pg_id, _In_ uint32_t subscription);
+
+/* Packet header fields used by the port QoS maps */
+typedef struct _stub_qos_header_t {
+    bool    is_ip;
+    bool    tagged;
+    uint8_t dscp;
+    uint8_t dot1p;
+} stub_qos_header_t;
+
+/* Ingress classification of a packet, color is a sai_packet_color_t */
+typedef struct _stub_qos_class_t {
+    uint8_t tc;
+    uint8_t queue_index;
+    uint8_t priority_group;
+    uint8_t color;
+} stub_qos_class_t;
+
+sai_status_t db_qos_map_port_bind(_In_ uint32_t port_id, _In_ sai_qos_map_type_t type, _In_ sai_object_id_t map);
+sai_status_t db_qos_map_port_bound_get(_In_ uint32_t           port_id,
+                                       _In_ sai_qos_map_type_t type,
+                                       _Out_ sai_object_id_t  *map);
+sai_status_t db_qos_map_port_default_tc_set(_In_ uint32_t port_id, _In_ uint8_t tc);
+sai_status_t db_qos_map_port_default_tc_get(_In_ uint32_t port_id, _Out_ uint8_t *tc);
+sai_status_t db_qos_map_classify(_In_ uint32_t                 core,
+                                 _In_ uint32_t                 port_id,
+                                 _In_ uint32_t                 count,
+                                 _In_ const stub_qos_header_t *headers,
+                                 _Out_ stub_qos_class_t       *classes);
+sai_status_t db_qos_map_remark(_In_ uint32_t                core,
+                               _In_ uint32_t                port_id,
+                               _In_ uint32_t                count,
+                               _In_ const stub_qos_class_t *classes,
+                               _Inout_ stub_qos_header_t   *headers);
+sai_status_t db_qos_map_pfc_priority_get(_In_ uint32_t  core,
+                                         _In_ uint32_t  port_id,
+                                         _In_ uint8_t   priority,
+                                         _Out_ uint8_t *queue_index,
+                                         _Out_ uint8_t *priority_group);
+
+/* Bytes of the sampled packets copied to the host */
+#define SAMPLEPACKET_HEADER_SIZE 128
+
+typedef struct _stub_sample_t {
+    uint32_t port_id;
+    bool     ingress;
+    /* Frame length, and number of its first bytes in header */
+    uint32_t length;
+    uint32_t header_length;
+    /* Sampler rate, packets it has observed and samples it has dropped, as in an sFlow flow sample */
+    uint32_t rate;
+    uint64_t sample_pool;
+    uint64_t drops;
+    uint8_t  header[SAMPLEPACKET_HEADER_SIZE];
+} stub_sample_t;
+
+sai_status_t db_samplepacket_port_bind(_In_ uint32_t port_id, _In_ bool ingress, _In_ sai_object_id_t session);
+sai_status_t db_samplepacket_port_bound_get(_In_ uint32_t         port_id,
+                                            _In_ bool             ingress,
+                                            _Out_ sai_object_id_t *session);
+sai_status_t db_samplepacket_sample(_In_ uint32_t              port_id,
+                                    _In_ bool                  ingress,
+                                    _In_ uint32_t              count,
+                                    _In_ const uint32_t       *lengths,
+                                    _In_ const uint8_t* const *headers);
+bool db_samplepacket_peek(_Out_ const stub_sample_t **sample);
+void db_samplepacket_pop();
+
+/* Mirror sessions per port and direction */
+#define MIRROR_PORT_SESSIONS 4
+/* Room for the largest encapsulation, Ethernet, VLAN, IPv6, GRE and ERSPAN headers */
+#define MIRROR_HEADROOM      96
+
+/* Packet bytes, shared by the packet and its mirror copies */
+typedef struct _stub_mirror_buf_t {
+    uint32_t ref_count;
+    uint32_t length;
+    uint8_t  data[];
+} stub_mirror_buf_t;
+
+/* Mirror copy, header followed by length bytes of buf from offset */
+typedef struct _stub_mirror_packet_t {
+    stub_mirror_buf_t *buf;
+    uint32_t           offset;
+    uint32_t           length;
+    uint32_t           header_length;
+    uint8_t            header[MIRROR_HEADROOM];
+    uint32_t           monitor_port_id;
+    uint8_t            tc;
+} stub_mirror_packet_t;
+
+sai_status_t db_mirror_buf_alloc(_In_ uint32_t length, _Out_ stub_mirror_buf_t **buf);
+void db_mirror_buf_release(_In_ stub_mirror_buf_t *buf);
+sai_status_t db_mirror_port_clone(_In_ uint32_t               core,
+                                  _In_ uint32_t               port_id,
+                                  _In_ bool                   ingress,
+                                  _In_ stub_mirror_buf_t     *buf,
+                                  _In_ uint32_t               length,
+                                  _Out_ stub_mirror_packet_t *clones,
+                                  _Out_ uint32_t             *count);
+void db_mirror_packet_release(_Inout_ stub_mirror_packet_t *clone);
+sai_status_t db_mirror_session_stats_get(_In_ sai_object_id_t session_id,
+                                         _Out_ uint64_t       *packets,
+                                         _Out_ uint64_t       *bytes);
+sai_status_t db_mirror_port_sessions_set(_In_ uint32_t                port_id,
+                                         _In_ bool                    ingress,
+                                         _In_ const sai_object_list_t *sessions);
+sai_status_t db_mirror_port_sessions_get(_In_ uint32_t             port_id,
+                                         _In_ bool                 ingress,
+                                         _Inout_ sai_object_list_t *sessions);
+
+/* Room for the largest tunnel header, IPv6 and GRE with key */
+#define TUNNEL_HEADROOM 48
+
+/* Packet from its IP header on, with headroom bytes free in front of data */
+typedef struct _stub_tunnel_packet_t {
+    uint8_t *data;
+    uint32_t length;
+    uint32_t headroom;
+} stub_tunnel_packet_t;
+
+typedef enum _stub_tunnel_verdict_t {
+    /* Not terminated, packet unchanged */
+    STUB_TUNNEL_MISS,
+    /* Outer header removed, inner packet rewritten by the tunnel decap modes */
+    STUB_TUNNEL_DECAP,
+    /* Terminated, inner packet malformed or CE marked but not ECN capable */
+    STUB_TUNNEL_DROP
+} stub_tunnel_verdict_t;
+
+sai_status_t db_tunnel_decap(_In_ sai_object_id_t          vr_id,
+                             _In_ uint32_t                 count,
+                             _Inout_ stub_tunnel_packet_t *packets,
+                             _Out_ stub_tunnel_verdict_t  *verdicts,
+                             _Out_ sai_object_id_t        *tunnel_ids);
+sai_status_t db_tunnel_encap(_In_ sai_object_id_t          tunnel_id,
+                             _In_ const sai_ip_address_t  *dst_ip,
+                             _In_ uint32_t                 count,
+                             _Inout_ stub_tunnel_packet_t *packets);
+
+#define UDF_GROUP_LENGTH_MAX 16
+
+/* Packet from its L2 header on */
+typedef struct _stub_udf_packet_t {
+    const uint8_t *data;
+    uint32_t       length;
+} stub_udf_packet_t;
+
+/* Bytes of a UDF group extracted from a packet, not valid when no UDF of the group applies */
+typedef struct _stub_udf_key_t {
+    bool    valid;
+    uint8_t data[UDF_GROUP_LENGTH_MAX];
+} stub_udf_key_t;
+
+sai_status_t db_udf_group_extract(_In_ uint32_t                 core,
+                                  _In_ sai_object_id_t          udf_group_id,
+                                  _In_ uint32_t                 count,
+                                  _In_ const stub_udf_packet_t *packets,
+                                  _Out_ stub_udf_key_t         *keys);
+sai_status_t db_udf_hash(_In_ uint32_t                 core,
+                         _In_ uint32_t                 count,
+                         _In_ const stub_udf_packet_t *packets,
+                         _Inout_ uint32_t             *hashes);
+
+/* Outputs of a multicast group, one bit each */
+#define MCAST_GROUP_OUTPUTS 64
+
+/* Replicated copy, referencing length bytes of buf */
+typedef struct _stub_mcast_copy_t {
+    stub_mirror_buf_t *buf;
+    uint32_t           length;
+    /* Port, or router interface of routed copies */
+    sai_object_id_t    output;
+} stub_mcast_copy_t;
+
+typedef enum _stub_mcast_verdict_t {
+    STUB_MCAST_MISS,
+    STUB_MCAST_HIT,
+    STUB_MCAST_RPF_FAIL
+} stub_mcast_verdict_t;
+
+sai_status_t db_ipmc_replicate(_In_ sai_object_id_t        vr_id,
+                               _In_ sai_object_id_t        rif_id,
+                               _In_ stub_mirror_buf_t     *buf,
+                               _In_ uint32_t               offset,
+                               _In_ uint32_t               length,
+                               _Out_ stub_mcast_copy_t    *copies,
+                               _Out_ uint32_t             *count,
+                               _Out_ stub_mcast_verdict_t *verdict,
+                               _Out_ bool                 *to_cpu);
+sai_status_t db_l2mc_replicate(_In_ sai_vlan_id_t          vlan_id,
+                               _In_ uint32_t               port_id,
+                               _In_ stub_mirror_buf_t     *buf,
+                               _In_ uint32_t               length,
+                               _Out_ stub_mcast_copy_t    *copies,
+                               _Out_ uint32_t             *count,
+                               _Out_ stub_mcast_verdict_t *verdict,
+                               _Out_ bool                 *to_cpu);
+
+/* Instance of the VLANs not set to another */
+#define STP_DEFAULT_INSTANCE 0
+
+bool db_stp_port_forwarding(_In_ sai_vlan_id_t vlan_id, _In_ uint32_t port_id);
+bool db_stp_port_learning(_In_ sai_vlan_id_t vlan_id, _In_ uint32_t port_id);
+sai_status_t db_stp_vlan_get(_In_ sai_vlan_id_t vlan_id, _Out_ sai_object_id_t *stp_id);
+sai_status_t db_stp_vlan_set(_In_ sai_vlan_id_t vlan_id, _In_ sai_object_id_t stp_id);
+
+sai_status_t db_lag_select(_In_ uint32_t         core,
+                           _In_ sai_object_id_t  lag_id,
+                           _In_ uint32_t         count,
+                           _In_ const uint32_t  *hashes,
+                           _Out_ uint32_t       *ports);
+sai_status_t db_lag_member_flows_get(_In_ sai_object_id_t member_id, _Out_ uint64_t *flows);
+sai_status_t db_lag_port_ingress_get(_In_ uint32_t port_id, _Out_ sai_object_id_t *lag_id);
+
+/* Trapped packet, referencing length bytes of buf */
+typedef struct _stub_trap_packet_t {
+    int32_t            trap_id;
+    uint32_t           port_id;
+    stub_mirror_buf_t *buf;
+    uint32_t           length;
+} stub_trap_packet_t;
+
+typedef struct _stub_trap_stats_t {
+    uint64_t punted;
+    uint64_t admin_drops;
+    uint64_t policer_drops;
+    uint64_t queue_drops;
+} stub_trap_stats_t;
+
+sai_status_t db_trap_punt(_In_ uint32_t                  core,
+                          _In_ uint64_t                  now_ns,
+                          _In_ uint32_t                  count,
+                          _In_ const stub_trap_packet_t *packets,
+                          _Out_ bool                    *punted);
+sai_status_t db_trap_dispatch(_In_ uint32_t budget, _Out_ uint32_t *count);
+sai_status_t db_trap_start();
+void db_trap_stop();
+sai_status_t db_trap_action_get(_In_ int32_t trap_id, _Out_ sai_packet_action_t *action);
+bool db_trap_classify(_In_ const uint8_t *data, _In_ uint32_t length, _Out_ int32_t *trap_id);
+sai_status_t db_trap_stats_get(_In_ int32_t trap_id, _Out_ stub_trap_stats_t *stats);
+sai_status_t db_trap_cpu_queue_weight_set(_In_ uint32_t queue, _In_ uint32_t weight);
+sai_status_t db_trap_default_group_get(_Out_ sai_object_id_t *trap_group_id);
+sai_status_t db_trap_default_group_set(_In_ sai_object_id_t trap_group_id);
+
+typedef struct _stub_notification_stats_t {
+    uint64_t delivered;
+    uint64_t callbacks;
+    uint64_t overflow_drops;
+} stub_notification_stats_t;
+
+sai_status_t db_notification_start();
+void db_notification_stop();
+sai_status_t db_notification_config_set(_In_ uint32_t max_batch, _In_ uint32_t max_latency_us);
+void db_notification_stats_get(_Out_ stub_notification_stats_t *stats);
+sai_status_t db_notify_fdb_event(_In_ sai_fdb_event_t        event_type,
+                                 _In_ const sai_fdb_entry_t *fdb_entry,
+                                 _In_ uint32_t               attr_count,
+                                 _In_ const sai_attribute_t *attr_list);
+sai_status_t db_notify_port_state(_In_ uint32_t port_id, _In_ sai_port_oper_status_t port_state);
+sai_status_t db_notify_switch_state(_In_ sai_switch_oper_status_t switch_state);
+
+typedef enum _stub_counter_type_t {
+    COUNTER_TYPE_PORT,
+    COUNTER_TYPE_QUEUE,
+    COUNTER_TYPE_INGRESS_PG,
+    COUNTER_TYPE_POLICER
+} stub_counter_type_t;
+
+#define COUNTER_DEFAULT_REFRESH_INTERVAL 1
+
+sai_status_t db_counter_start();
+void db_counter_stop();
+/* Refresh interval in seconds, 0 reads the counters directly */
+void db_counter_refresh_interval_set(_In_ uint32_t interval);
+uint32_t db_counter_refresh_interval_get();
+/* Take a snapshot of the counters now, when they are cached */
+void db_counter_refresh();
+/*
+ * Rows of cached counters of a type, NULL when the counters are read directly.
+ * Values loaded from the rows are consistent when db_counter_read_retry then
+ * returns false, otherwise they should be loaded again.
+ */
+const uint64_t* db_counter_read_begin(_In_ stub_counter_type_t type, _Out_ uint64_t *seq);
+bool db_counter_read_retry(_In_ uint64_t seq);
+
+#define STUB_TELEMETRY_NUMBER 16
+
+/*
+ * Peak of a gauge for the telemetry subscriptions. The peak since the last
+ * sample of any subscription is folded into the watermarks of all of them,
+ * and the watermark of a subscription restarts only once its record is sent,
+ * so a record dropped or sampled by another subscription loses no peak
+ */
+typedef struct _stub_telemetry_watermark_t {
+    uint64_t peak;
+    uint64_t watermarks[STUB_TELEMETRY_NUMBER];
+} stub_telemetry_watermark_t;
+
+/* Stop pushing telemetry, ending all the subscriptions */
+void db_telemetry_stop();
+uint64_t db_telemetry_watermark_sample(_Inout_ stub_telemetry_watermark_t *watermark,
+                                       _In_ uint64_t                       current,
+                                       _In_ uint32_t                       subscription);
+void db_telemetry_watermark_restart(_Inout_ stub_telemetry_watermark_t *watermark, _In_ uint32_t subscription);
+
+sai_status_t db_profile_load(_In_ sai_switch_profile_id_t profile_id);
+const char* db_profile_string_get(_In_ const char *key);
+uint32_t db_profile_u32_get(_In_ const char *key, _In_ uint32_t default_value);
+bool db_profile_bool_get(_In_ const char *key, _In_ bool default_value);
+
+sai_status_t db_init_start();
+void db_init_wait();
+sai_switch_oper_status_t db_init_oper_status_get();
+
+/* Forwarding results besides a port */
+#define FDB_FLOOD PORT_NUMBER
+#define FDB_DROP  (PORT_NUMBER + 1)
+
+typedef struct _stub_fdb_packet_t {
+    sai_vlan_id_t vlan_id;
+    uint32_t      port_id;
+    sai_mac_t     src_mac;
+    sai_mac_t     dst_mac;
+} stub_fdb_packet_t;
+
+typedef struct _stub_fdb_stats_t {
+    uint64_t learned;
+    uint64_t moved;
+    uint64_t aged;
+    uint64_t learn_drops;
+    uint64_t limit_drops;
+    uint64_t table_full_drops;
+    uint64_t entries;
+} stub_fdb_stats_t;
+
+/* Host churn generated for learning, rates in packets per million */
+typedef struct _stub_fdb_churn_t {
+    uint32_t host_count;
+    uint32_t vlan_count;
+    uint32_t port_count;
+    uint32_t move_ppm;
+    uint32_t replace_ppm;
+    uint64_t seed;
+} stub_fdb_churn_t;
+
+sai_status_t db_fdb_forward(_In_ uint32_t                 core,
+                            _In_ uint64_t                 now_ns,
+                            _In_ uint32_t                 count,
+                            _In_ const stub_fdb_packet_t *packets,
+                            _Out_ uint32_t               *ports,
+                            _Out_ bool                   *to_cpu);
+sai_status_t db_fdb_learn(_In_ uint64_t now_ns, _In_ uint32_t budget, _Out_ uint32_t *learned);
+sai_status_t db_fdb_age(_In_ uint64_t now_ns, _Out_ uint32_t *aged);
+void db_fdb_stats_get(_Out_ stub_fdb_stats_t *stats);
+void db_fdb_aging_time_set(_In_ uint32_t aging_time);
+uint32_t db_fdb_aging_time_get();
+void db_fdb_max_learned_set(_In_ uint32_t max_learned);
+uint32_t db_fdb_max_learned_get();
+void db_init_fdb();
+uint32_t db_fdb_table_size_get();
+sai_status_t db_fdb_churn_init(_In_ const stub_fdb_churn_t *churn);
+sai_status_t db_fdb_churn_generate(_In_ uint32_t core, _In_ uint32_t count, _Out_ stub_fdb_packet_t *packets);
+void db_port_fdb_learning_get(_In_ uint32_t              port_id,
+                              _Out_ int32_t             *mode,
+                              _Out_ uint32_t            *max_learned,
+                              _Out_ sai_packet_action_t *violation);
+
+typedef struct _stub_sim_flow_t {
+    uint32_t           port_id;
+    uint8_t            queue_index;
+    uint64_t           rate_bps;
+    uint32_t           length;
+    sai_packet_color_t color;
+    bool               ecn_capable;
+    bool               poisson;
+    uint64_t           start_ns;
+    uint64_t           stop_ns;
+    /* Port and priority group the flow is received on, for ingress buffer accounting and PFC */
+    uint32_t           ingress_port_id;
+    uint8_t            priority_group;
+} stub_sim_flow_t;
+
+void db_sim_reset(_In_ uint64_t seed);
+sai_status_t db_sim_flow_add(_In_ const stub_sim_flow_t *flow, _Out_ uint32_t *flow_id);
+sai_status_t db_sim_pcap_add(_In_ const char *path, _In_ uint32_t port_id, _In_ uint64_t start_ns);
+sai_status_t db_sim_run(_In_ uint64_t until_ns, _Out_ uint64_t *event_count);
+uint64_t db_sim_now();
+/* Exclude the simulator from the queue and buffer state, while read from another thread */
+void db_sim_lock();
+void db_sim_unlock();
 
 sai_status_t stub_fill_objlist(sai_object_id_t *data, uint32_t count, sai_object_list_t *list);
+sai_status_t stub_fill_u8list(uint8_t *data, uint32_t count, sai_u8_list_t *list);
 sai_status_t stub_fill_u32list(uint32_t *data, uint32_t count, sai_u32_list_t *list);
 sai_status_t stub_fill_s32list(int32_t *data, uint32_t count, sai_s32_list_t *list);
 sai_status_t stub_fill_vlanlist(sai_vlan_id_t *data, uint32_t count, sai_vlan_list_t *list);
+sai_status_t stub_fill_qosmaplist(sai_qos_map_t *data, uint32_t count, sai_qos_map_list_t *list);
+sai_status_t stub_fill_tunnelmaplist(sai_tunnel_map_t *data, uint32_t count, sai_tunnel_map_list_t *list);
+
+/*
+ * Epoch based reclamation of the tables read by the forwarding cores without
+ * a lock. A core brackets its reads with stub_epoch_read_begin/end, which
+ * publish the epoch it reads with. A writer swaps the new table in, retires
+ * the old one, tagged with the current epoch and starting the next, then
+ * reclaims, freeing the retired tables no core can still read. Writers of a
+ * domain are serialized by their module.
+ */
+typedef struct _stub_epoch_reader_t {
+    /* 0 when not reading */
+    uint64_t epoch;
+} __attribute__((aligned(CACHE_LINE_SIZE))) stub_epoch_reader_t;
+
+/* Embedded in the retired table, object being the pointer to free */
+typedef struct _stub_epoch_retired_t {
+    void                         *object;
+    uint64_t                      epoch;
+    struct _stub_epoch_retired_t *next;
+} stub_epoch_retired_t;
+
+typedef struct _stub_epoch_domain_t {
+    uint64_t              epoch;
+    stub_epoch_retired_t *retired;
+    stub_epoch_reader_t   readers[STUB_CORES];
+} stub_epoch_domain_t;
+
+#define STUB_EPOCH_DOMAIN_INIT { .epoch = 1 }
+
+void stub_epoch_read_begin(_Inout_ stub_epoch_domain_t *domain, _In_ uint32_t core);
+void stub_epoch_read_end(_Inout_ stub_epoch_domain_t *domain, _In_ uint32_t core);
+void stub_epoch_retire(_Inout_ stub_epoch_domain_t *domain, _In_ void *object, _Out_ stub_epoch_retired_t *retired);
+void stub_epoch_reclaim(_Inout_ stub_epoch_domain_t *domain);
 
 void utils_log(const sai_log_level_t severity, const char *module_name, const char *p_str, ...);
 
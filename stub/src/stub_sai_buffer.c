@@ -0,0 +1,2101 @@
+/*
+ *  Copyright (C) 2014. Mellanox Technologies, Ltd. ALL RIGHTS RESERVED.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ */
+
+#include "sai.h"
+#include "stub_sai.h"
+#include "assert.h"
+#include "inttypes.h"
+#include "pthread.h"
+
+#undef  __MODULE__
+#define __MODULE__ SAI_BUFFER
+
+/*
+ * Shared buffer admission.
+ * Buffers are accounted in cells. Each ingress priority group and egress
+ * queue bound to a buffer profile owns the reserved size of the profile in
+ * its pool, and takes cells beyond it from the pool shared size, up to a
+ * static limit or to 2^SHARED_DYNAMIC_TH times the free shared size
+ * (dynamic threshold). An ingress priority group with a XOFF threshold is
+ * lossless : a packet refused by the shared pool is held in headroom, and
+ * the group sends XOFF, until the headroom drains and the group usage
+ * falls to its XON threshold. Cells are released headroom first, then
+ * shared, then reserved.
+ */
+
+static const sai_attribute_entry_t buffer_pool_attribs[] = {
+    { SAI_BUFFER_POOL_ATTR_SHARED_SIZE, false, false, false, true,
+      "Buffer pool shared size", SAI_ATTR_VAL_TYPE_U32 },
+    { SAI_BUFFER_POOL_ATTR_TYPE, true, true, false, true,
+      "Buffer pool type", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_BUFFER_POOL_ATTR_SIZE, true, true, true, true,
+      "Buffer pool size", SAI_ATTR_VAL_TYPE_U32 },
+    { SAI_BUFFER_POOL_ATTR_THRESHOLD_MODE, false, true, false, true,
+      "Buffer pool threshold mode", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_BUFFER_POOL_ATTR_XOFF_SIZE, false, true, true, true,
+      "Buffer pool XOFF size", SAI_ATTR_VAL_TYPE_U32 },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+static const sai_attribute_entry_t buffer_profile_attribs[] = {
+    { SAI_BUFFER_PROFILE_ATTR_POOL_ID, true, true, false, true,
+      "Buffer profile pool", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_BUFFER_PROFILE_ATTR_BUFFER_SIZE, true, true, true, true,
+      "Buffer profile reserved size", SAI_ATTR_VAL_TYPE_U32 },
+    { SAI_BUFFER_PROFILE_ATTR_THRESHOLD_MODE, false, true, true, true,
+      "Buffer profile threshold mode", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_BUFFER_PROFILE_ATTR_SHARED_DYNAMIC_TH, false, true, true, true,
+      "Buffer profile shared dynamic threshold", SAI_ATTR_VAL_TYPE_S8 },
+    { SAI_BUFFER_PROFILE_ATTR_SHARED_STATIC_TH, false, true, true, true,
+      "Buffer profile shared static threshold", SAI_ATTR_VAL_TYPE_U32 },
+    { SAI_BUFFER_PROFILE_ATTR_XOFF_TH, false, true, true, true,
+      "Buffer profile XOFF threshold", SAI_ATTR_VAL_TYPE_U32 },
+    { SAI_BUFFER_PROFILE_ATTR_XON_TH, false, true, true, true,
+      "Buffer profile XON threshold", SAI_ATTR_VAL_TYPE_U32 },
+    { SAI_BUFFER_PROFILE_ATTR_XON_OFFSET_TH, false, true, true, true,
+      "Buffer profile XON offset threshold", SAI_ATTR_VAL_TYPE_U32 },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+static const sai_attribute_entry_t ingress_pg_attribs[] = {
+    { SAI_INGRESS_PRIORITY_GROUP_ATTR_BUFFER_PROFILE, false, false, true, true,
+      "Ingress priority group buffer profile", SAI_ATTR_VAL_TYPE_OID },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+sai_status_t stub_buffer_pool_attr_get(_In_ const sai_object_key_t   *key,
+                                       _Inout_ sai_attribute_value_t *value,
+                                       _In_ uint32_t                  attr_index,
+                                       _Inout_ vendor_cache_t        *cache,
+                                       void                          *arg);
+sai_status_t stub_buffer_pool_attr_set(_In_ const sai_object_key_t      *key,
+                                       _In_ const sai_attribute_value_t *value,
+                                       void                             *arg);
+sai_status_t stub_buffer_profile_attr_get(_In_ const sai_object_key_t   *key,
+                                          _Inout_ sai_attribute_value_t *value,
+                                          _In_ uint32_t                  attr_index,
+                                          _Inout_ vendor_cache_t        *cache,
+                                          void                          *arg);
+sai_status_t stub_buffer_profile_attr_set(_In_ const sai_object_key_t      *key,
+                                          _In_ const sai_attribute_value_t *value,
+                                          void                             *arg);
+sai_status_t stub_ingress_pg_profile_get(_In_ const sai_object_key_t   *key,
+                                         _Inout_ sai_attribute_value_t *value,
+                                         _In_ uint32_t                  attr_index,
+                                         _Inout_ vendor_cache_t        *cache,
+                                         void                          *arg);
+sai_status_t stub_ingress_pg_profile_set(_In_ const sai_object_key_t      *key,
+                                         _In_ const sai_attribute_value_t *value,
+                                         void                             *arg);
+
+static const sai_vendor_attribute_entry_t buffer_pool_vendor_attribs[] = {
+    { SAI_BUFFER_POOL_ATTR_SHARED_SIZE,
+      { false, false, false, true },
+      { false, false, false, true },
+      stub_buffer_pool_attr_get, (void*)SAI_BUFFER_POOL_ATTR_SHARED_SIZE,
+      NULL, NULL },
+    { SAI_BUFFER_POOL_ATTR_TYPE,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_buffer_pool_attr_get, (void*)SAI_BUFFER_POOL_ATTR_TYPE,
+      NULL, NULL },
+    { SAI_BUFFER_POOL_ATTR_SIZE,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_buffer_pool_attr_get, (void*)SAI_BUFFER_POOL_ATTR_SIZE,
+      stub_buffer_pool_attr_set, (void*)SAI_BUFFER_POOL_ATTR_SIZE },
+    { SAI_BUFFER_POOL_ATTR_THRESHOLD_MODE,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_buffer_pool_attr_get, (void*)SAI_BUFFER_POOL_ATTR_THRESHOLD_MODE,
+      NULL, NULL },
+    { SAI_BUFFER_POOL_ATTR_XOFF_SIZE,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_buffer_pool_attr_get, (void*)SAI_BUFFER_POOL_ATTR_XOFF_SIZE,
+      stub_buffer_pool_attr_set, (void*)SAI_BUFFER_POOL_ATTR_XOFF_SIZE },
+};
+
+static const sai_vendor_attribute_entry_t buffer_profile_vendor_attribs[] = {
+    { SAI_BUFFER_PROFILE_ATTR_POOL_ID,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_buffer_profile_attr_get, (void*)SAI_BUFFER_PROFILE_ATTR_POOL_ID,
+      NULL, NULL },
+    { SAI_BUFFER_PROFILE_ATTR_BUFFER_SIZE,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_buffer_profile_attr_get, (void*)SAI_BUFFER_PROFILE_ATTR_BUFFER_SIZE,
+      stub_buffer_profile_attr_set, (void*)SAI_BUFFER_PROFILE_ATTR_BUFFER_SIZE },
+    { SAI_BUFFER_PROFILE_ATTR_THRESHOLD_MODE,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_buffer_profile_attr_get, (void*)SAI_BUFFER_PROFILE_ATTR_THRESHOLD_MODE,
+      stub_buffer_profile_attr_set, (void*)SAI_BUFFER_PROFILE_ATTR_THRESHOLD_MODE },
+    { SAI_BUFFER_PROFILE_ATTR_SHARED_DYNAMIC_TH,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_buffer_profile_attr_get, (void*)SAI_BUFFER_PROFILE_ATTR_SHARED_DYNAMIC_TH,
+      stub_buffer_profile_attr_set, (void*)SAI_BUFFER_PROFILE_ATTR_SHARED_DYNAMIC_TH },
+    { SAI_BUFFER_PROFILE_ATTR_SHARED_STATIC_TH,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_buffer_profile_attr_get, (void*)SAI_BUFFER_PROFILE_ATTR_SHARED_STATIC_TH,
+      stub_buffer_profile_attr_set, (void*)SAI_BUFFER_PROFILE_ATTR_SHARED_STATIC_TH },
+    { SAI_BUFFER_PROFILE_ATTR_XOFF_TH,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_buffer_profile_attr_get, (void*)SAI_BUFFER_PROFILE_ATTR_XOFF_TH,
+      stub_buffer_profile_attr_set, (void*)SAI_BUFFER_PROFILE_ATTR_XOFF_TH },
+    { SAI_BUFFER_PROFILE_ATTR_XON_TH,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_buffer_profile_attr_get, (void*)SAI_BUFFER_PROFILE_ATTR_XON_TH,
+      stub_buffer_profile_attr_set, (void*)SAI_BUFFER_PROFILE_ATTR_XON_TH },
+    { SAI_BUFFER_PROFILE_ATTR_XON_OFFSET_TH,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_buffer_profile_attr_get, (void*)SAI_BUFFER_PROFILE_ATTR_XON_OFFSET_TH,
+      stub_buffer_profile_attr_set, (void*)SAI_BUFFER_PROFILE_ATTR_XON_OFFSET_TH },
+};
+
+static const sai_vendor_attribute_entry_t ingress_pg_vendor_attribs[] = {
+    { SAI_INGRESS_PRIORITY_GROUP_ATTR_BUFFER_PROFILE,
+      { false, false, true, true },
+      { false, false, true, true },
+      stub_ingress_pg_profile_get, NULL,
+      stub_ingress_pg_profile_set, NULL },
+};
+
+/* State DB *************/
+#define BUFFER_NONE               0xFFFFFFFF
+#define MAX_BUFFER_POOL_NUMBER    16
+#define MAX_BUFFER_PROFILE_NUMBER 256
+#define BUFFER_CELL_SIZE          256
+#define BUFFER_MIN_DYNAMIC_TH     (-8)
+#define BUFFER_MAX_DYNAMIC_TH     8
+#define BUFFER_PG_STAT_COUNT      (SAI_INGRESS_PRIORITY_GROUP_STAT_BYTES + 1)
+
+/* Cells taken by a packet or reserved for a size, and cells fitting in a limit */
+#define BUFFER_CELLS(bytes)       (((uint64_t)(bytes) + BUFFER_CELL_SIZE - 1) / BUFFER_CELL_SIZE)
+#define BUFFER_CELLS_FLOOR(bytes) ((bytes) / BUFFER_CELL_SIZE)
+#define BUFFER_BYTES(cells)       ((uint64_t)(cells) * BUFFER_CELL_SIZE)
+
+typedef struct _stub_buffer_pool_t {
+    sai_buffer_pool_type_t           type;
+    sai_buffer_pool_threshold_mode_t mode;
+    uint32_t                         size;
+    uint32_t                         xoff_size;
+    /* Cells reserved by the bound priority groups and queues, the rest is shared */
+    uint32_t                         reserved_cells;
+    uint32_t                         shared_cells;
+    uint32_t                         reserved_used;
+    uint32_t                         shared_used;
+    uint32_t                         headroom_used;
+    uint32_t                         watermark;
+    uint32_t                         ref_count;
+    bool                             is_valid;
+} stub_buffer_pool_t;
+
+typedef struct _stub_buffer_profile_t {
+    sai_object_id_t                     pool;
+    uint32_t                            pool_id;
+    uint32_t                            buffer_size;
+    sai_buffer_profile_threshold_mode_t mode;
+    int8_t                              dynamic_th;
+    uint32_t                            static_th;
+    uint32_t                            xoff_th;
+    uint32_t                            xon_th;
+    uint32_t                            xon_offset_th;
+    /* Thresholds in cells, and the threshold mode resolved against the pool one */
+    uint32_t                            reserved_cells;
+    uint32_t                            static_cells;
+    uint32_t                            xoff_cells;
+    uint32_t                            xon_cells;
+    uint32_t                            xon_offset_cells;
+    bool                                dynamic;
+    uint32_t                            ref_count;
+    bool                                is_valid;
+} stub_buffer_profile_t;
+
+/* Occupancy of an ingress priority group or an egress queue, in cells */
+typedef struct _stub_buffer_usage_t {
+    sai_object_id_t profile;
+    uint32_t        profile_id;
+    uint32_t        reserved_used;
+    uint32_t        shared_used;
+    uint32_t        headroom_used;
+    uint32_t        watermark;
+    uint32_t        shared_watermark;
+    uint32_t        headroom_watermark;
+    bool            xoff;
+} stub_buffer_usage_t;
+
+typedef struct _stub_buffer_pg_t {
+    stub_buffer_usage_t        usage;
+    /* Peaks of the usage, shared usage and headroom usage for the telemetry subscriptions */
+    stub_telemetry_watermark_t telemetry_watermark;
+    stub_telemetry_watermark_t telemetry_shared_watermark;
+    stub_telemetry_watermark_t telemetry_headroom_watermark;
+    uint64_t                   counters[BUFFER_PG_STAT_COUNT];
+    uint64_t                   xoff_count;
+    uint64_t                   dropped_packets;
+} stub_buffer_pg_t;
+
+static stub_buffer_pool_t    buffer_pool_db[MAX_BUFFER_POOL_NUMBER];
+static stub_buffer_profile_t buffer_profile_db[MAX_BUFFER_PROFILE_NUMBER];
+static stub_buffer_pg_t      buffer_pg_db[BUFFER_PG_NUMBER];
+static stub_buffer_usage_t   buffer_queue_db[MAX_QUEUE_NUMBER];
+static pthread_once_t        buffer_db_once = PTHREAD_ONCE_INIT;
+/* Priority groups which went back to XON, for the traffic sources to resume */
+static uint32_t              buffer_xon_ring[BUFFER_PG_NUMBER];
+static uint32_t              buffer_xon_head;
+static uint32_t              buffer_xon_count;
+
+static void buffer_db_init()
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < BUFFER_PG_NUMBER; ii++) {
+        buffer_pg_db[ii].usage.profile_id = BUFFER_NONE;
+    }
+    for (ii = 0; ii < MAX_QUEUE_NUMBER; ii++) {
+        buffer_queue_db[ii].profile_id = BUFFER_NONE;
+    }
+}
+
+/* Build the buffer tables, on switch init or on first use, whichever comes first */
+void db_init_buffer()
+{
+    pthread_once(&buffer_db_once, buffer_db_init);
+}
+
+static sai_status_t db_get_buffer_pool(_In_ uint32_t pool_id, _Out_ stub_buffer_pool_t **pool)
+{
+    if ((pool_id >= MAX_BUFFER_POOL_NUMBER) || (!buffer_pool_db[pool_id].is_valid)) {
+        STUB_LOG_ERR("Invalid buffer pool ID %u\n", pool_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *pool = &buffer_pool_db[pool_id];
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t db_find_free_buffer_pool_index(_Out_ uint32_t *free_index)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < MAX_BUFFER_POOL_NUMBER; ii++) {
+        if (false == buffer_pool_db[ii].is_valid) {
+            *free_index = ii;
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+
+    STUB_LOG_ERR("Buffer pool table full\n");
+    return SAI_STATUS_TABLE_FULL;
+}
+
+static sai_status_t db_get_buffer_profile(_In_ uint32_t profile_id, _Out_ stub_buffer_profile_t **profile)
+{
+    if ((profile_id >= MAX_BUFFER_PROFILE_NUMBER) || (!buffer_profile_db[profile_id].is_valid)) {
+        STUB_LOG_ERR("Invalid buffer profile ID %u\n", profile_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *profile = &buffer_profile_db[profile_id];
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t db_find_free_buffer_profile_index(_Out_ uint32_t *free_index)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < MAX_BUFFER_PROFILE_NUMBER; ii++) {
+        if (false == buffer_profile_db[ii].is_valid) {
+            *free_index = ii;
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+
+    STUB_LOG_ERR("Buffer profile table full\n");
+    return SAI_STATUS_TABLE_FULL;
+}
+
+static sai_status_t db_get_ingress_pg(_In_ uint32_t pg_id, _Out_ stub_buffer_pg_t **pg)
+{
+    db_init_buffer();
+
+    if (pg_id >= BUFFER_PG_NUMBER) {
+        STUB_LOG_ERR("Invalid ingress priority group ID %u\n", pg_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *pg = &buffer_pg_db[pg_id];
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Move reserved cells in or out of a pool, the shared size is what is neither reserved nor headroom */
+static sai_status_t buffer_pool_reserve(_Inout_ stub_buffer_pool_t *pool,
+                                        _In_ uint32_t               size,
+                                        _In_ uint32_t               xoff_size,
+                                        _In_ int64_t                reserved_delta)
+{
+    uint64_t total    = BUFFER_CELLS_FLOOR(size);
+    uint64_t xoff     = BUFFER_CELLS(xoff_size);
+    int64_t  reserved = (int64_t)pool->reserved_cells + reserved_delta;
+
+    assert(reserved >= 0);
+
+    if (xoff + reserved > total) {
+        STUB_LOG_ERR("Buffer pool size %u can't hold XOFF size %u and %" PRId64 " reserved cells\n",
+                     size, xoff_size, reserved);
+        return SAI_STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    pool->size           = size;
+    pool->xoff_size      = xoff_size;
+    pool->reserved_cells = (uint32_t)reserved;
+    pool->shared_cells   = (uint32_t)(total - xoff - reserved);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static void buffer_profile_cells_update(_Inout_ stub_buffer_profile_t *profile)
+{
+    sai_buffer_pool_threshold_mode_t mode = SAI_BUFFER_POOL_THRESHOLD_MODE_DYNAMIC;
+
+    if (BUFFER_NONE != profile->pool_id) {
+        mode = buffer_pool_db[profile->pool_id].mode;
+    }
+
+    profile->reserved_cells   = BUFFER_CELLS(profile->buffer_size);
+    profile->static_cells     = BUFFER_CELLS_FLOOR(profile->static_th);
+    profile->xoff_cells       = BUFFER_CELLS_FLOOR(profile->xoff_th);
+    profile->xon_cells        = BUFFER_CELLS_FLOOR(profile->xon_th);
+    profile->xon_offset_cells = BUFFER_CELLS(profile->xon_offset_th);
+    profile->dynamic          = (SAI_BUFFER_PROFILE_THRESHOLD_MODE_DYNAMIC == profile->mode) ||
+                                ((SAI_BUFFER_PROFILE_THRESHOLD_MODE_INHERIT_BUFFER_POOL_MODE == profile->mode) &&
+                                 (SAI_BUFFER_POOL_THRESHOLD_MODE_DYNAMIC == mode));
+}
+
+/*
+ * Shared cells an occupancy may hold : the static threshold, or 2^alpha
+ * times the free shared cells of the pool.
+ */
+static uint32_t buffer_shared_limit(_In_ const stub_buffer_pool_t    *pool,
+                                    _In_ const stub_buffer_profile_t *profile)
+{
+    uint64_t free_cells;
+
+    if (!profile->dynamic) {
+        return profile->static_cells ? profile->static_cells : pool->shared_cells;
+    }
+
+    free_cells = (pool->shared_cells > pool->shared_used) ? pool->shared_cells - pool->shared_used : 0;
+    if (profile->dynamic_th < 0) {
+        return (uint32_t)(free_cells >> -profile->dynamic_th);
+    }
+
+    free_cells <<= profile->dynamic_th;
+
+    return (free_cells > pool->shared_cells) ? pool->shared_cells : (uint32_t)free_cells;
+}
+
+static void buffer_watermarks_update(_Inout_ stub_buffer_pool_t *pool, _Inout_ stub_buffer_usage_t *usage)
+{
+    uint32_t used = usage->reserved_used + usage->shared_used + usage->headroom_used;
+
+    if (used > usage->watermark) {
+        usage->watermark = used;
+    }
+    if (usage->shared_used > usage->shared_watermark) {
+        usage->shared_watermark = usage->shared_used;
+    }
+    if (usage->headroom_used > usage->headroom_watermark) {
+        usage->headroom_watermark = usage->headroom_used;
+    }
+
+    used = pool->reserved_used + pool->shared_used + pool->headroom_used;
+    if (used > pool->watermark) {
+        pool->watermark = used;
+    }
+}
+
+static void buffer_pg_telemetry_update(_Inout_ stub_buffer_pg_t *pg)
+{
+    uint32_t used = pg->usage.reserved_used + pg->usage.shared_used + pg->usage.headroom_used;
+
+    if (used > pg->telemetry_watermark.peak) {
+        pg->telemetry_watermark.peak = used;
+    }
+    if (pg->usage.shared_used > pg->telemetry_shared_watermark.peak) {
+        pg->telemetry_shared_watermark.peak = pg->usage.shared_used;
+    }
+    if (pg->usage.headroom_used > pg->telemetry_headroom_watermark.peak) {
+        pg->telemetry_headroom_watermark.peak = pg->usage.headroom_used;
+    }
+}
+
+/* Charge cells to the reserved buffer of an occupancy first, and then to the shared pool within its limit */
+static bool buffer_charge(_Inout_ stub_buffer_pool_t          *pool,
+                          _In_ const stub_buffer_profile_t    *profile,
+                          _Inout_ stub_buffer_usage_t         *usage,
+                          _In_ uint32_t                        cells)
+{
+    uint32_t reserved = 0, shared;
+
+    if (usage->reserved_used < profile->reserved_cells) {
+        reserved = profile->reserved_cells - usage->reserved_used;
+        if (reserved > cells) {
+            reserved = cells;
+        }
+    }
+
+    shared = cells - reserved;
+    if ((0 != shared) &&
+        ((pool->shared_used + shared > pool->shared_cells) ||
+         (usage->shared_used + shared > buffer_shared_limit(pool, profile)))) {
+        return false;
+    }
+
+    usage->reserved_used += reserved;
+    usage->shared_used   += shared;
+    pool->reserved_used  += reserved;
+    pool->shared_used    += shared;
+
+    return true;
+}
+
+/* Release cells from headroom first, then shared, then reserved */
+static void buffer_release(_Inout_ stub_buffer_pool_t *pool, _Inout_ stub_buffer_usage_t *usage, _In_ uint32_t cells)
+{
+    uint32_t part;
+
+    part                  = (cells < usage->headroom_used) ? cells : usage->headroom_used;
+    usage->headroom_used -= part;
+    pool->headroom_used  -= part;
+    cells                -= part;
+
+    part                = (cells < usage->shared_used) ? cells : usage->shared_used;
+    usage->shared_used -= part;
+    pool->shared_used  -= part;
+    cells              -= part;
+
+    assert(cells <= usage->reserved_used);
+    usage->reserved_used -= cells;
+    pool->reserved_used  -= cells;
+}
+
+/*
+ * Bind an occupancy to a buffer profile of a pool of the given type,
+ * moving the profile reference and the reserved cells.
+ * Only an empty occupancy can change profile.
+ */
+static sai_status_t buffer_usage_bind(_Inout_ stub_buffer_usage_t *usage,
+                                      _In_ sai_object_id_t         profile_oid,
+                                      _In_ sai_buffer_pool_type_t  type)
+{
+    stub_buffer_profile_t *profile = NULL, *old;
+    stub_buffer_pool_t    *pool;
+    sai_status_t           status;
+    uint32_t               profile_id = BUFFER_NONE;
+
+    if (profile_oid == usage->profile) {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    if (0 != usage->reserved_used + usage->shared_used + usage->headroom_used) {
+        STUB_LOG_ERR("Can't change the buffer profile of an occupied buffer\n");
+        return SAI_STATUS_OBJECT_IN_USE;
+    }
+
+    if (SAI_NULL_OBJECT_ID != profile_oid) {
+        if (SAI_STATUS_SUCCESS !=
+            (status = stub_object_to_type(profile_oid, SAI_OBJECT_TYPE_BUFFER_PROFILE, &profile_id))) {
+            return status;
+        }
+        if (SAI_STATUS_SUCCESS != (status = db_get_buffer_profile(profile_id, &profile))) {
+            return status;
+        }
+        if ((BUFFER_NONE == profile->pool_id) || (type != buffer_pool_db[profile->pool_id].type)) {
+            STUB_LOG_ERR("Buffer profile ID %u isn't in an %s pool\n", profile_id,
+                         (SAI_BUFFER_POOL_TYPE_INGRESS == type) ? "ingress" : "egress");
+            return SAI_STATUS_INVALID_PARAMETER;
+        }
+        pool = &buffer_pool_db[profile->pool_id];
+        if (SAI_STATUS_SUCCESS !=
+            (status = buffer_pool_reserve(pool, pool->size, pool->xoff_size, profile->reserved_cells))) {
+            return status;
+        }
+        profile->ref_count++;
+    }
+
+    if (BUFFER_NONE != usage->profile_id) {
+        old  = &buffer_profile_db[usage->profile_id];
+        pool = &buffer_pool_db[old->pool_id];
+        buffer_pool_reserve(pool, pool->size, pool->xoff_size, -(int64_t)old->reserved_cells);
+        assert(old->ref_count > 0);
+        old->ref_count--;
+    }
+
+    usage->profile    = profile_oid;
+    usage->profile_id = profile_id;
+    usage->xoff       = false;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Get the ingress priority groups of a port, in index order */
+sai_status_t db_buffer_port_priority_groups_get(_In_ uint32_t         port_id,
+                                                _Out_ sai_object_id_t *pgs,
+                                                _Inout_ uint32_t      *count)
+{
+    sai_status_t status;
+    uint32_t     ii;
+
+    if (port_id >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid port %u\n", port_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (*count < BUFFER_PG_PER_PORT) {
+        *count = BUFFER_PG_PER_PORT;
+        return SAI_STATUS_BUFFER_OVERFLOW;
+    }
+
+    for (ii = 0; ii < BUFFER_PG_PER_PORT; ii++) {
+        if (SAI_STATUS_SUCCESS !=
+            (status = stub_create_object(SAI_OBJECT_TYPE_INGRESS_PRIORITY_GROUP, port_id * BUFFER_PG_PER_PORT + ii,
+                                         &pgs[ii]))) {
+            return status;
+        }
+    }
+
+    *count = BUFFER_PG_PER_PORT;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Admit a packet received on a port priority group to the ingress buffer.
+ * Packets of a priority group without buffer profile aren't accounted.
+ * The packet is charged to the reserved and shared buffer of the group, or
+ * to its headroom once the shared buffer refuses it, which turns the group
+ * to XOFF. Packets which fit nowhere are dropped.
+ */
+sai_status_t db_buffer_ingress_admit(_In_ uint32_t          port_id,
+                                     _In_ uint8_t           pg_index,
+                                     _Inout_ stub_packet_t *packet,
+                                     _Out_ bool            *admitted,
+                                     _Out_ bool            *xoff)
+{
+    stub_buffer_profile_t *profile;
+    stub_buffer_pool_t    *pool;
+    stub_buffer_pg_t      *pg;
+    uint32_t               pg_id, cells;
+
+    db_init_buffer();
+
+    if ((port_id >= PORT_NUMBER) || (pg_index >= BUFFER_PG_PER_PORT)) {
+        STUB_LOG_ERR("Invalid port %u priority group %u\n", port_id, pg_index);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    pg_id = port_id * BUFFER_PG_PER_PORT + pg_index;
+    pg    = &buffer_pg_db[pg_id];
+
+    pg->counters[SAI_INGRESS_PRIORITY_GROUP_STAT_PACKETS]++;
+    pg->counters[SAI_INGRESS_PRIORITY_GROUP_STAT_BYTES] += packet->length;
+
+    packet->ingress_accounted = false;
+    *admitted                 = true;
+    *xoff                     = false;
+
+    if (BUFFER_NONE == pg->usage.profile_id) {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    profile = &buffer_profile_db[pg->usage.profile_id];
+    pool    = &buffer_pool_db[profile->pool_id];
+    cells   = (uint32_t)BUFFER_CELLS(packet->length);
+
+    if (!buffer_charge(pool, profile, &pg->usage, cells)) {
+        /* Headroom is private to the group, or shared between groups up to the pool XOFF size */
+        if ((0 == profile->xoff_cells) || (pg->usage.headroom_used + cells > profile->xoff_cells) ||
+            ((0 != pool->xoff_size) && (pool->headroom_used + cells > BUFFER_CELLS(pool->xoff_size)))) {
+            pg->dropped_packets++;
+            *admitted = false;
+            return SAI_STATUS_SUCCESS;
+        }
+
+        pg->usage.headroom_used += cells;
+        pool->headroom_used     += cells;
+
+        if (!pg->usage.xoff) {
+            pg->usage.xoff = true;
+            pg->xoff_count++;
+            *xoff = true;
+        }
+    }
+
+    buffer_watermarks_update(pool, &pg->usage);
+    buffer_pg_telemetry_update(pg);
+
+    packet->ingress_accounted = true;
+    packet->ingress_pg_id     = pg_id;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Release the ingress buffer of a packet leaving the switch or dropped on egress.
+ * A group in XOFF goes back to XON when its headroom is empty and its usage
+ * is at most max(XON_TH, reserved and shared limit - XON_OFFSET_TH).
+ */
+void db_buffer_ingress_release(_In_ const stub_packet_t *packet)
+{
+    stub_buffer_profile_t *profile;
+    stub_buffer_pool_t    *pool;
+    stub_buffer_pg_t      *pg;
+    uint32_t               limit, xon;
+
+    if (!packet->ingress_accounted) {
+        return;
+    }
+
+    pg      = &buffer_pg_db[packet->ingress_pg_id];
+    profile = &buffer_profile_db[pg->usage.profile_id];
+    pool    = &buffer_pool_db[profile->pool_id];
+
+    buffer_release(pool, &pg->usage, (uint32_t)BUFFER_CELLS(packet->length));
+
+    if ((!pg->usage.xoff) || (0 != pg->usage.headroom_used)) {
+        return;
+    }
+
+    limit = profile->reserved_cells + buffer_shared_limit(pool, profile);
+    xon   = (limit > profile->xon_offset_cells) ? limit - profile->xon_offset_cells : 0;
+    if (xon < profile->xon_cells) {
+        xon = profile->xon_cells;
+    }
+
+    if (pg->usage.reserved_used + pg->usage.shared_used <= xon) {
+        pg->usage.xoff = false;
+        assert(buffer_xon_count < BUFFER_PG_NUMBER);
+        buffer_xon_ring[(buffer_xon_head + buffer_xon_count++) % BUFFER_PG_NUMBER] = packet->ingress_pg_id;
+    }
+}
+
+/* Take the next priority group which went back to XON, if any */
+bool db_buffer_xon_pop(_Out_ uint32_t *port_id, _Out_ uint8_t *pg_index)
+{
+    uint32_t pg_id;
+
+    if (0 == buffer_xon_count) {
+        return false;
+    }
+
+    pg_id           = buffer_xon_ring[buffer_xon_head];
+    buffer_xon_head = (buffer_xon_head + 1) % BUFFER_PG_NUMBER;
+    buffer_xon_count--;
+
+    *port_id  = pg_id / BUFFER_PG_PER_PORT;
+    *pg_index = pg_id % BUFFER_PG_PER_PORT;
+
+    return true;
+}
+
+/* Admit a packet to the egress buffer of a queue, queues without buffer profile aren't accounted */
+sai_status_t db_buffer_egress_admit(_In_ uint32_t queue_id, _In_ uint32_t length, _Out_ bool *admitted)
+{
+    stub_buffer_usage_t   *usage;
+    stub_buffer_profile_t *profile;
+    stub_buffer_pool_t    *pool;
+
+    db_init_buffer();
+
+    if (queue_id >= MAX_QUEUE_NUMBER) {
+        STUB_LOG_ERR("Invalid queue ID %u\n", queue_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    usage     = &buffer_queue_db[queue_id];
+    *admitted = true;
+
+    if (BUFFER_NONE == usage->profile_id) {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    profile = &buffer_profile_db[usage->profile_id];
+    pool    = &buffer_pool_db[profile->pool_id];
+
+    if (!buffer_charge(pool, profile, usage, (uint32_t)BUFFER_CELLS(length))) {
+        *admitted = false;
+        return SAI_STATUS_SUCCESS;
+    }
+
+    buffer_watermarks_update(pool, usage);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+void db_buffer_egress_release(_In_ uint32_t queue_id, _In_ uint32_t length)
+{
+    stub_buffer_usage_t *usage = &buffer_queue_db[queue_id];
+
+    /* Packets may reach queues before anything was admitted to a buffer */
+    db_init_buffer();
+
+    if (BUFFER_NONE == usage->profile_id) {
+        return;
+    }
+
+    buffer_release(&buffer_pool_db[buffer_profile_db[usage->profile_id].pool_id], usage,
+                   (uint32_t)BUFFER_CELLS(length));
+}
+
+/* Bind a queue to a buffer profile of an egress pool, the queue must be empty */
+sai_status_t db_buffer_queue_profile_set(_In_ uint32_t queue_id, _In_ sai_object_id_t profile)
+{
+    db_init_buffer();
+
+    if (queue_id >= MAX_QUEUE_NUMBER) {
+        STUB_LOG_ERR("Invalid queue ID %u\n", queue_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    return buffer_usage_bind(&buffer_queue_db[queue_id], profile, SAI_BUFFER_POOL_TYPE_EGRESS);
+}
+
+/* Check the counter ids before reading any, so a read fills all the counters or none */
+static sai_status_t ingress_pg_stats_check(_In_ const sai_ingress_priority_group_stat_t *counter_ids,
+                                           _In_ uint32_t                                 number_of_counters)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < number_of_counters; ii++) {
+        if (((uint32_t)counter_ids[ii] > SAI_INGRESS_PRIORITY_GROUP_STAT_XOFF_ROOM_WATERMARK_BYTES) &&
+            (STUB_INGRESS_PRIORITY_GROUP_STAT_XOFF_EVENTS != (int32_t)counter_ids[ii]) &&
+            (STUB_INGRESS_PRIORITY_GROUP_STAT_DROPPED_PACKETS != (int32_t)counter_ids[ii])) {
+            STUB_LOG_ERR("Invalid ingress priority group counter %d\n", counter_ids[ii]);
+            return SAI_STATUS_INVALID_PARAMETER;
+        }
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Read counters of a priority group, the counter ids are checked by ingress_pg_stats_check */
+static void ingress_pg_stats_read(_In_ const stub_buffer_pg_t                *pg,
+                                  _In_ const sai_ingress_priority_group_stat_t *counter_ids,
+                                  _In_ uint32_t                                 number_of_counters,
+                                  _Out_ uint64_t                               *counters)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < number_of_counters; ii++) {
+        switch ((int32_t)counter_ids[ii]) {
+        case SAI_INGRESS_PRIORITY_GROUP_STAT_PACKETS:
+        case SAI_INGRESS_PRIORITY_GROUP_STAT_BYTES:
+            counters[ii] = pg->counters[counter_ids[ii]];
+            break;
+
+        case SAI_INGRESS_PRIORITY_GROUP_STAT_CURR_OCCUPANCY_BYTES:
+            counters[ii] = BUFFER_BYTES(pg->usage.reserved_used + pg->usage.shared_used + pg->usage.headroom_used);
+            break;
+
+        case SAI_INGRESS_PRIORITY_GROUP_STAT_WATERMARK_BYTES:
+            counters[ii] = BUFFER_BYTES(pg->usage.watermark);
+            break;
+
+        case SAI_INGRESS_PRIORITY_GROUP_STAT_SHARED_CURR_OCCUPANCY_BYTES:
+            counters[ii] = BUFFER_BYTES(pg->usage.shared_used);
+            break;
+
+        case SAI_INGRESS_PRIORITY_GROUP_STAT_SHARED_WATERMARK_BYTES:
+            counters[ii] = BUFFER_BYTES(pg->usage.shared_watermark);
+            break;
+
+        case SAI_INGRESS_PRIORITY_GROUP_STAT_XOFF_ROOM_CURR_OCCUPANCY_BYTES:
+            counters[ii] = BUFFER_BYTES(pg->usage.headroom_used);
+            break;
+
+        case SAI_INGRESS_PRIORITY_GROUP_STAT_XOFF_ROOM_WATERMARK_BYTES:
+            counters[ii] = BUFFER_BYTES(pg->usage.headroom_watermark);
+            break;
+
+        case STUB_INGRESS_PRIORITY_GROUP_STAT_XOFF_EVENTS:
+            counters[ii] = pg->xoff_count;
+            break;
+
+        case STUB_INGRESS_PRIORITY_GROUP_STAT_DROPPED_PACKETS:
+            counters[ii] = pg->dropped_packets;
+            break;
+
+        default:
+            counters[ii] = 0;
+            break;
+        }
+    }
+}
+
+/* Custom counters follow the standard ones in the priority group counter rows */
+static uint32_t ingress_pg_stat_slot(_In_ sai_ingress_priority_group_stat_t counter_id)
+{
+    switch ((int32_t)counter_id) {
+    case STUB_INGRESS_PRIORITY_GROUP_STAT_XOFF_EVENTS:
+        return SAI_INGRESS_PRIORITY_GROUP_STAT_XOFF_ROOM_WATERMARK_BYTES + 1;
+
+    case STUB_INGRESS_PRIORITY_GROUP_STAT_DROPPED_PACKETS:
+        return SAI_INGRESS_PRIORITY_GROUP_STAT_XOFF_ROOM_WATERMARK_BYTES + 2;
+
+    default:
+        return counter_id;
+    }
+}
+
+/* Load counters of priority groups from the counter cache, all from one snapshot. False when they aren't cached */
+static bool ingress_pg_stats_cache_read(_In_ uint32_t                                 number_of_pgs,
+                                        _In_ const sai_object_id_t                   *ingress_pg_ids,
+                                        _In_ const sai_ingress_priority_group_stat_t *counter_ids,
+                                        _In_ uint32_t                                 number_of_counters,
+                                        _Out_ uint64_t                               *counters)
+{
+    const uint64_t *rows;
+    uint64_t        seq, *row;
+    uint32_t        ii, jj, pg_id;
+
+    do {
+        if (NULL == (rows = db_counter_read_begin(COUNTER_TYPE_INGRESS_PG, &seq))) {
+            return false;
+        }
+
+        for (ii = 0, row = counters; ii < number_of_pgs; ii++, row += number_of_counters) {
+            stub_object_to_type(ingress_pg_ids[ii], SAI_OBJECT_TYPE_INGRESS_PRIORITY_GROUP, &pg_id);
+            for (jj = 0; jj < number_of_counters; jj++) {
+                row[jj] = __atomic_load_n(&rows[pg_id * BUFFER_PG_STAT_ROW + ingress_pg_stat_slot(counter_ids[jj])],
+                                          __ATOMIC_RELAXED);
+            }
+        }
+    } while (db_counter_read_retry(seq));
+
+    return true;
+}
+
+void db_buffer_pg_stats_all_get(_Out_ uint64_t *counters)
+{
+    sai_ingress_priority_group_stat_t ids[BUFFER_PG_STAT_ROW];
+    uint32_t                          ii;
+
+    for (ii = 0; ii <= SAI_INGRESS_PRIORITY_GROUP_STAT_XOFF_ROOM_WATERMARK_BYTES; ii++) {
+        ids[ii] = (sai_ingress_priority_group_stat_t)ii;
+    }
+    ids[ii++] = (sai_ingress_priority_group_stat_t)STUB_INGRESS_PRIORITY_GROUP_STAT_XOFF_EVENTS;
+    ids[ii++] = (sai_ingress_priority_group_stat_t)STUB_INGRESS_PRIORITY_GROUP_STAT_DROPPED_PACKETS;
+
+    for (ii = 0; ii < BUFFER_PG_NUMBER; ii++, counters += BUFFER_PG_STAT_ROW) {
+        ingress_pg_stats_read(&buffer_pg_db[ii], ids, BUFFER_PG_STAT_ROW, counters);
+    }
+}
+
+/*
+ * Read counters of a priority group for telemetry, the watermarks being the
+ * peaks since the last record of the subscription. Called with the simulator
+ * lock held
+ */
+sai_status_t db_buffer_pg_stats_sample(_In_ sai_object_id_t ingress_pg_id,
+                                       _In_ uint32_t        subscription,
+                                       _In_ const int32_t  *counter_ids,
+                                       _In_ uint32_t        number_of_counters,
+                                       _Out_ uint64_t      *counters)
+{
+    stub_buffer_pg_t *pg;
+    sai_status_t      status;
+    uint32_t          db_id, ii, used;
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_object_to_type(ingress_pg_id, SAI_OBJECT_TYPE_INGRESS_PRIORITY_GROUP, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_ingress_pg(db_id, &pg))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = ingress_pg_stats_check((const sai_ingress_priority_group_stat_t*)counter_ids,
+                                         number_of_counters))) {
+        return status;
+    }
+
+    ingress_pg_stats_read(pg, (const sai_ingress_priority_group_stat_t*)counter_ids, number_of_counters, counters);
+
+    for (ii = 0; ii < number_of_counters; ii++) {
+        switch (counter_ids[ii]) {
+        case SAI_INGRESS_PRIORITY_GROUP_STAT_WATERMARK_BYTES:
+            used         = pg->usage.reserved_used + pg->usage.shared_used + pg->usage.headroom_used;
+            counters[ii] = BUFFER_BYTES(db_telemetry_watermark_sample(&pg->telemetry_watermark, used, subscription));
+            break;
+
+        case SAI_INGRESS_PRIORITY_GROUP_STAT_SHARED_WATERMARK_BYTES:
+            counters[ii] = BUFFER_BYTES(db_telemetry_watermark_sample(&pg->telemetry_shared_watermark,
+                                                                      pg->usage.shared_used, subscription));
+            break;
+
+        case SAI_INGRESS_PRIORITY_GROUP_STAT_XOFF_ROOM_WATERMARK_BYTES:
+            counters[ii] = BUFFER_BYTES(db_telemetry_watermark_sample(&pg->telemetry_headroom_watermark,
+                                                                      pg->usage.headroom_used, subscription));
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Restart the watermarks of a priority group for a subscription, once its record is sent */
+sai_status_t db_buffer_pg_watermarks_restart(_In_ sai_object_id_t ingress_pg_id, _In_ uint32_t subscription)
+{
+    stub_buffer_pg_t *pg;
+    sai_status_t      status;
+    uint32_t          db_id;
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_object_to_type(ingress_pg_id, SAI_OBJECT_TYPE_INGRESS_PRIORITY_GROUP, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_ingress_pg(db_id, &pg))) {
+        return status;
+    }
+
+    db_telemetry_watermark_restart(&pg->telemetry_watermark, subscription);
+    db_telemetry_watermark_restart(&pg->telemetry_shared_watermark, subscription);
+    db_telemetry_watermark_restart(&pg->telemetry_headroom_watermark, subscription);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*************************/
+
+static void buffer_pool_key_to_str(_In_ sai_object_id_t pool_id, _Out_ char *key_str)
+{
+    uint32_t poolid;
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(pool_id, SAI_OBJECT_TYPE_BUFFER_POOL, &poolid)) {
+        snprintf(key_str, MAX_KEY_STR_LEN, "invalid buffer pool id");
+    } else {
+        snprintf(key_str, MAX_KEY_STR_LEN, "buffer pool id %u", poolid);
+    }
+}
+
+static void buffer_profile_key_to_str(_In_ sai_object_id_t profile_id, _Out_ char *key_str)
+{
+    uint32_t profileid;
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(profile_id, SAI_OBJECT_TYPE_BUFFER_PROFILE, &profileid)) {
+        snprintf(key_str, MAX_KEY_STR_LEN, "invalid buffer profile id");
+    } else {
+        snprintf(key_str, MAX_KEY_STR_LEN, "buffer profile id %u", profileid);
+    }
+}
+
+static void ingress_pg_key_to_str(_In_ sai_object_id_t pg_id, _Out_ char *key_str)
+{
+    uint32_t pgid;
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(pg_id, SAI_OBJECT_TYPE_INGRESS_PRIORITY_GROUP, &pgid)) {
+        snprintf(key_str, MAX_KEY_STR_LEN, "invalid ingress priority group id");
+    } else {
+        snprintf(key_str, MAX_KEY_STR_LEN, "ingress priority group port %u index %u", pgid / BUFFER_PG_PER_PORT,
+                 pgid % BUFFER_PG_PER_PORT);
+    }
+}
+
+/*
+ * Routine Description:
+ *    Create buffer pool
+ *
+ * Arguments:
+ *    [out] pool_id - buffer pool id
+ *    [in] switch_id - switch id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_buffer_pool(_Out_ sai_object_id_t      *pool_id,
+                                     _In_ sai_object_id_t        switch_id,
+                                     _In_ uint32_t               attr_count,
+                                     _In_ const sai_attribute_t *attr_list)
+{
+    sai_status_t                 status;
+    const sai_attribute_value_t *type, *size, *mode, *xoff_size;
+    uint32_t                     type_index, size_index, mode_index, xoff_index, db_id = 0;
+    stub_buffer_pool_t          *pool;
+    char                         list_str[MAX_LIST_VALUE_STR_LEN];
+    char                         key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == pool_id) {
+        STUB_LOG_ERR("NULL buffer pool id param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = check_attribs_metadata(attr_count, attr_list, buffer_pool_attribs, buffer_pool_vendor_attribs,
+                                         SAI_OPERATION_CREATE))) {
+        STUB_LOG_ERR("Failed attribs check\n");
+        return status;
+    }
+
+    sai_attr_list_to_str(attr_count, attr_list, buffer_pool_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create buffer pool, %s\n", list_str);
+
+    status = find_attrib_in_list(attr_count, attr_list, SAI_BUFFER_POOL_ATTR_TYPE, &type, &type_index);
+    assert(SAI_STATUS_SUCCESS == status);
+    status = find_attrib_in_list(attr_count, attr_list, SAI_BUFFER_POOL_ATTR_SIZE, &size, &size_index);
+    assert(SAI_STATUS_SUCCESS == status);
+
+    if ((SAI_BUFFER_POOL_TYPE_INGRESS != type->s32) && (SAI_BUFFER_POOL_TYPE_EGRESS != type->s32)) {
+        STUB_LOG_ERR("Invalid buffer pool type %d\n", type->s32);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + type_index;
+    }
+
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_BUFFER_POOL_ATTR_THRESHOLD_MODE, &mode, &mode_index)) {
+        if ((SAI_BUFFER_POOL_THRESHOLD_MODE_STATIC != mode->s32) &&
+            (SAI_BUFFER_POOL_THRESHOLD_MODE_DYNAMIC != mode->s32)) {
+            STUB_LOG_ERR("Invalid buffer pool threshold mode %d\n", mode->s32);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + mode_index;
+        }
+    } else {
+        mode = NULL;
+    }
+
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_BUFFER_POOL_ATTR_XOFF_SIZE, &xoff_size, &xoff_index)) {
+        if ((SAI_BUFFER_POOL_TYPE_INGRESS != type->s32) && (0 != xoff_size->u32)) {
+            STUB_LOG_ERR("XOFF size is only valid for an ingress buffer pool\n");
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + xoff_index;
+        }
+    } else {
+        xoff_size = NULL;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_find_free_buffer_pool_index(&db_id))) {
+        return status;
+    }
+
+    pool = &buffer_pool_db[db_id];
+    memset(pool, 0, sizeof(*pool));
+    pool->type = type->s32;
+    pool->mode = mode ? mode->s32 : SAI_BUFFER_POOL_THRESHOLD_MODE_DYNAMIC;
+
+    if (SAI_STATUS_SUCCESS != (status = buffer_pool_reserve(pool, size->u32, xoff_size ? xoff_size->u32 : 0, 0))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = stub_create_object(SAI_OBJECT_TYPE_BUFFER_POOL, db_id, pool_id))) {
+        return status;
+    }
+
+    pool->is_valid = true;
+
+    buffer_pool_key_to_str(*pool_id, key_str);
+    STUB_LOG_NTC("Created buffer pool %s\n", key_str);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Remove buffer pool
+ *
+ * Arguments:
+ *    [in] pool_id - buffer pool id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_buffer_pool(_In_ sai_object_id_t pool_id)
+{
+    char                key_str[MAX_KEY_STR_LEN];
+    sai_status_t        status;
+    uint32_t            db_id;
+    stub_buffer_pool_t *pool;
+
+    STUB_LOG_ENTER();
+
+    buffer_pool_key_to_str(pool_id, key_str);
+    STUB_LOG_NTC("Remove buffer pool %s\n", key_str);
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(pool_id, SAI_OBJECT_TYPE_BUFFER_POOL, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_buffer_pool(db_id, &pool))) {
+        return status;
+    }
+
+    if (0 != pool->ref_count) {
+        STUB_LOG_ERR("Buffer pool ID %u is used by %u buffer profiles\n", db_id, pool->ref_count);
+        return SAI_STATUS_OBJECT_IN_USE;
+    }
+
+    pool->is_valid = false;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Set buffer pool attribute
+ *
+ * Arguments:
+ *    [in] pool_id - buffer pool id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_buffer_pool_attribute(_In_ sai_object_id_t pool_id, _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = pool_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    buffer_pool_key_to_str(pool_id, key_str);
+    return sai_set_attribute(&key, key_str, buffer_pool_attribs, buffer_pool_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get buffer pool attributes
+ *
+ * Arguments:
+ *    [in] pool_id - buffer pool id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_buffer_pool_attribute(_In_ sai_object_id_t     pool_id,
+                                            _In_ uint32_t            attr_count,
+                                            _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = pool_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    buffer_pool_key_to_str(pool_id, key_str);
+    return sai_get_attributes(&key, key_str, buffer_pool_attribs, buffer_pool_vendor_attribs, attr_count,
+                              attr_list);
+}
+
+/* Buffer pool attributes [uint32_t sizes, sai_buffer_pool_type_t type, sai_buffer_pool_threshold_mode_t mode] */
+sai_status_t stub_buffer_pool_attr_get(_In_ const sai_object_key_t   *key,
+                                       _Inout_ sai_attribute_value_t *value,
+                                       _In_ uint32_t                  attr_index,
+                                       _Inout_ vendor_cache_t        *cache,
+                                       void                          *arg)
+{
+    sai_status_t        status;
+    uint32_t            db_id;
+    stub_buffer_pool_t *pool;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_BUFFER_POOL, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_buffer_pool(db_id, &pool))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_BUFFER_POOL_ATTR_SHARED_SIZE:
+        value->u32 = (uint32_t)BUFFER_BYTES(pool->shared_cells);
+        break;
+
+    case SAI_BUFFER_POOL_ATTR_TYPE:
+        value->s32 = pool->type;
+        break;
+
+    case SAI_BUFFER_POOL_ATTR_SIZE:
+        value->u32 = pool->size;
+        break;
+
+    case SAI_BUFFER_POOL_ATTR_THRESHOLD_MODE:
+        value->s32 = pool->mode;
+        break;
+
+    case SAI_BUFFER_POOL_ATTR_XOFF_SIZE:
+        value->u32 = pool->xoff_size;
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid buffer pool attribute %d\n", (int32_t)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Buffer pool attributes [uint32_t size, uint32_t xoff_size] */
+sai_status_t stub_buffer_pool_attr_set(_In_ const sai_object_key_t      *key,
+                                       _In_ const sai_attribute_value_t *value,
+                                       void                             *arg)
+{
+    sai_status_t        status;
+    uint32_t            db_id;
+    stub_buffer_pool_t *pool;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_BUFFER_POOL, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_buffer_pool(db_id, &pool))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_BUFFER_POOL_ATTR_SIZE:
+        if (SAI_STATUS_SUCCESS != (status = buffer_pool_reserve(pool, value->u32, pool->xoff_size, 0))) {
+            return status;
+        }
+        break;
+
+    case SAI_BUFFER_POOL_ATTR_XOFF_SIZE:
+        if ((SAI_BUFFER_POOL_TYPE_INGRESS != pool->type) && (0 != value->u32)) {
+            STUB_LOG_ERR("XOFF size is only valid for an ingress buffer pool\n");
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        if (SAI_STATUS_SUCCESS != (status = buffer_pool_reserve(pool, pool->size, value->u32, 0))) {
+            return status;
+        }
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid buffer pool attribute %d\n", (int32_t)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *   Get buffer pool statistics counters.
+ *
+ * Arguments:
+ *    [in] pool_id - buffer pool id
+ *    [in] counter_ids - specifies the array of counter ids
+ *    [in] number_of_counters - number of counters in the array
+ *    [out] counters - array of resulting counter values.
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_buffer_pool_stats(_In_ sai_object_id_t               pool_id,
+                                        _In_ const sai_buffer_pool_stat_t *counter_ids,
+                                        _In_ uint32_t                      number_of_counters,
+                                        _Out_ uint64_t                    *counters)
+{
+    sai_status_t        status;
+    uint32_t            ii, db_id;
+    stub_buffer_pool_t *pool;
+    char                key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    buffer_pool_key_to_str(pool_id, key_str);
+    STUB_LOG_NTC("Get buffer pool stats %s\n", key_str);
+
+    if (NULL == counter_ids) {
+        STUB_LOG_ERR("NULL counter ids array param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (NULL == counters) {
+        STUB_LOG_ERR("NULL counters array param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(pool_id, SAI_OBJECT_TYPE_BUFFER_POOL, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_buffer_pool(db_id, &pool))) {
+        return status;
+    }
+
+    for (ii = 0; ii < number_of_counters; ii++) {
+        switch (counter_ids[ii]) {
+        case SAI_BUFFER_POOL_STAT_CURR_OCCUPANCY_BYTES:
+            counters[ii] = BUFFER_BYTES(pool->reserved_used + pool->shared_used + pool->headroom_used);
+            break;
+
+        case SAI_BUFFER_POOL_STAT_WATERMARK_BYTES:
+            counters[ii] = BUFFER_BYTES(pool->watermark);
+            break;
+
+        default:
+            STUB_LOG_ERR("Invalid buffer pool counter %d\n", counter_ids[ii]);
+            return SAI_STATUS_INVALID_PARAMETER;
+        }
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t buffer_profile_attr_apply(_Inout_ stub_buffer_profile_t     *profile,
+                                              _In_ sai_attr_id_t                 attr_id,
+                                              _In_ const sai_attribute_value_t *value)
+{
+    switch (attr_id) {
+    case SAI_BUFFER_PROFILE_ATTR_POOL_ID:
+        profile->pool = value->oid;
+        break;
+
+    case SAI_BUFFER_PROFILE_ATTR_BUFFER_SIZE:
+        profile->buffer_size = value->u32;
+        break;
+
+    case SAI_BUFFER_PROFILE_ATTR_THRESHOLD_MODE:
+        if ((value->s32 < SAI_BUFFER_PROFILE_THRESHOLD_MODE_STATIC) ||
+            (value->s32 > SAI_BUFFER_PROFILE_THRESHOLD_MODE_INHERIT_BUFFER_POOL_MODE)) {
+            STUB_LOG_ERR("Invalid buffer profile threshold mode %d\n", value->s32);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        profile->mode = value->s32;
+        break;
+
+    case SAI_BUFFER_PROFILE_ATTR_SHARED_DYNAMIC_TH:
+        if ((value->s8 < BUFFER_MIN_DYNAMIC_TH) || (value->s8 > BUFFER_MAX_DYNAMIC_TH)) {
+            STUB_LOG_ERR("Invalid buffer profile dynamic threshold %d\n", value->s8);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        profile->dynamic_th = value->s8;
+        break;
+
+    case SAI_BUFFER_PROFILE_ATTR_SHARED_STATIC_TH:
+        profile->static_th = value->u32;
+        break;
+
+    case SAI_BUFFER_PROFILE_ATTR_XOFF_TH:
+        profile->xoff_th = value->u32;
+        break;
+
+    case SAI_BUFFER_PROFILE_ATTR_XON_TH:
+        profile->xon_th = value->u32;
+        break;
+
+    case SAI_BUFFER_PROFILE_ATTR_XON_OFFSET_TH:
+        profile->xon_offset_th = value->u32;
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid buffer profile attribute %d\n", attr_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Create buffer profile
+ *
+ * Arguments:
+ *    [out] buffer_profile_id - buffer profile id
+ *    [in] switch_id - switch id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_buffer_profile(_Out_ sai_object_id_t      *buffer_profile_id,
+                                        _In_ sai_object_id_t        switch_id,
+                                        _In_ uint32_t               attr_count,
+                                        _In_ const sai_attribute_t *attr_list)
+{
+    sai_status_t                 status;
+    const sai_attribute_value_t *threshold;
+    stub_buffer_profile_t        params;
+    stub_buffer_pool_t          *pool;
+    uint32_t                     ii, threshold_index, pool_id = BUFFER_NONE, db_id = 0;
+    char                         list_str[MAX_LIST_VALUE_STR_LEN];
+    char                         key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == buffer_profile_id) {
+        STUB_LOG_ERR("NULL buffer profile id param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = check_attribs_metadata(attr_count, attr_list, buffer_profile_attribs,
+                                         buffer_profile_vendor_attribs, SAI_OPERATION_CREATE))) {
+        STUB_LOG_ERR("Failed attribs check\n");
+        return status;
+    }
+
+    sai_attr_list_to_str(attr_count, attr_list, buffer_profile_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create buffer profile, %s\n", list_str);
+
+    memset(&params, 0, sizeof(params));
+    params.mode = SAI_BUFFER_PROFILE_THRESHOLD_MODE_INHERIT_BUFFER_POOL_MODE;
+
+    for (ii = 0; ii < attr_count; ii++) {
+        if (SAI_STATUS_SUCCESS !=
+            (status = buffer_profile_attr_apply(&params, attr_list[ii].id, &attr_list[ii].value))) {
+            return (SAI_STATUS_INVALID_ATTR_VALUE_0 == status) ? SAI_STATUS_INVALID_ATTR_VALUE_0 + ii : status;
+        }
+    }
+
+    if (SAI_NULL_OBJECT_ID != params.pool) {
+        if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(params.pool, SAI_OBJECT_TYPE_BUFFER_POOL, &pool_id))) {
+            return status;
+        }
+        if (SAI_STATUS_SUCCESS != (status = db_get_buffer_pool(pool_id, &pool))) {
+            return status;
+        }
+    }
+    params.pool_id = pool_id;
+    buffer_profile_cells_update(&params);
+
+    /* The threshold of the mode in use must be given */
+    if (SAI_STATUS_SUCCESS !=
+        find_attrib_in_list(attr_count, attr_list,
+                            params.dynamic ? SAI_BUFFER_PROFILE_ATTR_SHARED_DYNAMIC_TH :
+                            SAI_BUFFER_PROFILE_ATTR_SHARED_STATIC_TH, &threshold, &threshold_index)) {
+        STUB_LOG_ERR("Missing mandatory buffer profile %s threshold\n", params.dynamic ? "dynamic" : "static");
+        return SAI_STATUS_MANDATORY_ATTRIBUTE_MISSING;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_find_free_buffer_profile_index(&db_id))) {
+        return status;
+    }
+
+    buffer_profile_db[db_id]          = params;
+    buffer_profile_db[db_id].is_valid = true;
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_create_object(SAI_OBJECT_TYPE_BUFFER_PROFILE, db_id, buffer_profile_id))) {
+        buffer_profile_db[db_id].is_valid = false;
+        return status;
+    }
+
+    if (BUFFER_NONE != pool_id) {
+        buffer_pool_db[pool_id].ref_count++;
+    }
+
+    buffer_profile_key_to_str(*buffer_profile_id, key_str);
+    STUB_LOG_NTC("Created buffer profile %s\n", key_str);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Remove buffer profile
+ *
+ * Arguments:
+ *    [in] buffer_profile_id - buffer profile id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_buffer_profile(_In_ sai_object_id_t buffer_profile_id)
+{
+    char                   key_str[MAX_KEY_STR_LEN];
+    sai_status_t           status;
+    uint32_t               db_id;
+    stub_buffer_profile_t *profile;
+
+    STUB_LOG_ENTER();
+
+    buffer_profile_key_to_str(buffer_profile_id, key_str);
+    STUB_LOG_NTC("Remove buffer profile %s\n", key_str);
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_object_to_type(buffer_profile_id, SAI_OBJECT_TYPE_BUFFER_PROFILE, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_buffer_profile(db_id, &profile))) {
+        return status;
+    }
+
+    if (0 != profile->ref_count) {
+        STUB_LOG_ERR("Buffer profile ID %u is used by %u priority groups and queues\n", db_id, profile->ref_count);
+        return SAI_STATUS_OBJECT_IN_USE;
+    }
+
+    if (BUFFER_NONE != profile->pool_id) {
+        assert(buffer_pool_db[profile->pool_id].ref_count > 0);
+        buffer_pool_db[profile->pool_id].ref_count--;
+    }
+
+    profile->is_valid = false;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Set buffer profile attribute
+ *
+ * Arguments:
+ *    [in] buffer_profile_id - buffer profile id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_buffer_profile_attribute(_In_ sai_object_id_t buffer_profile_id, _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = buffer_profile_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    buffer_profile_key_to_str(buffer_profile_id, key_str);
+    return sai_set_attribute(&key, key_str, buffer_profile_attribs, buffer_profile_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get buffer profile attributes
+ *
+ * Arguments:
+ *    [in] buffer_profile_id - buffer profile id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_buffer_profile_attribute(_In_ sai_object_id_t     buffer_profile_id,
+                                               _In_ uint32_t            attr_count,
+                                               _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = buffer_profile_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    buffer_profile_key_to_str(buffer_profile_id, key_str);
+    return sai_get_attributes(&key, key_str, buffer_profile_attribs, buffer_profile_vendor_attribs, attr_count,
+                              attr_list);
+}
+
+/* Buffer profile attributes [sai_object_id_t pool, uint32_t sizes and thresholds, int8_t dynamic threshold,
+ * sai_buffer_profile_threshold_mode_t mode] */
+sai_status_t stub_buffer_profile_attr_get(_In_ const sai_object_key_t   *key,
+                                          _Inout_ sai_attribute_value_t *value,
+                                          _In_ uint32_t                  attr_index,
+                                          _Inout_ vendor_cache_t        *cache,
+                                          void                          *arg)
+{
+    sai_status_t           status;
+    uint32_t               db_id;
+    stub_buffer_profile_t *profile;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_BUFFER_PROFILE, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_buffer_profile(db_id, &profile))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_BUFFER_PROFILE_ATTR_POOL_ID:
+        value->oid = profile->pool;
+        break;
+
+    case SAI_BUFFER_PROFILE_ATTR_BUFFER_SIZE:
+        value->u32 = profile->buffer_size;
+        break;
+
+    case SAI_BUFFER_PROFILE_ATTR_THRESHOLD_MODE:
+        value->s32 = profile->mode;
+        break;
+
+    case SAI_BUFFER_PROFILE_ATTR_SHARED_DYNAMIC_TH:
+        value->s8 = profile->dynamic_th;
+        break;
+
+    case SAI_BUFFER_PROFILE_ATTR_SHARED_STATIC_TH:
+        value->u32 = profile->static_th;
+        break;
+
+    case SAI_BUFFER_PROFILE_ATTR_XOFF_TH:
+        value->u32 = profile->xoff_th;
+        break;
+
+    case SAI_BUFFER_PROFILE_ATTR_XON_TH:
+        value->u32 = profile->xon_th;
+        break;
+
+    case SAI_BUFFER_PROFILE_ATTR_XON_OFFSET_TH:
+        value->u32 = profile->xon_offset_th;
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid buffer profile attribute %d\n", (int32_t)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Buffer profile attributes [uint32_t sizes and thresholds, int8_t dynamic threshold,
+ * sai_buffer_profile_threshold_mode_t mode].
+ * A new reserved size moves the reserved cells of all the users of the profile.
+ */
+sai_status_t stub_buffer_profile_attr_set(_In_ const sai_object_key_t      *key,
+                                          _In_ const sai_attribute_value_t *value,
+                                          void                             *arg)
+{
+    sai_status_t           status;
+    uint32_t               db_id;
+    stub_buffer_profile_t *profile, params;
+    stub_buffer_pool_t    *pool;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_BUFFER_PROFILE, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_buffer_profile(db_id, &profile))) {
+        return status;
+    }
+
+    params = *profile;
+    if (SAI_STATUS_SUCCESS != (status = buffer_profile_attr_apply(&params, (sai_attr_id_t)(int64_t)arg, value))) {
+        return status;
+    }
+    buffer_profile_cells_update(&params);
+
+    if ((params.reserved_cells != profile->reserved_cells) && (0 != profile->ref_count)) {
+        pool = &buffer_pool_db[profile->pool_id];
+        if (SAI_STATUS_SUCCESS !=
+            (status = buffer_pool_reserve(pool, pool->size, pool->xoff_size,
+                                          ((int64_t)params.reserved_cells - profile->reserved_cells) *
+                                          profile->ref_count))) {
+            return status;
+        }
+    }
+
+    *profile = params;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Set ingress priority group attribute
+ *
+ * Arguments:
+ *    [in] ingress_pg_id - ingress priority group id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_ingress_priority_group_attribute(_In_ sai_object_id_t        ingress_pg_id,
+                                                       _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = ingress_pg_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    ingress_pg_key_to_str(ingress_pg_id, key_str);
+    return sai_set_attribute(&key, key_str, ingress_pg_attribs, ingress_pg_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get ingress priority group attributes
+ *
+ * Arguments:
+ *    [in] ingress_pg_id - ingress priority group id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_ingress_priority_group_attribute(_In_ sai_object_id_t     ingress_pg_id,
+                                                       _In_ uint32_t            attr_count,
+                                                       _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = ingress_pg_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    ingress_pg_key_to_str(ingress_pg_id, key_str);
+    return sai_get_attributes(&key, key_str, ingress_pg_attribs, ingress_pg_vendor_attribs, attr_count, attr_list);
+}
+
+/* Buffer profile [sai_object_id_t] */
+sai_status_t stub_ingress_pg_profile_get(_In_ const sai_object_key_t   *key,
+                                         _Inout_ sai_attribute_value_t *value,
+                                         _In_ uint32_t                  attr_index,
+                                         _Inout_ vendor_cache_t        *cache,
+                                         void                          *arg)
+{
+    sai_status_t      status;
+    uint32_t          db_id;
+    stub_buffer_pg_t *pg;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_INGRESS_PRIORITY_GROUP, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_ingress_pg(db_id, &pg))) {
+        return status;
+    }
+
+    value->oid = pg->usage.profile;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Buffer profile [sai_object_id_t], the priority group must be empty */
+sai_status_t stub_ingress_pg_profile_set(_In_ const sai_object_key_t      *key,
+                                         _In_ const sai_attribute_value_t *value,
+                                         void                             *arg)
+{
+    sai_status_t      status;
+    uint32_t          db_id;
+    stub_buffer_pg_t *pg;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_INGRESS_PRIORITY_GROUP, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_ingress_pg(db_id, &pg))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = buffer_usage_bind(&pg->usage, value->oid, SAI_BUFFER_POOL_TYPE_INGRESS))) {
+        return status;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *   Get ingress priority group statistics counters.
+ *
+ * Arguments:
+ *    [in] ingress_pg_id - ingress priority group id
+ *    [in] counter_ids - specifies the array of counter ids
+ *    [in] number_of_counters - number of counters in the array
+ *    [out] counters - array of resulting counter values.
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_ingress_priority_group_stats(_In_ sai_object_id_t                          ingress_pg_id,
+                                                   _In_ const sai_ingress_priority_group_stat_t *counter_ids,
+                                                   _In_ uint32_t                                 number_of_counters,
+                                                   _Out_ uint64_t                               *counters)
+{
+    sai_status_t      status;
+    uint32_t          db_id;
+    stub_buffer_pg_t *pg;
+    char              key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    ingress_pg_key_to_str(ingress_pg_id, key_str);
+    STUB_LOG_NTC("Get ingress priority group stats %s\n", key_str);
+
+    if (NULL == counter_ids) {
+        STUB_LOG_ERR("NULL counter ids array param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (NULL == counters) {
+        STUB_LOG_ERR("NULL counters array param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_object_to_type(ingress_pg_id, SAI_OBJECT_TYPE_INGRESS_PRIORITY_GROUP, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_ingress_pg(db_id, &pg))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = ingress_pg_stats_check(counter_ids, number_of_counters))) {
+        return status;
+    }
+
+    if (!ingress_pg_stats_cache_read(1, &ingress_pg_id, counter_ids, number_of_counters, counters)) {
+        ingress_pg_stats_read(pg, counter_ids, number_of_counters, counters);
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *   Get statistics counters of several ingress priority groups.
+ *
+ * Arguments:
+ *    [in] number_of_pgs - number of ingress priority groups in the array
+ *    [in] ingress_pg_ids - array of ingress priority group ids
+ *    [in] counter_ids - specifies the array of counter ids, read for each priority group
+ *    [in] number_of_counters - number of counters in the array
+ *    [out] counters - matrix of resulting counter values, a row per priority group
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_ingress_priority_group_stats_bulk(_In_ uint32_t                                 number_of_pgs,
+                                                        _In_ const sai_object_id_t                   *ingress_pg_ids,
+                                                        _In_ const sai_ingress_priority_group_stat_t *counter_ids,
+                                                        _In_ uint32_t                                 number_of_counters,
+                                                        _Out_ uint64_t                               *counters)
+{
+    sai_status_t      status;
+    uint32_t          ii, db_id;
+    stub_buffer_pg_t *pg;
+
+    STUB_LOG_ENTER();
+
+    STUB_LOG_NTC("Get ingress priority group stats bulk, %u priority groups %u counters\n",
+                 number_of_pgs, number_of_counters);
+
+    if (NULL == ingress_pg_ids) {
+        STUB_LOG_ERR("NULL ingress priority group ids array param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (NULL == counter_ids) {
+        STUB_LOG_ERR("NULL counter ids array param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (NULL == counters) {
+        STUB_LOG_ERR("NULL counters array param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = ingress_pg_stats_check(counter_ids, number_of_counters))) {
+        return status;
+    }
+
+    /* Validate all the priority groups first, nothing is read if any id is wrong */
+    for (ii = 0; ii < number_of_pgs; ii++) {
+        if (SAI_STATUS_SUCCESS !=
+            (status = stub_object_to_type(ingress_pg_ids[ii], SAI_OBJECT_TYPE_INGRESS_PRIORITY_GROUP, &db_id))) {
+            return status;
+        }
+
+        if (SAI_STATUS_SUCCESS != (status = db_get_ingress_pg(db_id, &pg))) {
+            return status;
+        }
+    }
+
+    if (ingress_pg_stats_cache_read(number_of_pgs, ingress_pg_ids, counter_ids, number_of_counters, counters)) {
+        STUB_LOG_EXIT();
+        return SAI_STATUS_SUCCESS;
+    }
+
+    /* The simulator is held off while the rows are filled, so they are one snapshot */
+    db_sim_lock();
+    for (ii = 0; ii < number_of_pgs; ii++) {
+        stub_object_to_type(ingress_pg_ids[ii], SAI_OBJECT_TYPE_INGRESS_PRIORITY_GROUP, &db_id);
+        db_get_ingress_pg(db_id, &pg);
+        ingress_pg_stats_read(pg, counter_ids, number_of_counters, counters + ii * number_of_counters);
+    }
+    db_sim_unlock();
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *   Clear ingress priority group statistics counters.
+ *
+ * Arguments:
+ *    [in] ingress_pg_id - ingress priority group id
+ *    [in] counter_ids - specifies the array of counter ids
+ *    [in] number_of_counters - number of counters in the array
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_clear_ingress_priority_group_stats(_In_ sai_object_id_t                          ingress_pg_id,
+                                                     _In_ const sai_ingress_priority_group_stat_t *counter_ids,
+                                                     _In_ uint32_t                                 number_of_counters)
+{
+    sai_status_t      status;
+    uint32_t          ii, db_id;
+    stub_buffer_pg_t *pg;
+    char              key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    ingress_pg_key_to_str(ingress_pg_id, key_str);
+    STUB_LOG_NTC("Clear ingress priority group stats %s\n", key_str);
+
+    if (NULL == counter_ids) {
+        STUB_LOG_ERR("NULL counter ids array param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_object_to_type(ingress_pg_id, SAI_OBJECT_TYPE_INGRESS_PRIORITY_GROUP, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_ingress_pg(db_id, &pg))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = ingress_pg_stats_check(counter_ids, number_of_counters))) {
+        return status;
+    }
+
+    db_sim_lock();
+    for (ii = 0; ii < number_of_counters; ii++) {
+        switch ((int32_t)counter_ids[ii]) {
+        case SAI_INGRESS_PRIORITY_GROUP_STAT_PACKETS:
+        case SAI_INGRESS_PRIORITY_GROUP_STAT_BYTES:
+            pg->counters[counter_ids[ii]] = 0;
+            break;
+
+        /* Occupancy is a gauge, watermarks restart from it */
+        case SAI_INGRESS_PRIORITY_GROUP_STAT_WATERMARK_BYTES:
+            pg->usage.watermark = pg->usage.reserved_used + pg->usage.shared_used + pg->usage.headroom_used;
+            break;
+
+        case SAI_INGRESS_PRIORITY_GROUP_STAT_SHARED_WATERMARK_BYTES:
+            pg->usage.shared_watermark = pg->usage.shared_used;
+            break;
+
+        case SAI_INGRESS_PRIORITY_GROUP_STAT_XOFF_ROOM_WATERMARK_BYTES:
+            pg->usage.headroom_watermark = pg->usage.headroom_used;
+            break;
+
+        case STUB_INGRESS_PRIORITY_GROUP_STAT_XOFF_EVENTS:
+            pg->xoff_count = 0;
+            break;
+
+        case STUB_INGRESS_PRIORITY_GROUP_STAT_DROPPED_PACKETS:
+            pg->dropped_packets = 0;
+            break;
+
+        default:
+            break;
+        }
+    }
+    db_sim_unlock();
+
+    db_counter_refresh();
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+const sai_buffer_api_t buffer_api = {
+    stub_create_buffer_pool,
+    stub_remove_buffer_pool,
+    stub_set_buffer_pool_attribute,
+    stub_get_buffer_pool_attribute,
+    stub_get_buffer_pool_stats,
+    stub_set_ingress_priority_group_attribute,
+    stub_get_ingress_priority_group_attribute,
+    stub_get_ingress_priority_group_stats,
+    stub_clear_ingress_priority_group_stats,
+    stub_create_buffer_profile,
+    stub_remove_buffer_profile,
+    stub_set_buffer_profile_attribute,
+    stub_get_buffer_profile_attribute,
+    stub_get_ingress_priority_group_stats_bulk
+};
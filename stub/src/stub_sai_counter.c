@@ -0,0 +1,250 @@
+/*
+ *  Copyright (C) 2014. Mellanox Technologies, Ltd. ALL RIGHTS RESERVED.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ */
+
+#include "sai.h"
+#include "stub_sai.h"
+#include "assert.h"
+#include "errno.h"
+#include "pthread.h"
+#include "time.h"
+
+#undef  __MODULE__
+#define __MODULE__ SAI_COUNTER
+
+/*
+ * With a non zero SAI_SWITCH_ATTR_COUNTER_REFRESH_INTERVAL, the port, queue,
+ * ingress priority group and policer counters are cached. A thread snapshots
+ * them all every interval, and the stats getters only load the snapshot, so
+ * polling them costs the same whatever the number of cores summed or the
+ * simulator state walked to compute them.
+ *
+ * The snapshot is double buffered. It is taken into a staging copy owned by
+ * the thread, then copied to the shadow buffer readers don't use, which is
+ * published by incrementing the sequence number. The sequence number picks
+ * the buffer to read, and a reader finding it changed after loading its
+ * values loads them again. Readers never wait for the thread, which only
+ * writes the buffer they read once it published the other one.
+ */
+
+/* State DB *************/
+typedef struct _stub_counter_shadow_t {
+    uint64_t port[PORT_NUMBER * PORT_STAT_COUNT];
+    uint64_t queue[MAX_QUEUE_NUMBER * QUEUE_STAT_ROW];
+    uint64_t ingress_pg[BUFFER_PG_NUMBER * BUFFER_PG_STAT_ROW];
+    uint64_t policer[MAX_POLICER_NUMBER * POLICER_STAT_ROW];
+} stub_counter_shadow_t;
+
+static stub_counter_shadow_t counter_staging;
+static stub_counter_shadow_t counter_shadow[2];
+/* Last published snapshot is in counter_shadow[counter_seq % 2], none while 0 */
+static uint64_t              counter_seq;
+static pthread_t             counter_thread;
+/* Serializes the snapshots of the thread and of refresh requests */
+static pthread_mutex_t       counter_snapshot_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t       counter_lock          = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t        counter_cond;
+static bool                  counter_running;
+static uint32_t              counter_refresh_interval = COUNTER_DEFAULT_REFRESH_INTERVAL;
+
+static uint64_t counter_now()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+static void counter_snapshot()
+{
+    const uint64_t *staging = (const uint64_t*)&counter_staging;
+    uint64_t       *shadow;
+    uint64_t        seq;
+    uint32_t        ii;
+
+    pthread_mutex_lock(&counter_snapshot_lock);
+
+    db_sim_lock();
+    db_port_stats_all_get(counter_staging.port);
+    db_queue_stats_all_get(counter_staging.queue);
+    db_buffer_pg_stats_all_get(counter_staging.ingress_pg);
+    db_sim_unlock();
+    db_policer_stats_all_get(counter_staging.policer);
+
+    /*
+     * Readers of this buffer loaded the sequence number before the last one
+     * was published, the fence orders that publish before the stores below,
+     * so a reader seeing any of them sees the sequence number changed.
+     */
+    seq    = counter_seq;
+    shadow = (uint64_t*)&counter_shadow[(seq + 1) % 2];
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    for (ii = 0; ii < sizeof(stub_counter_shadow_t) / sizeof(uint64_t); ii++) {
+        __atomic_store_n(&shadow[ii], staging[ii], __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&counter_seq, seq + 1, __ATOMIC_RELEASE);
+
+    pthread_mutex_unlock(&counter_snapshot_lock);
+}
+
+static void* counter_thread_run(void *arg)
+{
+    struct timespec deadline;
+    uint64_t        deadline_ns;
+    uint32_t        interval;
+
+    pthread_mutex_lock(&counter_lock);
+    while (__atomic_load_n(&counter_running, __ATOMIC_ACQUIRE)) {
+        interval = __atomic_load_n(&counter_refresh_interval, __ATOMIC_RELAXED);
+        if (0 == interval) {
+            pthread_cond_wait(&counter_cond, &counter_lock);
+            continue;
+        }
+
+        /* Interval changes and refresh requests wake the thread up, restarting the interval */
+        deadline_ns      = counter_now() + interval * 1000000000ULL;
+        deadline.tv_sec  = deadline_ns / 1000000000ULL;
+        deadline.tv_nsec = deadline_ns % 1000000000ULL;
+        if (ETIMEDOUT != pthread_cond_timedwait(&counter_cond, &counter_lock, &deadline)) {
+            continue;
+        }
+
+        pthread_mutex_unlock(&counter_lock);
+        counter_snapshot();
+        pthread_mutex_lock(&counter_lock);
+    }
+    pthread_mutex_unlock(&counter_lock);
+
+    return NULL;
+}
+
+/* Start the counter thread, with a first snapshot taken before returning */
+sai_status_t db_counter_start()
+{
+    pthread_condattr_t attr;
+    int                err;
+
+    if (__atomic_load_n(&counter_running, __ATOMIC_ACQUIRE)) {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&counter_cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    counter_snapshot();
+
+    __atomic_store_n(&counter_running, true, __ATOMIC_RELEASE);
+    if (0 != (err = pthread_create(&counter_thread, NULL, counter_thread_run, NULL))) {
+        __atomic_store_n(&counter_running, false, __ATOMIC_RELEASE);
+        pthread_cond_destroy(&counter_cond);
+        STUB_LOG_ERR("Failed to start counter thread, %s\n", strerror(err));
+        return SAI_STATUS_FAILURE;
+    }
+
+    STUB_LOG_NTC("Counter thread started, refresh interval %u s\n", counter_refresh_interval);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Stop the counter thread, counters are read directly again */
+void db_counter_stop()
+{
+    if (!__atomic_load_n(&counter_running, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+
+    pthread_mutex_lock(&counter_lock);
+    __atomic_store_n(&counter_running, false, __ATOMIC_RELEASE);
+    pthread_cond_signal(&counter_cond);
+    pthread_mutex_unlock(&counter_lock);
+
+    pthread_join(counter_thread, NULL);
+    pthread_cond_destroy(&counter_cond);
+}
+
+/* Setting the interval, even to its current value, refreshes the counters */
+void db_counter_refresh_interval_set(_In_ uint32_t interval)
+{
+    __atomic_store_n(&counter_refresh_interval, interval, __ATOMIC_RELAXED);
+
+    db_counter_refresh();
+}
+
+uint32_t db_counter_refresh_interval_get()
+{
+    return __atomic_load_n(&counter_refresh_interval, __ATOMIC_RELAXED);
+}
+
+/*
+ * Snapshot the counters before returning, so they reflect everything counted
+ * so far, and restart the refresh interval from now
+ */
+void db_counter_refresh()
+{
+    if (!__atomic_load_n(&counter_running, __ATOMIC_ACQUIRE) ||
+        (0 == __atomic_load_n(&counter_refresh_interval, __ATOMIC_RELAXED))) {
+        return;
+    }
+
+    counter_snapshot();
+
+    pthread_mutex_lock(&counter_lock);
+    pthread_cond_signal(&counter_cond);
+    pthread_mutex_unlock(&counter_lock);
+}
+
+const uint64_t* db_counter_read_begin(_In_ stub_counter_type_t type, _Out_ uint64_t *seq)
+{
+    const stub_counter_shadow_t *shadow;
+
+    if (!__atomic_load_n(&counter_running, __ATOMIC_ACQUIRE) ||
+        (0 == __atomic_load_n(&counter_refresh_interval, __ATOMIC_RELAXED))) {
+        return NULL;
+    }
+
+    *seq   = __atomic_load_n(&counter_seq, __ATOMIC_ACQUIRE);
+    shadow = &counter_shadow[*seq % 2];
+
+    switch (type) {
+    case COUNTER_TYPE_PORT:
+        return shadow->port;
+
+    case COUNTER_TYPE_QUEUE:
+        return shadow->queue;
+
+    case COUNTER_TYPE_INGRESS_PG:
+        return shadow->ingress_pg;
+
+    case COUNTER_TYPE_POLICER:
+        return shadow->policer;
+
+    default:
+        assert(false);
+        return NULL;
+    }
+}
+
+bool db_counter_read_retry(_In_ uint64_t seq)
+{
+    /* Orders the loads of the values before the load of the sequence number */
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+    return (seq != __atomic_load_n(&counter_seq, __ATOMIC_RELAXED));
+}
+
+/*************************/
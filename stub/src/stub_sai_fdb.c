@@ -18,6 +18,7 @@
 #include "sai.h"
 #include "stub_sai.h"
 #include "assert.h"
+#include "pthread.h"
 
 #undef  __MODULE__
 #define __MODULE__ SAI_FDB
@@ -74,6 +75,562 @@ static const sai_vendor_attribute_entry_t fdb_vendor_attribs[] = {
       stub_fdb_action_get, NULL,
       stub_fdb_action_set, NULL }
 };
+
+/* State DB *************/
+
+/*
+ * The FDB is an open addressing hash table, looked up without a lock by the
+ * forwarding cores and only written under the FDB write lock. A slot key is
+ * written after its value and checked again after reading the value, removed
+ * entries are left as tombstones, turned back to empty slots when followed
+ * by an empty slot, so a lookup racing a change sees the entry either before
+ * or after it.
+ *
+ * A source MAC miss or a station move found by a forwarding core is queued
+ * to the learn ring of the core, a single producer single consumer ring,
+ * past a small per core filter dropping requests repeated within the learn
+ * holdoff. The learn rings are drained by db_fdb_learn, which applies the
+ * port learning limits, the switch limit and the table size, updates the
+ * table under the write lock and raises the LEARNED and MOVE events. Hits
+ * refresh the entry last seen time, which db_fdb_age checks against the
+ * switch aging time to age dynamic entries out with AGED events.
+ *
+ * The table holds up to the SAI_FDB_TABLE_SIZE entries of the switch profile,
+ * in the smallest power of two slots keeping it at most half full, so a small
+ * FDB only probes, ages and flushes the slots it needs.
+ */
+#define FDB_SLOTS             (1 << 18)
+#define FDB_SLOT_MASK         (FDB_SLOTS - 1)
+#define FDB_ENTRY_NUMBER      (FDB_SLOTS / 2)
+#define FDB_MIN_SLOTS         1024
+#define FDB_KEY_EMPTY         0
+#define FDB_KEY_DELETED       1
+#define FDB_KEY_VALID         (1ULL << 62)
+#define FDB_LEARN_RING_SIZE   4096
+#define FDB_LEARN_FILTER_SIZE 256
+#define FDB_LEARN_HOLDOFF_NS  1000000
+#define FDB_VALUE_PORT_MASK   0xFFFF
+#define FDB_VALUE_STATIC      (1 << 16)
+#define FDB_VALUE_ACTION_SHIFT 17
+#define NS_PER_SEC            1000000000ULL
+
+/* Value packs the port, static flag and packet action, so it is read and written at once */
+typedef struct _stub_fdb_slot_t {
+    uint64_t key;
+    uint32_t value;
+    /* Seconds, refreshed by hits */
+    uint32_t last_seen;
+} stub_fdb_slot_t;
+
+typedef struct _stub_fdb_learn_t {
+    uint64_t key;
+    uint32_t port_id;
+} stub_fdb_learn_t;
+
+/* Tail is only written by the forwarding core, head by db_fdb_learn */
+typedef struct _stub_fdb_learn_ring_t {
+    uint32_t         tail __attribute__((aligned(CACHE_LINE_SIZE)));
+    uint32_t         head __attribute__((aligned(CACHE_LINE_SIZE)));
+    stub_fdb_learn_t slots[FDB_LEARN_RING_SIZE];
+    /* Requests queued lately, by key hash, with the port and time queued */
+    stub_fdb_learn_t filter[FDB_LEARN_FILTER_SIZE];
+    uint64_t         filter_ns[FDB_LEARN_FILTER_SIZE];
+    uint64_t         learn_drops;
+    uint64_t         limit_drops;
+} stub_fdb_learn_ring_t;
+
+static stub_fdb_slot_t       fdb_db[FDB_SLOTS];
+static pthread_mutex_t       fdb_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t              fdb_dynamic_count;
+static uint32_t              fdb_entry_count;
+static uint32_t              fdb_table_size = FDB_ENTRY_NUMBER;
+/* Slots in use are fdb_db[0..fdb_slot_mask], only changed on init */
+static uint32_t              fdb_slot_mask  = FDB_SLOT_MASK;
+/* Slots were written since init, a table never written needs no clearing, nor its pages touched */
+static bool                  fdb_db_dirty;
+static uint32_t              fdb_port_learned[PORT_NUMBER];
+static uint32_t              fdb_aging_time;
+/* Seconds, last time given to learning or aging, for the entries created through the API */
+static uint32_t              fdb_now;
+static uint32_t              fdb_max_learned;
+static stub_fdb_learn_ring_t fdb_learn_rings[STUB_CORES];
+static stub_fdb_stats_t      fdb_stats;
+
+static uint64_t fdb_key(_In_ sai_vlan_id_t vlan_id, _In_ const sai_mac_t mac)
+{
+    return FDB_KEY_VALID | ((uint64_t)(vlan_id & 0xFFF) << 48) |
+           ((uint64_t)mac[0] << 40) | ((uint64_t)mac[1] << 32) | ((uint64_t)mac[2] << 24) |
+           ((uint64_t)mac[3] << 16) | ((uint64_t)mac[4] << 8) | mac[5];
+}
+
+static void fdb_key_to_entry(_In_ uint64_t key, _Out_ sai_fdb_entry_t *fdb_entry)
+{
+    uint32_t ii;
+
+    memset(fdb_entry, 0, sizeof(*fdb_entry));
+    fdb_entry->vlan_id = (key >> 48) & 0xFFF;
+    for (ii = 0; ii < 6; ii++) {
+        fdb_entry->mac_address[ii] = (key >> (40 - 8 * ii)) & 0xFF;
+    }
+}
+
+static uint32_t fdb_hash(_In_ uint64_t key)
+{
+    return (uint32_t)((key * 0x9E3779B97F4A7C15ULL) >> 46) & fdb_slot_mask;
+}
+
+static uint32_t fdb_value(_In_ uint32_t port_id, _In_ bool is_static, _In_ sai_packet_action_t action)
+{
+    return port_id | (is_static ? FDB_VALUE_STATIC : 0) | ((uint32_t)action << FDB_VALUE_ACTION_SHIFT);
+}
+
+/* Lock free lookup, value of the key or false on miss. Slot, when not NULL, gets the slot found */
+static bool fdb_lookup(_In_ uint64_t key, _Out_ uint32_t *value, _Out_ stub_fdb_slot_t **slot)
+{
+    stub_fdb_slot_t *entry;
+    uint32_t         index = fdb_hash(key), ii;
+    uint64_t         slot_key;
+
+    for (ii = 0; ii <= fdb_slot_mask; ii++, index = (index + 1) & fdb_slot_mask) {
+        entry    = &fdb_db[index];
+        slot_key = __atomic_load_n(&entry->key, __ATOMIC_ACQUIRE);
+        if (FDB_KEY_EMPTY == slot_key) {
+            return false;
+        }
+        if (slot_key != key) {
+            continue;
+        }
+
+        *value = __atomic_load_n(&entry->value, __ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&entry->key, __ATOMIC_ACQUIRE) != key) {
+            return false;
+        }
+        if (NULL != slot) {
+            *slot = entry;
+        }
+        return true;
+    }
+
+    return false;
+}
+
+/* Under the write lock. Inserts in the first tombstone or empty slot of the probe sequence */
+static sai_status_t fdb_insert(_In_ uint64_t key, _In_ uint32_t value, _In_ uint32_t now_s)
+{
+    stub_fdb_slot_t *entry, *free_slot = NULL;
+    uint32_t         index = fdb_hash(key), ii;
+
+    if (fdb_entry_count >= fdb_table_size) {
+        return SAI_STATUS_TABLE_FULL;
+    }
+
+    for (ii = 0; ii <= fdb_slot_mask; ii++, index = (index + 1) & fdb_slot_mask) {
+        entry = &fdb_db[index];
+        if (key == entry->key) {
+            return SAI_STATUS_ITEM_ALREADY_EXISTS;
+        }
+        if ((NULL == free_slot) && (FDB_KEY_VALID > entry->key)) {
+            free_slot = entry;
+        }
+        if (FDB_KEY_EMPTY == entry->key) {
+            break;
+        }
+    }
+
+    __atomic_store_n(&free_slot->value, value, __ATOMIC_RELAXED);
+    __atomic_store_n(&free_slot->last_seen, now_s, __ATOMIC_RELAXED);
+    __atomic_store_n(&free_slot->key, key, __ATOMIC_RELEASE);
+
+    fdb_db_dirty = true;
+    fdb_entry_count++;
+    if (!(value & FDB_VALUE_STATIC)) {
+        __atomic_fetch_add(&fdb_dynamic_count, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&fdb_port_learned[value & FDB_VALUE_PORT_MASK], 1, __ATOMIC_RELAXED);
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Under the write lock */
+static void fdb_remove_slot(_Inout_ stub_fdb_slot_t *entry)
+{
+    uint32_t index = entry - fdb_db;
+
+    if (!(entry->value & FDB_VALUE_STATIC)) {
+        __atomic_fetch_sub(&fdb_dynamic_count, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_sub(&fdb_port_learned[entry->value & FDB_VALUE_PORT_MASK], 1, __ATOMIC_RELAXED);
+    }
+    fdb_entry_count--;
+
+    __atomic_store_n(&entry->key, FDB_KEY_DELETED, __ATOMIC_RELEASE);
+
+    /* No key probes past an empty slot, so the tombstones right before one aren't needed */
+    if (FDB_KEY_EMPTY != fdb_db[(index + 1) & fdb_slot_mask].key) {
+        return;
+    }
+    while (FDB_KEY_DELETED == fdb_db[index].key) {
+        __atomic_store_n(&fdb_db[index].key, FDB_KEY_EMPTY, __ATOMIC_RELEASE);
+        index = (index - 1) & fdb_slot_mask;
+    }
+}
+
+/* Under the write lock, moves a dynamic entry to a port */
+static void fdb_move_slot(_Inout_ stub_fdb_slot_t *entry, _In_ uint32_t port_id)
+{
+    __atomic_fetch_sub(&fdb_port_learned[entry->value & FDB_VALUE_PORT_MASK], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&fdb_port_learned[port_id], 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&entry->value, (entry->value & ~FDB_VALUE_PORT_MASK) | port_id, __ATOMIC_RELEASE);
+}
+
+static void fdb_notify(_In_ sai_fdb_event_t event_type, _In_ uint64_t key, _In_ uint32_t value)
+{
+    sai_fdb_entry_t fdb_entry;
+    sai_attribute_t attr_list[3];
+
+    fdb_key_to_entry(key, &fdb_entry);
+
+    attr_list[0].id        = SAI_FDB_ENTRY_ATTR_TYPE;
+    attr_list[0].value.s32 = (value & FDB_VALUE_STATIC) ? SAI_FDB_ENTRY_STATIC : SAI_FDB_ENTRY_DYNAMIC;
+    attr_list[1].id        = SAI_FDB_ENTRY_ATTR_PORT_ID;
+    stub_create_object(SAI_OBJECT_TYPE_PORT, value & FDB_VALUE_PORT_MASK, &attr_list[1].value.oid);
+    attr_list[2].id        = SAI_FDB_ENTRY_ATTR_PACKET_ACTION;
+    attr_list[2].value.s32 = value >> FDB_VALUE_ACTION_SHIFT;
+
+    db_notify_fdb_event(event_type, &fdb_entry, 3, attr_list);
+}
+
+/* Queue a learn request, unless the same one was queued within the holdoff */
+static void fdb_learn_request(_Inout_ stub_fdb_learn_ring_t *ring,
+                              _In_ uint64_t                  now_ns,
+                              _In_ uint64_t                  key,
+                              _In_ uint32_t                  port_id)
+{
+    uint32_t filter = fdb_hash(key) % FDB_LEARN_FILTER_SIZE, tail = ring->tail;
+
+    if ((ring->filter[filter].key == key) && (ring->filter[filter].port_id == port_id) &&
+        (now_ns - ring->filter_ns[filter] < FDB_LEARN_HOLDOFF_NS)) {
+        return;
+    }
+
+    if (FDB_LEARN_RING_SIZE == tail - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)) {
+        ring->learn_drops++;
+        return;
+    }
+
+    ring->slots[tail % FDB_LEARN_RING_SIZE].key     = key;
+    ring->slots[tail % FDB_LEARN_RING_SIZE].port_id = port_id;
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+
+    ring->filter[filter].key     = key;
+    ring->filter[filter].port_id = port_id;
+    ring->filter_ns[filter]      = now_ns;
+}
+
+/* Whether a port may learn one more address, under its limit and, unless moved from another port, the switch limit */
+static bool fdb_port_may_learn(_In_ uint32_t port_id, _In_ uint32_t max_learned, _In_ bool move)
+{
+    uint32_t switch_max_learned = __atomic_load_n(&fdb_max_learned, __ATOMIC_RELAXED);
+
+    return ((0 == max_learned) || (__atomic_load_n(&fdb_port_learned[port_id], __ATOMIC_RELAXED) < max_learned)) &&
+           (move || (0 == switch_max_learned) ||
+            (__atomic_load_n(&fdb_dynamic_count, __ATOMIC_RELAXED) < switch_max_learned));
+}
+
+/*
+ * Forward count packets received by a core, without taking the FDB write
+ * lock. ports gets the egress port, FDB_FLOOD for unknown destinations and
+ * FDB_DROP for packets dropped, to_cpu whether a copy goes to the CPU.
+ * Unknown sources and station moves are queued for learning.
+ */
+sai_status_t db_fdb_forward(_In_ uint32_t                 core,
+                            _In_ uint64_t                 now_ns,
+                            _In_ uint32_t                 count,
+                            _In_ const stub_fdb_packet_t *packets,
+                            _Out_ uint32_t               *ports,
+                            _Out_ bool                   *to_cpu)
+{
+    stub_fdb_learn_ring_t *ring;
+    stub_fdb_slot_t       *slot = NULL;
+    sai_packet_action_t    action, violation;
+    uint32_t               ii, value, port_id, max_learned, now_s = now_ns / NS_PER_SEC;
+    uint64_t               key;
+    int32_t                mode;
+    bool                   forward, hit;
+
+    if (core >= STUB_CORES) {
+        STUB_LOG_ERR("Invalid core %u\n", core);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    ring = &fdb_learn_rings[core];
+
+    for (ii = 0; ii < count; ii++) {
+        ports[ii]  = FDB_DROP;
+        to_cpu[ii] = false;
+        port_id    = packets[ii].port_id;
+
+        if ((port_id >= PORT_NUMBER) || !db_stp_port_learning(packets[ii].vlan_id, port_id)) {
+            continue;
+        }
+
+        /* Source, known on this port, moved, or unknown */
+        forward = db_stp_port_forwarding(packets[ii].vlan_id, port_id);
+        key     = fdb_key(packets[ii].vlan_id, packets[ii].src_mac);
+        hit     = fdb_lookup(key, &value, &slot);
+        if (hit && ((value & FDB_VALUE_PORT_MASK) == port_id)) {
+            if (__atomic_load_n(&slot->last_seen, __ATOMIC_RELAXED) != now_s) {
+                __atomic_store_n(&slot->last_seen, now_s, __ATOMIC_RELAXED);
+            }
+        } else if (!hit || !(value & FDB_VALUE_STATIC)) {
+            db_port_fdb_learning_get(port_id, &mode, &max_learned, &violation);
+
+            if (SAI_PORT_LEARN_MODE_HW == mode) {
+                if (fdb_port_may_learn(port_id, max_learned, hit)) {
+                    fdb_learn_request(ring, now_ns, key, port_id);
+                } else {
+                    ring->limit_drops++;
+                    if (!hit) {
+                        forward    = forward && (SAI_PACKET_ACTION_DROP != violation) &&
+                                     (SAI_PACKET_ACTION_TRAP != violation);
+                        to_cpu[ii] = (SAI_PACKET_ACTION_TRAP == violation) || (SAI_PACKET_ACTION_LOG == violation);
+                    }
+                }
+            } else if (!hit) {
+                forward    = forward && (SAI_PORT_LEARN_MODE_DROP != mode) && (SAI_PORT_LEARN_MODE_CPU_TRAP != mode);
+                to_cpu[ii] = (SAI_PORT_LEARN_MODE_CPU_TRAP == mode) || (SAI_PORT_LEARN_MODE_CPU_LOG == mode);
+            }
+        }
+
+        if (!forward) {
+            continue;
+        }
+
+        /* Destination */
+        if (!fdb_lookup(fdb_key(packets[ii].vlan_id, packets[ii].dst_mac), &value, NULL)) {
+            ports[ii] = FDB_FLOOD;
+            continue;
+        }
+
+        action = value >> FDB_VALUE_ACTION_SHIFT;
+        if ((SAI_PACKET_ACTION_TRAP == action) || (SAI_PACKET_ACTION_LOG == action)) {
+            to_cpu[ii] = true;
+        }
+        /* Not sent back to the port it came from */
+        if (((SAI_PACKET_ACTION_FORWARD == action) || (SAI_PACKET_ACTION_LOG == action)) &&
+            ((value & FDB_VALUE_PORT_MASK) != port_id)) {
+            ports[ii] = value & FDB_VALUE_PORT_MASK;
+        }
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Apply up to budget queued learn requests, raising the LEARNED and MOVE
+ * events. learned gets the requests taken off the learn rings.
+ */
+sai_status_t db_fdb_learn(_In_ uint64_t now_ns, _In_ uint32_t budget, _Out_ uint32_t *learned)
+{
+    stub_fdb_learn_ring_t  *ring;
+    const stub_fdb_learn_t *request;
+    stub_fdb_slot_t        *slot;
+    sai_packet_action_t     violation;
+    uint32_t                core, head, tail, value, max_learned, now_s = now_ns / NS_PER_SEC;
+    int32_t                 mode;
+    bool                    hit;
+
+    *learned = 0;
+
+    pthread_mutex_lock(&fdb_lock);
+
+    fdb_now = now_s;
+
+    for (core = 0; core < STUB_CORES; core++) {
+        ring = &fdb_learn_rings[core];
+        head = ring->head;
+        tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+
+        for (; (head != tail) && (*learned < budget); head++, (*learned)++) {
+            request = &ring->slots[head % FDB_LEARN_RING_SIZE];
+
+            hit = fdb_lookup(request->key, &value, &slot);
+            if (hit && ((value & FDB_VALUE_STATIC) || ((value & FDB_VALUE_PORT_MASK) == request->port_id))) {
+                continue;
+            }
+
+            /* Limits checked again, the counts the forwarding core checked may have changed since */
+            db_port_fdb_learning_get(request->port_id, &mode, &max_learned, &violation);
+            if (!fdb_port_may_learn(request->port_id, max_learned, hit)) {
+                fdb_stats.limit_drops++;
+                continue;
+            }
+
+            if (hit) {
+                fdb_move_slot(slot, request->port_id);
+                __atomic_store_n(&slot->last_seen, now_s, __ATOMIC_RELAXED);
+                fdb_stats.moved++;
+                fdb_notify(SAI_FDB_EVENT_MOVE, request->key, slot->value);
+                continue;
+            }
+
+            value = fdb_value(request->port_id, false, SAI_PACKET_ACTION_FORWARD);
+            if (SAI_STATUS_SUCCESS != fdb_insert(request->key, value, now_s)) {
+                fdb_stats.table_full_drops++;
+                continue;
+            }
+            fdb_stats.learned++;
+            fdb_notify(SAI_FDB_EVENT_LEARNED, request->key, value);
+        }
+
+        __atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+    }
+
+    pthread_mutex_unlock(&fdb_lock);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Age out the dynamic entries not seen for more than the switch aging time, in whole seconds, raising AGED events */
+sai_status_t db_fdb_age(_In_ uint64_t now_ns, _Out_ uint32_t *aged)
+{
+    stub_fdb_slot_t *entry;
+    uint32_t         ii, value, now_s = now_ns / NS_PER_SEC, aging_time;
+    uint64_t         key;
+
+    *aged = 0;
+
+    if (0 == (aging_time = __atomic_load_n(&fdb_aging_time, __ATOMIC_RELAXED))) {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    pthread_mutex_lock(&fdb_lock);
+
+    fdb_now = now_s;
+
+    for (ii = 0; ii <= fdb_slot_mask; ii++) {
+        entry = &fdb_db[ii];
+        if ((FDB_KEY_VALID > entry->key) || (entry->value & FDB_VALUE_STATIC) ||
+            (now_s - __atomic_load_n(&entry->last_seen, __ATOMIC_RELAXED) <= aging_time)) {
+            continue;
+        }
+
+        key   = entry->key;
+        value = entry->value;
+        fdb_remove_slot(entry);
+        fdb_stats.aged++;
+        (*aged)++;
+        fdb_notify(SAI_FDB_EVENT_AGED, key, value);
+    }
+
+    pthread_mutex_unlock(&fdb_lock);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Remove the entries of the VLANs and ports set in the bitmaps, dynamic and/or static ones */
+static uint32_t fdb_flush(_In_ const uint64_t *vlans, _In_ uint64_t ports, _In_ bool dynamic, _In_ bool is_static)
+{
+    stub_fdb_slot_t *entry;
+    uint32_t         ii, port_id, flushed = 0;
+    sai_vlan_id_t    vlan_id;
+
+    pthread_mutex_lock(&fdb_lock);
+
+    for (ii = 0; ii <= fdb_slot_mask; ii++) {
+        entry = &fdb_db[ii];
+        if (FDB_KEY_VALID > entry->key) {
+            continue;
+        }
+
+        port_id = entry->value & FDB_VALUE_PORT_MASK;
+        vlan_id = (entry->key >> 48) & 0xFFF;
+        if (!((entry->value & FDB_VALUE_STATIC) ? is_static : dynamic) || !((ports >> port_id) & 1) ||
+            !((vlans[vlan_id / 64] >> (vlan_id % 64)) & 1)) {
+            continue;
+        }
+
+        fdb_remove_slot(entry);
+        flushed++;
+    }
+
+    pthread_mutex_unlock(&fdb_lock);
+
+    return flushed;
+}
+
+void db_fdb_stats_get(_Out_ stub_fdb_stats_t *stats)
+{
+    uint32_t core;
+
+    pthread_mutex_lock(&fdb_lock);
+    *stats         = fdb_stats;
+    stats->entries = fdb_entry_count;
+    pthread_mutex_unlock(&fdb_lock);
+
+    for (core = 0; core < STUB_CORES; core++) {
+        stats->learn_drops += __atomic_load_n(&fdb_learn_rings[core].learn_drops, __ATOMIC_RELAXED);
+        stats->limit_drops += __atomic_load_n(&fdb_learn_rings[core].limit_drops, __ATOMIC_RELAXED);
+    }
+}
+
+/* Aging time in seconds, 0 for no aging */
+void db_fdb_aging_time_set(_In_ uint32_t aging_time)
+{
+    __atomic_store_n(&fdb_aging_time, aging_time, __ATOMIC_RELAXED);
+}
+
+uint32_t db_fdb_aging_time_get()
+{
+    return __atomic_load_n(&fdb_aging_time, __ATOMIC_RELAXED);
+}
+
+/* Dynamic entries the switch learns, 0 for no limit */
+void db_fdb_max_learned_set(_In_ uint32_t max_learned)
+{
+    __atomic_store_n(&fdb_max_learned, max_learned, __ATOMIC_RELAXED);
+}
+
+uint32_t db_fdb_max_learned_get()
+{
+    return __atomic_load_n(&fdb_max_learned, __ATOMIC_RELAXED);
+}
+
+/* Empty the FDB and size it for the SAI_FDB_TABLE_SIZE entries of the switch profile */
+void db_init_fdb()
+{
+    uint32_t table_size, slots = FDB_MIN_SLOTS;
+
+    table_size = db_profile_u32_get(SAI_KEY_FDB_TABLE_SIZE, FDB_ENTRY_NUMBER);
+    if ((0 == table_size) || (table_size > FDB_ENTRY_NUMBER)) {
+        STUB_LOG_WRN("FDB table size %u out of range, using %u\n", table_size, FDB_ENTRY_NUMBER);
+        table_size = FDB_ENTRY_NUMBER;
+    }
+    while (slots < 2 * table_size) {
+        slots *= 2;
+    }
+
+    pthread_mutex_lock(&fdb_lock);
+    if (fdb_db_dirty) {
+        memset(fdb_db, 0, (fdb_slot_mask + 1) * sizeof(fdb_db[0]));
+        fdb_db_dirty = false;
+    }
+    memset(fdb_port_learned, 0, sizeof(fdb_port_learned));
+    fdb_entry_count   = 0;
+    fdb_dynamic_count = 0;
+    fdb_table_size    = table_size;
+    fdb_slot_mask     = slots - 1;
+    pthread_mutex_unlock(&fdb_lock);
+
+    STUB_LOG_NTC("FDB table size %u, %u slots\n", table_size, slots);
+}
+
+uint32_t db_fdb_table_size_get()
+{
+    return fdb_table_size;
+}
+
+/*************************/
+
 static void fdb_key_to_str(_In_ const sai_fdb_entry_t* fdb_entry, _Out_ char *key_str)
 {
     snprintf(key_str, MAX_KEY_STR_LEN, "fdb entry mac [%02x:%02x:%02x:%02x:%02x:%02x] vlan %u",
@@ -142,6 +699,26 @@ sai_status_t stub_create_fdb_entry(_In_ const sai_fdb_entry_t* fdb_entry,
         return status;
     }
 
+    if (port_id >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid port %u\n", port_id);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + port_index;
+    }
+
+    if ((action->s32 < SAI_PACKET_ACTION_DROP) || (action->s32 > SAI_PACKET_ACTION_TRANSIT)) {
+        STUB_LOG_ERR("Invalid FDB entry packet action %d\n", action->s32);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + action_index;
+    }
+
+    pthread_mutex_lock(&fdb_lock);
+    status = fdb_insert(fdb_key(fdb_entry->vlan_id, fdb_entry->mac_address),
+                        fdb_value(port_id, SAI_FDB_ENTRY_STATIC == type->s32, action->s32), fdb_now);
+    pthread_mutex_unlock(&fdb_lock);
+
+    if (SAI_STATUS_SUCCESS != status) {
+        STUB_LOG_ERR("Failed to create %s\n", key_str);
+        return status;
+    }
+
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
 }
@@ -159,7 +736,9 @@ sai_status_t stub_create_fdb_entry(_In_ const sai_fdb_entry_t* fdb_entry,
  */
 sai_status_t stub_remove_fdb_entry(_In_ const sai_fdb_entry_t* fdb_entry)
 {
-    char key_str[MAX_KEY_STR_LEN];
+    char             key_str[MAX_KEY_STR_LEN];
+    stub_fdb_slot_t *slot;
+    uint32_t         value;
 
     STUB_LOG_ENTER();
 
@@ -171,6 +750,15 @@ sai_status_t stub_remove_fdb_entry(_In_ const sai_fdb_entry_t* fdb_entry)
     fdb_key_to_str(fdb_entry, key_str);
     STUB_LOG_NTC("Remove FDB entry %s\n", key_str);
 
+    pthread_mutex_lock(&fdb_lock);
+    if (!fdb_lookup(fdb_key(fdb_entry->vlan_id, fdb_entry->mac_address), &value, &slot)) {
+        pthread_mutex_unlock(&fdb_lock);
+        STUB_LOG_ERR("%s not found\n", key_str);
+        return SAI_STATUS_ITEM_NOT_FOUND;
+    }
+    fdb_remove_slot(slot);
+    pthread_mutex_unlock(&fdb_lock);
+
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
 }
@@ -203,11 +791,49 @@ sai_status_t stub_set_fdb_entry_attribute(_In_ const sai_fdb_entry_t* fdb_entry,
     return sai_set_attribute(&key, key_str, fdb_attribs, fdb_vendor_attribs, attr);
 }
 
+/* Replace the value of an entry, keeping the learned counts. Under the write lock */
+static sai_status_t fdb_value_set(_In_ const sai_fdb_entry_t *fdb_entry, _In_ uint32_t mask, _In_ uint32_t bits)
+{
+    stub_fdb_slot_t *slot;
+    uint32_t         value;
+
+    if (!fdb_lookup(fdb_key(fdb_entry->vlan_id, fdb_entry->mac_address), &value, &slot)) {
+        STUB_LOG_ERR("FDB entry not found\n");
+        return SAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    if (!(value & FDB_VALUE_STATIC)) {
+        __atomic_fetch_sub(&fdb_dynamic_count, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_sub(&fdb_port_learned[value & FDB_VALUE_PORT_MASK], 1, __ATOMIC_RELAXED);
+    }
+
+    value = (value & ~mask) | bits;
+    __atomic_store_n(&slot->value, value, __ATOMIC_RELEASE);
+
+    if (!(value & FDB_VALUE_STATIC)) {
+        __atomic_fetch_add(&fdb_dynamic_count, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&fdb_port_learned[value & FDB_VALUE_PORT_MASK], 1, __ATOMIC_RELAXED);
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
 /* Set FDB entry type [sai_fdb_entry_type_t] */
 sai_status_t stub_fdb_type_set(_In_ const sai_object_key_t *key, _In_ const sai_attribute_value_t *value, void *arg)
 {
+    sai_status_t status;
+
     STUB_LOG_ENTER();
 
+    pthread_mutex_lock(&fdb_lock);
+    status = fdb_value_set(key->fdb_entry, FDB_VALUE_STATIC,
+                           (SAI_FDB_ENTRY_STATIC == value->s32) ? FDB_VALUE_STATIC : 0);
+    pthread_mutex_unlock(&fdb_lock);
+
+    if (SAI_STATUS_SUCCESS != status) {
+        return status;
+    }
+
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
 }
@@ -226,6 +852,19 @@ sai_status_t stub_fdb_port_set(_In_ const sai_object_key_t *key, _In_ const sai_
         return status;
     }
 
+    if (port_id >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid port %u\n", port_id);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0;
+    }
+
+    pthread_mutex_lock(&fdb_lock);
+    status = fdb_value_set(key->fdb_entry, FDB_VALUE_PORT_MASK, port_id);
+    pthread_mutex_unlock(&fdb_lock);
+
+    if (SAI_STATUS_SUCCESS != status) {
+        return status;
+    }
+
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
 }
@@ -233,8 +872,24 @@ sai_status_t stub_fdb_port_set(_In_ const sai_object_key_t *key, _In_ const sai_
 /* Set FDB entry packet action [sai_packet_action_t] */
 sai_status_t stub_fdb_action_set(_In_ const sai_object_key_t *key, _In_ const sai_attribute_value_t *value, void *arg)
 {
+    sai_status_t status;
+
     STUB_LOG_ENTER();
 
+    if ((value->s32 < SAI_PACKET_ACTION_DROP) || (value->s32 > SAI_PACKET_ACTION_TRANSIT)) {
+        STUB_LOG_ERR("Invalid FDB entry packet action %d\n", value->s32);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0;
+    }
+
+    pthread_mutex_lock(&fdb_lock);
+    status = fdb_value_set(key->fdb_entry, ~(uint32_t)0 << FDB_VALUE_ACTION_SHIFT,
+                           (uint32_t)value->s32 << FDB_VALUE_ACTION_SHIFT);
+    pthread_mutex_unlock(&fdb_lock);
+
+    if (SAI_STATUS_SUCCESS != status) {
+        return status;
+    }
+
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
 }
@@ -270,6 +925,16 @@ sai_status_t stub_get_fdb_entry_attribute(_In_ const sai_fdb_entry_t* fdb_entry,
     return sai_get_attributes(&key, key_str, fdb_attribs, fdb_vendor_attribs, attr_count, attr_list);
 }
 
+static sai_status_t fdb_value_get(_In_ const sai_fdb_entry_t *fdb_entry, _Out_ uint32_t *value)
+{
+    if (!fdb_lookup(fdb_key(fdb_entry->vlan_id, fdb_entry->mac_address), value, NULL)) {
+        STUB_LOG_ERR("FDB entry not found\n");
+        return SAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
 /* Get FDB entry type [sai_fdb_entry_type_t] */
 sai_status_t stub_fdb_type_get(_In_ const sai_object_key_t   *key,
                                _Inout_ sai_attribute_value_t *value,
@@ -277,9 +942,16 @@ sai_status_t stub_fdb_type_get(_In_ const sai_object_key_t   *key,
                                _Inout_ vendor_cache_t        *cache,
                                void                          *arg)
 {
+    sai_status_t status;
+    uint32_t     fdb_value;
+
     STUB_LOG_ENTER();
 
-    value->s32 = SAI_FDB_ENTRY_STATIC;
+    if (SAI_STATUS_SUCCESS != (status = fdb_value_get(key->fdb_entry, &fdb_value))) {
+        return status;
+    }
+
+    value->s32 = (fdb_value & FDB_VALUE_STATIC) ? SAI_FDB_ENTRY_STATIC : SAI_FDB_ENTRY_DYNAMIC;
 
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
@@ -298,11 +970,21 @@ sai_status_t stub_fdb_port_get(_In_ const sai_object_key_t   *key,
                                _Inout_ vendor_cache_t        *cache,
                                void                          *arg)
 {
-    sai_status_t status;
+    sai_status_t        status;
+    uint32_t            fdb_value;
+    sai_packet_action_t action;
 
     STUB_LOG_ENTER();
 
-    if (SAI_STATUS_SUCCESS != (status = stub_create_object(SAI_OBJECT_TYPE_PORT, 1, &value->oid))) {
+    if (SAI_STATUS_SUCCESS != (status = fdb_value_get(key->fdb_entry, &fdb_value))) {
+        return status;
+    }
+
+    action = fdb_value >> FDB_VALUE_ACTION_SHIFT;
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_create_object(SAI_OBJECT_TYPE_PORT,
+                                     ((SAI_PACKET_ACTION_DROP == action) || (SAI_PACKET_ACTION_TRAP == action)) ? 0 :
+                                     fdb_value & FDB_VALUE_PORT_MASK, &value->oid))) {
         return status;
     }
 
@@ -317,9 +999,16 @@ sai_status_t stub_fdb_action_get(_In_ const sai_object_key_t   *key,
                                  _Inout_ vendor_cache_t        *cache,
                                  void                          *arg)
 {
+    sai_status_t status;
+    uint32_t     fdb_value;
+
     STUB_LOG_ENTER();
 
-    value->s32 = SAI_PACKET_ACTION_FORWARD;
+    if (SAI_STATUS_SUCCESS != (status = fdb_value_get(key->fdb_entry, &fdb_value))) {
+        return status;
+    }
+
+    value->s32 = fdb_value >> FDB_VALUE_ACTION_SHIFT;
 
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
@@ -342,10 +1031,14 @@ sai_status_t stub_flush_fdb_entries(_In_ uint32_t attr_count, _In_ const sai_att
     sai_status_t                 status;
     const sai_attribute_value_t *port, *vlan, *type;
     uint32_t                     port_index, vlan_index, type_index;
-    uint32_t                     port_id;
+    uint32_t                     port_id, flushed;
+    uint64_t                     vlans[4096 / 64], ports = ~0ULL;
+    bool                         dynamic = true, is_static = true;
 
     STUB_LOG_ENTER();
 
+    memset(vlans, 0xFF, sizeof(vlans));
+
     if (SAI_STATUS_SUCCESS ==
         (status =
              find_attrib_in_list(attr_count, attr_list, SAI_FDB_FLUSH_ATTR_PORT_ID,
@@ -353,24 +1046,164 @@ sai_status_t stub_flush_fdb_entries(_In_ uint32_t attr_count, _In_ const sai_att
         if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(port->oid, SAI_OBJECT_TYPE_PORT, &port_id))) {
             return status;
         }
+        if (port_id >= PORT_NUMBER) {
+            STUB_LOG_ERR("Invalid port %u\n", port_id);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + port_index;
+        }
+        ports = 1ULL << port_id;
     }
 
     if (SAI_STATUS_SUCCESS ==
         (status =
              find_attrib_in_list(attr_count, attr_list, SAI_FDB_FLUSH_ATTR_VLAN_ID,
                                  &vlan, &vlan_index))) {
+        memset(vlans, 0, sizeof(vlans));
+        vlans[(vlan->u16 & 0xFFF) / 64] = 1ULL << ((vlan->u16 & 0xFFF) % 64);
     }
 
     if (SAI_STATUS_SUCCESS ==
         (status =
              find_attrib_in_list(attr_count, attr_list, SAI_FDB_FLUSH_ATTR_ENTRY_TYPE,
                                  &type, &type_index))) {
+        dynamic   = (SAI_FDB_FLUSH_ENTRY_DYNAMIC == type->s32);
+        is_static = (SAI_FDB_FLUSH_ENTRY_STATIC == type->s32);
     }
 
+    flushed = fdb_flush(vlans, ports, dynamic, is_static);
+    STUB_LOG_NTC("Flushed %u FDB entries\n", flushed);
+
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
 }
 
+/*
+ * Routine Description:
+ *    Remove the dynamic FDB entries of a set of VLANs learned on a set of
+ *    ports, on STP topology changes
+ *
+ * Arguments:
+ *    [in] vlans - 4096 bit bitmap of the VLANs
+ *    [in] ports - bitmap of the ports
+ */
+void db_fdb_flush_vlans(_In_ const uint64_t *vlans, _In_ uint64_t ports)
+{
+    uint32_t flushed = fdb_flush(vlans, ports, true, false);
+
+    STUB_LOG_NTC("Flushed %u FDB entries on topology change\n", flushed);
+}
+
+/*
+ * Learning load generator. Hosts are spread over the VLANs and ports, and
+ * each generated packet is sent by a random host to a random host of its
+ * VLAN. A packet may first move its host to another port, or replace it by
+ * a new host with a new MAC, the old one left to age out. Each core draws
+ * from its own share of the hosts, so cores generate concurrently.
+ */
+#define FDB_CHURN_HOSTS FDB_ENTRY_NUMBER
+
+typedef struct _stub_fdb_host_t {
+    sai_mac_t     mac;
+    sai_vlan_id_t vlan_id;
+    uint32_t      port_id;
+} stub_fdb_host_t;
+
+static stub_fdb_host_t  fdb_churn_hosts[FDB_CHURN_HOSTS];
+static stub_fdb_churn_t fdb_churn;
+static uint64_t         fdb_churn_seeds[STUB_CORES];
+static uint32_t         fdb_churn_next_mac[STUB_CORES];
+
+static uint64_t fdb_churn_random(_Inout_ uint64_t *seed)
+{
+    *seed ^= *seed << 13;
+    *seed ^= *seed >> 7;
+    *seed ^= *seed << 17;
+    return *seed;
+}
+
+/* Locally administered MAC, made of the core and a counter so hosts never collide */
+static void fdb_churn_mac(_In_ uint32_t core, _Out_ sai_mac_t mac)
+{
+    uint32_t serial = fdb_churn_next_mac[core]++;
+
+    mac[0] = 0x02;
+    mac[1] = core;
+    mac[2] = serial >> 24;
+    mac[3] = serial >> 16;
+    mac[4] = serial >> 8;
+    mac[5] = serial;
+}
+
+sai_status_t db_fdb_churn_init(_In_ const stub_fdb_churn_t *churn)
+{
+    uint32_t ii, core;
+
+    if ((0 == churn->host_count) || (churn->host_count > FDB_CHURN_HOSTS) || (churn->host_count < STUB_CORES * 2) ||
+        (0 == churn->vlan_count) || (churn->vlan_count > 4094) ||
+        (0 == churn->port_count) || (churn->port_count > PORT_NUMBER)) {
+        STUB_LOG_ERR("Invalid churn of %u hosts on %u VLANs %u ports\n",
+                     churn->host_count, churn->vlan_count, churn->port_count);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    fdb_churn = *churn;
+    for (core = 0; core < STUB_CORES; core++) {
+        fdb_churn_seeds[core]    = (churn->seed ? churn->seed : 0x9E3779B97F4A7C15ULL) + core * 0x2545F4914F6CDD1DULL;
+        fdb_churn_next_mac[core] = 0;
+    }
+
+    /* Host ii belongs to core ii % STUB_CORES, and to VLAN ii / STUB_CORES % vlan_count */
+    for (ii = 0; ii < churn->host_count; ii++) {
+        fdb_churn_mac(ii % STUB_CORES, fdb_churn_hosts[ii].mac);
+        fdb_churn_hosts[ii].vlan_id = 1 + (ii / STUB_CORES) % churn->vlan_count;
+        fdb_churn_hosts[ii].port_id = fdb_churn_random(&fdb_churn_seeds[ii % STUB_CORES]) % churn->port_count;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Generate count packets of the hosts of a core, moving and replacing hosts on the way */
+sai_status_t db_fdb_churn_generate(_In_ uint32_t core, _In_ uint32_t count, _Out_ stub_fdb_packet_t *packets)
+{
+    stub_fdb_host_t       *src;
+    const stub_fdb_host_t *dst;
+    uint64_t              *seed;
+    uint32_t               ii, hosts, src_index, dst_index, roll;
+
+    if (core >= STUB_CORES) {
+        STUB_LOG_ERR("Invalid core %u\n", core);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    seed  = &fdb_churn_seeds[core];
+    hosts = (fdb_churn.host_count - core + STUB_CORES - 1) / STUB_CORES;
+
+    for (ii = 0; ii < count; ii++) {
+        src_index = core + STUB_CORES * (fdb_churn_random(seed) % hosts);
+        src       = &fdb_churn_hosts[src_index];
+
+        roll = fdb_churn_random(seed) % 1000000;
+        if (roll < fdb_churn.move_ppm) {
+            src->port_id = (src->port_id + 1 + fdb_churn_random(seed) % (fdb_churn.port_count - 1 ? : 1)) %
+                           fdb_churn.port_count;
+        } else if (roll < fdb_churn.move_ppm + fdb_churn.replace_ppm) {
+            fdb_churn_mac(core, src->mac);
+            src->port_id = fdb_churn_random(seed) % fdb_churn.port_count;
+        }
+
+        /* Another host of the core on the same VLAN, as VLANs repeat every vlan_count hosts of a core */
+        dst_index = src_index + STUB_CORES * fdb_churn.vlan_count * (1 + fdb_churn_random(seed) % 7);
+        dst       = &fdb_churn_hosts[(dst_index < fdb_churn.host_count) ? dst_index :
+                                     (src_index % (STUB_CORES * fdb_churn.vlan_count))];
+
+        packets[ii].vlan_id = src->vlan_id;
+        packets[ii].port_id = src->port_id;
+        memcpy(packets[ii].src_mac, src->mac, sizeof(sai_mac_t));
+        memcpy(packets[ii].dst_mac, dst->mac, sizeof(sai_mac_t));
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
 const sai_fdb_api_t fdb_api = {
     stub_create_fdb_entry,
     stub_remove_fdb_entry,
@@ -18,8 +18,22 @@
 #include "sai.h"
 #include "stub_sai.h"
 #include "assert.h"
+#include "pthread.h"
 #ifndef _WIN32
 #include <net/if.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <linux/if_ether.h>
+#include <linux/if_packet.h>
+#include <linux/if_tun.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
 #endif
 
 #undef  __MODULE__
@@ -32,6 +46,8 @@ static const sai_attribute_entry_t host_interface_attribs[] = {
       "Host interface associated port or router interface", SAI_ATTR_VAL_TYPE_OID },
     { SAI_HOSTIF_ATTR_NAME, true, true, true, true,
       "Host interface name", SAI_ATTR_VAL_TYPE_CHARDATA },
+    { SAI_HOSTIF_ATTR_OPER_STATUS, false, true, true, true,
+      "Host interface oper status", SAI_ATTR_VAL_TYPE_BOOL },
     { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
       "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
 };
@@ -54,6 +70,14 @@ sai_status_t stub_host_interface_name_get(_In_ const sai_object_key_t   *key,
 sai_status_t stub_host_interface_name_set(_In_ const sai_object_key_t      *key,
                                           _In_ const sai_attribute_value_t *value,
                                           void                             *arg);
+sai_status_t stub_host_interface_oper_status_get(_In_ const sai_object_key_t   *key,
+                                                 _Inout_ sai_attribute_value_t *value,
+                                                 _In_ uint32_t                  attr_index,
+                                                 _Inout_ vendor_cache_t        *cache,
+                                                 void                          *arg);
+sai_status_t stub_host_interface_oper_status_set(_In_ const sai_object_key_t      *key,
+                                                 _In_ const sai_attribute_value_t *value,
+                                                 void                             *arg);
 
 static const sai_vendor_attribute_entry_t host_interface_vendor_attribs[] = {
     { SAI_HOSTIF_ATTR_TYPE,
@@ -71,24 +95,1457 @@ static const sai_vendor_attribute_entry_t host_interface_vendor_attribs[] = {
       { true, false, true, true },
       stub_host_interface_name_get, NULL,
       stub_host_interface_name_set, NULL },
+    { SAI_HOSTIF_ATTR_OPER_STATUS,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_host_interface_oper_status_get, NULL,
+      stub_host_interface_oper_status_set, NULL },
+};
+
+static const sai_attribute_entry_t trap_group_attribs[] = {
+    { SAI_HOSTIF_TRAP_GROUP_ATTR_ADMIN_STATE, false, true, true, true,
+      "Trap group admin state", SAI_ATTR_VAL_TYPE_BOOL },
+    { SAI_HOSTIF_TRAP_GROUP_ATTR_QUEUE, false, true, true, true,
+      "Trap group CPU queue", SAI_ATTR_VAL_TYPE_U32 },
+    { SAI_HOSTIF_TRAP_GROUP_ATTR_POLICER, false, true, true, true,
+      "Trap group policer", SAI_ATTR_VAL_TYPE_OID },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+static const sai_attribute_entry_t trap_attribs[] = {
+    { SAI_HOSTIF_TRAP_ATTR_PACKET_ACTION, false, false, true, true,
+      "Trap action", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_HOSTIF_TRAP_ATTR_TRAP_PRIORITY, false, false, true, true,
+      "Trap priority", SAI_ATTR_VAL_TYPE_U32 },
+    { SAI_HOSTIF_TRAP_ATTR_TRAP_CHANNEL, false, false, true, true,
+      "Trap channel", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_HOSTIF_TRAP_ATTR_TRAP_GROUP, false, false, true, true,
+      "Trap group", SAI_ATTR_VAL_TYPE_OID },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+sai_status_t stub_trap_group_attr_get(_In_ const sai_object_key_t   *key,
+                                      _Inout_ sai_attribute_value_t *value,
+                                      _In_ uint32_t                  attr_index,
+                                      _Inout_ vendor_cache_t        *cache,
+                                      void                          *arg);
+sai_status_t stub_trap_group_attr_set(_In_ const sai_object_key_t      *key,
+                                      _In_ const sai_attribute_value_t *value,
+                                      void                             *arg);
+sai_status_t stub_trap_attr_get(_In_ const sai_object_key_t   *key,
+                                _Inout_ sai_attribute_value_t *value,
+                                _In_ uint32_t                  attr_index,
+                                _Inout_ vendor_cache_t        *cache,
+                                void                          *arg);
+sai_status_t stub_trap_attr_set(_In_ const sai_object_key_t      *key,
+                                _In_ const sai_attribute_value_t *value,
+                                void                             *arg);
+
+static const sai_vendor_attribute_entry_t trap_group_vendor_attribs[] = {
+    { SAI_HOSTIF_TRAP_GROUP_ATTR_ADMIN_STATE,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_trap_group_attr_get, (void*)SAI_HOSTIF_TRAP_GROUP_ATTR_ADMIN_STATE,
+      stub_trap_group_attr_set, (void*)SAI_HOSTIF_TRAP_GROUP_ATTR_ADMIN_STATE },
+    { SAI_HOSTIF_TRAP_GROUP_ATTR_QUEUE,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_trap_group_attr_get, (void*)SAI_HOSTIF_TRAP_GROUP_ATTR_QUEUE,
+      stub_trap_group_attr_set, (void*)SAI_HOSTIF_TRAP_GROUP_ATTR_QUEUE },
+    { SAI_HOSTIF_TRAP_GROUP_ATTR_POLICER,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_trap_group_attr_get, (void*)SAI_HOSTIF_TRAP_GROUP_ATTR_POLICER,
+      stub_trap_group_attr_set, (void*)SAI_HOSTIF_TRAP_GROUP_ATTR_POLICER },
 };
+
+static const sai_vendor_attribute_entry_t trap_vendor_attribs[] = {
+    { SAI_HOSTIF_TRAP_ATTR_PACKET_ACTION,
+      { false, false, true, true },
+      { false, false, true, true },
+      stub_trap_attr_get, (void*)SAI_HOSTIF_TRAP_ATTR_PACKET_ACTION,
+      stub_trap_attr_set, (void*)SAI_HOSTIF_TRAP_ATTR_PACKET_ACTION },
+    { SAI_HOSTIF_TRAP_ATTR_TRAP_PRIORITY,
+      { false, false, true, true },
+      { false, false, true, true },
+      stub_trap_attr_get, (void*)SAI_HOSTIF_TRAP_ATTR_TRAP_PRIORITY,
+      stub_trap_attr_set, (void*)SAI_HOSTIF_TRAP_ATTR_TRAP_PRIORITY },
+    { SAI_HOSTIF_TRAP_ATTR_TRAP_CHANNEL,
+      { false, false, true, true },
+      { false, false, true, true },
+      stub_trap_attr_get, (void*)SAI_HOSTIF_TRAP_ATTR_TRAP_CHANNEL,
+      stub_trap_attr_set, (void*)SAI_HOSTIF_TRAP_ATTR_TRAP_CHANNEL },
+    { SAI_HOSTIF_TRAP_ATTR_TRAP_GROUP,
+      { false, false, true, true },
+      { false, false, true, true },
+      stub_trap_attr_get, (void*)SAI_HOSTIF_TRAP_ATTR_TRAP_GROUP,
+      stub_trap_attr_set, (void*)SAI_HOSTIF_TRAP_ATTR_TRAP_GROUP },
+};
+
+/* State DB *************/
+
+/*
+ * Netdev host interfaces are TAP devices, the stub holding the switch side of
+ * them: frames sent to the host interface are received by the host stack,
+ * and frames the host stack sends out of it are received from the host
+ * interface. The TAP goes away with its file descriptor. Link state and name
+ * are set over rtnetlink.
+ *
+ * FD host interfaces are packet sockets bound to the netdev named by the
+ * host interface name, with TPACKET_V3 RX and TX rings mapped in the stub.
+ * Receive copies frames from the ring blocks straight into the caller
+ * buffers, send copies them into TX ring frames and kicks the socket once
+ * per batch, so there is no system call per frame either way.
+ */
+#define MAX_HOST_INTERFACES       64
+#define HOSTIF_RX_BLOCK_SIZE      (1 << 20)
+#define HOSTIF_RX_BLOCKS          16
+#define HOSTIF_RX_FRAME_SIZE      2048
+/* Hand a partly filled RX block to the stub after this many ms */
+#define HOSTIF_RX_BLOCK_TIMEOUT   1
+#define HOSTIF_TX_FRAME_SIZE      (1 << 14)
+#define HOSTIF_TX_FRAMES          256
+#define HOSTIF_TX_DATA_OFFSET     (TPACKET3_HDRLEN - sizeof(struct sockaddr_ll))
+/* Largest frame read from a TAP */
+#define HOSTIF_FRAME_MAX          65536
+
+typedef struct _stub_host_interface_t {
+    int32_t              type;
+    sai_object_id_t      rif_port;
+    char                 name[HOSTIF_NAME_SIZE];
+    bool                 oper_status;
+    /* TAP or packet socket */
+    int                  fd;
+    /* Netdev host interfaces: frame read into a too small caller buffer, kept for the next receive */
+    uint8_t             *pending;
+    sai_size_t           pending_length;
+    /* FD host interfaces: RX blocks then TX frames */
+    uint8_t             *ring;
+    size_t               ring_size;
+    uint32_t             rx_block;
+    /* Next frame of rx_block and frames left in it, NULL before the block is taken */
+    struct tpacket3_hdr *rx_frame;
+    uint32_t             rx_left;
+    uint32_t             tx_frame;
+    bool                 is_valid;
+} stub_host_interface_t;
+
+static stub_host_interface_t host_interface_db[MAX_HOST_INTERFACES];
+
+static sai_status_t db_get_host_interface(_In_ sai_object_id_t hif_id, _Out_ stub_host_interface_t **hif)
+{
+    sai_status_t status;
+    uint32_t     hif_data;
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(hif_id, SAI_OBJECT_TYPE_HOST_INTERFACE, &hif_data))) {
+        return status;
+    }
+
+    if ((hif_data >= MAX_HOST_INTERFACES) || (!host_interface_db[hif_data].is_valid)) {
+        STUB_LOG_ERR("Invalid host interface %u\n", hif_data);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *hif = &host_interface_db[hif_data];
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t db_find_free_host_interface_index(_Out_ uint32_t *free_index)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < MAX_HOST_INTERFACES; ii++) {
+        if (false == host_interface_db[ii].is_valid) {
+            *free_index = ii;
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+
+    STUB_LOG_ERR("Host interface table full\n");
+    return SAI_STATUS_TABLE_FULL;
+}
+
+/* Set link up or down, and rename it when name isn't NULL */
+static sai_status_t host_interface_link_set(_In_ uint32_t ifindex, _In_ bool up, _In_ const char *name)
+{
+    struct {
+        struct nlmsghdr  hdr;
+        struct ifinfomsg ifi;
+        char             attrs[RTA_SPACE(HOSTIF_NAME_SIZE)];
+    } req;
+    struct {
+        struct nlmsghdr hdr;
+        struct nlmsgerr err;
+    } ack;
+    struct rtattr *rta;
+    int            fd;
+    ssize_t        len;
+
+    memset(&req, 0, sizeof(req));
+    req.hdr.nlmsg_len    = NLMSG_LENGTH(sizeof(req.ifi));
+    req.hdr.nlmsg_type   = RTM_NEWLINK;
+    req.hdr.nlmsg_flags  = NLM_F_REQUEST | NLM_F_ACK;
+    req.ifi.ifi_family   = AF_UNSPEC;
+    req.ifi.ifi_index    = ifindex;
+    req.ifi.ifi_flags    = up ? IFF_UP : 0;
+    req.ifi.ifi_change   = IFF_UP;
+
+    if (NULL != name) {
+        rta           = (struct rtattr*)((uint8_t*)&req + NLMSG_ALIGN(req.hdr.nlmsg_len));
+        rta->rta_type = IFLA_IFNAME;
+        rta->rta_len  = RTA_LENGTH(strlen(name) + 1);
+        memcpy(RTA_DATA(rta), name, strlen(name) + 1);
+        req.hdr.nlmsg_len = NLMSG_ALIGN(req.hdr.nlmsg_len) + RTA_ALIGN(rta->rta_len);
+    }
+
+    if (0 > (fd = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE))) {
+        STUB_LOG_ERR("Failed to open netlink socket, %s\n", strerror(errno));
+        return SAI_STATUS_FAILURE;
+    }
+
+    if ((0 > send(fd, &req, req.hdr.nlmsg_len, 0)) ||
+        (0 > (len = recv(fd, &ack, sizeof(ack), 0)))) {
+        STUB_LOG_ERR("Failed netlink request for link %u, %s\n", ifindex, strerror(errno));
+        close(fd);
+        return SAI_STATUS_FAILURE;
+    }
+    close(fd);
+
+    if ((len < (ssize_t)sizeof(ack)) || (NLMSG_ERROR != ack.hdr.nlmsg_type)) {
+        STUB_LOG_ERR("Unexpected netlink reply for link %u\n", ifindex);
+        return SAI_STATUS_FAILURE;
+    }
+
+    if (0 != ack.err.error) {
+        STUB_LOG_ERR("Failed to set link %u, %s\n", ifindex, strerror(-ack.err.error));
+        return SAI_STATUS_FAILURE;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t host_interface_tap_open(_Inout_ stub_host_interface_t *hif)
+{
+    struct ifreq ifr;
+
+    if (0 > (hif->fd = open("/dev/net/tun", O_RDWR | O_NONBLOCK | O_CLOEXEC))) {
+        STUB_LOG_ERR("Failed to open TUN device, %s\n", strerror(errno));
+        return SAI_STATUS_FAILURE;
+    }
+
+    memset(&ifr, 0, sizeof(ifr));
+    ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
+    strncpy(ifr.ifr_name, hif->name, IFNAMSIZ - 1);
+    if (0 > ioctl(hif->fd, TUNSETIFF, &ifr)) {
+        STUB_LOG_ERR("Failed to create TAP %s, %s\n", hif->name, strerror(errno));
+        close(hif->fd);
+        return SAI_STATUS_FAILURE;
+    }
+
+    if (NULL == (hif->pending = malloc(HOSTIF_FRAME_MAX))) {
+        STUB_LOG_ERR("Failed to allocate host interface buffer\n");
+        close(hif->fd);
+        return SAI_STATUS_NO_MEMORY;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t host_interface_packet_bind(_In_ const stub_host_interface_t *hif)
+{
+    struct sockaddr_ll addr;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sll_family   = AF_PACKET;
+    addr.sll_protocol = htons(ETH_P_ALL);
+    if (0 == (addr.sll_ifindex = if_nametoindex(hif->name))) {
+        STUB_LOG_ERR("No netdev %s for FD host interface\n", hif->name);
+        return SAI_STATUS_FAILURE;
+    }
+
+    if (0 > bind(hif->fd, (struct sockaddr*)&addr, sizeof(addr))) {
+        STUB_LOG_ERR("Failed to bind to %s, %s\n", hif->name, strerror(errno));
+        return SAI_STATUS_FAILURE;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t host_interface_packet_open(_Inout_ stub_host_interface_t *hif)
+{
+    struct tpacket_req3 rx_req, tx_req;
+    int                 version = TPACKET_V3, one = 1;
+    sai_status_t        status;
+
+    if (0 > (hif->fd = socket(AF_PACKET, SOCK_RAW | SOCK_CLOEXEC, htons(ETH_P_ALL)))) {
+        STUB_LOG_ERR("Failed to open packet socket, %s\n", strerror(errno));
+        return SAI_STATUS_FAILURE;
+    }
+
+    memset(&rx_req, 0, sizeof(rx_req));
+    rx_req.tp_block_size       = HOSTIF_RX_BLOCK_SIZE;
+    rx_req.tp_block_nr         = HOSTIF_RX_BLOCKS;
+    rx_req.tp_frame_size       = HOSTIF_RX_FRAME_SIZE;
+    rx_req.tp_frame_nr         = HOSTIF_RX_BLOCK_SIZE / HOSTIF_RX_FRAME_SIZE * HOSTIF_RX_BLOCKS;
+    rx_req.tp_retire_blk_tov   = HOSTIF_RX_BLOCK_TIMEOUT;
+    memset(&tx_req, 0, sizeof(tx_req));
+    tx_req.tp_block_size       = HOSTIF_TX_FRAME_SIZE;
+    tx_req.tp_block_nr         = HOSTIF_TX_FRAMES;
+    tx_req.tp_frame_size       = HOSTIF_TX_FRAME_SIZE;
+    tx_req.tp_frame_nr         = HOSTIF_TX_FRAMES;
+
+    if ((0 > setsockopt(hif->fd, SOL_PACKET, PACKET_VERSION, &version, sizeof(version))) ||
+        (0 > setsockopt(hif->fd, SOL_PACKET, PACKET_RX_RING, &rx_req, sizeof(rx_req))) ||
+        (0 > setsockopt(hif->fd, SOL_PACKET, PACKET_TX_RING, &tx_req, sizeof(tx_req)))) {
+        STUB_LOG_ERR("Failed to set packet socket rings, %s\n", strerror(errno));
+        close(hif->fd);
+        return SAI_STATUS_FAILURE;
+    }
+
+    /* Best effort, frames sent then skip the qdisc and don't loop back to the RX ring */
+    setsockopt(hif->fd, SOL_PACKET, PACKET_QDISC_BYPASS, &one, sizeof(one));
+#ifdef PACKET_IGNORE_OUTGOING
+    setsockopt(hif->fd, SOL_PACKET, PACKET_IGNORE_OUTGOING, &one, sizeof(one));
+#endif
+
+    hif->ring_size = (size_t)HOSTIF_RX_BLOCK_SIZE * HOSTIF_RX_BLOCKS + (size_t)HOSTIF_TX_FRAME_SIZE * HOSTIF_TX_FRAMES;
+    hif->ring      = mmap(NULL, hif->ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, hif->fd, 0);
+    if (MAP_FAILED == hif->ring) {
+        STUB_LOG_ERR("Failed to map packet socket rings, %s\n", strerror(errno));
+        close(hif->fd);
+        return SAI_STATUS_FAILURE;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = host_interface_packet_bind(hif))) {
+        munmap(hif->ring, hif->ring_size);
+        close(hif->fd);
+        return status;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static void host_interface_close(_Inout_ stub_host_interface_t *hif)
+{
+    if (NULL != hif->ring) {
+        munmap(hif->ring, hif->ring_size);
+    }
+    free(hif->pending);
+    close(hif->fd);
+}
+
+/* Next frame of the RX ring, NULL when none */
+static struct tpacket3_hdr* host_interface_ring_peek(_Inout_ stub_host_interface_t *hif)
+{
+    struct tpacket_block_desc *block;
+
+    while (NULL == hif->rx_frame) {
+        block = (struct tpacket_block_desc*)(hif->ring + (size_t)hif->rx_block * HOSTIF_RX_BLOCK_SIZE);
+        if (!(__atomic_load_n(&block->hdr.bh1.block_status, __ATOMIC_ACQUIRE) & TP_STATUS_USER)) {
+            return NULL;
+        }
+
+        if (0 == block->hdr.bh1.num_pkts) {
+            __atomic_store_n(&block->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+            hif->rx_block = (hif->rx_block + 1) % HOSTIF_RX_BLOCKS;
+            continue;
+        }
+
+        hif->rx_frame = (struct tpacket3_hdr*)((uint8_t*)block + block->hdr.bh1.offset_to_first_pkt);
+        hif->rx_left  = block->hdr.bh1.num_pkts;
+    }
+
+    return hif->rx_frame;
+}
+
+/* Done with the frame peeked, give the block back to the kernel after its last frame */
+static void host_interface_ring_pop(_Inout_ stub_host_interface_t *hif)
+{
+    struct tpacket_block_desc *block;
+
+    if (0 != --hif->rx_left) {
+        hif->rx_frame = (struct tpacket3_hdr*)((uint8_t*)hif->rx_frame + hif->rx_frame->tp_next_offset);
+        return;
+    }
+
+    block = (struct tpacket_block_desc*)(hif->ring + (size_t)hif->rx_block * HOSTIF_RX_BLOCK_SIZE);
+    __atomic_store_n(&block->hdr.bh1.block_status, TP_STATUS_KERNEL, __ATOMIC_RELEASE);
+    hif->rx_block = (hif->rx_block + 1) % HOSTIF_RX_BLOCKS;
+    hif->rx_frame = NULL;
+}
+
+/*
+ * Receive a frame into buffer. A frame larger than buffer is kept, and its
+ * length returned with SAI_STATUS_BUFFER_OVERFLOW.
+ */
+static sai_status_t host_interface_frame_recv(_Inout_ stub_host_interface_t *hif,
+                                              _Out_ void                    *buffer,
+                                              _Inout_ sai_size_t            *buffer_size)
+{
+    struct tpacket3_hdr *frame;
+    struct iovec         iov[2];
+    ssize_t              len;
+
+    if (SAI_HOSTIF_TYPE_FD == hif->type) {
+        if (NULL == (frame = host_interface_ring_peek(hif))) {
+            return SAI_STATUS_ITEM_NOT_FOUND;
+        }
+
+        if (*buffer_size < frame->tp_snaplen) {
+            *buffer_size = frame->tp_snaplen;
+            return SAI_STATUS_BUFFER_OVERFLOW;
+        }
+
+        memcpy(buffer, (uint8_t*)frame + frame->tp_mac, frame->tp_snaplen);
+        *buffer_size = frame->tp_snaplen;
+        host_interface_ring_pop(hif);
+        return SAI_STATUS_SUCCESS;
+    }
+
+    if (0 != hif->pending_length) {
+        if (*buffer_size < hif->pending_length) {
+            *buffer_size = hif->pending_length;
+            return SAI_STATUS_BUFFER_OVERFLOW;
+        }
+
+        memcpy(buffer, hif->pending, hif->pending_length);
+        *buffer_size        = hif->pending_length;
+        hif->pending_length = 0;
+        return SAI_STATUS_SUCCESS;
+    }
+
+    /* Read straight into the caller buffer, the rest of a larger frame into pending */
+    iov[0].iov_base = buffer;
+    iov[0].iov_len  = (*buffer_size < HOSTIF_FRAME_MAX) ? *buffer_size : HOSTIF_FRAME_MAX;
+    iov[1].iov_base = hif->pending;
+    iov[1].iov_len  = HOSTIF_FRAME_MAX - iov[0].iov_len;
+    if (0 > (len = readv(hif->fd, iov, (0 == iov[1].iov_len) ? 1 : 2))) {
+        if ((EAGAIN == errno) || (EWOULDBLOCK == errno)) {
+            return SAI_STATUS_ITEM_NOT_FOUND;
+        }
+        STUB_LOG_ERR("Failed to read from %s, %s\n", hif->name, strerror(errno));
+        return SAI_STATUS_FAILURE;
+    }
+
+    if ((size_t)len > iov[0].iov_len) {
+        memmove(hif->pending + iov[0].iov_len, hif->pending, len - iov[0].iov_len);
+        memcpy(hif->pending, buffer, iov[0].iov_len);
+        hif->pending_length = len;
+        *buffer_size        = len;
+        return SAI_STATUS_BUFFER_OVERFLOW;
+    }
+
+    *buffer_size = len;
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Send count frames, sent set to the number queued before the TX ring or the TAP filled up */
+static sai_status_t host_interface_frames_send(_Inout_ stub_host_interface_t     *hif,
+                                               _In_ uint32_t                   count,
+                                               _In_ const sai_hostif_packet_t *packets,
+                                               _Out_ uint32_t                 *sent)
+{
+    struct tpacket3_hdr *frame;
+    sai_status_t         status = SAI_STATUS_SUCCESS;
+    uint32_t             ii;
+
+    *sent = 0;
+
+    if (SAI_HOSTIF_TYPE_NETDEV == hif->type) {
+        for (ii = 0; ii < count; ii++) {
+            if (0 > write(hif->fd, packets[ii].buffer, packets[ii].buffer_size)) {
+                if ((EAGAIN == errno) || (EWOULDBLOCK == errno)) {
+                    break;
+                }
+                STUB_LOG_ERR("Failed to write to %s, %s\n", hif->name, strerror(errno));
+                return SAI_STATUS_FAILURE;
+            }
+            (*sent)++;
+        }
+        return SAI_STATUS_SUCCESS;
+    }
+
+    for (ii = 0; ii < count; ii++) {
+        if (packets[ii].buffer_size > HOSTIF_TX_FRAME_SIZE - HOSTIF_TX_DATA_OFFSET) {
+            STUB_LOG_ERR("Packet of %zu bytes too large for the TX ring\n", (size_t)packets[ii].buffer_size);
+            status = SAI_STATUS_INVALID_PARAMETER;
+            break;
+        }
+
+        frame = (struct tpacket3_hdr*)(hif->ring + (size_t)HOSTIF_RX_BLOCK_SIZE * HOSTIF_RX_BLOCKS +
+                                       (size_t)hif->tx_frame * HOSTIF_TX_FRAME_SIZE);
+        if (TP_STATUS_AVAILABLE != __atomic_load_n(&frame->tp_status, __ATOMIC_ACQUIRE)) {
+            break;
+        }
+
+        memcpy((uint8_t*)frame + HOSTIF_TX_DATA_OFFSET, packets[ii].buffer, packets[ii].buffer_size);
+        frame->tp_len         = packets[ii].buffer_size;
+        frame->tp_snaplen     = packets[ii].buffer_size;
+        frame->tp_next_offset = 0;
+        __atomic_store_n(&frame->tp_status, TP_STATUS_SEND_REQUEST, __ATOMIC_RELEASE);
+        hif->tx_frame = (hif->tx_frame + 1) % HOSTIF_TX_FRAMES;
+        (*sent)++;
+    }
+
+    /* An error left on the socket by a past link down is reported once, the frames go on the next kick */
+    if ((0 != *sent) && (0 > sendto(hif->fd, NULL, 0, MSG_DONTWAIT, NULL, 0)) &&
+        ((ENETDOWN != errno) || (0 > sendto(hif->fd, NULL, 0, MSG_DONTWAIT, NULL, 0))) &&
+        (EAGAIN != errno) && (EWOULDBLOCK != errno)) {
+        STUB_LOG_ERR("Failed to send on %s, %s\n", hif->name, strerror(errno));
+        return SAI_STATUS_FAILURE;
+    }
+
+    return status;
+}
+
+/*
+ * Trapped packets are punted to the CPU queue of their trap group, past its
+ * policer. A CPU queue is a single producer single consumer ring per punting
+ * core, so punting takes no lock and a core flooding a queue doesn't delay
+ * the others. The consumer takes packets of the CPU queues by weighted round
+ * robin, up to the weight of a queue in a row, so a queue filled by an ARP
+ * storm can't starve the queue BGP is trapped to.
+ *
+ * Traps are identified by their trap ID, switch, router and exception traps
+ * taking a bank of TRAP_BANK_SIZE IDs each. Drops are counted per trap and
+ * per core, for the trap group being disabled, for its policer and for its
+ * CPU queue being full.
+ *
+ * The trap thread hands the punted packets to the packet event notification,
+ * when one is set, and they are left to recv_packet otherwise. Both consume
+ * the CPU queues under the trap consumer lock, as their consumer state isn't
+ * shared safely.
+ */
+#define TRAP_CPU_QUEUES        8
+#define TRAP_RING_SIZE         512
+#define TRAP_BANK_SIZE         32
+#define TRAP_BANKS             3
+#define TRAP_NUMBER            (TRAP_BANK_SIZE * TRAP_BANKS)
+#define MAX_TRAP_GROUPS        16
+#define DEFAULT_TRAP_GROUP     0
+#define TRAP_DISPATCH_BUDGET   256
+#define TRAP_IDLE_US           100
+
+typedef struct _stub_trap_t {
+    sai_packet_action_t action;
+    uint32_t            priority;
+    int32_t             channel;
+    /* Trap group, the switch default one when not set */
+    bool                group_set;
+    uint32_t            group;
+} stub_trap_t;
+
+typedef struct _stub_trap_group_t {
+    bool            admin_state;
+    uint32_t        queue;
+    sai_object_id_t policer;
+    uint32_t        policer_db_id;
+    bool            is_valid;
+} stub_trap_group_t;
+
+typedef struct _stub_trap_counters_t {
+    uint64_t punted;
+    uint64_t admin_drops;
+    uint64_t policer_drops;
+    uint64_t queue_drops;
+} __attribute__((aligned(CACHE_LINE_SIZE))) stub_trap_counters_t;
+
+/* Tail is only written by the punting core, head by the consumer */
+typedef struct _stub_trap_ring_t {
+    uint32_t           tail __attribute__((aligned(CACHE_LINE_SIZE)));
+    uint32_t           head __attribute__((aligned(CACHE_LINE_SIZE)));
+    stub_trap_packet_t slots[TRAP_RING_SIZE];
+} stub_trap_ring_t;
+
+static stub_trap_t          trap_db[TRAP_NUMBER] = {
+    [0 ... TRAP_NUMBER - 1] = { .action = SAI_PACKET_ACTION_FORWARD, .channel = SAI_HOSTIF_TRAP_CHANNEL_CB }
+};
+static stub_trap_group_t    trap_group_db[MAX_TRAP_GROUPS] = {
+    [DEFAULT_TRAP_GROUP] = { .admin_state = true, .is_valid = true }
+};
+static uint32_t             trap_default_group = DEFAULT_TRAP_GROUP;
+static stub_trap_counters_t trap_counters[TRAP_NUMBER][STUB_CORES];
+static stub_trap_ring_t     trap_rings[STUB_CORES][TRAP_CPU_QUEUES];
+/* Consumer state, the queue served, packets it may still send in a row, and the next core ring of each queue */
+static uint32_t             trap_weights[TRAP_CPU_QUEUES] = { [0 ... TRAP_CPU_QUEUES - 1] = 1 };
+static uint32_t             trap_queue = TRAP_CPU_QUEUES - 1;
+static uint32_t             trap_credit;
+static uint32_t             trap_ring_next[TRAP_CPU_QUEUES];
+static pthread_mutex_t      trap_consumer_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t            trap_thread;
+static bool                 trap_running;
+
+static sai_status_t db_get_trap(_In_ int32_t trap_id, _Out_ uint32_t *index)
+{
+    uint32_t bank = (uint32_t)trap_id / 0x2000, offset = (uint32_t)trap_id % 0x2000;
+
+    if ((trap_id < 0) || (bank >= TRAP_BANKS) || (offset >= TRAP_BANK_SIZE)) {
+        STUB_LOG_ERR("Invalid trap ID 0x%x\n", trap_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *index = bank * TRAP_BANK_SIZE + offset;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t db_get_trap_group(_In_ sai_object_id_t trap_group_id, _Out_ uint32_t *db_id)
+{
+    sai_status_t status;
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_object_to_type(trap_group_id, SAI_OBJECT_TYPE_HOSTIF_TRAP_GROUP, db_id))) {
+        return status;
+    }
+
+    if ((*db_id >= MAX_TRAP_GROUPS) || (!trap_group_db[*db_id].is_valid)) {
+        STUB_LOG_ERR("Invalid trap group %u\n", *db_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t db_find_free_trap_group_index(_Out_ uint32_t *free_index)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < MAX_TRAP_GROUPS; ii++) {
+        if (false == trap_group_db[ii].is_valid) {
+            *free_index = ii;
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+
+    STUB_LOG_ERR("Trap group table full\n");
+    return SAI_STATUS_TABLE_FULL;
+}
+
+static uint32_t trap_group_of(_In_ const stub_trap_t *trap)
+{
+    return trap->group_set ? trap->group : __atomic_load_n(&trap_default_group, __ATOMIC_RELAXED);
+}
+
+/*
+ * Punt count trapped packets of a core to the CPU queues, taking a reference
+ * on the buffers queued. punted, which may be NULL, tells the ones queued.
+ * Packets of traps with a forward or drop action aren't punted.
+ */
+sai_status_t db_trap_punt(_In_ uint32_t                  core,
+                          _In_ uint64_t                  now_ns,
+                          _In_ uint32_t                  count,
+                          _In_ const stub_trap_packet_t *packets,
+                          _Out_ bool                    *punted)
+{
+    const stub_trap_group_t *group;
+    stub_trap_counters_t    *counters;
+    stub_trap_ring_t        *ring;
+    sai_packet_action_t      action, meter_action;
+    sai_packet_color_t       color;
+    sai_status_t             status;
+    uint32_t                 ii, index, tail;
+
+    if (core >= STUB_CORES) {
+        STUB_LOG_ERR("Invalid core %u\n", core);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    for (ii = 0; ii < count; ii++) {
+        if (NULL != punted) {
+            punted[ii] = false;
+        }
+
+        if (SAI_STATUS_SUCCESS != (status = db_get_trap(packets[ii].trap_id, &index))) {
+            return status;
+        }
+
+        action = __atomic_load_n(&trap_db[index].action, __ATOMIC_RELAXED);
+        if ((SAI_PACKET_ACTION_TRAP != action) && (SAI_PACKET_ACTION_LOG != action) &&
+            (SAI_PACKET_ACTION_COPY != action)) {
+            continue;
+        }
+
+        group    = &trap_group_db[trap_group_of(&trap_db[index])];
+        counters = &trap_counters[index][core];
+
+        if (!group->admin_state) {
+            counters->admin_drops++;
+            continue;
+        }
+
+        if ((SAI_NULL_OBJECT_ID != group->policer) &&
+            (SAI_STATUS_SUCCESS == db_policer_meter(group->policer_db_id, core, now_ns, 1, &packets[ii].length,
+                                                    NULL, &color, &meter_action)) &&
+            (SAI_PACKET_ACTION_DROP == meter_action)) {
+            counters->policer_drops++;
+            continue;
+        }
+
+        ring = &trap_rings[core][group->queue];
+        tail = ring->tail;
+        if (TRAP_RING_SIZE == tail - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE)) {
+            counters->queue_drops++;
+            continue;
+        }
+
+        __atomic_fetch_add(&packets[ii].buf->ref_count, 1, __ATOMIC_RELAXED);
+        ring->slots[tail % TRAP_RING_SIZE] = packets[ii];
+        __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+        counters->punted++;
+
+        if (NULL != punted) {
+            punted[ii] = true;
+        }
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Next packet of the CPU queues by weighted round robin, NULL when all are empty */
+static const stub_trap_packet_t* trap_queue_peek()
+{
+    const stub_trap_ring_t *ring;
+    uint32_t                ii, jj, core;
+
+    /* Up to all the queues, then the current one again with new credit */
+    for (ii = 0; ii <= TRAP_CPU_QUEUES; ii++) {
+        if (0 != trap_credit) {
+            for (jj = 0; jj < STUB_CORES; jj++) {
+                core = (trap_ring_next[trap_queue] + jj) % STUB_CORES;
+                ring = &trap_rings[core][trap_queue];
+                if (ring->head != __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE)) {
+                    trap_ring_next[trap_queue] = core;
+                    return &ring->slots[ring->head % TRAP_RING_SIZE];
+                }
+            }
+        }
+
+        trap_queue  = (trap_queue + 1) % TRAP_CPU_QUEUES;
+        trap_credit = trap_weights[trap_queue];
+    }
+
+    return NULL;
+}
+
+/* Done with the packet peeked, its buffer reference is the caller's */
+static void trap_queue_pop()
+{
+    uint32_t          core = trap_ring_next[trap_queue];
+    stub_trap_ring_t *ring = &trap_rings[core][trap_queue];
+
+    __atomic_store_n(&ring->head, ring->head + 1, __ATOMIC_RELEASE);
+    trap_ring_next[trap_queue] = (core + 1) % STUB_CORES;
+    trap_credit--;
+}
+
+static void trap_packet_attrs(_In_ const stub_trap_packet_t *packet, _Out_ sai_attribute_t *attr_list)
+{
+    attr_list[0].id        = SAI_HOSTIF_PACKET_ATTR_HOSTIF_TRAP_TYPE;
+    attr_list[0].value.s32 = packet->trap_id;
+    attr_list[1].id        = SAI_HOSTIF_PACKET_ATTR_INGRESS_PORT;
+    stub_create_object(SAI_OBJECT_TYPE_PORT, packet->port_id, &attr_list[1].value.oid);
+}
+
+/*
+ * Hand up to budget punted packets to the packet event notification, run by
+ * the trap thread. Packets are left to recv_packet when no notification is
+ * set. The notification is called with the consumer lock held, so a packet
+ * is never taken off the queues once the notification is cleared.
+ */
+sai_status_t db_trap_dispatch(_In_ uint32_t budget, _Out_ uint32_t *count)
+{
+    const stub_trap_packet_t *packet;
+    sai_attribute_t           attr_list[2];
+
+    pthread_mutex_lock(&trap_consumer_lock);
+
+    for (*count = 0; *count < budget; (*count)++) {
+        if ((NULL == g_notification_callbacks.on_packet_event) || (NULL == (packet = trap_queue_peek()))) {
+            break;
+        }
+
+        trap_packet_attrs(packet, attr_list);
+        g_notification_callbacks.on_packet_event(packet->buf->data, packet->length, 2, attr_list);
+        db_mirror_buf_release(packet->buf);
+        trap_queue_pop();
+    }
+
+    pthread_mutex_unlock(&trap_consumer_lock);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Copy the next punted packet to buffer, SAI_STATUS_ITEM_NOT_FOUND when the CPU queues are empty */
+static sai_status_t trap_packet_recv(_Out_ void            *buffer,
+                                     _Inout_ sai_size_t    *buffer_size,
+                                     _Inout_ uint32_t      *attr_count,
+                                     _Out_ sai_attribute_t *attr_list)
+{
+    const stub_trap_packet_t *packet;
+    sai_status_t              status = SAI_STATUS_SUCCESS;
+
+    pthread_mutex_lock(&trap_consumer_lock);
+
+    if (NULL == (packet = trap_queue_peek())) {
+        status = SAI_STATUS_ITEM_NOT_FOUND;
+    } else if ((*buffer_size < packet->length) || (*attr_count < 2)) {
+        *buffer_size = packet->length;
+        *attr_count  = 2;
+        status       = SAI_STATUS_BUFFER_OVERFLOW;
+    } else if (NULL == attr_list) {
+        STUB_LOG_ERR("NULL attribute list param\n");
+        status = SAI_STATUS_INVALID_PARAMETER;
+    } else {
+        memcpy(buffer, packet->buf->data, packet->length);
+        trap_packet_attrs(packet, attr_list);
+        *buffer_size = packet->length;
+        *attr_count  = 2;
+
+        db_mirror_buf_release(packet->buf);
+        trap_queue_pop();
+    }
+
+    pthread_mutex_unlock(&trap_consumer_lock);
+
+    return status;
+}
+
+static void* trap_thread_run(void *arg)
+{
+    uint32_t count;
+
+    while (__atomic_load_n(&trap_running, __ATOMIC_ACQUIRE)) {
+        db_trap_dispatch(TRAP_DISPATCH_BUDGET, &count);
+        if (0 == count) {
+            usleep(TRAP_IDLE_US);
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Start the trap thread. It polls the CPU queues, sleeping TRAP_IDLE_US when
+ * they are empty, so punting never takes a lock or wakes it up.
+ */
+sai_status_t db_trap_start()
+{
+    int err;
+
+    if (__atomic_load_n(&trap_running, __ATOMIC_ACQUIRE)) {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    __atomic_store_n(&trap_running, true, __ATOMIC_RELEASE);
+    if (0 != (err = pthread_create(&trap_thread, NULL, trap_thread_run, NULL))) {
+        __atomic_store_n(&trap_running, false, __ATOMIC_RELEASE);
+        STUB_LOG_ERR("Failed to start trap thread, %s\n", strerror(err));
+        return SAI_STATUS_FAILURE;
+    }
+
+    STUB_LOG_NTC("Trap thread started\n");
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Stop the trap thread, packets still queued are left to recv_packet */
+void db_trap_stop()
+{
+    if (!__atomic_load_n(&trap_running, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+
+    __atomic_store_n(&trap_running, false, __ATOMIC_RELEASE);
+    pthread_join(trap_thread, NULL);
+}
+
+/* Packet action of a trap, telling whether its packets still go on after the trap */
+sai_status_t db_trap_action_get(_In_ int32_t trap_id, _Out_ sai_packet_action_t *action)
+{
+    sai_status_t status;
+    uint32_t     index;
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_trap(trap_id, &index))) {
+        return status;
+    }
+
+    *action = __atomic_load_n(&trap_db[index].action, __ATOMIC_RELAXED);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Trap of a control protocol packet, from its Ethernet header and first
+ * length bytes. Returns false for packets no trap is defined for.
+ */
+bool db_trap_classify(_In_ const uint8_t *data, _In_ uint32_t length, _Out_ int32_t *trap_id)
+{
+    static const uint8_t stp_mac[6] = { 0x01, 0x80, 0xc2, 0x00, 0x00, 0x00 };
+    uint32_t             l3         = 14, l4;
+    uint16_t             ethertype, src_port = 0, dst_port = 0;
+    uint8_t              protocol;
+
+    if (length < 14) {
+        return false;
+    }
+
+    if (0 == memcmp(data, stp_mac, sizeof(stp_mac))) {
+        *trap_id = SAI_HOSTIF_TRAP_TYPE_STP;
+        return true;
+    }
+
+    ethertype = (data[12] << 8) | data[13];
+    if ((0x8100 == ethertype) && (length >= 18)) {
+        ethertype = (data[16] << 8) | data[17];
+        l3        = 18;
+    }
+
+    switch (ethertype) {
+    case 0x8809:
+        /* Slow protocols, LACP subtype */
+        if ((length > l3) && (1 == data[l3])) {
+            *trap_id = SAI_HOSTIF_TRAP_TYPE_LACP;
+            return true;
+        }
+        return false;
+
+    case 0x888E:
+        *trap_id = SAI_HOSTIF_TRAP_TYPE_EAPOL;
+        return true;
+
+    case 0x88CC:
+        *trap_id = SAI_HOSTIF_TRAP_TYPE_LLDP;
+        return true;
+
+    case 0x0806:
+        if (length < l3 + 8) {
+            return false;
+        }
+        *trap_id = (2 == data[l3 + 7]) ? SAI_HOSTIF_TRAP_TYPE_ARP_RESPONSE : SAI_HOSTIF_TRAP_TYPE_ARP_REQUEST;
+        return true;
+
+    case 0x0800:
+        if (length < l3 + 20) {
+            return false;
+        }
+        protocol = data[l3 + 9];
+        l4       = l3 + (data[l3] & 0x0F) * 4;
+        break;
+
+    case 0x86DD:
+        if (length < l3 + 40) {
+            return false;
+        }
+        protocol = data[l3 + 6];
+        l4       = l3 + 40;
+        break;
+
+    default:
+        return false;
+    }
+
+    if (length >= l4 + 4) {
+        src_port = (data[l4] << 8) | data[l4 + 1];
+        dst_port = (data[l4 + 2] << 8) | data[l4 + 3];
+    }
+
+    switch (protocol) {
+    case 6:
+        if ((179 != src_port) && (179 != dst_port)) {
+            return false;
+        }
+        *trap_id = (0x0800 == ethertype) ? SAI_HOSTIF_TRAP_TYPE_BGP : SAI_HOSTIF_TRAP_TYPE_BGPV6;
+        return true;
+
+    case 17:
+        if ((0x0800 == ethertype) && ((67 == dst_port) || (68 == dst_port))) {
+            *trap_id = SAI_HOSTIF_TRAP_TYPE_DHCP;
+            return true;
+        }
+        if ((0x86DD == ethertype) && ((546 == dst_port) || (547 == dst_port))) {
+            *trap_id = SAI_HOSTIF_TRAP_TYPE_DHCPV6;
+            return true;
+        }
+        return false;
+
+    case 58:
+        /* ICMPv6 router and neighbor solicitations and advertisements, and redirects */
+        if ((length > l4) && (data[l4] >= 133) && (data[l4] <= 137)) {
+            *trap_id = SAI_HOSTIF_TRAP_TYPE_IPV6_NEIGHBOR_DISCOVERY;
+            return true;
+        }
+        return false;
+
+    case 89:
+        *trap_id = (0x0800 == ethertype) ? SAI_HOSTIF_TRAP_TYPE_OSPF : SAI_HOSTIF_TRAP_TYPE_OSPFV6;
+        return true;
+
+    case 103:
+        *trap_id = SAI_HOSTIF_TRAP_TYPE_PIM;
+        return true;
+
+    case 112:
+        *trap_id = (0x0800 == ethertype) ? SAI_HOSTIF_TRAP_TYPE_VRRP : SAI_HOSTIF_TRAP_TYPE_VRRPV6;
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+sai_status_t db_trap_stats_get(_In_ int32_t trap_id, _Out_ stub_trap_stats_t *stats)
+{
+    const stub_trap_counters_t *counters;
+    sai_status_t                status;
+    uint32_t                    index, core;
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_trap(trap_id, &index))) {
+        return status;
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    for (core = 0; core < STUB_CORES; core++) {
+        counters              = &trap_counters[index][core];
+        stats->punted        += counters->punted;
+        stats->admin_drops   += counters->admin_drops;
+        stats->policer_drops += counters->policer_drops;
+        stats->queue_drops   += counters->queue_drops;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Packets a CPU queue may send in a row, 1 by default */
+sai_status_t db_trap_cpu_queue_weight_set(_In_ uint32_t queue, _In_ uint32_t weight)
+{
+    if ((queue >= TRAP_CPU_QUEUES) || (0 == weight)) {
+        STUB_LOG_ERR("Invalid CPU queue %u weight %u\n", queue, weight);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    trap_weights[queue] = weight;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t db_trap_default_group_get(_Out_ sai_object_id_t *trap_group_id)
+{
+    return stub_create_object(SAI_OBJECT_TYPE_HOSTIF_TRAP_GROUP, trap_default_group, trap_group_id);
+}
+
+sai_status_t db_trap_default_group_set(_In_ sai_object_id_t trap_group_id)
+{
+    sai_status_t status;
+    uint32_t     db_id;
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_trap_group(trap_group_id, &db_id))) {
+        return status;
+    }
+
+    __atomic_store_n(&trap_default_group, db_id, __ATOMIC_RELAXED);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*************************/
+
 static void host_interface_key_to_str(_In_ sai_object_id_t hif_id, _Out_ char *key_str)
 {
-    uint32_t hif_data;
+    uint32_t hif_data;
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(hif_id, SAI_OBJECT_TYPE_HOST_INTERFACE, &hif_data)) {
+        snprintf(key_str, MAX_KEY_STR_LEN, "invalid host interface");
+    } else {
+        snprintf(key_str, MAX_KEY_STR_LEN, "host interface %u", hif_data);
+    }
+}
+
+static void trap_group_key_to_str(_In_ sai_object_id_t trap_group_id, _Out_ char *key_str)
+{
+    uint32_t db_id;
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(trap_group_id, SAI_OBJECT_TYPE_HOSTIF_TRAP_GROUP, &db_id)) {
+        snprintf(key_str, MAX_KEY_STR_LEN, "invalid trap group");
+    } else {
+        snprintf(key_str, MAX_KEY_STR_LEN, "trap group %u", db_id);
+    }
+}
+
+static void trap_key_to_str(_In_ int32_t trap_id, _Out_ char *key_str)
+{
+    snprintf(key_str, MAX_KEY_STR_LEN, "trap 0x%x", trap_id);
+}
+
+/*
+ * Routine Description:
+ *    Create host interface.
+ *
+ * Arguments:
+ *    [out] hif_id - host interface id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_host_interface(_Out_ sai_object_id_t     * hif_id,
+                                        _In_ uint32_t               attr_count,
+                                        _In_ const sai_attribute_t *attr_list)
+{
+    sai_status_t                 status;
+    const sai_attribute_value_t *type, *rif_port, *name, *oper_status;
+    uint32_t                     type_index, rif_port_index, name_index, oper_status_index, rif_data, db_id;
+    stub_host_interface_t       *hif;
+    char                         key_str[MAX_KEY_STR_LEN];
+    char                         list_str[MAX_LIST_VALUE_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == hif_id) {
+        STUB_LOG_ERR("NULL host interface ID param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status =
+             check_attribs_metadata(attr_count, attr_list, host_interface_attribs, host_interface_vendor_attribs,
+                                    SAI_OPERATION_CREATE))) {
+        STUB_LOG_ERR("Failed attribs check\n");
+        return status;
+    }
+
+    sai_attr_list_to_str(attr_count, attr_list, host_interface_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create host interface, %s\n", list_str);
+
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_HOSTIF_ATTR_TYPE, &type, &type_index));
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_HOSTIF_ATTR_NAME, &name, &name_index));
+
+    if (SAI_STATUS_SUCCESS != (status = db_find_free_host_interface_index(&db_id))) {
+        return status;
+    }
+
+    hif = &host_interface_db[db_id];
+    memset(hif, 0, sizeof(*hif));
+    hif->type = type->s32;
+    strncpy(hif->name, name->chardata, HOSTIF_NAME_SIZE - 1);
+
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_HOSTIF_ATTR_OPER_STATUS, &oper_status, &oper_status_index)) {
+        hif->oper_status = oper_status->booldata;
+    }
+
+    if (SAI_HOSTIF_TYPE_NETDEV == type->s32) {
+        if (SAI_STATUS_SUCCESS !=
+            (status =
+                 find_attrib_in_list(attr_count, attr_list, SAI_HOSTIF_ATTR_RIF_OR_PORT_ID, &rif_port,
+                                     &rif_port_index))) {
+            STUB_LOG_ERR("Missing mandatory attribute rif port id on create of host if netdev type\n");
+            return SAI_STATUS_MANDATORY_ATTRIBUTE_MISSING;
+        }
+
+        if (SAI_OBJECT_TYPE_ROUTER_INTERFACE == sai_object_type_query(rif_port->oid)) {
+            if (SAI_STATUS_SUCCESS !=
+                (status = stub_object_to_type(rif_port->oid, SAI_OBJECT_TYPE_ROUTER_INTERFACE, &rif_data))) {
+                return status;
+            }
+        } else if (SAI_OBJECT_TYPE_PORT == sai_object_type_query(rif_port->oid)) {
+            if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(rif_port->oid, SAI_OBJECT_TYPE_PORT, &rif_data))) {
+                return status;
+            }
+        } else {
+            STUB_LOG_ERR("Invalid rif port object type %s", SAI_TYPE_STR(sai_object_type_query(rif_port->oid)));
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + rif_port_index;
+        }
+        hif->rif_port = rif_port->oid;
+
+        if (SAI_STATUS_SUCCESS != (status = host_interface_tap_open(hif))) {
+            return status;
+        }
+
+        if (hif->oper_status &&
+            (SAI_STATUS_SUCCESS != (status = host_interface_link_set(if_nametoindex(hif->name), true, NULL)))) {
+            host_interface_close(hif);
+            return status;
+        }
+    } else if (SAI_HOSTIF_TYPE_FD == type->s32) {
+        if (SAI_STATUS_SUCCESS != (status = host_interface_packet_open(hif))) {
+            return status;
+        }
+    } else {
+        STUB_LOG_ERR("Invalid host interface type %d\n", type->s32);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + type_index;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = stub_create_object(SAI_OBJECT_TYPE_HOST_INTERFACE, db_id, hif_id))) {
+        host_interface_close(hif);
+        return status;
+    }
+
+    hif->is_valid = true;
+
+    host_interface_key_to_str(*hif_id, key_str);
+    STUB_LOG_NTC("Created host interface %s\n", key_str);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Remove host interface
+ *
+ * Arguments:
+ *    [in] hif_id - host interface id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_host_interface(_In_ sai_object_id_t hif_id)
+{
+    char                   key_str[MAX_KEY_STR_LEN];
+    stub_host_interface_t *hif;
+    sai_status_t           status;
+
+    STUB_LOG_ENTER();
+
+    host_interface_key_to_str(hif_id, key_str);
+    STUB_LOG_NTC("Remove host interface %s\n", key_str);
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_host_interface(hif_id, &hif))) {
+        return status;
+    }
+
+    host_interface_close(hif);
+    hif->is_valid = false;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Set host interface attribute
+ *
+ * Arguments:
+ *    [in] hif_id - host interface id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_host_interface_attribute(_In_ sai_object_id_t hif_id, _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = hif_id };
+    char                   key_str[MAX_KEY_STR_LEN];
 
-    if (SAI_STATUS_SUCCESS != stub_object_to_type(hif_id, SAI_OBJECT_TYPE_HOST_INTERFACE, &hif_data)) {
-        snprintf(key_str, MAX_KEY_STR_LEN, "invalid host interface");
+    STUB_LOG_ENTER();
+
+    host_interface_key_to_str(hif_id, key_str);
+    return sai_set_attribute(&key, key_str, host_interface_attribs, host_interface_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get host interface attribute
+ *
+ * Arguments:
+ *    [in] hif_id - host interface id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_host_interface_attribute(_In_ sai_object_id_t     hif_id,
+                                               _In_ uint32_t            attr_count,
+                                               _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = hif_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    host_interface_key_to_str(hif_id, key_str);
+    return sai_get_attributes(&key,
+                              key_str,
+                              host_interface_attribs,
+                              host_interface_vendor_attribs,
+                              attr_count,
+                              attr_list);
+}
+
+/* Type [sai_host_interface_type_t] */
+sai_status_t stub_host_interface_type_get(_In_ const sai_object_key_t   *key,
+                                          _Inout_ sai_attribute_value_t *value,
+                                          _In_ uint32_t                  attr_index,
+                                          _Inout_ vendor_cache_t        *cache,
+                                          void                          *arg)
+{
+    stub_host_interface_t *hif;
+    sai_status_t           status;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_host_interface(key->object_id, &hif))) {
+        return status;
+    }
+
+    value->s32 = hif->type;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Assosiated port or router interface [sai_object_id_t] */
+sai_status_t stub_host_interface_rif_port_get(_In_ const sai_object_key_t   *key,
+                                              _Inout_ sai_attribute_value_t *value,
+                                              _In_ uint32_t                  attr_index,
+                                              _Inout_ vendor_cache_t        *cache,
+                                              void                          *arg)
+{
+    stub_host_interface_t *hif;
+    sai_status_t           status;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_host_interface(key->object_id, &hif))) {
+        return status;
+    }
+
+    value->oid = hif->rif_port;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Name [char[HOST_INTERFACE_NAME_SIZE]] (MANDATORY_ON_CREATE)
+ * The maximum number of charactars for the name is HOST_INTERFACE_NAME_SIZE - 1 since
+ * it needs the terminating null byte ('\0') at the end.  */
+sai_status_t stub_host_interface_name_get(_In_ const sai_object_key_t   *key,
+                                          _Inout_ sai_attribute_value_t *value,
+                                          _In_ uint32_t                  attr_index,
+                                          _Inout_ vendor_cache_t        *cache,
+                                          void                          *arg)
+{
+    stub_host_interface_t *hif;
+    sai_status_t           status;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_host_interface(key->object_id, &hif))) {
+        return status;
+    }
+
+    strncpy(value->chardata, hif->name, HOSTIF_NAME_SIZE);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Name [char[HOST_INTERFACE_NAME_SIZE]]
+ * The maximum number of charactars for the name is HOST_INTERFACE_NAME_SIZE - 1 since
+ * it needs the terminating null byte ('\0') at the end.
+ * Renames the TAP of netdev host interfaces, binds FD host interfaces to the named netdev. */
+sai_status_t stub_host_interface_name_set(_In_ const sai_object_key_t      *key,
+                                          _In_ const sai_attribute_value_t *value,
+                                          void                             *arg)
+{
+    stub_host_interface_t *hif;
+    char                   old_name[HOSTIF_NAME_SIZE];
+    uint32_t               ifindex;
+    sai_status_t           status;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_host_interface(key->object_id, &hif))) {
+        return status;
+    }
+
+    strncpy(old_name, hif->name, HOSTIF_NAME_SIZE);
+    strncpy(hif->name, value->chardata, HOSTIF_NAME_SIZE - 1);
+
+    if (SAI_HOSTIF_TYPE_FD == hif->type) {
+        status = host_interface_packet_bind(hif);
     } else {
-        snprintf(key_str, MAX_KEY_STR_LEN, "host interface %u", hif_data);
+        /* A link is renamed while down */
+        ifindex = if_nametoindex(old_name);
+        if ((SAI_STATUS_SUCCESS == (status = host_interface_link_set(ifindex, false, NULL))) &&
+            (SAI_STATUS_SUCCESS != (status = host_interface_link_set(ifindex, hif->oper_status, hif->name)))) {
+            host_interface_link_set(ifindex, hif->oper_status, NULL);
+        }
+    }
+
+    if (SAI_STATUS_SUCCESS != status) {
+        strncpy(hif->name, old_name, HOSTIF_NAME_SIZE);
+        return status;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Oper status [bool] */
+sai_status_t stub_host_interface_oper_status_get(_In_ const sai_object_key_t   *key,
+                                                 _Inout_ sai_attribute_value_t *value,
+                                                 _In_ uint32_t                  attr_index,
+                                                 _Inout_ vendor_cache_t        *cache,
+                                                 void                          *arg)
+{
+    stub_host_interface_t *hif;
+    sai_status_t           status;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_host_interface(key->object_id, &hif))) {
+        return status;
+    }
+
+    value->booldata = hif->oper_status;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Oper status [bool], sets the TAP link of netdev host interfaces up or down */
+sai_status_t stub_host_interface_oper_status_set(_In_ const sai_object_key_t      *key,
+                                                 _In_ const sai_attribute_value_t *value,
+                                                 void                             *arg)
+{
+    stub_host_interface_t *hif;
+    sai_status_t           status;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_host_interface(key->object_id, &hif))) {
+        return status;
+    }
+
+    if ((SAI_HOSTIF_TYPE_NETDEV == hif->type) &&
+        (SAI_STATUS_SUCCESS != (status = host_interface_link_set(if_nametoindex(hif->name), value->booldata, NULL)))) {
+        return status;
     }
+
+    hif->oper_status = value->booldata;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
 }
 
 /*
  * Routine Description:
- *    Create host interface.
+ *    Create host interface trap group
  *
  * Arguments:
- *    [out] hif_id - host interface id
+ *    [out] hostif_trap_group_id - trap group id
  *    [in] attr_count - number of attributes
  *    [in] attr_list - array of attributes
  *
@@ -96,146 +1553,306 @@ static void host_interface_key_to_str(_In_ sai_object_id_t hif_id, _Out_ char *k
  *    SAI_STATUS_SUCCESS on success
  *    Failure status code on error
  */
-sai_status_t stub_create_host_interface(_Out_ sai_object_id_t     * hif_id,
-                                        _In_ uint32_t               attr_count,
-                                        _In_ const sai_attribute_t *attr_list)
+sai_status_t stub_create_host_interface_trap_group(_Out_ sai_object_id_t      *hostif_trap_group_id,
+                                                   _In_ uint32_t               attr_count,
+                                                   _In_ const sai_attribute_t *attr_list)
 {
+    const sai_attribute_value_t *admin_state, *queue, *policer;
+    uint32_t                     admin_state_index, queue_index, policer_index, db_id;
+    stub_trap_group_t           *group;
     sai_status_t                 status;
-    int                          ret;
-    const sai_attribute_value_t *type, *rif_port, *name;
-    uint32_t                     type_index, rif_port_index, name_index, rif_data;
     char                         key_str[MAX_KEY_STR_LEN];
     char                         list_str[MAX_LIST_VALUE_STR_LEN];
-    static uint32_t              next_id = 0;
-    char                         system_cmd[1024];
 
     STUB_LOG_ENTER();
 
-    if (NULL == hif_id) {
-        STUB_LOG_ERR("NULL host interface ID param\n");
+    if (NULL == hostif_trap_group_id) {
+        STUB_LOG_ERR("NULL trap group ID param\n");
         return SAI_STATUS_INVALID_PARAMETER;
     }
 
     if (SAI_STATUS_SUCCESS !=
-        (status =
-             check_attribs_metadata(attr_count, attr_list, host_interface_attribs, host_interface_vendor_attribs,
-                                    SAI_OPERATION_CREATE))) {
+        (status = check_attribs_metadata(attr_count, attr_list, trap_group_attribs, trap_group_vendor_attribs,
+                                         SAI_OPERATION_CREATE))) {
         STUB_LOG_ERR("Failed attribs check\n");
         return status;
     }
 
-    sai_attr_list_to_str(attr_count, attr_list, host_interface_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
-    STUB_LOG_NTC("Create host interface, %s\n", list_str);
+    sai_attr_list_to_str(attr_count, attr_list, trap_group_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create trap group, %s\n", list_str);
 
-    assert(SAI_STATUS_SUCCESS ==
-           find_attrib_in_list(attr_count, attr_list, SAI_HOSTIF_ATTR_TYPE, &type, &type_index));
-    assert(SAI_STATUS_SUCCESS ==
-           find_attrib_in_list(attr_count, attr_list, SAI_HOSTIF_ATTR_NAME, &name, &name_index));
+    if (SAI_STATUS_SUCCESS != (status = db_find_free_trap_group_index(&db_id))) {
+        return status;
+    }
 
-    if (SAI_HOSTIF_TYPE_NETDEV == type->s32) {
-        if (SAI_STATUS_SUCCESS !=
-            (status =
-                 find_attrib_in_list(attr_count, attr_list, SAI_HOSTIF_ATTR_RIF_OR_PORT_ID, &rif_port,
-                                     &rif_port_index))) {
-            STUB_LOG_ERR("Missing mandatory attribute rif port id on create of host if netdev type\n");
-            return SAI_STATUS_MANDATORY_ATTRIBUTE_MISSING;
+    group = &trap_group_db[db_id];
+    memset(group, 0, sizeof(*group));
+    group->admin_state = true;
+
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_HOSTIF_TRAP_GROUP_ATTR_ADMIN_STATE, &admin_state,
+                            &admin_state_index)) {
+        group->admin_state = admin_state->booldata;
+    }
+
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_HOSTIF_TRAP_GROUP_ATTR_QUEUE, &queue, &queue_index)) {
+        if (queue->u32 >= TRAP_CPU_QUEUES) {
+            STUB_LOG_ERR("Invalid CPU queue %u\n", queue->u32);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + queue_index;
         }
+        group->queue = queue->u32;
+    }
 
-        if (SAI_OBJECT_TYPE_ROUTER_INTERFACE == sai_object_type_query(rif_port->oid)) {
-            if (SAI_STATUS_SUCCESS !=
-                (status = stub_object_to_type(rif_port->oid, SAI_OBJECT_TYPE_ROUTER_INTERFACE, &rif_data))) {
-                return status;
-            }
-        } else if (SAI_OBJECT_TYPE_PORT == sai_object_type_query(rif_port->oid)) {
-            if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(rif_port->oid, SAI_OBJECT_TYPE_PORT, &rif_data))) {
-                return status;
-            }
-        } else {
-            STUB_LOG_ERR("Invalid rif port object type %s", SAI_TYPE_STR(sai_object_type_query(rif_port->oid)));
-            return SAI_STATUS_INVALID_ATTR_VALUE_0 + rif_port_index;
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_HOSTIF_TRAP_GROUP_ATTR_POLICER, &policer, &policer_index)) {
+        if ((SAI_NULL_OBJECT_ID != policer->oid) &&
+            ((SAI_STATUS_SUCCESS != stub_object_to_type(policer->oid, SAI_OBJECT_TYPE_POLICER, &group->policer_db_id)) ||
+             (SAI_STATUS_SUCCESS != db_policer_ref(group->policer_db_id, true)))) {
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + policer_index;
         }
-        snprintf(system_cmd, sizeof(system_cmd), "ip link add name %s type dummy", name->chardata);
-        ret = system(system_cmd);
-        if (0 != ret) {
-            STUB_LOG_INF("Error on attempt to create dummy interface. Possibly interface already exists");
-            return SAI_STATUS_SUCCESS;
+        group->policer = policer->oid;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_create_object(SAI_OBJECT_TYPE_HOSTIF_TRAP_GROUP, db_id, hostif_trap_group_id))) {
+        if (SAI_NULL_OBJECT_ID != group->policer) {
+            db_policer_ref(group->policer_db_id, false);
         }
+        return status;
+    }
 
-    } else if (SAI_HOSTIF_TYPE_FD == type->s32) {
-    } else {
-        STUB_LOG_ERR("Invalid host interface type %d\n", type->s32);
-        return SAI_STATUS_INVALID_ATTR_VALUE_0 + type_index;
+    group->is_valid = true;
+
+    trap_group_key_to_str(*hostif_trap_group_id, key_str);
+    STUB_LOG_NTC("Created %s\n", key_str);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Remove host interface trap group
+ *
+ * Arguments:
+ *    [in] hostif_trap_group_id - trap group id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_host_interface_trap_group(_In_ sai_object_id_t hostif_trap_group_id)
+{
+    char         key_str[MAX_KEY_STR_LEN];
+    uint32_t     db_id, ii;
+    sai_status_t status;
+
+    STUB_LOG_ENTER();
+
+    trap_group_key_to_str(hostif_trap_group_id, key_str);
+    STUB_LOG_NTC("Remove %s\n", key_str);
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_trap_group(hostif_trap_group_id, &db_id))) {
+        return status;
+    }
+
+    if ((DEFAULT_TRAP_GROUP == db_id) || (trap_default_group == db_id)) {
+        STUB_LOG_ERR("Trap group %u is the switch default trap group\n", db_id);
+        return SAI_STATUS_OBJECT_IN_USE;
+    }
+
+    for (ii = 0; ii < TRAP_NUMBER; ii++) {
+        if (trap_db[ii].group_set && (db_id == trap_db[ii].group)) {
+            STUB_LOG_ERR("Trap group %u is used by trap index %u\n", db_id, ii);
+            return SAI_STATUS_OBJECT_IN_USE;
+        }
     }
 
-    if (SAI_STATUS_SUCCESS != (status = stub_create_object(SAI_OBJECT_TYPE_HOST_INTERFACE, next_id++, hif_id))) {
-        return status;
-    }
-    host_interface_key_to_str(*hif_id, key_str);
-    STUB_LOG_NTC("Created host interface %s\n", key_str);
+    if (SAI_NULL_OBJECT_ID != trap_group_db[db_id].policer) {
+        db_policer_ref(trap_group_db[db_id].policer_db_id, false);
+    }
+
+    trap_group_db[db_id].is_valid = false;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Set host interface trap group attribute
+ *
+ * Arguments:
+ *    [in] hostif_trap_group_id - trap group id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_host_interface_trap_group_attribute(_In_ sai_object_id_t        hostif_trap_group_id,
+                                                          _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = hostif_trap_group_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
 
-    STUB_LOG_EXIT();
-    return SAI_STATUS_SUCCESS;
+    trap_group_key_to_str(hostif_trap_group_id, key_str);
+    return sai_set_attribute(&key, key_str, trap_group_attribs, trap_group_vendor_attribs, attr);
 }
 
 /*
  * Routine Description:
- *    Remove host interface
+ *    Get host interface trap group attributes
  *
  * Arguments:
- *    [in] hif_id - host interface id
+ *    [in] hostif_trap_group_id - trap group id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
  *
  * Return Values:
  *    SAI_STATUS_SUCCESS on success
  *    Failure status code on error
  */
-sai_status_t stub_remove_host_interface(_In_ sai_object_id_t hif_id)
+sai_status_t stub_get_host_interface_trap_group_attribute(_In_ sai_object_id_t     hostif_trap_group_id,
+                                                          _In_ uint32_t            attr_count,
+                                                          _Inout_ sai_attribute_t *attr_list)
 {
-    char         key_str[MAX_KEY_STR_LEN];
-    uint32_t     hif_data;
-    sai_status_t status;
+    const sai_object_key_t key = { .object_id = hostif_trap_group_id };
+    char                   key_str[MAX_KEY_STR_LEN];
 
     STUB_LOG_ENTER();
 
-    host_interface_key_to_str(hif_id, key_str);
-    STUB_LOG_NTC("Remove host interface %s\n", key_str);
+    trap_group_key_to_str(hostif_trap_group_id, key_str);
+    return sai_get_attributes(&key, key_str, trap_group_attribs, trap_group_vendor_attribs, attr_count, attr_list);
+}
 
-    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(hif_id, SAI_OBJECT_TYPE_HOST_INTERFACE, &hif_data))) {
+/* Admin state [bool], CPU queue [uint32_t], policer [sai_object_id_t] */
+sai_status_t stub_trap_group_attr_get(_In_ const sai_object_key_t   *key,
+                                      _Inout_ sai_attribute_value_t *value,
+                                      _In_ uint32_t                  attr_index,
+                                      _Inout_ vendor_cache_t        *cache,
+                                      void                          *arg)
+{
+    const stub_trap_group_t *group;
+    sai_status_t             status;
+    uint32_t                 db_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_trap_group(key->object_id, &db_id))) {
+        return status;
+    }
+
+    group = &trap_group_db[db_id];
+
+    switch ((int64_t)arg) {
+    case SAI_HOSTIF_TRAP_GROUP_ATTR_ADMIN_STATE:
+        value->booldata = group->admin_state;
+        break;
+
+    case SAI_HOSTIF_TRAP_GROUP_ATTR_QUEUE:
+        value->u32 = group->queue;
+        break;
+
+    case SAI_HOSTIF_TRAP_GROUP_ATTR_POLICER:
+        value->oid = group->policer;
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid trap group attribute %d\n", (int)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Admin state [bool], CPU queue [uint32_t], policer [sai_object_id_t] */
+sai_status_t stub_trap_group_attr_set(_In_ const sai_object_key_t      *key,
+                                      _In_ const sai_attribute_value_t *value,
+                                      void                             *arg)
+{
+    stub_trap_group_t *group;
+    sai_status_t       status;
+    uint32_t           db_id, policer_db_id = 0;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_trap_group(key->object_id, &db_id))) {
         return status;
     }
 
+    group = &trap_group_db[db_id];
+
+    switch ((int64_t)arg) {
+    case SAI_HOSTIF_TRAP_GROUP_ATTR_ADMIN_STATE:
+        __atomic_store_n(&group->admin_state, value->booldata, __ATOMIC_RELAXED);
+        break;
+
+    case SAI_HOSTIF_TRAP_GROUP_ATTR_QUEUE:
+        if (value->u32 >= TRAP_CPU_QUEUES) {
+            STUB_LOG_ERR("Invalid CPU queue %u\n", value->u32);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        __atomic_store_n(&group->queue, value->u32, __ATOMIC_RELAXED);
+        break;
+
+    case SAI_HOSTIF_TRAP_GROUP_ATTR_POLICER:
+        if ((SAI_NULL_OBJECT_ID != value->oid) &&
+            ((SAI_STATUS_SUCCESS != (status = stub_object_to_type(value->oid, SAI_OBJECT_TYPE_POLICER,
+                                                                  &policer_db_id))) ||
+             (SAI_STATUS_SUCCESS != (status = db_policer_ref(policer_db_id, true))))) {
+            return status;
+        }
+        if (SAI_NULL_OBJECT_ID != group->policer) {
+            db_policer_ref(group->policer_db_id, false);
+        }
+        __atomic_store_n(&group->policer_db_id, policer_db_id, __ATOMIC_RELEASE);
+        __atomic_store_n(&group->policer, value->oid, __ATOMIC_RELEASE);
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid trap group attribute %d\n", (int)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
 }
 
 /*
  * Routine Description:
- *    Set host interface attribute
+ *    Set trap attribute
  *
  * Arguments:
- *    [in] hif_id - host interface id
+ *    [in] hostif_trapid - trap id
  *    [in] attr - attribute
  *
  * Return Values:
  *    SAI_STATUS_SUCCESS on success
  *    Failure status code on error
  */
-sai_status_t stub_set_host_interface_attribute(_In_ sai_object_id_t hif_id, _In_ const sai_attribute_t *attr)
+sai_status_t stub_set_host_interface_trap_attribute(_In_ sai_hostif_trap_id_t  hostif_trapid,
+                                                    _In_ const sai_attribute_t *attr)
 {
-    const sai_object_key_t key = { .object_id = hif_id };
+    const sai_object_key_t key = { .object_id = hostif_trapid };
     char                   key_str[MAX_KEY_STR_LEN];
 
     STUB_LOG_ENTER();
 
-    host_interface_key_to_str(hif_id, key_str);
-    return sai_set_attribute(&key, key_str, host_interface_attribs, host_interface_vendor_attribs, attr);
+    trap_key_to_str(hostif_trapid, key_str);
+    return sai_set_attribute(&key, key_str, trap_attribs, trap_vendor_attribs, attr);
 }
 
 /*
  * Routine Description:
- *    Get host interface attribute
+ *    Get trap attributes
  *
  * Arguments:
- *    [in] hif_id - host interface id
+ *    [in] hostif_trapid - trap id
  *    [in] attr_count - number of attributes
  *    [inout] attr_list - array of attributes
  *
@@ -243,127 +1860,429 @@ sai_status_t stub_set_host_interface_attribute(_In_ sai_object_id_t hif_id, _In_
  *    SAI_STATUS_SUCCESS on success
  *    Failure status code on error
  */
-sai_status_t stub_get_host_interface_attribute(_In_ sai_object_id_t     hif_id,
-                                               _In_ uint32_t            attr_count,
-                                               _Inout_ sai_attribute_t *attr_list)
+sai_status_t stub_get_host_interface_trap_attribute(_In_ sai_hostif_trap_id_t hostif_trapid,
+                                                    _In_ uint32_t             attr_count,
+                                                    _Inout_ sai_attribute_t  *attr_list)
 {
-    const sai_object_key_t key = { .object_id = hif_id };
+    const sai_object_key_t key = { .object_id = hostif_trapid };
     char                   key_str[MAX_KEY_STR_LEN];
 
     STUB_LOG_ENTER();
 
-    host_interface_key_to_str(hif_id, key_str);
-    return sai_get_attributes(&key,
-                              key_str,
-                              host_interface_attribs,
-                              host_interface_vendor_attribs,
-                              attr_count,
-                              attr_list);
+    trap_key_to_str(hostif_trapid, key_str);
+    return sai_get_attributes(&key, key_str, trap_attribs, trap_vendor_attribs, attr_count, attr_list);
 }
 
-/* Type [sai_host_interface_type_t] */
-sai_status_t stub_host_interface_type_get(_In_ const sai_object_key_t   *key,
-                                          _Inout_ sai_attribute_value_t *value,
-                                          _In_ uint32_t                  attr_index,
-                                          _Inout_ vendor_cache_t        *cache,
-                                          void                          *arg)
+/*
+ * Routine Description:
+ *   Get trap statistics counters.
+ *
+ * Arguments:
+ *    [in] hostif_trapid - trap id
+ *    [in] counter_ids - specifies the array of counter ids
+ *    [in] number_of_counters - number of counters in the array
+ *    [out] counters - array of resulting counter values.
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_host_interface_trap_stats(_In_ sai_hostif_trap_id_t          hostif_trapid,
+                                                _In_ const sai_hostif_trap_stat_t *counter_ids,
+                                                _In_ uint32_t                      number_of_counters,
+                                                _Out_ uint64_t                    *counters)
 {
+    stub_trap_stats_t stats;
+    sai_status_t      status;
+    uint32_t          ii;
+    char              key_str[MAX_KEY_STR_LEN];
+
     STUB_LOG_ENTER();
 
-    value->s32 = SAI_HOSTIF_TYPE_NETDEV;
+    trap_key_to_str(hostif_trapid, key_str);
+    STUB_LOG_NTC("Get trap stats %s\n", key_str);
+
+    if (NULL == counter_ids) {
+        STUB_LOG_ERR("NULL counter ids array param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (NULL == counters) {
+        STUB_LOG_ERR("NULL counters array param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_trap_stats_get(hostif_trapid, &stats))) {
+        return status;
+    }
+
+    for (ii = 0; ii < number_of_counters; ii++) {
+        switch (counter_ids[ii]) {
+        case SAI_HOSTIF_TRAP_STAT_PACKETS:
+            counters[ii] = stats.punted;
+            break;
+
+        case SAI_HOSTIF_TRAP_STAT_ADMIN_DROPPED_PACKETS:
+            counters[ii] = stats.admin_drops;
+            break;
+
+        case SAI_HOSTIF_TRAP_STAT_POLICER_DROPPED_PACKETS:
+            counters[ii] = stats.policer_drops;
+            break;
+
+        case SAI_HOSTIF_TRAP_STAT_QUEUE_DROPPED_PACKETS:
+            counters[ii] = stats.queue_drops;
+            break;
+
+        default:
+            STUB_LOG_ERR("Invalid trap counter %d\n", counter_ids[ii]);
+            return SAI_STATUS_INVALID_PARAMETER;
+        }
+    }
 
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
 }
 
-/* Assosiated port or router interface [sai_object_id_t] */
-sai_status_t stub_host_interface_rif_port_get(_In_ const sai_object_key_t   *key,
-                                              _Inout_ sai_attribute_value_t *value,
-                                              _In_ uint32_t                  attr_index,
-                                              _Inout_ vendor_cache_t        *cache,
-                                              void                          *arg)
+/* Action [sai_packet_action_t], priority [uint32_t], channel [sai_hostif_trap_channel_t],
+ * trap group [sai_object_id_t]. The key holds the trap ID */
+sai_status_t stub_trap_attr_get(_In_ const sai_object_key_t   *key,
+                                _Inout_ sai_attribute_value_t *value,
+                                _In_ uint32_t                  attr_index,
+                                _Inout_ vendor_cache_t        *cache,
+                                void                          *arg)
 {
-    sai_status_t status;
+    const stub_trap_t *trap;
+    sai_status_t       status;
+    uint32_t           index;
 
     STUB_LOG_ENTER();
 
-    if (SAI_STATUS_SUCCESS != (status = stub_create_object(SAI_OBJECT_TYPE_PORT, 1, &value->oid))) {
+    if (SAI_STATUS_SUCCESS != (status = db_get_trap((int32_t)key->object_id, &index))) {
         return status;
     }
 
+    trap = &trap_db[index];
+
+    switch ((int64_t)arg) {
+    case SAI_HOSTIF_TRAP_ATTR_PACKET_ACTION:
+        value->s32 = trap->action;
+        break;
+
+    case SAI_HOSTIF_TRAP_ATTR_TRAP_PRIORITY:
+        value->u32 = trap->priority;
+        break;
+
+    case SAI_HOSTIF_TRAP_ATTR_TRAP_CHANNEL:
+        value->s32 = trap->channel;
+        break;
+
+    case SAI_HOSTIF_TRAP_ATTR_TRAP_GROUP:
+        return stub_create_object(SAI_OBJECT_TYPE_HOSTIF_TRAP_GROUP, trap_group_of(trap), &value->oid);
+
+    default:
+        STUB_LOG_ERR("Invalid trap attribute %d\n", (int)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
 }
 
-/* Name [char[HOST_INTERFACE_NAME_SIZE]] (MANDATORY_ON_CREATE)
- * The maximum number of charactars for the name is HOST_INTERFACE_NAME_SIZE - 1 since
- * it needs the terminating null byte ('\0') at the end.  */
-sai_status_t stub_host_interface_name_get(_In_ const sai_object_key_t   *key,
-                                          _Inout_ sai_attribute_value_t *value,
-                                          _In_ uint32_t                  attr_index,
-                                          _Inout_ vendor_cache_t        *cache,
-                                          void                          *arg)
+/* Action [sai_packet_action_t], priority [uint32_t], channel [sai_hostif_trap_channel_t],
+ * trap group [sai_object_id_t]. The key holds the trap ID */
+sai_status_t stub_trap_attr_set(_In_ const sai_object_key_t      *key,
+                                _In_ const sai_attribute_value_t *value,
+                                void                             *arg)
 {
-    uint32_t     hif_id;
+    stub_trap_t *trap;
     sai_status_t status;
+    uint32_t     index, db_id;
 
     STUB_LOG_ENTER();
 
-    if (SAI_STATUS_SUCCESS !=
-        (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_HOST_INTERFACE, &hif_id))) {
+    if (SAI_STATUS_SUCCESS != (status = db_get_trap((int32_t)key->object_id, &index))) {
         return status;
     }
 
-    strncpy(value->chardata, "name", HOSTIF_NAME_SIZE);
+    trap = &trap_db[index];
+
+    switch ((int64_t)arg) {
+    case SAI_HOSTIF_TRAP_ATTR_PACKET_ACTION:
+        if ((value->s32 < SAI_PACKET_ACTION_DROP) || (value->s32 > SAI_PACKET_ACTION_TRANSIT)) {
+            STUB_LOG_ERR("Invalid trap action %d\n", value->s32);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        __atomic_store_n(&trap->action, value->s32, __ATOMIC_RELAXED);
+        break;
+
+    case SAI_HOSTIF_TRAP_ATTR_TRAP_PRIORITY:
+        trap->priority = value->u32;
+        break;
+
+    case SAI_HOSTIF_TRAP_ATTR_TRAP_CHANNEL:
+        if ((value->s32 < SAI_HOSTIF_TRAP_CHANNEL_FD) || (value->s32 > SAI_HOSTIF_TRAP_CHANNEL_NETDEV)) {
+            STUB_LOG_ERR("Invalid trap channel %d\n", value->s32);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        trap->channel = value->s32;
+        break;
+
+    case SAI_HOSTIF_TRAP_ATTR_TRAP_GROUP:
+        if (SAI_STATUS_SUCCESS != (status = db_get_trap_group(value->oid, &db_id))) {
+            return status;
+        }
+        __atomic_store_n(&trap->group, db_id, __ATOMIC_RELAXED);
+        __atomic_store_n(&trap->group_set, true, __ATOMIC_RELEASE);
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid trap attribute %d\n", (int)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
 
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
 }
 
-/* Name [char[HOST_INTERFACE_NAME_SIZE]]
- * The maximum number of charactars for the name is HOST_INTERFACE_NAME_SIZE - 1 since
- * it needs the terminating null byte ('\0') at the end.  */
-sai_status_t stub_host_interface_name_set(_In_ const sai_object_key_t      *key,
-                                          _In_ const sai_attribute_value_t *value,
-                                          void                             *arg)
+/*
+ * Routine Description:
+ *    Receive packet trapped to the host. Samplepacket samples come first, oldest first, then
+ *    packets of the CPU queues unless the packet event notification takes them, then
+ *    frames received on the host interface.
+ *
+ * Arguments:
+ *    [in] hif_id - host interface id
+ *    [out] buffer - packet buffer, gets the sampled header bytes or the frame
+ *    [inout] buffer_size - buffer size, set to the number of bytes copied or required
+ *    [inout] attr_count - number of attributes, set to the number returned or required
+ *    [out] attr_list - trap type and ingress/egress port attributes, none for frames
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    SAI_STATUS_ITEM_NOT_FOUND if no packet is pending
+ *    SAI_STATUS_BUFFER_OVERFLOW if buffer or attr_list is too small, the packet is kept
+ *    Failure status code on error
+ */
+sai_status_t stub_recv_host_interface_packet(_In_ sai_object_id_t    hif_id,
+                                             _Out_ void             *buffer,
+                                             _Inout_ sai_size_t     *buffer_size,
+                                             _Inout_ uint32_t       *attr_count,
+                                             _Out_ sai_attribute_t  *attr_list)
 {
-    uint32_t     hif_id;
-    sai_status_t status;
+    const stub_sample_t   *sample;
+    stub_host_interface_t *hif;
+    sai_status_t           status;
 
     STUB_LOG_ENTER();
 
-    if (SAI_STATUS_SUCCESS !=
-        (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_HOST_INTERFACE, &hif_id))) {
+    if ((NULL == buffer_size) || (NULL == attr_count)) {
+        STUB_LOG_ERR("NULL buffer size or attribute count param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_host_interface(hif_id, &hif))) {
         return status;
     }
 
+    if (!db_samplepacket_peek(&sample)) {
+        if ((0 != *buffer_size) && (NULL == buffer)) {
+            STUB_LOG_ERR("NULL buffer param\n");
+            return SAI_STATUS_INVALID_PARAMETER;
+        }
+
+        if ((NULL == g_notification_callbacks.on_packet_event) &&
+            (SAI_STATUS_ITEM_NOT_FOUND != (status = trap_packet_recv(buffer, buffer_size, attr_count, attr_list)))) {
+            return status;
+        }
+
+        if (SAI_STATUS_SUCCESS != (status = host_interface_frame_recv(hif, buffer, buffer_size))) {
+            return status;
+        }
+
+        *attr_count = 0;
+
+        STUB_LOG_EXIT();
+        return SAI_STATUS_SUCCESS;
+    }
+
+    if ((*buffer_size < sample->header_length) || (*attr_count < 2)) {
+        *buffer_size = sample->header_length;
+        *attr_count  = 2;
+        return SAI_STATUS_BUFFER_OVERFLOW;
+    }
+
+    if (((sample->header_length > 0) && (NULL == buffer)) || (NULL == attr_list)) {
+        STUB_LOG_ERR("NULL buffer or attribute list param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    attr_list[0].id        = SAI_HOSTIF_PACKET_ATTR_HOSTIF_TRAP_TYPE;
+    attr_list[0].value.s32 = SAI_HOSTIF_TRAP_TYPE_SAMPLEPACKET;
+    attr_list[1].id        = sample->ingress ? SAI_HOSTIF_PACKET_ATTR_INGRESS_PORT :
+                             SAI_HOSTIF_PACKET_ATTR_EGRESS_PORT_OR_LAG;
+    if (SAI_STATUS_SUCCESS != (status = stub_create_object(SAI_OBJECT_TYPE_PORT, sample->port_id,
+                                                           &attr_list[1].value.oid))) {
+        return status;
+    }
+
+    memcpy(buffer, sample->header, sample->header_length);
+    *buffer_size = sample->header_length;
+    *attr_count  = 2;
+
+    db_samplepacket_pop();
+
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
 }
 
-sai_status_t stub_set_host_interface_trap_attribute(_In_ sai_hostif_trap_id_t  hostif_trapid,
-                                                    _In_ const sai_attribute_t *attr)
+/*
+ * Routine Description:
+ *    Send packet on host interface. Netdev host interfaces deliver it to the host stack,
+ *    FD host interfaces send it out of the netdev they are bound to.
+ *
+ * Arguments:
+ *    [in] hif_id - host interface id
+ *    [in] buffer - packet buffer
+ *    [in] buffer_size - packet size in bytes
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    SAI_STATUS_INSUFFICIENT_RESOURCES if no TX ring frame or TAP room is free
+ *    Failure status code on error
+ */
+sai_status_t stub_send_host_interface_packet(_In_ sai_object_id_t  hif_id,
+                                             _In_ void            *buffer,
+                                             _In_ sai_size_t       buffer_size,
+                                             _In_ uint32_t         attr_count,
+                                             _In_ sai_attribute_t *attr_list)
 {
+    const sai_hostif_packet_t packet = { .buffer = buffer, .buffer_size = buffer_size };
+    stub_host_interface_t    *hif;
+    sai_status_t              status;
+    uint32_t                  sent;
+
     STUB_LOG_ENTER();
-    STUB_LOG_EXIT();
 
+    if (NULL == buffer) {
+        STUB_LOG_ERR("NULL buffer param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_host_interface(hif_id, &hif))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = host_interface_frames_send(hif, 1, &packet, &sent))) {
+        return status;
+    }
+
+    if (0 == sent) {
+        return SAI_STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
 }
 
+/*
+ * Routine Description:
+ *    Receive frames of host interface into the caller buffers, up to count, without
+ *    waiting. Samplepacket samples are left to stub_recv_host_interface_packet.
+ *
+ * Arguments:
+ *    [in] hif_id - host interface id
+ *    [inout] count - number of packets, set to the number received
+ *    [inout] packets - buffers and their size, size set to the frame length
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success, count may be 0
+ *    SAI_STATUS_BUFFER_OVERFLOW if the first frame is larger than its buffer, size set
+ *    to the frame length and the frame kept
+ *    Failure status code on error
+ */
+sai_status_t stub_recv_host_interface_packets(_In_ sai_object_id_t         hif_id,
+                                              _Inout_ uint32_t            *count,
+                                              _Inout_ sai_hostif_packet_t *packets)
+{
+    stub_host_interface_t *hif;
+    sai_status_t           status = SAI_STATUS_SUCCESS;
+    uint32_t               ii;
+
+    if ((NULL == count) || (NULL == packets)) {
+        STUB_LOG_ERR("NULL count or packets param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_host_interface(hif_id, &hif))) {
+        return status;
+    }
+
+    for (ii = 0; ii < *count; ii++) {
+        if (SAI_STATUS_SUCCESS != (status = host_interface_frame_recv(hif, packets[ii].buffer, &packets[ii].buffer_size))) {
+            break;
+        }
+    }
+
+    *count = ii;
+
+    if ((SAI_STATUS_ITEM_NOT_FOUND == status) || ((SAI_STATUS_BUFFER_OVERFLOW == status) && (0 != ii))) {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    return status;
+}
+
+/*
+ * Routine Description:
+ *    Send packets on host interface, up to count, without waiting.
+ *
+ * Arguments:
+ *    [in] hif_id - host interface id
+ *    [inout] count - number of packets, set to the number sent
+ *    [in] packets - packet buffers and sizes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success, count is less than asked once the TX ring or TAP is full
+ *    Failure status code on error
+ */
+sai_status_t stub_send_host_interface_packets(_In_ sai_object_id_t            hif_id,
+                                              _Inout_ uint32_t               *count,
+                                              _In_ const sai_hostif_packet_t *packets)
+{
+    stub_host_interface_t *hif;
+    sai_status_t           status;
+
+    if ((NULL == count) || (NULL == packets)) {
+        STUB_LOG_ERR("NULL count or packets param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_host_interface(hif_id, &hif))) {
+        return status;
+    }
+
+    return host_interface_frames_send(hif, *count, packets, count);
+}
 
 const sai_hostif_api_t host_interface_api = {
     stub_create_host_interface,
     stub_remove_host_interface,
     stub_set_host_interface_attribute,
     stub_get_host_interface_attribute,
-    NULL,
-    NULL,
-    NULL,
-    NULL,
+    stub_create_host_interface_trap_group,
+    stub_remove_host_interface_trap_group,
+    stub_set_host_interface_trap_group_attribute,
+    stub_get_host_interface_trap_group_attribute,
     stub_set_host_interface_trap_attribute,
+    stub_get_host_interface_trap_attribute,
     NULL,
     NULL,
-    NULL,
-    NULL,
-    NULL
+    stub_recv_host_interface_packet,
+    stub_send_host_interface_packet,
+    stub_recv_host_interface_packets,
+    stub_send_host_interface_packets,
+    stub_get_host_interface_trap_stats
 };
@@ -0,0 +1,709 @@
+/*
+ *  Copyright (C) 2014. Mellanox Technologies, Ltd. ALL RIGHTS RESERVED.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ */
+
+#include "sai.h"
+#include "stub_sai.h"
+#include "assert.h"
+
+#undef  __MODULE__
+#define __MODULE__ SAI_SCHEDULER
+
+/*
+ * Hierarchical egress scheduler of the ports.
+ * Each port has a tree built from its scheduler groups and queues, the port
+ * being the root. Every node keeps bitmaps of its children : which have
+ * traffic and are allowed by their max shaper, which are below their min
+ * rate, and which are strict priority. Children are ordered by descending
+ * priority, so each level decides in O(1) with a find first set : children
+ * below their min rate first in round robin, then strict priority, then
+ * DWRR / WRR with deficits charged after transmission.
+ * Shapers are token buckets refilled lazily. A node out of tokens has a
+ * timer on a hashed timing wheel of its port, and is made eligible again
+ * when the timer expires.
+ * The tree is rebuilt on the next use after any scheduling configuration
+ * change.
+ */
+
+/* State DB *************/
+#define HQOS_NONE              0xFF
+#define HQOS_ROOT              0
+#define HQOS_NO_QUEUE          0xFFFFFFFF
+#define HQOS_MAX_NODES         128
+#define HQOS_MAX_DEPTH         (SCHEDULER_GROUP_MAX_LEVELS + 2)
+#define HQOS_MAX_PORT_GROUPS   (HQOS_MAX_NODES - 1)
+#define HQOS_MAX_PORT_QUEUES   (2 * QUEUE_MAX_INDEX)
+/* DWRR credit per weight unit */
+#define HQOS_QUANTUM_BYTES     1024
+#define HQOS_WHEEL_SLOTS       4096
+#define HQOS_TICK_SHIFT        8
+/* Shaper tokens are kept in bytes or packets times NS_PER_SEC, so a refill is rate times elapsed ns */
+#define HQOS_NS_PER_SEC        1000000000LL
+#define HQOS_MIN_BURST_BYTES   10000
+#define HQOS_MIN_BURST_PACKETS 10
+#define HQOS_MAX_BURST         1000000000ULL
+#define HQOS_BIT(slot)         (1ULL << (slot))
+
+typedef enum _stub_hqos_phase_t {
+    HQOS_PHASE_MIN,
+    HQOS_PHASE_STRICT,
+    HQOS_PHASE_DRR
+} stub_hqos_phase_t;
+
+typedef struct _stub_hqos_bucket_t {
+    bool     enabled;
+    bool     packets;
+    uint64_t rate;
+    int64_t  burst;
+    int64_t  tokens;
+    uint64_t last_ns;
+} stub_hqos_bucket_t;
+
+typedef struct _stub_hqos_node_t {
+    /* Children with traffic allowed by their max shaper */
+    uint64_t           active;
+    /* Children below their min rate */
+    uint64_t           entitled;
+    uint64_t           strict;
+    int64_t            deficit;
+    int64_t            quantum;
+    /* Queue of a leaf, HQOS_NO_QUEUE for the port and the groups */
+    uint32_t           queue_id;
+    uint8_t            parent;
+    uint8_t            slot;
+    uint8_t            min_cursor;
+    uint8_t            drr_cursor;
+    bool               is_strict;
+    bool               packet_charged;
+    bool               backlogged;
+    bool               eligible;
+    bool               below_min;
+    bool               shaped;
+    bool               timer_pending;
+    uint8_t            timer_next;
+    uint8_t            priority;
+    uint8_t            child_count;
+    uint8_t            children[SCHEDULER_GROUP_MAX_CHILDS];
+    uint32_t           group_id;
+    uint64_t           timer_tick;
+    stub_hqos_bucket_t min;
+    stub_hqos_bucket_t max;
+} stub_hqos_node_t;
+
+typedef struct _stub_hqos_port_t {
+    uint32_t         generation;
+    uint32_t         node_count;
+    stub_hqos_node_t nodes[HQOS_MAX_NODES];
+    uint8_t          wheel[HQOS_WHEEL_SLOTS];
+    uint64_t         tick;
+    uint32_t         timer_count;
+} stub_hqos_port_t;
+
+static stub_hqos_port_t hqos_ports[PORT_NUMBER];
+static uint8_t          hqos_queue_nodes[MAX_QUEUE_NUMBER];
+static uint32_t         hqos_generation = 1;
+
+/* Scheduling configuration changed, rebuild the trees on their next use */
+void db_hqos_invalidate()
+{
+    hqos_generation++;
+}
+
+static void hqos_bucket_init(_Out_ stub_hqos_bucket_t *bucket,
+                             _In_ uint64_t             rate,
+                             _In_ uint64_t             burst,
+                             _In_ bool                 packets,
+                             _In_ uint64_t             now_ns)
+{
+    uint64_t min_burst = packets ? HQOS_MIN_BURST_PACKETS : HQOS_MIN_BURST_BYTES;
+
+    memset(bucket, 0, sizeof(*bucket));
+    if (0 == rate) {
+        return;
+    }
+
+    if (burst < min_burst) {
+        burst = min_burst;
+    }
+    if (burst > HQOS_MAX_BURST) {
+        burst = HQOS_MAX_BURST;
+    }
+
+    bucket->enabled = true;
+    bucket->packets = packets;
+    bucket->rate    = rate;
+    bucket->burst   = (int64_t)burst * HQOS_NS_PER_SEC;
+    bucket->tokens  = bucket->burst;
+    bucket->last_ns = now_ns;
+}
+
+static void hqos_bucket_refill(_Inout_ stub_hqos_bucket_t *bucket, _In_ uint64_t now_ns)
+{
+    uint64_t elapsed, room;
+
+    if ((!bucket->enabled) || (now_ns <= bucket->last_ns)) {
+        return;
+    }
+
+    elapsed         = now_ns - bucket->last_ns;
+    bucket->last_ns = now_ns;
+    if (bucket->tokens >= bucket->burst) {
+        return;
+    }
+
+    /* Compare before multiplying, so that long idle times don't overflow */
+    room = bucket->burst - bucket->tokens;
+    if (elapsed >= room / bucket->rate + 1) {
+        bucket->tokens = bucket->burst;
+    } else {
+        bucket->tokens += bucket->rate * elapsed;
+        if (bucket->tokens > bucket->burst) {
+            bucket->tokens = bucket->burst;
+        }
+    }
+}
+
+static void hqos_bucket_charge(_Inout_ stub_hqos_bucket_t *bucket, _In_ uint32_t length)
+{
+    if (bucket->enabled) {
+        bucket->tokens -= (bucket->packets ? 1 : (int64_t)length) * HQOS_NS_PER_SEC;
+    }
+}
+
+static bool hqos_bucket_conforms(_In_ const stub_hqos_bucket_t *bucket)
+{
+    return (!bucket->enabled) || (bucket->tokens > 0);
+}
+
+/* Time when the bucket has tokens again */
+static uint64_t hqos_bucket_ready_ns(_In_ const stub_hqos_bucket_t *bucket)
+{
+    uint64_t missing = (uint64_t)(1 - bucket->tokens);
+
+    return bucket->last_ns + (missing + bucket->rate - 1) / bucket->rate;
+}
+
+/* Next set bit of a mask from a slot, wrapping around */
+static uint8_t hqos_next_slot(_In_ uint64_t mask, _In_ uint32_t from)
+{
+    uint64_t after = (from < 64) ? (mask & (~0ULL << from)) : 0;
+
+    return (uint8_t)__builtin_ctzll(after ? after : mask);
+}
+
+static void hqos_timer_add(_Inout_ stub_hqos_port_t *port, _In_ uint8_t node_index, _In_ uint64_t expiry_ns)
+{
+    stub_hqos_node_t *node = &port->nodes[node_index];
+    uint64_t          tick = (expiry_ns >> HQOS_TICK_SHIFT) + 1;
+    uint32_t          slot;
+    uint8_t          *link;
+
+    if (tick <= port->tick) {
+        tick = port->tick + 1;
+    }
+
+    if (node->timer_pending) {
+        /* The pending timer fires no later, and the node is evaluated again then */
+        if (node->timer_tick <= tick) {
+            return;
+        }
+        for (link = &port->wheel[node->timer_tick & (HQOS_WHEEL_SLOTS - 1)]; *link != node_index;
+             link = &port->nodes[*link].timer_next) {
+            assert(HQOS_NONE != *link);
+        }
+        *link = node->timer_next;
+    } else {
+        port->timer_count++;
+    }
+
+    slot                = tick & (HQOS_WHEEL_SLOTS - 1);
+    node->timer_pending = true;
+    node->timer_tick    = tick;
+    node->timer_next    = port->wheel[slot];
+    port->wheel[slot]   = node_index;
+}
+
+static void hqos_node_update(_Inout_ stub_hqos_port_t *port,
+                             _In_ uint8_t              node_index,
+                             _In_ uint64_t             now_ns,
+                             _In_ bool                 to_root);
+
+/* Fire the timers of one wheel slot due at a tick, keeping the ones of later rounds */
+static void hqos_wheel_slot_expire(_Inout_ stub_hqos_port_t *port,
+                                   _In_ uint32_t             slot,
+                                   _In_ uint64_t             tick,
+                                   _In_ uint64_t             now_ns)
+{
+    uint8_t  index = port->wheel[slot], next, expired = HQOS_NONE;
+    uint8_t *link  = &port->wheel[slot];
+
+    while (HQOS_NONE != index) {
+        next = port->nodes[index].timer_next;
+        if (port->nodes[index].timer_tick <= tick) {
+            *link                         = next;
+            port->nodes[index].timer_next = expired;
+            expired                       = index;
+        } else {
+            link = &port->nodes[index].timer_next;
+        }
+        index = next;
+    }
+
+    for (index = expired; HQOS_NONE != index; index = next) {
+        next                             = port->nodes[index].timer_next;
+        port->nodes[index].timer_pending = false;
+        port->timer_count--;
+        hqos_node_update(port, index, now_ns, false);
+    }
+}
+
+static void hqos_wheel_advance(_Inout_ stub_hqos_port_t *port, _In_ uint64_t now_ns)
+{
+    uint64_t target = now_ns >> HQOS_TICK_SHIFT;
+    uint32_t ii;
+
+    if (target <= port->tick) {
+        return;
+    }
+
+    /* Past a whole turn, every slot is due once at the target time */
+    if ((target - port->tick >= HQOS_WHEEL_SLOTS) && (0 != port->timer_count)) {
+        port->tick = target;
+        for (ii = 0; ii < HQOS_WHEEL_SLOTS; ii++) {
+            hqos_wheel_slot_expire(port, ii, target, now_ns);
+        }
+        return;
+    }
+
+    while ((port->tick < target) && (0 != port->timer_count)) {
+        port->tick++;
+        hqos_wheel_slot_expire(port, port->tick & (HQOS_WHEEL_SLOTS - 1), port->tick, now_ns);
+    }
+
+    port->tick = target;
+}
+
+/*
+ * Evaluate a node after its traffic or its tokens changed, and report it to
+ * its parent : active when it has traffic allowed by its max shaper, and
+ * entitled when it is also below its min rate. A node held by a shaper gets
+ * a timer. The change propagates up as long as the parent activity changes,
+ * or up to the root after a transmission charged the whole path.
+ */
+static void hqos_node_update(_Inout_ stub_hqos_port_t *port,
+                             _In_ uint8_t              node_index,
+                             _In_ uint64_t             now_ns,
+                             _In_ bool                 to_root)
+{
+    stub_hqos_node_t *node, *parent;
+    bool              has_traffic, eligible, below_min;
+    uint64_t          ready_ns = 0;
+
+    while (HQOS_ROOT != node_index) {
+        node        = &port->nodes[node_index];
+        parent      = &port->nodes[node->parent];
+        has_traffic = (HQOS_NO_QUEUE != node->queue_id) ? node->backlogged : (0 != node->active);
+
+        eligible  = has_traffic;
+        below_min = false;
+
+        if (!has_traffic) {
+            node->deficit = 0;
+        } else if (node->shaped) {
+            hqos_bucket_refill(&node->min, now_ns);
+            hqos_bucket_refill(&node->max, now_ns);
+            eligible  = hqos_bucket_conforms(&node->max);
+            below_min = eligible && node->min.enabled && hqos_bucket_conforms(&node->min);
+
+            if (!hqos_bucket_conforms(&node->max)) {
+                ready_ns = hqos_bucket_ready_ns(&node->max);
+            }
+            if (node->min.enabled && (!hqos_bucket_conforms(&node->min)) &&
+                ((0 == ready_ns) || (hqos_bucket_ready_ns(&node->min) < ready_ns))) {
+                ready_ns = hqos_bucket_ready_ns(&node->min);
+            }
+            if (0 != ready_ns) {
+                hqos_timer_add(port, node_index, ready_ns);
+            }
+        }
+
+        if (below_min != node->below_min) {
+            node->below_min  = below_min;
+            parent->entitled ^= HQOS_BIT(node->slot);
+        }
+
+        if (eligible != node->eligible) {
+            node->eligible  = eligible;
+            parent->active ^= HQOS_BIT(node->slot);
+
+            /* The parent activity changes only on its first child becoming active or its last one inactive */
+            if ((!to_root) && (eligible ? (parent->active != HQOS_BIT(node->slot)) : (0 != parent->active))) {
+                return;
+            }
+        } else if (!to_root) {
+            return;
+        }
+
+        node_index = node->parent;
+        ready_ns   = 0;
+    }
+}
+
+/* Choose the child of a node to serve, and in which phase */
+static uint8_t hqos_node_select(_Inout_ stub_hqos_node_t *node,
+                                _In_ stub_hqos_node_t    *nodes,
+                                _Out_ stub_hqos_phase_t  *phase)
+{
+    stub_hqos_node_t *child;
+    uint64_t          mask;
+    uint8_t           slot;
+
+    if (0 != (mask = node->active & node->entitled)) {
+        slot             = hqos_next_slot(mask, node->min_cursor);
+        node->min_cursor = slot + 1;
+        *phase           = HQOS_PHASE_MIN;
+        return slot;
+    }
+
+    if (0 != (mask = node->active & node->strict)) {
+        *phase = HQOS_PHASE_STRICT;
+        return (uint8_t)__builtin_ctzll(mask);
+    }
+
+    /* Serve the current child while it has credit, then top it up and move on */
+    mask   = node->active & ~node->strict;
+    *phase = HQOS_PHASE_DRR;
+    slot   = hqos_next_slot(mask, node->drr_cursor);
+    for (;;) {
+        child = &nodes[node->children[slot]];
+        if (child->deficit > 0) {
+            node->drr_cursor = slot;
+            return slot;
+        }
+        child->deficit += child->quantum;
+        slot            = hqos_next_slot(mask, slot + 1);
+    }
+}
+
+static void hqos_node_init(_Out_ stub_hqos_node_t *node,
+                           _In_ uint8_t            parent,
+                           _In_ sai_object_id_t    scheduler_profile,
+                           _In_ uint64_t           now_ns)
+{
+    stub_scheduler_params_t params;
+    uint32_t                scheduler_id;
+    bool                    packets;
+
+    memset(node, 0, sizeof(*node));
+    node->parent     = parent;
+    node->timer_next = HQOS_NONE;
+
+    db_scheduler_defaults(&params);
+    if ((SAI_NULL_OBJECT_ID != scheduler_profile) &&
+        ((SAI_STATUS_SUCCESS != stub_object_to_type(scheduler_profile, SAI_OBJECT_TYPE_SCHEDULER, &scheduler_id)) ||
+         (SAI_STATUS_SUCCESS != db_scheduler_get(scheduler_id, &params)))) {
+        STUB_LOG_ERR("Invalid scheduler profile, using defaults\n");
+        db_scheduler_defaults(&params);
+    }
+
+    /* WRR counts packets, DWRR counts bytes */
+    node->packet_charged = (SAI_SCHEDULING_TYPE_WRR == params.type);
+    node->quantum        = node->packet_charged ? params.weight : (int64_t)params.weight * HQOS_QUANTUM_BYTES;
+    node->is_strict      = (SAI_SCHEDULING_TYPE_STRICT == params.type);
+
+    packets = (SAI_METER_TYPE_PACKETS == params.meter_type);
+    hqos_bucket_init(&node->min, params.min_rate, params.min_burst, packets, now_ns);
+    hqos_bucket_init(&node->max, params.max_rate, params.max_burst, packets, now_ns);
+    node->shaped = node->min.enabled || node->max.enabled;
+}
+
+static uint8_t hqos_group_node_find(_In_ const stub_hqos_port_t *port, _In_ sai_object_id_t group)
+{
+    uint32_t group_id, ii;
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(group, SAI_OBJECT_TYPE_SCHEDULER_GROUP, &group_id)) {
+        return HQOS_NONE;
+    }
+
+    for (ii = 1; ii < port->node_count; ii++) {
+        if ((HQOS_NO_QUEUE == port->nodes[ii].queue_id) && (port->nodes[ii].group_id == group_id)) {
+            return (uint8_t)ii;
+        }
+    }
+
+    return HQOS_NONE;
+}
+
+static int hqos_child_compare(_In_ const stub_hqos_node_t *nodes, _In_ uint8_t first, _In_ uint8_t second)
+{
+    if (nodes[first].priority != nodes[second].priority) {
+        return (nodes[first].priority > nodes[second].priority) ? -1 : 1;
+    }
+
+    return (first < second) ? -1 : 1;
+}
+
+/* Build the tree of a port from its scheduler groups and queues */
+static sai_status_t hqos_port_build(_In_ uint32_t port_id, _In_ uint64_t now_ns)
+{
+    stub_hqos_port_t *port = &hqos_ports[port_id];
+    stub_hqos_node_t *node, *parent;
+    uint32_t          group_ids[HQOS_MAX_PORT_GROUPS], queue_ids[HQOS_MAX_PORT_QUEUES];
+    uint32_t          group_count = HQOS_MAX_PORT_GROUPS, queue_count = HQOS_MAX_PORT_QUEUES;
+    uint32_t          ii, jj, kk, packets;
+    sai_object_id_t   parent_id, scheduler_profile;
+    sai_status_t      status;
+    uint8_t           parent_index, index, queue_index;
+
+    if (SAI_STATUS_SUCCESS != (status = db_scheduler_group_port_groups_get(port_id, group_ids, &group_count))) {
+        STUB_LOG_ERR("Too many scheduler groups on port %u\n", port_id);
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_queue_port_queues_get(port_id, queue_ids, &queue_count))) {
+        return status;
+    }
+
+    if (1 + group_count + queue_count > HQOS_MAX_NODES) {
+        STUB_LOG_ERR("Too many scheduling nodes on port %u\n", port_id);
+        return SAI_STATUS_TABLE_FULL;
+    }
+
+    memset(port->wheel, HQOS_NONE, sizeof(port->wheel));
+    port->tick        = now_ns >> HQOS_TICK_SHIFT;
+    port->timer_count = 0;
+    port->node_count  = 1;
+    hqos_node_init(&port->nodes[HQOS_ROOT], HQOS_NONE, SAI_NULL_OBJECT_ID, now_ns);
+    port->nodes[HQOS_ROOT].queue_id = HQOS_NO_QUEUE;
+
+    for (ii = 0; ii < group_count; ii++) {
+        if (SAI_STATUS_SUCCESS !=
+            (status = db_scheduler_group_info_get(group_ids[ii], &parent_id, &scheduler_profile))) {
+            return status;
+        }
+        node = &port->nodes[port->node_count++];
+        hqos_node_init(node, HQOS_NONE, scheduler_profile, now_ns);
+        node->queue_id = HQOS_NO_QUEUE;
+        node->group_id = group_ids[ii];
+    }
+
+    /* Link the groups once they all have a node, the parent of level 0 groups is the port */
+    for (ii = 0; ii < group_count; ii++) {
+        db_scheduler_group_info_get(group_ids[ii], &parent_id, &scheduler_profile);
+        parent_index = (SAI_OBJECT_TYPE_PORT == sai_object_type_query(parent_id)) ?
+                       HQOS_ROOT : hqos_group_node_find(port, parent_id);
+        if (HQOS_NONE == parent_index) {
+            STUB_LOG_ERR("Scheduler group %u parent not found on port %u\n", group_ids[ii], port_id);
+            return SAI_STATUS_FAILURE;
+        }
+        port->nodes[1 + ii].parent = parent_index;
+    }
+
+    for (ii = 0; ii < queue_count; ii++) {
+        index = (uint8_t)port->node_count++;
+        node  = &port->nodes[index];
+        if (SAI_STATUS_SUCCESS !=
+            (status = db_queue_info_get(queue_ids[ii], &queue_index, &parent_id, &scheduler_profile))) {
+            return status;
+        }
+        /* Higher queue indexes have higher strict priority */
+        hqos_node_init(node, HQOS_ROOT, scheduler_profile, now_ns);
+        node->priority = queue_index;
+        node->queue_id = queue_ids[ii];
+        if (SAI_OBJECT_TYPE_SCHEDULER_GROUP == sai_object_type_query(parent_id)) {
+            if (HQOS_NONE == (node->parent = hqos_group_node_find(port, parent_id))) {
+                STUB_LOG_ERR("Queue %u parent not found on port %u\n", queue_ids[ii], port_id);
+                return SAI_STATUS_FAILURE;
+            }
+        }
+        hqos_queue_nodes[queue_ids[ii]] = index;
+
+        /* A group is as urgent as its most urgent queue */
+        for (parent_index = node->parent; HQOS_NONE != parent_index;
+             parent_index = port->nodes[parent_index].parent) {
+            if (port->nodes[parent_index].priority < node->priority) {
+                port->nodes[parent_index].priority = node->priority;
+            }
+        }
+    }
+
+    for (ii = 1; ii < port->node_count; ii++) {
+        parent = &port->nodes[port->nodes[ii].parent];
+        if (parent->child_count == SCHEDULER_GROUP_MAX_CHILDS) {
+            STUB_LOG_ERR("Too many scheduling children on port %u\n", port_id);
+            return SAI_STATUS_TABLE_FULL;
+        }
+        /* Insertion sort, by descending priority */
+        for (jj = parent->child_count;
+             (jj > 0) && (hqos_child_compare(port->nodes, (uint8_t)ii, parent->children[jj - 1]) < 0); jj--) {
+            parent->children[jj] = parent->children[jj - 1];
+        }
+        parent->children[jj] = (uint8_t)ii;
+        parent->child_count++;
+    }
+
+    /* Place the children in the bitmaps of their parents */
+    for (ii = 0; ii < port->node_count; ii++) {
+        parent = &port->nodes[ii];
+        for (kk = 0; kk < parent->child_count; kk++) {
+            node       = &port->nodes[parent->children[kk]];
+            node->slot = (uint8_t)kk;
+            if (node->is_strict) {
+                parent->strict |= HQOS_BIT(kk);
+            }
+        }
+    }
+
+    port->generation = hqos_generation;
+
+    for (ii = 1; ii < port->node_count; ii++) {
+        node = &port->nodes[ii];
+        if ((HQOS_NO_QUEUE != node->queue_id) &&
+            (SAI_STATUS_SUCCESS == db_queue_depth_get(node->queue_id, &packets)) && (0 != packets)) {
+            node->backlogged = true;
+            hqos_node_update(port, (uint8_t)ii, now_ns, false);
+        }
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t hqos_port_get(_In_ uint32_t port_id, _In_ uint64_t now_ns, _Out_ stub_hqos_port_t **port)
+{
+    sai_status_t status;
+
+    if (port_id >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid port %u\n", port_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *port = &hqos_ports[port_id];
+
+    if (((*port)->generation != hqos_generation) || ((now_ns >> HQOS_TICK_SHIFT) < (*port)->tick)) {
+        if (SAI_STATUS_SUCCESS != (status = hqos_port_build(port_id, now_ns))) {
+            (*port)->node_count = 0;
+            (*port)->generation = hqos_generation;
+            return status;
+        }
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* A queue of the port received traffic */
+sai_status_t db_hqos_queue_backlogged(_In_ uint32_t port_id, _In_ uint32_t queue_id, _In_ uint64_t now_ns)
+{
+    stub_hqos_port_t *port;
+    stub_hqos_node_t *node;
+    sai_status_t      status;
+
+    if (SAI_STATUS_SUCCESS != (status = hqos_port_get(port_id, now_ns, &port))) {
+        return status;
+    }
+
+    if ((queue_id >= MAX_QUEUE_NUMBER) || (hqos_queue_nodes[queue_id] >= port->node_count) ||
+        (port->nodes[hqos_queue_nodes[queue_id]].queue_id != queue_id)) {
+        STUB_LOG_ERR("Queue %u not found on port %u\n", queue_id, port_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    /* A tree just rebuilt already knows the queue backlog */
+    node = &port->nodes[hqos_queue_nodes[queue_id]];
+    if (!node->backlogged) {
+        node->backlogged = true;
+        hqos_node_update(port, hqos_queue_nodes[queue_id], now_ns, false);
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Take the next packet to transmit on a port.
+ * When nothing can be sent, the wakeup time is when a shaper lets traffic
+ * through again, or UINT64_MAX if the port has no traffic.
+ */
+sai_status_t db_hqos_dequeue(_In_ uint32_t        port_id,
+                             _In_ uint64_t        now_ns,
+                             _Out_ stub_packet_t *packet,
+                             _Out_ bool          *dequeued,
+                             _Out_ uint64_t      *wakeup_ns)
+{
+    stub_hqos_port_t *port;
+    stub_hqos_node_t *node;
+    stub_hqos_phase_t phases[HQOS_MAX_DEPTH];
+    uint8_t           path[HQOS_MAX_DEPTH];
+    uint32_t          depth = 0, ii, packets;
+    uint8_t           index = HQOS_ROOT;
+    sai_status_t      status;
+
+    *dequeued  = false;
+    *wakeup_ns = UINT64_MAX;
+
+    if (SAI_STATUS_SUCCESS != (status = hqos_port_get(port_id, now_ns, &port))) {
+        return status;
+    }
+
+    if (0 == port->node_count) {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    hqos_wheel_advance(port, now_ns);
+
+    if (0 == port->nodes[HQOS_ROOT].active) {
+        for (ii = 1; ii < port->node_count; ii++) {
+            if (port->nodes[ii].timer_pending &&
+                ((port->nodes[ii].timer_tick << HQOS_TICK_SHIFT) < *wakeup_ns)) {
+                *wakeup_ns = port->nodes[ii].timer_tick << HQOS_TICK_SHIFT;
+            }
+        }
+        return SAI_STATUS_SUCCESS;
+    }
+
+    while (HQOS_NO_QUEUE == port->nodes[index].queue_id) {
+        assert(depth < HQOS_MAX_DEPTH);
+        node          = &port->nodes[index];
+        index         = node->children[hqos_node_select(node, port->nodes, &phases[depth])];
+        path[depth++] = index;
+    }
+
+    node = &port->nodes[index];
+    if (SAI_STATUS_SUCCESS != (status = db_queue_dequeue(node->queue_id, packet, dequeued))) {
+        return status;
+    }
+    if (SAI_STATUS_SUCCESS != (status = db_queue_depth_get(node->queue_id, &packets))) {
+        return status;
+    }
+    node->backlogged = (0 != packets);
+
+    /* Charge the shapers of every node on the path, and the deficits where DRR chose */
+    for (ii = 0; (ii < depth) && (*dequeued); ii++) {
+        node = &port->nodes[path[ii]];
+        if (node->shaped) {
+            hqos_bucket_refill(&node->min, now_ns);
+            hqos_bucket_refill(&node->max, now_ns);
+            hqos_bucket_charge(&node->min, packet->length);
+            hqos_bucket_charge(&node->max, packet->length);
+        }
+        if (HQOS_PHASE_DRR == phases[ii]) {
+            node->deficit -= node->packet_charged ? 1 : packet->length;
+        }
+    }
+    hqos_node_update(port, index, now_ns, true);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*************************/
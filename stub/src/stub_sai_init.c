@@ -0,0 +1,189 @@
+/*
+ *  Copyright (C) 2014. Mellanox Technologies, Ltd. ALL RIGHTS RESERVED.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ */
+
+#include "sai.h"
+#include "stub_sai.h"
+#include "assert.h"
+#include "pthread.h"
+
+#undef  __MODULE__
+#define __MODULE__ SAI_INIT
+
+/*
+ * Switch initialize only sets up what the first API calls need, the ports,
+ * default VLAN, FDB and notifications, and returns. The other stages run on
+ * a pool of init workers, each worker taking the next stage not started.
+ *
+ * Stages whose tables are also built on first use, the queues and buffers,
+ * are run once, by a worker or by the first call needing them, whichever
+ * comes first, so nothing waits for the workers. Counters are read directly
+ * until the counter stage started the refresh thread.
+ *
+ * When the last stage is done, the switch oper status goes UP, or FAILED if
+ * a stage failed, and a switch state change notification is sent. The
+ * number of workers is the switch profile key SAI_INIT_WORKERS, 0 runs the
+ * stages on the initializing thread before switch initialize returns, which
+ * then fails with the status of the first stage failed. Switch connect runs
+ * the stages again, those already done by the switch initialize being no-ops.
+ */
+
+/* State DB *************/
+#define INIT_WORKERS_KEY     "SAI_INIT_WORKERS"
+#define INIT_DEFAULT_WORKERS 2
+#define INIT_MAX_WORKERS     8
+
+typedef struct _stub_init_stage_t {
+    const char *name;
+    sai_status_t (*run)();
+} stub_init_stage_t;
+
+static sai_status_t init_queue_stage()
+{
+    db_init_port_queues();
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t init_buffer_stage()
+{
+    db_init_buffer();
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static const stub_init_stage_t init_stages[] = {
+    { "queues", init_queue_stage },
+    { "buffers", init_buffer_stage },
+    { "counters", db_counter_start },
+};
+
+#define INIT_STAGE_COUNT (sizeof(init_stages) / sizeof(init_stages[0]))
+
+static pthread_t init_workers[INIT_MAX_WORKERS];
+static uint32_t  init_worker_count;
+/* Next stage to start, and stages not done yet */
+static uint32_t  init_next_stage;
+static uint32_t  init_pending;
+static bool      init_failed;
+/* Status of the first stage failed */
+static int32_t   init_status;
+static int32_t   init_oper_status = SAI_SWITCH_OPER_STATUS_UP;
+
+static void init_stage_run(_In_ uint32_t stage)
+{
+    sai_status_t status;
+    int32_t      oper_status;
+    bool         failed = false;
+
+    if (SAI_STATUS_SUCCESS != (status = init_stages[stage].run())) {
+        STUB_LOG_ERR("Switch init stage %s failed, status %d\n", init_stages[stage].name, status);
+        if (__atomic_compare_exchange_n(&init_failed, &failed, true, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            __atomic_store_n(&init_status, status, __ATOMIC_RELAXED);
+        }
+    } else {
+        STUB_LOG_DBG("Switch init stage %s done\n", init_stages[stage].name);
+    }
+
+    if (1 != __atomic_fetch_sub(&init_pending, 1, __ATOMIC_ACQ_REL)) {
+        return;
+    }
+
+    oper_status = __atomic_load_n(&init_failed, __ATOMIC_RELAXED) ?
+                  SAI_SWITCH_OPER_STATUS_FAILED : SAI_SWITCH_OPER_STATUS_UP;
+    __atomic_store_n(&init_oper_status, oper_status, __ATOMIC_RELEASE);
+
+    STUB_LOG_NTC("Switch init done, oper status %s\n", (SAI_SWITCH_OPER_STATUS_UP == oper_status) ? "up" : "failed");
+
+    db_notify_switch_state(oper_status);
+}
+
+static void init_stages_run()
+{
+    uint32_t stage;
+
+    while ((stage = __atomic_fetch_add(&init_next_stage, 1, __ATOMIC_RELAXED)) < INIT_STAGE_COUNT) {
+        init_stage_run(stage);
+    }
+}
+
+static void* init_worker_run(void *arg)
+{
+    init_stages_run();
+
+    return NULL;
+}
+
+/*
+ * Run the deferred switch init stages, on the init workers of the switch
+ * profile. Without workers the stages are done on return, and the status is
+ * that of the first stage failed
+ */
+sai_status_t db_init_start()
+{
+    uint32_t workers;
+    int      err;
+
+    db_init_wait();
+
+    init_next_stage = 0;
+    init_pending    = INIT_STAGE_COUNT;
+    init_failed     = false;
+    init_status     = SAI_STATUS_SUCCESS;
+    __atomic_store_n(&init_oper_status, SAI_SWITCH_OPER_STATUS_DOWN, __ATOMIC_RELEASE);
+
+    workers = db_profile_u32_get(INIT_WORKERS_KEY, INIT_DEFAULT_WORKERS);
+    if (workers > INIT_MAX_WORKERS) {
+        workers = INIT_MAX_WORKERS;
+    }
+    if (workers > INIT_STAGE_COUNT) {
+        workers = INIT_STAGE_COUNT;
+    }
+
+    for (init_worker_count = 0; init_worker_count < workers; init_worker_count++) {
+        if (0 != (err = pthread_create(&init_workers[init_worker_count], NULL, init_worker_run, NULL))) {
+            STUB_LOG_WRN("Failed to start switch init worker, %s\n", strerror(err));
+            break;
+        }
+    }
+
+    /* Without workers, the stages run here */
+    if (0 == init_worker_count) {
+        init_stages_run();
+        return init_status;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Wait for the switch init stages to be done */
+void db_init_wait()
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < init_worker_count; ii++) {
+        pthread_join(init_workers[ii], NULL);
+    }
+    init_worker_count = 0;
+}
+
+/* DOWN while init stages are pending, then UP, or FAILED if one failed */
+sai_switch_oper_status_t db_init_oper_status_get()
+{
+    return __atomic_load_n(&init_oper_status, __ATOMIC_ACQUIRE);
+}
+
+/*************************/
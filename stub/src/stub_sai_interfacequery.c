@@ -121,8 +121,8 @@ sai_status_t sai_api_query(_In_ sai_api_t sai_api_id, _Out_ void** api_method_ta
         return SAI_STATUS_SUCCESS;
 
     case SAI_API_QOS_MAPS:
-        /* TODO : implement */
-        return SAI_STATUS_NOT_IMPLEMENTED;
+        *(const sai_qos_map_api_t**)api_method_table = &qos_map_api;
+        return SAI_STATUS_SUCCESS;
 
     case SAI_API_ACL:
         /* TODO : implement */
@@ -133,20 +133,80 @@ sai_status_t sai_api_query(_In_ sai_api_t sai_api_id, _Out_ void** api_method_ta
         return SAI_STATUS_SUCCESS;
 
     case SAI_API_MIRROR:
-        /* TODO : implement */
-        return SAI_STATUS_NOT_IMPLEMENTED;
+        *(const sai_mirror_api_t**)api_method_table = &mirror_api;
+        return SAI_STATUS_SUCCESS;
 
     case SAI_API_SAMPLEPACKET:
-        /* TODO : implement */
-        return SAI_STATUS_NOT_IMPLEMENTED;
+        *(const sai_samplepacket_api_t**)api_method_table = &samplepacket_api;
+        return SAI_STATUS_SUCCESS;
 
     case SAI_API_STP:
-        /* TODO : implement */
-        return SAI_STATUS_NOT_IMPLEMENTED;
+        *(const sai_stp_api_t**)api_method_table = &stp_api;
+        return SAI_STATUS_SUCCESS;
 
     case SAI_API_LAG:
-        /* TODO : implement */
-        return SAI_STATUS_NOT_IMPLEMENTED;
+        *(const sai_lag_api_t**)api_method_table = &lag_api;
+        return SAI_STATUS_SUCCESS;
+
+    case SAI_API_POLICER:
+        *(const sai_policer_api_t**)api_method_table = &policer_api;
+        return SAI_STATUS_SUCCESS;
+
+    case SAI_API_WRED:
+        *(const sai_wred_api_t**)api_method_table = &wred_api;
+        return SAI_STATUS_SUCCESS;
+
+    case SAI_API_QUEUE:
+        *(const sai_queue_api_t**)api_method_table = &queue_api;
+        return SAI_STATUS_SUCCESS;
+
+    case SAI_API_SCHEDULER:
+        *(const sai_scheduler_api_t**)api_method_table = &scheduler_api;
+        return SAI_STATUS_SUCCESS;
+
+    case SAI_API_SCHEDULER_GROUP:
+        *(const sai_scheduler_group_api_t**)api_method_table = &scheduler_group_api;
+        return SAI_STATUS_SUCCESS;
+
+    case SAI_API_BUFFERS:
+        *(const sai_buffer_api_t**)api_method_table = &buffer_api;
+        return SAI_STATUS_SUCCESS;
+
+    case SAI_API_TUNNEL:
+        *(const sai_tunnel_api_t**)api_method_table = &tunnel_api;
+        return SAI_STATUS_SUCCESS;
+
+    case SAI_API_UDF:
+        *(const sai_udf_api_t**)api_method_table = &udf_api;
+        return SAI_STATUS_SUCCESS;
+
+    case SAI_API_L2MC:
+        *(const sai_l2mc_api_t**)api_method_table = &l2mc_api;
+        return SAI_STATUS_SUCCESS;
+
+    case SAI_API_IPMC:
+        *(const sai_ipmc_api_t**)api_method_table = &ipmc_api;
+        return SAI_STATUS_SUCCESS;
+
+    case SAI_API_RPF_GROUP:
+        *(const sai_rpf_group_api_t**)api_method_table = &rpf_group_api;
+        return SAI_STATUS_SUCCESS;
+
+    case SAI_API_L2MC_GROUP:
+        *(const sai_l2mc_group_api_t**)api_method_table = &l2mc_group_api;
+        return SAI_STATUS_SUCCESS;
+
+    case SAI_API_IPMC_GROUP:
+        *(const sai_ipmc_group_api_t**)api_method_table = &ipmc_group_api;
+        return SAI_STATUS_SUCCESS;
+
+    case SAI_API_MCAST_FDB:
+        *(const sai_mcast_fdb_api_t**)api_method_table = &mcast_fdb_api;
+        return SAI_STATUS_SUCCESS;
+
+    case SAI_API_TELEMETRY:
+        *(const sai_telemetry_api_t**)api_method_table = &telemetry_api;
+        return SAI_STATUS_SUCCESS;
 
     default:
         fprintf(stderr, "Invalid API type %d\n", sai_api_id);
@@ -264,6 +324,51 @@ sai_status_t sai_log_set(_In_ sai_api_t sai_api_id, _In_ sai_log_level_t log_lev
     case SAI_API_LAG:
         break;
 
+    case SAI_API_POLICER:
+        break;
+
+    case SAI_API_WRED:
+        break;
+
+    case SAI_API_QUEUE:
+        break;
+
+    case SAI_API_SCHEDULER:
+        break;
+
+    case SAI_API_SCHEDULER_GROUP:
+        break;
+
+    case SAI_API_BUFFERS:
+        break;
+
+    case SAI_API_TUNNEL:
+        break;
+
+    case SAI_API_UDF:
+        break;
+
+    case SAI_API_L2MC:
+        break;
+
+    case SAI_API_IPMC:
+        break;
+
+    case SAI_API_RPF_GROUP:
+        break;
+
+    case SAI_API_L2MC_GROUP:
+        break;
+
+    case SAI_API_IPMC_GROUP:
+        break;
+
+    case SAI_API_MCAST_FDB:
+        break;
+
+    case SAI_API_TELEMETRY:
+        break;
+
     default:
         fprintf(stderr, "Invalid API type %d\n", sai_api_id);
         return SAI_STATUS_INVALID_PARAMETER;
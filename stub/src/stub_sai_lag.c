@@ -0,0 +1,988 @@
+/*
+ *  Copyright (C) 2014. Mellanox Technologies, Ltd. ALL RIGHTS RESERVED.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ */
+
+#include "sai.h"
+#include "stub_sai.h"
+#include "assert.h"
+#include "inttypes.h"
+
+#undef  __MODULE__
+#define __MODULE__ SAI_LAG
+
+static const sai_attribute_entry_t lag_attribs[] = {
+    { SAI_LAG_ATTR_PORT_LIST, false, false, false, true,
+      "LAG port list", SAI_ATTR_VAL_TYPE_OBJLIST },
+    { SAI_LAG_ATTR_INGRESS_ACL, false, true, true, true,
+      "LAG ingress ACL", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_LAG_ATTR_EGRESS_ACL, false, true, true, true,
+      "LAG egress ACL", SAI_ATTR_VAL_TYPE_OID },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+static const sai_attribute_entry_t lag_member_attribs[] = {
+    { SAI_LAG_MEMBER_ATTR_LAG_ID, true, true, false, true,
+      "LAG member LAG ID", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_LAG_MEMBER_ATTR_PORT_ID, true, true, false, true,
+      "LAG member port ID", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_LAG_MEMBER_ATTR_EGRESS_DISABLE, false, true, true, true,
+      "LAG member egress disable", SAI_ATTR_VAL_TYPE_BOOL },
+    { SAI_LAG_MEMBER_ATTR_INGRESS_DISABLE, false, true, true, true,
+      "LAG member ingress disable", SAI_ATTR_VAL_TYPE_BOOL },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+sai_status_t stub_lag_attr_get(_In_ const sai_object_key_t   *key,
+                               _Inout_ sai_attribute_value_t *value,
+                               _In_ uint32_t                  attr_index,
+                               _Inout_ vendor_cache_t        *cache,
+                               void                          *arg);
+sai_status_t stub_lag_acl_set(_In_ const sai_object_key_t      *key,
+                              _In_ const sai_attribute_value_t *value,
+                              void                             *arg);
+sai_status_t stub_lag_member_attr_get(_In_ const sai_object_key_t   *key,
+                                      _Inout_ sai_attribute_value_t *value,
+                                      _In_ uint32_t                  attr_index,
+                                      _Inout_ vendor_cache_t        *cache,
+                                      void                          *arg);
+sai_status_t stub_lag_member_disable_set(_In_ const sai_object_key_t      *key,
+                                         _In_ const sai_attribute_value_t *value,
+                                         void                             *arg);
+
+static const sai_vendor_attribute_entry_t lag_vendor_attribs[] = {
+    { SAI_LAG_ATTR_PORT_LIST,
+      { false, false, false, true },
+      { false, false, false, true },
+      stub_lag_attr_get, (void*)SAI_LAG_ATTR_PORT_LIST,
+      NULL, NULL },
+    { SAI_LAG_ATTR_INGRESS_ACL,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_lag_attr_get, (void*)SAI_LAG_ATTR_INGRESS_ACL,
+      stub_lag_acl_set, (void*)SAI_LAG_ATTR_INGRESS_ACL },
+    { SAI_LAG_ATTR_EGRESS_ACL,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_lag_attr_get, (void*)SAI_LAG_ATTR_EGRESS_ACL,
+      stub_lag_acl_set, (void*)SAI_LAG_ATTR_EGRESS_ACL },
+};
+
+static const sai_vendor_attribute_entry_t lag_member_vendor_attribs[] = {
+    { SAI_LAG_MEMBER_ATTR_LAG_ID,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_lag_member_attr_get, (void*)SAI_LAG_MEMBER_ATTR_LAG_ID,
+      NULL, NULL },
+    { SAI_LAG_MEMBER_ATTR_PORT_ID,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_lag_member_attr_get, (void*)SAI_LAG_MEMBER_ATTR_PORT_ID,
+      NULL, NULL },
+    { SAI_LAG_MEMBER_ATTR_EGRESS_DISABLE,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_lag_member_attr_get, (void*)SAI_LAG_MEMBER_ATTR_EGRESS_DISABLE,
+      stub_lag_member_disable_set, (void*)SAI_LAG_MEMBER_ATTR_EGRESS_DISABLE },
+    { SAI_LAG_MEMBER_ATTR_INGRESS_DISABLE,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_lag_member_attr_get, (void*)SAI_LAG_MEMBER_ATTR_INGRESS_DISABLE,
+      stub_lag_member_disable_set, (void*)SAI_LAG_MEMBER_ATTR_INGRESS_DISABLE },
+};
+
+/* State DB *************/
+
+/*
+ * Egress member selection goes through a table of LAG_BUCKETS buckets, each
+ * holding the port the flows hashing to it are sent to. Enabled members own
+ * an equal share of the buckets, give or take one.
+ *
+ * A member change copies the table and moves only the buckets it has to:
+ * those of members gone or disabled, and those above the new share of the
+ * others, to the members below theirs. Flows of the remaining members keep
+ * their port. The copy is then swapped in, so a selection sees either the
+ * old or the new table, never a disabled member of a table being rebuilt.
+ * Replaced tables are freed once no core reads with an epoch from before the
+ * swap.
+ *
+ * A port is member of one LAG at most, so members are indexed by port.
+ */
+#define MAX_LAG_NUMBER   64
+#define LAG_BUCKETS      256
+
+#if PORT_NUMBER > 64
+#error "LAG member bitmap too small for the ports"
+#endif
+
+typedef struct _stub_lag_table_t {
+    uint8_t              buckets[LAG_BUCKETS];
+    /* Buckets of each port */
+    uint16_t             share[PORT_NUMBER];
+    uint32_t             member_count;
+    stub_epoch_retired_t retired;
+} stub_lag_table_t;
+
+typedef struct _stub_lag_t {
+    /* Member ports, and the ones enabled for egress */
+    uint64_t          members;
+    uint64_t          egress_members;
+    /* NULL while no member is enabled for egress */
+    stub_lag_table_t *table;
+    sai_object_id_t   ingress_acl;
+    sai_object_id_t   egress_acl;
+    bool              is_valid;
+} stub_lag_t;
+
+/* Flows selected for a member by one core */
+typedef struct _stub_lag_counters_t {
+    uint64_t flows;
+} __attribute__((aligned(CACHE_LINE_SIZE))) stub_lag_counters_t;
+
+typedef struct _stub_lag_member_t {
+    uint32_t            lag_db_id;
+    bool                egress_disable;
+    bool                ingress_disable;
+    stub_lag_counters_t counters[STUB_CORES];
+    bool                is_valid;
+} stub_lag_member_t;
+
+static stub_lag_t          lag_db[MAX_LAG_NUMBER];
+static stub_lag_member_t   lag_member_db[PORT_NUMBER];
+static stub_epoch_domain_t lag_epoch = STUB_EPOCH_DOMAIN_INIT;
+
+static sai_status_t db_get_lag(_In_ uint32_t lag_id, _Out_ stub_lag_t **lag)
+{
+    if ((lag_id >= MAX_LAG_NUMBER) || (!lag_db[lag_id].is_valid)) {
+        STUB_LOG_ERR("Invalid LAG ID %u\n", lag_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *lag = &lag_db[lag_id];
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t db_find_free_lag_index(_Out_ uint32_t *free_index)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < MAX_LAG_NUMBER; ii++) {
+        if (false == lag_db[ii].is_valid) {
+            *free_index = ii;
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+
+    STUB_LOG_ERR("LAG table full\n");
+    return SAI_STATUS_TABLE_FULL;
+}
+
+static sai_status_t db_get_lag_member(_In_ uint32_t member_id, _Out_ stub_lag_member_t **member)
+{
+    if ((member_id >= PORT_NUMBER) || (!lag_member_db[member_id].is_valid)) {
+        STUB_LOG_ERR("Invalid LAG member ID %u\n", member_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *member = &lag_member_db[member_id];
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Move the buckets of table to the ports set in members, as few as possible.
+ * Members holding the most buckets keep the extra ones when the buckets do
+ * not divide evenly.
+ */
+static void lag_table_rebalance(_Inout_ stub_lag_table_t *table, _In_ uint64_t members)
+{
+    uint16_t target[PORT_NUMBER] = { 0 };
+    uint8_t  order[PORT_NUMBER], moved[LAG_BUCKETS];
+    uint32_t count = __builtin_popcountll(members), moved_count = 0, extra, ii, jj, port;
+    uint64_t bits;
+
+    for (bits = members, ii = 0; bits; bits &= bits - 1) {
+        order[ii++] = __builtin_ctzll(bits);
+    }
+
+    /* Members by decreasing share, the first ones get the extra buckets */
+    for (ii = 1; ii < count; ii++) {
+        port = order[ii];
+        for (jj = ii; (jj > 0) && (table->share[order[jj - 1]] < table->share[port]); jj--) {
+            order[jj] = order[jj - 1];
+        }
+        order[jj] = port;
+    }
+
+    extra = LAG_BUCKETS % count;
+    for (ii = 0; ii < count; ii++) {
+        target[order[ii]] = LAG_BUCKETS / count + (ii < extra);
+    }
+
+    for (ii = 0; ii < LAG_BUCKETS; ii++) {
+        port = table->buckets[ii];
+        if (table->share[port] > target[port]) {
+            table->share[port]--;
+            moved[moved_count++] = ii;
+        }
+    }
+
+    for (ii = 0, jj = 0; ii < moved_count; ii++) {
+        while (table->share[order[jj]] >= target[order[jj]]) {
+            jj++;
+        }
+        table->buckets[moved[ii]] = order[jj];
+        table->share[order[jj]]++;
+    }
+
+    table->member_count = count;
+}
+
+/* Rebuild the selection table of a LAG from its egress members, and swap it in */
+static sai_status_t lag_publish(_Inout_ stub_lag_t *lag)
+{
+    stub_lag_table_t *table = NULL, *old;
+
+    if (0 != lag->egress_members) {
+        if (NULL == (table = malloc(sizeof(*table)))) {
+            STUB_LOG_ERR("Failed to allocate LAG table\n");
+            return SAI_STATUS_NO_MEMORY;
+        }
+
+        if (NULL != lag->table) {
+            memcpy(table, lag->table, sizeof(*table));
+        } else {
+            /* All buckets start on the first member, moved from there */
+            memset(table, 0, sizeof(*table));
+            memset(table->buckets, __builtin_ctzll(lag->egress_members), sizeof(table->buckets));
+            table->share[__builtin_ctzll(lag->egress_members)] = LAG_BUCKETS;
+        }
+
+        lag_table_rebalance(table, lag->egress_members);
+    }
+
+    old = __atomic_exchange_n(&lag->table, table, __ATOMIC_SEQ_CST);
+    if (NULL != old) {
+        stub_epoch_retire(&lag_epoch, old, &old->retired);
+    }
+
+    stub_epoch_reclaim(&lag_epoch);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Change the egress members of a LAG, reverted when the table can't be rebuilt */
+static sai_status_t lag_egress_members_set(_Inout_ stub_lag_t *lag, _In_ uint64_t egress_members)
+{
+    uint64_t     old = lag->egress_members;
+    sai_status_t status;
+
+    if (old == egress_members) {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    lag->egress_members = egress_members;
+    if (SAI_STATUS_SUCCESS != (status = lag_publish(lag))) {
+        lag->egress_members = old;
+    }
+
+    return status;
+}
+
+/*
+ * Select the egress port of count packets sent to a LAG, by their hash.
+ * Ports are set to PORT_NUMBER when no member is enabled for egress.
+ */
+sai_status_t db_lag_select(_In_ uint32_t         core,
+                           _In_ sai_object_id_t  lag_id,
+                           _In_ uint32_t         count,
+                           _In_ const uint32_t  *hashes,
+                           _Out_ uint32_t       *ports)
+{
+    const stub_lag_table_t *table;
+    stub_lag_t             *lag;
+    sai_status_t            status;
+    uint32_t                db_id, ii;
+
+    if (core >= STUB_CORES) {
+        STUB_LOG_ERR("Invalid core %u\n", core);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(lag_id, SAI_OBJECT_TYPE_LAG, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_lag(db_id, &lag))) {
+        return status;
+    }
+
+    stub_epoch_read_begin(&lag_epoch, core);
+    table = __atomic_load_n(&lag->table, __ATOMIC_SEQ_CST);
+
+    if (NULL == table) {
+        for (ii = 0; ii < count; ii++) {
+            ports[ii] = PORT_NUMBER;
+        }
+    } else {
+        for (ii = 0; ii < count; ii++) {
+            ports[ii] = table->buckets[hashes[ii] % LAG_BUCKETS];
+            lag_member_db[ports[ii]].counters[core].flows++;
+        }
+    }
+
+    stub_epoch_read_end(&lag_epoch, core);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Flows selected for a member since it was added */
+sai_status_t db_lag_member_flows_get(_In_ sai_object_id_t member_id, _Out_ uint64_t *flows)
+{
+    stub_lag_member_t *member;
+    sai_status_t       status;
+    uint32_t           db_id, core;
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(member_id, SAI_OBJECT_TYPE_LAG_MEMBER, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_lag_member(db_id, &member))) {
+        return status;
+    }
+
+    *flows = 0;
+    for (core = 0; core < STUB_CORES; core++) {
+        *flows += member->counters[core].flows;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* LAG of a port, SAI_NULL_OBJECT_ID when none or when ingress is disabled on it */
+sai_status_t db_lag_port_ingress_get(_In_ uint32_t port_id, _Out_ sai_object_id_t *lag_id)
+{
+    const stub_lag_member_t *member = &lag_member_db[port_id % PORT_NUMBER];
+
+    if (port_id >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid port %u\n", port_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if ((!member->is_valid) || (member->ingress_disable)) {
+        *lag_id = SAI_NULL_OBJECT_ID;
+        return SAI_STATUS_SUCCESS;
+    }
+
+    return stub_create_object(SAI_OBJECT_TYPE_LAG, member->lag_db_id, lag_id);
+}
+
+/*************************/
+
+static void lag_key_to_str(_In_ sai_object_id_t lag_id, _Out_ char *key_str)
+{
+    uint32_t lagid;
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(lag_id, SAI_OBJECT_TYPE_LAG, &lagid)) {
+        snprintf(key_str, MAX_KEY_STR_LEN, "invalid LAG");
+    } else {
+        snprintf(key_str, MAX_KEY_STR_LEN, "LAG %u", lagid);
+    }
+}
+
+static void lag_member_key_to_str(_In_ sai_object_id_t lag_member_id, _Out_ char *key_str)
+{
+    uint32_t memberid;
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(lag_member_id, SAI_OBJECT_TYPE_LAG_MEMBER, &memberid)) {
+        snprintf(key_str, MAX_KEY_STR_LEN, "invalid LAG member");
+    } else {
+        snprintf(key_str, MAX_KEY_STR_LEN, "LAG member port %u", memberid);
+    }
+}
+
+/* ACL table or ACL table group, or SAI_NULL_OBJECT_ID */
+static sai_status_t lag_acl_check(_In_ sai_object_id_t acl_id)
+{
+    sai_object_type_t type = sai_object_type_query(acl_id);
+
+    if ((SAI_NULL_OBJECT_ID != acl_id) && (SAI_OBJECT_TYPE_ACL_TABLE != type) &&
+        (SAI_OBJECT_TYPE_ACL_TABLE_GROUP != type)) {
+        STUB_LOG_ERR("Invalid ACL object type %d\n", type);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Create LAG.
+ *
+ * Arguments:
+ *    [out] lag_id - LAG id
+ *    [in] switch_id - switch id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_lag(_Out_ sai_object_id_t      *lag_id,
+                             _In_ sai_object_id_t        switch_id,
+                             _In_ uint32_t               attr_count,
+                             _In_ const sai_attribute_t *attr_list)
+{
+    sai_status_t                 status;
+    const sai_attribute_value_t *ingress_acl, *egress_acl;
+    uint32_t                     ingress_acl_index, egress_acl_index, db_id;
+    char                         list_str[MAX_LIST_VALUE_STR_LEN];
+    char                         key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == lag_id) {
+        STUB_LOG_ERR("NULL LAG id param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = check_attribs_metadata(attr_count, attr_list, lag_attribs, lag_vendor_attribs,
+                                         SAI_OPERATION_CREATE))) {
+        STUB_LOG_ERR("Failed attribs check\n");
+        return status;
+    }
+
+    sai_attr_list_to_str(attr_count, attr_list, lag_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create LAG, %s\n", list_str);
+
+    if (SAI_STATUS_SUCCESS != (status = db_find_free_lag_index(&db_id))) {
+        return status;
+    }
+
+    memset(&lag_db[db_id], 0, sizeof(lag_db[db_id]));
+
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_LAG_ATTR_INGRESS_ACL, &ingress_acl, &ingress_acl_index)) {
+        if (SAI_STATUS_SUCCESS != lag_acl_check(ingress_acl->oid)) {
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + ingress_acl_index;
+        }
+        lag_db[db_id].ingress_acl = ingress_acl->oid;
+    }
+
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_LAG_ATTR_EGRESS_ACL, &egress_acl, &egress_acl_index)) {
+        if (SAI_STATUS_SUCCESS != lag_acl_check(egress_acl->oid)) {
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + egress_acl_index;
+        }
+        lag_db[db_id].egress_acl = egress_acl->oid;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = stub_create_object(SAI_OBJECT_TYPE_LAG, db_id, lag_id))) {
+        return status;
+    }
+
+    lag_db[db_id].is_valid = true;
+
+    lag_key_to_str(*lag_id, key_str);
+    STUB_LOG_NTC("Created %s\n", key_str);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Remove LAG.
+ *
+ * Arguments:
+ *    [in] lag_id - LAG id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_lag(_In_ sai_object_id_t lag_id)
+{
+    stub_lag_t  *lag;
+    char         key_str[MAX_KEY_STR_LEN];
+    sai_status_t status;
+    uint32_t     db_id;
+
+    STUB_LOG_ENTER();
+
+    lag_key_to_str(lag_id, key_str);
+    STUB_LOG_NTC("Remove %s\n", key_str);
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(lag_id, SAI_OBJECT_TYPE_LAG, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_lag(db_id, &lag))) {
+        return status;
+    }
+
+    if (0 != lag->members) {
+        STUB_LOG_ERR("LAG %u has %u members\n", db_id, __builtin_popcountll(lag->members));
+        return SAI_STATUS_OBJECT_IN_USE;
+    }
+
+    lag->is_valid = false;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Set LAG attribute.
+ *
+ * Arguments:
+ *    [in] lag_id - LAG id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_lag_attribute(_In_ sai_object_id_t lag_id, _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = lag_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    lag_key_to_str(lag_id, key_str);
+    return sai_set_attribute(&key, key_str, lag_attribs, lag_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get LAG attributes.
+ *
+ * Arguments:
+ *    [in] lag_id - LAG id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_lag_attribute(_In_ sai_object_id_t     lag_id,
+                                    _In_ uint32_t            attr_count,
+                                    _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = lag_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    lag_key_to_str(lag_id, key_str);
+    return sai_get_attributes(&key, key_str, lag_attribs, lag_vendor_attribs, attr_count, attr_list);
+}
+
+/* Port list [sai_object_list_t], ingress and egress ACL [sai_object_id_t] */
+sai_status_t stub_lag_attr_get(_In_ const sai_object_key_t   *key,
+                               _Inout_ sai_attribute_value_t *value,
+                               _In_ uint32_t                  attr_index,
+                               _Inout_ vendor_cache_t        *cache,
+                               void                          *arg)
+{
+    stub_lag_t     *lag;
+    sai_status_t    status;
+    sai_object_id_t members[PORT_NUMBER];
+    uint64_t        bits;
+    uint32_t        db_id, count = 0;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_LAG, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_lag(db_id, &lag))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_LAG_ATTR_PORT_LIST:
+        for (bits = lag->members; bits; bits &= bits - 1) {
+            if (SAI_STATUS_SUCCESS !=
+                (status = stub_create_object(SAI_OBJECT_TYPE_LAG_MEMBER, __builtin_ctzll(bits), &members[count++]))) {
+                return status;
+            }
+        }
+        status = stub_fill_objlist(members, count, &value->objlist);
+        break;
+
+    case SAI_LAG_ATTR_INGRESS_ACL:
+        value->oid = lag->ingress_acl;
+        break;
+
+    case SAI_LAG_ATTR_EGRESS_ACL:
+        value->oid = lag->egress_acl;
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid LAG attribute %d\n", (int)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return status;
+}
+
+/* Ingress and egress ACL [sai_object_id_t] */
+sai_status_t stub_lag_acl_set(_In_ const sai_object_key_t      *key,
+                              _In_ const sai_attribute_value_t *value,
+                              void                             *arg)
+{
+    stub_lag_t  *lag;
+    sai_status_t status;
+    uint32_t     db_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_LAG, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_lag(db_id, &lag))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = lag_acl_check(value->oid))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_LAG_ATTR_INGRESS_ACL:
+        lag->ingress_acl = value->oid;
+        break;
+
+    case SAI_LAG_ATTR_EGRESS_ACL:
+        lag->egress_acl = value->oid;
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid LAG attribute %d\n", (int)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Create LAG member.
+ *
+ * Arguments:
+ *    [out] lag_member_id - LAG member id
+ *    [in] switch_id - switch id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_lag_member(_Out_ sai_object_id_t      *lag_member_id,
+                                    _In_ sai_object_id_t        switch_id,
+                                    _In_ uint32_t               attr_count,
+                                    _In_ const sai_attribute_t *attr_list)
+{
+    stub_lag_t                  *lag;
+    stub_lag_member_t           *member;
+    sai_status_t                 status;
+    const sai_attribute_value_t *lag_id, *port, *egress_disable, *ingress_disable;
+    uint32_t                     lag_index, port_index, egress_disable_index, ingress_disable_index;
+    uint32_t                     lag_db_id, port_id;
+    char                         list_str[MAX_LIST_VALUE_STR_LEN];
+    char                         key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == lag_member_id) {
+        STUB_LOG_ERR("NULL LAG member id param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = check_attribs_metadata(attr_count, attr_list, lag_member_attribs, lag_member_vendor_attribs,
+                                         SAI_OPERATION_CREATE))) {
+        STUB_LOG_ERR("Failed attribs check\n");
+        return status;
+    }
+
+    sai_attr_list_to_str(attr_count, attr_list, lag_member_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create LAG member, %s\n", list_str);
+
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_LAG_MEMBER_ATTR_LAG_ID, &lag_id, &lag_index));
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_LAG_MEMBER_ATTR_PORT_ID, &port, &port_index));
+
+    if ((SAI_STATUS_SUCCESS != stub_object_to_type(lag_id->oid, SAI_OBJECT_TYPE_LAG, &lag_db_id)) ||
+        (SAI_STATUS_SUCCESS != db_get_lag(lag_db_id, &lag))) {
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + lag_index;
+    }
+
+    if ((SAI_STATUS_SUCCESS != stub_object_to_type(port->oid, SAI_OBJECT_TYPE_PORT, &port_id)) ||
+        (port_id >= PORT_NUMBER)) {
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + port_index;
+    }
+
+    member = &lag_member_db[port_id];
+    if (member->is_valid) {
+        STUB_LOG_ERR("Port %u already in LAG %u\n", port_id, member->lag_db_id);
+        return SAI_STATUS_ITEM_ALREADY_EXISTS;
+    }
+
+    memset(member, 0, sizeof(*member));
+    member->lag_db_id = lag_db_id;
+
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_LAG_MEMBER_ATTR_EGRESS_DISABLE, &egress_disable,
+                            &egress_disable_index)) {
+        member->egress_disable = egress_disable->booldata;
+    }
+
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_LAG_MEMBER_ATTR_INGRESS_DISABLE, &ingress_disable,
+                            &ingress_disable_index)) {
+        member->ingress_disable = ingress_disable->booldata;
+    }
+
+    if (!member->egress_disable) {
+        if (SAI_STATUS_SUCCESS !=
+            (status = lag_egress_members_set(lag, lag->egress_members | (1ULL << port_id)))) {
+            return status;
+        }
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = stub_create_object(SAI_OBJECT_TYPE_LAG_MEMBER, port_id, lag_member_id))) {
+        return status;
+    }
+
+    lag->members    |= 1ULL << port_id;
+    member->is_valid = true;
+
+    lag_member_key_to_str(*lag_member_id, key_str);
+    STUB_LOG_NTC("Created %s\n", key_str);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Remove LAG member.
+ *
+ * Arguments:
+ *    [in] lag_member_id - LAG member id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_lag_member(_In_ sai_object_id_t lag_member_id)
+{
+    stub_lag_member_t *member;
+    stub_lag_t        *lag;
+    char               key_str[MAX_KEY_STR_LEN];
+    sai_status_t       status;
+    uint32_t           db_id;
+
+    STUB_LOG_ENTER();
+
+    lag_member_key_to_str(lag_member_id, key_str);
+    STUB_LOG_NTC("Remove %s\n", key_str);
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(lag_member_id, SAI_OBJECT_TYPE_LAG_MEMBER, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_lag_member(db_id, &member))) {
+        return status;
+    }
+
+    lag = &lag_db[member->lag_db_id];
+    if (SAI_STATUS_SUCCESS != (status = lag_egress_members_set(lag, lag->egress_members & ~(1ULL << db_id)))) {
+        return status;
+    }
+
+    lag->members    &= ~(1ULL << db_id);
+    member->is_valid = false;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Set LAG member attribute.
+ *
+ * Arguments:
+ *    [in] lag_member_id - LAG member id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_lag_member_attribute(_In_ sai_object_id_t lag_member_id, _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = lag_member_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    lag_member_key_to_str(lag_member_id, key_str);
+    return sai_set_attribute(&key, key_str, lag_member_attribs, lag_member_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get LAG member attributes.
+ *
+ * Arguments:
+ *    [in] lag_member_id - LAG member id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_lag_member_attribute(_In_ sai_object_id_t     lag_member_id,
+                                           _In_ uint32_t            attr_count,
+                                           _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = lag_member_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    lag_member_key_to_str(lag_member_id, key_str);
+    return sai_get_attributes(&key, key_str, lag_member_attribs, lag_member_vendor_attribs, attr_count, attr_list);
+}
+
+/* LAG and port [sai_object_id_t], egress and ingress disable [bool] */
+sai_status_t stub_lag_member_attr_get(_In_ const sai_object_key_t   *key,
+                                      _Inout_ sai_attribute_value_t *value,
+                                      _In_ uint32_t                  attr_index,
+                                      _Inout_ vendor_cache_t        *cache,
+                                      void                          *arg)
+{
+    stub_lag_member_t *member;
+    sai_status_t       status;
+    uint32_t           db_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_LAG_MEMBER, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_lag_member(db_id, &member))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_LAG_MEMBER_ATTR_LAG_ID:
+        status = stub_create_object(SAI_OBJECT_TYPE_LAG, member->lag_db_id, &value->oid);
+        break;
+
+    case SAI_LAG_MEMBER_ATTR_PORT_ID:
+        status = stub_create_object(SAI_OBJECT_TYPE_PORT, db_id, &value->oid);
+        break;
+
+    case SAI_LAG_MEMBER_ATTR_EGRESS_DISABLE:
+        value->booldata = member->egress_disable;
+        break;
+
+    case SAI_LAG_MEMBER_ATTR_INGRESS_DISABLE:
+        value->booldata = member->ingress_disable;
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid LAG member attribute %d\n", (int)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return status;
+}
+
+/* Egress and ingress disable [bool] */
+sai_status_t stub_lag_member_disable_set(_In_ const sai_object_key_t      *key,
+                                         _In_ const sai_attribute_value_t *value,
+                                         void                             *arg)
+{
+    stub_lag_member_t *member;
+    stub_lag_t        *lag;
+    sai_status_t       status;
+    uint32_t           db_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_LAG_MEMBER, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_lag_member(db_id, &member))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_LAG_MEMBER_ATTR_EGRESS_DISABLE:
+        lag = &lag_db[member->lag_db_id];
+        if (SAI_STATUS_SUCCESS !=
+            (status = lag_egress_members_set(lag, value->booldata ? (lag->egress_members & ~(1ULL << db_id)) :
+                                             (lag->egress_members | (1ULL << db_id))))) {
+            return status;
+        }
+        member->egress_disable = value->booldata;
+        break;
+
+    case SAI_LAG_MEMBER_ATTR_INGRESS_DISABLE:
+        member->ingress_disable = value->booldata;
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid LAG member attribute %d\n", (int)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+const sai_lag_api_t lag_api = {
+    stub_create_lag,
+    stub_remove_lag,
+    stub_set_lag_attribute,
+    stub_get_lag_attribute,
+    stub_create_lag_member,
+    stub_remove_lag_member,
+    stub_set_lag_member_attribute,
+    stub_get_lag_member_attribute
+};
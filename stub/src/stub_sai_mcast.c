@@ -0,0 +1,2769 @@
+/*
+ *  Copyright (C) 2014. Mellanox Technologies, Ltd. ALL RIGHTS RESERVED.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ */
+
+#include "sai.h"
+#include "stub_sai.h"
+#include "assert.h"
+#include "inttypes.h"
+
+#undef  __MODULE__
+#define __MODULE__ SAI_MCAST
+
+static const sai_attribute_entry_t rpf_group_attribs[] = {
+    { SAI_RPF_GROUP_ATTR_RPF_INTERFACE_COUNT, false, false, false, true,
+      "RPF group interface count", SAI_ATTR_VAL_TYPE_U32 },
+    { SAI_RPF_GROUP_ATTR_RPF_MEMBER_LIST, false, false, false, true,
+      "RPF group member list", SAI_ATTR_VAL_TYPE_OBJLIST },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+static const sai_attribute_entry_t rpf_group_member_attribs[] = {
+    { SAI_RPF_GROUP_MEMBER_ATTR_RPF_GROUP_ID, true, true, false, true,
+      "RPF group member group ID", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_RPF_GROUP_MEMBER_ATTR_RPF_INTERFACE_ID, true, true, false, true,
+      "RPF group member interface ID", SAI_ATTR_VAL_TYPE_OID },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+static const sai_attribute_entry_t ipmc_group_attribs[] = {
+    { SAI_IPMC_GROUP_ATTR_IPMC_OUTPUT_COUNT, false, false, false, true,
+      "IPMC group output count", SAI_ATTR_VAL_TYPE_U32 },
+    { SAI_IPMC_GROUP_ATTR_IPMC_MEMBER_LIST, false, false, false, true,
+      "IPMC group member list", SAI_ATTR_VAL_TYPE_OBJLIST },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+static const sai_attribute_entry_t ipmc_group_member_attribs[] = {
+    { SAI_IPMC_GROUP_MEMBER_ATTR_IPMC_GROUP_ID, true, true, false, true,
+      "IPMC group member group ID", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_IPMC_GROUP_MEMBER_ATTR_IPMC_OUTPUT_ID, true, true, false, true,
+      "IPMC group member output ID", SAI_ATTR_VAL_TYPE_OID },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+static const sai_attribute_entry_t l2mc_group_attribs[] = {
+    { SAI_L2MC_GROUP_ATTR_L2MC_OUTPUT_COUNT, false, false, false, true,
+      "L2MC group output count", SAI_ATTR_VAL_TYPE_U32 },
+    { SAI_L2MC_GROUP_ATTR_L2MC_MEMBER_LIST, false, false, false, true,
+      "L2MC group member list", SAI_ATTR_VAL_TYPE_OBJLIST },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+static const sai_attribute_entry_t l2mc_group_member_attribs[] = {
+    { SAI_L2MC_GROUP_MEMBER_ATTR_L2MC_GROUP_ID, true, true, false, true,
+      "L2MC group member group ID", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_L2MC_GROUP_MEMBER_ATTR_L2MC_OUTPUT_ID, true, true, false, true,
+      "L2MC group member output ID", SAI_ATTR_VAL_TYPE_OID },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+static const sai_attribute_entry_t ipmc_entry_attribs[] = {
+    { SAI_IPMC_ENTRY_ATTR_PACKET_ACTION, true, true, true, true,
+      "IPMC entry packet action", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_IPMC_ENTRY_ATTR_OUTPUT_GROUP_ID, false, true, true, true,
+      "IPMC entry output group ID", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_IPMC_ENTRY_ATTR_RPF_GROUP_ID, true, true, true, true,
+      "IPMC entry RPF group ID", SAI_ATTR_VAL_TYPE_OID },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+static const sai_attribute_entry_t l2mc_entry_attribs[] = {
+    { SAI_L2MC_ENTRY_ATTR_PACKET_ACTION, true, true, true, true,
+      "L2MC entry packet action", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_L2MC_ENTRY_ATTR_OUTPUT_GROUP_ID, false, true, true, true,
+      "L2MC entry output group ID", SAI_ATTR_VAL_TYPE_OID },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+static const sai_attribute_entry_t mcast_fdb_entry_attribs[] = {
+    { SAI_MCAST_FDB_ENTRY_ATTR_GROUP_ID, true, true, false, true,
+      "Multicast FDB entry group ID", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_MCAST_FDB_ENTRY_ATTR_PACKET_ACTION, true, true, false, true,
+      "Multicast FDB entry packet action", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_MCAST_FDB_ENTRY_ATTR_META_DATA, false, true, true, true,
+      "Multicast FDB entry meta data", SAI_ATTR_VAL_TYPE_U32 },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+/* Group and member attributes are alike for RPF, IPMC and L2MC groups */
+typedef enum _stub_mcast_attr_t {
+    MCAST_GROUP_ATTR_COUNT,
+    MCAST_GROUP_ATTR_MEMBER_LIST,
+    MCAST_MEMBER_ATTR_GROUP_ID,
+    MCAST_MEMBER_ATTR_OUTPUT_ID
+} stub_mcast_attr_t;
+
+sai_status_t stub_mcast_group_attr_get(_In_ const sai_object_key_t   *key,
+                                       _Inout_ sai_attribute_value_t *value,
+                                       _In_ uint32_t                  attr_index,
+                                       _Inout_ vendor_cache_t        *cache,
+                                       void                          *arg);
+sai_status_t stub_mcast_member_attr_get(_In_ const sai_object_key_t   *key,
+                                        _Inout_ sai_attribute_value_t *value,
+                                        _In_ uint32_t                  attr_index,
+                                        _Inout_ vendor_cache_t        *cache,
+                                        void                          *arg);
+sai_status_t stub_ipmc_entry_attr_get(_In_ const sai_object_key_t   *key,
+                                      _Inout_ sai_attribute_value_t *value,
+                                      _In_ uint32_t                  attr_index,
+                                      _Inout_ vendor_cache_t        *cache,
+                                      void                          *arg);
+sai_status_t stub_ipmc_entry_attr_set(_In_ const sai_object_key_t      *key,
+                                      _In_ const sai_attribute_value_t *value,
+                                      void                             *arg);
+sai_status_t stub_l2mc_entry_attr_get(_In_ const sai_object_key_t   *key,
+                                      _Inout_ sai_attribute_value_t *value,
+                                      _In_ uint32_t                  attr_index,
+                                      _Inout_ vendor_cache_t        *cache,
+                                      void                          *arg);
+sai_status_t stub_l2mc_entry_attr_set(_In_ const sai_object_key_t      *key,
+                                      _In_ const sai_attribute_value_t *value,
+                                      void                             *arg);
+sai_status_t stub_mcast_fdb_entry_attr_get(_In_ const sai_object_key_t   *key,
+                                           _Inout_ sai_attribute_value_t *value,
+                                           _In_ uint32_t                  attr_index,
+                                           _Inout_ vendor_cache_t        *cache,
+                                           void                          *arg);
+sai_status_t stub_mcast_fdb_entry_attr_set(_In_ const sai_object_key_t      *key,
+                                           _In_ const sai_attribute_value_t *value,
+                                           void                             *arg);
+
+static const sai_vendor_attribute_entry_t rpf_group_vendor_attribs[] = {
+    { SAI_RPF_GROUP_ATTR_RPF_INTERFACE_COUNT,
+      { false, false, false, true },
+      { false, false, false, true },
+      stub_mcast_group_attr_get, (void*)MCAST_GROUP_ATTR_COUNT,
+      NULL, NULL },
+    { SAI_RPF_GROUP_ATTR_RPF_MEMBER_LIST,
+      { false, false, false, true },
+      { false, false, false, true },
+      stub_mcast_group_attr_get, (void*)MCAST_GROUP_ATTR_MEMBER_LIST,
+      NULL, NULL },
+};
+
+static const sai_vendor_attribute_entry_t rpf_group_member_vendor_attribs[] = {
+    { SAI_RPF_GROUP_MEMBER_ATTR_RPF_GROUP_ID,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_mcast_member_attr_get, (void*)MCAST_MEMBER_ATTR_GROUP_ID,
+      NULL, NULL },
+    { SAI_RPF_GROUP_MEMBER_ATTR_RPF_INTERFACE_ID,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_mcast_member_attr_get, (void*)MCAST_MEMBER_ATTR_OUTPUT_ID,
+      NULL, NULL },
+};
+
+static const sai_vendor_attribute_entry_t ipmc_group_vendor_attribs[] = {
+    { SAI_IPMC_GROUP_ATTR_IPMC_OUTPUT_COUNT,
+      { false, false, false, true },
+      { false, false, false, true },
+      stub_mcast_group_attr_get, (void*)MCAST_GROUP_ATTR_COUNT,
+      NULL, NULL },
+    { SAI_IPMC_GROUP_ATTR_IPMC_MEMBER_LIST,
+      { false, false, false, true },
+      { false, false, false, true },
+      stub_mcast_group_attr_get, (void*)MCAST_GROUP_ATTR_MEMBER_LIST,
+      NULL, NULL },
+};
+
+static const sai_vendor_attribute_entry_t ipmc_group_member_vendor_attribs[] = {
+    { SAI_IPMC_GROUP_MEMBER_ATTR_IPMC_GROUP_ID,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_mcast_member_attr_get, (void*)MCAST_MEMBER_ATTR_GROUP_ID,
+      NULL, NULL },
+    { SAI_IPMC_GROUP_MEMBER_ATTR_IPMC_OUTPUT_ID,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_mcast_member_attr_get, (void*)MCAST_MEMBER_ATTR_OUTPUT_ID,
+      NULL, NULL },
+};
+
+static const sai_vendor_attribute_entry_t l2mc_group_vendor_attribs[] = {
+    { SAI_L2MC_GROUP_ATTR_L2MC_OUTPUT_COUNT,
+      { false, false, false, true },
+      { false, false, false, true },
+      stub_mcast_group_attr_get, (void*)MCAST_GROUP_ATTR_COUNT,
+      NULL, NULL },
+    { SAI_L2MC_GROUP_ATTR_L2MC_MEMBER_LIST,
+      { false, false, false, true },
+      { false, false, false, true },
+      stub_mcast_group_attr_get, (void*)MCAST_GROUP_ATTR_MEMBER_LIST,
+      NULL, NULL },
+};
+
+static const sai_vendor_attribute_entry_t l2mc_group_member_vendor_attribs[] = {
+    { SAI_L2MC_GROUP_MEMBER_ATTR_L2MC_GROUP_ID,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_mcast_member_attr_get, (void*)MCAST_MEMBER_ATTR_GROUP_ID,
+      NULL, NULL },
+    { SAI_L2MC_GROUP_MEMBER_ATTR_L2MC_OUTPUT_ID,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_mcast_member_attr_get, (void*)MCAST_MEMBER_ATTR_OUTPUT_ID,
+      NULL, NULL },
+};
+
+static const sai_vendor_attribute_entry_t ipmc_entry_vendor_attribs[] = {
+    { SAI_IPMC_ENTRY_ATTR_PACKET_ACTION,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_ipmc_entry_attr_get, (void*)SAI_IPMC_ENTRY_ATTR_PACKET_ACTION,
+      stub_ipmc_entry_attr_set, (void*)SAI_IPMC_ENTRY_ATTR_PACKET_ACTION },
+    { SAI_IPMC_ENTRY_ATTR_OUTPUT_GROUP_ID,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_ipmc_entry_attr_get, (void*)SAI_IPMC_ENTRY_ATTR_OUTPUT_GROUP_ID,
+      stub_ipmc_entry_attr_set, (void*)SAI_IPMC_ENTRY_ATTR_OUTPUT_GROUP_ID },
+    { SAI_IPMC_ENTRY_ATTR_RPF_GROUP_ID,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_ipmc_entry_attr_get, (void*)SAI_IPMC_ENTRY_ATTR_RPF_GROUP_ID,
+      stub_ipmc_entry_attr_set, (void*)SAI_IPMC_ENTRY_ATTR_RPF_GROUP_ID },
+};
+
+static const sai_vendor_attribute_entry_t l2mc_entry_vendor_attribs[] = {
+    { SAI_L2MC_ENTRY_ATTR_PACKET_ACTION,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_l2mc_entry_attr_get, (void*)SAI_L2MC_ENTRY_ATTR_PACKET_ACTION,
+      stub_l2mc_entry_attr_set, (void*)SAI_L2MC_ENTRY_ATTR_PACKET_ACTION },
+    { SAI_L2MC_ENTRY_ATTR_OUTPUT_GROUP_ID,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_l2mc_entry_attr_get, (void*)SAI_L2MC_ENTRY_ATTR_OUTPUT_GROUP_ID,
+      stub_l2mc_entry_attr_set, (void*)SAI_L2MC_ENTRY_ATTR_OUTPUT_GROUP_ID },
+};
+
+static const sai_vendor_attribute_entry_t mcast_fdb_entry_vendor_attribs[] = {
+    { SAI_MCAST_FDB_ENTRY_ATTR_GROUP_ID,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_mcast_fdb_entry_attr_get, (void*)SAI_MCAST_FDB_ENTRY_ATTR_GROUP_ID,
+      NULL, NULL },
+    { SAI_MCAST_FDB_ENTRY_ATTR_PACKET_ACTION,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_mcast_fdb_entry_attr_get, (void*)SAI_MCAST_FDB_ENTRY_ATTR_PACKET_ACTION,
+      NULL, NULL },
+    { SAI_MCAST_FDB_ENTRY_ATTR_META_DATA,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_mcast_fdb_entry_attr_get, (void*)SAI_MCAST_FDB_ENTRY_ATTR_META_DATA,
+      stub_mcast_fdb_entry_attr_set, (void*)SAI_MCAST_FDB_ENTRY_ATTR_META_DATA },
+};
+
+/* State DB *************/
+
+/*
+ * A group keeps its outputs as a 64 bit bitmap: one bit per port for L2MC
+ * groups, one bit per output slot for IPMC and RPF groups, whose slots hold
+ * the router interfaces. Members are not stored apart, a member ID is its
+ * group index times MCAST_GROUP_OUTPUTS plus its bit.
+ *
+ * IPMC, L2MC and multicast FDB entries share one hash table, with linear
+ * probing and backward shift removal as for the tunnel termination table.
+ * A packet is looked up as (S,G), then as (*,G); bridged packets without an
+ * L2MC entry are then looked up by destination MAC.
+ *
+ * Replication walks the set bits of the group. Copies reference the packet
+ * buffer, so the bytes are never copied, and the buffer reference count is
+ * raised once per packet for all its copies.
+ */
+#define MAX_MCAST_GROUP_NUMBER  1024
+#define MAX_MCAST_ENTRY_NUMBER  16384
+/* Power of 2, at most half full */
+#define MCAST_ENTRY_HASH_SIZE   (2 * MAX_MCAST_ENTRY_NUMBER)
+#define MCAST_ETHERTYPE_VLAN    0x8100
+#define MCAST_ETHERTYPE_IPV4    0x0800
+#define MCAST_ETHERTYPE_IPV6    0x86DD
+#define MCAST_ETH_HEADER_SIZE   14
+#define MCAST_VLAN_TAG_SIZE     4
+#define MCAST_IPV4_HEADER_SIZE  20
+#define MCAST_IPV6_HEADER_SIZE  40
+#define MCAST_VLAN_MAX          4095
+
+#if PORT_NUMBER > MCAST_GROUP_OUTPUTS
+#error "L2MC group bitmap too small for the ports"
+#endif
+
+typedef enum _stub_mcast_group_kind_t {
+    MCAST_GROUP_RPF,
+    MCAST_GROUP_IPMC,
+    MCAST_GROUP_L2MC,
+    MCAST_GROUP_KINDS
+} stub_mcast_group_kind_t;
+
+/* Entry types, kept in the entry key */
+typedef enum _stub_mcast_entry_type_t {
+    MCAST_ENTRY_IPMC_SG = SAI_IPMC_ENTRY_TYPE_SG,
+    MCAST_ENTRY_IPMC_XG = SAI_IPMC_ENTRY_TYPE_XG,
+    MCAST_ENTRY_L2MC_SG,
+    MCAST_ENTRY_L2MC_XG,
+    MCAST_ENTRY_FDB
+} stub_mcast_entry_type_t;
+
+typedef struct _stub_mcast_group_t {
+    uint64_t        members;
+    /* Port or router interface of each member */
+    sai_object_id_t outputs[MCAST_GROUP_OUTPUTS];
+    uint32_t        ref_count;
+    bool            is_valid;
+} stub_mcast_group_t;
+
+typedef struct _stub_mcast_kind_t {
+    const char                         *name;
+    sai_object_type_t                   group_type;
+    sai_object_type_t                   member_type;
+    const sai_attribute_entry_t        *group_attribs;
+    const sai_vendor_attribute_entry_t *group_vendor_attribs;
+    const sai_attribute_entry_t        *member_attribs;
+    const sai_vendor_attribute_entry_t *member_vendor_attribs;
+} stub_mcast_kind_t;
+
+/* Hashed and compared as a whole, unused bytes are zero */
+typedef struct _stub_mcast_key_t {
+    /* Virtual router of IPMC entries, VLAN of L2MC and multicast FDB entries */
+    uint32_t domain;
+    uint8_t  type;
+    uint8_t  family;
+    uint8_t  reserved[2];
+    /* Group address, MAC address of multicast FDB entries */
+    uint8_t  dst[16];
+    uint8_t  src[16];
+} stub_mcast_key_t;
+
+typedef struct _stub_mcast_entry_t {
+    stub_mcast_key_t    key;
+    sai_packet_action_t action;
+    /* From the packet action */
+    bool                replicate;
+    bool                to_cpu;
+    sai_object_id_t     group;
+    uint32_t            group_db_id;
+    sai_object_id_t     rpf_group;
+    uint32_t            rpf_group_db_id;
+    uint32_t            meta_data;
+    bool                is_valid;
+} stub_mcast_entry_t;
+
+typedef struct _stub_mcast_slot_t {
+    uint32_t hash;
+    /* Entry index plus one, 0 for a free slot */
+    uint32_t index;
+} stub_mcast_slot_t;
+
+static const stub_mcast_kind_t mcast_kinds[MCAST_GROUP_KINDS] = {
+    { "RPF group", SAI_OBJECT_TYPE_RPF_GROUP, SAI_OBJECT_TYPE_RPF_GROUP_MEMBER,
+      rpf_group_attribs, rpf_group_vendor_attribs, rpf_group_member_attribs, rpf_group_member_vendor_attribs },
+    { "IPMC group", SAI_OBJECT_TYPE_IPMC_GROUP, SAI_OBJECT_TYPE_IPMC_GROUP_MEMBER,
+      ipmc_group_attribs, ipmc_group_vendor_attribs, ipmc_group_member_attribs, ipmc_group_member_vendor_attribs },
+    { "L2MC group", SAI_OBJECT_TYPE_L2MC_GROUP, SAI_OBJECT_TYPE_L2MC_GROUP_MEMBER,
+      l2mc_group_attribs, l2mc_group_vendor_attribs, l2mc_group_member_attribs, l2mc_group_member_vendor_attribs },
+};
+
+static stub_mcast_group_t mcast_group_db[MCAST_GROUP_KINDS][MAX_MCAST_GROUP_NUMBER];
+static stub_mcast_entry_t mcast_entry_db[MAX_MCAST_ENTRY_NUMBER];
+static stub_mcast_slot_t  mcast_entry_hash[MCAST_ENTRY_HASH_SIZE];
+/* No free entry below this index */
+static uint32_t           mcast_entry_free_hint;
+
+static sai_status_t db_get_mcast_group(_In_ stub_mcast_group_kind_t kind,
+                                       _In_ uint32_t                group_id,
+                                       _Out_ stub_mcast_group_t   **group)
+{
+    if ((group_id >= MAX_MCAST_GROUP_NUMBER) || (!mcast_group_db[kind][group_id].is_valid)) {
+        STUB_LOG_ERR("Invalid %s ID %u\n", mcast_kinds[kind].name, group_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *group = &mcast_group_db[kind][group_id];
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t db_find_free_mcast_group_index(_In_ stub_mcast_group_kind_t kind, _Out_ uint32_t *free_index)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < MAX_MCAST_GROUP_NUMBER; ii++) {
+        if (false == mcast_group_db[kind][ii].is_valid) {
+            *free_index = ii;
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+
+    STUB_LOG_ERR("%s table full\n", mcast_kinds[kind].name);
+    return SAI_STATUS_TABLE_FULL;
+}
+
+/* Group and bit of a member */
+static sai_status_t db_get_mcast_member(_In_ stub_mcast_group_kind_t kind,
+                                        _In_ uint32_t                member_id,
+                                        _Out_ stub_mcast_group_t   **group,
+                                        _Out_ uint32_t              *bit)
+{
+    *bit = member_id % MCAST_GROUP_OUTPUTS;
+
+    if ((SAI_STATUS_SUCCESS != db_get_mcast_group(kind, member_id / MCAST_GROUP_OUTPUTS, group)) ||
+        (0 == ((*group)->members & (1ULL << *bit)))) {
+        STUB_LOG_ERR("Invalid %s member ID %u\n", mcast_kinds[kind].name, member_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t db_find_free_mcast_entry_index(_Out_ uint32_t *free_index)
+{
+    uint32_t ii;
+
+    for (ii = mcast_entry_free_hint; ii < MAX_MCAST_ENTRY_NUMBER; ii++) {
+        if (false == mcast_entry_db[ii].is_valid) {
+            *free_index           = ii;
+            mcast_entry_free_hint = ii + 1;
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+
+    STUB_LOG_ERR("Multicast entry table full\n");
+    return SAI_STATUS_TABLE_FULL;
+}
+
+static uint16_t mcast_get16(_In_ const uint8_t *p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static uint32_t mcast_key_hash(_In_ const stub_mcast_key_t *key)
+{
+    uint64_t words[sizeof(*key) / sizeof(uint64_t)];
+    uint64_t hash = 0;
+    uint32_t ii;
+
+    memcpy(words, key, sizeof(words));
+    for (ii = 0; ii < sizeof(words) / sizeof(words[0]); ii++) {
+        hash  = (hash ^ words[ii]) * 0x9E3779B97F4A7C15ULL;
+        hash ^= hash >> 29;
+    }
+
+    return (uint32_t)(hash >> 32);
+}
+
+/* Addresses in network order, src is ignored for (*,G) entries */
+static void mcast_key_fill(_Out_ stub_mcast_key_t       *key,
+                           _In_ stub_mcast_entry_type_t  type,
+                           _In_ uint32_t                 domain,
+                           _In_ sai_ip_addr_family_t     family,
+                           _In_ const uint8_t           *dst,
+                           _In_ const uint8_t           *src)
+{
+    uint32_t size = (SAI_IP_ADDR_FAMILY_IPV4 == family) ? sizeof(sai_ip4_t) : sizeof(sai_ip6_t);
+
+    memset(key, 0, sizeof(*key));
+    key->domain = domain;
+    key->type   = type;
+    key->family = family;
+    memcpy(key->dst, dst, size);
+
+    if ((MCAST_ENTRY_IPMC_SG == type) || (MCAST_ENTRY_L2MC_SG == type)) {
+        memcpy(key->src, src, size);
+    }
+}
+
+static const uint8_t* mcast_ip_bytes(_In_ const sai_ip_address_t *ip)
+{
+    return (SAI_IP_ADDR_FAMILY_IPV4 == ip->addr_family) ? (const uint8_t*)&ip->addr.ip4 : ip->addr.ip6;
+}
+
+static bool mcast_ip_is_group(_In_ sai_ip_addr_family_t family, _In_ const uint8_t *dst)
+{
+    return (SAI_IP_ADDR_FAMILY_IPV4 == family) ? (0xE0 == (dst[0] & 0xF0)) : (0xFF == dst[0]);
+}
+
+/* Key of an IPMC or L2MC entry, validating its addresses */
+static sai_status_t mcast_ip_key_fill(_Out_ stub_mcast_key_t       *key,
+                                      _In_ stub_mcast_entry_type_t  type,
+                                      _In_ uint32_t                 domain,
+                                      _In_ const sai_ip_address_t  *destination,
+                                      _In_ const sai_ip_address_t  *source)
+{
+    bool sg = (MCAST_ENTRY_IPMC_SG == type) || (MCAST_ENTRY_L2MC_SG == type);
+
+    if (((SAI_IP_ADDR_FAMILY_IPV4 != destination->addr_family) &&
+         (SAI_IP_ADDR_FAMILY_IPV6 != destination->addr_family)) ||
+        (!mcast_ip_is_group(destination->addr_family, mcast_ip_bytes(destination)))) {
+        STUB_LOG_ERR("Invalid multicast group address\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (sg && (source->addr_family != destination->addr_family)) {
+        STUB_LOG_ERR("Source and group address families differ\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    mcast_key_fill(key, type, domain, destination->addr_family, mcast_ip_bytes(destination),
+                   sg ? mcast_ip_bytes(source) : NULL);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t mcast_ipmc_key_fill(_In_ const sai_ipmc_entry_t *ipmc_entry, _Out_ stub_mcast_key_t *key)
+{
+    sai_status_t status;
+    uint32_t     vr_id;
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(ipmc_entry->vr_id, SAI_OBJECT_TYPE_VIRTUAL_ROUTER, &vr_id))) {
+        return status;
+    }
+
+    if ((SAI_IPMC_ENTRY_TYPE_SG != ipmc_entry->type) && (SAI_IPMC_ENTRY_TYPE_XG != ipmc_entry->type)) {
+        STUB_LOG_ERR("Invalid IPMC entry type %d\n", ipmc_entry->type);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    return mcast_ip_key_fill(key, MCAST_ENTRY_IPMC_SG + ipmc_entry->type, vr_id, &ipmc_entry->destination,
+                             &ipmc_entry->source);
+}
+
+static sai_status_t mcast_l2mc_key_fill(_In_ const sai_l2mc_entry_t *l2mc_entry, _Out_ stub_mcast_key_t *key)
+{
+    if ((0 == l2mc_entry->vlan_id) || (l2mc_entry->vlan_id >= MCAST_VLAN_MAX)) {
+        STUB_LOG_ERR("Invalid VLAN %u\n", l2mc_entry->vlan_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if ((SAI_L2MC_ENTRY_TYPE_SG != l2mc_entry->type) && (SAI_L2MC_ENTRY_TYPE_XG != l2mc_entry->type)) {
+        STUB_LOG_ERR("Invalid L2MC entry type %d\n", l2mc_entry->type);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    return mcast_ip_key_fill(key, MCAST_ENTRY_L2MC_SG + l2mc_entry->type, l2mc_entry->vlan_id,
+                             &l2mc_entry->destination, &l2mc_entry->source);
+}
+
+static sai_status_t mcast_fdb_key_fill(_In_ const sai_mcast_fdb_entry_t *fdb_entry, _Out_ stub_mcast_key_t *key)
+{
+    if ((0 == fdb_entry->vlan_id) || (fdb_entry->vlan_id >= MCAST_VLAN_MAX)) {
+        STUB_LOG_ERR("Invalid VLAN %u\n", fdb_entry->vlan_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (0 == (fdb_entry->mac_address[0] & 1)) {
+        STUB_LOG_ERR("Not a multicast MAC address\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    memset(key, 0, sizeof(*key));
+    key->domain = fdb_entry->vlan_id;
+    key->type   = MCAST_ENTRY_FDB;
+    memcpy(key->dst, fdb_entry->mac_address, sizeof(sai_mac_t));
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static stub_mcast_entry_t* mcast_entry_lookup(_In_ const stub_mcast_key_t *key)
+{
+    const stub_mcast_slot_t *slot;
+    uint32_t                 hash = mcast_key_hash(key), ii;
+
+    for (ii = hash & (MCAST_ENTRY_HASH_SIZE - 1); mcast_entry_hash[ii].index;
+         ii = (ii + 1) & (MCAST_ENTRY_HASH_SIZE - 1)) {
+        slot = &mcast_entry_hash[ii];
+        if ((hash == slot->hash) && (0 == memcmp(&mcast_entry_db[slot->index - 1].key, key, sizeof(*key)))) {
+            return &mcast_entry_db[slot->index - 1];
+        }
+    }
+
+    return NULL;
+}
+
+static sai_status_t mcast_entry_get(_In_ const stub_mcast_key_t *key, _Out_ stub_mcast_entry_t **entry)
+{
+    if (NULL == (*entry = mcast_entry_lookup(key))) {
+        STUB_LOG_ERR("Multicast entry not found\n");
+        return SAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static void mcast_entry_hash_insert(_In_ uint32_t entry_id)
+{
+    uint32_t hash = mcast_key_hash(&mcast_entry_db[entry_id].key);
+    uint32_t ii;
+
+    for (ii = hash & (MCAST_ENTRY_HASH_SIZE - 1); mcast_entry_hash[ii].index;
+         ii = (ii + 1) & (MCAST_ENTRY_HASH_SIZE - 1)) {
+    }
+
+    mcast_entry_hash[ii].hash  = hash;
+    mcast_entry_hash[ii].index = entry_id + 1;
+}
+
+static void mcast_entry_hash_remove(_In_ uint32_t entry_id)
+{
+    const uint32_t mask = MCAST_ENTRY_HASH_SIZE - 1;
+    uint32_t       free, next, home;
+
+    for (free = mcast_key_hash(&mcast_entry_db[entry_id].key) & mask;
+         mcast_entry_hash[free].index != entry_id + 1; free = (free + 1) & mask) {
+        assert(mcast_entry_hash[free].index);
+    }
+
+    /* Move back each following entry of the run whose home slot is not between the hole and itself */
+    for (next = (free + 1) & mask; mcast_entry_hash[next].index; next = (next + 1) & mask) {
+        home = mcast_entry_hash[next].hash & mask;
+        if (((next - home) & mask) >= ((next - free) & mask)) {
+            mcast_entry_hash[free] = mcast_entry_hash[next];
+            free                   = next;
+        }
+    }
+
+    mcast_entry_hash[free].index = 0;
+}
+
+/* Output group kind of an entry */
+static stub_mcast_group_kind_t mcast_entry_group_kind(_In_ const stub_mcast_key_t *key)
+{
+    return (MCAST_ENTRY_IPMC_SG == key->type) || (MCAST_ENTRY_IPMC_XG == key->type) ?
+           MCAST_GROUP_IPMC : MCAST_GROUP_L2MC;
+}
+
+/* Group referenced by an entry, SAI_NULL_OBJECT_ID for none when allowed */
+static sai_status_t mcast_group_ref_check(_In_ stub_mcast_group_kind_t kind,
+                                          _In_ sai_object_id_t         group_id,
+                                          _In_ bool                    allow_null,
+                                          _Out_ uint32_t              *db_id)
+{
+    stub_mcast_group_t *group;
+
+    *db_id = 0;
+    if (allow_null && (SAI_NULL_OBJECT_ID == group_id)) {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    if ((SAI_STATUS_SUCCESS != stub_object_to_type(group_id, mcast_kinds[kind].group_type, db_id)) ||
+        (SAI_STATUS_SUCCESS != db_get_mcast_group(kind, *db_id, &group))) {
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static void mcast_group_ref(_In_ stub_mcast_group_kind_t kind,
+                            _In_ sai_object_id_t         group_id,
+                            _In_ uint32_t                db_id,
+                            _In_ int32_t                 delta)
+{
+    if (SAI_NULL_OBJECT_ID != group_id) {
+        mcast_group_db[kind][db_id].ref_count += delta;
+    }
+}
+
+static sai_status_t mcast_action_apply(_Inout_ stub_mcast_entry_t *entry, _In_ int32_t action)
+{
+    switch (action) {
+    case SAI_PACKET_ACTION_FORWARD:
+    case SAI_PACKET_ACTION_COPY_CANCEL:
+    case SAI_PACKET_ACTION_TRANSIT:
+        entry->replicate = true;
+        entry->to_cpu    = false;
+        break;
+
+    case SAI_PACKET_ACTION_COPY:
+    case SAI_PACKET_ACTION_LOG:
+        entry->replicate = true;
+        entry->to_cpu    = true;
+        break;
+
+    case SAI_PACKET_ACTION_TRAP:
+        entry->replicate = false;
+        entry->to_cpu    = true;
+        break;
+
+    case SAI_PACKET_ACTION_DROP:
+    case SAI_PACKET_ACTION_DENY:
+        entry->replicate = false;
+        entry->to_cpu    = false;
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid packet action %d\n", action);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0;
+    }
+
+    entry->action = action;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t mcast_entry_insert(_In_ const stub_mcast_entry_t *entry)
+{
+    sai_status_t status;
+    uint32_t     db_id;
+
+    if (NULL != mcast_entry_lookup(&entry->key)) {
+        STUB_LOG_ERR("Multicast entry exists\n");
+        return SAI_STATUS_ITEM_ALREADY_EXISTS;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_find_free_mcast_entry_index(&db_id))) {
+        return status;
+    }
+
+    mcast_entry_db[db_id]          = *entry;
+    mcast_entry_db[db_id].is_valid = true;
+    mcast_entry_hash_insert(db_id);
+
+    mcast_group_ref(mcast_entry_group_kind(&entry->key), entry->group, entry->group_db_id, 1);
+    mcast_group_ref(MCAST_GROUP_RPF, entry->rpf_group, entry->rpf_group_db_id, 1);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t mcast_entry_remove(_In_ const stub_mcast_key_t *key)
+{
+    stub_mcast_entry_t *entry;
+    sai_status_t        status;
+    uint32_t            db_id;
+
+    if (SAI_STATUS_SUCCESS != (status = mcast_entry_get(key, &entry))) {
+        return status;
+    }
+
+    db_id = (uint32_t)(entry - mcast_entry_db);
+    mcast_entry_hash_remove(db_id);
+    entry->is_valid = false;
+    if (db_id < mcast_entry_free_hint) {
+        mcast_entry_free_hint = db_id;
+    }
+
+    mcast_group_ref(mcast_entry_group_kind(key), entry->group, entry->group_db_id, -1);
+    mcast_group_ref(MCAST_GROUP_RPF, entry->rpf_group, entry->rpf_group_db_id, -1);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Point an entry to another output or RPF group */
+static sai_status_t mcast_entry_group_set(_Inout_ stub_mcast_entry_t *entry,
+                                          _In_ stub_mcast_group_kind_t kind,
+                                          _In_ sai_object_id_t         group_id)
+{
+    sai_object_id_t *group    = (MCAST_GROUP_RPF == kind) ? &entry->rpf_group : &entry->group;
+    uint32_t        *group_db = (MCAST_GROUP_RPF == kind) ? &entry->rpf_group_db_id : &entry->group_db_id;
+    uint32_t         db_id;
+
+    if (SAI_STATUS_SUCCESS != mcast_group_ref_check(kind, group_id, true, &db_id)) {
+        return SAI_STATUS_INVALID_ATTR_VALUE_0;
+    }
+
+    mcast_group_ref(kind, group_id, db_id, 1);
+    mcast_group_ref(kind, *group, *group_db, -1);
+    *group    = group_id;
+    *group_db = db_id;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Whether a packet received on a router interface passes the RPF check of an entry */
+static bool mcast_rpf_check(_In_ const stub_mcast_entry_t *entry, _In_ sai_object_id_t rif_id)
+{
+    const stub_mcast_group_t *rpf;
+    uint64_t                  members;
+
+    if (SAI_NULL_OBJECT_ID == entry->rpf_group) {
+        return true;
+    }
+
+    rpf     = &mcast_group_db[MCAST_GROUP_RPF][entry->rpf_group_db_id];
+    members = rpf->members;
+    if (0 == members) {
+        return true;
+    }
+
+    for (; members; members &= members - 1) {
+        if (rpf->outputs[__builtin_ctzll(members)] == rif_id) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Copies to the group outputs but the one the packet was received on, referencing buf */
+static uint32_t mcast_group_replicate(_In_ const stub_mcast_group_t *group,
+                                      _In_ sai_object_id_t           skip,
+                                      _In_ stub_mirror_buf_t        *buf,
+                                      _In_ uint32_t                  length,
+                                      _Out_ stub_mcast_copy_t       *copies)
+{
+    uint64_t        members = __atomic_load_n(&group->members, __ATOMIC_ACQUIRE);
+    sai_object_id_t output;
+    uint32_t        count = 0;
+
+    for (; members; members &= members - 1) {
+        output               = group->outputs[__builtin_ctzll(members)];
+        copies[count].buf    = buf;
+        copies[count].length = length;
+        copies[count].output = output;
+        count               += (output != skip);
+    }
+
+    if (0 != count) {
+        __atomic_fetch_add(&buf->ref_count, count, __ATOMIC_RELAXED);
+    }
+
+    return count;
+}
+
+static void mcast_entry_replicate(_In_ const stub_mcast_entry_t *entry,
+                                  _In_ sai_object_id_t           skip,
+                                  _In_ stub_mirror_buf_t        *buf,
+                                  _In_ uint32_t                  length,
+                                  _Out_ stub_mcast_copy_t       *copies,
+                                  _Out_ uint32_t                *count,
+                                  _Out_ bool                    *to_cpu)
+{
+    *to_cpu = entry->to_cpu;
+    *count  = 0;
+
+    if (entry->replicate && (SAI_NULL_OBJECT_ID != entry->group)) {
+        *count = mcast_group_replicate(&mcast_group_db[mcast_entry_group_kind(&entry->key)][entry->group_db_id],
+                                       skip, buf, length, copies);
+    }
+}
+
+/* (S,G) then (*,G) entry of an IP packet */
+static const stub_mcast_entry_t* mcast_ip_lookup(_In_ stub_mcast_entry_type_t type_sg,
+                                                 _In_ uint32_t                domain,
+                                                 _In_ const uint8_t          *ip,
+                                                 _In_ uint32_t                length)
+{
+    const stub_mcast_entry_t *entry;
+    stub_mcast_key_t          key;
+    sai_ip_addr_family_t      family;
+    const uint8_t            *dst, *src;
+
+    if ((length >= MCAST_IPV4_HEADER_SIZE) && (4 == (ip[0] >> 4))) {
+        family = SAI_IP_ADDR_FAMILY_IPV4;
+        src    = ip + 12;
+        dst    = ip + 16;
+    } else if ((length >= MCAST_IPV6_HEADER_SIZE) && (6 == (ip[0] >> 4))) {
+        family = SAI_IP_ADDR_FAMILY_IPV6;
+        src    = ip + 8;
+        dst    = ip + 24;
+    } else {
+        return NULL;
+    }
+
+    if (!mcast_ip_is_group(family, dst)) {
+        return NULL;
+    }
+
+    mcast_key_fill(&key, type_sg, domain, family, dst, src);
+    if (NULL != (entry = mcast_entry_lookup(&key))) {
+        return entry;
+    }
+
+    mcast_key_fill(&key, type_sg + 1, domain, family, dst, NULL);
+    return mcast_entry_lookup(&key);
+}
+
+static sai_status_t mcast_replicate_check(_In_ const stub_mirror_buf_t *buf, _In_ uint32_t offset, _In_ uint32_t length)
+{
+    if (NULL == buf) {
+        STUB_LOG_ERR("NULL packet buffer\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if ((length > buf->length) || (offset > length)) {
+        STUB_LOG_ERR("Packet length %u offset %u over buffer length %u\n", length, offset, buf->length);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Route a multicast packet received on a router interface. The IP header
+ * starts at offset in buf. copies must hold MCAST_GROUP_OUTPUTS copies, one
+ * per router interface of the output group but the receiving one, each
+ * holding a reference on buf until released.
+ */
+sai_status_t db_ipmc_replicate(_In_ sai_object_id_t        vr_id,
+                               _In_ sai_object_id_t        rif_id,
+                               _In_ stub_mirror_buf_t     *buf,
+                               _In_ uint32_t               offset,
+                               _In_ uint32_t               length,
+                               _Out_ stub_mcast_copy_t    *copies,
+                               _Out_ uint32_t             *count,
+                               _Out_ stub_mcast_verdict_t *verdict,
+                               _Out_ bool                 *to_cpu)
+{
+    const stub_mcast_entry_t *entry;
+    sai_status_t              status;
+    uint32_t                  vr;
+
+    if (SAI_STATUS_SUCCESS != (status = mcast_replicate_check(buf, offset, length))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(vr_id, SAI_OBJECT_TYPE_VIRTUAL_ROUTER, &vr))) {
+        return status;
+    }
+
+    *count  = 0;
+    *to_cpu = false;
+
+    if (NULL == (entry = mcast_ip_lookup(MCAST_ENTRY_IPMC_SG, vr, buf->data + offset, length - offset))) {
+        *verdict = STUB_MCAST_MISS;
+        return SAI_STATUS_SUCCESS;
+    }
+
+    if (!mcast_rpf_check(entry, rif_id)) {
+        *verdict = STUB_MCAST_RPF_FAIL;
+        return SAI_STATUS_SUCCESS;
+    }
+
+    *verdict = STUB_MCAST_HIT;
+    mcast_entry_replicate(entry, rif_id, buf, length, copies, count, to_cpu);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Bridge a multicast frame received on a port in a VLAN, by its L2MC entry
+ * for IP multicast, else by its multicast FDB entry. copies must hold
+ * MCAST_GROUP_OUTPUTS copies, one per port of the output group but the
+ * receiving one, each holding a reference on buf until released.
+ */
+sai_status_t db_l2mc_replicate(_In_ sai_vlan_id_t          vlan_id,
+                               _In_ uint32_t               port_id,
+                               _In_ stub_mirror_buf_t     *buf,
+                               _In_ uint32_t               length,
+                               _Out_ stub_mcast_copy_t    *copies,
+                               _Out_ uint32_t             *count,
+                               _Out_ stub_mcast_verdict_t *verdict,
+                               _Out_ bool                 *to_cpu)
+{
+    const stub_mcast_entry_t *entry = NULL;
+    stub_mcast_key_t          key;
+    sai_object_id_t           port;
+    sai_status_t              status;
+    uint32_t                  l3 = MCAST_ETH_HEADER_SIZE;
+    uint16_t                  ethertype;
+
+    if (SAI_STATUS_SUCCESS != (status = mcast_replicate_check(buf, 0, length))) {
+        return status;
+    }
+
+    if (port_id >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid port %u\n", port_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *count   = 0;
+    *to_cpu  = false;
+    *verdict = STUB_MCAST_MISS;
+
+    if ((length < MCAST_ETH_HEADER_SIZE) || (0 == (buf->data[0] & 1))) {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    ethertype = mcast_get16(buf->data + 12);
+    if ((MCAST_ETHERTYPE_VLAN == ethertype) && (length >= MCAST_ETH_HEADER_SIZE + MCAST_VLAN_TAG_SIZE)) {
+        ethertype = mcast_get16(buf->data + 16);
+        l3       += MCAST_VLAN_TAG_SIZE;
+    }
+
+    if ((MCAST_ETHERTYPE_IPV4 == ethertype) || (MCAST_ETHERTYPE_IPV6 == ethertype)) {
+        entry = mcast_ip_lookup(MCAST_ENTRY_L2MC_SG, vlan_id, buf->data + l3, length - l3);
+    }
+
+    if (NULL == entry) {
+        memset(&key, 0, sizeof(key));
+        key.domain = vlan_id;
+        key.type   = MCAST_ENTRY_FDB;
+        memcpy(key.dst, buf->data, sizeof(sai_mac_t));
+        if (NULL == (entry = mcast_entry_lookup(&key))) {
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = stub_create_object(SAI_OBJECT_TYPE_PORT, port_id, &port))) {
+        return status;
+    }
+
+    *verdict = STUB_MCAST_HIT;
+    mcast_entry_replicate(entry, port, buf, length, copies, count, to_cpu);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*************************/
+
+static void mcast_group_key_to_str(_In_ stub_mcast_group_kind_t kind,
+                                   _In_ sai_object_id_t         group_id,
+                                   _Out_ char                  *key_str)
+{
+    uint32_t groupid;
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(group_id, mcast_kinds[kind].group_type, &groupid)) {
+        snprintf(key_str, MAX_KEY_STR_LEN, "invalid %s", mcast_kinds[kind].name);
+    } else {
+        snprintf(key_str, MAX_KEY_STR_LEN, "%s %u", mcast_kinds[kind].name, groupid);
+    }
+}
+
+static void mcast_member_key_to_str(_In_ stub_mcast_group_kind_t kind,
+                                    _In_ sai_object_id_t         member_id,
+                                    _Out_ char                  *key_str)
+{
+    uint32_t memberid;
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(member_id, mcast_kinds[kind].member_type, &memberid)) {
+        snprintf(key_str, MAX_KEY_STR_LEN, "invalid %s member", mcast_kinds[kind].name);
+    } else {
+        snprintf(key_str, MAX_KEY_STR_LEN, "%s %u member %u", mcast_kinds[kind].name,
+                 memberid / MCAST_GROUP_OUTPUTS, memberid % MCAST_GROUP_OUTPUTS);
+    }
+}
+
+static void mcast_ip_entry_key_to_str(_In_ const char             *name,
+                                      _In_ uint32_t                domain,
+                                      _In_ bool                    sg,
+                                      _In_ const sai_ip_address_t *destination,
+                                      _In_ const sai_ip_address_t *source,
+                                      _Out_ char                  *key_str)
+{
+    int pos, res = 0;
+
+    pos = snprintf(key_str, MAX_KEY_STR_LEN, "%s %u (", name, domain);
+    if (sg) {
+        sai_ipaddr_to_str(*source, MAX_KEY_STR_LEN - pos, key_str + pos, &res);
+        pos += res;
+    } else {
+        pos += snprintf(key_str + pos, MAX_KEY_STR_LEN - pos, "*");
+    }
+    if (pos >= MAX_KEY_STR_LEN) {
+        return;
+    }
+    pos += snprintf(key_str + pos, MAX_KEY_STR_LEN - pos, ",");
+    if (pos >= MAX_KEY_STR_LEN) {
+        return;
+    }
+    sai_ipaddr_to_str(*destination, MAX_KEY_STR_LEN - pos, key_str + pos, &res);
+    pos += res;
+    if (pos >= MAX_KEY_STR_LEN) {
+        return;
+    }
+    snprintf(key_str + pos, MAX_KEY_STR_LEN - pos, ")");
+}
+
+static void ipmc_entry_key_to_str(_In_ const sai_ipmc_entry_t *ipmc_entry, _Out_ char *key_str)
+{
+    uint32_t vr_id;
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(ipmc_entry->vr_id, SAI_OBJECT_TYPE_VIRTUAL_ROUTER, &vr_id)) {
+        snprintf(key_str, MAX_KEY_STR_LEN, "IPMC entry invalid virtual router");
+        return;
+    }
+
+    mcast_ip_entry_key_to_str("IPMC entry vr", vr_id, SAI_IPMC_ENTRY_TYPE_SG == ipmc_entry->type,
+                              &ipmc_entry->destination, &ipmc_entry->source, key_str);
+}
+
+static void l2mc_entry_key_to_str(_In_ const sai_l2mc_entry_t *l2mc_entry, _Out_ char *key_str)
+{
+    mcast_ip_entry_key_to_str("L2MC entry vlan", l2mc_entry->vlan_id, SAI_L2MC_ENTRY_TYPE_SG == l2mc_entry->type,
+                              &l2mc_entry->destination, &l2mc_entry->source, key_str);
+}
+
+static void mcast_fdb_entry_key_to_str(_In_ const sai_mcast_fdb_entry_t *fdb_entry, _Out_ char *key_str)
+{
+    snprintf(key_str, MAX_KEY_STR_LEN, "multicast fdb entry mac [%02x:%02x:%02x:%02x:%02x:%02x] vlan %u",
+             fdb_entry->mac_address[0],
+             fdb_entry->mac_address[1],
+             fdb_entry->mac_address[2],
+             fdb_entry->mac_address[3],
+             fdb_entry->mac_address[4],
+             fdb_entry->mac_address[5],
+             fdb_entry->vlan_id);
+}
+
+static sai_status_t mcast_group_create(_In_ stub_mcast_group_kind_t kind,
+                                       _Out_ sai_object_id_t       *group_id,
+                                       _In_ uint32_t                attr_count,
+                                       _In_ const sai_attribute_t  *attr_list)
+{
+    const stub_mcast_kind_t *info = &mcast_kinds[kind];
+    sai_status_t             status;
+    uint32_t                 db_id;
+    char                     list_str[MAX_LIST_VALUE_STR_LEN];
+    char                     key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == group_id) {
+        STUB_LOG_ERR("NULL %s id param\n", info->name);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = check_attribs_metadata(attr_count, attr_list, info->group_attribs, info->group_vendor_attribs,
+                                         SAI_OPERATION_CREATE))) {
+        STUB_LOG_ERR("Failed attribs check\n");
+        return status;
+    }
+
+    sai_attr_list_to_str(attr_count, attr_list, info->group_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create %s, %s\n", info->name, list_str);
+
+    if (SAI_STATUS_SUCCESS != (status = db_find_free_mcast_group_index(kind, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = stub_create_object(info->group_type, db_id, group_id))) {
+        return status;
+    }
+
+    memset(&mcast_group_db[kind][db_id], 0, sizeof(mcast_group_db[kind][db_id]));
+    mcast_group_db[kind][db_id].is_valid = true;
+
+    mcast_group_key_to_str(kind, *group_id, key_str);
+    STUB_LOG_NTC("Created %s\n", key_str);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t mcast_group_remove(_In_ stub_mcast_group_kind_t kind, _In_ sai_object_id_t group_id)
+{
+    stub_mcast_group_t *group;
+    char                key_str[MAX_KEY_STR_LEN];
+    sai_status_t        status;
+    uint32_t            db_id;
+
+    STUB_LOG_ENTER();
+
+    mcast_group_key_to_str(kind, group_id, key_str);
+    STUB_LOG_NTC("Remove %s\n", key_str);
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(group_id, mcast_kinds[kind].group_type, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_mcast_group(kind, db_id, &group))) {
+        return status;
+    }
+
+    if (0 != group->members) {
+        STUB_LOG_ERR("%s %u has %u members\n", mcast_kinds[kind].name, db_id, __builtin_popcountll(group->members));
+        return SAI_STATUS_OBJECT_IN_USE;
+    }
+
+    if (group->ref_count > 0) {
+        STUB_LOG_ERR("%s %u is used by %u entries\n", mcast_kinds[kind].name, db_id, group->ref_count);
+        return SAI_STATUS_OBJECT_IN_USE;
+    }
+
+    group->is_valid = false;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Kind of a group or member object */
+static sai_status_t mcast_kind_of(_In_ sai_object_id_t          object_id,
+                                  _In_ bool                     member,
+                                  _Out_ stub_mcast_group_kind_t *kind,
+                                  _Out_ uint32_t               *db_id)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < MCAST_GROUP_KINDS; ii++) {
+        if (SAI_STATUS_SUCCESS ==
+            stub_object_to_type(object_id, member ? mcast_kinds[ii].member_type : mcast_kinds[ii].group_type,
+                                db_id)) {
+            *kind = ii;
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+
+    STUB_LOG_ERR("Not a multicast group%s\n", member ? " member" : "");
+    return SAI_STATUS_INVALID_PARAMETER;
+}
+
+/* Group attributes, of any group kind */
+sai_status_t stub_mcast_group_attr_get(_In_ const sai_object_key_t   *key,
+                                       _Inout_ sai_attribute_value_t *value,
+                                       _In_ uint32_t                  attr_index,
+                                       _Inout_ vendor_cache_t        *cache,
+                                       void                          *arg)
+{
+    stub_mcast_group_kind_t kind;
+    stub_mcast_group_t     *group;
+    sai_status_t            status;
+    sai_object_id_t         members[MCAST_GROUP_OUTPUTS];
+    uint64_t                bits;
+    uint32_t                db_id, count = 0;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = mcast_kind_of(key->object_id, false, &kind, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_mcast_group(kind, db_id, &group))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case MCAST_GROUP_ATTR_COUNT:
+        value->u32 = __builtin_popcountll(group->members);
+        break;
+
+    case MCAST_GROUP_ATTR_MEMBER_LIST:
+        for (bits = group->members; bits; bits &= bits - 1) {
+            if (SAI_STATUS_SUCCESS !=
+                (status = stub_create_object(mcast_kinds[kind].member_type,
+                                             db_id * MCAST_GROUP_OUTPUTS + __builtin_ctzll(bits),
+                                             &members[count++]))) {
+                return status;
+            }
+        }
+        status = stub_fill_objlist(members, count, &value->objlist);
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid %s attribute %d\n", mcast_kinds[kind].name, (int)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return status;
+}
+
+static sai_status_t mcast_member_create(_In_ stub_mcast_group_kind_t kind,
+                                        _Out_ sai_object_id_t       *member_id,
+                                        _In_ uint32_t                attr_count,
+                                        _In_ const sai_attribute_t  *attr_list,
+                                        _In_ sai_attr_id_t           group_attr,
+                                        _In_ sai_attr_id_t           output_attr)
+{
+    const stub_mcast_kind_t     *info = &mcast_kinds[kind];
+    stub_mcast_group_t          *group;
+    sai_status_t                 status;
+    const sai_attribute_value_t *group_id, *output;
+    uint32_t                     group_index, output_index, db_id, output_db_id, bit;
+    uint64_t                     bits;
+    char                         list_str[MAX_LIST_VALUE_STR_LEN];
+    char                         key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == member_id) {
+        STUB_LOG_ERR("NULL %s member id param\n", info->name);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = check_attribs_metadata(attr_count, attr_list, info->member_attribs, info->member_vendor_attribs,
+                                         SAI_OPERATION_CREATE))) {
+        STUB_LOG_ERR("Failed attribs check\n");
+        return status;
+    }
+
+    sai_attr_list_to_str(attr_count, attr_list, info->member_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create %s member, %s\n", info->name, list_str);
+
+    assert(SAI_STATUS_SUCCESS == find_attrib_in_list(attr_count, attr_list, group_attr, &group_id, &group_index));
+    assert(SAI_STATUS_SUCCESS == find_attrib_in_list(attr_count, attr_list, output_attr, &output, &output_index));
+
+    if ((SAI_STATUS_SUCCESS != stub_object_to_type(group_id->oid, info->group_type, &db_id)) ||
+        (SAI_STATUS_SUCCESS != db_get_mcast_group(kind, db_id, &group))) {
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + group_index;
+    }
+
+    if (MCAST_GROUP_L2MC == kind) {
+        if (SAI_STATUS_SUCCESS != stub_object_to_type(output->oid, SAI_OBJECT_TYPE_PORT, &output_db_id)) {
+            if ((SAI_STATUS_SUCCESS == stub_object_to_type(output->oid, SAI_OBJECT_TYPE_LAG, &output_db_id)) ||
+                (SAI_STATUS_SUCCESS == stub_object_to_type(output->oid, SAI_OBJECT_TYPE_TUNNEL, &output_db_id))) {
+                STUB_LOG_ERR("L2MC group member on a LAG or tunnel not supported\n");
+                return SAI_STATUS_ATTR_NOT_SUPPORTED_0 + output_index;
+            }
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + output_index;
+        }
+        if (output_db_id >= PORT_NUMBER) {
+            STUB_LOG_ERR("Invalid port %u\n", output_db_id);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + output_index;
+        }
+        bit = output_db_id;
+        if (group->members & (1ULL << bit)) {
+            STUB_LOG_ERR("Port %u already in %s %u\n", bit, info->name, db_id);
+            return SAI_STATUS_ITEM_ALREADY_EXISTS;
+        }
+    } else {
+        if (SAI_STATUS_SUCCESS != stub_object_to_type(output->oid, SAI_OBJECT_TYPE_ROUTER_INTERFACE, &output_db_id)) {
+            if ((MCAST_GROUP_IPMC == kind) &&
+                (SAI_STATUS_SUCCESS == stub_object_to_type(output->oid, SAI_OBJECT_TYPE_TUNNEL, &output_db_id))) {
+                STUB_LOG_ERR("IPMC group member on a tunnel not supported\n");
+                return SAI_STATUS_ATTR_NOT_SUPPORTED_0 + output_index;
+            }
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + output_index;
+        }
+        for (bits = group->members; bits; bits &= bits - 1) {
+            if (group->outputs[__builtin_ctzll(bits)] == output->oid) {
+                STUB_LOG_ERR("Router interface already in %s %u\n", info->name, db_id);
+                return SAI_STATUS_ITEM_ALREADY_EXISTS;
+            }
+        }
+        if (UINT64_MAX == group->members) {
+            STUB_LOG_ERR("%s %u full\n", info->name, db_id);
+            return SAI_STATUS_TABLE_FULL;
+        }
+        bit = __builtin_ctzll(~group->members);
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_create_object(info->member_type, db_id * MCAST_GROUP_OUTPUTS + bit, member_id))) {
+        return status;
+    }
+
+    /* Output before its bit, for replication reading the group meanwhile */
+    group->outputs[bit] = output->oid;
+    __atomic_or_fetch(&group->members, 1ULL << bit, __ATOMIC_RELEASE);
+
+    mcast_member_key_to_str(kind, *member_id, key_str);
+    STUB_LOG_NTC("Created %s\n", key_str);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t mcast_member_remove(_In_ stub_mcast_group_kind_t kind, _In_ sai_object_id_t member_id)
+{
+    stub_mcast_group_t *group;
+    char                key_str[MAX_KEY_STR_LEN];
+    sai_status_t        status;
+    uint32_t            db_id, bit;
+
+    STUB_LOG_ENTER();
+
+    mcast_member_key_to_str(kind, member_id, key_str);
+    STUB_LOG_NTC("Remove %s\n", key_str);
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(member_id, mcast_kinds[kind].member_type, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_mcast_member(kind, db_id, &group, &bit))) {
+        return status;
+    }
+
+    __atomic_and_fetch(&group->members, ~(1ULL << bit), __ATOMIC_RELEASE);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Member attributes, of any group kind */
+sai_status_t stub_mcast_member_attr_get(_In_ const sai_object_key_t   *key,
+                                        _Inout_ sai_attribute_value_t *value,
+                                        _In_ uint32_t                  attr_index,
+                                        _Inout_ vendor_cache_t        *cache,
+                                        void                          *arg)
+{
+    stub_mcast_group_kind_t kind;
+    stub_mcast_group_t     *group;
+    sai_status_t            status;
+    uint32_t                db_id, bit;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = mcast_kind_of(key->object_id, true, &kind, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_mcast_member(kind, db_id, &group, &bit))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case MCAST_MEMBER_ATTR_GROUP_ID:
+        status = stub_create_object(mcast_kinds[kind].group_type, db_id / MCAST_GROUP_OUTPUTS, &value->oid);
+        break;
+
+    case MCAST_MEMBER_ATTR_OUTPUT_ID:
+        value->oid = group->outputs[bit];
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid %s member attribute %d\n", mcast_kinds[kind].name, (int)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return status;
+}
+
+/*
+ * Routine Description:
+ *    Create RPF group.
+ *
+ * Arguments:
+ *    [out] rpf_group_id - RPF group id
+ *    [in] switch_id - switch id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_rpf_group(_Out_ sai_object_id_t      *rpf_group_id,
+                                   _In_ sai_object_id_t        switch_id,
+                                   _In_ uint32_t               attr_count,
+                                   _In_ const sai_attribute_t *attr_list)
+{
+    return mcast_group_create(MCAST_GROUP_RPF, rpf_group_id, attr_count, attr_list);
+}
+
+/*
+ * Routine Description:
+ *    Remove RPF group.
+ *
+ * Arguments:
+ *    [in] rpf_group_id - RPF group id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_rpf_group(_In_ sai_object_id_t rpf_group_id)
+{
+    return mcast_group_remove(MCAST_GROUP_RPF, rpf_group_id);
+}
+
+/*
+ * Routine Description:
+ *    Set RPF group attribute.
+ *
+ * Arguments:
+ *    [in] rpf_group_id - RPF group id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_rpf_group_attribute(_In_ sai_object_id_t rpf_group_id, _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = rpf_group_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    mcast_group_key_to_str(MCAST_GROUP_RPF, rpf_group_id, key_str);
+    return sai_set_attribute(&key, key_str, rpf_group_attribs, rpf_group_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get RPF group attributes.
+ *
+ * Arguments:
+ *    [in] rpf_group_id - RPF group id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_rpf_group_attribute(_In_ sai_object_id_t     rpf_group_id,
+                                          _In_ uint32_t            attr_count,
+                                          _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = rpf_group_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    mcast_group_key_to_str(MCAST_GROUP_RPF, rpf_group_id, key_str);
+    return sai_get_attributes(&key, key_str, rpf_group_attribs, rpf_group_vendor_attribs, attr_count, attr_list);
+}
+
+/*
+ * Routine Description:
+ *    Create RPF group member.
+ *
+ * Arguments:
+ *    [out] rpf_group_member_id - RPF group member id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_rpf_group_member(_Out_ sai_object_id_t      *rpf_group_member_id,
+                                          _In_ uint32_t               attr_count,
+                                          _In_ const sai_attribute_t *attr_list)
+{
+    return mcast_member_create(MCAST_GROUP_RPF, rpf_group_member_id, attr_count, attr_list,
+                               SAI_RPF_GROUP_MEMBER_ATTR_RPF_GROUP_ID, SAI_RPF_GROUP_MEMBER_ATTR_RPF_INTERFACE_ID);
+}
+
+/*
+ * Routine Description:
+ *    Remove RPF group member.
+ *
+ * Arguments:
+ *    [in] rpf_group_member_id - RPF group member id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_rpf_group_member(_In_ sai_object_id_t rpf_group_member_id)
+{
+    return mcast_member_remove(MCAST_GROUP_RPF, rpf_group_member_id);
+}
+
+/*
+ * Routine Description:
+ *    Set RPF group member attribute.
+ *
+ * Arguments:
+ *    [in] rpf_group_member_id - RPF group member id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_rpf_group_member_attribute(_In_ sai_object_id_t        rpf_group_member_id,
+                                                 _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = rpf_group_member_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    mcast_member_key_to_str(MCAST_GROUP_RPF, rpf_group_member_id, key_str);
+    return sai_set_attribute(&key, key_str, rpf_group_member_attribs, rpf_group_member_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get RPF group member attributes.
+ *
+ * Arguments:
+ *    [in] rpf_group_member_id - RPF group member id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_rpf_group_member_attribute(_In_ sai_object_id_t     rpf_group_member_id,
+                                                 _In_ uint32_t            attr_count,
+                                                 _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = rpf_group_member_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    mcast_member_key_to_str(MCAST_GROUP_RPF, rpf_group_member_id, key_str);
+    return sai_get_attributes(&key, key_str, rpf_group_member_attribs, rpf_group_member_vendor_attribs,
+                              attr_count, attr_list);
+}
+
+/*
+ * Routine Description:
+ *    Create IPMC group.
+ *
+ * Arguments:
+ *    [out] ipmc_group_id - IPMC group id
+ *    [in] switch_id - switch id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_ipmc_group(_Out_ sai_object_id_t      *ipmc_group_id,
+                                    _In_ sai_object_id_t        switch_id,
+                                    _In_ uint32_t               attr_count,
+                                    _In_ const sai_attribute_t *attr_list)
+{
+    return mcast_group_create(MCAST_GROUP_IPMC, ipmc_group_id, attr_count, attr_list);
+}
+
+/*
+ * Routine Description:
+ *    Remove IPMC group.
+ *
+ * Arguments:
+ *    [in] ipmc_group_id - IPMC group id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_ipmc_group(_In_ sai_object_id_t ipmc_group_id)
+{
+    return mcast_group_remove(MCAST_GROUP_IPMC, ipmc_group_id);
+}
+
+/*
+ * Routine Description:
+ *    Set IPMC group attribute.
+ *
+ * Arguments:
+ *    [in] ipmc_group_id - IPMC group id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_ipmc_group_attribute(_In_ sai_object_id_t ipmc_group_id, _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = ipmc_group_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    mcast_group_key_to_str(MCAST_GROUP_IPMC, ipmc_group_id, key_str);
+    return sai_set_attribute(&key, key_str, ipmc_group_attribs, ipmc_group_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get IPMC group attributes.
+ *
+ * Arguments:
+ *    [in] ipmc_group_id - IPMC group id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_ipmc_group_attribute(_In_ sai_object_id_t     ipmc_group_id,
+                                           _In_ uint32_t            attr_count,
+                                           _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = ipmc_group_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    mcast_group_key_to_str(MCAST_GROUP_IPMC, ipmc_group_id, key_str);
+    return sai_get_attributes(&key, key_str, ipmc_group_attribs, ipmc_group_vendor_attribs, attr_count, attr_list);
+}
+
+/*
+ * Routine Description:
+ *    Create IPMC group member.
+ *
+ * Arguments:
+ *    [out] ipmc_group_member_id - IPMC group member id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_ipmc_group_member(_Out_ sai_object_id_t      *ipmc_group_member_id,
+                                           _In_ uint32_t               attr_count,
+                                           _In_ const sai_attribute_t *attr_list)
+{
+    return mcast_member_create(MCAST_GROUP_IPMC, ipmc_group_member_id, attr_count, attr_list,
+                               SAI_IPMC_GROUP_MEMBER_ATTR_IPMC_GROUP_ID, SAI_IPMC_GROUP_MEMBER_ATTR_IPMC_OUTPUT_ID);
+}
+
+/*
+ * Routine Description:
+ *    Remove IPMC group member.
+ *
+ * Arguments:
+ *    [in] ipmc_group_member_id - IPMC group member id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_ipmc_group_member(_In_ sai_object_id_t ipmc_group_member_id)
+{
+    return mcast_member_remove(MCAST_GROUP_IPMC, ipmc_group_member_id);
+}
+
+/*
+ * Routine Description:
+ *    Set IPMC group member attribute.
+ *
+ * Arguments:
+ *    [in] ipmc_group_member_id - IPMC group member id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_ipmc_group_member_attribute(_In_ sai_object_id_t        ipmc_group_member_id,
+                                                  _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = ipmc_group_member_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    mcast_member_key_to_str(MCAST_GROUP_IPMC, ipmc_group_member_id, key_str);
+    return sai_set_attribute(&key, key_str, ipmc_group_member_attribs, ipmc_group_member_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get IPMC group member attributes.
+ *
+ * Arguments:
+ *    [in] ipmc_group_member_id - IPMC group member id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_ipmc_group_member_attribute(_In_ sai_object_id_t     ipmc_group_member_id,
+                                                  _In_ uint32_t            attr_count,
+                                                  _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = ipmc_group_member_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    mcast_member_key_to_str(MCAST_GROUP_IPMC, ipmc_group_member_id, key_str);
+    return sai_get_attributes(&key, key_str, ipmc_group_member_attribs, ipmc_group_member_vendor_attribs,
+                              attr_count, attr_list);
+}
+
+/*
+ * Routine Description:
+ *    Create L2MC group.
+ *
+ * Arguments:
+ *    [out] l2mc_group_id - L2MC group id
+ *    [in] switch_id - switch id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_l2mc_group(_Out_ sai_object_id_t      *l2mc_group_id,
+                                    _In_ sai_object_id_t        switch_id,
+                                    _In_ uint32_t               attr_count,
+                                    _In_ const sai_attribute_t *attr_list)
+{
+    return mcast_group_create(MCAST_GROUP_L2MC, l2mc_group_id, attr_count, attr_list);
+}
+
+/*
+ * Routine Description:
+ *    Remove L2MC group.
+ *
+ * Arguments:
+ *    [in] l2mc_group_id - L2MC group id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_l2mc_group(_In_ sai_object_id_t l2mc_group_id)
+{
+    return mcast_group_remove(MCAST_GROUP_L2MC, l2mc_group_id);
+}
+
+/*
+ * Routine Description:
+ *    Set L2MC group attribute.
+ *
+ * Arguments:
+ *    [in] l2mc_group_id - L2MC group id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_l2mc_group_attribute(_In_ sai_object_id_t l2mc_group_id, _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = l2mc_group_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    mcast_group_key_to_str(MCAST_GROUP_L2MC, l2mc_group_id, key_str);
+    return sai_set_attribute(&key, key_str, l2mc_group_attribs, l2mc_group_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get L2MC group attributes.
+ *
+ * Arguments:
+ *    [in] l2mc_group_id - L2MC group id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_l2mc_group_attribute(_In_ sai_object_id_t     l2mc_group_id,
+                                           _In_ uint32_t            attr_count,
+                                           _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = l2mc_group_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    mcast_group_key_to_str(MCAST_GROUP_L2MC, l2mc_group_id, key_str);
+    return sai_get_attributes(&key, key_str, l2mc_group_attribs, l2mc_group_vendor_attribs, attr_count, attr_list);
+}
+
+/*
+ * Routine Description:
+ *    Create L2MC group member.
+ *
+ * Arguments:
+ *    [out] l2mc_group_member_id - L2MC group member id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_l2mc_group_member(_Out_ sai_object_id_t      *l2mc_group_member_id,
+                                           _In_ uint32_t               attr_count,
+                                           _In_ const sai_attribute_t *attr_list)
+{
+    return mcast_member_create(MCAST_GROUP_L2MC, l2mc_group_member_id, attr_count, attr_list,
+                               SAI_L2MC_GROUP_MEMBER_ATTR_L2MC_GROUP_ID, SAI_L2MC_GROUP_MEMBER_ATTR_L2MC_OUTPUT_ID);
+}
+
+/*
+ * Routine Description:
+ *    Remove L2MC group member.
+ *
+ * Arguments:
+ *    [in] l2mc_group_member_id - L2MC group member id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_l2mc_group_member(_In_ sai_object_id_t l2mc_group_member_id)
+{
+    return mcast_member_remove(MCAST_GROUP_L2MC, l2mc_group_member_id);
+}
+
+/*
+ * Routine Description:
+ *    Set L2MC group member attribute.
+ *
+ * Arguments:
+ *    [in] l2mc_group_member_id - L2MC group member id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_l2mc_group_member_attribute(_In_ sai_object_id_t        l2mc_group_member_id,
+                                                  _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = l2mc_group_member_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    mcast_member_key_to_str(MCAST_GROUP_L2MC, l2mc_group_member_id, key_str);
+    return sai_set_attribute(&key, key_str, l2mc_group_member_attribs, l2mc_group_member_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get L2MC group member attributes.
+ *
+ * Arguments:
+ *    [in] l2mc_group_member_id - L2MC group member id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_l2mc_group_member_attribute(_In_ sai_object_id_t     l2mc_group_member_id,
+                                                  _In_ uint32_t            attr_count,
+                                                  _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = l2mc_group_member_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    mcast_member_key_to_str(MCAST_GROUP_L2MC, l2mc_group_member_id, key_str);
+    return sai_get_attributes(&key, key_str, l2mc_group_member_attribs, l2mc_group_member_vendor_attribs,
+                              attr_count, attr_list);
+}
+
+/*
+ * Routine Description:
+ *    Create IPMC entry.
+ *
+ * Arguments:
+ *    [in] ipmc_entry - IPMC entry
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_ipmc_entry(_In_ const sai_ipmc_entry_t *ipmc_entry,
+                                    _In_ uint32_t                attr_count,
+                                    _In_ const sai_attribute_t  *attr_list)
+{
+    stub_mcast_entry_t           entry;
+    sai_status_t                 status;
+    const sai_attribute_value_t *action, *group, *rpf_group;
+    uint32_t                     action_index, group_index, rpf_group_index;
+    char                         list_str[MAX_LIST_VALUE_STR_LEN];
+    char                         key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == ipmc_entry) {
+        STUB_LOG_ERR("NULL IPMC entry param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = check_attribs_metadata(attr_count, attr_list, ipmc_entry_attribs, ipmc_entry_vendor_attribs,
+                                         SAI_OPERATION_CREATE))) {
+        STUB_LOG_ERR("Failed attribs check\n");
+        return status;
+    }
+
+    ipmc_entry_key_to_str(ipmc_entry, key_str);
+    sai_attr_list_to_str(attr_count, attr_list, ipmc_entry_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create %s, %s\n", key_str, list_str);
+
+    memset(&entry, 0, sizeof(entry));
+    if (SAI_STATUS_SUCCESS != (status = mcast_ipmc_key_fill(ipmc_entry, &entry.key))) {
+        return status;
+    }
+
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_IPMC_ENTRY_ATTR_PACKET_ACTION, &action, &action_index));
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_IPMC_ENTRY_ATTR_RPF_GROUP_ID, &rpf_group,
+                               &rpf_group_index));
+
+    if (SAI_STATUS_SUCCESS != mcast_action_apply(&entry, action->s32)) {
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + action_index;
+    }
+
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_IPMC_ENTRY_ATTR_OUTPUT_GROUP_ID, &group, &group_index)) {
+        if (SAI_STATUS_SUCCESS != mcast_group_ref_check(MCAST_GROUP_IPMC, group->oid, true, &entry.group_db_id)) {
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + group_index;
+        }
+        entry.group = group->oid;
+    }
+
+    if (SAI_STATUS_SUCCESS != mcast_group_ref_check(MCAST_GROUP_RPF, rpf_group->oid, true, &entry.rpf_group_db_id)) {
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + rpf_group_index;
+    }
+    entry.rpf_group = rpf_group->oid;
+
+    if (SAI_STATUS_SUCCESS != (status = mcast_entry_insert(&entry))) {
+        return status;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Remove IPMC entry.
+ *
+ * Arguments:
+ *    [in] ipmc_entry - IPMC entry
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_ipmc_entry(_In_ const sai_ipmc_entry_t *ipmc_entry)
+{
+    stub_mcast_key_t key;
+    sai_status_t     status;
+    char             key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == ipmc_entry) {
+        STUB_LOG_ERR("NULL IPMC entry param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    ipmc_entry_key_to_str(ipmc_entry, key_str);
+    STUB_LOG_NTC("Remove %s\n", key_str);
+
+    if (SAI_STATUS_SUCCESS != (status = mcast_ipmc_key_fill(ipmc_entry, &key))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = mcast_entry_remove(&key))) {
+        return status;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Set IPMC entry attribute.
+ *
+ * Arguments:
+ *    [in] ipmc_entry - IPMC entry
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_ipmc_entry_attribute(_In_ const sai_ipmc_entry_t *ipmc_entry, _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .ipmc_entry = ipmc_entry };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == ipmc_entry) {
+        STUB_LOG_ERR("NULL IPMC entry param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    ipmc_entry_key_to_str(ipmc_entry, key_str);
+    return sai_set_attribute(&key, key_str, ipmc_entry_attribs, ipmc_entry_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get IPMC entry attributes.
+ *
+ * Arguments:
+ *    [in] ipmc_entry - IPMC entry
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_ipmc_entry_attribute(_In_ const sai_ipmc_entry_t *ipmc_entry,
+                                           _In_ uint32_t                attr_count,
+                                           _Inout_ sai_attribute_t     *attr_list)
+{
+    const sai_object_key_t key = { .ipmc_entry = ipmc_entry };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == ipmc_entry) {
+        STUB_LOG_ERR("NULL IPMC entry param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    ipmc_entry_key_to_str(ipmc_entry, key_str);
+    return sai_get_attributes(&key, key_str, ipmc_entry_attribs, ipmc_entry_vendor_attribs, attr_count, attr_list);
+}
+
+/* IPMC entry attributes */
+sai_status_t stub_ipmc_entry_attr_get(_In_ const sai_object_key_t   *key,
+                                      _Inout_ sai_attribute_value_t *value,
+                                      _In_ uint32_t                  attr_index,
+                                      _Inout_ vendor_cache_t        *cache,
+                                      void                          *arg)
+{
+    stub_mcast_entry_t *entry;
+    stub_mcast_key_t    entry_key;
+    sai_status_t        status;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = mcast_ipmc_key_fill(key->ipmc_entry, &entry_key))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = mcast_entry_get(&entry_key, &entry))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_IPMC_ENTRY_ATTR_PACKET_ACTION:
+        value->s32 = entry->action;
+        break;
+
+    case SAI_IPMC_ENTRY_ATTR_OUTPUT_GROUP_ID:
+        value->oid = entry->group;
+        break;
+
+    case SAI_IPMC_ENTRY_ATTR_RPF_GROUP_ID:
+        value->oid = entry->rpf_group;
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid IPMC entry attribute %d\n", (int)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Packet action [sai_packet_action_t], output group and RPF group [sai_object_id_t] */
+sai_status_t stub_ipmc_entry_attr_set(_In_ const sai_object_key_t      *key,
+                                      _In_ const sai_attribute_value_t *value,
+                                      void                             *arg)
+{
+    stub_mcast_entry_t *entry;
+    stub_mcast_key_t    entry_key;
+    sai_status_t        status;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = mcast_ipmc_key_fill(key->ipmc_entry, &entry_key))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = mcast_entry_get(&entry_key, &entry))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_IPMC_ENTRY_ATTR_PACKET_ACTION:
+        status = mcast_action_apply(entry, value->s32);
+        break;
+
+    case SAI_IPMC_ENTRY_ATTR_OUTPUT_GROUP_ID:
+        status = mcast_entry_group_set(entry, MCAST_GROUP_IPMC, value->oid);
+        break;
+
+    case SAI_IPMC_ENTRY_ATTR_RPF_GROUP_ID:
+        status = mcast_entry_group_set(entry, MCAST_GROUP_RPF, value->oid);
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid IPMC entry attribute %d\n", (int)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return status;
+}
+
+/*
+ * Routine Description:
+ *    Create L2MC entry.
+ *
+ * Arguments:
+ *    [in] l2mc_entry - L2MC entry
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_l2mc_entry(_In_ const sai_l2mc_entry_t *l2mc_entry,
+                                    _In_ uint32_t                attr_count,
+                                    _In_ const sai_attribute_t  *attr_list)
+{
+    stub_mcast_entry_t           entry;
+    sai_status_t                 status;
+    const sai_attribute_value_t *action, *group;
+    uint32_t                     action_index, group_index;
+    char                         list_str[MAX_LIST_VALUE_STR_LEN];
+    char                         key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == l2mc_entry) {
+        STUB_LOG_ERR("NULL L2MC entry param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = check_attribs_metadata(attr_count, attr_list, l2mc_entry_attribs, l2mc_entry_vendor_attribs,
+                                         SAI_OPERATION_CREATE))) {
+        STUB_LOG_ERR("Failed attribs check\n");
+        return status;
+    }
+
+    l2mc_entry_key_to_str(l2mc_entry, key_str);
+    sai_attr_list_to_str(attr_count, attr_list, l2mc_entry_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create %s, %s\n", key_str, list_str);
+
+    memset(&entry, 0, sizeof(entry));
+    if (SAI_STATUS_SUCCESS != (status = mcast_l2mc_key_fill(l2mc_entry, &entry.key))) {
+        return status;
+    }
+
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_L2MC_ENTRY_ATTR_PACKET_ACTION, &action, &action_index));
+
+    if (SAI_STATUS_SUCCESS != mcast_action_apply(&entry, action->s32)) {
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + action_index;
+    }
+
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_L2MC_ENTRY_ATTR_OUTPUT_GROUP_ID, &group, &group_index)) {
+        if (SAI_STATUS_SUCCESS != mcast_group_ref_check(MCAST_GROUP_L2MC, group->oid, true, &entry.group_db_id)) {
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + group_index;
+        }
+        entry.group = group->oid;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = mcast_entry_insert(&entry))) {
+        return status;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Remove L2MC entry.
+ *
+ * Arguments:
+ *    [in] l2mc_entry - L2MC entry
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_l2mc_entry(_In_ const sai_l2mc_entry_t *l2mc_entry)
+{
+    stub_mcast_key_t key;
+    sai_status_t     status;
+    char             key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == l2mc_entry) {
+        STUB_LOG_ERR("NULL L2MC entry param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    l2mc_entry_key_to_str(l2mc_entry, key_str);
+    STUB_LOG_NTC("Remove %s\n", key_str);
+
+    if (SAI_STATUS_SUCCESS != (status = mcast_l2mc_key_fill(l2mc_entry, &key))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = mcast_entry_remove(&key))) {
+        return status;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Set L2MC entry attribute.
+ *
+ * Arguments:
+ *    [in] l2mc_entry - L2MC entry
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_l2mc_entry_attribute(_In_ const sai_l2mc_entry_t *l2mc_entry, _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .l2mc_entry = l2mc_entry };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == l2mc_entry) {
+        STUB_LOG_ERR("NULL L2MC entry param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    l2mc_entry_key_to_str(l2mc_entry, key_str);
+    return sai_set_attribute(&key, key_str, l2mc_entry_attribs, l2mc_entry_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get L2MC entry attributes.
+ *
+ * Arguments:
+ *    [in] l2mc_entry - L2MC entry
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_l2mc_entry_attribute(_In_ const sai_l2mc_entry_t *l2mc_entry,
+                                           _In_ uint32_t                attr_count,
+                                           _Inout_ sai_attribute_t     *attr_list)
+{
+    const sai_object_key_t key = { .l2mc_entry = l2mc_entry };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == l2mc_entry) {
+        STUB_LOG_ERR("NULL L2MC entry param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    l2mc_entry_key_to_str(l2mc_entry, key_str);
+    return sai_get_attributes(&key, key_str, l2mc_entry_attribs, l2mc_entry_vendor_attribs, attr_count, attr_list);
+}
+
+/* L2MC entry attributes */
+sai_status_t stub_l2mc_entry_attr_get(_In_ const sai_object_key_t   *key,
+                                      _Inout_ sai_attribute_value_t *value,
+                                      _In_ uint32_t                  attr_index,
+                                      _Inout_ vendor_cache_t        *cache,
+                                      void                          *arg)
+{
+    stub_mcast_entry_t *entry;
+    stub_mcast_key_t    entry_key;
+    sai_status_t        status;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = mcast_l2mc_key_fill(key->l2mc_entry, &entry_key))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = mcast_entry_get(&entry_key, &entry))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_L2MC_ENTRY_ATTR_PACKET_ACTION:
+        value->s32 = entry->action;
+        break;
+
+    case SAI_L2MC_ENTRY_ATTR_OUTPUT_GROUP_ID:
+        value->oid = entry->group;
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid L2MC entry attribute %d\n", (int)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Packet action [sai_packet_action_t], output group [sai_object_id_t] */
+sai_status_t stub_l2mc_entry_attr_set(_In_ const sai_object_key_t      *key,
+                                      _In_ const sai_attribute_value_t *value,
+                                      void                             *arg)
+{
+    stub_mcast_entry_t *entry;
+    stub_mcast_key_t    entry_key;
+    sai_status_t        status;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = mcast_l2mc_key_fill(key->l2mc_entry, &entry_key))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = mcast_entry_get(&entry_key, &entry))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_L2MC_ENTRY_ATTR_PACKET_ACTION:
+        status = mcast_action_apply(entry, value->s32);
+        break;
+
+    case SAI_L2MC_ENTRY_ATTR_OUTPUT_GROUP_ID:
+        status = mcast_entry_group_set(entry, MCAST_GROUP_L2MC, value->oid);
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid L2MC entry attribute %d\n", (int)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return status;
+}
+
+/*
+ * Routine Description:
+ *    Create multicast FDB entry.
+ *
+ * Arguments:
+ *    [in] fdb_entry - multicast FDB entry
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_mcast_fdb_entry(_In_ const sai_mcast_fdb_entry_t *fdb_entry,
+                                         _In_ uint32_t                     attr_count,
+                                         _In_ const sai_attribute_t       *attr_list)
+{
+    stub_mcast_entry_t           entry;
+    sai_status_t                 status;
+    const sai_attribute_value_t *group, *action, *meta_data;
+    uint32_t                     group_index, action_index, meta_data_index;
+    char                         list_str[MAX_LIST_VALUE_STR_LEN];
+    char                         key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == fdb_entry) {
+        STUB_LOG_ERR("NULL multicast fdb entry param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = check_attribs_metadata(attr_count, attr_list, mcast_fdb_entry_attribs,
+                                         mcast_fdb_entry_vendor_attribs, SAI_OPERATION_CREATE))) {
+        STUB_LOG_ERR("Failed attribs check\n");
+        return status;
+    }
+
+    mcast_fdb_entry_key_to_str(fdb_entry, key_str);
+    sai_attr_list_to_str(attr_count, attr_list, mcast_fdb_entry_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create %s, %s\n", key_str, list_str);
+
+    memset(&entry, 0, sizeof(entry));
+    if (SAI_STATUS_SUCCESS != (status = mcast_fdb_key_fill(fdb_entry, &entry.key))) {
+        return status;
+    }
+
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_MCAST_FDB_ENTRY_ATTR_GROUP_ID, &group, &group_index));
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_MCAST_FDB_ENTRY_ATTR_PACKET_ACTION, &action,
+                               &action_index));
+
+    if (SAI_STATUS_SUCCESS != mcast_group_ref_check(MCAST_GROUP_L2MC, group->oid, false, &entry.group_db_id)) {
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + group_index;
+    }
+    entry.group = group->oid;
+
+    if (SAI_STATUS_SUCCESS != mcast_action_apply(&entry, action->s32)) {
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + action_index;
+    }
+
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_MCAST_FDB_ENTRY_ATTR_META_DATA, &meta_data,
+                            &meta_data_index)) {
+        entry.meta_data = meta_data->u32;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = mcast_entry_insert(&entry))) {
+        return status;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Remove multicast FDB entry.
+ *
+ * Arguments:
+ *    [in] fdb_entry - multicast FDB entry
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_mcast_fdb_entry(_In_ const sai_mcast_fdb_entry_t *fdb_entry)
+{
+    stub_mcast_key_t key;
+    sai_status_t     status;
+    char             key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == fdb_entry) {
+        STUB_LOG_ERR("NULL multicast fdb entry param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    mcast_fdb_entry_key_to_str(fdb_entry, key_str);
+    STUB_LOG_NTC("Remove %s\n", key_str);
+
+    if (SAI_STATUS_SUCCESS != (status = mcast_fdb_key_fill(fdb_entry, &key))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = mcast_entry_remove(&key))) {
+        return status;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Set multicast FDB entry attribute.
+ *
+ * Arguments:
+ *    [in] fdb_entry - multicast FDB entry
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_mcast_fdb_entry_attribute(_In_ const sai_mcast_fdb_entry_t *fdb_entry,
+                                                _In_ const sai_attribute_t       *attr)
+{
+    const sai_object_key_t key = { .mcast_fdb_entry = fdb_entry };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == fdb_entry) {
+        STUB_LOG_ERR("NULL multicast fdb entry param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    mcast_fdb_entry_key_to_str(fdb_entry, key_str);
+    return sai_set_attribute(&key, key_str, mcast_fdb_entry_attribs, mcast_fdb_entry_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get multicast FDB entry attributes.
+ *
+ * Arguments:
+ *    [in] fdb_entry - multicast FDB entry
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_mcast_fdb_entry_attribute(_In_ const sai_mcast_fdb_entry_t *fdb_entry,
+                                                _In_ uint32_t                     attr_count,
+                                                _Inout_ sai_attribute_t          *attr_list)
+{
+    const sai_object_key_t key = { .mcast_fdb_entry = fdb_entry };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == fdb_entry) {
+        STUB_LOG_ERR("NULL multicast fdb entry param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    mcast_fdb_entry_key_to_str(fdb_entry, key_str);
+    return sai_get_attributes(&key, key_str, mcast_fdb_entry_attribs, mcast_fdb_entry_vendor_attribs,
+                              attr_count, attr_list);
+}
+
+/* Multicast FDB entry attributes */
+sai_status_t stub_mcast_fdb_entry_attr_get(_In_ const sai_object_key_t   *key,
+                                           _Inout_ sai_attribute_value_t *value,
+                                           _In_ uint32_t                  attr_index,
+                                           _Inout_ vendor_cache_t        *cache,
+                                           void                          *arg)
+{
+    stub_mcast_entry_t *entry;
+    stub_mcast_key_t    entry_key;
+    sai_status_t        status;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = mcast_fdb_key_fill(key->mcast_fdb_entry, &entry_key))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = mcast_entry_get(&entry_key, &entry))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_MCAST_FDB_ENTRY_ATTR_GROUP_ID:
+        value->oid = entry->group;
+        break;
+
+    case SAI_MCAST_FDB_ENTRY_ATTR_PACKET_ACTION:
+        value->s32 = entry->action;
+        break;
+
+    case SAI_MCAST_FDB_ENTRY_ATTR_META_DATA:
+        value->u32 = entry->meta_data;
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid multicast fdb entry attribute %d\n", (int)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Meta data [uint32_t] */
+sai_status_t stub_mcast_fdb_entry_attr_set(_In_ const sai_object_key_t      *key,
+                                           _In_ const sai_attribute_value_t *value,
+                                           void                             *arg)
+{
+    stub_mcast_entry_t *entry;
+    stub_mcast_key_t    entry_key;
+    sai_status_t        status;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = mcast_fdb_key_fill(key->mcast_fdb_entry, &entry_key))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = mcast_entry_get(&entry_key, &entry))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_MCAST_FDB_ENTRY_ATTR_META_DATA:
+        entry->meta_data = value->u32;
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid multicast fdb entry attribute %d\n", (int)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+const sai_rpf_group_api_t rpf_group_api = {
+    stub_create_rpf_group,
+    stub_remove_rpf_group,
+    stub_set_rpf_group_attribute,
+    stub_get_rpf_group_attribute,
+    stub_create_rpf_group_member,
+    stub_remove_rpf_group_member,
+    stub_set_rpf_group_member_attribute,
+    stub_get_rpf_group_member_attribute
+};
+
+const sai_ipmc_group_api_t ipmc_group_api = {
+    stub_create_ipmc_group,
+    stub_remove_ipmc_group,
+    stub_set_ipmc_group_attribute,
+    stub_get_ipmc_group_attribute,
+    stub_create_ipmc_group_member,
+    stub_remove_ipmc_group_member,
+    stub_set_ipmc_group_member_attribute,
+    stub_get_ipmc_group_member_attribute
+};
+
+const sai_l2mc_group_api_t l2mc_group_api = {
+    stub_create_l2mc_group,
+    stub_remove_l2mc_group,
+    stub_set_l2mc_group_attribute,
+    stub_get_l2mc_group_attribute,
+    stub_create_l2mc_group_member,
+    stub_remove_l2mc_group_member,
+    stub_set_l2mc_group_member_attribute,
+    stub_get_l2mc_group_member_attribute
+};
+
+const sai_ipmc_api_t ipmc_api = {
+    stub_create_ipmc_entry,
+    stub_remove_ipmc_entry,
+    stub_set_ipmc_entry_attribute,
+    stub_get_ipmc_entry_attribute
+};
+
+const sai_l2mc_api_t l2mc_api = {
+    stub_create_l2mc_entry,
+    stub_remove_l2mc_entry,
+    stub_set_l2mc_entry_attribute,
+    stub_get_l2mc_entry_attribute
+};
+
+const sai_mcast_fdb_api_t mcast_fdb_api = {
+    stub_create_mcast_fdb_entry,
+    stub_remove_mcast_fdb_entry,
+    stub_set_mcast_fdb_entry_attribute,
+    stub_get_mcast_fdb_entry_attribute
+};
@@ -0,0 +1,204 @@
+/*
+ *  Copyright (C) 2014. Mellanox Technologies, Ltd. ALL RIGHTS RESERVED.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ */
+
+#include "sai.h"
+#include "stub_sai.h"
+#include "assert.h"
+#include "stdio.h"
+#include "time.h"
+#include "arpa/inet.h"
+
+/*
+ * L2 multicast replication throughput. BENCH_GROUPS L2MC groups get all
+ * BENCH_PORTS ports as members, and one (*,G) entry each on BENCH_VLAN.
+ * Packets go round robin over the groups and ingress ports, so each packet
+ * fans out to all the ports but its ingress one.
+ *
+ * The first run releases every copy, as the egress would. The second one
+ * only resets the packet reference count, measuring lookup and fan out.
+ */
+
+#define BENCH_GROUPS     1023
+#define BENCH_PORTS      64
+#define BENCH_VLAN       10
+#define BENCH_PACKETS    64
+#define BENCH_LENGTH     128
+#define BENCH_ITERATIONS 2000000
+#define BENCH_GROUP_IP   0xe0100000
+#define BENCH_SOURCE_IP  0x01020304
+#define BENCH_IP_OFFSET  14
+
+static const uint8_t bench_mac[6] = { 0x01, 0x00, 0x5e, 0x10, 0x00, 0x00 };
+
+static stub_mirror_buf_t *bench_packets[BENCH_PACKETS];
+static stub_mcast_copy_t  bench_copies[BENCH_PORTS];
+
+#define BENCH_CHECK(x)                                                           \
+    do {                                                                         \
+        if (!(x)) {                                                              \
+            fprintf(stderr, "%s:%d: %s failed\n", __FILE__, __LINE__, #x);       \
+            exit(1);                                                             \
+        }                                                                        \
+    } while (0)
+
+static sai_object_id_t bench_object(_In_ sai_object_type_t type, _In_ uint32_t data)
+{
+    sai_object_id_t object_id;
+
+    BENCH_CHECK(SAI_STATUS_SUCCESS == stub_create_object(type, data, &object_id));
+
+    return object_id;
+}
+
+static sai_ip_address_t bench_ip4(_In_ uint32_t addr)
+{
+    sai_ip_address_t ip;
+
+    memset(&ip, 0, sizeof(ip));
+    ip.addr_family = SAI_IP_ADDR_FAMILY_IPV4;
+    ip.addr.ip4    = htonl(addr);
+
+    return ip;
+}
+
+/* L2MC group with all the ports, and its (*,G) entry */
+static void bench_group_create(_In_ uint32_t index)
+{
+    sai_l2mc_entry_t l2mc_entry;
+    sai_attribute_t  attrs[2];
+    sai_object_id_t  group_id, member_id;
+    uint32_t         port;
+
+    BENCH_CHECK(SAI_STATUS_SUCCESS == l2mc_group_api.create_l2mc_group(&group_id, 0, 0, NULL));
+
+    attrs[0].id        = SAI_L2MC_GROUP_MEMBER_ATTR_L2MC_GROUP_ID;
+    attrs[0].value.oid = group_id;
+    attrs[1].id        = SAI_L2MC_GROUP_MEMBER_ATTR_L2MC_OUTPUT_ID;
+    for (port = 0; port < BENCH_PORTS; port++) {
+        attrs[1].value.oid = bench_object(SAI_OBJECT_TYPE_PORT, port);
+        BENCH_CHECK(SAI_STATUS_SUCCESS == l2mc_group_api.create_l2mc_group_member(&member_id, 2, attrs));
+    }
+
+    memset(&l2mc_entry, 0, sizeof(l2mc_entry));
+    l2mc_entry.vlan_id     = BENCH_VLAN;
+    l2mc_entry.type        = SAI_L2MC_ENTRY_TYPE_XG;
+    l2mc_entry.destination = bench_ip4(BENCH_GROUP_IP + index);
+
+    attrs[0].id        = SAI_L2MC_ENTRY_ATTR_PACKET_ACTION;
+    attrs[0].value.s32 = SAI_PACKET_ACTION_FORWARD;
+    attrs[1].id        = SAI_L2MC_ENTRY_ATTR_OUTPUT_GROUP_ID;
+    attrs[1].value.oid = group_id;
+    BENCH_CHECK(SAI_STATUS_SUCCESS == l2mc_api.create_l2mc_entry(&l2mc_entry, 2, attrs));
+}
+
+/* Ethernet, IPv4 UDP packet to the group */
+static void bench_packet_create(_Out_ stub_mirror_buf_t **buf)
+{
+    uint8_t *ip;
+    uint32_t addr;
+
+    BENCH_CHECK(SAI_STATUS_SUCCESS == db_mirror_buf_alloc(BENCH_LENGTH, buf));
+
+    memset((*buf)->data, 0, BENCH_LENGTH);
+    memcpy((*buf)->data, bench_mac, sizeof(bench_mac));
+    (*buf)->data[12] = 0x08;
+
+    ip    = (*buf)->data + BENCH_IP_OFFSET;
+    ip[0] = 0x45;
+    ip[8] = 64;
+    ip[9] = 17;
+    addr  = htonl(BENCH_SOURCE_IP);
+    memcpy(ip + 12, &addr, sizeof(addr));
+    addr = htonl(BENCH_GROUP_IP);
+    memcpy(ip + 16, &addr, sizeof(addr));
+}
+
+/* Next packet, to the group of this iteration */
+static stub_mirror_buf_t* bench_packet_next(_In_ long iter)
+{
+    stub_mirror_buf_t *buf   = bench_packets[iter % BENCH_PACKETS];
+    uint32_t           group = iter % BENCH_GROUPS;
+
+    buf->data[BENCH_IP_OFFSET + 18] = (group >> 8) & 0xff;
+    buf->data[BENCH_IP_OFFSET + 19] = group & 0xff;
+
+    return buf;
+}
+
+static double bench_now()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+static void bench_replicate(_In_ bool release)
+{
+    stub_mcast_verdict_t verdict;
+    stub_mirror_buf_t   *buf;
+    uint64_t             copies = 0;
+    uint32_t             count, ii;
+    double               start, ns;
+    bool                 to_cpu;
+    long                 iter;
+
+    start = bench_now();
+    for (iter = 0; iter < BENCH_ITERATIONS; iter++) {
+        buf = bench_packet_next(iter);
+        db_l2mc_replicate(BENCH_VLAN, iter % BENCH_PORTS, buf, BENCH_LENGTH, bench_copies, &count, &verdict,
+                          &to_cpu);
+        copies += count;
+
+        if (release) {
+            for (ii = 0; ii < count; ii++) {
+                db_mirror_buf_release(bench_copies[ii].buf);
+            }
+        } else {
+            buf->ref_count = 1;
+        }
+    }
+    ns = bench_now() - start;
+
+    printf("%-24s %7.1f ns/packet, %5.2f ns/copy, %5.1f Mpps, %4.0f Mcopies/s\n",
+           release ? "replicate and release:" : "lookup and fan out:",
+           ns / BENCH_ITERATIONS, ns / copies, BENCH_ITERATIONS / ns * 1e3, copies / ns * 1e3);
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < BENCH_GROUPS; ii++) {
+        bench_group_create(ii);
+    }
+
+    for (ii = 0; ii < BENCH_PACKETS; ii++) {
+        bench_packet_create(&bench_packets[ii]);
+    }
+
+    printf("%u L2MC groups x %u ports\n", BENCH_GROUPS, BENCH_PORTS);
+    bench_replicate(true);
+    bench_replicate(false);
+
+    for (ii = 0; ii < BENCH_PACKETS; ii++) {
+        db_mirror_buf_release(bench_packets[ii]);
+    }
+
+    return 0;
+}
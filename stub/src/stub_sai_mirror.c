@@ -0,0 +1,1146 @@
+/*
+ *  Copyright (C) 2014. Mellanox Technologies, Ltd. ALL RIGHTS RESERVED.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ */
+
+#include "sai.h"
+#include "stub_sai.h"
+#include "assert.h"
+#include "inttypes.h"
+#include "stddef.h"
+
+#undef  __MODULE__
+#define __MODULE__ SAI_MIRROR
+
+static const sai_attribute_entry_t mirror_attribs[] = {
+    { SAI_MIRROR_SESSION_ATTR_TYPE, true, true, false, true,
+      "Mirror session type", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_MIRROR_SESSION_ATTR_MONITOR_PORT, true, true, true, true,
+      "Mirror session monitor port", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_MIRROR_SESSION_ATTR_TRUNCATE_SIZE, false, true, true, true,
+      "Mirror session truncate size", SAI_ATTR_VAL_TYPE_U16 },
+    { SAI_MIRROR_SESSION_ATTR_TC, false, true, true, true,
+      "Mirror session traffic class", SAI_ATTR_VAL_TYPE_U8 },
+    { SAI_MIRROR_SESSION_ATTR_VLAN_TPID, false, true, true, true,
+      "Mirror session VLAN TPID", SAI_ATTR_VAL_TYPE_U16 },
+    { SAI_MIRROR_SESSION_ATTR_VLAN_ID, false, true, true, true,
+      "Mirror session VLAN ID", SAI_ATTR_VAL_TYPE_U16 },
+    { SAI_MIRROR_SESSION_ATTR_VLAN_PRI, false, true, true, true,
+      "Mirror session VLAN priority", SAI_ATTR_VAL_TYPE_U8 },
+    { SAI_MIRROR_SESSION_ATTR_VLAN_CFI, false, true, true, true,
+      "Mirror session VLAN CFI", SAI_ATTR_VAL_TYPE_U8 },
+    { SAI_MIRROR_SESSION_ATTR_ERSPAN_ENCAPSULATION_TYPE, false, true, false, true,
+      "Mirror session ERSPAN encapsulation type", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_MIRROR_SESSION_ATTR_IPHDR_VERSION, false, true, true, true,
+      "Mirror session IP header version", SAI_ATTR_VAL_TYPE_U8 },
+    { SAI_MIRROR_SESSION_ATTR_TOS, false, true, true, true,
+      "Mirror session TOS", SAI_ATTR_VAL_TYPE_U8 },
+    { SAI_MIRROR_SESSION_ATTR_TTL, false, true, true, true,
+      "Mirror session TTL", SAI_ATTR_VAL_TYPE_U8 },
+    { SAI_MIRROR_SESSION_ATTR_SRC_IP_ADDRESS, false, true, true, true,
+      "Mirror session source IP address", SAI_ATTR_VAL_TYPE_IPADDR },
+    { SAI_MIRROR_SESSION_ATTR_DST_IP_ADDRESS, false, true, true, true,
+      "Mirror session destination IP address", SAI_ATTR_VAL_TYPE_IPADDR },
+    { SAI_MIRROR_SESSION_ATTR_SRC_MAC_ADDRESS, false, true, true, true,
+      "Mirror session source MAC address", SAI_ATTR_VAL_TYPE_MAC },
+    { SAI_MIRROR_SESSION_ATTR_DST_MAC_ADDRESS, false, true, true, true,
+      "Mirror session destination MAC address", SAI_ATTR_VAL_TYPE_MAC },
+    { SAI_MIRROR_SESSION_ATTR_GRE_PROTOCOL_TYPE, false, true, true, true,
+      "Mirror session GRE protocol type", SAI_ATTR_VAL_TYPE_U16 },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+sai_status_t stub_mirror_attr_get(_In_ const sai_object_key_t   *key,
+                                  _Inout_ sai_attribute_value_t *value,
+                                  _In_ uint32_t                  attr_index,
+                                  _Inout_ vendor_cache_t        *cache,
+                                  void                          *arg);
+sai_status_t stub_mirror_attr_set(_In_ const sai_object_key_t      *key,
+                                  _In_ const sai_attribute_value_t *value,
+                                  void                             *arg);
+
+static const sai_vendor_attribute_entry_t mirror_vendor_attribs[] = {
+    { SAI_MIRROR_SESSION_ATTR_TYPE,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_mirror_attr_get, (void*)SAI_MIRROR_SESSION_ATTR_TYPE,
+      NULL, NULL },
+    { SAI_MIRROR_SESSION_ATTR_MONITOR_PORT,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_mirror_attr_get, (void*)SAI_MIRROR_SESSION_ATTR_MONITOR_PORT,
+      stub_mirror_attr_set, (void*)SAI_MIRROR_SESSION_ATTR_MONITOR_PORT },
+    { SAI_MIRROR_SESSION_ATTR_TRUNCATE_SIZE,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_mirror_attr_get, (void*)SAI_MIRROR_SESSION_ATTR_TRUNCATE_SIZE,
+      stub_mirror_attr_set, (void*)SAI_MIRROR_SESSION_ATTR_TRUNCATE_SIZE },
+    { SAI_MIRROR_SESSION_ATTR_TC,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_mirror_attr_get, (void*)SAI_MIRROR_SESSION_ATTR_TC,
+      stub_mirror_attr_set, (void*)SAI_MIRROR_SESSION_ATTR_TC },
+    { SAI_MIRROR_SESSION_ATTR_VLAN_TPID,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_mirror_attr_get, (void*)SAI_MIRROR_SESSION_ATTR_VLAN_TPID,
+      stub_mirror_attr_set, (void*)SAI_MIRROR_SESSION_ATTR_VLAN_TPID },
+    { SAI_MIRROR_SESSION_ATTR_VLAN_ID,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_mirror_attr_get, (void*)SAI_MIRROR_SESSION_ATTR_VLAN_ID,
+      stub_mirror_attr_set, (void*)SAI_MIRROR_SESSION_ATTR_VLAN_ID },
+    { SAI_MIRROR_SESSION_ATTR_VLAN_PRI,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_mirror_attr_get, (void*)SAI_MIRROR_SESSION_ATTR_VLAN_PRI,
+      stub_mirror_attr_set, (void*)SAI_MIRROR_SESSION_ATTR_VLAN_PRI },
+    { SAI_MIRROR_SESSION_ATTR_VLAN_CFI,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_mirror_attr_get, (void*)SAI_MIRROR_SESSION_ATTR_VLAN_CFI,
+      stub_mirror_attr_set, (void*)SAI_MIRROR_SESSION_ATTR_VLAN_CFI },
+    { SAI_MIRROR_SESSION_ATTR_ERSPAN_ENCAPSULATION_TYPE,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_mirror_attr_get, (void*)SAI_MIRROR_SESSION_ATTR_ERSPAN_ENCAPSULATION_TYPE,
+      NULL, NULL },
+    { SAI_MIRROR_SESSION_ATTR_IPHDR_VERSION,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_mirror_attr_get, (void*)SAI_MIRROR_SESSION_ATTR_IPHDR_VERSION,
+      stub_mirror_attr_set, (void*)SAI_MIRROR_SESSION_ATTR_IPHDR_VERSION },
+    { SAI_MIRROR_SESSION_ATTR_TOS,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_mirror_attr_get, (void*)SAI_MIRROR_SESSION_ATTR_TOS,
+      stub_mirror_attr_set, (void*)SAI_MIRROR_SESSION_ATTR_TOS },
+    { SAI_MIRROR_SESSION_ATTR_TTL,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_mirror_attr_get, (void*)SAI_MIRROR_SESSION_ATTR_TTL,
+      stub_mirror_attr_set, (void*)SAI_MIRROR_SESSION_ATTR_TTL },
+    { SAI_MIRROR_SESSION_ATTR_SRC_IP_ADDRESS,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_mirror_attr_get, (void*)SAI_MIRROR_SESSION_ATTR_SRC_IP_ADDRESS,
+      stub_mirror_attr_set, (void*)SAI_MIRROR_SESSION_ATTR_SRC_IP_ADDRESS },
+    { SAI_MIRROR_SESSION_ATTR_DST_IP_ADDRESS,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_mirror_attr_get, (void*)SAI_MIRROR_SESSION_ATTR_DST_IP_ADDRESS,
+      stub_mirror_attr_set, (void*)SAI_MIRROR_SESSION_ATTR_DST_IP_ADDRESS },
+    { SAI_MIRROR_SESSION_ATTR_SRC_MAC_ADDRESS,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_mirror_attr_get, (void*)SAI_MIRROR_SESSION_ATTR_SRC_MAC_ADDRESS,
+      stub_mirror_attr_set, (void*)SAI_MIRROR_SESSION_ATTR_SRC_MAC_ADDRESS },
+    { SAI_MIRROR_SESSION_ATTR_DST_MAC_ADDRESS,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_mirror_attr_get, (void*)SAI_MIRROR_SESSION_ATTR_DST_MAC_ADDRESS,
+      stub_mirror_attr_set, (void*)SAI_MIRROR_SESSION_ATTR_DST_MAC_ADDRESS },
+    { SAI_MIRROR_SESSION_ATTR_GRE_PROTOCOL_TYPE,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_mirror_attr_get, (void*)SAI_MIRROR_SESSION_ATTR_GRE_PROTOCOL_TYPE,
+      stub_mirror_attr_set, (void*)SAI_MIRROR_SESSION_ATTR_GRE_PROTOCOL_TYPE },
+};
+
+/* State DB *************/
+
+/*
+ * A mirror copy shares the buffer of the original packet, holding a
+ * reference on it. Truncation only shortens the length of the copy, and the
+ * encapsulation is written to the header of the copy descriptor, in front of
+ * the shared bytes, so mirroring never copies the packet payload.
+ *
+ * Each session keeps its encapsulation pre-built as a template. Per copy the
+ * template is copied and only the lengths, IPv4 checksum, GRE sequence and
+ * ERSPAN header are filled in. The template is rewritten on attribute set
+ * under a sequence lock, copies taken meanwhile retry.
+ */
+#define MAX_MIRROR_NUMBER        32
+#define MIRROR_DIRECTIONS        2
+#define MIRROR_ETHERTYPE_VLAN    0x8100
+#define MIRROR_ETHERTYPE_IPV4    0x0800
+#define MIRROR_ETHERTYPE_IPV6    0x86DD
+#define MIRROR_ETHERTYPE_ERSPAN  0x88BE
+#define MIRROR_IP_PROTOCOL_GRE   47
+#define MIRROR_MAC_HEADER_SIZE   12
+#define MIRROR_VLAN_TAG_SIZE     4
+
+/* Mirror copies sent by one core */
+typedef struct _stub_mirror_counters_t {
+    uint64_t packets;
+    uint64_t bytes;
+} __attribute__((aligned(CACHE_LINE_SIZE))) stub_mirror_counters_t;
+
+/* What a copy needs from its session, read under the sequence lock */
+typedef struct _stub_mirror_encap_t {
+    sai_mirror_session_type_t type;
+    uint32_t                  monitor_port_id;
+    uint8_t                   tc;
+    uint16_t                  truncate_size;
+    uint32_t                  length;
+    /* Offsets of the outer IP and GRE headers */
+    uint32_t                  ip_offset;
+    uint32_t                  gre_offset;
+    bool                      ipv4;
+    bool                      erspan;
+    /* IPv4 header checksum sum, without the total length */
+    uint32_t                  ip_sum;
+    uint8_t                   header[MIRROR_HEADROOM];
+} stub_mirror_encap_t;
+
+typedef struct _stub_mirror_t {
+    sai_object_id_t                 monitor_port;
+    uint16_t                        vlan_tpid;
+    uint16_t                        vlan_id;
+    uint8_t                         vlan_pri;
+    uint8_t                         vlan_cfi;
+    sai_erspan_encapsulation_type_t encap_type;
+    uint8_t                         iphdr_version;
+    uint8_t                         tos;
+    uint8_t                         ttl;
+    sai_ip_address_t                src_ip;
+    sai_ip_address_t                dst_ip;
+    sai_mac_t                       src_mac;
+    sai_mac_t                       dst_mac;
+    uint16_t                        gre_protocol_type;
+    uint32_t                        encap_seq;
+    stub_mirror_encap_t             encap;
+    uint32_t                        gre_seq;
+    stub_mirror_counters_t          counters[STUB_CORES];
+    uint32_t                        ref_count;
+    bool                            is_valid;
+} stub_mirror_t;
+
+typedef struct _stub_mirror_port_t {
+    uint32_t        count;
+    uint32_t        sessions[MIRROR_PORT_SESSIONS];
+    sai_object_id_t session_ids[MIRROR_PORT_SESSIONS];
+} stub_mirror_port_t;
+
+static stub_mirror_t      mirror_db[MAX_MIRROR_NUMBER];
+static stub_mirror_port_t mirror_port_db[PORT_NUMBER][MIRROR_DIRECTIONS];
+
+static sai_status_t db_get_mirror(_In_ uint32_t session_id, _Out_ stub_mirror_t **session)
+{
+    if ((session_id >= MAX_MIRROR_NUMBER) || (!mirror_db[session_id].is_valid)) {
+        STUB_LOG_ERR("Invalid mirror session ID %u\n", session_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *session = &mirror_db[session_id];
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t db_find_free_mirror_index(_Out_ uint32_t *free_index)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < MAX_MIRROR_NUMBER; ii++) {
+        if (false == mirror_db[ii].is_valid) {
+            *free_index = ii;
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+
+    STUB_LOG_ERR("Mirror session table full\n");
+    return SAI_STATUS_TABLE_FULL;
+}
+
+static uint8_t* mirror_put16(_Out_ uint8_t *p, _In_ uint16_t value)
+{
+    p[0] = value >> 8;
+    p[1] = value & 0xFF;
+
+    return p + 2;
+}
+
+static uint8_t* mirror_put32(_Out_ uint8_t *p, _In_ uint32_t value)
+{
+    p[0] = value >> 24;
+    p[1] = (value >> 16) & 0xFF;
+    p[2] = (value >> 8) & 0xFF;
+    p[3] = value & 0xFF;
+
+    return p + 4;
+}
+
+static uint16_t mirror_checksum_fold(_In_ uint32_t sum)
+{
+    while (sum >> 16) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+
+    return (uint16_t)~sum;
+}
+
+/*
+ * Build the encapsulation template of a session:
+ * RSPAN - the VLAN tag inserted after the MAC addresses of the copy
+ * ERSPAN - Ethernet [VLAN] | IPv4/IPv6 | GRE [seq | ERSPAN type II] | copy
+ */
+static void mirror_encap_build(_In_ const stub_mirror_t *session, _Out_ stub_mirror_encap_t *encap)
+{
+    uint8_t *p = encap->header, *ip;
+    uint32_t ii;
+
+    encap->length     = 0;
+    encap->ip_offset  = 0;
+    encap->gre_offset = 0;
+    encap->ip_sum     = 0;
+    encap->ipv4       = (4 == session->iphdr_version);
+    encap->erspan     = (MIRROR_ETHERTYPE_ERSPAN == session->gre_protocol_type);
+
+    if (SAI_MIRROR_SESSION_TYPE_LOCAL == encap->type) {
+        return;
+    }
+
+    if (SAI_MIRROR_SESSION_TYPE_ENHANCED_REMOTE == encap->type) {
+        memcpy(p, session->dst_mac, sizeof(sai_mac_t));
+        memcpy(p + sizeof(sai_mac_t), session->src_mac, sizeof(sai_mac_t));
+        p += MIRROR_MAC_HEADER_SIZE;
+    }
+
+    if ((SAI_MIRROR_SESSION_TYPE_REMOTE == encap->type) || (0 != session->vlan_id)) {
+        p = mirror_put16(p, session->vlan_tpid);
+        p = mirror_put16(p, (session->vlan_pri << 13) | ((session->vlan_cfi & 1) << 12) | (session->vlan_id & 0xFFF));
+    }
+
+    if (SAI_MIRROR_SESSION_TYPE_REMOTE == encap->type) {
+        encap->length = p - encap->header;
+        return;
+    }
+
+    p  = mirror_put16(p, encap->ipv4 ? MIRROR_ETHERTYPE_IPV4 : MIRROR_ETHERTYPE_IPV6);
+    ip = p;
+    encap->ip_offset = p - encap->header;
+    if (encap->ipv4) {
+        p    = mirror_put16(p, 0x4500 | session->tos);
+        p    = mirror_put16(p, 0);
+        p    = mirror_put32(p, 0x00004000);
+        *p++ = session->ttl;
+        *p++ = MIRROR_IP_PROTOCOL_GRE;
+        p    = mirror_put16(p, 0);
+        memcpy(p, &session->src_ip.addr.ip4, sizeof(sai_ip4_t));
+        memcpy(p + sizeof(sai_ip4_t), &session->dst_ip.addr.ip4, sizeof(sai_ip4_t));
+        p += 2 * sizeof(sai_ip4_t);
+        for (ii = 0; ii < (uint32_t)(p - ip); ii += 2) {
+            encap->ip_sum += (ip[ii] << 8) | ip[ii + 1];
+        }
+    } else {
+        p    = mirror_put32(p, (6 << 28) | (session->tos << 20));
+        p    = mirror_put16(p, 0);
+        *p++ = MIRROR_IP_PROTOCOL_GRE;
+        *p++ = session->ttl;
+        memcpy(p, session->src_ip.addr.ip6, sizeof(sai_ip6_t));
+        memcpy(p + sizeof(sai_ip6_t), session->dst_ip.addr.ip6, sizeof(sai_ip6_t));
+        p += 2 * sizeof(sai_ip6_t);
+    }
+
+    encap->gre_offset = p - encap->header;
+    if (encap->erspan) {
+        /* Sequence number present, ERSPAN header filled per copy */
+        p = mirror_put16(p, 0x1000);
+        p = mirror_put16(p, MIRROR_ETHERTYPE_ERSPAN);
+        memset(p, 0, 12);
+        p += 12;
+    } else {
+        p = mirror_put16(p, 0);
+        p = mirror_put16(p, session->gre_protocol_type);
+    }
+
+    encap->length = p - encap->header;
+}
+
+/* Apply new settings to a session and rebuild its template, copies taken meanwhile retry */
+static void mirror_encap_update(_Inout_ stub_mirror_t *session, _In_ const stub_mirror_t *updated)
+{
+    __atomic_store_n(&session->encap_seq, session->encap_seq + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(session, updated, offsetof(stub_mirror_t, encap_seq));
+    session->encap = updated->encap;
+    mirror_encap_build(session, &session->encap);
+    __atomic_store_n(&session->encap_seq, session->encap_seq + 1, __ATOMIC_RELEASE);
+}
+
+static void mirror_clone(_Inout_ stub_mirror_t        *session,
+                         _In_ uint32_t                 session_id,
+                         _In_ uint32_t                 core,
+                         _In_ uint32_t                 port_id,
+                         _In_ stub_mirror_buf_t       *buf,
+                         _In_ uint32_t                 length,
+                         _Out_ stub_mirror_packet_t   *clone)
+{
+    const stub_mirror_encap_t *encap = &session->encap;
+    stub_mirror_encap_t        meta;
+    stub_mirror_counters_t    *counters;
+    uint32_t                   seq, payload, ip_length, vlan = 0, cos = 0, en = 0;
+    uint8_t                   *p;
+
+    /* Copy the template, retrying if it was rewritten meanwhile */
+    do {
+        while ((seq = __atomic_load_n(&session->encap_seq, __ATOMIC_ACQUIRE)) & 1) {
+        }
+        memcpy(&meta, encap, offsetof(stub_mirror_encap_t, header));
+        memcpy(clone->header, encap->header, meta.length);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    } while (seq != __atomic_load_n(&session->encap_seq, __ATOMIC_RELAXED));
+
+    payload = ((0 != meta.truncate_size) && (meta.truncate_size < length)) ? meta.truncate_size : length;
+
+    clone->buf             = buf;
+    clone->offset          = 0;
+    clone->length          = payload;
+    clone->header_length   = meta.length;
+    clone->monitor_port_id = meta.monitor_port_id;
+    clone->tc              = meta.tc;
+
+    switch (meta.type) {
+    case SAI_MIRROR_SESSION_TYPE_REMOTE:
+        /* Tag after the MAC addresses, the rest follows from the shared buffer */
+        if (payload < MIRROR_MAC_HEADER_SIZE) {
+            clone->header_length = 0;
+            break;
+        }
+        memmove(clone->header + MIRROR_MAC_HEADER_SIZE, clone->header, MIRROR_VLAN_TAG_SIZE);
+        if (NULL != buf) {
+            memcpy(clone->header, buf->data, MIRROR_MAC_HEADER_SIZE);
+        } else {
+            memset(clone->header, 0, MIRROR_MAC_HEADER_SIZE);
+        }
+        clone->header_length += MIRROR_MAC_HEADER_SIZE;
+        clone->offset         = MIRROR_MAC_HEADER_SIZE;
+        clone->length         = payload - MIRROR_MAC_HEADER_SIZE;
+        break;
+
+    case SAI_MIRROR_SESSION_TYPE_ENHANCED_REMOTE:
+        ip_length = meta.length - meta.ip_offset + payload;
+        if (meta.ipv4) {
+            mirror_put16(clone->header + meta.ip_offset + 2, ip_length);
+            mirror_put16(clone->header + meta.ip_offset + 10, mirror_checksum_fold(meta.ip_sum + ip_length));
+        } else {
+            mirror_put16(clone->header + meta.ip_offset + 4, ip_length - 40);
+        }
+
+        if (meta.erspan) {
+            if ((NULL != buf) && (payload >= MIRROR_MAC_HEADER_SIZE + MIRROR_VLAN_TAG_SIZE) &&
+                (MIRROR_ETHERTYPE_VLAN == ((buf->data[12] << 8) | buf->data[13]))) {
+                vlan = ((buf->data[14] << 8) | buf->data[15]) & 0xFFF;
+                cos  = buf->data[14] >> 5;
+                en   = 3;
+            }
+            p = clone->header + meta.gre_offset + 4;
+            p = mirror_put32(p, __atomic_fetch_add(&session->gre_seq, 1, __ATOMIC_RELAXED));
+            p = mirror_put32(p, (1 << 28) | (vlan << 16) | (cos << 13) | (en << 11) |
+                             ((payload < length) << 10) | (session_id & 0x3FF));
+            mirror_put32(p, port_id & 0xFFFFF);
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    if (NULL != buf) {
+        __atomic_fetch_add(&buf->ref_count, 1, __ATOMIC_RELAXED);
+    }
+
+    counters = &session->counters[core % STUB_CORES];
+    counters->packets++;
+    counters->bytes += clone->header_length + clone->length;
+}
+
+/*
+ * Mirror a packet received (ingress) or sent (egress) on a port to the
+ * sessions of the port. clones must hold MIRROR_PORT_SESSIONS copies, each
+ * holds a reference on buf until released. buf may be NULL when the packet
+ * bytes aren't available, the copies then only carry their lengths.
+ */
+sai_status_t db_mirror_port_clone(_In_ uint32_t               core,
+                                  _In_ uint32_t               port_id,
+                                  _In_ bool                   ingress,
+                                  _In_ stub_mirror_buf_t     *buf,
+                                  _In_ uint32_t               length,
+                                  _Out_ stub_mirror_packet_t *clones,
+                                  _Out_ uint32_t             *count)
+{
+    const stub_mirror_port_t *port;
+    uint32_t                  ii;
+
+    if (port_id >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid port %u\n", port_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if ((NULL != buf) && (length > buf->length)) {
+        STUB_LOG_ERR("Packet length %u over buffer length %u\n", length, buf->length);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    port = &mirror_port_db[port_id][ingress ? 0 : 1];
+    for (ii = 0; ii < port->count; ii++) {
+        mirror_clone(&mirror_db[port->sessions[ii]], port->sessions[ii], core, port_id, buf, length, &clones[ii]);
+    }
+
+    *count = port->count;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t db_mirror_buf_alloc(_In_ uint32_t length, _Out_ stub_mirror_buf_t **buf)
+{
+    if (NULL == (*buf = malloc(sizeof(stub_mirror_buf_t) + length))) {
+        STUB_LOG_ERR("Failed to allocate packet buffer of %u bytes\n", length);
+        return SAI_STATUS_NO_MEMORY;
+    }
+
+    (*buf)->ref_count = 1;
+    (*buf)->length    = length;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+void db_mirror_buf_release(_In_ stub_mirror_buf_t *buf)
+{
+    if (1 == __atomic_fetch_sub(&buf->ref_count, 1, __ATOMIC_ACQ_REL)) {
+        free(buf);
+    }
+}
+
+void db_mirror_packet_release(_Inout_ stub_mirror_packet_t *clone)
+{
+    if (NULL != clone->buf) {
+        db_mirror_buf_release(clone->buf);
+        clone->buf = NULL;
+    }
+}
+
+/* Mirror copies sent by a session and their bytes, encapsulation included */
+sai_status_t db_mirror_session_stats_get(_In_ sai_object_id_t session_id,
+                                         _Out_ uint64_t       *packets,
+                                         _Out_ uint64_t       *bytes)
+{
+    stub_mirror_t *session;
+    sai_status_t   status;
+    uint32_t       db_id, core;
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(session_id, SAI_OBJECT_TYPE_MIRROR_SESSION, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_mirror(db_id, &session))) {
+        return status;
+    }
+
+    *packets = 0;
+    *bytes   = 0;
+    for (core = 0; core < STUB_CORES; core++) {
+        *packets += session->counters[core].packets;
+        *bytes   += session->counters[core].bytes;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t db_mirror_port_sessions_set(_In_ uint32_t                port_id,
+                                         _In_ bool                    ingress,
+                                         _In_ const sai_object_list_t *sessions)
+{
+    stub_mirror_port_t *port;
+    stub_mirror_t      *session;
+    uint32_t            db_ids[MIRROR_PORT_SESSIONS];
+    uint32_t            ii, jj;
+
+    if (port_id >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid port %u\n", port_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (sessions->count > MIRROR_PORT_SESSIONS) {
+        STUB_LOG_ERR("Too many mirror sessions %u, max %u\n", sessions->count, MIRROR_PORT_SESSIONS);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0;
+    }
+
+    for (ii = 0; ii < sessions->count; ii++) {
+        if ((SAI_STATUS_SUCCESS != stub_object_to_type(sessions->list[ii], SAI_OBJECT_TYPE_MIRROR_SESSION, &db_ids[ii])) ||
+            (SAI_STATUS_SUCCESS != db_get_mirror(db_ids[ii], &session))) {
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        for (jj = 0; jj < ii; jj++) {
+            if (db_ids[jj] == db_ids[ii]) {
+                STUB_LOG_ERR("Mirror session %u appears twice\n", db_ids[ii]);
+                return SAI_STATUS_INVALID_ATTR_VALUE_0;
+            }
+        }
+    }
+
+    port = &mirror_port_db[port_id][ingress ? 0 : 1];
+    for (ii = 0; ii < port->count; ii++) {
+        mirror_db[port->sessions[ii]].ref_count--;
+    }
+
+    /* Shrink first, so that a concurrent copy never sees a session not yet set */
+    __atomic_store_n(&port->count, 0, __ATOMIC_RELEASE);
+    for (ii = 0; ii < sessions->count; ii++) {
+        port->sessions[ii]    = db_ids[ii];
+        port->session_ids[ii] = sessions->list[ii];
+        mirror_db[db_ids[ii]].ref_count++;
+    }
+    __atomic_store_n(&port->count, sessions->count, __ATOMIC_RELEASE);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t db_mirror_port_sessions_get(_In_ uint32_t             port_id,
+                                         _In_ bool                 ingress,
+                                         _Inout_ sai_object_list_t *sessions)
+{
+    const stub_mirror_port_t *port;
+
+    if (port_id >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid port %u\n", port_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    port = &mirror_port_db[port_id][ingress ? 0 : 1];
+
+    return stub_fill_objlist((sai_object_id_t*)port->session_ids, port->count, sessions);
+}
+
+/*************************/
+
+static void mirror_key_to_str(_In_ sai_object_id_t session_id, _Out_ char *key_str)
+{
+    uint32_t sessionid;
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(session_id, SAI_OBJECT_TYPE_MIRROR_SESSION, &sessionid)) {
+        snprintf(key_str, MAX_KEY_STR_LEN, "invalid mirror session");
+    } else {
+        snprintf(key_str, MAX_KEY_STR_LEN, "mirror session %u", sessionid);
+    }
+}
+
+static bool mirror_attr_valid_for_type(_In_ sai_attr_id_t id, _In_ sai_mirror_session_type_t type)
+{
+    switch (id) {
+    case SAI_MIRROR_SESSION_ATTR_VLAN_TPID:
+    case SAI_MIRROR_SESSION_ATTR_VLAN_ID:
+    case SAI_MIRROR_SESSION_ATTR_VLAN_PRI:
+    case SAI_MIRROR_SESSION_ATTR_VLAN_CFI:
+        return (SAI_MIRROR_SESSION_TYPE_LOCAL != type);
+
+    case SAI_MIRROR_SESSION_ATTR_ERSPAN_ENCAPSULATION_TYPE:
+    case SAI_MIRROR_SESSION_ATTR_IPHDR_VERSION:
+    case SAI_MIRROR_SESSION_ATTR_TOS:
+    case SAI_MIRROR_SESSION_ATTR_TTL:
+    case SAI_MIRROR_SESSION_ATTR_SRC_IP_ADDRESS:
+    case SAI_MIRROR_SESSION_ATTR_DST_IP_ADDRESS:
+    case SAI_MIRROR_SESSION_ATTR_SRC_MAC_ADDRESS:
+    case SAI_MIRROR_SESSION_ATTR_DST_MAC_ADDRESS:
+    case SAI_MIRROR_SESSION_ATTR_GRE_PROTOCOL_TYPE:
+        return (SAI_MIRROR_SESSION_TYPE_ENHANCED_REMOTE == type);
+
+    default:
+        return true;
+    }
+}
+
+/* Check an attribute value and store it in the session, the template is rebuilt by the caller */
+static sai_status_t mirror_attr_apply(_Inout_ stub_mirror_t *session, _In_ const sai_attribute_t *attr)
+{
+    uint32_t port_id;
+
+    switch (attr->id) {
+    case SAI_MIRROR_SESSION_ATTR_MONITOR_PORT:
+        if ((SAI_STATUS_SUCCESS != stub_object_to_type(attr->value.oid, SAI_OBJECT_TYPE_PORT, &port_id)) ||
+            (port_id >= PORT_NUMBER)) {
+            STUB_LOG_ERR("Invalid mirror monitor port %" PRIx64 "\n", attr->value.oid);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        session->monitor_port          = attr->value.oid;
+        session->encap.monitor_port_id = port_id;
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_TRUNCATE_SIZE:
+        if ((0 != attr->value.u16) && (attr->value.u16 < MIRROR_MAC_HEADER_SIZE)) {
+            STUB_LOG_ERR("Invalid mirror truncate size %u\n", attr->value.u16);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        session->encap.truncate_size = attr->value.u16;
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_TC:
+        if (attr->value.u8 >= QUEUE_MAX_INDEX) {
+            STUB_LOG_ERR("Invalid mirror traffic class %u\n", attr->value.u8);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        session->encap.tc = attr->value.u8;
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_VLAN_TPID:
+        session->vlan_tpid = attr->value.u16;
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_VLAN_ID:
+        if (attr->value.u16 > 4094) {
+            STUB_LOG_ERR("Invalid mirror VLAN %u\n", attr->value.u16);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        session->vlan_id = attr->value.u16;
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_VLAN_PRI:
+        if (attr->value.u8 > 7) {
+            STUB_LOG_ERR("Invalid mirror VLAN priority %u\n", attr->value.u8);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        session->vlan_pri = attr->value.u8;
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_VLAN_CFI:
+        if (attr->value.u8 > 1) {
+            STUB_LOG_ERR("Invalid mirror VLAN CFI %u\n", attr->value.u8);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        session->vlan_cfi = attr->value.u8;
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_ERSPAN_ENCAPSULATION_TYPE:
+        if (SAI_ERSPAN_ENCAPSULATION_TYPE_MIRROR_L3_GRE_TUNNEL != attr->value.s32) {
+            STUB_LOG_ERR("Invalid mirror encapsulation type %d\n", attr->value.s32);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        session->encap_type = attr->value.s32;
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_IPHDR_VERSION:
+        if ((4 != attr->value.u8) && (6 != attr->value.u8)) {
+            STUB_LOG_ERR("Invalid mirror IP header version %u\n", attr->value.u8);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        session->iphdr_version = attr->value.u8;
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_TOS:
+        session->tos = attr->value.u8;
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_TTL:
+        session->ttl = attr->value.u8;
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_SRC_IP_ADDRESS:
+        session->src_ip = attr->value.ipaddr;
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_DST_IP_ADDRESS:
+        session->dst_ip = attr->value.ipaddr;
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_SRC_MAC_ADDRESS:
+        memcpy(session->src_mac, attr->value.mac, sizeof(sai_mac_t));
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_DST_MAC_ADDRESS:
+        memcpy(session->dst_mac, attr->value.mac, sizeof(sai_mac_t));
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_GRE_PROTOCOL_TYPE:
+        session->gre_protocol_type = attr->value.u16;
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid mirror session attribute %d\n", attr->id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Tunnel addresses must match the IP header version */
+static bool mirror_ip_consistent(_In_ const stub_mirror_t *session)
+{
+    sai_ip_addr_family_t family = (4 == session->iphdr_version) ? SAI_IP_ADDR_FAMILY_IPV4 : SAI_IP_ADDR_FAMILY_IPV6;
+
+    return (SAI_MIRROR_SESSION_TYPE_ENHANCED_REMOTE != session->encap.type) ||
+           ((family == session->src_ip.addr_family) && (family == session->dst_ip.addr_family));
+}
+
+/*
+ * Routine Description:
+ *    Create mirror session.
+ *
+ * Arguments:
+ *    [out] session_id - mirror session id
+ *    [in] switch_id - switch id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_mirror_session(_Out_ sai_object_id_t      *session_id,
+                                        _In_ sai_object_id_t        switch_id,
+                                        _In_ uint32_t               attr_count,
+                                        _In_ const sai_attribute_t *attr_list)
+{
+    static const sai_attr_id_t   remote_mandatory[] = {
+        SAI_MIRROR_SESSION_ATTR_VLAN_TPID, SAI_MIRROR_SESSION_ATTR_VLAN_ID,
+        SAI_MIRROR_SESSION_ATTR_VLAN_PRI, SAI_MIRROR_SESSION_ATTR_VLAN_CFI
+    };
+    static const sai_attr_id_t   erspan_mandatory[] = {
+        SAI_MIRROR_SESSION_ATTR_ERSPAN_ENCAPSULATION_TYPE, SAI_MIRROR_SESSION_ATTR_IPHDR_VERSION,
+        SAI_MIRROR_SESSION_ATTR_TOS, SAI_MIRROR_SESSION_ATTR_SRC_IP_ADDRESS,
+        SAI_MIRROR_SESSION_ATTR_DST_IP_ADDRESS, SAI_MIRROR_SESSION_ATTR_SRC_MAC_ADDRESS,
+        SAI_MIRROR_SESSION_ATTR_DST_MAC_ADDRESS, SAI_MIRROR_SESSION_ATTR_GRE_PROTOCOL_TYPE
+    };
+    stub_mirror_t                *session;
+    sai_status_t                  status;
+    const sai_attribute_value_t  *type, *value;
+    uint32_t                      type_index, index, db_id, ii;
+    char                          list_str[MAX_LIST_VALUE_STR_LEN];
+    char                          key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == session_id) {
+        STUB_LOG_ERR("NULL mirror session id param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = check_attribs_metadata(attr_count, attr_list, mirror_attribs, mirror_vendor_attribs,
+                                         SAI_OPERATION_CREATE))) {
+        STUB_LOG_ERR("Failed attribs check\n");
+        return status;
+    }
+
+    sai_attr_list_to_str(attr_count, attr_list, mirror_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create mirror session, %s\n", list_str);
+
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_MIRROR_SESSION_ATTR_TYPE, &type, &type_index));
+
+    if ((SAI_MIRROR_SESSION_TYPE_LOCAL != type->s32) && (SAI_MIRROR_SESSION_TYPE_REMOTE != type->s32) &&
+        (SAI_MIRROR_SESSION_TYPE_ENHANCED_REMOTE != type->s32)) {
+        STUB_LOG_ERR("Invalid mirror session type %d\n", type->s32);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + type_index;
+    }
+
+    for (ii = 0; ii < attr_count; ii++) {
+        if (!mirror_attr_valid_for_type(attr_list[ii].id, type->s32)) {
+            STUB_LOG_ERR("Mirror session attribute %d not valid for type %d\n", attr_list[ii].id, type->s32);
+            return SAI_STATUS_INVALID_ATTRIBUTE_0 + ii;
+        }
+    }
+
+    for (ii = 0; (SAI_MIRROR_SESSION_TYPE_LOCAL != type->s32) &&
+         (ii < sizeof(remote_mandatory) / sizeof(remote_mandatory[0])); ii++) {
+        if (SAI_STATUS_SUCCESS != find_attrib_in_list(attr_count, attr_list, remote_mandatory[ii], &value, &index)) {
+            STUB_LOG_ERR("Missing mandatory mirror session attribute %d\n", remote_mandatory[ii]);
+            return SAI_STATUS_MANDATORY_ATTRIBUTE_MISSING;
+        }
+    }
+
+    for (ii = 0; (SAI_MIRROR_SESSION_TYPE_ENHANCED_REMOTE == type->s32) &&
+         (ii < sizeof(erspan_mandatory) / sizeof(erspan_mandatory[0])); ii++) {
+        if (SAI_STATUS_SUCCESS != find_attrib_in_list(attr_count, attr_list, erspan_mandatory[ii], &value, &index)) {
+            STUB_LOG_ERR("Missing mandatory mirror session attribute %d\n", erspan_mandatory[ii]);
+            return SAI_STATUS_MANDATORY_ATTRIBUTE_MISSING;
+        }
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_find_free_mirror_index(&db_id))) {
+        return status;
+    }
+
+    session = &mirror_db[db_id];
+    memset(session, 0, sizeof(*session));
+    session->encap.type = type->s32;
+    session->ttl        = 255;
+
+    for (ii = 0; ii < attr_count; ii++) {
+        if ((SAI_MIRROR_SESSION_ATTR_TYPE != attr_list[ii].id) &&
+            (SAI_STATUS_SUCCESS != (status = mirror_attr_apply(session, &attr_list[ii])))) {
+            return (SAI_STATUS_INVALID_ATTR_VALUE_0 == status) ? SAI_STATUS_INVALID_ATTR_VALUE_0 + ii : status;
+        }
+    }
+
+    if (!mirror_ip_consistent(session)) {
+        STUB_LOG_ERR("Mirror tunnel addresses don't match IP header version %u\n", session->iphdr_version);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = stub_create_object(SAI_OBJECT_TYPE_MIRROR_SESSION, db_id, session_id))) {
+        return status;
+    }
+
+    mirror_encap_build(session, &session->encap);
+    session->is_valid = true;
+
+    mirror_key_to_str(*session_id, key_str);
+    STUB_LOG_NTC("Created mirror session %s, encapsulation %u bytes\n", key_str, session->encap.length);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Remove mirror session.
+ *
+ * Arguments:
+ *    [in] session_id - mirror session id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_mirror_session(_In_ sai_object_id_t session_id)
+{
+    stub_mirror_t *session;
+    char           key_str[MAX_KEY_STR_LEN];
+    sai_status_t   status;
+    uint32_t       db_id;
+
+    STUB_LOG_ENTER();
+
+    mirror_key_to_str(session_id, key_str);
+    STUB_LOG_NTC("Remove mirror session %s\n", key_str);
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(session_id, SAI_OBJECT_TYPE_MIRROR_SESSION, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_mirror(db_id, &session))) {
+        return status;
+    }
+
+    if (session->ref_count > 0) {
+        STUB_LOG_ERR("Mirror session %u is used by %u ports\n", db_id, session->ref_count);
+        return SAI_STATUS_OBJECT_IN_USE;
+    }
+
+    session->is_valid = false;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Set mirror session attribute.
+ *
+ * Arguments:
+ *    [in] session_id - mirror session id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_mirror_session_attribute(_In_ sai_object_id_t session_id, _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = session_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    mirror_key_to_str(session_id, key_str);
+    return sai_set_attribute(&key, key_str, mirror_attribs, mirror_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get mirror session attributes.
+ *
+ * Arguments:
+ *    [in] session_id - mirror session id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_mirror_session_attribute(_In_ sai_object_id_t     session_id,
+                                               _In_ uint32_t            attr_count,
+                                               _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = session_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    mirror_key_to_str(session_id, key_str);
+    return sai_get_attributes(&key, key_str, mirror_attribs, mirror_vendor_attribs, attr_count, attr_list);
+}
+
+/* Mirror session attributes */
+sai_status_t stub_mirror_attr_get(_In_ const sai_object_key_t   *key,
+                                  _Inout_ sai_attribute_value_t *value,
+                                  _In_ uint32_t                  attr_index,
+                                  _Inout_ vendor_cache_t        *cache,
+                                  void                          *arg)
+{
+    stub_mirror_t *session;
+    sai_status_t   status;
+    uint32_t       db_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_MIRROR_SESSION, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_mirror(db_id, &session))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_MIRROR_SESSION_ATTR_TYPE:
+        value->s32 = session->encap.type;
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_MONITOR_PORT:
+        value->oid = session->monitor_port;
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_TRUNCATE_SIZE:
+        value->u16 = session->encap.truncate_size;
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_TC:
+        value->u8 = session->encap.tc;
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_VLAN_TPID:
+        value->u16 = session->vlan_tpid;
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_VLAN_ID:
+        value->u16 = session->vlan_id;
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_VLAN_PRI:
+        value->u8 = session->vlan_pri;
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_VLAN_CFI:
+        value->u8 = session->vlan_cfi;
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_ERSPAN_ENCAPSULATION_TYPE:
+        value->s32 = session->encap_type;
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_IPHDR_VERSION:
+        value->u8 = session->iphdr_version;
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_TOS:
+        value->u8 = session->tos;
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_TTL:
+        value->u8 = session->ttl;
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_SRC_IP_ADDRESS:
+        value->ipaddr = session->src_ip;
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_DST_IP_ADDRESS:
+        value->ipaddr = session->dst_ip;
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_SRC_MAC_ADDRESS:
+        memcpy(value->mac, session->src_mac, sizeof(sai_mac_t));
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_DST_MAC_ADDRESS:
+        memcpy(value->mac, session->dst_mac, sizeof(sai_mac_t));
+        break;
+
+    case SAI_MIRROR_SESSION_ATTR_GRE_PROTOCOL_TYPE:
+        value->u16 = session->gre_protocol_type;
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid mirror session attribute %d\n", (int)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Mirror session attributes, the encapsulation template is rebuilt for the new value */
+sai_status_t stub_mirror_attr_set(_In_ const sai_object_key_t      *key,
+                                  _In_ const sai_attribute_value_t *value,
+                                  void                             *arg)
+{
+    const sai_attribute_t attr = { .id = (sai_attr_id_t)(int64_t)arg, .value = *value };
+    stub_mirror_t        *session;
+    stub_mirror_t         updated;
+    sai_status_t          status;
+    uint32_t              db_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_MIRROR_SESSION, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_mirror(db_id, &session))) {
+        return status;
+    }
+
+    if (!mirror_attr_valid_for_type(attr.id, session->encap.type)) {
+        STUB_LOG_ERR("Mirror session attribute %d not valid for type %d\n", attr.id, session->encap.type);
+        return SAI_STATUS_INVALID_ATTRIBUTE_0;
+    }
+
+    /* Check on a copy, the session changes only if the result is consistent */
+    memcpy(&updated, session, offsetof(stub_mirror_t, encap_seq));
+    updated.encap = session->encap;
+    if (SAI_STATUS_SUCCESS != (status = mirror_attr_apply(&updated, &attr))) {
+        return status;
+    }
+
+    if (!mirror_ip_consistent(&updated)) {
+        STUB_LOG_ERR("Mirror tunnel addresses don't match IP header version %u\n", updated.iphdr_version);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0;
+    }
+
+    mirror_encap_update(session, &updated);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+const sai_mirror_api_t mirror_api = {
+    stub_create_mirror_session,
+    stub_remove_mirror_session,
+    stub_set_mirror_session_attribute,
+    stub_get_mirror_session_attribute
+};
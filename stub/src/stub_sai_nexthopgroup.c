@@ -25,10 +25,21 @@
 static const sai_attribute_entry_t next_hop_group_attribs[] = {
     { SAI_NEXT_HOP_GROUP_ATTR_NEXT_HOP_COUNT, false, false, false, true,
       "Next hop group entries count", SAI_ATTR_VAL_TYPE_U32 },
+    { SAI_NEXT_HOP_GROUP_ATTR_NEXT_HOP_MEMBER_LIST, false, false, false, true,
+      "Next hop group member list", SAI_ATTR_VAL_TYPE_OBJLIST },
     { SAI_NEXT_HOP_GROUP_ATTR_TYPE, true, true, false, true,
       "Next hop group type", SAI_ATTR_VAL_TYPE_S32 },
-    { SAI_NEXT_HOP_GROUP_ATTR_NEXT_HOP_LIST, true, true, true, true,
-      "Next hop group hop list", SAI_ATTR_VAL_TYPE_OBJLIST },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+static const sai_attribute_entry_t next_hop_group_member_attribs[] = {
+    { SAI_NEXT_HOP_GROUP_MEMBER_ATTR_NEXT_HOP_GROUP_ID, true, true, false, true,
+      "Next hop group member group id", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_NEXT_HOP_GROUP_MEMBER_ATTR_NEXT_HOP_ID, true, true, false, true,
+      "Next hop group member next hop id", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_NEXT_HOP_GROUP_MEMBER_ATTR_WEIGHT, false, true, true, true,
+      "Next hop group member weight", SAI_ATTR_VAL_TYPE_U32 },
     { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
       "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
 };
@@ -43,14 +54,29 @@ sai_status_t stub_next_hop_group_type_get(_In_ const sai_object_key_t   *key,
                                           _In_ uint32_t                  attr_index,
                                           _Inout_ vendor_cache_t        *cache,
                                           void                          *arg);
-sai_status_t stub_next_hop_group_hop_list_get(_In_ const sai_object_key_t   *key,
-                                              _Inout_ sai_attribute_value_t *value,
-                                              _In_ uint32_t                  attr_index,
-                                              _Inout_ vendor_cache_t        *cache,
-                                              void                          *arg);
-sai_status_t stub_next_hop_group_hop_list_set(_In_ const sai_object_key_t      *key,
-                                              _In_ const sai_attribute_value_t *value,
-                                              void                             *arg);
+sai_status_t stub_next_hop_group_member_list_get(_In_ const sai_object_key_t   *key,
+                                                 _Inout_ sai_attribute_value_t *value,
+                                                 _In_ uint32_t                  attr_index,
+                                                 _Inout_ vendor_cache_t        *cache,
+                                                 void                          *arg);
+sai_status_t stub_next_hop_group_member_group_get(_In_ const sai_object_key_t   *key,
+                                                  _Inout_ sai_attribute_value_t *value,
+                                                  _In_ uint32_t                  attr_index,
+                                                  _Inout_ vendor_cache_t        *cache,
+                                                  void                          *arg);
+sai_status_t stub_next_hop_group_member_hop_get(_In_ const sai_object_key_t   *key,
+                                                _Inout_ sai_attribute_value_t *value,
+                                                _In_ uint32_t                  attr_index,
+                                                _Inout_ vendor_cache_t        *cache,
+                                                void                          *arg);
+sai_status_t stub_next_hop_group_member_weight_get(_In_ const sai_object_key_t   *key,
+                                                   _Inout_ sai_attribute_value_t *value,
+                                                   _In_ uint32_t                  attr_index,
+                                                   _Inout_ vendor_cache_t        *cache,
+                                                   void                          *arg);
+sai_status_t stub_next_hop_group_member_weight_set(_In_ const sai_object_key_t      *key,
+                                                   _In_ const sai_attribute_value_t *value,
+                                                   void                             *arg);
 
 static const sai_vendor_attribute_entry_t next_hop_group_vendor_attribs[] = {
     { SAI_NEXT_HOP_GROUP_ATTR_NEXT_HOP_COUNT,
@@ -58,50 +84,138 @@ static const sai_vendor_attribute_entry_t next_hop_group_vendor_attribs[] = {
       { false, false, false, true },
       stub_next_hop_group_count_get, NULL,
       NULL, NULL },
+    { SAI_NEXT_HOP_GROUP_ATTR_NEXT_HOP_MEMBER_LIST,
+      { false, false, false, true },
+      { false, false, false, true },
+      stub_next_hop_group_member_list_get, NULL,
+      NULL, NULL },
     { SAI_NEXT_HOP_GROUP_ATTR_TYPE,
       { true, false, false, true },
       { true, false, false, true },
       stub_next_hop_group_type_get, NULL,
       NULL, NULL },
-    { SAI_NEXT_HOP_GROUP_ATTR_NEXT_HOP_LIST,
+};
+
+static const sai_vendor_attribute_entry_t next_hop_group_member_vendor_attribs[] = {
+    { SAI_NEXT_HOP_GROUP_MEMBER_ATTR_NEXT_HOP_GROUP_ID,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_next_hop_group_member_group_get, NULL,
+      NULL, NULL },
+    { SAI_NEXT_HOP_GROUP_MEMBER_ATTR_NEXT_HOP_ID,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_next_hop_group_member_hop_get, NULL,
+      NULL, NULL },
+    { SAI_NEXT_HOP_GROUP_MEMBER_ATTR_WEIGHT,
       { true, false, true, true },
       { true, false, true, true },
-      stub_next_hop_group_hop_list_get, NULL,
-      stub_next_hop_group_hop_list_set, NULL },
+      stub_next_hop_group_member_weight_get, NULL,
+      stub_next_hop_group_member_weight_set, NULL },
 };
 
 /* State DB *************/
 #define ECMP_MAX_PATHS 64
 
-typedef struct _stub_next_hop_group_t {
-    uint32_t        next_hop_count;
-    sai_object_id_t next_hop_list[ECMP_MAX_PATHS];
+/* Largest bucket table a weighted group may be expanded into */
+#define ECMP_MAX_BUCKETS 512
+
+/* Allowed deviation of a member traffic share from its configured weight share,
+ * relative to the configured share, in 1/1000 units */
+#define ECMP_WEIGHT_TOLERANCE 50
+
+#define NEXT_HOP_GROUP_MEMBER_DEFAULT_WEIGHT 1
+
+typedef struct _stub_next_hop_group_member_t {
+    uint32_t        next_hop_group_id;
+    sai_object_id_t next_hop_id;
+    uint32_t        weight;
     bool            is_valid;
+} stub_next_hop_group_member_t;
+
+/*
+ * Next hop group as seen by the caller. The forwarding state lives in the
+ * ECMP group it points to, which is shared by all next hop groups having the
+ * same set of next hops and weights.
+ * Members may be next hop groups, resolved when forwarding. user_count counts
+ * the groups using this group as member, child_group_count the members of this
+ * group that are groups. Only one level of groups as members is allowed, so a
+ * group never has both.
+ */
+typedef struct _stub_next_hop_group_t {
+    sai_next_hop_group_type_t type;
+    uint32_t                  member_count;
+    uint32_t                  member_list[ECMP_MAX_PATHS];
+    uint32_t                  ecmp_group_id;
+    uint32_t                  user_count;
+    uint32_t                  child_group_count;
+    bool                      is_valid;
 } stub_next_hop_group_t;
 
-#define MAX_NEXT_HOP_GROUP_NUMBER 1000
-static stub_next_hop_group_t next_hop_group_db[MAX_NEXT_HOP_GROUP_NUMBER];
+/*
+ * Hardware ECMP group. Paths are kept in slots 0..path_count-1. Traffic is
+ * spread over bucket_count buckets, each holding the slot of the path it is
+ * sent to, with bucket_share[slot] buckets owned by every path.
+ * The group is in use while ref_count is not zero, and is found by content
+ * through the hash chain starting at ecmp_group_hash_heads.
+ */
+typedef struct _stub_ecmp_group_t {
+    uint32_t        ref_count;
+    uint32_t        hash;
+    uint32_t        hash_next;
+    uint32_t        path_count;
+    sai_object_id_t next_hop_list[ECMP_MAX_PATHS];
+    uint32_t        weights[ECMP_MAX_PATHS];
+    uint32_t        bucket_count;
+    uint16_t        bucket_share[ECMP_MAX_PATHS];
+    uint8_t         buckets[ECMP_MAX_BUCKETS];
+} stub_ecmp_group_t;
+
+#define MAX_NEXT_HOP_GROUP_NUMBER        4096
+#define MAX_NEXT_HOP_GROUP_MEMBER_NUMBER 16000
+#define MAX_ECMP_GROUP_NUMBER            1000
+#define ECMP_GROUP_HASH_SIZE             1024
+#define ECMP_GROUP_NONE                  0xFFFFFFFF
+static stub_next_hop_group_t        next_hop_group_db[MAX_NEXT_HOP_GROUP_NUMBER];
+static stub_next_hop_group_member_t next_hop_group_member_db[MAX_NEXT_HOP_GROUP_MEMBER_NUMBER];
+static stub_ecmp_group_t            ecmp_group_db[MAX_ECMP_GROUP_NUMBER];
+static uint32_t                     ecmp_group_hash_heads[ECMP_GROUP_HASH_SIZE];
 
 void db_init_next_hop_group()
 {
+    uint32_t ii;
+
     memset(next_hop_group_db, 0, sizeof(next_hop_group_db));
-}
+    memset(next_hop_group_member_db, 0, sizeof(next_hop_group_member_db));
+    memset(ecmp_group_db, 0, sizeof(ecmp_group_db));
 
-sai_status_t db_get_next_hop_group(_In_ uint32_t next_hop_group_id, _Out_ sai_object_list_t   *next_hop_list)
-{
-    if (NULL == next_hop_list) {
-        STUB_LOG_ERR("NULL next hop list param\n");
-        return SAI_STATUS_INVALID_PARAMETER;
+    for (ii = 0; ii < ECMP_GROUP_HASH_SIZE; ii++) {
+        ecmp_group_hash_heads[ii] = ECMP_GROUP_NONE;
     }
+}
 
+static sai_status_t db_get_group(_In_ uint32_t next_hop_group_id, _Out_ stub_next_hop_group_t **group)
+{
     if ((next_hop_group_id >= MAX_NEXT_HOP_GROUP_NUMBER) ||
         (!next_hop_group_db[next_hop_group_id].is_valid)) {
         STUB_LOG_ERR("Invalid next hop group ID %u\n", next_hop_group_id);
         return SAI_STATUS_INVALID_PARAMETER;
     }
 
-    next_hop_list->count = next_hop_group_db[next_hop_group_id].next_hop_count;
-    next_hop_list->list  = next_hop_group_db[next_hop_group_id].next_hop_list;
+    *group = &next_hop_group_db[next_hop_group_id];
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t db_get_member(_In_ uint32_t member_id, _Out_ stub_next_hop_group_member_t **member)
+{
+    if ((member_id >= MAX_NEXT_HOP_GROUP_MEMBER_NUMBER) ||
+        (!next_hop_group_member_db[member_id].is_valid)) {
+        STUB_LOG_ERR("Invalid next hop group member ID %u\n", member_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *member = &next_hop_group_member_db[member_id];
 
     return SAI_STATUS_SUCCESS;
 }
@@ -121,178 +235,721 @@ static sai_status_t db_find_free_index(_Out_ uint32_t *free_index)
     return SAI_STATUS_TABLE_FULL;
 }
 
-static sai_status_t validate_next_hop_list(_In_ uint32_t               next_hop_count,
-                                           _In_ const sai_object_id_t* nexthops,
-                                           _In_ uint32_t               param_index)
+static sai_status_t db_find_free_member_index(_Out_ uint32_t *free_index)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < MAX_NEXT_HOP_GROUP_MEMBER_NUMBER; ii++) {
+        if (false == next_hop_group_member_db[ii].is_valid) {
+            *free_index = ii;
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+
+    STUB_LOG_ERR("Next hop group member table full\n");
+    return SAI_STATUS_TABLE_FULL;
+}
+
+static sai_status_t db_find_free_ecmp_index(_Out_ uint32_t *free_index)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < MAX_ECMP_GROUP_NUMBER; ii++) {
+        if (0 == ecmp_group_db[ii].ref_count) {
+            *free_index = ii;
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+
+    STUB_LOG_ERR("ECMP group table full\n");
+    return SAI_STATUS_INSUFFICIENT_RESOURCES;
+}
+
+/*
+ * Split bucket_count buckets between the paths proportionally to their
+ * weights, using largest remainder rounding.
+ */
+static void ecmp_group_apportion(_In_ const uint32_t *weights,
+                                 _In_ uint32_t        count,
+                                 _In_ uint64_t        weight_sum,
+                                 _In_ uint32_t        bucket_count,
+                                 _Out_ uint16_t      *shares)
+{
+    uint64_t remainders[ECMP_MAX_PATHS];
+    uint32_t ii, best, assigned = 0;
+
+    for (ii = 0; ii < count; ii++) {
+        shares[ii]     = (uint16_t)(((uint64_t)weights[ii] * bucket_count) / weight_sum);
+        remainders[ii] = ((uint64_t)weights[ii] * bucket_count) % weight_sum;
+        assigned      += shares[ii];
+    }
+
+    /* Less than count buckets are left, hand them out by largest remainder */
+    while (assigned < bucket_count) {
+        best = 0;
+        for (ii = 1; ii < count; ii++) {
+            if (remainders[ii] > remainders[best]) {
+                best = ii;
+            }
+        }
+        shares[best]++;
+        remainders[best] = 0;
+        assigned++;
+    }
+}
+
+static bool ecmp_group_shares_within_tolerance(_In_ const uint32_t *weights,
+                                               _In_ uint32_t        count,
+                                               _In_ uint64_t        weight_sum,
+                                               _In_ uint32_t        bucket_count,
+                                               _In_ const uint16_t *shares)
+{
+    uint64_t ideal, actual, diff;
+    uint32_t ii;
+
+    for (ii = 0; ii < count; ii++) {
+        if (0 == weights[ii]) {
+            continue;
+        }
+
+        /* Compare shares[ii] / bucket_count against weights[ii] / weight_sum */
+        ideal  = (uint64_t)weights[ii] * bucket_count;
+        actual = (uint64_t)shares[ii] * weight_sum;
+        diff   = (actual > ideal) ? (actual - ideal) : (ideal - actual);
+
+        if (diff * 1000 > ideal * ECMP_WEIGHT_TOLERANCE) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Pick the bucket table size for the given weights and fill the per path shares.
+ * The current size is kept when it still satisfies the tolerance, so that a weight
+ * change only moves the buckets it has to. Otherwise the smallest size within
+ * tolerance is chosen, which bounds the table size for the configured error.
+ */
+static uint32_t ecmp_group_size_for_weights(_In_ const uint32_t *weights,
+                                            _In_ uint32_t        count,
+                                            _In_ uint32_t        current_size,
+                                            _Out_ uint16_t      *shares)
+{
+    uint64_t weight_sum = 0;
+    uint32_t ii, active = 0, size;
+
+    for (ii = 0; ii < count; ii++) {
+        weight_sum += weights[ii];
+        if (0 != weights[ii]) {
+            active++;
+        }
+    }
+
+    if (0 == active) {
+        memset(shares, 0, sizeof(*shares) * count);
+        return 0;
+    }
+
+    if (current_size >= active) {
+        ecmp_group_apportion(weights, count, weight_sum, current_size, shares);
+        if (ecmp_group_shares_within_tolerance(weights, count, weight_sum, current_size, shares)) {
+            return current_size;
+        }
+    }
+
+    for (size = active; size <= ECMP_MAX_BUCKETS; size++) {
+        ecmp_group_apportion(weights, count, weight_sum, size, shares);
+        if (ecmp_group_shares_within_tolerance(weights, count, weight_sum, size, shares)) {
+            return size;
+        }
+    }
+
+    STUB_LOG_WRN("Weights can't be expanded within tolerance into %u buckets, using best effort\n",
+                 ECMP_MAX_BUCKETS);
+    ecmp_group_apportion(weights, count, weight_sum, ECMP_MAX_BUCKETS, shares);
+    return ECMP_MAX_BUCKETS;
+}
+
+/*
+ * Bring the bucket table to the new shares. When the table size is unchanged,
+ * only the buckets of paths that lost share are reassigned, to paths that
+ * gained share, and all other flows stay on their next hop.
+ */
+static void ecmp_group_update_buckets(_Inout_ stub_ecmp_group_t *ecmp,
+                                      _In_ uint32_t              bucket_count,
+                                      _In_ const uint16_t       *shares)
+{
+    uint16_t owned[ECMP_MAX_PATHS];
+    uint16_t free_buckets[ECMP_MAX_BUCKETS];
+    uint32_t ii, jj, slot, free_count = 0, bucket = 0;
+
+    if (bucket_count != ecmp->bucket_count) {
+        for (slot = 0; slot < ecmp->path_count; slot++) {
+            for (jj = 0; jj < shares[slot]; jj++) {
+                ecmp->buckets[bucket++] = (uint8_t)slot;
+            }
+        }
+    } else {
+        memcpy(owned, ecmp->bucket_share, sizeof(owned));
+
+        for (ii = 0; ii < bucket_count; ii++) {
+            slot = ecmp->buckets[ii];
+            if (owned[slot] > shares[slot]) {
+                owned[slot]--;
+                free_buckets[free_count++] = (uint16_t)ii;
+            }
+        }
+
+        for (slot = 0; slot < ecmp->path_count; slot++) {
+            while (owned[slot] < shares[slot]) {
+                assert(free_count > 0);
+                ecmp->buckets[free_buckets[--free_count]] = (uint8_t)slot;
+                owned[slot]++;
+            }
+        }
+    }
+
+    ecmp->bucket_count = bucket_count;
+    memset(ecmp->bucket_share, 0, sizeof(ecmp->bucket_share));
+    memcpy(ecmp->bucket_share, shares, sizeof(*shares) * ecmp->path_count);
+}
+
+static void ecmp_group_rebalance(_Inout_ stub_ecmp_group_t *ecmp, _In_ const uint32_t *weights)
+{
+    uint16_t shares[ECMP_MAX_PATHS];
+    uint32_t bucket_count;
+
+    bucket_count = ecmp_group_size_for_weights(weights, ecmp->path_count, ecmp->bucket_count, shares);
+    ecmp_group_update_buckets(ecmp, bucket_count, shares);
+}
+
+static uint32_t next_hop_in_list(_In_ sai_object_id_t        next_hop_id,
+                                 _In_ uint32_t               next_hop_count,
+                                 _In_ const sai_object_id_t *next_hops)
 {
     uint32_t ii;
 
     for (ii = 0; ii < next_hop_count; ii++) {
-        if (SAI_OBJECT_TYPE_NEXT_HOP != sai_object_type_query(nexthops[ii])) {
-            STUB_LOG_ERR("Invalid next hop object type %s, index %u\n",
-                         SAI_TYPE_STR(sai_object_type_query(nexthops[ii])), ii);
-            return SAI_STATUS_INVALID_ATTR_VALUE_0 + param_index;
+        if (next_hop_id == next_hops[ii]) {
+            return ii;
         }
     }
 
-    return SAI_STATUS_SUCCESS;
+    return next_hop_count;
 }
 
-static sai_status_t db_create_next_hop_group(_Out_ uint32_t               *next_hop_group_id,
-                                             _In_ const sai_object_list_t *next_hop_list,
-                                             _In_ uint32_t                 param_index)
+/*
+ * Bring an ECMP group to the given paths and weights. Removed paths are
+ * drained first and their slots reused, then weights are applied and new
+ * paths added, moving as few buckets as possible.
+ */
+static void ecmp_group_sync(_Inout_ stub_ecmp_group_t *ecmp,
+                            _In_ const sai_object_id_t *next_hops,
+                            _In_ const uint32_t        *weights,
+                            _In_ uint32_t               count)
 {
-    sai_status_t status;
+    uint32_t new_weights[ECMP_MAX_PATHS];
+    bool     removed[ECMP_MAX_PATHS];
+    bool     any_removed = false;
+    uint32_t slot, last, idx, ii;
+
+    for (slot = 0; slot < ecmp->path_count; slot++) {
+        idx               = next_hop_in_list(ecmp->next_hop_list[slot], count, next_hops);
+        removed[slot]     = (idx == count);
+        new_weights[slot] = removed[slot] ? 0 : ecmp->weights[slot];
+        any_removed      |= removed[slot];
+    }
 
-    if (NULL == next_hop_group_id) {
-        STUB_LOG_ERR("NULL next hop group id param\n");
-        return SAI_STATUS_INVALID_PARAMETER;
+    if (any_removed) {
+        ecmp_group_rebalance(ecmp, new_weights);
+
+        for (slot = ecmp->path_count; slot-- > 0;) {
+            if (!removed[slot]) {
+                continue;
+            }
+            last = ecmp->path_count - 1;
+            if (slot != last) {
+                ecmp->next_hop_list[slot] = ecmp->next_hop_list[last];
+                ecmp->bucket_share[slot]  = ecmp->bucket_share[last];
+                new_weights[slot]         = new_weights[last];
+                for (ii = 0; ii < ecmp->bucket_count; ii++) {
+                    if (last == ecmp->buckets[ii]) {
+                        ecmp->buckets[ii] = (uint8_t)slot;
+                    }
+                }
+            }
+            ecmp->bucket_share[last] = 0;
+            ecmp->path_count--;
+        }
     }
 
-    if (NULL == next_hop_list) {
-        STUB_LOG_ERR("NULL next hop list param\n");
-        return SAI_STATUS_INVALID_PARAMETER;
+    for (ii = 0; ii < count; ii++) {
+        slot = next_hop_in_list(next_hops[ii], ecmp->path_count, ecmp->next_hop_list);
+        if (slot == ecmp->path_count) {
+            ecmp->next_hop_list[slot] = next_hops[ii];
+            ecmp->bucket_share[slot]  = 0;
+            ecmp->path_count++;
+        }
+        new_weights[slot] = weights[ii];
     }
 
-    if (next_hop_list->count > ECMP_MAX_PATHS) {
-        STUB_LOG_ERR("Next hop count %u bigger than maximum %u\n", next_hop_list->count, ECMP_MAX_PATHS);
-        return SAI_STATUS_INVALID_ATTR_VALUE_0 + param_index;
+    memcpy(ecmp->weights, new_weights, sizeof(*new_weights) * ecmp->path_count);
+    ecmp_group_rebalance(ecmp, new_weights);
+}
+
+/* FNV-1a over the (next hop, weight) pairs, independent of their order */
+static uint32_t ecmp_group_content_hash(_In_ const sai_object_id_t *next_hops,
+                                        _In_ const uint32_t        *weights,
+                                        _In_ uint32_t               count)
+{
+    uint64_t keys[ECMP_MAX_PATHS][2], tmp[2];
+    uint32_t hash = 2166136261u;
+    uint32_t ii, jj, byte;
+
+    for (ii = 0; ii < count; ii++) {
+        keys[ii][0] = next_hops[ii];
+        keys[ii][1] = weights[ii];
+        for (jj = ii; jj > 0 && keys[jj - 1][0] > keys[jj][0]; jj--) {
+            memcpy(tmp, keys[jj], sizeof(tmp));
+            memcpy(keys[jj], keys[jj - 1], sizeof(tmp));
+            memcpy(keys[jj - 1], tmp, sizeof(tmp));
+        }
     }
 
-    if (0 == next_hop_list->count) {
-        STUB_LOG_ERR("Can't create empty next hop group\n");
-        return SAI_STATUS_INVALID_ATTR_VALUE_0 + param_index;
+    for (ii = 0; ii < count; ii++) {
+        for (jj = 0; jj < 2; jj++) {
+            for (byte = 0; byte < sizeof(uint64_t); byte++) {
+                hash ^= (uint8_t)(keys[ii][jj] >> (byte * 8));
+                hash *= 16777619u;
+            }
+        }
     }
 
-    if (SAI_STATUS_SUCCESS !=
-        (status = db_find_free_index(next_hop_group_id))) {
-        return status;
+    return hash;
+}
+
+static bool ecmp_group_content_equal(_In_ const stub_ecmp_group_t *ecmp,
+                                     _In_ const sai_object_id_t   *next_hops,
+                                     _In_ const uint32_t          *weights,
+                                     _In_ uint32_t                 count)
+{
+    uint32_t ii, slot;
+
+    if (count != ecmp->path_count) {
+        return false;
     }
 
-    if (SAI_STATUS_SUCCESS !=
-        (status = validate_next_hop_list(next_hop_list->count, next_hop_list->list, param_index))) {
+    for (ii = 0; ii < count; ii++) {
+        slot = next_hop_in_list(next_hops[ii], ecmp->path_count, ecmp->next_hop_list);
+        if ((slot == ecmp->path_count) || (weights[ii] != ecmp->weights[slot])) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static uint32_t db_find_ecmp_group(_In_ uint32_t               hash,
+                                   _In_ const sai_object_id_t *next_hops,
+                                   _In_ const uint32_t        *weights,
+                                   _In_ uint32_t               count)
+{
+    uint32_t ecmp_id;
+
+    for (ecmp_id = ecmp_group_hash_heads[hash % ECMP_GROUP_HASH_SIZE];
+         ecmp_id != ECMP_GROUP_NONE;
+         ecmp_id = ecmp_group_db[ecmp_id].hash_next) {
+        if ((hash == ecmp_group_db[ecmp_id].hash) &&
+            ecmp_group_content_equal(&ecmp_group_db[ecmp_id], next_hops, weights, count)) {
+            return ecmp_id;
+        }
+    }
+
+    return ECMP_GROUP_NONE;
+}
+
+static void db_ecmp_group_hash_insert(_In_ uint32_t ecmp_id, _In_ uint32_t hash)
+{
+    ecmp_group_db[ecmp_id].hash                   = hash;
+    ecmp_group_db[ecmp_id].hash_next              = ecmp_group_hash_heads[hash % ECMP_GROUP_HASH_SIZE];
+    ecmp_group_hash_heads[hash % ECMP_GROUP_HASH_SIZE] = ecmp_id;
+}
+
+static void db_ecmp_group_hash_remove(_In_ uint32_t ecmp_id)
+{
+    uint32_t *link = &ecmp_group_hash_heads[ecmp_group_db[ecmp_id].hash % ECMP_GROUP_HASH_SIZE];
+
+    while (*link != ecmp_id) {
+        assert(*link != ECMP_GROUP_NONE);
+        link = &ecmp_group_db[*link].hash_next;
+    }
+    *link = ecmp_group_db[ecmp_id].hash_next;
+}
+
+static void db_release_ecmp_group(_In_ uint32_t ecmp_id)
+{
+    if (ECMP_GROUP_NONE == ecmp_id) {
+        return;
+    }
+
+    assert(ecmp_group_db[ecmp_id].ref_count > 0);
+    if (0 == --ecmp_group_db[ecmp_id].ref_count) {
+        db_ecmp_group_hash_remove(ecmp_id);
+    }
+}
+
+/*
+ * Point a next hop group at the ECMP group matching its current members.
+ * An existing ECMP group with the same content is shared. Otherwise a group
+ * used only by this next hop group is updated in place, and a shared one is
+ * copied before the update, so the other users are not affected.
+ */
+static sai_status_t db_next_hop_group_update_ecmp(_Inout_ stub_next_hop_group_t *group)
+{
+    sai_object_id_t next_hops[ECMP_MAX_PATHS];
+    uint32_t        weights[ECMP_MAX_PATHS];
+    uint32_t        ii, hash, ecmp_id, old_ecmp_id = group->ecmp_group_id;
+    sai_status_t    status;
+
+    if (0 == group->member_count) {
+        db_release_ecmp_group(old_ecmp_id);
+        group->ecmp_group_id = ECMP_GROUP_NONE;
+        return SAI_STATUS_SUCCESS;
+    }
+
+    for (ii = 0; ii < group->member_count; ii++) {
+        next_hops[ii] = next_hop_group_member_db[group->member_list[ii]].next_hop_id;
+        weights[ii]   = next_hop_group_member_db[group->member_list[ii]].weight;
+    }
+
+    hash    = ecmp_group_content_hash(next_hops, weights, group->member_count);
+    ecmp_id = db_find_ecmp_group(hash, next_hops, weights, group->member_count);
+
+    if (ECMP_GROUP_NONE != ecmp_id) {
+        if (ecmp_id != old_ecmp_id) {
+            ecmp_group_db[ecmp_id].ref_count++;
+            db_release_ecmp_group(old_ecmp_id);
+            group->ecmp_group_id = ecmp_id;
+            STUB_LOG_DBG("Sharing ECMP group %u, %u users\n", ecmp_id, ecmp_group_db[ecmp_id].ref_count);
+        }
+        return SAI_STATUS_SUCCESS;
+    }
+
+    if ((ECMP_GROUP_NONE != old_ecmp_id) && (1 == ecmp_group_db[old_ecmp_id].ref_count)) {
+        db_ecmp_group_hash_remove(old_ecmp_id);
+        ecmp_group_sync(&ecmp_group_db[old_ecmp_id], next_hops, weights, group->member_count);
+        db_ecmp_group_hash_insert(old_ecmp_id, hash);
+        return SAI_STATUS_SUCCESS;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_find_free_ecmp_index(&ecmp_id))) {
         return status;
     }
 
-    next_hop_group_db[*next_hop_group_id].next_hop_count = next_hop_list->count;
-    memcpy(next_hop_group_db[*next_hop_group_id].next_hop_list,
-           next_hop_list->list,
-           sizeof(sai_object_id_t) * next_hop_list->count);
-    next_hop_group_db[*next_hop_group_id].is_valid = true;
+    if (ECMP_GROUP_NONE != old_ecmp_id) {
+        memcpy(&ecmp_group_db[ecmp_id], &ecmp_group_db[old_ecmp_id], sizeof(ecmp_group_db[ecmp_id]));
+    } else {
+        memset(&ecmp_group_db[ecmp_id], 0, sizeof(ecmp_group_db[ecmp_id]));
+    }
+    ecmp_group_db[ecmp_id].ref_count = 1;
+    ecmp_group_sync(&ecmp_group_db[ecmp_id], next_hops, weights, group->member_count);
+    db_ecmp_group_hash_insert(ecmp_id, hash);
+
+    db_release_ecmp_group(old_ecmp_id);
+    group->ecmp_group_id = ecmp_id;
 
     return SAI_STATUS_SUCCESS;
 }
 
-static sai_status_t db_remove_next_hop_group(_In_ uint32_t next_hop_group_id)
+/* Spread the flow hash again for the member group, so that its choice is
+ * independent of the bucket chosen in the upper group */
+static uint32_t next_hop_group_member_hash(_In_ uint32_t hash)
 {
-    if ((next_hop_group_id >= MAX_NEXT_HOP_GROUP_NUMBER) ||
-        (!next_hop_group_db[next_hop_group_id].is_valid)) {
-        STUB_LOG_ERR("Invalid next hop group ID %u\n", next_hop_group_id);
-        return SAI_STATUS_INVALID_PARAMETER;
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6Bu;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35u;
+
+    return hash ^ (hash >> 16);
+}
+
+static sai_status_t db_ecmp_group_select(_In_ uint32_t ecmp_id, _In_ uint32_t hash, _Out_ uint32_t *slot)
+{
+    if ((ECMP_GROUP_NONE == ecmp_id) || (0 == ecmp_group_db[ecmp_id].bucket_count)) {
+        return SAI_STATUS_ITEM_NOT_FOUND;
     }
 
-    next_hop_group_db[next_hop_group_id].is_valid = false;
+    *slot = ecmp_group_db[ecmp_id].buckets[hash % ecmp_group_db[ecmp_id].bucket_count];
 
     return SAI_STATUS_SUCCESS;
 }
 
-sai_status_t db_update_next_hop_group_list(_In_ uint32_t next_hop_group_id, _In_ sai_object_list_t next_hop_list)
+/*
+ * Resolve a path of an ECMP group to a next hop. A path that is a next hop
+ * group is looked up in the ECMP group it currently points to, so changing
+ * its members takes effect in every group using it.
+ */
+static sai_status_t db_ecmp_group_resolve(_In_ uint32_t ecmp_id, _In_ uint32_t slot, _In_ uint32_t hash,
+                                          _Out_ sai_object_id_t *next_hop_id)
 {
+    sai_object_id_t path = ecmp_group_db[ecmp_id].next_hop_list[slot];
+    uint32_t        child_id, child_slot, child_ecmp_id;
+    sai_status_t    status;
+
+    if (SAI_OBJECT_TYPE_NEXT_HOP_GROUP != sai_object_type_query(path)) {
+        *next_hop_id = path;
+        return SAI_STATUS_SUCCESS;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(path, SAI_OBJECT_TYPE_NEXT_HOP_GROUP, &child_id))) {
+        return status;
+    }
+
+    child_ecmp_id = next_hop_group_db[child_id].ecmp_group_id;
+    if (SAI_STATUS_SUCCESS !=
+        (status = db_ecmp_group_select(child_ecmp_id, next_hop_group_member_hash(hash), &child_slot))) {
+        return status;
+    }
+
+    *next_hop_id = ecmp_group_db[child_ecmp_id].next_hop_list[child_slot];
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Select the next hop for a flow hash. This is the forwarding path lookup,
+ * a bucket table read per level regardless of group size and weights.
+ * Flows of a member group left without next hops are moved to the following
+ * paths of the group until the member group is updated.
+ */
+sai_status_t db_next_hop_group_select(_In_ uint32_t next_hop_group_id, _In_ uint32_t hash,
+                                      _Out_ sai_object_id_t *next_hop_id)
+{
+    uint32_t     ecmp_id, slot, ii;
     sai_status_t status;
 
     if ((next_hop_group_id >= MAX_NEXT_HOP_GROUP_NUMBER) ||
         (!next_hop_group_db[next_hop_group_id].is_valid)) {
-        STUB_LOG_ERR("Invalid next hop group ID %u\n", next_hop_group_id);
         return SAI_STATUS_INVALID_PARAMETER;
     }
 
-    if (next_hop_list.count > ECMP_MAX_PATHS) {
-        STUB_LOG_ERR("Next hop count %u bigger than maximum %u\n", next_hop_list.count, ECMP_MAX_PATHS);
-        return SAI_STATUS_INVALID_ATTR_VALUE_0;
+    ecmp_id = next_hop_group_db[next_hop_group_id].ecmp_group_id;
+    if (SAI_STATUS_SUCCESS != (status = db_ecmp_group_select(ecmp_id, hash, &slot))) {
+        return status;
+    }
+
+    for (ii = 0; ii < ecmp_group_db[ecmp_id].path_count; ii++) {
+        status = db_ecmp_group_resolve(ecmp_id, (slot + ii) % ecmp_group_db[ecmp_id].path_count, hash, next_hop_id);
+        if (SAI_STATUS_ITEM_NOT_FOUND != status) {
+            return status;
+        }
+    }
+
+    return SAI_STATUS_ITEM_NOT_FOUND;
+}
+
+/*
+ * Report ECMP group sharing : number of non empty next hop groups, number of
+ * ECMP groups backing them, and the ECMP group capacity.
+ */
+void db_next_hop_group_sharing_get(_Out_ uint32_t *group_count,
+                                   _Out_ uint32_t *ecmp_group_count,
+                                   _Out_ uint32_t *ecmp_group_capacity)
+{
+    uint32_t ii;
+
+    *group_count         = 0;
+    *ecmp_group_count    = 0;
+    *ecmp_group_capacity = MAX_ECMP_GROUP_NUMBER;
+
+    for (ii = 0; ii < MAX_NEXT_HOP_GROUP_NUMBER; ii++) {
+        if (next_hop_group_db[ii].is_valid && (ECMP_GROUP_NONE != next_hop_group_db[ii].ecmp_group_id)) {
+            (*group_count)++;
+        }
+    }
+
+    for (ii = 0; ii < MAX_ECMP_GROUP_NUMBER; ii++) {
+        if (0 != ecmp_group_db[ii].ref_count) {
+            (*ecmp_group_count)++;
+        }
+    }
+}
+
+static sai_status_t db_create_next_hop_group(_Out_ uint32_t *next_hop_group_id, _In_ sai_next_hop_group_type_t type)
+{
+    sai_status_t status;
+
+    if (NULL == next_hop_group_id) {
+        STUB_LOG_ERR("NULL next hop group id param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
     }
 
     if (SAI_STATUS_SUCCESS !=
-        (status = validate_next_hop_list(next_hop_list.count, next_hop_list.list, 0))) {
+        (status = db_find_free_index(next_hop_group_id))) {
         return status;
     }
 
-    next_hop_group_db[next_hop_group_id].next_hop_count = next_hop_list.count;
-    memcpy(next_hop_group_db[next_hop_group_id].next_hop_list,
-           next_hop_list.list,
-           sizeof(sai_object_id_t) * next_hop_list.count);
+    memset(&next_hop_group_db[*next_hop_group_id], 0, sizeof(next_hop_group_db[*next_hop_group_id]));
+    next_hop_group_db[*next_hop_group_id].type          = type;
+    next_hop_group_db[*next_hop_group_id].ecmp_group_id = ECMP_GROUP_NONE;
+    next_hop_group_db[*next_hop_group_id].is_valid      = true;
 
     return SAI_STATUS_SUCCESS;
 }
 
-sai_status_t db_add_members_next_hop_group_list(_In_ uint32_t               next_hop_group_id,
-                                                _In_ uint32_t               next_hop_count,
-                                                _In_ const sai_object_id_t* nexthops)
+static sai_status_t db_remove_next_hop_group(_In_ uint32_t next_hop_group_id)
 {
     stub_next_hop_group_t *group;
     sai_status_t           status;
 
-    if ((next_hop_group_id >= MAX_NEXT_HOP_GROUP_NUMBER) ||
-        (!next_hop_group_db[next_hop_group_id].is_valid)) {
-        STUB_LOG_ERR("Invalid next hop group ID %u\n", next_hop_group_id);
-        return SAI_STATUS_INVALID_PARAMETER;
+    if (SAI_STATUS_SUCCESS != (status = db_get_group(next_hop_group_id, &group))) {
+        return status;
     }
 
-    group = &next_hop_group_db[next_hop_group_id];
+    if (0 != group->member_count) {
+        STUB_LOG_ERR("Next hop group ID %u still has %u members\n", next_hop_group_id, group->member_count);
+        return SAI_STATUS_OBJECT_IN_USE;
+    }
 
-    if (next_hop_count + group->next_hop_count > ECMP_MAX_PATHS) {
-        STUB_LOG_ERR("Next hop count %u bigger than maximum %u\n",
-                     next_hop_count + group->next_hop_count, ECMP_MAX_PATHS);
-        return SAI_STATUS_INVALID_ATTR_VALUE_0;
+    if (0 != group->user_count) {
+        STUB_LOG_ERR("Next hop group ID %u is member of %u groups\n", next_hop_group_id, group->user_count);
+        return SAI_STATUS_OBJECT_IN_USE;
     }
 
-    if (SAI_STATUS_SUCCESS !=
-        (status = validate_next_hop_list(next_hop_count, nexthops, 0))) {
+    group->is_valid = false;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t db_create_next_hop_group_member(_Out_ uint32_t       *member_id,
+                                                    _In_ uint32_t         next_hop_group_id,
+                                                    _In_ sai_object_id_t  next_hop_id,
+                                                    _In_ uint32_t         weight)
+{
+    stub_next_hop_group_t *group, *child = NULL;
+    sai_status_t           status;
+    uint32_t               slot, child_id;
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_group(next_hop_group_id, &group))) {
         return status;
     }
 
-    memcpy(&group->next_hop_list[group->next_hop_count],
-           nexthops,
-           sizeof(sai_object_id_t) * next_hop_count);
-    group->next_hop_count += next_hop_count;
+    if (SAI_OBJECT_TYPE_NEXT_HOP_GROUP == sai_object_type_query(next_hop_id)) {
+        if ((SAI_STATUS_SUCCESS != (status = stub_object_to_type(next_hop_id, SAI_OBJECT_TYPE_NEXT_HOP_GROUP,
+                                                                 &child_id))) ||
+            (SAI_STATUS_SUCCESS != (status = db_get_group(child_id, &child)))) {
+            return status;
+        }
+
+        if (child_id == next_hop_group_id) {
+            STUB_LOG_ERR("Next hop group ID %u can't be member of itself\n", next_hop_group_id);
+            return SAI_STATUS_INVALID_PARAMETER;
+        }
+
+        if ((0 != group->user_count) || (0 != child->child_group_count)) {
+            STUB_LOG_ERR("Next hop group ID %u as member of group ID %u exceeds two group levels\n",
+                         child_id, next_hop_group_id);
+            return SAI_STATUS_NOT_SUPPORTED;
+        }
+    }
+
+    if (group->member_count >= ECMP_MAX_PATHS) {
+        STUB_LOG_ERR("Next hop count %u reached maximum %u\n", group->member_count, ECMP_MAX_PATHS);
+        return SAI_STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    for (slot = 0; slot < group->member_count; slot++) {
+        if (next_hop_id == next_hop_group_member_db[group->member_list[slot]].next_hop_id) {
+            STUB_LOG_ERR("Next hop already member of group ID %u\n", next_hop_group_id);
+            return SAI_STATUS_ITEM_ALREADY_EXISTS;
+        }
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_find_free_member_index(member_id))) {
+        return status;
+    }
+
+    next_hop_group_member_db[*member_id].next_hop_group_id = next_hop_group_id;
+    next_hop_group_member_db[*member_id].next_hop_id       = next_hop_id;
+    next_hop_group_member_db[*member_id].weight            = weight;
+    next_hop_group_member_db[*member_id].is_valid          = true;
+
+    group->member_list[group->member_count++] = *member_id;
+
+    if (SAI_STATUS_SUCCESS != (status = db_next_hop_group_update_ecmp(group))) {
+        group->member_count--;
+        next_hop_group_member_db[*member_id].is_valid = false;
+        return status;
+    }
+
+    if (NULL != child) {
+        child->user_count++;
+        group->child_group_count++;
+    }
 
     return SAI_STATUS_SUCCESS;
 }
 
-bool next_hop_in_list(sai_object_id_t nexthop, _In_ uint32_t next_hop_count, _In_ const sai_object_id_t* nexthops)
+static sai_status_t db_remove_next_hop_group_member(_In_ uint32_t member_id)
 {
-    uint32_t ii;
+    stub_next_hop_group_member_t *member;
+    stub_next_hop_group_t        *group;
+    sai_status_t                  status;
+    uint32_t                      slot, child_id;
 
-    for (ii = 0; ii < next_hop_count; ii++) {
-        if (nexthop == nexthops[ii]) {
-            return true;
+    if (SAI_STATUS_SUCCESS != (status = db_get_member(member_id, &member))) {
+        return status;
+    }
+
+    group = &next_hop_group_db[member->next_hop_group_id];
+
+    for (slot = 0; slot < group->member_count; slot++) {
+        if (member_id == group->member_list[slot]) {
+            break;
         }
     }
+    assert(slot < group->member_count);
+
+    group->member_list[slot] = group->member_list[--group->member_count];
+
+    if (SAI_STATUS_SUCCESS != (status = db_next_hop_group_update_ecmp(group))) {
+        group->member_list[group->member_count++] = member_id;
+        return status;
+    }
+
+    if (SAI_OBJECT_TYPE_NEXT_HOP_GROUP == sai_object_type_query(member->next_hop_id)) {
+        stub_object_to_type(member->next_hop_id, SAI_OBJECT_TYPE_NEXT_HOP_GROUP, &child_id);
+        next_hop_group_db[child_id].user_count--;
+        group->child_group_count--;
+    }
+
+    member->is_valid = false;
 
-    return false;
+    return SAI_STATUS_SUCCESS;
 }
 
-sai_status_t db_remove_members_next_hop_group_list(_In_ uint32_t               next_hop_group_id,
-                                                   _In_ uint32_t               next_hop_count,
-                                                   _In_ const sai_object_id_t* nexthops)
+static sai_status_t db_set_next_hop_group_member_weight(_In_ uint32_t member_id, _In_ uint32_t weight)
 {
-    stub_next_hop_group_t *group;
-    uint32_t               ii = 0;
+    stub_next_hop_group_member_t *member;
+    sai_status_t                  status;
+    uint32_t                      old_weight;
 
-    if ((next_hop_group_id >= MAX_NEXT_HOP_GROUP_NUMBER) ||
-        (!next_hop_group_db[next_hop_group_id].is_valid)) {
-        STUB_LOG_ERR("Invalid next hop group ID %u\n", next_hop_group_id);
-        return SAI_STATUS_INVALID_PARAMETER;
+    if (SAI_STATUS_SUCCESS != (status = db_get_member(member_id, &member))) {
+        return status;
     }
 
-    group = &next_hop_group_db[next_hop_group_id];
+    if (weight == member->weight) {
+        return SAI_STATUS_SUCCESS;
+    }
 
-    while (ii < group->next_hop_count) {
-        if (next_hop_in_list(group->next_hop_list[ii], next_hop_count, nexthops)) {
-            group->next_hop_count--;
-            group->next_hop_list[ii] = group->next_hop_list[group->next_hop_count];
-            continue;
-        }
-        ii++;
+    old_weight     = member->weight;
+    member->weight = weight;
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = db_next_hop_group_update_ecmp(&next_hop_group_db[member->next_hop_group_id]))) {
+        member->weight = old_weight;
+        return status;
     }
 
     return SAI_STATUS_SUCCESS;
@@ -311,12 +968,24 @@ static void next_hop_group_key_to_str(_In_ sai_object_id_t next_hop_group_id, _O
     }
 }
 
+static void next_hop_group_member_key_to_str(_In_ sai_object_id_t member_id, _Out_ char *key_str)
+{
+    uint32_t memberid;
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(member_id, SAI_OBJECT_TYPE_NEXT_HOP_GROUP_MEMBER, &memberid)) {
+        snprintf(key_str, MAX_KEY_STR_LEN, "invalid next hop group member id");
+    } else {
+        snprintf(key_str, MAX_KEY_STR_LEN, "next hop group member id %u", memberid);
+    }
+}
+
 /*
  * Routine Description:
  *    Create next hop group
  *
  * Arguments:
  *    [out] next_hop_group_id - next hop group id
+ *    [in] switch_id - switch id
  *    [in] attr_count - number of attributes
  *    [in] attr_list - array of attributes
  *
@@ -325,12 +994,13 @@ static void next_hop_group_key_to_str(_In_ sai_object_id_t next_hop_group_id, _O
  *    Failure status code on error
  */
 sai_status_t stub_create_next_hop_group(_Out_ sai_object_id_t     * next_hop_group_id,
+                                        _In_ sai_object_id_t        switch_id,
                                         _In_ uint32_t               attr_count,
                                         _In_ const sai_attribute_t *attr_list)
 {
     sai_status_t                 status;
-    const sai_attribute_value_t *type, *hop_list;
-    uint32_t                     type_index, hop_list_index, group_id = 0;
+    const sai_attribute_value_t *type;
+    uint32_t                     type_index, group_id = 0;
     char                         list_str[MAX_LIST_VALUE_STR_LEN];
     char                         key_str[MAX_KEY_STR_LEN];
 
@@ -354,20 +1024,14 @@ sai_status_t stub_create_next_hop_group(_Out_ sai_object_id_t     * next_hop_gro
 
     assert(SAI_STATUS_SUCCESS ==
            find_attrib_in_list(attr_count, attr_list, SAI_NEXT_HOP_GROUP_ATTR_TYPE, &type, &type_index));
-    assert(SAI_STATUS_SUCCESS ==
-           find_attrib_in_list(attr_count,
-                               attr_list,
-                               SAI_NEXT_HOP_GROUP_ATTR_NEXT_HOP_LIST,
-                               &hop_list,
-                               &hop_list_index));
 
-    if (SAI_NEXT_HOP_GROUP_ECMP != type->s32) {
+    if (SAI_NEXT_HOP_GROUP_TYPE_ECMP != type->s32) {
         STUB_LOG_ERR("Invalid next hop group type %d on create\n", type->s32);
         return SAI_STATUS_INVALID_ATTR_VALUE_0 + type_index;
     }
 
     if (SAI_STATUS_SUCCESS !=
-        (status = db_create_next_hop_group(&group_id, &(hop_list->objlist), hop_list_index))) {
+        (status = db_create_next_hop_group(&group_id, type->s32))) {
         return status;
     }
 
@@ -480,9 +1144,22 @@ sai_status_t stub_next_hop_group_type_get(_In_ const sai_object_key_t   *key,
                                           _Inout_ vendor_cache_t        *cache,
                                           void                          *arg)
 {
+    sai_status_t           status;
+    uint32_t               group_id;
+    stub_next_hop_group_t *group;
+
     STUB_LOG_ENTER();
 
-    value->s32 = SAI_NEXT_HOP_GROUP_ECMP;
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_NEXT_HOP_GROUP, &group_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_group(group_id, &group))) {
+        return status;
+    }
+
+    value->s32 = group->type;
 
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
@@ -495,9 +1172,9 @@ sai_status_t stub_next_hop_group_count_get(_In_ const sai_object_key_t   *key,
                                            _Inout_ vendor_cache_t        *cache,
                                            void                          *arg)
 {
-    sai_status_t      status;
-    uint32_t          group_id;
-    sai_object_list_t hop_list;
+    sai_status_t           status;
+    uint32_t               group_id;
+    stub_next_hop_group_t *group;
 
     STUB_LOG_ENTER();
 
@@ -506,27 +1183,27 @@ sai_status_t stub_next_hop_group_count_get(_In_ const sai_object_key_t   *key,
         return status;
     }
 
-    if (SAI_STATUS_SUCCESS !=
-        (status = db_get_next_hop_group(group_id, &hop_list))) {
+    if (SAI_STATUS_SUCCESS != (status = db_get_group(group_id, &group))) {
         return status;
     }
 
-    value->u32 = hop_list.count;
+    value->u32 = group->member_count;
 
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
 }
 
-/* Next hop list [sai_object_list_t] */
-sai_status_t stub_next_hop_group_hop_list_get(_In_ const sai_object_key_t   *key,
-                                              _Inout_ sai_attribute_value_t *value,
-                                              _In_ uint32_t                  attr_index,
-                                              _Inout_ vendor_cache_t        *cache,
-                                              void                          *arg)
+/* Next hop member list [sai_object_list_t] */
+sai_status_t stub_next_hop_group_member_list_get(_In_ const sai_object_key_t   *key,
+                                                 _Inout_ sai_attribute_value_t *value,
+                                                 _In_ uint32_t                  attr_index,
+                                                 _Inout_ vendor_cache_t        *cache,
+                                                 void                          *arg)
 {
-    sai_status_t      status;
-    uint32_t          group_id;
-    sai_object_list_t hop_list;
+    sai_status_t           status;
+    uint32_t               group_id, slot;
+    stub_next_hop_group_t *group;
+    sai_object_id_t        members[ECMP_MAX_PATHS];
 
     STUB_LOG_ENTER();
 
@@ -535,12 +1212,19 @@ sai_status_t stub_next_hop_group_hop_list_get(_In_ const sai_object_key_t   *key
         return status;
     }
 
-    if (SAI_STATUS_SUCCESS !=
-        (status = db_get_next_hop_group(group_id, &hop_list))) {
+    if (SAI_STATUS_SUCCESS != (status = db_get_group(group_id, &group))) {
         return status;
     }
 
-    if (SAI_STATUS_SUCCESS != (status = stub_fill_objlist(hop_list.list, hop_list.count, &value->objlist))) {
+    for (slot = 0; slot < group->member_count; slot++) {
+        if (SAI_STATUS_SUCCESS !=
+            (status = stub_create_object(SAI_OBJECT_TYPE_NEXT_HOP_GROUP_MEMBER, group->member_list[slot],
+                                         &members[slot]))) {
+            return status;
+        }
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = stub_fill_objlist(members, group->member_count, &value->objlist))) {
         return status;
     }
 
@@ -548,27 +1232,81 @@ sai_status_t stub_next_hop_group_hop_list_get(_In_ const sai_object_key_t   *key
     return SAI_STATUS_SUCCESS;
 }
 
-/* Next hop list [sai_object_list_t] */
-sai_status_t stub_next_hop_group_hop_list_set(_In_ const sai_object_key_t      *key,
-                                              _In_ const sai_attribute_value_t *value,
-                                              void                             *arg)
+/*
+ * Routine Description:
+ *    Create next hop group member
+ *
+ * Arguments:
+ *    [out] next_hop_group_member_id - next hop group member id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_next_hop_group_member(_Out_ sai_object_id_t     * next_hop_group_member_id,
+                                               _In_ uint32_t               attr_count,
+                                               _In_ const sai_attribute_t *attr_list)
 {
-    sai_status_t status;
-    uint32_t     group_id;
+    sai_status_t                 status;
+    const sai_attribute_value_t *group, *hop, *weight;
+    uint32_t                     group_index, hop_index, weight_index, group_id, member_id = 0;
+    uint32_t                     weight_value = NEXT_HOP_GROUP_MEMBER_DEFAULT_WEIGHT;
+    char                         list_str[MAX_LIST_VALUE_STR_LEN];
+    char                         key_str[MAX_KEY_STR_LEN];
 
     STUB_LOG_ENTER();
 
+    if (NULL == next_hop_group_member_id) {
+        STUB_LOG_ERR("NULL next hop group member id param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
     if (SAI_STATUS_SUCCESS !=
-        (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_NEXT_HOP_GROUP, &group_id))) {
+        (status =
+             check_attribs_metadata(attr_count, attr_list, next_hop_group_member_attribs,
+                                    next_hop_group_member_vendor_attribs, SAI_OPERATION_CREATE))) {
+        STUB_LOG_ERR("Failed attribs check\n");
         return status;
     }
 
+    sai_attr_list_to_str(attr_count, attr_list, next_hop_group_member_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create next hop group member, %s\n", list_str);
+
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_NEXT_HOP_GROUP_MEMBER_ATTR_NEXT_HOP_GROUP_ID, &group,
+                               &group_index));
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_NEXT_HOP_GROUP_MEMBER_ATTR_NEXT_HOP_ID, &hop,
+                               &hop_index));
+
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_NEXT_HOP_GROUP_MEMBER_ATTR_WEIGHT, &weight, &weight_index)) {
+        weight_value = weight->u32;
+    }
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(group->oid, SAI_OBJECT_TYPE_NEXT_HOP_GROUP, &group_id)) {
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + group_index;
+    }
+
+    if ((SAI_OBJECT_TYPE_NEXT_HOP != sai_object_type_query(hop->oid)) &&
+        (SAI_OBJECT_TYPE_NEXT_HOP_GROUP != sai_object_type_query(hop->oid))) {
+        STUB_LOG_ERR("Invalid next hop object type %s\n", SAI_TYPE_STR(sai_object_type_query(hop->oid)));
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + hop_index;
+    }
+
     if (SAI_STATUS_SUCCESS !=
-        (status = db_update_next_hop_group_list(group_id, value->objlist))) {
+        (status = db_create_next_hop_group_member(&member_id, group_id, hop->oid, weight_value))) {
         return status;
     }
 
-    /* TODO : update route with next hop list changes */
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_create_object(SAI_OBJECT_TYPE_NEXT_HOP_GROUP_MEMBER, member_id, next_hop_group_member_id))) {
+        return status;
+    }
+    next_hop_group_member_key_to_str(*next_hop_group_member_id, key_str);
+    STUB_LOG_NTC("Created next hop group member %s\n", key_str);
 
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
@@ -576,97 +1314,198 @@ sai_status_t stub_next_hop_group_hop_list_set(_In_ const sai_object_key_t      *
 
 /*
  * Routine Description:
- *    Add next hop to a group
+ *    Remove next hop group member
  *
  * Arguments:
- *    [in] next_hop_group_id - next hop group id
- *    [in] next_hop_count - number of next hops
- *    [in] nexthops - array of next hops
+ *    [in] next_hop_group_member_id - next hop group member id
  *
  * Return Values:
  *    SAI_STATUS_SUCCESS on success
  *    Failure status code on error
  */
-sai_status_t stub_add_next_hop_to_group(_In_ sai_object_id_t        next_hop_group_id,
-                                        _In_ uint32_t               next_hop_count,
-                                        _In_ const sai_object_id_t* nexthops)
+sai_status_t stub_remove_next_hop_group_member(_In_ sai_object_id_t next_hop_group_member_id)
 {
-    sai_status_t status;
-    char         value[MAX_LIST_VALUE_STR_LEN];
-    uint32_t     group_id;
     char         key_str[MAX_KEY_STR_LEN];
+    sai_status_t status;
+    uint32_t     member_id;
 
     STUB_LOG_ENTER();
 
-    if (NULL == nexthops) {
-        STUB_LOG_ERR("NULL nexthops param\n");
-        return SAI_STATUS_INVALID_PARAMETER;
-    }
-
-    next_hop_group_key_to_str(next_hop_group_id, key_str);
-    sai_nexthops_to_str(next_hop_count, nexthops, MAX_LIST_VALUE_STR_LEN, value);
-    STUB_LOG_NTC("Add next hops {%s} to %s\n", value, key_str);
+    next_hop_group_member_key_to_str(next_hop_group_member_id, key_str);
+    STUB_LOG_NTC("Remove next hop group member %s\n", key_str);
 
     if (SAI_STATUS_SUCCESS !=
-        (status = stub_object_to_type(next_hop_group_id, SAI_OBJECT_TYPE_NEXT_HOP_GROUP, &group_id))) {
+        (status = stub_object_to_type(next_hop_group_member_id, SAI_OBJECT_TYPE_NEXT_HOP_GROUP_MEMBER, &member_id))) {
         return status;
     }
 
     if (SAI_STATUS_SUCCESS !=
-        (status = db_add_members_next_hop_group_list(group_id, next_hop_count, nexthops))) {
+        (status = db_remove_next_hop_group_member(member_id))) {
         return status;
     }
 
-    /* TODO : update route with next hop list changes */
-
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
 }
 
 /*
  * Routine Description:
- *    Remove next hop from a group
+ *    Set Next Hop Group member attribute
  *
  * Arguments:
- *    [in] next_hop_group_id - next hop group id
- *    [in] next_hop_count - number of next hops
- *    [in] nexthops - array of next hops
+ *    [in] next_hop_group_member_id - next hop group member id
+ *    [in] attr - attribute
  *
  * Return Values:
  *    SAI_STATUS_SUCCESS on success
  *    Failure status code on error
  */
-sai_status_t stub_remove_next_hop_from_group(_In_ sai_object_id_t        next_hop_group_id,
-                                             _In_ uint32_t               next_hop_count,
-                                             _In_ const sai_object_id_t* nexthops)
+sai_status_t stub_set_next_hop_group_member_attribute(_In_ sai_object_id_t        next_hop_group_member_id,
+                                                      _In_ const sai_attribute_t *attr)
 {
-    sai_status_t status;
-    char         value[MAX_LIST_VALUE_STR_LEN];
-    uint32_t     group_id;
-    char         key_str[MAX_KEY_STR_LEN];
+    const sai_object_key_t key = { .object_id = next_hop_group_member_id };
+    char                   key_str[MAX_KEY_STR_LEN];
 
     STUB_LOG_ENTER();
 
-    if (NULL == nexthops) {
-        STUB_LOG_ERR("NULL nexthops param\n");
-        return SAI_STATUS_INVALID_PARAMETER;
+    next_hop_group_member_key_to_str(next_hop_group_member_id, key_str);
+    return sai_set_attribute(&key, key_str, next_hop_group_member_attribs, next_hop_group_member_vendor_attribs,
+                             attr);
+}
+
+/*
+ * Routine Description:
+ *    Get Next Hop Group member attribute
+ *
+ * Arguments:
+ *    [in] next_hop_group_member_id - next hop group member id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_next_hop_group_member_attribute(_In_ sai_object_id_t     next_hop_group_member_id,
+                                                      _In_ uint32_t            attr_count,
+                                                      _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = next_hop_group_member_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    next_hop_group_member_key_to_str(next_hop_group_member_id, key_str);
+    return sai_get_attributes(&key,
+                              key_str,
+                              next_hop_group_member_attribs,
+                              next_hop_group_member_vendor_attribs,
+                              attr_count,
+                              attr_list);
+}
+
+static sai_status_t next_hop_group_member_key_to_db(_In_ const sai_object_key_t          *key,
+                                                    _Out_ stub_next_hop_group_member_t **member)
+{
+    sai_status_t status;
+    uint32_t     member_id;
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_NEXT_HOP_GROUP_MEMBER, &member_id))) {
+        return status;
     }
 
-    next_hop_group_key_to_str(next_hop_group_id, key_str);
-    sai_nexthops_to_str(next_hop_count, nexthops, MAX_LIST_VALUE_STR_LEN, value);
-    STUB_LOG_NTC("Remove next hops {%s} from %s\n", value, key_str);
+    return db_get_member(member_id, member);
+}
+
+/* Next hop group id [sai_object_id_t] */
+sai_status_t stub_next_hop_group_member_group_get(_In_ const sai_object_key_t   *key,
+                                                  _Inout_ sai_attribute_value_t *value,
+                                                  _In_ uint32_t                  attr_index,
+                                                  _Inout_ vendor_cache_t        *cache,
+                                                  void                          *arg)
+{
+    sai_status_t                  status;
+    stub_next_hop_group_member_t *member;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = next_hop_group_member_key_to_db(key, &member))) {
+        return status;
+    }
 
     if (SAI_STATUS_SUCCESS !=
-        (status = stub_object_to_type(next_hop_group_id, SAI_OBJECT_TYPE_NEXT_HOP_GROUP, &group_id))) {
+        (status = stub_create_object(SAI_OBJECT_TYPE_NEXT_HOP_GROUP, member->next_hop_group_id, &value->oid))) {
         return status;
     }
 
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Next hop id [sai_object_id_t] */
+sai_status_t stub_next_hop_group_member_hop_get(_In_ const sai_object_key_t   *key,
+                                                _Inout_ sai_attribute_value_t *value,
+                                                _In_ uint32_t                  attr_index,
+                                                _Inout_ vendor_cache_t        *cache,
+                                                void                          *arg)
+{
+    sai_status_t                  status;
+    stub_next_hop_group_member_t *member;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = next_hop_group_member_key_to_db(key, &member))) {
+        return status;
+    }
+
+    value->oid = member->next_hop_id;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Member weight [uint32_t] (default to 1) */
+sai_status_t stub_next_hop_group_member_weight_get(_In_ const sai_object_key_t   *key,
+                                                   _Inout_ sai_attribute_value_t *value,
+                                                   _In_ uint32_t                  attr_index,
+                                                   _Inout_ vendor_cache_t        *cache,
+                                                   void                          *arg)
+{
+    sai_status_t                  status;
+    stub_next_hop_group_member_t *member;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = next_hop_group_member_key_to_db(key, &member))) {
+        return status;
+    }
+
+    value->u32 = member->weight;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Member weight [uint32_t] (default to 1) */
+sai_status_t stub_next_hop_group_member_weight_set(_In_ const sai_object_key_t      *key,
+                                                   _In_ const sai_attribute_value_t *value,
+                                                   void                             *arg)
+{
+    sai_status_t status;
+    uint32_t     member_id;
+
+    STUB_LOG_ENTER();
+
     if (SAI_STATUS_SUCCESS !=
-        (status = db_remove_members_next_hop_group_list(group_id, next_hop_count, nexthops))) {
+        (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_NEXT_HOP_GROUP_MEMBER, &member_id))) {
         return status;
     }
 
-    /* TODO : update route with next hop list changes */
+    if (SAI_STATUS_SUCCESS !=
+        (status = db_set_next_hop_group_member_weight(member_id, value->u32))) {
+        return status;
+    }
 
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
@@ -677,6 +1516,8 @@ const sai_next_hop_group_api_t next_hop_group_api = {
     stub_remove_next_hop_group,
     stub_set_next_hop_group_attribute,
     stub_get_next_hop_group_attribute,
-    stub_add_next_hop_to_group,
-    stub_remove_next_hop_from_group
+    stub_create_next_hop_group_member,
+    stub_remove_next_hop_group_member,
+    stub_set_next_hop_group_member_attribute,
+    stub_get_next_hop_group_member_attribute
 };
@@ -0,0 +1,448 @@
+/*
+ *  Copyright (C) 2014. Mellanox Technologies, Ltd. ALL RIGHTS RESERVED.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ */
+
+#include "sai.h"
+#include "stub_sai.h"
+#include "assert.h"
+#include "errno.h"
+#include "inttypes.h"
+#include "pthread.h"
+#include "sched.h"
+#include "time.h"
+
+#undef  __MODULE__
+#define __MODULE__ SAI_NOTIFICATION
+
+/*
+ * FDB and port state events are queued by the cores generating them and
+ * handed to the switch notifications by a dedicated thread, in arrays of up
+ * to max batch events, so a MAC move storm makes a few large callbacks
+ * rather than one per event, and never blocks the core raising it.
+ *
+ * The queue is a bounded multi producer single consumer ring, each slot
+ * holding a sequence number telling whether it is free for the producer
+ * which claimed its position or filled for the consumer. Producers claim
+ * positions with a compare and swap on the tail, and events finding the
+ * queue full are dropped and counted.
+ *
+ * An event waits at most max latency for its batch to fill. The thread only
+ * sleeps on an empty queue, or until the pending batch is due, and producers
+ * only wake it when the queue holds the events it waits for.
+ */
+
+/* State DB *************/
+#define NOTIFICATION_QUEUE_SIZE         16384
+#define NOTIFICATION_FDB_ATTRS          3
+#define NOTIFICATION_MAX_BATCH          1024
+#define NOTIFICATION_DEFAULT_BATCH      256
+#define NOTIFICATION_DEFAULT_LATENCY_US 1000
+#define NOTIFICATION_BATCH_KEY          "SAI_NOTIFICATION_MAX_BATCH"
+#define NOTIFICATION_LATENCY_KEY        "SAI_NOTIFICATION_MAX_LATENCY_US"
+
+typedef enum _stub_notification_type_t {
+    NOTIFICATION_FDB_EVENT,
+    NOTIFICATION_PORT_STATE,
+    NOTIFICATION_SWITCH_STATE
+} stub_notification_type_t;
+
+typedef struct _stub_notification_t {
+    stub_notification_type_t type;
+    union {
+        struct {
+            sai_fdb_event_t event_type;
+            sai_fdb_entry_t fdb_entry;
+            uint32_t        attr_count;
+            sai_attribute_t attr[NOTIFICATION_FDB_ATTRS];
+        } fdb;
+        sai_port_oper_status_notification_t port;
+        sai_switch_oper_status_t            switch_state;
+    } data;
+} stub_notification_t;
+
+typedef struct _stub_notification_slot_t {
+    uint64_t            seq;
+    stub_notification_t event;
+} stub_notification_slot_t;
+
+/* Tail is claimed by the producers, head only moved by the thread */
+typedef struct _stub_notification_queue_t {
+    uint64_t                 tail __attribute__((aligned(CACHE_LINE_SIZE)));
+    uint64_t                 head __attribute__((aligned(CACHE_LINE_SIZE)));
+    /* Events the sleeping thread waits for, 0 when not sleeping */
+    uint64_t                 wake_depth;
+    stub_notification_slot_t slots[NOTIFICATION_QUEUE_SIZE];
+} stub_notification_queue_t;
+
+typedef struct _stub_notification_batch_t {
+    uint32_t                            fdb_count;
+    uint32_t                            port_count;
+    sai_fdb_event_notification_data_t   fdb[NOTIFICATION_MAX_BATCH];
+    sai_attribute_t                     fdb_attr[NOTIFICATION_MAX_BATCH][NOTIFICATION_FDB_ATTRS];
+    sai_port_oper_status_notification_t port[NOTIFICATION_MAX_BATCH];
+} stub_notification_batch_t;
+
+static stub_notification_queue_t notification_queue;
+static stub_notification_batch_t notification_batch;
+static pthread_t                 notification_thread;
+static pthread_mutex_t           notification_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t            notification_cond;
+static bool                      notification_running;
+static uint32_t                  notification_max_batch      = NOTIFICATION_DEFAULT_BATCH;
+static uint64_t                  notification_max_latency_ns = NOTIFICATION_DEFAULT_LATENCY_US * 1000ULL;
+static stub_notification_stats_t notification_stats;
+
+static uint64_t notification_now()
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+static sai_status_t notification_enqueue(_In_ const stub_notification_t *event)
+{
+    stub_notification_slot_t *slot;
+    uint64_t                  pos, seq, wake_depth;
+
+    if (!__atomic_load_n(&notification_running, __ATOMIC_ACQUIRE)) {
+        return SAI_STATUS_UNINITIALIZED;
+    }
+
+    pos = __atomic_load_n(&notification_queue.tail, __ATOMIC_RELAXED);
+    for (;;) {
+        slot = &notification_queue.slots[pos % NOTIFICATION_QUEUE_SIZE];
+        seq  = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+
+        if (seq == pos) {
+            if (__atomic_compare_exchange_n(&notification_queue.tail, &pos, pos + 1, true,
+                                            __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if ((int64_t)(seq - pos) < 0) {
+            __atomic_fetch_add(&notification_stats.overflow_drops, 1, __ATOMIC_RELAXED);
+            return SAI_STATUS_INSUFFICIENT_RESOURCES;
+        } else {
+            pos = __atomic_load_n(&notification_queue.tail, __ATOMIC_RELAXED);
+        }
+    }
+
+    slot->event = *event;
+    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+
+    /* Pairs with the thread setting wake_depth then checking the tail */
+    wake_depth = __atomic_load_n(&notification_queue.wake_depth, __ATOMIC_SEQ_CST);
+    if ((0 != wake_depth) && (pos + 1 - __atomic_load_n(&notification_queue.head, __ATOMIC_RELAXED) >= wake_depth)) {
+        pthread_mutex_lock(&notification_lock);
+        pthread_cond_signal(&notification_cond);
+        pthread_mutex_unlock(&notification_lock);
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Next event of the queue, false when empty. A claimed slot still being filled is waited for */
+static bool notification_dequeue(_Out_ stub_notification_t *event)
+{
+    stub_notification_slot_t *slot;
+    uint64_t                  head = notification_queue.head;
+
+    slot = &notification_queue.slots[head % NOTIFICATION_QUEUE_SIZE];
+    while (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != head + 1) {
+        if (__atomic_load_n(&notification_queue.tail, __ATOMIC_SEQ_CST) == head) {
+            return false;
+        }
+        sched_yield();
+    }
+
+    *event = slot->event;
+    __atomic_store_n(&slot->seq, head + NOTIFICATION_QUEUE_SIZE, __ATOMIC_RELEASE);
+    __atomic_store_n(&notification_queue.head, head + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+static void notification_fdb_flush()
+{
+    stub_notification_batch_t *batch = &notification_batch;
+
+    if (0 == batch->fdb_count) {
+        return;
+    }
+
+    if (NULL != g_notification_callbacks.on_fdb_event) {
+        g_notification_callbacks.on_fdb_event(batch->fdb_count, batch->fdb);
+        __atomic_fetch_add(&notification_stats.callbacks, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&notification_stats.delivered, batch->fdb_count, __ATOMIC_RELAXED);
+    }
+    batch->fdb_count = 0;
+}
+
+static void notification_port_flush()
+{
+    stub_notification_batch_t *batch = &notification_batch;
+
+    if (0 == batch->port_count) {
+        return;
+    }
+
+    if (NULL != g_notification_callbacks.on_port_state_change) {
+        g_notification_callbacks.on_port_state_change(batch->port_count, batch->port);
+        __atomic_fetch_add(&notification_stats.callbacks, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&notification_stats.delivered, batch->port_count, __ATOMIC_RELAXED);
+    }
+    batch->port_count = 0;
+}
+
+static void notification_batch_add(_In_ const stub_notification_t *event, _In_ uint32_t max_batch)
+{
+    stub_notification_batch_t         *batch = &notification_batch;
+    sai_fdb_event_notification_data_t *fdb;
+    uint32_t                           ii;
+
+    if (NOTIFICATION_FDB_EVENT == event->type) {
+        fdb             = &batch->fdb[batch->fdb_count];
+        fdb->event_type = event->data.fdb.event_type;
+        fdb->fdb_entry  = event->data.fdb.fdb_entry;
+        fdb->attr_count = event->data.fdb.attr_count;
+        fdb->attr       = batch->fdb_attr[batch->fdb_count];
+        for (ii = 0; ii < fdb->attr_count; ii++) {
+            fdb->attr[ii] = event->data.fdb.attr[ii];
+        }
+        if (++batch->fdb_count >= max_batch) {
+            notification_fdb_flush();
+        }
+    } else if (NOTIFICATION_PORT_STATE == event->type) {
+        batch->port[batch->port_count] = event->data.port;
+        if (++batch->port_count >= max_batch) {
+            notification_port_flush();
+        }
+    } else {
+        /* Switch state changes are rare and not batched, events queued before them are delivered first */
+        notification_fdb_flush();
+        notification_port_flush();
+        if (NULL != g_notification_callbacks.on_switch_state_change) {
+            g_notification_callbacks.on_switch_state_change(event->data.switch_state);
+            __atomic_fetch_add(&notification_stats.callbacks, 1, __ATOMIC_RELAXED);
+            __atomic_fetch_add(&notification_stats.delivered, 1, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+/* Sleep until the queue holds depth events, or until deadline_ns when not 0 */
+static void notification_wait(_In_ uint64_t depth, _In_ uint64_t deadline_ns)
+{
+    struct timespec deadline;
+    uint64_t        head = notification_queue.head;
+
+    pthread_mutex_lock(&notification_lock);
+
+    __atomic_store_n(&notification_queue.wake_depth, depth, __ATOMIC_SEQ_CST);
+    if ((__atomic_load_n(&notification_queue.tail, __ATOMIC_SEQ_CST) - head < depth) &&
+        __atomic_load_n(&notification_running, __ATOMIC_ACQUIRE)) {
+        if (0 == deadline_ns) {
+            pthread_cond_wait(&notification_cond, &notification_lock);
+        } else {
+            deadline.tv_sec  = deadline_ns / 1000000000ULL;
+            deadline.tv_nsec = deadline_ns % 1000000000ULL;
+            pthread_cond_timedwait(&notification_cond, &notification_lock, &deadline);
+        }
+    }
+    __atomic_store_n(&notification_queue.wake_depth, 0, __ATOMIC_RELAXED);
+
+    pthread_mutex_unlock(&notification_lock);
+}
+
+static void* notification_thread_run(void *arg)
+{
+    stub_notification_t event;
+    uint64_t            deadline_ns = 0, now;
+    uint32_t            max_batch, pending;
+    bool                running;
+
+    for (;;) {
+        running   = __atomic_load_n(&notification_running, __ATOMIC_ACQUIRE);
+        max_batch = __atomic_load_n(&notification_max_batch, __ATOMIC_RELAXED);
+
+        while (notification_dequeue(&event)) {
+            if ((0 == notification_batch.fdb_count) && (0 == notification_batch.port_count)) {
+                deadline_ns = notification_now() + __atomic_load_n(&notification_max_latency_ns, __ATOMIC_RELAXED);
+            }
+            notification_batch_add(&event, max_batch);
+        }
+
+        pending = notification_batch.fdb_count + notification_batch.port_count;
+        if (0 == pending) {
+            if (!running) {
+                break;
+            }
+            notification_wait(1, 0);
+            continue;
+        }
+
+        now = notification_now();
+        if (!running || (now >= deadline_ns)) {
+            notification_fdb_flush();
+            notification_port_flush();
+            continue;
+        }
+
+        /* Either batch filling up flushes it, so wake for the events the fuller one still takes */
+        notification_wait(max_batch - (notification_batch.fdb_count > notification_batch.port_count ?
+                                        notification_batch.fdb_count : notification_batch.port_count),
+                          deadline_ns);
+    }
+
+    return NULL;
+}
+
+/*
+ * Start the notification thread, with the max batch and latency of the switch
+ * profile keys SAI_NOTIFICATION_MAX_BATCH and SAI_NOTIFICATION_MAX_LATENCY_US
+ */
+sai_status_t db_notification_start()
+{
+    pthread_condattr_t attr;
+    sai_status_t       status;
+    uint32_t           ii;
+    int                err;
+
+    if (__atomic_load_n(&notification_running, __ATOMIC_ACQUIRE)) {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = db_notification_config_set(
+             db_profile_u32_get(NOTIFICATION_BATCH_KEY, NOTIFICATION_DEFAULT_BATCH),
+             db_profile_u32_get(NOTIFICATION_LATENCY_KEY, NOTIFICATION_DEFAULT_LATENCY_US)))) {
+        return status;
+    }
+
+    for (ii = 0; ii < NOTIFICATION_QUEUE_SIZE; ii++) {
+        notification_queue.slots[ii].seq = ii;
+    }
+    notification_queue.head = notification_queue.tail = 0;
+    memset(&notification_stats, 0, sizeof(notification_stats));
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&notification_cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    __atomic_store_n(&notification_running, true, __ATOMIC_RELEASE);
+    if (0 != (err = pthread_create(&notification_thread, NULL, notification_thread_run, NULL))) {
+        __atomic_store_n(&notification_running, false, __ATOMIC_RELEASE);
+        pthread_cond_destroy(&notification_cond);
+        STUB_LOG_ERR("Failed to start notification thread, %s\n", strerror(err));
+        return SAI_STATUS_FAILURE;
+    }
+
+    STUB_LOG_NTC("Notification thread started, max batch %u max latency %" PRIu64 " us\n",
+                 notification_max_batch, notification_max_latency_ns / 1000);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Stop the notification thread, once the events queued are delivered */
+void db_notification_stop()
+{
+    if (!__atomic_load_n(&notification_running, __ATOMIC_ACQUIRE)) {
+        return;
+    }
+
+    pthread_mutex_lock(&notification_lock);
+    __atomic_store_n(&notification_running, false, __ATOMIC_RELEASE);
+    pthread_cond_signal(&notification_cond);
+    pthread_mutex_unlock(&notification_lock);
+
+    pthread_join(notification_thread, NULL);
+    pthread_cond_destroy(&notification_cond);
+}
+
+sai_status_t db_notification_config_set(_In_ uint32_t max_batch, _In_ uint32_t max_latency_us)
+{
+    if ((0 == max_batch) || (max_batch > NOTIFICATION_MAX_BATCH)) {
+        STUB_LOG_ERR("Invalid notification max batch %u, max %u\n", max_batch, NOTIFICATION_MAX_BATCH);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    __atomic_store_n(&notification_max_batch, max_batch, __ATOMIC_RELAXED);
+    __atomic_store_n(&notification_max_latency_ns, max_latency_us * 1000ULL, __ATOMIC_RELAXED);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+void db_notification_stats_get(_Out_ stub_notification_stats_t *stats)
+{
+    stats->delivered      = __atomic_load_n(&notification_stats.delivered, __ATOMIC_RELAXED);
+    stats->callbacks      = __atomic_load_n(&notification_stats.callbacks, __ATOMIC_RELAXED);
+    stats->overflow_drops = __atomic_load_n(&notification_stats.overflow_drops, __ATOMIC_RELAXED);
+}
+
+/*
+ * Queue an FDB event, with up to 3 attributes. Doesn't block, fails with
+ * SAI_STATUS_INSUFFICIENT_RESOURCES when the queue is full.
+ */
+sai_status_t db_notify_fdb_event(_In_ sai_fdb_event_t        event_type,
+                                 _In_ const sai_fdb_entry_t *fdb_entry,
+                                 _In_ uint32_t               attr_count,
+                                 _In_ const sai_attribute_t *attr_list)
+{
+    stub_notification_t event;
+    uint32_t            ii;
+
+    if (attr_count > NOTIFICATION_FDB_ATTRS) {
+        STUB_LOG_ERR("Too many FDB event attributes %u, max %u\n", attr_count, NOTIFICATION_FDB_ATTRS);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    event.type                = NOTIFICATION_FDB_EVENT;
+    event.data.fdb.event_type = event_type;
+    event.data.fdb.fdb_entry  = *fdb_entry;
+    event.data.fdb.attr_count = attr_count;
+    for (ii = 0; ii < attr_count; ii++) {
+        event.data.fdb.attr[ii] = attr_list[ii];
+    }
+
+    return notification_enqueue(&event);
+}
+
+/* Queue a port operational status change. Doesn't block, fails when the queue is full */
+sai_status_t db_notify_port_state(_In_ uint32_t port_id, _In_ sai_port_oper_status_t port_state)
+{
+    stub_notification_t event;
+    sai_status_t        status;
+
+    event.type = NOTIFICATION_PORT_STATE;
+    if (SAI_STATUS_SUCCESS != (status = stub_create_object(SAI_OBJECT_TYPE_PORT, port_id, &event.data.port.port_id))) {
+        return status;
+    }
+    event.data.port.port_state = port_state;
+
+    return notification_enqueue(&event);
+}
+
+sai_status_t db_notify_switch_state(_In_ sai_switch_oper_status_t switch_state)
+{
+    stub_notification_t event;
+
+    event.type              = NOTIFICATION_SWITCH_STATE;
+    event.data.switch_state = switch_state;
+
+    return notification_enqueue(&event);
+}
+
+/*************************/
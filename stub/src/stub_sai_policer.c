@@ -0,0 +1,1112 @@
+/*
+ *  Copyright (C) 2014. Mellanox Technologies, Ltd. ALL RIGHTS RESERVED.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ */
+
+#include "sai.h"
+#include "stub_sai.h"
+#include "assert.h"
+#include "inttypes.h"
+
+#undef  __MODULE__
+#define __MODULE__ SAI_POLICER
+
+static const sai_attribute_entry_t policer_attribs[] = {
+    { SAI_POLICER_ATTR_METER_TYPE, true, true, false, true,
+      "Policer meter type", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_POLICER_ATTR_MODE, true, true, false, true,
+      "Policer mode", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_POLICER_ATTR_COLOR_SOURCE, false, true, false, true,
+      "Policer color source", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_POLICER_ATTR_CBS, false, true, false, true,
+      "Policer committed burst size", SAI_ATTR_VAL_TYPE_U64 },
+    { SAI_POLICER_ATTR_CIR, false, true, false, true,
+      "Policer committed information rate", SAI_ATTR_VAL_TYPE_U64 },
+    { SAI_POLICER_ATTR_PBS, false, true, false, true,
+      "Policer peak burst size", SAI_ATTR_VAL_TYPE_U64 },
+    { SAI_POLICER_ATTR_PIR, false, true, false, true,
+      "Policer peak information rate", SAI_ATTR_VAL_TYPE_U64 },
+    { SAI_POLICER_ATTR_GREEN_PACKET_ACTION, false, true, false, true,
+      "Policer green packet action", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_POLICER_ATTR_YELLOW_PACKET_ACTION, false, true, false, true,
+      "Policer yellow packet action", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_POLICER_ATTR_RED_PACKET_ACTION, false, true, false, true,
+      "Policer red packet action", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_POLICER_ATTR_ENABLE_COUNTER_PACKET_ACTION_LIST, false, true, true, true,
+      "Policer counted packet actions", SAI_ATTR_VAL_TYPE_S32LIST },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+sai_status_t stub_policer_attr_get(_In_ const sai_object_key_t   *key,
+                                   _Inout_ sai_attribute_value_t *value,
+                                   _In_ uint32_t                  attr_index,
+                                   _Inout_ vendor_cache_t        *cache,
+                                   void                          *arg);
+sai_status_t stub_policer_counter_actions_get(_In_ const sai_object_key_t   *key,
+                                              _Inout_ sai_attribute_value_t *value,
+                                              _In_ uint32_t                  attr_index,
+                                              _Inout_ vendor_cache_t        *cache,
+                                              void                          *arg);
+sai_status_t stub_policer_counter_actions_set(_In_ const sai_object_key_t      *key,
+                                              _In_ const sai_attribute_value_t *value,
+                                              void                             *arg);
+
+static const sai_vendor_attribute_entry_t policer_vendor_attribs[] = {
+    { SAI_POLICER_ATTR_METER_TYPE,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_policer_attr_get, (void*)SAI_POLICER_ATTR_METER_TYPE,
+      NULL, NULL },
+    { SAI_POLICER_ATTR_MODE,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_policer_attr_get, (void*)SAI_POLICER_ATTR_MODE,
+      NULL, NULL },
+    { SAI_POLICER_ATTR_COLOR_SOURCE,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_policer_attr_get, (void*)SAI_POLICER_ATTR_COLOR_SOURCE,
+      NULL, NULL },
+    { SAI_POLICER_ATTR_CBS,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_policer_attr_get, (void*)SAI_POLICER_ATTR_CBS,
+      NULL, NULL },
+    { SAI_POLICER_ATTR_CIR,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_policer_attr_get, (void*)SAI_POLICER_ATTR_CIR,
+      NULL, NULL },
+    { SAI_POLICER_ATTR_PBS,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_policer_attr_get, (void*)SAI_POLICER_ATTR_PBS,
+      NULL, NULL },
+    { SAI_POLICER_ATTR_PIR,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_policer_attr_get, (void*)SAI_POLICER_ATTR_PIR,
+      NULL, NULL },
+    { SAI_POLICER_ATTR_GREEN_PACKET_ACTION,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_policer_attr_get, (void*)SAI_POLICER_ATTR_GREEN_PACKET_ACTION,
+      NULL, NULL },
+    { SAI_POLICER_ATTR_YELLOW_PACKET_ACTION,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_policer_attr_get, (void*)SAI_POLICER_ATTR_YELLOW_PACKET_ACTION,
+      NULL, NULL },
+    { SAI_POLICER_ATTR_RED_PACKET_ACTION,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_policer_attr_get, (void*)SAI_POLICER_ATTR_RED_PACKET_ACTION,
+      NULL, NULL },
+    { SAI_POLICER_ATTR_ENABLE_COUNTER_PACKET_ACTION_LIST,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_policer_counter_actions_get, NULL,
+      stub_policer_counter_actions_set, NULL },
+};
+
+/* State DB *************/
+
+/*
+ * Token buckets are kept in fixed point, scaled by NS_PER_SEC * STUB_CORES.
+ * With this scale a bucket of one core refills by exactly rate units per
+ * nanosecond, and a packet costs length * POLICER_TOKEN_SCALE units, so
+ * metering needs no division and loses no precision.
+ */
+#define NS_PER_SEC          1000000000ULL
+#define POLICER_TOKEN_SCALE (NS_PER_SEC * STUB_CORES)
+
+/* Largest burst size, so that a full bucket fits the fixed point scale */
+#define POLICER_MAX_BURST (UINT64_MAX / POLICER_TOKEN_SCALE)
+
+#define MAX_POLICER_COUNTER_ACTIONS        8
+#define POLICER_COLORS                     (SAI_PACKET_COLOR_RED + 1)
+
+/*
+ * Per core share of a policer. Each core owns 1/STUB_CORES of the burst
+ * sizes and of the rates. A core short of tokens takes them from the buckets
+ * of the other cores, so a single core can still use the whole policer.
+ * Levels and refill time are only changed with compare and swap, counters
+ * are only written by the owning core.
+ */
+typedef struct _stub_policer_core_t {
+    uint64_t committed;
+    uint64_t peak;
+    uint64_t last_ns;
+    uint64_t packets[POLICER_COLORS];
+    uint64_t bytes[POLICER_COLORS];
+} __attribute__((aligned(CACHE_LINE_SIZE))) stub_policer_core_t;
+
+typedef struct _stub_policer_t {
+    stub_policer_core_t        cores[STUB_CORES];
+    sai_meter_type_t           meter_type;
+    sai_policer_mode_t         mode;
+    sai_policer_color_source_t color_source;
+    uint64_t                   cbs;
+    uint64_t                   cir;
+    uint64_t                   pbs;
+    uint64_t                   pir;
+    sai_packet_action_t        actions[POLICER_COLORS];
+    uint32_t                   counter_action_count;
+    int32_t                    counter_actions[MAX_POLICER_COUNTER_ACTIONS];
+    uint32_t                   ref_count;
+    bool                       is_valid;
+} stub_policer_t;
+
+static stub_policer_t policer_db[MAX_POLICER_NUMBER];
+
+static sai_status_t db_get_policer(_In_ uint32_t policer_id, _Out_ stub_policer_t **policer)
+{
+    if ((policer_id >= MAX_POLICER_NUMBER) || (!policer_db[policer_id].is_valid)) {
+        STUB_LOG_ERR("Invalid policer ID %u\n", policer_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *policer = &policer_db[policer_id];
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t db_find_free_policer_index(_Out_ uint32_t *free_index)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < MAX_POLICER_NUMBER; ii++) {
+        if (false == policer_db[ii].is_valid) {
+            *free_index = ii;
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+
+    STUB_LOG_ERR("Policer table full\n");
+    return SAI_STATUS_TABLE_FULL;
+}
+
+/* Rate and size of the committed and peak buckets of one core, in fixed point */
+static void policer_core_params(_In_ const stub_policer_t *policer,
+                                _Out_ uint64_t            *committed_rate,
+                                _Out_ uint64_t            *committed_size,
+                                _Out_ uint64_t            *peak_rate,
+                                _Out_ uint64_t            *peak_size)
+{
+    *committed_rate = policer->cir;
+    *committed_size = policer->cbs * NS_PER_SEC;
+    *peak_size      = policer->pbs * NS_PER_SEC;
+
+    switch (policer->mode) {
+    case SAI_POLICER_MODE_TR_TCM:
+        *peak_rate = policer->pir;
+        break;
+
+    case SAI_POLICER_MODE_SR_TCM:
+        /* Excess bucket is only filled by committed bucket overflow */
+        *peak_rate = 0;
+        break;
+
+    default:
+        *peak_rate = 0;
+        *peak_size = 0;
+        break;
+    }
+}
+
+static uint64_t policer_level_add(_Inout_ uint64_t *level, _In_ uint64_t tokens, _In_ uint64_t size)
+{
+    uint64_t old_level, new_level, added;
+
+    old_level = __atomic_load_n(level, __ATOMIC_RELAXED);
+    do {
+        added     = (old_level >= size) ? 0 : ((tokens > size - old_level) ? size - old_level : tokens);
+        new_level = old_level + added;
+    } while ((0 != added) &&
+             !__atomic_compare_exchange_n(level, &old_level, new_level, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    return tokens - added;
+}
+
+static bool policer_level_take(_Inout_ uint64_t *level, _In_ uint64_t cost)
+{
+    uint64_t old_level;
+
+    old_level = __atomic_load_n(level, __ATOMIC_RELAXED);
+    do {
+        if (old_level < cost) {
+            return false;
+        }
+    } while (!__atomic_compare_exchange_n(level, &old_level, old_level - cost, true, __ATOMIC_RELAXED,
+                                          __ATOMIC_RELAXED));
+
+    return true;
+}
+
+/*
+ * Add the tokens accumulated since the last refill of a core bucket. Whoever
+ * advances last_ns adds the tokens for the elapsed time, so concurrent
+ * refills never add the same interval twice.
+ */
+static void policer_core_refill(_In_ const stub_policer_t *policer,
+                                _Inout_ stub_policer_core_t *core,
+                                _In_ uint64_t                now_ns)
+{
+    uint64_t last_ns, elapsed, tokens, overflow;
+    uint64_t committed_rate, committed_size, peak_rate, peak_size;
+
+    last_ns = __atomic_load_n(&core->last_ns, __ATOMIC_RELAXED);
+    do {
+        if (now_ns <= last_ns) {
+            return;
+        }
+    } while (!__atomic_compare_exchange_n(&core->last_ns, &last_ns, now_ns, true, __ATOMIC_RELAXED,
+                                          __ATOMIC_RELAXED));
+
+    elapsed = now_ns - last_ns;
+    policer_core_params(policer, &committed_rate, &committed_size, &peak_rate, &peak_size);
+
+    if (__builtin_mul_overflow(elapsed, committed_rate, &tokens)) {
+        tokens = UINT64_MAX;
+    }
+    overflow = policer_level_add(&core->committed, tokens, committed_size);
+
+    if (SAI_POLICER_MODE_SR_TCM == policer->mode) {
+        policer_level_add(&core->peak, overflow, peak_size);
+    } else if (SAI_POLICER_MODE_TR_TCM == policer->mode) {
+        if (__builtin_mul_overflow(elapsed, peak_rate, &tokens)) {
+            tokens = UINT64_MAX;
+        }
+        policer_level_add(&core->peak, tokens, peak_size);
+    }
+}
+
+static uint64_t policer_level_take_upto(_Inout_ uint64_t *level, _In_ uint64_t cost)
+{
+    uint64_t old_level, taken;
+
+    old_level = __atomic_load_n(level, __ATOMIC_RELAXED);
+    do {
+        taken = (old_level < cost) ? old_level : cost;
+        if (0 == taken) {
+            return 0;
+        }
+    } while (!__atomic_compare_exchange_n(level, &old_level, old_level - taken, true, __ATOMIC_RELAXED,
+                                          __ATOMIC_RELAXED));
+
+    return taken;
+}
+
+/*
+ * Take tokens from the core bucket. If it is short, collect them from the
+ * buckets of all cores, and give them back if there aren't enough in total.
+ */
+static bool policer_take(_Inout_ stub_policer_t *policer,
+                         _In_ uint32_t           core,
+                         _In_ bool               peak,
+                         _In_ uint64_t           cost,
+                         _In_ uint64_t           now_ns)
+{
+    stub_policer_core_t *other;
+    uint64_t             taken[STUB_CORES] = { 0 };
+    uint64_t             remaining            = cost;
+    uint64_t             committed_rate, committed_size, peak_rate, peak_size;
+    uint32_t             ii;
+
+    if (policer_level_take(peak ? &policer->cores[core].peak : &policer->cores[core].committed, cost)) {
+        return true;
+    }
+
+    for (ii = 0; (ii < STUB_CORES) && (0 != remaining); ii++) {
+        other = &policer->cores[(core + ii) % STUB_CORES];
+        if (0 != ii) {
+            policer_core_refill(policer, other, now_ns);
+        }
+        taken[ii]  = policer_level_take_upto(peak ? &other->peak : &other->committed, remaining);
+        remaining -= taken[ii];
+    }
+
+    if (0 == remaining) {
+        return true;
+    }
+
+    policer_core_params(policer, &committed_rate, &committed_size, &peak_rate, &peak_size);
+    for (ii = 0; ii < STUB_CORES; ii++) {
+        other = &policer->cores[(core + ii) % STUB_CORES];
+        policer_level_add(peak ? &other->peak : &other->committed, taken[ii], peak ? peak_size : committed_size);
+    }
+
+    return false;
+}
+
+static sai_packet_color_t policer_color_packet(_Inout_ stub_policer_t *policer,
+                                               _In_ uint32_t           core,
+                                               _In_ uint64_t           cost,
+                                               _In_ sai_packet_color_t in_color,
+                                               _In_ uint64_t           now_ns)
+{
+    if (SAI_POLICER_COLOR_SOURCE_BLIND == policer->color_source) {
+        in_color = SAI_PACKET_COLOR_GREEN;
+    }
+
+    if (SAI_PACKET_COLOR_RED == in_color) {
+        return SAI_PACKET_COLOR_RED;
+    }
+
+    switch (policer->mode) {
+    case SAI_POLICER_MODE_SR_TCM:
+        /* RFC 2697 */
+        if ((SAI_PACKET_COLOR_GREEN == in_color) && policer_take(policer, core, false, cost, now_ns)) {
+            return SAI_PACKET_COLOR_GREEN;
+        }
+        if (policer_take(policer, core, true, cost, now_ns)) {
+            return SAI_PACKET_COLOR_YELLOW;
+        }
+        return SAI_PACKET_COLOR_RED;
+
+    case SAI_POLICER_MODE_TR_TCM:
+        /* RFC 2698 */
+        if (!policer_take(policer, core, true, cost, now_ns)) {
+            return SAI_PACKET_COLOR_RED;
+        }
+        if ((SAI_PACKET_COLOR_GREEN == in_color) && policer_take(policer, core, false, cost, now_ns)) {
+            return SAI_PACKET_COLOR_GREEN;
+        }
+        return SAI_PACKET_COLOR_YELLOW;
+
+    case SAI_POLICER_MODE_STORM_CONTROL:
+    default:
+        if (policer_take(policer, core, false, cost, now_ns)) {
+            return SAI_PACKET_COLOR_GREEN;
+        }
+        return SAI_PACKET_COLOR_RED;
+    }
+}
+
+/*
+ * Meter a batch of packets received on a core at time now_ns, and return
+ * their color and the action configured for it. in_colors is used by color
+ * aware policers and may be NULL, actions may be NULL.
+ * Different cores may meter the same policer concurrently, while a core
+ * should be used by a single thread.
+ */
+sai_status_t db_policer_meter(_In_ uint32_t                  policer_id,
+                              _In_ uint32_t                  core,
+                              _In_ uint64_t                  now_ns,
+                              _In_ uint32_t                  count,
+                              _In_ const uint32_t           *lengths,
+                              _In_ const sai_packet_color_t *in_colors,
+                              _Out_ sai_packet_color_t      *colors,
+                              _Out_ sai_packet_action_t     *actions)
+{
+    stub_policer_t      *policer;
+    stub_policer_core_t *own;
+    uint64_t             packets[POLICER_COLORS] = { 0 };
+    uint64_t             bytes[POLICER_COLORS]   = { 0 };
+    uint64_t             cost;
+    uint32_t             ii, color;
+    sai_status_t         status;
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_policer(policer_id, &policer))) {
+        return status;
+    }
+
+    core %= STUB_CORES;
+    own   = &policer->cores[core];
+    policer_core_refill(policer, own, now_ns);
+
+    for (ii = 0; ii < count; ii++) {
+        cost = (SAI_METER_TYPE_PACKETS == policer->meter_type) ? POLICER_TOKEN_SCALE :
+               lengths[ii] * POLICER_TOKEN_SCALE;
+        colors[ii] = policer_color_packet(policer, core, cost,
+                                          (NULL == in_colors) ? SAI_PACKET_COLOR_GREEN : in_colors[ii], now_ns);
+        if (NULL != actions) {
+            actions[ii] = policer->actions[colors[ii]];
+        }
+        packets[colors[ii]]++;
+        bytes[colors[ii]] += lengths[ii];
+    }
+
+    for (color = 0; color < POLICER_COLORS; color++) {
+        __atomic_store_n(&own->packets[color], own->packets[color] + packets[color], __ATOMIC_RELAXED);
+        __atomic_store_n(&own->bytes[color], own->bytes[color] + bytes[color], __ATOMIC_RELAXED);
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static void db_policer_counters_get(_In_ const stub_policer_t *policer,
+                                    _Out_ uint64_t            *packets,
+                                    _Out_ uint64_t            *bytes)
+{
+    uint32_t core, color;
+
+    for (color = 0; color < POLICER_COLORS; color++) {
+        packets[color] = 0;
+        bytes[color]   = 0;
+        for (core = 0; core < STUB_CORES; core++) {
+            packets[color] += __atomic_load_n(&policer->cores[core].packets[color], __ATOMIC_RELAXED);
+            bytes[color]   += __atomic_load_n(&policer->cores[core].bytes[color], __ATOMIC_RELAXED);
+        }
+    }
+}
+
+/* Check the counter ids before reading any, so a read fills all the counters or none */
+static sai_status_t policer_stats_check(_In_ const sai_policer_stat_t *counter_ids, _In_ uint32_t number_of_counters)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < number_of_counters; ii++) {
+        if ((uint32_t)counter_ids[ii] >= POLICER_STAT_ROW) {
+            STUB_LOG_ERR("Invalid policer counter %d\n", counter_ids[ii]);
+            return SAI_STATUS_INVALID_PARAMETER;
+        }
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static void policer_stats_read(_In_ const stub_policer_t     *policer,
+                               _In_ const sai_policer_stat_t *counter_ids,
+                               _In_ uint32_t                  number_of_counters,
+                               _Out_ uint64_t                *counters)
+{
+    uint64_t packets[POLICER_COLORS], bytes[POLICER_COLORS];
+    uint32_t ii;
+
+    db_policer_counters_get(policer, packets, bytes);
+
+    for (ii = 0; ii < number_of_counters; ii++) {
+        switch (counter_ids[ii]) {
+        case SAI_POLICER_STAT_PACKETS:
+            counters[ii] = packets[SAI_PACKET_COLOR_GREEN] + packets[SAI_PACKET_COLOR_YELLOW] +
+                           packets[SAI_PACKET_COLOR_RED];
+            break;
+
+        case SAI_POLICER_STAT_ATTR_BYTES:
+            counters[ii] = bytes[SAI_PACKET_COLOR_GREEN] + bytes[SAI_PACKET_COLOR_YELLOW] +
+                           bytes[SAI_PACKET_COLOR_RED];
+            break;
+
+        case SAI_POLICER_STAT_GREEN_PACKETS:
+            counters[ii] = packets[SAI_PACKET_COLOR_GREEN];
+            break;
+
+        case SAI_POLICER_STAT_GREEN_BYTES:
+            counters[ii] = bytes[SAI_PACKET_COLOR_GREEN];
+            break;
+
+        case SAI_POLICER_STAT_YELLOW_PACKETS:
+            counters[ii] = packets[SAI_PACKET_COLOR_YELLOW];
+            break;
+
+        case SAI_POLICER_STAT_YELLOW_BYTES:
+            counters[ii] = bytes[SAI_PACKET_COLOR_YELLOW];
+            break;
+
+        case SAI_POLICER_STAT_RED_PACKETS:
+            counters[ii] = packets[SAI_PACKET_COLOR_RED];
+            break;
+
+        case SAI_POLICER_STAT_RED_BYTES:
+            counters[ii] = bytes[SAI_PACKET_COLOR_RED];
+            break;
+
+        default:
+            counters[ii] = 0;
+            break;
+        }
+    }
+}
+
+/* Load counters of a policer from the counter cache, false when they aren't cached */
+static bool policer_stats_cache_read(_In_ uint32_t                  policer_id,
+                                     _In_ const sai_policer_stat_t *counter_ids,
+                                     _In_ uint32_t                  number_of_counters,
+                                     _Out_ uint64_t                *counters)
+{
+    const uint64_t *rows;
+    uint64_t        seq;
+    uint32_t        ii;
+
+    do {
+        if (NULL == (rows = db_counter_read_begin(COUNTER_TYPE_POLICER, &seq))) {
+            return false;
+        }
+
+        for (ii = 0; ii < number_of_counters; ii++) {
+            counters[ii] = __atomic_load_n(&rows[policer_id * POLICER_STAT_ROW + counter_ids[ii]], __ATOMIC_RELAXED);
+        }
+    } while (db_counter_read_retry(seq));
+
+    return true;
+}
+
+/* Rows of free policers hold stale counters, the policer is checked before its row is read */
+void db_policer_stats_all_get(_Out_ uint64_t *counters)
+{
+    sai_policer_stat_t ids[POLICER_STAT_ROW];
+    uint32_t           ii;
+
+    for (ii = 0; ii < POLICER_STAT_ROW; ii++) {
+        ids[ii] = (sai_policer_stat_t)ii;
+    }
+
+    for (ii = 0; ii < MAX_POLICER_NUMBER; ii++, counters += POLICER_STAT_ROW) {
+        policer_stats_read(&policer_db[ii], ids, POLICER_STAT_ROW, counters);
+    }
+}
+
+static sai_status_t db_create_policer(_Out_ uint32_t *policer_id, _In_ const stub_policer_t *params)
+{
+    stub_policer_t *policer;
+    sai_status_t    status;
+    uint32_t        core;
+
+    if (SAI_STATUS_SUCCESS != (status = db_find_free_policer_index(policer_id))) {
+        return status;
+    }
+
+    policer = &policer_db[*policer_id];
+    memcpy(policer, params, sizeof(*policer));
+
+    /* Buckets start full */
+    for (core = 0; core < STUB_CORES; core++) {
+        memset(&policer->cores[core], 0, sizeof(policer->cores[core]));
+        policer->cores[core].committed = policer->cbs * NS_PER_SEC;
+        policer->cores[core].peak      = (SAI_POLICER_MODE_STORM_CONTROL == policer->mode) ? 0 :
+                                         policer->pbs * NS_PER_SEC;
+    }
+
+    policer->is_valid = true;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t db_remove_policer(_In_ uint32_t policer_id)
+{
+    stub_policer_t *policer;
+    sai_status_t    status;
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_policer(policer_id, &policer))) {
+        return status;
+    }
+
+    if (0 != policer->ref_count) {
+        STUB_LOG_ERR("Policer ID %u is used by %u trap groups\n", policer_id, policer->ref_count);
+        return SAI_STATUS_OBJECT_IN_USE;
+    }
+
+    policer->is_valid = false;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Count trap groups using a policer, so that it isn't removed while in use */
+sai_status_t db_policer_ref(_In_ uint32_t policer_id, _In_ bool add)
+{
+    stub_policer_t *policer;
+    sai_status_t    status;
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_policer(policer_id, &policer))) {
+        return status;
+    }
+
+    if (add) {
+        policer->ref_count++;
+    } else {
+        assert(policer->ref_count > 0);
+        policer->ref_count--;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*************************/
+
+static void policer_key_to_str(_In_ sai_object_id_t policer_id, _Out_ char *key_str)
+{
+    uint32_t policerid;
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(policer_id, SAI_OBJECT_TYPE_POLICER, &policerid)) {
+        snprintf(key_str, MAX_KEY_STR_LEN, "invalid policer id");
+    } else {
+        snprintf(key_str, MAX_KEY_STR_LEN, "policer id %u", policerid);
+    }
+}
+
+static sai_status_t policer_action_check(_In_ int32_t action, _In_ uint32_t attr_index)
+{
+    switch (action) {
+    case SAI_PACKET_ACTION_DROP:
+    case SAI_PACKET_ACTION_FORWARD:
+    case SAI_PACKET_ACTION_COPY:
+    case SAI_PACKET_ACTION_COPY_CANCEL:
+    case SAI_PACKET_ACTION_TRAP:
+    case SAI_PACKET_ACTION_LOG:
+    case SAI_PACKET_ACTION_DENY:
+    case SAI_PACKET_ACTION_TRANSIT:
+        return SAI_STATUS_SUCCESS;
+
+    default:
+        STUB_LOG_ERR("Invalid policer packet action %d\n", action);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + attr_index;
+    }
+}
+
+static sai_status_t policer_counter_actions_fill(_Inout_ stub_policer_t *policer,
+                                                 _In_ const sai_s32_list_t *list,
+                                                 _In_ uint32_t attr_index)
+{
+    sai_status_t status;
+    uint32_t     ii;
+
+    if (list->count > MAX_POLICER_COUNTER_ACTIONS) {
+        STUB_LOG_ERR("Policer counted actions count %u exceeds maximum %u\n", list->count,
+                     MAX_POLICER_COUNTER_ACTIONS);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + attr_index;
+    }
+
+    for (ii = 0; ii < list->count; ii++) {
+        if (SAI_STATUS_SUCCESS != (status = policer_action_check(list->list[ii], attr_index))) {
+            return status;
+        }
+    }
+
+    memcpy(policer->counter_actions, list->list, sizeof(*list->list) * list->count);
+    policer->counter_action_count = list->count;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Create policer
+ *
+ * Arguments:
+ *    [out] policer_id - policer id
+ *    [in] switch_id - switch id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_policer(_Out_ sai_object_id_t      *policer_id,
+                                 _In_ sai_object_id_t        switch_id,
+                                 _In_ uint32_t               attr_count,
+                                 _In_ const sai_attribute_t *attr_list)
+{
+    static const sai_attr_id_t   action_attrs[POLICER_COLORS] = {
+        SAI_POLICER_ATTR_GREEN_PACKET_ACTION,
+        SAI_POLICER_ATTR_YELLOW_PACKET_ACTION,
+        SAI_POLICER_ATTR_RED_PACKET_ACTION
+    };
+    stub_policer_t               params;
+    sai_status_t                 status;
+    const sai_attribute_value_t *meter_type, *mode, *value;
+    uint32_t                     meter_type_index, mode_index, index, color, db_id = 0;
+    uint32_t                     pir_index = 0;
+    char                         list_str[MAX_LIST_VALUE_STR_LEN];
+    char                         key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == policer_id) {
+        STUB_LOG_ERR("NULL policer id param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = check_attribs_metadata(attr_count, attr_list, policer_attribs, policer_vendor_attribs,
+                                         SAI_OPERATION_CREATE))) {
+        STUB_LOG_ERR("Failed attribs check\n");
+        return status;
+    }
+
+    sai_attr_list_to_str(attr_count, attr_list, policer_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create policer, %s\n", list_str);
+
+    memset(&params, 0, sizeof(params));
+
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_POLICER_ATTR_METER_TYPE, &meter_type, &meter_type_index));
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_POLICER_ATTR_MODE, &mode, &mode_index));
+
+    if ((SAI_METER_TYPE_PACKETS != meter_type->s32) && (SAI_METER_TYPE_BYTES != meter_type->s32)) {
+        STUB_LOG_ERR("Invalid policer meter type %d\n", meter_type->s32);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + meter_type_index;
+    }
+    params.meter_type = meter_type->s32;
+
+    if ((SAI_POLICER_MODE_SR_TCM != mode->s32) && (SAI_POLICER_MODE_TR_TCM != mode->s32) &&
+        (SAI_POLICER_MODE_STORM_CONTROL != mode->s32)) {
+        STUB_LOG_ERR("Invalid policer mode %d\n", mode->s32);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + mode_index;
+    }
+    params.mode = mode->s32;
+
+    params.color_source = SAI_POLICER_COLOR_SOURCE_AWARE;
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_POLICER_ATTR_COLOR_SOURCE, &value, &index)) {
+        if ((SAI_POLICER_COLOR_SOURCE_BLIND != value->s32) && (SAI_POLICER_COLOR_SOURCE_AWARE != value->s32)) {
+            STUB_LOG_ERR("Invalid policer color source %d\n", value->s32);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + index;
+        }
+        params.color_source = value->s32;
+    }
+
+    if (SAI_STATUS_SUCCESS == find_attrib_in_list(attr_count, attr_list, SAI_POLICER_ATTR_CBS, &value, &index)) {
+        if (value->u64 > POLICER_MAX_BURST) {
+            STUB_LOG_ERR("Policer CBS %" PRIu64 " exceeds maximum %" PRIu64 "\n", value->u64, POLICER_MAX_BURST);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + index;
+        }
+        params.cbs = value->u64;
+    }
+    if (SAI_STATUS_SUCCESS == find_attrib_in_list(attr_count, attr_list, SAI_POLICER_ATTR_PBS, &value, &index)) {
+        if (value->u64 > POLICER_MAX_BURST) {
+            STUB_LOG_ERR("Policer PBS %" PRIu64 " exceeds maximum %" PRIu64 "\n", value->u64, POLICER_MAX_BURST);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + index;
+        }
+        params.pbs = value->u64;
+    }
+    if (SAI_STATUS_SUCCESS == find_attrib_in_list(attr_count, attr_list, SAI_POLICER_ATTR_CIR, &value, &index)) {
+        params.cir = value->u64;
+    }
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_POLICER_ATTR_PIR, &value, &pir_index)) {
+        params.pir = value->u64;
+    } else if (SAI_POLICER_MODE_TR_TCM == params.mode) {
+        STUB_LOG_ERR("Missing mandatory attribute PIR for two rate policer\n");
+        return SAI_STATUS_MANDATORY_ATTRIBUTE_MISSING;
+    }
+
+    if ((SAI_POLICER_MODE_TR_TCM == params.mode) && (params.pir < params.cir)) {
+        STUB_LOG_ERR("Policer PIR %" PRIu64 " below CIR %" PRIu64 "\n", params.pir, params.cir);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + pir_index;
+    }
+
+    for (color = 0; color < POLICER_COLORS; color++) {
+        params.actions[color] = SAI_PACKET_ACTION_FORWARD;
+        if (SAI_STATUS_SUCCESS ==
+            find_attrib_in_list(attr_count, attr_list, action_attrs[color], &value, &index)) {
+            if (SAI_STATUS_SUCCESS != (status = policer_action_check(value->s32, index))) {
+                return status;
+            }
+            params.actions[color] = value->s32;
+        }
+    }
+
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_POLICER_ATTR_ENABLE_COUNTER_PACKET_ACTION_LIST, &value,
+                            &index)) {
+        if (SAI_STATUS_SUCCESS != (status = policer_counter_actions_fill(&params, &value->s32list, index))) {
+            return status;
+        }
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_create_policer(&db_id, &params))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = stub_create_object(SAI_OBJECT_TYPE_POLICER, db_id, policer_id))) {
+        db_remove_policer(db_id);
+        return status;
+    }
+    policer_key_to_str(*policer_id, key_str);
+    STUB_LOG_NTC("Created policer %s\n", key_str);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Remove policer
+ *
+ * Arguments:
+ *    [in] policer_id - policer id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_policer(_In_ sai_object_id_t policer_id)
+{
+    char         key_str[MAX_KEY_STR_LEN];
+    sai_status_t status;
+    uint32_t     db_id;
+
+    STUB_LOG_ENTER();
+
+    policer_key_to_str(policer_id, key_str);
+    STUB_LOG_NTC("Remove policer %s\n", key_str);
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(policer_id, SAI_OBJECT_TYPE_POLICER, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_remove_policer(db_id))) {
+        return status;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Set policer attribute
+ *
+ * Arguments:
+ *    [in] policer_id - policer id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_policer_attribute(_In_ sai_object_id_t policer_id, _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = policer_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    policer_key_to_str(policer_id, key_str);
+    return sai_set_attribute(&key, key_str, policer_attribs, policer_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get policer attribute
+ *
+ * Arguments:
+ *    [in] policer_id - policer id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_policer_attribute(_In_ sai_object_id_t     policer_id,
+                                        _In_ uint32_t            attr_count,
+                                        _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = policer_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    policer_key_to_str(policer_id, key_str);
+    return sai_get_attributes(&key, key_str, policer_attribs, policer_vendor_attribs, attr_count, attr_list);
+}
+
+/* Policer create only attributes [sai_meter_type_t, sai_policer_mode_t, sai_policer_color_source_t,
+ * uint64_t rates and burst sizes, sai_packet_action_t per color] */
+sai_status_t stub_policer_attr_get(_In_ const sai_object_key_t   *key,
+                                   _Inout_ sai_attribute_value_t *value,
+                                   _In_ uint32_t                  attr_index,
+                                   _Inout_ vendor_cache_t        *cache,
+                                   void                          *arg)
+{
+    sai_status_t    status;
+    uint32_t        db_id;
+    stub_policer_t *policer;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_POLICER, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_policer(db_id, &policer))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_POLICER_ATTR_METER_TYPE:
+        value->s32 = policer->meter_type;
+        break;
+
+    case SAI_POLICER_ATTR_MODE:
+        value->s32 = policer->mode;
+        break;
+
+    case SAI_POLICER_ATTR_COLOR_SOURCE:
+        value->s32 = policer->color_source;
+        break;
+
+    case SAI_POLICER_ATTR_CBS:
+        value->u64 = policer->cbs;
+        break;
+
+    case SAI_POLICER_ATTR_CIR:
+        value->u64 = policer->cir;
+        break;
+
+    case SAI_POLICER_ATTR_PBS:
+        value->u64 = policer->pbs;
+        break;
+
+    case SAI_POLICER_ATTR_PIR:
+        value->u64 = policer->pir;
+        break;
+
+    case SAI_POLICER_ATTR_GREEN_PACKET_ACTION:
+        value->s32 = policer->actions[SAI_PACKET_COLOR_GREEN];
+        break;
+
+    case SAI_POLICER_ATTR_YELLOW_PACKET_ACTION:
+        value->s32 = policer->actions[SAI_PACKET_COLOR_YELLOW];
+        break;
+
+    case SAI_POLICER_ATTR_RED_PACKET_ACTION:
+        value->s32 = policer->actions[SAI_PACKET_COLOR_RED];
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid policer attribute %" PRId64 "\n", (int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Policer counted packet actions [sai_s32_list_t] */
+sai_status_t stub_policer_counter_actions_get(_In_ const sai_object_key_t   *key,
+                                              _Inout_ sai_attribute_value_t *value,
+                                              _In_ uint32_t                  attr_index,
+                                              _Inout_ vendor_cache_t        *cache,
+                                              void                          *arg)
+{
+    sai_status_t    status;
+    uint32_t        db_id;
+    stub_policer_t *policer;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_POLICER, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_policer(db_id, &policer))) {
+        return status;
+    }
+
+    status = stub_fill_s32list(policer->counter_actions, policer->counter_action_count, &value->s32list);
+
+    STUB_LOG_EXIT();
+    return status;
+}
+
+/* Policer counted packet actions [sai_s32_list_t] */
+sai_status_t stub_policer_counter_actions_set(_In_ const sai_object_key_t      *key,
+                                              _In_ const sai_attribute_value_t *value,
+                                              void                             *arg)
+{
+    sai_status_t    status;
+    uint32_t        db_id;
+    stub_policer_t *policer;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_POLICER, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_policer(db_id, &policer))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = policer_counter_actions_fill(policer, &value->s32list, 0))) {
+        return status;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *   Get policer statistics counters.
+ *
+ * Arguments:
+ *    [in] policer_id - policer id
+ *    [in] counter_ids - specifies the array of counter ids
+ *    [in] number_of_counters - number of counters in the array
+ *    [out] counters - array of resulting counter values.
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_policer_stats(_In_ sai_object_id_t           policer_id,
+                                    _In_ const sai_policer_stat_t *counter_ids,
+                                    _In_ uint32_t                  number_of_counters,
+                                    _Out_ uint64_t                *counters)
+{
+    sai_status_t    status;
+    uint32_t        db_id;
+    stub_policer_t *policer;
+    char            key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    policer_key_to_str(policer_id, key_str);
+    STUB_LOG_NTC("Get policer stats %s\n", key_str);
+
+    if (NULL == counter_ids) {
+        STUB_LOG_ERR("NULL counter ids array param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (NULL == counters) {
+        STUB_LOG_ERR("NULL counters array param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(policer_id, SAI_OBJECT_TYPE_POLICER, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_policer(db_id, &policer))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = policer_stats_check(counter_ids, number_of_counters))) {
+        return status;
+    }
+
+    if (!policer_stats_cache_read(db_id, counter_ids, number_of_counters, counters)) {
+        policer_stats_read(policer, counter_ids, number_of_counters, counters);
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+const sai_policer_api_t policer_api = {
+    stub_create_policer,
+    stub_remove_policer,
+    stub_set_policer_attribute,
+    stub_get_policer_attribute,
+    stub_get_policer_stats
+};
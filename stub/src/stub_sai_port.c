@@ -162,6 +162,43 @@ sai_status_t stub_port_mtu_get(_In_ const sai_object_key_t   *key,
                                _In_ uint32_t                  attr_index,
                                _Inout_ vendor_cache_t        *cache,
                                void                          *arg);
+sai_status_t stub_port_priority_groups_get(_In_ const sai_object_key_t   *key,
+                                           _Inout_ sai_attribute_value_t *value,
+                                           _In_ uint32_t                  attr_index,
+                                           _Inout_ vendor_cache_t        *cache,
+                                           void                          *arg);
+sai_status_t stub_port_default_tc_get(_In_ const sai_object_key_t   *key,
+                                      _Inout_ sai_attribute_value_t *value,
+                                      _In_ uint32_t                  attr_index,
+                                      _Inout_ vendor_cache_t        *cache,
+                                      void                          *arg);
+sai_status_t stub_port_default_tc_set(_In_ const sai_object_key_t      *key,
+                                      _In_ const sai_attribute_value_t *value,
+                                      void                             *arg);
+sai_status_t stub_port_qos_map_get(_In_ const sai_object_key_t   *key,
+                                   _Inout_ sai_attribute_value_t *value,
+                                   _In_ uint32_t                  attr_index,
+                                   _Inout_ vendor_cache_t        *cache,
+                                   void                          *arg);
+sai_status_t stub_port_qos_map_set(_In_ const sai_object_key_t      *key,
+                                   _In_ const sai_attribute_value_t *value,
+                                   void                             *arg);
+sai_status_t stub_port_samplepacket_get(_In_ const sai_object_key_t   *key,
+                                       _Inout_ sai_attribute_value_t *value,
+                                       _In_ uint32_t                  attr_index,
+                                       _Inout_ vendor_cache_t        *cache,
+                                       void                          *arg);
+sai_status_t stub_port_samplepacket_set(_In_ const sai_object_key_t      *key,
+                                       _In_ const sai_attribute_value_t *value,
+                                       void                             *arg);
+sai_status_t stub_port_mirror_session_get(_In_ const sai_object_key_t   *key,
+                                         _Inout_ sai_attribute_value_t *value,
+                                         _In_ uint32_t                  attr_index,
+                                         _Inout_ vendor_cache_t        *cache,
+                                         void                          *arg);
+sai_status_t stub_port_mirror_session_set(_In_ const sai_object_key_t      *key,
+                                         _In_ const sai_attribute_value_t *value,
+                                         void                             *arg);
 
 static const sai_attribute_entry_t        port_attribs[] = {
     { SAI_PORT_ATTR_TYPE, false, false, false, true,
@@ -220,6 +257,32 @@ static const sai_attribute_entry_t        port_attribs[] = {
       "Port ingress samplepacket enable", SAI_ATTR_VAL_TYPE_OID },
     { SAI_PORT_ATTR_EGRESS_SAMPLEPACKET_ENABLE, false, false, true, true,
       "Port egress samplepacket enable", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_PORT_ATTR_NUMBER_OF_INGRESS_PRIORITY_GROUPS, false, false, false, true,
+      "Port number of ingress priority groups", SAI_ATTR_VAL_TYPE_U32 },
+    { SAI_PORT_ATTR_INGRESS_PRIORITY_GROUP_LIST, false, false, false, true,
+      "Port ingress priority group list", SAI_ATTR_VAL_TYPE_OBJLIST },
+    { SAI_PORT_ATTR_QOS_DEFAULT_TC, false, false, true, true,
+      "Port QoS default TC", SAI_ATTR_VAL_TYPE_U8 },
+    { SAI_PORT_ATTR_QOS_DOT1P_TO_TC_MAP, false, false, true, true,
+      "Port QoS dot1p to TC map", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_PORT_ATTR_QOS_DOT1P_TO_COLOR_MAP, false, false, true, true,
+      "Port QoS dot1p to color map", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_PORT_ATTR_QOS_DSCP_TO_TC_MAP, false, false, true, true,
+      "Port QoS DSCP to TC map", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_PORT_ATTR_QOS_DSCP_TO_COLOR_MAP, false, false, true, true,
+      "Port QoS DSCP to color map", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_PORT_ATTR_QOS_TC_TO_QUEUE_MAP, false, false, true, true,
+      "Port QoS TC to queue map", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_PORT_ATTR_QOS_TC_AND_COLOR_TO_DOT1P_MAP, false, false, true, true,
+      "Port QoS TC and color to dot1p map", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_PORT_ATTR_QOS_TC_AND_COLOR_TO_DSCP_MAP, false, false, true, true,
+      "Port QoS TC and color to DSCP map", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_PORT_ATTR_QOS_TC_TO_PRIORITY_GROUP_MAP, false, false, true, true,
+      "Port QoS TC to priority group map", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_PORT_ATTR_QOS_PFC_PRIORITY_TO_PRIORITY_GROUP_MAP, false, false, true, true,
+      "Port QoS PFC priority to priority group map", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_PORT_ATTR_QOS_PFC_PRIORITY_TO_QUEUE_MAP, false, false, true, true,
+      "Port QoS PFC priority to queue map", SAI_ATTR_VAL_TYPE_OID },
     { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
       "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
 };
@@ -345,233 +408,750 @@ static const sai_vendor_attribute_entry_t port_vendor_attribs[] = {
       stub_port_fdb_violation_get, NULL,
       stub_port_fdb_violation_set, NULL },
     { SAI_PORT_ATTR_INGRESS_MIRROR_SESSION,
-      { false, false, false, false },
       { false, false, true, true },
-      NULL, NULL,
-      NULL, NULL },
+      { false, false, true, true },
+      stub_port_mirror_session_get, (void*)true,
+      stub_port_mirror_session_set, (void*)true },
     { SAI_PORT_ATTR_EGRESS_MIRROR_SESSION,
-      { false, false, false, false },
       { false, false, true, true },
-      NULL, NULL,
-      NULL, NULL },
+      { false, false, true, true },
+      stub_port_mirror_session_get, (void*)false,
+      stub_port_mirror_session_set, (void*)false },
     { SAI_PORT_ATTR_INGRESS_SAMPLEPACKET_ENABLE,
-      { false, false, false, false },
       { false, false, true, true },
-      NULL, NULL,
-      NULL, NULL },
+      { false, false, true, true },
+      stub_port_samplepacket_get, (void*)true,
+      stub_port_samplepacket_set, (void*)true },
     { SAI_PORT_ATTR_EGRESS_SAMPLEPACKET_ENABLE,
-      { false, false, false, false },
       { false, false, true, true },
-      NULL, NULL,
-      NULL, NULL }
+      { false, false, true, true },
+      stub_port_samplepacket_get, (void*)false,
+      stub_port_samplepacket_set, (void*)false },
+    { SAI_PORT_ATTR_NUMBER_OF_INGRESS_PRIORITY_GROUPS,
+      { false, false, false, true },
+      { false, false, false, true },
+      stub_port_priority_groups_get, (void*)SAI_PORT_ATTR_NUMBER_OF_INGRESS_PRIORITY_GROUPS,
+      NULL, NULL },
+    { SAI_PORT_ATTR_INGRESS_PRIORITY_GROUP_LIST,
+      { false, false, false, true },
+      { false, false, false, true },
+      stub_port_priority_groups_get, (void*)SAI_PORT_ATTR_INGRESS_PRIORITY_GROUP_LIST,
+      NULL, NULL },
+    { SAI_PORT_ATTR_QOS_DEFAULT_TC,
+      { false, false, true, true },
+      { false, false, true, true },
+      stub_port_default_tc_get, NULL,
+      stub_port_default_tc_set, NULL },
+    { SAI_PORT_ATTR_QOS_DOT1P_TO_TC_MAP,
+      { false, false, true, true },
+      { false, false, true, true },
+      stub_port_qos_map_get, (void*)SAI_QOS_MAP_TYPE_DOT1P_TO_TC,
+      stub_port_qos_map_set, (void*)SAI_QOS_MAP_TYPE_DOT1P_TO_TC },
+    { SAI_PORT_ATTR_QOS_DOT1P_TO_COLOR_MAP,
+      { false, false, true, true },
+      { false, false, true, true },
+      stub_port_qos_map_get, (void*)SAI_QOS_MAP_TYPE_DOT1P_TO_COLOR,
+      stub_port_qos_map_set, (void*)SAI_QOS_MAP_TYPE_DOT1P_TO_COLOR },
+    { SAI_PORT_ATTR_QOS_DSCP_TO_TC_MAP,
+      { false, false, true, true },
+      { false, false, true, true },
+      stub_port_qos_map_get, (void*)SAI_QOS_MAP_TYPE_DSCP_TO_TC,
+      stub_port_qos_map_set, (void*)SAI_QOS_MAP_TYPE_DSCP_TO_TC },
+    { SAI_PORT_ATTR_QOS_DSCP_TO_COLOR_MAP,
+      { false, false, true, true },
+      { false, false, true, true },
+      stub_port_qos_map_get, (void*)SAI_QOS_MAP_TYPE_DSCP_TO_COLOR,
+      stub_port_qos_map_set, (void*)SAI_QOS_MAP_TYPE_DSCP_TO_COLOR },
+    { SAI_PORT_ATTR_QOS_TC_TO_QUEUE_MAP,
+      { false, false, true, true },
+      { false, false, true, true },
+      stub_port_qos_map_get, (void*)SAI_QOS_MAP_TYPE_TC_TO_QUEUE,
+      stub_port_qos_map_set, (void*)SAI_QOS_MAP_TYPE_TC_TO_QUEUE },
+    { SAI_PORT_ATTR_QOS_TC_AND_COLOR_TO_DOT1P_MAP,
+      { false, false, true, true },
+      { false, false, true, true },
+      stub_port_qos_map_get, (void*)SAI_QOS_MAP_TYPE_TC_AND_COLOR_TO_DOT1P,
+      stub_port_qos_map_set, (void*)SAI_QOS_MAP_TYPE_TC_AND_COLOR_TO_DOT1P },
+    { SAI_PORT_ATTR_QOS_TC_AND_COLOR_TO_DSCP_MAP,
+      { false, false, true, true },
+      { false, false, true, true },
+      stub_port_qos_map_get, (void*)SAI_QOS_MAP_TYPE_TC_AND_COLOR_TO_DSCP,
+      stub_port_qos_map_set, (void*)SAI_QOS_MAP_TYPE_TC_AND_COLOR_TO_DSCP },
+    { SAI_PORT_ATTR_QOS_TC_TO_PRIORITY_GROUP_MAP,
+      { false, false, true, true },
+      { false, false, true, true },
+      stub_port_qos_map_get, (void*)SAI_QOS_MAP_TYPE_TC_TO_PRIORITY_GROUP,
+      stub_port_qos_map_set, (void*)SAI_QOS_MAP_TYPE_TC_TO_PRIORITY_GROUP },
+    { SAI_PORT_ATTR_QOS_PFC_PRIORITY_TO_PRIORITY_GROUP_MAP,
+      { false, false, true, true },
+      { false, false, true, true },
+      stub_port_qos_map_get, (void*)SAI_QOS_MAP_TYPE_PFC_PRIORITY_TO_PRIORITY_GROUP,
+      stub_port_qos_map_set, (void*)SAI_QOS_MAP_TYPE_PFC_PRIORITY_TO_PRIORITY_GROUP },
+    { SAI_PORT_ATTR_QOS_PFC_PRIORITY_TO_QUEUE_MAP,
+      { false, false, true, true },
+      { false, false, true, true },
+      stub_port_qos_map_get, (void*)SAI_QOS_MAP_TYPE_PFC_PRIORITY_TO_QUEUE,
+      stub_port_qos_map_set, (void*)SAI_QOS_MAP_TYPE_PFC_PRIORITY_TO_QUEUE }
 };
 
-/* Admin Mode [bool] */
-sai_status_t stub_port_state_set(_In_ const sai_object_key_t *key, _In_ const sai_attribute_value_t *value, void *arg)
-{
-    sai_status_t status;
-    uint32_t     port_id;
-
-    STUB_LOG_ENTER();
+/* State DB *************/
+#define PORT_DEFAULT_SPEED 40000
+#define PORT_MAX_QUEUES    32
+#define PORT_MIN_FRAME     64
+#define PORT_MAX_FRAME     1518
 
-    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
-        return status;
+/*
+ * Port counters are counted per core, each core adding to its own cache
+ * line aligned copy so that no two cores write the same line, and summed
+ * over the cores on read. Clearing a counter doesn't touch the per core
+ * copies, it records the current sum as a baseline which reads subtract.
+ */
+typedef struct _stub_port_counters_t {
+    uint64_t counters[PORT_STAT_COUNT];
+} __attribute__((aligned(CACHE_LINE_SIZE))) stub_port_counters_t;
+
+/* Speed in Mbps, 0 until set for the default speed */
+static uint32_t             port_speed_db[PORT_NUMBER];
+/* Ports are admin up until set down */
+static bool                 port_admin_down_db[PORT_NUMBER];
+/* FDB learning, read by the forwarding cores without a lock. Max learned 0 for no limit */
+static int32_t              port_learn_mode_db[PORT_NUMBER] = { [0 ... PORT_NUMBER - 1] = SAI_PORT_LEARN_MODE_HW };
+static uint32_t             port_max_learned_db[PORT_NUMBER];
+static sai_packet_action_t  port_fdb_violation_db[PORT_NUMBER] = { [0 ... PORT_NUMBER - 1] = SAI_PACKET_ACTION_DROP };
+static stub_port_counters_t port_counters_db[STUB_CORES][PORT_NUMBER];
+static uint64_t             port_baselines_db[PORT_NUMBER][PORT_STAT_COUNT];
+
+sai_status_t db_port_speed_get(_In_ uint32_t port_id, _Out_ uint32_t *speed)
+{
+    if (port_id >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid port %u\n", port_id);
+        return SAI_STATUS_INVALID_PARAMETER;
     }
 
-    STUB_LOG_EXIT();
+    *speed = port_speed_db[port_id] ? port_speed_db[port_id] : PORT_DEFAULT_SPEED;
+
     return SAI_STATUS_SUCCESS;
 }
 
-/* Update DSCP of outgoing packets [bool] */
-sai_status_t stub_port_update_dscp_set(_In_ const sai_object_key_t      *key,
-                                       _In_ const sai_attribute_value_t *value,
-                                       void                             *arg)
+void db_port_fdb_learning_get(_In_ uint32_t              port_id,
+                              _Out_ int32_t             *mode,
+                              _Out_ uint32_t            *max_learned,
+                              _Out_ sai_packet_action_t *violation)
 {
-    sai_status_t status;
-    uint32_t     port_id;
+    *mode        = __atomic_load_n(&port_learn_mode_db[port_id], __ATOMIC_RELAXED);
+    *max_learned = __atomic_load_n(&port_max_learned_db[port_id], __ATOMIC_RELAXED);
+    *violation   = __atomic_load_n(&port_fdb_violation_db[port_id], __ATOMIC_RELAXED);
+}
 
-    STUB_LOG_ENTER();
+static sai_status_t port_id_get(_In_ const sai_object_key_t *key, _Out_ uint32_t *port_id)
+{
+    sai_status_t status;
 
-    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, port_id))) {
         return status;
     }
 
-    STUB_LOG_EXIT();
+    if (*port_id >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid port %u\n", *port_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
     return SAI_STATUS_SUCCESS;
 }
 
-/* [bool] (default to FALSE) */
-sai_status_t stub_port_storm_control_set(_In_ const sai_object_key_t      *key,
-                                         _In_ const sai_attribute_value_t *value,
-                                         void                             *arg)
+/* Only the core owning the counters writes them, readers may load them concurrently */
+static void port_stat_add(_Inout_ stub_port_counters_t *counters, _In_ uint32_t counter_id, _In_ uint64_t value)
 {
-    sai_status_t status;
-    uint32_t     port_id;
-
-    STUB_LOG_ENTER();
+    __atomic_store_n(&counters->counters[counter_id], counters->counters[counter_id] + value, __ATOMIC_RELAXED);
+}
 
-    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
-        return status;
+static void port_stat_size_add(_Inout_ stub_port_counters_t *counters, _In_ uint32_t length)
+{
+    if (length < PORT_MIN_FRAME) {
+        port_stat_add(counters, SAI_PORT_STAT_ETHER_STATS_UNDERSIZE_PKTS, 1);
+    } else if (length == PORT_MIN_FRAME) {
+        port_stat_add(counters, SAI_PORT_STAT_ETHER_STATS_PKTS_64_OCTETS, 1);
+    } else if (length <= 127) {
+        port_stat_add(counters, SAI_PORT_STAT_ETHER_STATS_PKTS_65_TO_127_OCTETS, 1);
+    } else if (length <= 255) {
+        port_stat_add(counters, SAI_PORT_STAT_ETHER_STATS_PKTS_128_TO_255_OCTETS, 1);
+    } else if (length <= 511) {
+        port_stat_add(counters, SAI_PORT_STAT_ETHER_STATS_PKTS_256_TO_511_OCTETS, 1);
+    } else if (length <= 1023) {
+        port_stat_add(counters, SAI_PORT_STAT_ETHER_STATS_PKTS_512_TO_1023_OCTETS, 1);
+    } else if (length <= PORT_MAX_FRAME) {
+        port_stat_add(counters, SAI_PORT_STAT_ETHER_STATS_PKTS_1024_TO_1518_OCTETS, 1);
+    } else {
+        port_stat_add(counters, SAI_PORT_STAT_ETHER_STATS_OVERSIZE_PKTS, 1);
+        port_stat_add(counters, SAI_PORT_STAT_ETHER_RX_OVERSIZE_PKTS, 1);
     }
-
-    STUB_LOG_EXIT();
-    return SAI_STATUS_SUCCESS;
 }
 
-/* Action for packets with unknown source mac address
- * when FDB learning limit is reached.
- * [sai_packet_action_t] (default to SAI_PACKET_ACTION_DROP) */
-sai_status_t stub_port_fdb_violation_set(_In_ const sai_object_key_t      *key,
-                                         _In_ const sai_attribute_value_t *value,
-                                         void                             *arg)
+/* Count a packet received on a port */
+sai_status_t db_port_stats_rx(_In_ uint32_t         core,
+                              _In_ uint32_t         port_id,
+                              _In_ uint32_t         length,
+                              _In_ stub_port_cast_t cast)
 {
-    sai_status_t status;
-    uint32_t     port_id;
+    stub_port_counters_t *counters;
 
-    STUB_LOG_ENTER();
+    if ((core >= STUB_CORES) || (port_id >= PORT_NUMBER)) {
+        STUB_LOG_ERR("Invalid core %u port %u\n", core, port_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
 
-    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
-        return status;
+    counters = &port_counters_db[core][port_id];
+
+    port_stat_add(counters, SAI_PORT_STAT_IF_IN_OCTETS, length);
+    port_stat_add(counters, SAI_PORT_STAT_ETHER_STATS_OCTETS, length);
+    port_stat_add(counters, SAI_PORT_STAT_ETHER_STATS_PKTS, 1);
+    port_stat_add(counters, SAI_PORT_STAT_ETHER_STATS_RX_NO_ERRORS, 1);
+    port_stat_size_add(counters, length);
+
+    switch (cast) {
+    case PORT_CAST_UNICAST:
+        port_stat_add(counters, SAI_PORT_STAT_IF_IN_UCAST_PKTS, 1);
+        break;
+
+    case PORT_CAST_MULTICAST:
+        port_stat_add(counters, SAI_PORT_STAT_IF_IN_NON_UCAST_PKTS, 1);
+        port_stat_add(counters, SAI_PORT_STAT_IF_IN_MULTICAST_PKTS, 1);
+        port_stat_add(counters, SAI_PORT_STAT_ETHER_STATS_MULTICAST_PKTS, 1);
+        break;
+
+    case PORT_CAST_BROADCAST:
+        port_stat_add(counters, SAI_PORT_STAT_IF_IN_NON_UCAST_PKTS, 1);
+        port_stat_add(counters, SAI_PORT_STAT_IF_IN_BROADCAST_PKTS, 1);
+        port_stat_add(counters, SAI_PORT_STAT_ETHER_STATS_BROADCAST_PKTS, 1);
+        break;
     }
 
-    STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
 }
 
-/* Maximum number of learned MAC addresses [uint32_t] */
-sai_status_t stub_port_max_learned_addr_set(_In_ const sai_object_key_t      *key,
-                                            _In_ const sai_attribute_value_t *value,
-                                            void                             *arg)
+/* Count a packet transmitted by a port */
+sai_status_t db_port_stats_tx(_In_ uint32_t         core,
+                              _In_ uint32_t         port_id,
+                              _In_ uint32_t         length,
+                              _In_ stub_port_cast_t cast)
 {
-    sai_status_t status;
-    uint32_t     port_id;
+    stub_port_counters_t *counters;
 
-    STUB_LOG_ENTER();
+    if ((core >= STUB_CORES) || (port_id >= PORT_NUMBER)) {
+        STUB_LOG_ERR("Invalid core %u port %u\n", core, port_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
 
-    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
-        return status;
+    counters = &port_counters_db[core][port_id];
+
+    port_stat_add(counters, SAI_PORT_STAT_IF_OUT_OCTETS, length);
+    port_stat_add(counters, SAI_PORT_STAT_ETHER_STATS_TX_NO_ERRORS, 1);
+    if (length > PORT_MAX_FRAME) {
+        port_stat_add(counters, SAI_PORT_STAT_ETHER_TX_OVERSIZE_PKTS, 1);
+    }
+
+    switch (cast) {
+    case PORT_CAST_UNICAST:
+        port_stat_add(counters, SAI_PORT_STAT_IF_OUT_UCAST_PKTS, 1);
+        break;
+
+    case PORT_CAST_MULTICAST:
+        port_stat_add(counters, SAI_PORT_STAT_IF_OUT_NON_UCAST_PKTS, 1);
+        port_stat_add(counters, SAI_PORT_STAT_IF_OUT_MULTICAST_PKTS, 1);
+        break;
+
+    case PORT_CAST_BROADCAST:
+        port_stat_add(counters, SAI_PORT_STAT_IF_OUT_NON_UCAST_PKTS, 1);
+        port_stat_add(counters, SAI_PORT_STAT_IF_OUT_BROADCAST_PKTS, 1);
+        break;
     }
 
-    STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
 }
 
-/* Media Type [sai_port_media_type_t] */
-sai_status_t stub_port_media_type_set(_In_ const sai_object_key_t      *key,
-                                      _In_ const sai_attribute_value_t *value,
-                                      void                             *arg)
+/* Count a packet a port dropped, received or to transmit */
+sai_status_t db_port_stats_discard(_In_ uint32_t core, _In_ uint32_t port_id, _In_ bool ingress)
 {
-    sai_status_t status;
-    uint32_t     port_id;
+    stub_port_counters_t *counters;
 
-    STUB_LOG_ENTER();
+    if ((core >= STUB_CORES) || (port_id >= PORT_NUMBER)) {
+        STUB_LOG_ERR("Invalid core %u port %u\n", core, port_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
 
-    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
-        return status;
+    counters = &port_counters_db[core][port_id];
+
+    if (ingress) {
+        port_stat_add(counters, SAI_PORT_STAT_IF_IN_DISCARDS, 1);
+        port_stat_add(counters, SAI_PORT_STAT_ETHER_STATS_DROP_EVENTS, 1);
+    } else {
+        port_stat_add(counters, SAI_PORT_STAT_IF_OUT_DISCARDS, 1);
     }
 
-    STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
 }
 
-/* Default VLAN [sai_vlan_id_t]
- *   Untagged ingress frames are tagged with default VLAN
- */
-sai_status_t stub_port_default_vlan_set(_In_ const sai_object_key_t      *key,
-                                        _In_ const sai_attribute_value_t *value,
-                                        void                             *arg)
+/* Packets queued for transmission on a port */
+static uint64_t port_queue_length_get(_In_ uint32_t port_id)
 {
-    sai_status_t status;
-    uint32_t     port_id;
+    uint32_t queue_ids[PORT_MAX_QUEUES], count = PORT_MAX_QUEUES, ii, packets;
+    uint64_t length = 0;
 
-    STUB_LOG_ENTER();
+    if (SAI_STATUS_SUCCESS != db_queue_port_queues_get(port_id, queue_ids, &count)) {
+        return 0;
+    }
 
-    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
-        return status;
+    for (ii = 0; ii < count; ii++) {
+        if (SAI_STATUS_SUCCESS == db_queue_depth_get(queue_ids[ii], &packets)) {
+            length += packets;
+        }
     }
 
-    STUB_LOG_EXIT();
-    return SAI_STATUS_SUCCESS;
+    return length;
 }
 
-/* Default VLAN Priority [uint8_t]
- *  (default to 0) */
-sai_status_t stub_port_default_vlan_prio_set(_In_ const sai_object_key_t      *key,
-                                             _In_ const sai_attribute_value_t *value,
-                                             void                             *arg)
+/*
+ * Read a counter of a port since it was last cleared. The baseline is read
+ * first, a clear recording it after reading the per core counters, so the
+ * counter read is never below its baseline.
+ */
+static uint64_t port_stat_read(_In_ uint32_t port_id, _In_ uint32_t counter_id)
 {
-    sai_status_t status;
-    uint32_t     port_id;
+    uint64_t value;
+    uint32_t core;
 
-    STUB_LOG_ENTER();
+    if (SAI_PORT_STAT_IF_OUT_QLEN == counter_id) {
+        return port_queue_length_get(port_id);
+    }
 
-    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
-        return status;
+    value = -__atomic_load_n(&port_baselines_db[port_id][counter_id], __ATOMIC_ACQUIRE);
+    for (core = 0; core < STUB_CORES; core++) {
+        value += __atomic_load_n(&port_counters_db[core][port_id].counters[counter_id], __ATOMIC_RELAXED);
     }
 
-    STUB_LOG_EXIT();
-    return SAI_STATUS_SUCCESS;
+    return value;
 }
 
-/* Ingress Filtering (Drop Frames with Unknown VLANs) [bool] */
-sai_status_t stub_port_ingress_filter_set(_In_ const sai_object_key_t      *key,
-                                          _In_ const sai_attribute_value_t *value,
-                                          void                             *arg)
+/*
+ * Read some counters of several ports, the baselines first, then the counters
+ * of each core in one sweep over all the ports, so the counters of the ports
+ * are taken at about the same point of each core traffic, not port after port.
+ */
+static void port_stats_bulk_read(_In_ uint32_t                       number_of_ports,
+                                 _In_ const sai_object_id_t         *port_ids,
+                                 _In_ const sai_port_stat_counter_t *counter_ids,
+                                 _In_ uint32_t                       number_of_counters,
+                                 _Out_ uint64_t                     *counters)
 {
-    sai_status_t status;
-    uint32_t     port_id;
+    uint32_t  ii, jj, core, port_id;
+    uint64_t *row;
 
-    STUB_LOG_ENTER();
+    /* The simulator, counting port traffic, is held off so that the rows are one snapshot */
+    db_sim_lock();
 
-    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
-        return status;
+    for (ii = 0, row = counters; ii < number_of_ports; ii++, row += number_of_counters) {
+        stub_object_to_type(port_ids[ii], SAI_OBJECT_TYPE_PORT, &port_id);
+        for (jj = 0; jj < number_of_counters; jj++) {
+            row[jj] = -__atomic_load_n(&port_baselines_db[port_id][counter_ids[jj]], __ATOMIC_ACQUIRE);
+        }
     }
 
-    STUB_LOG_EXIT();
-    return SAI_STATUS_SUCCESS;
+    for (core = 0; core < STUB_CORES; core++) {
+        for (ii = 0, row = counters; ii < number_of_ports; ii++, row += number_of_counters) {
+            stub_object_to_type(port_ids[ii], SAI_OBJECT_TYPE_PORT, &port_id);
+            for (jj = 0; jj < number_of_counters; jj++) {
+                row[jj] += __atomic_load_n(&port_counters_db[core][port_id].counters[counter_ids[jj]],
+                                           __ATOMIC_RELAXED);
+            }
+        }
+    }
+
+    for (ii = 0, row = counters; ii < number_of_ports; ii++, row += number_of_counters) {
+        stub_object_to_type(port_ids[ii], SAI_OBJECT_TYPE_PORT, &port_id);
+        for (jj = 0; jj < number_of_counters; jj++) {
+            if (SAI_PORT_STAT_IF_OUT_QLEN == counter_ids[jj]) {
+                row[jj] = port_queue_length_get(port_id);
+            }
+        }
+    }
+
+    db_sim_unlock();
 }
 
-/* Dropping of untagged frames on ingress [bool] */
-/* Dropping of tagged frames on ingress [bool] */
-sai_status_t stub_port_drop_tags_set(_In_ const sai_object_key_t      *key,
-                                     _In_ const sai_attribute_value_t *value,
-                                     void                             *arg)
+/* Load counters of ports from the counter cache, all from one snapshot. False when they aren't cached */
+static bool port_stats_cache_read(_In_ uint32_t                       number_of_ports,
+                                  _In_ const sai_object_id_t         *port_ids,
+                                  _In_ const sai_port_stat_counter_t *counter_ids,
+                                  _In_ uint32_t                       number_of_counters,
+                                  _Out_ uint64_t                     *counters)
 {
-    sai_status_t status;
-    uint32_t     port_id;
+    const uint64_t *rows;
+    uint64_t        seq, *row;
+    uint32_t        ii, jj, port_id;
 
-    STUB_LOG_ENTER();
-
-    assert((SAI_PORT_ATTR_DROP_UNTAGGED == (int64_t)arg) || (SAI_PORT_ATTR_DROP_TAGGED == (int64_t)arg));
+    do {
+        if (NULL == (rows = db_counter_read_begin(COUNTER_TYPE_PORT, &seq))) {
+            return false;
+        }
 
-    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
-        return status;
-    }
+        for (ii = 0, row = counters; ii < number_of_ports; ii++, row += number_of_counters) {
+            stub_object_to_type(port_ids[ii], SAI_OBJECT_TYPE_PORT, &port_id);
+            for (jj = 0; jj < number_of_counters; jj++) {
+                row[jj] = __atomic_load_n(&rows[port_id * PORT_STAT_COUNT + counter_ids[jj]], __ATOMIC_RELAXED);
+            }
+        }
+    } while (db_counter_read_retry(seq));
 
-    STUB_LOG_EXIT();
-    return SAI_STATUS_SUCCESS;
+    return true;
 }
 
-/* Internal loopback control [sai_port_loopback_mode_t] */
-sai_status_t stub_port_internal_loopback_set(_In_ const sai_object_key_t      *key,
-                                             _In_ const sai_attribute_value_t *value,
-                                             void                             *arg)
+/* Read all the counters of a port, as port_stat_read does, core by core */
+static void port_stats_read(_In_ uint32_t port_id, _Out_ uint64_t *counters)
 {
-    sai_status_t status;
-    uint32_t     port_id;
+    uint32_t ii, core;
 
-    STUB_LOG_ENTER();
+    for (ii = 0; ii < PORT_STAT_COUNT; ii++) {
+        counters[ii] = -__atomic_load_n(&port_baselines_db[port_id][ii], __ATOMIC_ACQUIRE);
+    }
 
-    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
-        return status;
+    for (core = 0; core < STUB_CORES; core++) {
+        for (ii = 0; ii < PORT_STAT_COUNT; ii++) {
+            counters[ii] += __atomic_load_n(&port_counters_db[core][port_id].counters[ii], __ATOMIC_RELAXED);
+        }
     }
 
-    switch (value->s32) {
-    case SAI_PORT_INTERNAL_LOOPBACK_NONE:
-        break;
+    counters[SAI_PORT_STAT_IF_OUT_QLEN] = port_queue_length_get(port_id);
+}
 
-    case SAI_PORT_INTERNAL_LOOPBACK_PHY:
-        break;
+/* Clear some counters of a port, by moving their baselines to their current values */
+static void port_stats_clear(_In_ uint32_t port_id, _In_ uint32_t number_of_counters, _In_ const uint32_t *counter_ids)
+{
+    uint32_t ii, core;
+    uint64_t value;
+
+    for (ii = 0; ii < number_of_counters; ii++) {
+        for (value = 0, core = 0; core < STUB_CORES; core++) {
+            value += __atomic_load_n(&port_counters_db[core][port_id].counters[counter_ids[ii]], __ATOMIC_RELAXED);
+        }
+        __atomic_store_n(&port_baselines_db[port_id][counter_ids[ii]], value, __ATOMIC_RELEASE);
+    }
+}
+
+/*
+ * Read counters of a port for telemetry. Besides the port counters, the
+ * watermarks of the bytes queued on the port can be read, being the peaks
+ * since the last record of the subscription. Called with the simulator lock held
+ */
+sai_status_t db_port_stats_sample(_In_ sai_object_id_t port_id,
+                                  _In_ uint32_t        subscription,
+                                  _In_ const int32_t  *counter_ids,
+                                  _In_ uint32_t        number_of_counters,
+                                  _Out_ uint64_t      *counters)
+{
+    sai_status_t status;
+    uint32_t     ii, port_data;
+    uint64_t     watermark      = 0;
+    bool         watermark_read = false;
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(port_id, SAI_OBJECT_TYPE_PORT, &port_data))) {
+        return status;
+    }
+
+    if (port_data >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid port %u\n", port_data);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    for (ii = 0; ii < number_of_counters; ii++) {
+        if (((uint32_t)counter_ids[ii] >= PORT_STAT_COUNT) &&
+            (SAI_PORT_STAT_WATERMARK_BYTES != counter_ids[ii]) &&
+            (SAI_PORT_STAT_SHARED_WATERMARK_BYTES != counter_ids[ii])) {
+            STUB_LOG_ERR("Invalid port counter %d\n", counter_ids[ii]);
+            return SAI_STATUS_INVALID_PARAMETER;
+        }
+    }
+
+    for (ii = 0; ii < number_of_counters; ii++) {
+        switch (counter_ids[ii]) {
+        /* The whole port occupancy is shared, both watermarks are the same peak */
+        case SAI_PORT_STAT_WATERMARK_BYTES:
+        case SAI_PORT_STAT_SHARED_WATERMARK_BYTES:
+            if (!watermark_read) {
+                watermark      = db_queue_port_watermark_sample(port_data, subscription);
+                watermark_read = true;
+            }
+            counters[ii] = watermark;
+            break;
+
+        default:
+            counters[ii] = port_stat_read(port_data, counter_ids[ii]);
+            break;
+        }
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Restart the watermarks of a port for a subscription, once its record is sent */
+sai_status_t db_port_watermarks_restart(_In_ sai_object_id_t port_id, _In_ uint32_t subscription)
+{
+    sai_status_t status;
+    uint32_t     port_data;
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(port_id, SAI_OBJECT_TYPE_PORT, &port_data))) {
+        return status;
+    }
+
+    if (port_data >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid port %u\n", port_data);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    db_queue_port_watermark_restart(port_data, subscription);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Read the counters of all the ports, PORT_STAT_COUNT counters per port indexed by counter id */
+void db_port_stats_all_get(_Out_ uint64_t *counters)
+{
+    uint32_t port_id;
+
+    for (port_id = 0; port_id < PORT_NUMBER; port_id++) {
+        port_stats_read(port_id, counters + port_id * PORT_STAT_COUNT);
+    }
+}
+
+/*************************/
+
+/* Admin Mode [bool] */
+sai_status_t stub_port_state_set(_In_ const sai_object_key_t *key, _In_ const sai_attribute_value_t *value, void *arg)
+{
+    sai_status_t status;
+    uint32_t     port_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
+        return status;
+    }
+
+    if (port_id >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid port %u\n", port_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    /* Operational status follows the admin state, the change is notified from the notification thread */
+    if (port_admin_down_db[port_id] == value->booldata) {
+        port_admin_down_db[port_id] = !value->booldata;
+        db_notify_port_state(port_id, value->booldata ? SAI_PORT_OPER_STATUS_UP : SAI_PORT_OPER_STATUS_DOWN);
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Update DSCP of outgoing packets [bool] */
+sai_status_t stub_port_update_dscp_set(_In_ const sai_object_key_t      *key,
+                                       _In_ const sai_attribute_value_t *value,
+                                       void                             *arg)
+{
+    sai_status_t status;
+    uint32_t     port_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
+        return status;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* [bool] (default to FALSE) */
+sai_status_t stub_port_storm_control_set(_In_ const sai_object_key_t      *key,
+                                         _In_ const sai_attribute_value_t *value,
+                                         void                             *arg)
+{
+    sai_status_t status;
+    uint32_t     port_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
+        return status;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Action for packets with unknown source mac address
+ * when FDB learning limit is reached.
+ * [sai_packet_action_t] (default to SAI_PACKET_ACTION_DROP) */
+sai_status_t stub_port_fdb_violation_set(_In_ const sai_object_key_t      *key,
+                                         _In_ const sai_attribute_value_t *value,
+                                         void                             *arg)
+{
+    sai_status_t status;
+    uint32_t     port_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = port_id_get(key, &port_id))) {
+        return status;
+    }
+
+    if ((SAI_PACKET_ACTION_DROP != value->s32) && (SAI_PACKET_ACTION_FORWARD != value->s32) &&
+        (SAI_PACKET_ACTION_TRAP != value->s32) && (SAI_PACKET_ACTION_LOG != value->s32)) {
+        STUB_LOG_ERR("Invalid port fdb learning limit violation action %d\n", value->s32);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0;
+    }
+
+    __atomic_store_n(&port_fdb_violation_db[port_id], value->s32, __ATOMIC_RELAXED);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Maximum number of learned MAC addresses [uint32_t] */
+sai_status_t stub_port_max_learned_addr_set(_In_ const sai_object_key_t      *key,
+                                            _In_ const sai_attribute_value_t *value,
+                                            void                             *arg)
+{
+    sai_status_t status;
+    uint32_t     port_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = port_id_get(key, &port_id))) {
+        return status;
+    }
+
+    /* Lowering the limit below the addresses learned stops learning, the learned addresses stay until aged */
+    __atomic_store_n(&port_max_learned_db[port_id], value->u32, __ATOMIC_RELAXED);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Media Type [sai_port_media_type_t] */
+sai_status_t stub_port_media_type_set(_In_ const sai_object_key_t      *key,
+                                      _In_ const sai_attribute_value_t *value,
+                                      void                             *arg)
+{
+    sai_status_t status;
+    uint32_t     port_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
+        return status;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Default VLAN [sai_vlan_id_t]
+ *   Untagged ingress frames are tagged with default VLAN
+ */
+sai_status_t stub_port_default_vlan_set(_In_ const sai_object_key_t      *key,
+                                        _In_ const sai_attribute_value_t *value,
+                                        void                             *arg)
+{
+    sai_status_t status;
+    uint32_t     port_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
+        return status;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Default VLAN Priority [uint8_t]
+ *  (default to 0) */
+sai_status_t stub_port_default_vlan_prio_set(_In_ const sai_object_key_t      *key,
+                                             _In_ const sai_attribute_value_t *value,
+                                             void                             *arg)
+{
+    sai_status_t status;
+    uint32_t     port_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
+        return status;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Ingress Filtering (Drop Frames with Unknown VLANs) [bool] */
+sai_status_t stub_port_ingress_filter_set(_In_ const sai_object_key_t      *key,
+                                          _In_ const sai_attribute_value_t *value,
+                                          void                             *arg)
+{
+    sai_status_t status;
+    uint32_t     port_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
+        return status;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Dropping of untagged frames on ingress [bool] */
+/* Dropping of tagged frames on ingress [bool] */
+sai_status_t stub_port_drop_tags_set(_In_ const sai_object_key_t      *key,
+                                     _In_ const sai_attribute_value_t *value,
+                                     void                             *arg)
+{
+    sai_status_t status;
+    uint32_t     port_id;
+
+    STUB_LOG_ENTER();
+
+    assert((SAI_PORT_ATTR_DROP_UNTAGGED == (int64_t)arg) || (SAI_PORT_ATTR_DROP_TAGGED == (int64_t)arg));
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
+        return status;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Internal loopback control [sai_port_loopback_mode_t] */
+sai_status_t stub_port_internal_loopback_set(_In_ const sai_object_key_t      *key,
+                                             _In_ const sai_attribute_value_t *value,
+                                             void                             *arg)
+{
+    sai_status_t status;
+    uint32_t     port_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
+        return status;
+    }
+
+    switch (value->s32) {
+    case SAI_PORT_INTERNAL_LOOPBACK_NONE:
+        break;
+
+    case SAI_PORT_INTERNAL_LOOPBACK_PHY:
+        break;
 
     case SAI_PORT_INTERNAL_LOOPBACK_MAC:
         break;
@@ -595,7 +1175,7 @@ sai_status_t stub_port_fdb_learning_set(_In_ const sai_object_key_t      *key,
 
     STUB_LOG_ENTER();
 
-    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
+    if (SAI_STATUS_SUCCESS != (status = port_id_get(key, &port_id))) {
         return status;
     }
 
@@ -616,6 +1196,8 @@ sai_status_t stub_port_fdb_learning_set(_In_ const sai_object_key_t      *key,
         return SAI_STATUS_INVALID_ATTR_VALUE_0;
     }
 
+    __atomic_store_n(&port_learn_mode_db[port_id], value->s32, __ATOMIC_RELAXED);
+
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
 }
@@ -648,6 +1230,18 @@ sai_status_t stub_port_speed_set(_In_ const sai_object_key_t *key, _In_ const sa
         return status;
     }
 
+    if (port_id >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid port %u\n", port_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (0 == value->u32) {
+        STUB_LOG_ERR("Invalid port speed %u\n", value->u32);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0;
+    }
+
+    port_speed_db[port_id] = value->u32;
+
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
 }
@@ -702,11 +1296,11 @@ sai_status_t stub_port_max_learned_addr_get(_In_ const sai_object_key_t   *key,
 
     STUB_LOG_ENTER();
 
-    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
+    if (SAI_STATUS_SUCCESS != (status = port_id_get(key, &port_id))) {
         return status;
     }
 
-    value->u32 = 100000;
+    value->u32 = __atomic_load_n(&port_max_learned_db[port_id], __ATOMIC_RELAXED);
 
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
@@ -726,11 +1320,11 @@ sai_status_t stub_port_fdb_violation_get(_In_ const sai_object_key_t   *key,
 
     STUB_LOG_ENTER();
 
-    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
+    if (SAI_STATUS_SUCCESS != (status = port_id_get(key, &port_id))) {
         return status;
     }
 
-    value->s32 = SAI_PACKET_ACTION_DROP;
+    value->s32 = __atomic_load_n(&port_fdb_violation_db[port_id], __ATOMIC_RELAXED);
 
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
@@ -821,10 +1415,15 @@ sai_status_t stub_port_state_get(_In_ const sai_object_key_t   *key,
         return status;
     }
 
+    if (port_id >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid port %u\n", port_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
     if (SAI_PORT_ATTR_OPER_STATUS == (int64_t)arg) {
-        value->s32 = SAI_PORT_OPER_STATUS_UP;
+        value->s32 = port_admin_down_db[port_id] ? SAI_PORT_OPER_STATUS_DOWN : SAI_PORT_OPER_STATUS_UP;
     } else {
-        value->booldata = true;
+        value->booldata = !port_admin_down_db[port_id];
     }
 
     STUB_LOG_EXIT();
@@ -909,24 +1508,241 @@ sai_status_t stub_port_speed_get(_In_ const sai_object_key_t   *key,
     sai_status_t status;
     uint32_t     port_id;
 
-    STUB_LOG_ENTER();
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_port_speed_get(port_id, &value->u32))) {
+        return status;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Autoneg mode [bool] */
+sai_status_t stub_port_autoneg_get(_In_ const sai_object_key_t   *key,
+                                   _Inout_ sai_attribute_value_t *value,
+                                   _In_ uint32_t                  attr_index,
+                                   _Inout_ vendor_cache_t        *cache,
+                                   void                          *arg)
+{
+    sai_status_t status;
+    uint32_t     port_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
+        return status;
+    }
+
+    value->booldata = false;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Default VLAN [sai_vlan_id_t]
+ *   Untagged ingress frames are tagged with default VLAN
+ */
+sai_status_t stub_port_default_vlan_get(_In_ const sai_object_key_t   *key,
+                                        _Inout_ sai_attribute_value_t *value,
+                                        _In_ uint32_t                  attr_index,
+                                        _Inout_ vendor_cache_t        *cache,
+                                        void                          *arg)
+{
+    sai_status_t status;
+    uint32_t     port_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
+        return status;
+    }
+
+    value->u16 = 1;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Default VLAN Priority [uint8_t]
+ *  (default to 0) */
+sai_status_t stub_port_default_vlan_prio_get(_In_ const sai_object_key_t   *key,
+                                             _Inout_ sai_attribute_value_t *value,
+                                             _In_ uint32_t                  attr_index,
+                                             _Inout_ vendor_cache_t        *cache,
+                                             void                          *arg)
+{
+    sai_status_t status;
+    uint32_t     port_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
+        return status;
+    }
+
+    value->u8 = 0;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Ingress Filtering (Drop Frames with Unknown VLANs) [bool] */
+sai_status_t stub_port_ingress_filter_get(_In_ const sai_object_key_t   *key,
+                                          _Inout_ sai_attribute_value_t *value,
+                                          _In_ uint32_t                  attr_index,
+                                          _Inout_ vendor_cache_t        *cache,
+                                          void                          *arg)
+{
+    sai_status_t status;
+    uint32_t     port_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
+        return status;
+    }
+
+    value->booldata = false;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Dropping of untagged frames on ingress [bool] */
+/* Dropping of tagged frames on ingress [bool] */
+sai_status_t stub_port_drop_tags_get(_In_ const sai_object_key_t   *key,
+                                     _Inout_ sai_attribute_value_t *value,
+                                     _In_ uint32_t                  attr_index,
+                                     _Inout_ vendor_cache_t        *cache,
+                                     void                          *arg)
+{
+    sai_status_t status;
+    uint32_t     port_id;
+
+    STUB_LOG_ENTER();
+
+    assert((SAI_PORT_ATTR_DROP_UNTAGGED == (int64_t)arg) || (SAI_PORT_ATTR_DROP_TAGGED == (int64_t)arg));
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
+        return status;
+    }
+
+    value->booldata = false;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Internal loopback control [sai_port_internal_loopback_mode_t] */
+sai_status_t stub_port_internal_loopback_get(_In_ const sai_object_key_t   *key,
+                                             _Inout_ sai_attribute_value_t *value,
+                                             _In_ uint32_t                  attr_index,
+                                             _Inout_ vendor_cache_t        *cache,
+                                             void                          *arg)
+{
+    sai_status_t status;
+    uint32_t     port_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
+        return status;
+    }
+
+    value->s32 = SAI_PORT_INTERNAL_LOOPBACK_NONE;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* FDB Learning mode [sai_port_fdb_learning_mode_t] */
+sai_status_t stub_port_fdb_learning_get(_In_ const sai_object_key_t   *key,
+                                        _Inout_ sai_attribute_value_t *value,
+                                        _In_ uint32_t                  attr_index,
+                                        _Inout_ vendor_cache_t        *cache,
+                                        void                          *arg)
+{
+    sai_status_t status;
+    uint32_t     port_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = port_id_get(key, &port_id))) {
+        return status;
+    }
+
+    value->s32 = __atomic_load_n(&port_learn_mode_db[port_id], __ATOMIC_RELAXED);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* MTU [uint32_t] */
+sai_status_t stub_port_mtu_get(_In_ const sai_object_key_t   *key,
+                               _Inout_ sai_attribute_value_t *value,
+                               _In_ uint32_t                  attr_index,
+                               _Inout_ vendor_cache_t        *cache,
+                               void                          *arg)
+{
+    sai_status_t status;
+    uint32_t     port_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
+        return status;
+    }
+
+    value->u32 = 1514;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Ingress priority groups [uint32_t count, sai_object_list_t list] */
+sai_status_t stub_port_priority_groups_get(_In_ const sai_object_key_t   *key,
+                                           _Inout_ sai_attribute_value_t *value,
+                                           _In_ uint32_t                  attr_index,
+                                           _Inout_ vendor_cache_t        *cache,
+                                           void                          *arg)
+{
+    sai_status_t    status;
+    uint32_t        port_id, count = BUFFER_PG_PER_PORT;
+    sai_object_id_t pgs[BUFFER_PG_PER_PORT];
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
+        return status;
+    }
+
+    if (SAI_PORT_ATTR_NUMBER_OF_INGRESS_PRIORITY_GROUPS == (int64_t)arg) {
+        value->u32 = BUFFER_PG_PER_PORT;
+        STUB_LOG_EXIT();
+        return SAI_STATUS_SUCCESS;
+    }
 
-    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
+    if (SAI_STATUS_SUCCESS != (status = db_buffer_port_priority_groups_get(port_id, pgs, &count))) {
         return status;
     }
 
-    value->u32 = 40000;
+    status = stub_fill_objlist(pgs, count, &value->objlist);
 
     STUB_LOG_EXIT();
-    return SAI_STATUS_SUCCESS;
+    return status;
 }
 
-/* Autoneg mode [bool] */
-sai_status_t stub_port_autoneg_get(_In_ const sai_object_key_t   *key,
-                                   _Inout_ sai_attribute_value_t *value,
-                                   _In_ uint32_t                  attr_index,
-                                   _Inout_ vendor_cache_t        *cache,
-                                   void                          *arg)
+/* Default traffic class of packets not classified by a map [sai_uint8_t] */
+sai_status_t stub_port_default_tc_get(_In_ const sai_object_key_t   *key,
+                                      _Inout_ sai_attribute_value_t *value,
+                                      _In_ uint32_t                  attr_index,
+                                      _Inout_ vendor_cache_t        *cache,
+                                      void                          *arg)
 {
     sai_status_t status;
     uint32_t     port_id;
@@ -937,20 +1753,16 @@ sai_status_t stub_port_autoneg_get(_In_ const sai_object_key_t   *key,
         return status;
     }
 
-    value->booldata = false;
+    status = db_qos_map_port_default_tc_get(port_id, &value->u8);
 
     STUB_LOG_EXIT();
-    return SAI_STATUS_SUCCESS;
+    return status;
 }
 
-/* Default VLAN [sai_vlan_id_t]
- *   Untagged ingress frames are tagged with default VLAN
- */
-sai_status_t stub_port_default_vlan_get(_In_ const sai_object_key_t   *key,
-                                        _Inout_ sai_attribute_value_t *value,
-                                        _In_ uint32_t                  attr_index,
-                                        _Inout_ vendor_cache_t        *cache,
-                                        void                          *arg)
+/* Default traffic class of packets not classified by a map [sai_uint8_t] */
+sai_status_t stub_port_default_tc_set(_In_ const sai_object_key_t      *key,
+                                      _In_ const sai_attribute_value_t *value,
+                                      void                             *arg)
 {
     sai_status_t status;
     uint32_t     port_id;
@@ -961,19 +1773,18 @@ sai_status_t stub_port_default_vlan_get(_In_ const sai_object_key_t   *key,
         return status;
     }
 
-    value->u16 = 1;
+    status = db_qos_map_port_default_tc_set(port_id, value->u8);
 
     STUB_LOG_EXIT();
-    return SAI_STATUS_SUCCESS;
+    return status;
 }
 
-/* Default VLAN Priority [uint8_t]
- *  (default to 0) */
-sai_status_t stub_port_default_vlan_prio_get(_In_ const sai_object_key_t   *key,
-                                             _Inout_ sai_attribute_value_t *value,
-                                             _In_ uint32_t                  attr_index,
-                                             _Inout_ vendor_cache_t        *cache,
-                                             void                          *arg)
+/* QoS maps [sai_object_id_t] */
+sai_status_t stub_port_qos_map_get(_In_ const sai_object_key_t   *key,
+                                   _Inout_ sai_attribute_value_t *value,
+                                   _In_ uint32_t                  attr_index,
+                                   _Inout_ vendor_cache_t        *cache,
+                                   void                          *arg)
 {
     sai_status_t status;
     uint32_t     port_id;
@@ -984,18 +1795,16 @@ sai_status_t stub_port_default_vlan_prio_get(_In_ const sai_object_key_t   *key,
         return status;
     }
 
-    value->u8 = 0;
+    status = db_qos_map_port_bound_get(port_id, (sai_qos_map_type_t)(int64_t)arg, &value->oid);
 
     STUB_LOG_EXIT();
-    return SAI_STATUS_SUCCESS;
+    return status;
 }
 
-/* Ingress Filtering (Drop Frames with Unknown VLANs) [bool] */
-sai_status_t stub_port_ingress_filter_get(_In_ const sai_object_key_t   *key,
-                                          _Inout_ sai_attribute_value_t *value,
-                                          _In_ uint32_t                  attr_index,
-                                          _Inout_ vendor_cache_t        *cache,
-                                          void                          *arg)
+/* QoS maps [sai_object_id_t] */
+sai_status_t stub_port_qos_map_set(_In_ const sai_object_key_t      *key,
+                                   _In_ const sai_attribute_value_t *value,
+                                   void                             *arg)
 {
     sai_status_t status;
     uint32_t     port_id;
@@ -1006,43 +1815,38 @@ sai_status_t stub_port_ingress_filter_get(_In_ const sai_object_key_t   *key,
         return status;
     }
 
-    value->booldata = false;
+    status = db_qos_map_port_bind(port_id, (sai_qos_map_type_t)(int64_t)arg, value->oid);
 
     STUB_LOG_EXIT();
-    return SAI_STATUS_SUCCESS;
+    return status;
 }
 
-/* Dropping of untagged frames on ingress [bool] */
-/* Dropping of tagged frames on ingress [bool] */
-sai_status_t stub_port_drop_tags_get(_In_ const sai_object_key_t   *key,
-                                     _Inout_ sai_attribute_value_t *value,
-                                     _In_ uint32_t                  attr_index,
-                                     _Inout_ vendor_cache_t        *cache,
-                                     void                          *arg)
+/* Samplepacket session [sai_object_id_t], arg is true for ingress */
+sai_status_t stub_port_samplepacket_get(_In_ const sai_object_key_t   *key,
+                                       _Inout_ sai_attribute_value_t *value,
+                                       _In_ uint32_t                  attr_index,
+                                       _Inout_ vendor_cache_t        *cache,
+                                       void                          *arg)
 {
     sai_status_t status;
     uint32_t     port_id;
 
     STUB_LOG_ENTER();
 
-    assert((SAI_PORT_ATTR_DROP_UNTAGGED == (int64_t)arg) || (SAI_PORT_ATTR_DROP_TAGGED == (int64_t)arg));
-
     if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_PORT, &port_id))) {
         return status;
     }
 
-    value->booldata = false;
+    status = db_samplepacket_port_bound_get(port_id, (bool)(int64_t)arg, &value->oid);
 
     STUB_LOG_EXIT();
-    return SAI_STATUS_SUCCESS;
+    return status;
 }
 
-/* Internal loopback control [sai_port_internal_loopback_mode_t] */
-sai_status_t stub_port_internal_loopback_get(_In_ const sai_object_key_t   *key,
-                                             _Inout_ sai_attribute_value_t *value,
-                                             _In_ uint32_t                  attr_index,
-                                             _Inout_ vendor_cache_t        *cache,
-                                             void                          *arg)
+/* Samplepacket session [sai_object_id_t], arg is true for ingress */
+sai_status_t stub_port_samplepacket_set(_In_ const sai_object_key_t      *key,
+                                       _In_ const sai_attribute_value_t *value,
+                                       void                             *arg)
 {
     sai_status_t status;
     uint32_t     port_id;
@@ -1053,18 +1857,18 @@ sai_status_t stub_port_internal_loopback_get(_In_ const sai_object_key_t   *key,
         return status;
     }
 
-    value->s32 = SAI_PORT_INTERNAL_LOOPBACK_NONE;
+    status = db_samplepacket_port_bind(port_id, (bool)(int64_t)arg, value->oid);
 
     STUB_LOG_EXIT();
-    return SAI_STATUS_SUCCESS;
+    return status;
 }
 
-/* FDB Learning mode [sai_port_fdb_learning_mode_t] */
-sai_status_t stub_port_fdb_learning_get(_In_ const sai_object_key_t   *key,
-                                        _Inout_ sai_attribute_value_t *value,
-                                        _In_ uint32_t                  attr_index,
-                                        _Inout_ vendor_cache_t        *cache,
-                                        void                          *arg)
+/* Mirror sessions [sai_object_list_t], arg is true for ingress */
+sai_status_t stub_port_mirror_session_get(_In_ const sai_object_key_t   *key,
+                                         _Inout_ sai_attribute_value_t *value,
+                                         _In_ uint32_t                  attr_index,
+                                         _Inout_ vendor_cache_t        *cache,
+                                         void                          *arg)
 {
     sai_status_t status;
     uint32_t     port_id;
@@ -1075,18 +1879,16 @@ sai_status_t stub_port_fdb_learning_get(_In_ const sai_object_key_t   *key,
         return status;
     }
 
-    value->s32 = SAI_PORT_LEARN_MODE_HW;
+    status = db_mirror_port_sessions_get(port_id, (bool)(int64_t)arg, &value->objlist);
 
     STUB_LOG_EXIT();
-    return SAI_STATUS_SUCCESS;
+    return status;
 }
 
-/* MTU [uint32_t] */
-sai_status_t stub_port_mtu_get(_In_ const sai_object_key_t   *key,
-                               _Inout_ sai_attribute_value_t *value,
-                               _In_ uint32_t                  attr_index,
-                               _Inout_ vendor_cache_t        *cache,
-                               void                          *arg)
+/* Mirror sessions [sai_object_list_t], arg is true for ingress */
+sai_status_t stub_port_mirror_session_set(_In_ const sai_object_key_t      *key,
+                                         _In_ const sai_attribute_value_t *value,
+                                         void                             *arg)
 {
     sai_status_t status;
     uint32_t     port_id;
@@ -1097,10 +1899,10 @@ sai_status_t stub_port_mtu_get(_In_ const sai_object_key_t   *key,
         return status;
     }
 
-    value->u32 = 1514;
+    status = db_mirror_port_sessions_set(port_id, (bool)(int64_t)arg, &value->objlist);
 
     STUB_LOG_EXIT();
-    return SAI_STATUS_SUCCESS;
+    return status;
 }
 
 static void port_key_to_str(_In_ sai_object_id_t port_id, _Out_ char *key_str)
@@ -1206,171 +2008,203 @@ sai_status_t stub_get_port_stats(_In_ sai_object_id_t                port_id,
         return status;
     }
 
-    for (ii = 0; ii < number_of_counters; ii++) {
-        switch (counter_ids[ii]) {
-        case SAI_PORT_STAT_IF_IN_OCTETS:
-            counters[ii] = 0;
-            break;
-
-        case SAI_PORT_STAT_IF_IN_UCAST_PKTS:
-            counters[ii] = 0;
-            break;
-
-        case SAI_PORT_STAT_IF_IN_NON_UCAST_PKTS:
-            counters[ii] = 0;
-            break;
-
-        case SAI_PORT_STAT_IF_IN_DISCARDS:
-            counters[ii] = 0;
-            break;
+    if (port_data >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid port %u\n", port_data);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
 
-        case SAI_PORT_STAT_IF_IN_ERRORS:
-            counters[ii] = 0;
-            break;
+    for (ii = 0; ii < number_of_counters; ii++) {
+        if ((uint32_t)counter_ids[ii] >= PORT_STAT_COUNT) {
+            STUB_LOG_ERR("Invalid port counter %d\n", counter_ids[ii]);
+            return SAI_STATUS_INVALID_PARAMETER;
+        }
+    }
 
-        case SAI_PORT_STAT_IF_IN_UNKNOWN_PROTOS:
-            counters[ii] = 0;
-            break;
+    if (!port_stats_cache_read(1, &port_id, counter_ids, number_of_counters, counters)) {
+        for (ii = 0; ii < number_of_counters; ii++) {
+            counters[ii] = port_stat_read(port_data, counter_ids[ii]);
+        }
+    }
 
-        case SAI_PORT_STAT_IF_IN_BROADCAST_PKTS:
-            counters[ii] = 0;
-            break;
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
 
-        case SAI_PORT_STAT_IF_IN_MULTICAST_PKTS:
-            counters[ii] = 0;
-            break;
+/*
+ * Routine Description:
+ *   Get statistics counters of several ports.
+ *
+ * Arguments:
+ *    [in] number_of_ports - number of ports in the array
+ *    [in] port_ids - array of port ids
+ *    [in] counter_ids - specifies the array of counter ids, read for each port
+ *    [in] number_of_counters - number of counters in the array
+ *    [out] counters - matrix of resulting counter values, a row per port
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_port_stats_bulk(_In_ uint32_t                       number_of_ports,
+                                      _In_ const sai_object_id_t         *port_ids,
+                                      _In_ const sai_port_stat_counter_t *counter_ids,
+                                      _In_ uint32_t                       number_of_counters,
+                                      _Out_ uint64_t                     *counters)
+{
+    sai_status_t status;
+    uint32_t     ii, port_data;
 
-        case SAI_PORT_STAT_IF_OUT_OCTETS:
-            counters[ii] = 0;
-            break;
+    STUB_LOG_ENTER();
 
-        case SAI_PORT_STAT_IF_OUT_UCAST_PKTS:
-            counters[ii] = 0;
-            break;
+    STUB_LOG_NTC("Get port stats bulk, %u ports %u counters\n", number_of_ports, number_of_counters);
 
-        case SAI_PORT_STAT_IF_OUT_NON_UCAST_PKTS:
-            counters[ii] = 0;
-            break;
+    if (NULL == port_ids) {
+        STUB_LOG_ERR("NULL port ids array param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
 
-        case SAI_PORT_STAT_IF_OUT_DISCARDS:
-            counters[ii] = 0;
-            break;
+    if (NULL == counter_ids) {
+        STUB_LOG_ERR("NULL counter ids array param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
 
-        case SAI_PORT_STAT_IF_OUT_ERRORS:
-            counters[ii] = 0;
-            break;
+    if (NULL == counters) {
+        STUB_LOG_ERR("NULL counters array param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
 
-        case SAI_PORT_STAT_IF_OUT_BROADCAST_PKTS:
-            counters[ii] = 0;
-            break;
+    /* Validate everything first, nothing is read if any id is wrong */
+    for (ii = 0; ii < number_of_ports; ii++) {
+        if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(port_ids[ii], SAI_OBJECT_TYPE_PORT, &port_data))) {
+            return status;
+        }
 
-        case SAI_PORT_STAT_IF_OUT_MULTICAST_PKTS:
-            counters[ii] = 0;
-            break;
+        if (port_data >= PORT_NUMBER) {
+            STUB_LOG_ERR("Invalid port %u\n", port_data);
+            return SAI_STATUS_INVALID_PARAMETER;
+        }
+    }
 
-        case SAI_PORT_STAT_ETHER_STATS_DROP_EVENTS:
-            counters[ii] = 0;
-            break;
+    for (ii = 0; ii < number_of_counters; ii++) {
+        if ((uint32_t)counter_ids[ii] >= PORT_STAT_COUNT) {
+            STUB_LOG_ERR("Invalid port counter %d\n", counter_ids[ii]);
+            return SAI_STATUS_INVALID_PARAMETER;
+        }
+    }
 
-        case SAI_PORT_STAT_ETHER_STATS_MULTICAST_PKTS:
-            counters[ii] = 0;
-            break;
+    if (!port_stats_cache_read(number_of_ports, port_ids, counter_ids, number_of_counters, counters)) {
+        port_stats_bulk_read(number_of_ports, port_ids, counter_ids, number_of_counters, counters);
+    }
 
-        case SAI_PORT_STAT_ETHER_STATS_BROADCAST_PKTS:
-            counters[ii] = 0;
-            break;
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
 
-        case SAI_PORT_STAT_ETHER_STATS_UNDERSIZE_PKTS:
-            counters[ii] = 0;
-            break;
+/*
+ * Routine Description:
+ *   Clear port statistics counters.
+ *
+ * Arguments:
+ *    [in] port_id - port id
+ *    [in] counter_ids - specifies the array of counter ids
+ *    [in] number_of_counters - number of counters in the array
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_clear_port_stats(_In_ sai_object_id_t                port_id,
+                                   _In_ const sai_port_stat_counter_t *counter_ids,
+                                   _In_ uint32_t                       number_of_counters)
+{
+    sai_status_t status;
+    uint32_t     ii, port_data;
+    uint32_t     ids[PORT_STAT_COUNT];
+    uint32_t     count = 0;
+    char         key_str[MAX_KEY_STR_LEN];
 
-        case SAI_PORT_STAT_ETHER_STATS_FRAGMENTS:
-            counters[ii] = 0;
-            break;
+    STUB_LOG_ENTER();
 
-        case SAI_PORT_STAT_ETHER_STATS_PKTS_64_OCTETS:
-            counters[ii] = 0;
-            break;
+    port_key_to_str(port_id, key_str);
+    STUB_LOG_NTC("Clear port stats %s\n", key_str);
 
-        case SAI_PORT_STAT_ETHER_STATS_PKTS_65_TO_127_OCTETS:
-            counters[ii] = 0;
-            break;
+    if (NULL == counter_ids) {
+        STUB_LOG_ERR("NULL counter ids array param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
 
-        case SAI_PORT_STAT_ETHER_STATS_PKTS_128_TO_255_OCTETS:
-            counters[ii] = 0;
-            break;
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(port_id, SAI_OBJECT_TYPE_PORT, &port_data))) {
+        return status;
+    }
 
-        case SAI_PORT_STAT_ETHER_STATS_PKTS_256_TO_511_OCTETS:
-            counters[ii] = 0;
-            break;
+    if (port_data >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid port %u\n", port_data);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
 
-        case SAI_PORT_STAT_ETHER_STATS_PKTS_512_TO_1023_OCTETS:
-            counters[ii] = 0;
-            break;
+    for (ii = 0; ii < number_of_counters; ii++) {
+        if ((uint32_t)counter_ids[ii] >= PORT_STAT_COUNT) {
+            STUB_LOG_ERR("Invalid port counter %d\n", counter_ids[ii]);
+            return SAI_STATUS_INVALID_PARAMETER;
+        }
+    }
 
-        case SAI_PORT_STAT_ETHER_STATS_PKTS_1024_TO_1518_OCTETS:
-            counters[ii] = 0;
-            break;
+    /* Queue length is a gauge, not cleared */
+    for (ii = 0; ii < number_of_counters; ii++) {
+        if ((SAI_PORT_STAT_IF_OUT_QLEN != counter_ids[ii]) && (count < PORT_STAT_COUNT)) {
+            ids[count++] = counter_ids[ii];
+        }
+    }
 
-        case SAI_PORT_STAT_ETHER_STATS_OVERSIZE_PKTS:
-            counters[ii] = 0;
-            break;
+    port_stats_clear(port_data, count, ids);
+    db_counter_refresh();
 
-        case SAI_PORT_STAT_ETHER_STATS_JABBERS:
-            counters[ii] = 0;
-            break;
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
 
-        case SAI_PORT_STAT_ETHER_STATS_OCTETS:
-            counters[ii] = 0;
-            break;
+/*
+ * Routine Description:
+ *   Clear port's all statistics counters.
+ *
+ * Arguments:
+ *    [in] port_id - port id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_clear_port_all_stats(_In_ sai_object_id_t port_id)
+{
+    sai_status_t status;
+    uint32_t     ii, port_data;
+    uint32_t     ids[PORT_STAT_COUNT];
+    uint32_t     count = 0;
+    char         key_str[MAX_KEY_STR_LEN];
 
-        case SAI_PORT_STAT_ETHER_STATS_PKTS:
-            counters[ii] = 0;
-            break;
+    STUB_LOG_ENTER();
 
-        case SAI_PORT_STAT_ETHER_STATS_COLLISIONS:
-            counters[ii] = 0;
-            break;
+    port_key_to_str(port_id, key_str);
+    STUB_LOG_NTC("Clear port all stats %s\n", key_str);
 
-        case SAI_PORT_STAT_ETHER_STATS_CRC_ALIGN_ERRORS:
-            counters[ii] = 0;
-            break;
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(port_id, SAI_OBJECT_TYPE_PORT, &port_data))) {
+        return status;
+    }
 
-        case SAI_PORT_STAT_IF_IN_VLAN_DISCARDS:
-        case SAI_PORT_STAT_IF_OUT_QLEN:
-        case SAI_PORT_STAT_ETHER_RX_OVERSIZE_PKTS:
-        case SAI_PORT_STAT_ETHER_TX_OVERSIZE_PKTS:
-        case SAI_PORT_STAT_ETHER_STATS_TX_NO_ERRORS:
-        case SAI_PORT_STAT_ETHER_STATS_RX_NO_ERRORS:
-        case SAI_PORT_STAT_IP_IN_RECEIVES:
-        case SAI_PORT_STAT_IP_IN_OCTETS:
-        case SAI_PORT_STAT_IP_IN_UCAST_PKTS:
-        case SAI_PORT_STAT_IP_IN_NON_UCAST_PKTS:
-        case SAI_PORT_STAT_IP_IN_DISCARDS:
-        case SAI_PORT_STAT_IP_OUT_OCTETS:
-        case SAI_PORT_STAT_IP_OUT_UCAST_PKTS:
-        case SAI_PORT_STAT_IP_OUT_NON_UCAST_PKTS:
-        case SAI_PORT_STAT_IP_OUT_DISCARDS:
-        case SAI_PORT_STAT_IPV6_IN_RECEIVES:
-        case SAI_PORT_STAT_IPV6_IN_OCTETS:
-        case SAI_PORT_STAT_IPV6_IN_UCAST_PKTS:
-        case SAI_PORT_STAT_IPV6_IN_NON_UCAST_PKTS:
-        case SAI_PORT_STAT_IPV6_IN_MCAST_PKTS:
-        case SAI_PORT_STAT_IPV6_IN_DISCARDS:
-        case SAI_PORT_STAT_IPV6_OUT_OCTETS:
-        case SAI_PORT_STAT_IPV6_OUT_UCAST_PKTS:
-        case SAI_PORT_STAT_IPV6_OUT_NON_UCAST_PKTS:
-        case SAI_PORT_STAT_IPV6_OUT_MCAST_PKTS:
-        case SAI_PORT_STAT_IPV6_OUT_DISCARDS:
-            counters[ii] = 0;
-            break;
+    if (port_data >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid port %u\n", port_data);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
 
-        default:
-            STUB_LOG_ERR("Invalid port counter %d\n", counter_ids[ii]);
-            return SAI_STATUS_INVALID_PARAMETER;
+    for (ii = 0; ii < PORT_STAT_COUNT; ii++) {
+        if (SAI_PORT_STAT_IF_OUT_QLEN != ii) {
+            ids[count++] = ii;
         }
     }
 
+    port_stats_clear(port_data, count, ids);
+    db_counter_refresh();
+
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
 }
@@ -1379,6 +2213,7 @@ const sai_port_api_t port_api = {
     stub_set_port_attribute,
     stub_get_port_attribute,
     stub_get_port_stats,
-    NULL,
-    NULL
+    stub_clear_port_stats,
+    stub_clear_port_all_stats,
+    stub_get_port_stats_bulk
 };
@@ -0,0 +1,243 @@
+/*
+ *  Copyright (C) 2014. Mellanox Technologies, Ltd. ALL RIGHTS RESERVED.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ */
+
+#include "sai.h"
+#include "stub_sai.h"
+#include "assert.h"
+#include "strings.h"
+
+#undef  __MODULE__
+#define __MODULE__ SAI_PROFILE
+
+/*
+ * The switch profile is enumerated once when the switch is initialized, with
+ * the profile_get_next_value service, instead of modules asking the host for
+ * each key with profile_get_value and parsing the string they get.
+ *
+ * Keys and values are copied to one string pool, and the entries are kept
+ * sorted by key for binary search. Numbers and booleans are parsed at load,
+ * so the typed getters only look the key up. A key given twice keeps its
+ * last value. Keys which don't fit are left out whole, and fail the load.
+ */
+
+/* State DB *************/
+#define MAX_PROFILE_ENTRIES  256
+#define PROFILE_POOL_SIZE    16384
+
+typedef struct _stub_profile_entry_t {
+    const char *key;
+    const char *value;
+    uint32_t    u32;
+    bool        is_u32;
+    bool        boolean;
+    bool        is_bool;
+} stub_profile_entry_t;
+
+static stub_profile_entry_t profile_db[MAX_PROFILE_ENTRIES];
+static uint32_t             profile_count;
+static char                 profile_pool[PROFILE_POOL_SIZE];
+static uint32_t             profile_pool_used;
+
+/* Index of the key, or of the entry it would be inserted before */
+static uint32_t profile_search(_In_ const char *key, _Out_ bool *found)
+{
+    uint32_t low = 0, high = profile_count, mid;
+    int      cmp;
+
+    while (low < high) {
+        mid = low + (high - low) / 2;
+        cmp = strcmp(key, profile_db[mid].key);
+        if (0 == cmp) {
+            *found = true;
+            return mid;
+        }
+        if (cmp < 0) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+
+    *found = false;
+    return low;
+}
+
+static const char* profile_intern(_In_ const char *str)
+{
+    size_t length = strlen(str) + 1;
+    char  *copy;
+
+    if (length > PROFILE_POOL_SIZE - profile_pool_used) {
+        return NULL;
+    }
+
+    copy = &profile_pool[profile_pool_used];
+    memcpy(copy, str, length);
+    profile_pool_used += length;
+
+    return copy;
+}
+
+static void profile_parse(_Inout_ stub_profile_entry_t *entry)
+{
+    unsigned long value;
+    char         *end;
+
+    value         = strtoul(entry->value, &end, 0);
+    entry->is_u32 = (end != entry->value) && ('\0' == *end) && (value <= UINT32_MAX) && ('-' != entry->value[0]);
+    entry->u32    = entry->is_u32 ? (uint32_t)value : 0;
+
+    if ((0 == strcasecmp(entry->value, "true")) || (0 == strcmp(entry->value, "1"))) {
+        entry->is_bool = true;
+        entry->boolean = true;
+    } else if ((0 == strcasecmp(entry->value, "false")) || (0 == strcmp(entry->value, "0"))) {
+        entry->is_bool = true;
+        entry->boolean = false;
+    }
+}
+
+static sai_status_t profile_add(_In_ const char *key, _In_ const char *value)
+{
+    stub_profile_entry_t *entry;
+    uint32_t              index;
+    size_t                length;
+    bool                  found;
+
+    index = profile_search(key, &found);
+    if ((!found) && (MAX_PROFILE_ENTRIES == profile_count)) {
+        STUB_LOG_ERR("Profile table full, key %s ignored\n", key);
+        return SAI_STATUS_TABLE_FULL;
+    }
+
+    /* Both strings fit or none is copied, a key is never left without its value */
+    length = strlen(value) + 1 + (found ? 0 : strlen(key) + 1);
+    if (length > PROFILE_POOL_SIZE - profile_pool_used) {
+        STUB_LOG_ERR("Profile pool full, key %s ignored\n", key);
+        return SAI_STATUS_INSUFFICIENT_RESOURCES;
+    }
+
+    if (!found) {
+        memmove(&profile_db[index + 1], &profile_db[index], (profile_count - index) * sizeof(profile_db[0]));
+        profile_count++;
+        profile_db[index].key = profile_intern(key);
+    }
+
+    entry          = &profile_db[index];
+    entry->value   = profile_intern(value);
+    entry->is_u32  = false;
+    entry->is_bool = false;
+    profile_parse(entry);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Load all the keys of the switch profile, replacing those loaded before. A
+ * profile too big to load whole still gets the keys which fit, and fails
+ * with the status of the first key dropped
+ */
+sai_status_t db_profile_load(_In_ sai_switch_profile_id_t profile_id)
+{
+    const char  *key, *value;
+    sai_status_t status = SAI_STATUS_SUCCESS, add_status;
+    uint32_t     dropped = 0;
+
+    profile_count     = 0;
+    profile_pool_used = 0;
+
+    if (NULL == g_services.profile_get_next_value) {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    /* Restart the enumeration, the profile may have been walked before */
+    g_services.profile_get_next_value(profile_id, NULL, NULL);
+
+    while (0 == g_services.profile_get_next_value(profile_id, &key, &value)) {
+        if ((NULL == key) || (NULL == value)) {
+            continue;
+        }
+
+        STUB_LOG_DBG("Profile %s = %s\n", key, value);
+
+        if (SAI_STATUS_SUCCESS != (add_status = profile_add(key, value))) {
+            if (SAI_STATUS_SUCCESS == status) {
+                status = add_status;
+            }
+            dropped++;
+        }
+    }
+
+    if (0 != dropped) {
+        STUB_LOG_ERR("Loaded %u profile keys, %u dropped\n", profile_count, dropped);
+        return status;
+    }
+
+    STUB_LOG_NTC("Loaded %u profile keys\n", profile_count);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* String value of a key, NULL when it isn't in the profile */
+const char* db_profile_string_get(_In_ const char *key)
+{
+    uint32_t index;
+    bool     found;
+
+    index = profile_search(key, &found);
+
+    return found ? profile_db[index].value : NULL;
+}
+
+/* Number value of a key, the default when it isn't in the profile or isn't a number */
+uint32_t db_profile_u32_get(_In_ const char *key, _In_ uint32_t default_value)
+{
+    uint32_t index;
+    bool     found;
+
+    index = profile_search(key, &found);
+    if (!found) {
+        return default_value;
+    }
+
+    if (!profile_db[index].is_u32) {
+        STUB_LOG_WRN("Profile key %s value %s isn't a number\n", key, profile_db[index].value);
+        return default_value;
+    }
+
+    return profile_db[index].u32;
+}
+
+/* Boolean value of a key, true/false or 1/0, the default when it isn't in the profile or isn't one */
+bool db_profile_bool_get(_In_ const char *key, _In_ bool default_value)
+{
+    uint32_t index;
+    bool     found;
+
+    index = profile_search(key, &found);
+    if (!found) {
+        return default_value;
+    }
+
+    if (!profile_db[index].is_bool) {
+        STUB_LOG_WRN("Profile key %s value %s isn't a boolean\n", key, profile_db[index].value);
+        return default_value;
+    }
+
+    return profile_db[index].boolean;
+}
+
+/*************************/
@@ -0,0 +1,908 @@
+/*
+ *  Copyright (C) 2014. Mellanox Technologies, Ltd. ALL RIGHTS RESERVED.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ */
+
+#include "sai.h"
+#include "stub_sai.h"
+#include "assert.h"
+
+#undef  __MODULE__
+#define __MODULE__ SAI_QOS_MAP
+
+static const sai_attribute_entry_t qos_map_attribs[] = {
+    { SAI_QOS_MAP_ATTR_TYPE, true, true, false, true,
+      "QoS map type", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_QOS_MAP_ATTR_MAP_TO_VALUE_LIST, true, true, true, true,
+      "QoS map to value list", SAI_ATTR_VAL_TYPE_QOSMAP },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+sai_status_t stub_qos_map_type_get(_In_ const sai_object_key_t   *key,
+                                   _Inout_ sai_attribute_value_t *value,
+                                   _In_ uint32_t                  attr_index,
+                                   _Inout_ vendor_cache_t        *cache,
+                                   void                          *arg);
+sai_status_t stub_qos_map_list_get(_In_ const sai_object_key_t   *key,
+                                   _Inout_ sai_attribute_value_t *value,
+                                   _In_ uint32_t                  attr_index,
+                                   _Inout_ vendor_cache_t        *cache,
+                                   void                          *arg);
+sai_status_t stub_qos_map_list_set(_In_ const sai_object_key_t      *key,
+                                   _In_ const sai_attribute_value_t *value,
+                                   void                             *arg);
+
+static const sai_vendor_attribute_entry_t qos_map_vendor_attribs[] = {
+    { SAI_QOS_MAP_ATTR_TYPE,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_qos_map_type_get, NULL,
+      NULL, NULL },
+    { SAI_QOS_MAP_ATTR_MAP_TO_VALUE_LIST,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_qos_map_list_get, NULL,
+      stub_qos_map_list_set, NULL },
+};
+
+/* State DB *************/
+
+/*
+ * Every map is compiled into a dense table indexed by its key: DSCP (64),
+ * dot1p or PFC priority (8), traffic class (16) or traffic class and color
+ * (tc << 2 | color, 64), so any map fits one 64 byte table.
+ *
+ * The maps bound to a port are further fused into one read only table per
+ * port, giving traffic class, queue, priority group and color of a packet
+ * with a single load indexed by its DSCP or dot1p. Updates build a new port
+ * table and swap the pointer, so the packet path never waits for the control
+ * path. Replaced tables are freed once no core reads with an epoch from
+ * before the swap.
+ */
+#define MAX_QOS_MAP_NUMBER   128
+#define QOS_MAP_TYPES        (SAI_QOS_MAP_TYPE_PFC_PRIORITY_TO_QUEUE + 1)
+#define QOS_MAP_TABLE_SIZE   64
+#define QOS_MAP_DSCP_NUMBER  64
+#define QOS_MAP_PRIO_NUMBER  8
+#define QOS_MAP_TC_NUMBER    QUEUE_MAX_INDEX
+#define QOS_MAP_COLOR_BITS   2
+#define QOS_MAP_KEEP         0xFF
+
+/* Index of the fused classification table, DSCP keys first */
+#define QOS_MAP_CLASS_DOT1P    QOS_MAP_DSCP_NUMBER
+#define QOS_MAP_CLASS_UNTAGGED (QOS_MAP_CLASS_DOT1P + QOS_MAP_PRIO_NUMBER)
+#define QOS_MAP_CLASS_KEYS     (QOS_MAP_CLASS_UNTAGGED + 1)
+
+typedef enum _stub_qos_map_field_t {
+    QOS_MAP_FIELD_TC,
+    QOS_MAP_FIELD_DSCP,
+    QOS_MAP_FIELD_DOT1P,
+    QOS_MAP_FIELD_PRIO,
+    QOS_MAP_FIELD_PG,
+    QOS_MAP_FIELD_QUEUE,
+    QOS_MAP_FIELD_COLOR,
+    QOS_MAP_FIELD_TC_AND_COLOR,
+} stub_qos_map_field_t;
+
+static const uint32_t qos_map_field_limits[] = {
+    [QOS_MAP_FIELD_TC]           = QOS_MAP_TC_NUMBER,
+    [QOS_MAP_FIELD_DSCP]         = QOS_MAP_DSCP_NUMBER,
+    [QOS_MAP_FIELD_DOT1P]        = QOS_MAP_PRIO_NUMBER,
+    [QOS_MAP_FIELD_PRIO]         = QOS_MAP_PRIO_NUMBER,
+    [QOS_MAP_FIELD_PG]           = BUFFER_PG_PER_PORT,
+    [QOS_MAP_FIELD_QUEUE]        = QUEUE_MAX_INDEX,
+    [QOS_MAP_FIELD_COLOR]        = SAI_PACKET_COLOR_RED + 1,
+    [QOS_MAP_FIELD_TC_AND_COLOR] = QOS_MAP_TC_NUMBER << QOS_MAP_COLOR_BITS,
+};
+
+/* Key and value field of each map type */
+static const stub_qos_map_field_t qos_map_type_fields[QOS_MAP_TYPES][2] = {
+    [SAI_QOS_MAP_TYPE_DOT1P_TO_TC]                    = { QOS_MAP_FIELD_DOT1P, QOS_MAP_FIELD_TC },
+    [SAI_QOS_MAP_TYPE_DOT1P_TO_COLOR]                 = { QOS_MAP_FIELD_DOT1P, QOS_MAP_FIELD_COLOR },
+    [SAI_QOS_MAP_TYPE_DSCP_TO_TC]                     = { QOS_MAP_FIELD_DSCP, QOS_MAP_FIELD_TC },
+    [SAI_QOS_MAP_TYPE_DSCP_TO_COLOR]                  = { QOS_MAP_FIELD_DSCP, QOS_MAP_FIELD_COLOR },
+    [SAI_QOS_MAP_TYPE_TC_TO_QUEUE]                    = { QOS_MAP_FIELD_TC, QOS_MAP_FIELD_QUEUE },
+    [SAI_QOS_MAP_TYPE_TC_AND_COLOR_TO_DSCP]           = { QOS_MAP_FIELD_TC_AND_COLOR, QOS_MAP_FIELD_DSCP },
+    [SAI_QOS_MAP_TYPE_TC_AND_COLOR_TO_DOT1P]          = { QOS_MAP_FIELD_TC_AND_COLOR, QOS_MAP_FIELD_DOT1P },
+    [SAI_QOS_MAP_TYPE_TC_TO_PRIORITY_GROUP]           = { QOS_MAP_FIELD_TC, QOS_MAP_FIELD_PG },
+    [SAI_QOS_MAP_TYPE_PFC_PRIORITY_TO_PRIORITY_GROUP] = { QOS_MAP_FIELD_PRIO, QOS_MAP_FIELD_PG },
+    [SAI_QOS_MAP_TYPE_PFC_PRIORITY_TO_QUEUE]          = { QOS_MAP_FIELD_PRIO, QOS_MAP_FIELD_QUEUE },
+};
+
+typedef struct _stub_qos_map_t {
+    sai_qos_map_type_t type;
+    uint32_t           count;
+    sai_qos_map_t      list[QOS_MAP_TABLE_SIZE];
+    uint8_t            table[QOS_MAP_TABLE_SIZE];
+    /* Bit per table key given in the list, other keys map to the defaults */
+    uint64_t           mapped;
+    uint32_t           ref_count;
+    bool               is_valid;
+} stub_qos_map_t;
+
+/* Maps bound to a port, and its default traffic class */
+typedef struct _stub_qos_map_port_t {
+    sai_object_id_t maps[QOS_MAP_TYPES];
+    uint8_t         default_tc;
+} stub_qos_map_port_t;
+
+typedef struct _stub_qos_port_table_t {
+    bool                 trust_dscp;
+    stub_qos_class_t     classes[QOS_MAP_CLASS_KEYS];
+    /* DSCP and dot1p by tc << 2 | color, QOS_MAP_KEEP leaves the header unchanged */
+    uint8_t              remark_dscp[QOS_MAP_TABLE_SIZE];
+    uint8_t              remark_dot1p[QOS_MAP_TABLE_SIZE];
+    uint8_t              pfc_queue[QOS_MAP_PRIO_NUMBER];
+    uint8_t              pfc_pg[QOS_MAP_PRIO_NUMBER];
+    stub_epoch_retired_t retired;
+} stub_qos_port_table_t;
+
+static stub_qos_map_t         qos_map_db[MAX_QOS_MAP_NUMBER];
+static stub_qos_map_port_t    qos_map_port_db[PORT_NUMBER];
+static stub_qos_port_table_t *qos_map_port_tables[PORT_NUMBER];
+static stub_epoch_domain_t    qos_map_epoch = STUB_EPOCH_DOMAIN_INIT;
+
+/* Ports with no map bound yet */
+static const stub_qos_port_table_t qos_map_default_table = {
+    .remark_dscp  = { [0 ... QOS_MAP_TABLE_SIZE - 1] = QOS_MAP_KEEP },
+    .remark_dot1p = { [0 ... QOS_MAP_TABLE_SIZE - 1] = QOS_MAP_KEEP },
+    .pfc_queue    = { 0, 1, 2, 3, 4, 5, 6, 7 },
+    .pfc_pg       = { 0, 1, 2, 3, 4, 5, 6, 7 },
+};
+
+static sai_status_t db_get_qos_map(_In_ uint32_t map_id, _Out_ stub_qos_map_t **map)
+{
+    if ((map_id >= MAX_QOS_MAP_NUMBER) || (!qos_map_db[map_id].is_valid)) {
+        STUB_LOG_ERR("Invalid QoS map ID %u\n", map_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *map = &qos_map_db[map_id];
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t db_find_free_qos_map_index(_Out_ uint32_t *free_index)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < MAX_QOS_MAP_NUMBER; ii++) {
+        if (false == qos_map_db[ii].is_valid) {
+            *free_index = ii;
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+
+    STUB_LOG_ERR("QoS map table full\n");
+    return SAI_STATUS_TABLE_FULL;
+}
+
+static uint32_t qos_map_field_get(_In_ const sai_qos_map_params_t *params, _In_ stub_qos_map_field_t field)
+{
+    switch (field) {
+    case QOS_MAP_FIELD_TC:
+        return params->tc;
+
+    case QOS_MAP_FIELD_DSCP:
+        return params->dscp;
+
+    case QOS_MAP_FIELD_DOT1P:
+        return params->dot1p;
+
+    case QOS_MAP_FIELD_PRIO:
+        return params->prio;
+
+    case QOS_MAP_FIELD_PG:
+        return params->pg;
+
+    case QOS_MAP_FIELD_QUEUE:
+        return params->queue_index;
+
+    case QOS_MAP_FIELD_COLOR:
+        return params->color;
+
+    case QOS_MAP_FIELD_TC_AND_COLOR:
+        if ((params->tc >= QOS_MAP_TC_NUMBER) || ((uint32_t)params->color > SAI_PACKET_COLOR_RED)) {
+            return UINT32_MAX;
+        }
+        return ((uint32_t)params->tc << QOS_MAP_COLOR_BITS) | params->color;
+    }
+
+    return UINT32_MAX;
+}
+
+/* Compile the key/value list of a map into its dense table */
+static sai_status_t qos_map_compile(_Inout_ stub_qos_map_t         *map,
+                                    _In_ const sai_qos_map_list_t *list,
+                                    _In_ uint32_t                  attr_index)
+{
+    stub_qos_map_field_t key_field   = qos_map_type_fields[map->type][0];
+    stub_qos_map_field_t value_field = qos_map_type_fields[map->type][1];
+    uint32_t             ii, key, value;
+
+    if (list->count > QOS_MAP_TABLE_SIZE) {
+        STUB_LOG_ERR("QoS map entries count %u exceeds maximum %u\n", list->count, QOS_MAP_TABLE_SIZE);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + attr_index;
+    }
+
+    memset(map->table, 0, sizeof(map->table));
+    map->mapped = 0;
+
+    for (ii = 0; ii < list->count; ii++) {
+        key   = qos_map_field_get(&list->list[ii].key, key_field);
+        value = qos_map_field_get(&list->list[ii].value, value_field);
+
+        if (key >= qos_map_field_limits[key_field]) {
+            STUB_LOG_ERR("Invalid QoS map entry %u key\n", ii);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + attr_index;
+        }
+        if (value >= qos_map_field_limits[value_field]) {
+            STUB_LOG_ERR("Invalid QoS map entry %u value %u\n", ii, value);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + attr_index;
+        }
+        if (map->mapped & (1ULL << key)) {
+            STUB_LOG_ERR("QoS map entry %u key appears twice\n", ii);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + attr_index;
+        }
+
+        map->table[key] = value;
+        map->mapped    |= 1ULL << key;
+    }
+
+    memcpy(map->list, list->list, sizeof(*list->list) * list->count);
+    map->count = list->count;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static const stub_qos_map_t* qos_map_port_map(_In_ uint32_t port_id, _In_ sai_qos_map_type_t type)
+{
+    stub_qos_map_t *map;
+    uint32_t        map_id;
+
+    if (SAI_NULL_OBJECT_ID == qos_map_port_db[port_id].maps[type]) {
+        return NULL;
+    }
+
+    assert(SAI_STATUS_SUCCESS ==
+           stub_object_to_type(qos_map_port_db[port_id].maps[type], SAI_OBJECT_TYPE_QOS_MAP, &map_id));
+    assert(SAI_STATUS_SUCCESS == db_get_qos_map(map_id, &map));
+
+    return map;
+}
+
+/* Value of a key in a bound map, defaults to 0 for keys not in the map, or to
+ * unbound for a port without such map */
+static uint8_t qos_map_lookup(_In_ const stub_qos_map_t *map, _In_ uint32_t key, _In_ uint8_t unbound)
+{
+    if (NULL == map) {
+        return unbound;
+    }
+
+    return (map->mapped & (1ULL << key)) ? map->table[key] : 0;
+}
+
+static void qos_map_class_fill(_Out_ stub_qos_class_t     *class,
+                               _In_ uint8_t                tc,
+                               _In_ uint8_t                color,
+                               _In_ const stub_qos_map_t *tc_to_queue,
+                               _In_ const stub_qos_map_t *tc_to_pg)
+{
+    class->tc             = tc;
+    class->color          = color;
+    class->queue_index    = qos_map_lookup(tc_to_queue, tc, tc);
+    class->priority_group = qos_map_lookup(tc_to_pg, tc, 0);
+}
+
+/* Fuse the maps bound to a port into its classification table */
+static void qos_map_port_table_build(_In_ uint32_t port_id, _Out_ stub_qos_port_table_t *table)
+{
+    const stub_qos_map_t *dscp_tc      = qos_map_port_map(port_id, SAI_QOS_MAP_TYPE_DSCP_TO_TC);
+    const stub_qos_map_t *dscp_color   = qos_map_port_map(port_id, SAI_QOS_MAP_TYPE_DSCP_TO_COLOR);
+    const stub_qos_map_t *dot1p_tc     = qos_map_port_map(port_id, SAI_QOS_MAP_TYPE_DOT1P_TO_TC);
+    const stub_qos_map_t *dot1p_color  = qos_map_port_map(port_id, SAI_QOS_MAP_TYPE_DOT1P_TO_COLOR);
+    const stub_qos_map_t *tc_queue     = qos_map_port_map(port_id, SAI_QOS_MAP_TYPE_TC_TO_QUEUE);
+    const stub_qos_map_t *tc_pg        = qos_map_port_map(port_id, SAI_QOS_MAP_TYPE_TC_TO_PRIORITY_GROUP);
+    const stub_qos_map_t *remark_dscp  = qos_map_port_map(port_id, SAI_QOS_MAP_TYPE_TC_AND_COLOR_TO_DSCP);
+    const stub_qos_map_t *remark_dot1p = qos_map_port_map(port_id, SAI_QOS_MAP_TYPE_TC_AND_COLOR_TO_DOT1P);
+    const stub_qos_map_t *pfc_queue    = qos_map_port_map(port_id, SAI_QOS_MAP_TYPE_PFC_PRIORITY_TO_QUEUE);
+    const stub_qos_map_t *pfc_pg       = qos_map_port_map(port_id, SAI_QOS_MAP_TYPE_PFC_PRIORITY_TO_PRIORITY_GROUP);
+    uint8_t               default_tc   = qos_map_port_db[port_id].default_tc;
+    uint32_t              key;
+
+    memset(table, 0, sizeof(*table));
+
+    /* IP packets are classified by DSCP once a DSCP map is bound, by dot1p or the default otherwise */
+    table->trust_dscp = (NULL != dscp_tc) || (NULL != dscp_color);
+
+    for (key = 0; key < QOS_MAP_DSCP_NUMBER; key++) {
+        qos_map_class_fill(&table->classes[key],
+                           qos_map_lookup(dscp_tc, key, default_tc),
+                           qos_map_lookup(dscp_color, key, SAI_PACKET_COLOR_GREEN),
+                           tc_queue, tc_pg);
+    }
+    for (key = 0; key < QOS_MAP_PRIO_NUMBER; key++) {
+        qos_map_class_fill(&table->classes[QOS_MAP_CLASS_DOT1P + key],
+                           qos_map_lookup(dot1p_tc, key, default_tc),
+                           qos_map_lookup(dot1p_color, key, SAI_PACKET_COLOR_GREEN),
+                           tc_queue, tc_pg);
+    }
+    qos_map_class_fill(&table->classes[QOS_MAP_CLASS_UNTAGGED], default_tc, SAI_PACKET_COLOR_GREEN, tc_queue, tc_pg);
+
+    for (key = 0; key < QOS_MAP_TABLE_SIZE; key++) {
+        table->remark_dscp[key]  = QOS_MAP_KEEP;
+        table->remark_dot1p[key] = QOS_MAP_KEEP;
+        if ((NULL != remark_dscp) && (remark_dscp->mapped & (1ULL << key))) {
+            table->remark_dscp[key] = remark_dscp->table[key];
+        }
+        if ((NULL != remark_dot1p) && (remark_dot1p->mapped & (1ULL << key))) {
+            table->remark_dot1p[key] = remark_dot1p->table[key];
+        }
+    }
+
+    for (key = 0; key < QOS_MAP_PRIO_NUMBER; key++) {
+        table->pfc_queue[key] = qos_map_lookup(pfc_queue, key, key);
+        table->pfc_pg[key]    = qos_map_lookup(pfc_pg, key, key);
+    }
+}
+
+static void qos_map_port_table_swap(_In_ uint32_t port_id, _In_ stub_qos_port_table_t *table)
+{
+    stub_qos_port_table_t *old;
+
+    old = __atomic_exchange_n(&qos_map_port_tables[port_id], table, __ATOMIC_SEQ_CST);
+    if (NULL != old) {
+        stub_epoch_retire(&qos_map_epoch, old, &old->retired);
+    }
+
+    stub_epoch_reclaim(&qos_map_epoch);
+}
+
+static sai_status_t qos_map_port_publish(_In_ uint32_t port_id)
+{
+    stub_qos_port_table_t *table;
+
+    if (NULL == (table = malloc(sizeof(*table)))) {
+        STUB_LOG_ERR("Failed to allocate QoS table of port %u\n", port_id);
+        return SAI_STATUS_NO_MEMORY;
+    }
+
+    qos_map_port_table_build(port_id, table);
+    qos_map_port_table_swap(port_id, table);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Port table to read, the caller must end the read with qos_map_read_end */
+static const stub_qos_port_table_t* qos_map_read_begin(_In_ uint32_t core, _In_ uint32_t port_id)
+{
+    const stub_qos_port_table_t *table;
+
+    stub_epoch_read_begin(&qos_map_epoch, core);
+    table = __atomic_load_n(&qos_map_port_tables[port_id], __ATOMIC_SEQ_CST);
+
+    return (NULL != table) ? table : &qos_map_default_table;
+}
+
+static void qos_map_read_end(_In_ uint32_t core)
+{
+    stub_epoch_read_end(&qos_map_epoch, core);
+}
+
+static sai_status_t qos_map_reader_check(_In_ uint32_t core, _In_ uint32_t port_id)
+{
+    if (core >= STUB_CORES) {
+        STUB_LOG_ERR("Invalid core %u\n", core);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (port_id >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid port %u\n", port_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Classify a burst of packets received on a port. Header fields are masked to their width */
+sai_status_t db_qos_map_classify(_In_ uint32_t                 core,
+                                 _In_ uint32_t                 port_id,
+                                 _In_ uint32_t                 count,
+                                 _In_ const stub_qos_header_t *headers,
+                                 _Out_ stub_qos_class_t       *classes)
+{
+    const stub_qos_port_table_t *table;
+    sai_status_t                 status;
+    uint32_t                     ii, key;
+
+    if (SAI_STATUS_SUCCESS != (status = qos_map_reader_check(core, port_id))) {
+        return status;
+    }
+
+    table = qos_map_read_begin(core, port_id);
+
+    for (ii = 0; ii < count; ii++) {
+        if (headers[ii].is_ip && table->trust_dscp) {
+            key = headers[ii].dscp & (QOS_MAP_DSCP_NUMBER - 1);
+        } else if (headers[ii].tagged) {
+            key = QOS_MAP_CLASS_DOT1P + (headers[ii].dot1p & (QOS_MAP_PRIO_NUMBER - 1));
+        } else {
+            key = QOS_MAP_CLASS_UNTAGGED;
+        }
+        classes[ii] = table->classes[key];
+    }
+
+    qos_map_read_end(core);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Rewrite DSCP of IP packets and dot1p of tagged packets sent on a port by their class */
+sai_status_t db_qos_map_remark(_In_ uint32_t                core,
+                               _In_ uint32_t                port_id,
+                               _In_ uint32_t                count,
+                               _In_ const stub_qos_class_t *classes,
+                               _Inout_ stub_qos_header_t   *headers)
+{
+    const stub_qos_port_table_t *table;
+    sai_status_t                 status;
+    uint32_t                     ii, key;
+
+    if (SAI_STATUS_SUCCESS != (status = qos_map_reader_check(core, port_id))) {
+        return status;
+    }
+
+    table = qos_map_read_begin(core, port_id);
+
+    for (ii = 0; ii < count; ii++) {
+        key = (((uint32_t)classes[ii].tc << QOS_MAP_COLOR_BITS) | classes[ii].color) & (QOS_MAP_TABLE_SIZE - 1);
+        if (headers[ii].is_ip && (QOS_MAP_KEEP != table->remark_dscp[key])) {
+            headers[ii].dscp = table->remark_dscp[key];
+        }
+        if (headers[ii].tagged && (QOS_MAP_KEEP != table->remark_dot1p[key])) {
+            headers[ii].dot1p = table->remark_dot1p[key];
+        }
+    }
+
+    qos_map_read_end(core);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Queue and priority group paused by a PFC frame priority received on a port */
+sai_status_t db_qos_map_pfc_priority_get(_In_ uint32_t  core,
+                                         _In_ uint32_t  port_id,
+                                         _In_ uint8_t   priority,
+                                         _Out_ uint8_t *queue_index,
+                                         _Out_ uint8_t *priority_group)
+{
+    const stub_qos_port_table_t *table;
+    sai_status_t                 status;
+
+    if (SAI_STATUS_SUCCESS != (status = qos_map_reader_check(core, port_id))) {
+        return status;
+    }
+
+    if (priority >= QOS_MAP_PRIO_NUMBER) {
+        STUB_LOG_ERR("Invalid PFC priority %u\n", priority);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    table           = qos_map_read_begin(core, port_id);
+    *queue_index    = table->pfc_queue[priority];
+    *priority_group = table->pfc_pg[priority];
+    qos_map_read_end(core);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t db_qos_map_port_bind(_In_ uint32_t port_id, _In_ sai_qos_map_type_t type, _In_ sai_object_id_t map)
+{
+    stub_qos_map_t *new_map = NULL, *old_map = NULL;
+    sai_object_id_t old;
+    sai_status_t    status;
+    uint32_t        map_id;
+
+    if ((port_id >= PORT_NUMBER) || ((uint32_t)type >= QOS_MAP_TYPES)) {
+        STUB_LOG_ERR("Invalid port %u QoS map type %d\n", port_id, type);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_NULL_OBJECT_ID != map) {
+        if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(map, SAI_OBJECT_TYPE_QOS_MAP, &map_id))) {
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        if (SAI_STATUS_SUCCESS != (status = db_get_qos_map(map_id, &new_map))) {
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        if (new_map->type != type) {
+            STUB_LOG_ERR("QoS map type %d does not match port attribute type %d\n", new_map->type, type);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+    }
+
+    old = qos_map_port_db[port_id].maps[type];
+    if (old == map) {
+        return SAI_STATUS_SUCCESS;
+    }
+    if (SAI_NULL_OBJECT_ID != old) {
+        old_map = (stub_qos_map_t*)qos_map_port_map(port_id, type);
+    }
+
+    qos_map_port_db[port_id].maps[type] = map;
+    if (SAI_STATUS_SUCCESS != (status = qos_map_port_publish(port_id))) {
+        qos_map_port_db[port_id].maps[type] = old;
+        return status;
+    }
+
+    if (NULL != new_map) {
+        new_map->ref_count++;
+    }
+    if (NULL != old_map) {
+        old_map->ref_count--;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t db_qos_map_port_bound_get(_In_ uint32_t           port_id,
+                                       _In_ sai_qos_map_type_t type,
+                                       _Out_ sai_object_id_t  *map)
+{
+    if ((port_id >= PORT_NUMBER) || ((uint32_t)type >= QOS_MAP_TYPES)) {
+        STUB_LOG_ERR("Invalid port %u QoS map type %d\n", port_id, type);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *map = qos_map_port_db[port_id].maps[type];
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t db_qos_map_port_default_tc_set(_In_ uint32_t port_id, _In_ uint8_t tc)
+{
+    sai_status_t status;
+    uint8_t      old;
+
+    if (port_id >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid port %u\n", port_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (tc >= QOS_MAP_TC_NUMBER) {
+        STUB_LOG_ERR("Invalid default traffic class %u\n", tc);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0;
+    }
+
+    old                                 = qos_map_port_db[port_id].default_tc;
+    qos_map_port_db[port_id].default_tc = tc;
+    if (SAI_STATUS_SUCCESS != (status = qos_map_port_publish(port_id))) {
+        qos_map_port_db[port_id].default_tc = old;
+        return status;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t db_qos_map_port_default_tc_get(_In_ uint32_t port_id, _Out_ uint8_t *tc)
+{
+    if (port_id >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid port %u\n", port_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *tc = qos_map_port_db[port_id].default_tc;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*************************/
+
+static void qos_map_key_to_str(_In_ sai_object_id_t qos_map_id, _Out_ char *key_str)
+{
+    uint32_t mapid;
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(qos_map_id, SAI_OBJECT_TYPE_QOS_MAP, &mapid)) {
+        snprintf(key_str, MAX_KEY_STR_LEN, "invalid QoS map id");
+    } else {
+        snprintf(key_str, MAX_KEY_STR_LEN, "QoS map id %u", mapid);
+    }
+}
+
+/*
+ * Routine Description:
+ *    Create Qos Map
+ *
+ * Arguments:
+ *    [out] qos_map_id - Qos Map Id
+ *    [in] switch_id - switch id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_qos_map(_Out_ sai_object_id_t      *qos_map_id,
+                                 _In_ sai_object_id_t        switch_id,
+                                 _In_ uint32_t               attr_count,
+                                 _In_ const sai_attribute_t *attr_list)
+{
+    stub_qos_map_t              *map;
+    sai_status_t                 status;
+    const sai_attribute_value_t *type, *list;
+    uint32_t                     type_index, list_index, db_id;
+    char                         list_str[MAX_LIST_VALUE_STR_LEN];
+    char                         key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == qos_map_id) {
+        STUB_LOG_ERR("NULL QoS map id param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = check_attribs_metadata(attr_count, attr_list, qos_map_attribs, qos_map_vendor_attribs,
+                                         SAI_OPERATION_CREATE))) {
+        STUB_LOG_ERR("Failed attribs check\n");
+        return status;
+    }
+
+    sai_attr_list_to_str(attr_count, attr_list, qos_map_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create QoS map, %s\n", list_str);
+
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_QOS_MAP_ATTR_TYPE, &type, &type_index));
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_QOS_MAP_ATTR_MAP_TO_VALUE_LIST, &list, &list_index));
+
+    if ((type->s32 < SAI_QOS_MAP_TYPE_DOT1P_TO_TC) || (type->s32 >= QOS_MAP_TYPES)) {
+        STUB_LOG_ERR("Invalid QoS map type %d\n", type->s32);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + type_index;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_find_free_qos_map_index(&db_id))) {
+        return status;
+    }
+
+    map = &qos_map_db[db_id];
+    memset(map, 0, sizeof(*map));
+    map->type = type->s32;
+
+    if (SAI_STATUS_SUCCESS != (status = qos_map_compile(map, &list->qosmap, list_index))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = stub_create_object(SAI_OBJECT_TYPE_QOS_MAP, db_id, qos_map_id))) {
+        return status;
+    }
+    map->is_valid = true;
+
+    qos_map_key_to_str(*qos_map_id, key_str);
+    STUB_LOG_NTC("Created QoS map %s\n", key_str);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Remove Qos Map
+ *
+ * Arguments:
+ *    [in] qos_map_id - Qos Map id to be removed.
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_qos_map(_In_ sai_object_id_t qos_map_id)
+{
+    stub_qos_map_t *map;
+    char            key_str[MAX_KEY_STR_LEN];
+    sai_status_t    status;
+    uint32_t        db_id;
+
+    STUB_LOG_ENTER();
+
+    qos_map_key_to_str(qos_map_id, key_str);
+    STUB_LOG_NTC("Remove QoS map %s\n", key_str);
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(qos_map_id, SAI_OBJECT_TYPE_QOS_MAP, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_qos_map(db_id, &map))) {
+        return status;
+    }
+
+    if (map->ref_count > 0) {
+        STUB_LOG_ERR("QoS map %u is bound to %u ports\n", db_id, map->ref_count);
+        return SAI_STATUS_OBJECT_IN_USE;
+    }
+
+    map->is_valid = false;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Set attributes for qos map
+ *
+ * Arguments:
+ *    [in] qos_map_id - Qos Map Id
+ *    [in] attr - attribute to set
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_qos_map_attribute(_In_ sai_object_id_t qos_map_id, _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = qos_map_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    qos_map_key_to_str(qos_map_id, key_str);
+    return sai_set_attribute(&key, key_str, qos_map_attribs, qos_map_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get attrbutes of qos map
+ *
+ * Arguments:
+ *    [in] qos_map_id - map id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_qos_map_attribute(_In_ sai_object_id_t     qos_map_id,
+                                        _In_ uint32_t            attr_count,
+                                        _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = qos_map_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    qos_map_key_to_str(qos_map_id, key_str);
+    return sai_get_attributes(&key, key_str, qos_map_attribs, qos_map_vendor_attribs, attr_count, attr_list);
+}
+
+/* QoS map type [sai_qos_map_type_t] */
+sai_status_t stub_qos_map_type_get(_In_ const sai_object_key_t   *key,
+                                   _Inout_ sai_attribute_value_t *value,
+                                   _In_ uint32_t                  attr_index,
+                                   _Inout_ vendor_cache_t        *cache,
+                                   void                          *arg)
+{
+    stub_qos_map_t *map;
+    sai_status_t    status;
+    uint32_t        db_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_QOS_MAP, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_qos_map(db_id, &map))) {
+        return status;
+    }
+
+    value->s32 = map->type;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* QoS map entries [sai_qos_map_list_t] */
+sai_status_t stub_qos_map_list_get(_In_ const sai_object_key_t   *key,
+                                   _Inout_ sai_attribute_value_t *value,
+                                   _In_ uint32_t                  attr_index,
+                                   _Inout_ vendor_cache_t        *cache,
+                                   void                          *arg)
+{
+    stub_qos_map_t *map;
+    sai_status_t    status;
+    uint32_t        db_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_QOS_MAP, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_qos_map(db_id, &map))) {
+        return status;
+    }
+
+    status = stub_fill_qosmaplist(map->list, map->count, &value->qosmap);
+
+    STUB_LOG_EXIT();
+    return status;
+}
+
+/* QoS map entries [sai_qos_map_list_t]
+ * The ports using the map switch to the new entries without stopping lookups */
+sai_status_t stub_qos_map_list_set(_In_ const sai_object_key_t      *key,
+                                   _In_ const sai_attribute_value_t *value,
+                                   void                             *arg)
+{
+    stub_qos_map_t         *map, params;
+    stub_qos_port_table_t  *tables[PORT_NUMBER];
+    sai_status_t            status;
+    uint32_t                db_id, port_id, count = 0, ii;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_QOS_MAP, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_qos_map(db_id, &map))) {
+        return status;
+    }
+
+    memcpy(&params, map, sizeof(params));
+    if (SAI_STATUS_SUCCESS != (status = qos_map_compile(&params, &value->qosmap, 0))) {
+        return status;
+    }
+
+    /* Allocate every new port table first, so the update applies to all ports or none */
+    for (port_id = 0; port_id < PORT_NUMBER; port_id++) {
+        if (qos_map_port_db[port_id].maps[map->type] != key->object_id) {
+            continue;
+        }
+        if (NULL == (tables[count] = malloc(sizeof(*tables[count])))) {
+            STUB_LOG_ERR("Failed to allocate QoS table of port %u\n", port_id);
+            for (ii = 0; ii < count; ii++) {
+                free(tables[ii]);
+            }
+            return SAI_STATUS_NO_MEMORY;
+        }
+        count++;
+    }
+
+    memcpy(map, &params, sizeof(*map));
+
+    for (port_id = 0, ii = 0; port_id < PORT_NUMBER; port_id++) {
+        if (qos_map_port_db[port_id].maps[map->type] != key->object_id) {
+            continue;
+        }
+        qos_map_port_table_build(port_id, tables[ii]);
+        qos_map_port_table_swap(port_id, tables[ii]);
+        ii++;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+const sai_qos_map_api_t qos_map_api = {
+    stub_create_qos_map,
+    stub_remove_qos_map,
+    stub_set_qos_map_attribute,
+    stub_get_qos_map_attribute
+};
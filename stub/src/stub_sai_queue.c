@@ -0,0 +1,1349 @@
+/*
+ *  Copyright (C) 2014. Mellanox Technologies, Ltd. ALL RIGHTS RESERVED.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ */
+
+#include "sai.h"
+#include "stub_sai.h"
+#include "assert.h"
+#include "pthread.h"
+
+#undef  __MODULE__
+#define __MODULE__ SAI_QUEUE
+
+static const sai_attribute_entry_t queue_attribs[] = {
+    { SAI_QUEUE_ATTR_TYPE, true, true, false, true,
+      "Queue type", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_QUEUE_ATTR_PORT, true, true, false, true,
+      "Queue port", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_QUEUE_ATTR_INDEX, true, true, false, true,
+      "Queue index", SAI_ATTR_VAL_TYPE_U8 },
+    { SAI_QUEUE_ATTR_PARENT_SCHEDULER_NODE, true, true, true, true,
+      "Queue parent scheduler node", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_QUEUE_ATTR_WRED_PROFILE_ID, false, true, true, true,
+      "Queue WRED profile", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_QUEUE_ATTR_BUFFER_PROFILE_ID, false, true, true, true,
+      "Queue buffer profile", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_QUEUE_ATTR_SCHEDULER_PROFILE_ID, false, true, true, true,
+      "Queue scheduler profile", SAI_ATTR_VAL_TYPE_OID },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+sai_status_t stub_queue_attr_get(_In_ const sai_object_key_t   *key,
+                                 _Inout_ sai_attribute_value_t *value,
+                                 _In_ uint32_t                  attr_index,
+                                 _Inout_ vendor_cache_t        *cache,
+                                 void                          *arg);
+sai_status_t stub_queue_attr_set(_In_ const sai_object_key_t      *key,
+                                 _In_ const sai_attribute_value_t *value,
+                                 void                             *arg);
+
+static const sai_vendor_attribute_entry_t queue_vendor_attribs[] = {
+    { SAI_QUEUE_ATTR_TYPE,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_queue_attr_get, (void*)SAI_QUEUE_ATTR_TYPE,
+      NULL, NULL },
+    { SAI_QUEUE_ATTR_PORT,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_queue_attr_get, (void*)SAI_QUEUE_ATTR_PORT,
+      NULL, NULL },
+    { SAI_QUEUE_ATTR_INDEX,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_queue_attr_get, (void*)SAI_QUEUE_ATTR_INDEX,
+      NULL, NULL },
+    { SAI_QUEUE_ATTR_PARENT_SCHEDULER_NODE,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_queue_attr_get, (void*)SAI_QUEUE_ATTR_PARENT_SCHEDULER_NODE,
+      stub_queue_attr_set, (void*)SAI_QUEUE_ATTR_PARENT_SCHEDULER_NODE },
+    { SAI_QUEUE_ATTR_WRED_PROFILE_ID,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_queue_attr_get, (void*)SAI_QUEUE_ATTR_WRED_PROFILE_ID,
+      stub_queue_attr_set, (void*)SAI_QUEUE_ATTR_WRED_PROFILE_ID },
+    { SAI_QUEUE_ATTR_BUFFER_PROFILE_ID,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_queue_attr_get, (void*)SAI_QUEUE_ATTR_BUFFER_PROFILE_ID,
+      stub_queue_attr_set, (void*)SAI_QUEUE_ATTR_BUFFER_PROFILE_ID },
+    { SAI_QUEUE_ATTR_SCHEDULER_PROFILE_ID,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_queue_attr_get, (void*)SAI_QUEUE_ATTR_SCHEDULER_PROFILE_ID,
+      stub_queue_attr_set, (void*)SAI_QUEUE_ATTR_SCHEDULER_PROFILE_ID },
+};
+
+/* State DB *************/
+#define QUEUE_NONE               0xFFFFFFFF
+#define QUEUE_PACKET_POOL_SIZE   65536
+#define QUEUE_DEFAULT_MAX_BYTES  (1024 * 1024)
+#define QUEUE_AVERAGE_SHIFT      8
+#define QUEUE_SLOT_UNICAST       0
+#define QUEUE_SLOT_MULTICAST     1
+#define QUEUE_SLOTS              2
+
+/* Per color counters are laid out with a fixed stride from the green ones */
+#define QUEUE_STAT_COLOR(stat, color)         ((stat) + 4 * (color))
+#define QUEUE_STAT_DISCARD_COLOR(stat, color) ((stat) + 2 * (color))
+
+/*
+ * Queued packets are descriptors taken from a pool shared by all queues and
+ * chained in FIFO order, so the queue depth is only bounded by the byte limit.
+ */
+typedef struct _stub_queue_packet_t {
+    stub_packet_t packet;
+    uint32_t      next;
+} stub_queue_packet_t;
+
+typedef struct _stub_queue_t {
+    sai_queue_type_t           type;
+    uint32_t                   port_id;
+    uint8_t                    index;
+    sai_object_id_t            port;
+    sai_object_id_t            parent;
+    sai_object_id_t            wred_profile;
+    sai_object_id_t            buffer_profile;
+    sai_object_id_t            scheduler_profile;
+    uint32_t                   wred_id;
+    uint32_t                   head;
+    uint32_t                   tail;
+    uint32_t                   packets;
+    uint64_t                   bytes;
+    uint64_t                   watermark;
+    stub_telemetry_watermark_t telemetry_watermark;
+    /* WRED exponentially weighted average occupancy, in 1/2^QUEUE_AVERAGE_SHIFT bytes */
+    uint64_t                   average;
+    uint64_t                   counters[QUEUE_STAT_COUNT];
+    /* Transmitted bytes and simulation time since the bandwidth counter was cleared */
+    uint64_t                   rate_bytes;
+    uint64_t                   rate_start_ns;
+    bool                       is_valid;
+} stub_queue_t;
+
+static stub_queue_t               queue_db[MAX_QUEUE_NUMBER];
+static uint32_t                   port_queue_db[PORT_NUMBER][QUEUE_SLOTS][QUEUE_MAX_INDEX];
+static pthread_once_t             port_queue_db_once = PTHREAD_ONCE_INIT;
+static stub_queue_packet_t        queue_packet_pool[QUEUE_PACKET_POOL_SIZE];
+static uint32_t                   queue_packet_free = QUEUE_NONE;
+static uint32_t                   queue_packet_unused;
+/* Bytes queued on all the queues of a port, and their peak for the telemetry subscriptions */
+static uint64_t                   port_queued_bytes_db[PORT_NUMBER];
+static stub_telemetry_watermark_t port_watermark_db[PORT_NUMBER];
+
+static void port_queue_db_init()
+{
+    uint32_t port, slot, index;
+
+    for (port = 0; port < PORT_NUMBER; port++) {
+        for (slot = 0; slot < QUEUE_SLOTS; slot++) {
+            for (index = 0; index < QUEUE_MAX_INDEX; index++) {
+                port_queue_db[port][slot][index] = QUEUE_NONE;
+            }
+        }
+    }
+}
+
+/* Build the port queue table, on switch init or on first use, whichever comes first */
+void db_init_port_queues()
+{
+    pthread_once(&port_queue_db_once, port_queue_db_init);
+}
+
+static sai_status_t db_get_queue(_In_ uint32_t queue_id, _Out_ stub_queue_t **queue)
+{
+    if ((queue_id >= MAX_QUEUE_NUMBER) || (!queue_db[queue_id].is_valid)) {
+        STUB_LOG_ERR("Invalid queue ID %u\n", queue_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *queue = &queue_db[queue_id];
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t db_find_free_queue_index(_Out_ uint32_t *free_index)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < MAX_QUEUE_NUMBER; ii++) {
+        if (false == queue_db[ii].is_valid) {
+            *free_index = ii;
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+
+    STUB_LOG_ERR("Queue table full\n");
+    return SAI_STATUS_TABLE_FULL;
+}
+
+static uint32_t queue_packet_alloc()
+{
+    uint32_t index;
+
+    if (QUEUE_NONE != queue_packet_free) {
+        index             = queue_packet_free;
+        queue_packet_free = queue_packet_pool[index].next;
+        return index;
+    }
+
+    if (queue_packet_unused < QUEUE_PACKET_POOL_SIZE) {
+        return queue_packet_unused++;
+    }
+
+    return QUEUE_NONE;
+}
+
+static void queue_packet_free_push(_In_ uint32_t index)
+{
+    queue_packet_pool[index].next = queue_packet_free;
+    queue_packet_free             = index;
+}
+
+static void queue_count_drop(_Inout_ stub_queue_t *queue, _In_ const stub_packet_t *packet, _In_ bool discard)
+{
+    db_buffer_ingress_release(packet);
+
+    queue->counters[SAI_QUEUE_STAT_DROPPED_PACKETS]++;
+    queue->counters[SAI_QUEUE_STAT_DROPPED_BYTES] += packet->length;
+    queue->counters[QUEUE_STAT_COLOR(SAI_QUEUE_STAT_GREEN_DROPPED_PACKETS, packet->color)]++;
+    queue->counters[QUEUE_STAT_COLOR(SAI_QUEUE_STAT_GREEN_DROPPED_BYTES, packet->color)] += packet->length;
+
+    if (discard) {
+        queue->counters[SAI_QUEUE_STAT_DISCARD_DROPPED_PACKETS]++;
+        queue->counters[SAI_QUEUE_STAT_DISCARD_DROPPED_BYTES] += packet->length;
+        queue->counters[QUEUE_STAT_DISCARD_COLOR(SAI_QUEUE_STAT_GREEN_DISCARD_DROPPED_PACKETS, packet->color)]++;
+        queue->counters[QUEUE_STAT_DISCARD_COLOR(SAI_QUEUE_STAT_GREEN_DISCARD_DROPPED_BYTES, packet->color)] +=
+            packet->length;
+    }
+}
+
+/* Find the unicast queue of a port by index, where traffic classified to the index is enqueued */
+sai_status_t db_queue_find(_In_ uint32_t port_id, _In_ uint8_t index, _Out_ uint32_t *queue_id)
+{
+    db_init_port_queues();
+
+    if ((port_id >= PORT_NUMBER) || (index >= QUEUE_MAX_INDEX)) {
+        STUB_LOG_ERR("Invalid port %u queue index %u\n", port_id, index);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (QUEUE_NONE == port_queue_db[port_id][QUEUE_SLOT_UNICAST][index]) {
+        return SAI_STATUS_ITEM_NOT_FOUND;
+    }
+
+    *queue_id = port_queue_db[port_id][QUEUE_SLOT_UNICAST][index];
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Get the queues of a port, unicast ones first, each in ascending index order */
+sai_status_t db_queue_port_queues_get(_In_ uint32_t port_id, _Out_ uint32_t *queue_ids, _Inout_ uint32_t *count)
+{
+    uint32_t slot, index, found = 0;
+
+    db_init_port_queues();
+
+    if (port_id >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid port %u\n", port_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    for (slot = 0; slot < QUEUE_SLOTS; slot++) {
+        for (index = 0; index < QUEUE_MAX_INDEX; index++) {
+            if (QUEUE_NONE == port_queue_db[port_id][slot][index]) {
+                continue;
+            }
+            if (found == *count) {
+                return SAI_STATUS_BUFFER_OVERFLOW;
+            }
+            queue_ids[found++] = port_queue_db[port_id][slot][index];
+        }
+    }
+
+    *count = found;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Admit a packet to a queue.
+ * The WRED profile of the queue, if any, is applied on the average
+ * occupancy, and may ECN mark the packet or drop it. Packets refused by the
+ * egress buffer of the queue profile, or beyond the default queue byte limit
+ * without profile, or when no descriptor is left, are tail dropped.
+ */
+sai_status_t db_queue_enqueue(_In_ uint32_t          queue_id,
+                              _Inout_ stub_packet_t *packet,
+                              _In_ uint32_t          random,
+                              _Out_ bool            *accepted)
+{
+    stub_queue_t       *queue;
+    stub_wred_verdict_t verdict = STUB_WRED_ACCEPT;
+    sai_status_t        status;
+    uint8_t             weight;
+    uint64_t            current;
+    uint32_t            index;
+    bool                admitted;
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_queue(queue_id, &queue))) {
+        return status;
+    }
+
+    *accepted = false;
+
+    if (QUEUE_NONE != queue->wred_id) {
+        if (SAI_STATUS_SUCCESS != (status = db_wred_weight_get(queue->wred_id, &weight))) {
+            return status;
+        }
+
+        current = queue->bytes << QUEUE_AVERAGE_SHIFT;
+        if (current >= queue->average) {
+            queue->average += (current - queue->average) >> weight;
+        } else {
+            queue->average -= (queue->average - current) >> weight;
+        }
+
+        if (SAI_STATUS_SUCCESS !=
+            (status = db_wred_check(queue->wred_id, packet->color, queue->average >> QUEUE_AVERAGE_SHIFT,
+                                    packet->ecn_capable, random, &verdict))) {
+            return status;
+        }
+    }
+
+    if (STUB_WRED_DROP == verdict) {
+        queue_count_drop(queue, packet, true);
+        return SAI_STATUS_SUCCESS;
+    }
+
+    if (SAI_NULL_OBJECT_ID != queue->buffer_profile) {
+        if (SAI_STATUS_SUCCESS != (status = db_buffer_egress_admit(queue_id, packet->length, &admitted))) {
+            return status;
+        }
+    } else {
+        admitted = (queue->bytes + packet->length <= QUEUE_DEFAULT_MAX_BYTES);
+    }
+
+    if (!admitted) {
+        queue_count_drop(queue, packet, false);
+        return SAI_STATUS_SUCCESS;
+    }
+
+    if (QUEUE_NONE == (index = queue_packet_alloc())) {
+        db_buffer_egress_release(queue_id, packet->length);
+        queue_count_drop(queue, packet, false);
+        return SAI_STATUS_SUCCESS;
+    }
+
+    if (STUB_WRED_MARK == verdict) {
+        packet->ecn_marked = true;
+        queue->counters[SAI_QUEUE_STAT_WRED_ECN_MARKED_PACKETS]++;
+        queue->counters[SAI_QUEUE_STAT_WRED_ECN_MARKED_BYTES] += packet->length;
+    }
+
+    queue_packet_pool[index].packet = *packet;
+    queue_packet_pool[index].next   = QUEUE_NONE;
+    if (QUEUE_NONE == queue->tail) {
+        queue->head = index;
+    } else {
+        queue_packet_pool[queue->tail].next = index;
+    }
+    queue->tail = index;
+    queue->packets++;
+    queue->bytes += packet->length;
+    if (queue->bytes > queue->watermark) {
+        queue->watermark = queue->bytes;
+    }
+    if (queue->bytes > queue->telemetry_watermark.peak) {
+        queue->telemetry_watermark.peak = queue->bytes;
+    }
+    port_queued_bytes_db[queue->port_id] += packet->length;
+    if (port_queued_bytes_db[queue->port_id] > port_watermark_db[queue->port_id].peak) {
+        port_watermark_db[queue->port_id].peak = port_queued_bytes_db[queue->port_id];
+    }
+
+    *accepted = true;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Take the head packet of a queue for transmission */
+sai_status_t db_queue_dequeue(_In_ uint32_t queue_id, _Out_ stub_packet_t *packet, _Out_ bool *dequeued)
+{
+    stub_queue_t *queue;
+    sai_status_t  status;
+    uint32_t      index;
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_queue(queue_id, &queue))) {
+        return status;
+    }
+
+    if (QUEUE_NONE == queue->head) {
+        *dequeued = false;
+        return SAI_STATUS_SUCCESS;
+    }
+
+    index       = queue->head;
+    *packet     = queue_packet_pool[index].packet;
+    queue->head = queue_packet_pool[index].next;
+    if (QUEUE_NONE == queue->head) {
+        queue->tail = QUEUE_NONE;
+    }
+    queue_packet_free_push(index);
+    queue->packets--;
+    queue->bytes -= packet->length;
+    port_queued_bytes_db[queue->port_id] -= packet->length;
+    db_buffer_egress_release(queue_id, packet->length);
+    db_buffer_ingress_release(packet);
+
+    queue->counters[SAI_QUEUE_STAT_PACKETS]++;
+    queue->counters[SAI_QUEUE_STAT_BYTES] += packet->length;
+    queue->rate_bytes += packet->length;
+    queue->counters[QUEUE_STAT_COLOR(SAI_QUEUE_STAT_GREEN_PACKETS, packet->color)]++;
+    queue->counters[QUEUE_STAT_COLOR(SAI_QUEUE_STAT_GREEN_BYTES, packet->color)] += packet->length;
+
+    *dequeued = true;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t db_queue_depth_get(_In_ uint32_t queue_id, _Out_ uint32_t *packets)
+{
+    stub_queue_t *queue;
+    sai_status_t  status;
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_queue(queue_id, &queue))) {
+        return status;
+    }
+
+    *packets = queue->packets;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Get the place of a queue in the scheduling hierarchy of its port */
+sai_status_t db_queue_info_get(_In_ uint32_t          queue_id,
+                               _Out_ uint8_t         *index,
+                               _Out_ sai_object_id_t *parent,
+                               _Out_ sai_object_id_t *scheduler_profile)
+{
+    stub_queue_t *queue;
+    sai_status_t  status;
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_queue(queue_id, &queue))) {
+        return status;
+    }
+
+    *index             = queue->index;
+    *parent            = queue->parent;
+    *scheduler_profile = queue->scheduler_profile;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Average transmit rate in bits per second, over the simulation time since the counter was cleared */
+static uint64_t queue_bandwidth_get(_In_ const stub_queue_t *queue)
+{
+    uint64_t now = db_sim_now();
+
+    if (now <= queue->rate_start_ns) {
+        return 0;
+    }
+
+    return (uint64_t)((double)queue->rate_bytes * 8 * 1000000000ULL / (now - queue->rate_start_ns));
+}
+
+/* Check the counter ids before reading any, so a read fills all the counters or none */
+static sai_status_t queue_stats_check(_In_ const sai_queue_stat_t *counter_ids, _In_ uint32_t number_of_counters)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < number_of_counters; ii++) {
+        if (((uint32_t)counter_ids[ii] >= QUEUE_STAT_COUNT) && (STUB_QUEUE_STAT_TX_BANDWIDTH != (int32_t)counter_ids[ii])) {
+            STUB_LOG_ERR("Invalid queue counter %d\n", counter_ids[ii]);
+            return SAI_STATUS_INVALID_PARAMETER;
+        }
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Read counters of a queue, the counter ids are checked by queue_stats_check */
+static void queue_stats_read(_In_ const stub_queue_t     *queue,
+                             _In_ const sai_queue_stat_t *counter_ids,
+                             _In_ uint32_t                number_of_counters,
+                             _Out_ uint64_t              *counters)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < number_of_counters; ii++) {
+        switch (counter_ids[ii]) {
+        /* The whole queue occupancy is shared until buffers are reserved */
+        case SAI_QUEUE_STAT_CURR_OCCUPANCY_BYTES:
+        case SAI_QUEUE_STAT_SHARED_CURR_OCCUPANCY_BYTES:
+            counters[ii] = queue->bytes;
+            break;
+
+        case SAI_QUEUE_STAT_WATERMARK_BYTES:
+        case SAI_QUEUE_STAT_SHARED_WATERMARK_BYTES:
+            counters[ii] = queue->watermark;
+            break;
+
+        case STUB_QUEUE_STAT_TX_BANDWIDTH:
+            counters[ii] = queue_bandwidth_get(queue);
+            break;
+
+        default:
+            counters[ii] = queue->counters[counter_ids[ii]];
+            break;
+        }
+    }
+}
+
+/* Load counters of queues from the counter cache, all from one snapshot. False when they aren't cached */
+static bool queue_stats_cache_read(_In_ uint32_t                number_of_queues,
+                                   _In_ const sai_object_id_t  *queue_ids,
+                                   _In_ const sai_queue_stat_t *counter_ids,
+                                   _In_ uint32_t                number_of_counters,
+                                   _Out_ uint64_t              *counters)
+{
+    const uint64_t *rows;
+    uint64_t        seq, *row;
+    uint32_t        ii, jj, queue_id, slot;
+
+    do {
+        if (NULL == (rows = db_counter_read_begin(COUNTER_TYPE_QUEUE, &seq))) {
+            return false;
+        }
+
+        for (ii = 0, row = counters; ii < number_of_queues; ii++, row += number_of_counters) {
+            stub_object_to_type(queue_ids[ii], SAI_OBJECT_TYPE_QUEUE, &queue_id);
+            for (jj = 0; jj < number_of_counters; jj++) {
+                slot    = (STUB_QUEUE_STAT_TX_BANDWIDTH == (int32_t)counter_ids[jj]) ? QUEUE_STAT_COUNT : counter_ids[jj];
+                row[jj] = __atomic_load_n(&rows[queue_id * QUEUE_STAT_ROW + slot], __ATOMIC_RELAXED);
+            }
+        }
+    } while (db_counter_read_retry(seq));
+
+    return true;
+}
+
+void db_queue_stats_all_get(_Out_ uint64_t *counters)
+{
+    sai_queue_stat_t ids[QUEUE_STAT_ROW];
+    uint32_t         ii;
+
+    for (ii = 0; ii < QUEUE_STAT_COUNT; ii++) {
+        ids[ii] = (sai_queue_stat_t)ii;
+    }
+    ids[QUEUE_STAT_COUNT] = (sai_queue_stat_t)STUB_QUEUE_STAT_TX_BANDWIDTH;
+
+    for (ii = 0; ii < MAX_QUEUE_NUMBER; ii++, counters += QUEUE_STAT_ROW) {
+        if (queue_db[ii].is_valid) {
+            queue_stats_read(&queue_db[ii], ids, QUEUE_STAT_ROW, counters);
+        } else {
+            memset(counters, 0, QUEUE_STAT_ROW * sizeof(*counters));
+        }
+    }
+}
+
+/*
+ * Read counters of a queue for telemetry, the watermarks being the peaks since
+ * the last record of the subscription. Called with the simulator lock held
+ */
+sai_status_t db_queue_stats_sample(_In_ sai_object_id_t queue_id,
+                                   _In_ uint32_t        subscription,
+                                   _In_ const int32_t  *counter_ids,
+                                   _In_ uint32_t        number_of_counters,
+                                   _Out_ uint64_t      *counters)
+{
+    stub_queue_t *queue;
+    sai_status_t  status;
+    uint32_t      db_id, ii;
+    uint64_t      watermark      = 0;
+    bool          watermark_read = false;
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(queue_id, SAI_OBJECT_TYPE_QUEUE, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_queue(db_id, &queue))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = queue_stats_check((const sai_queue_stat_t*)counter_ids, number_of_counters))) {
+        return status;
+    }
+
+    queue_stats_read(queue, (const sai_queue_stat_t*)counter_ids, number_of_counters, counters);
+
+    for (ii = 0; ii < number_of_counters; ii++) {
+        if ((SAI_QUEUE_STAT_WATERMARK_BYTES == counter_ids[ii]) ||
+            (SAI_QUEUE_STAT_SHARED_WATERMARK_BYTES == counter_ids[ii])) {
+            if (!watermark_read) {
+                watermark      = db_telemetry_watermark_sample(&queue->telemetry_watermark, queue->bytes,
+                                                               subscription);
+                watermark_read = true;
+            }
+            counters[ii] = watermark;
+        }
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Restart the watermarks of a queue for a subscription, once its record is sent */
+sai_status_t db_queue_watermarks_restart(_In_ sai_object_id_t queue_id, _In_ uint32_t subscription)
+{
+    stub_queue_t *queue;
+    sai_status_t  status;
+    uint32_t      db_id;
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(queue_id, SAI_OBJECT_TYPE_QUEUE, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_queue(db_id, &queue))) {
+        return status;
+    }
+
+    db_telemetry_watermark_restart(&queue->telemetry_watermark, subscription);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Peak bytes queued on a port since the last record of the subscription */
+uint64_t db_queue_port_watermark_sample(_In_ uint32_t port_id, _In_ uint32_t subscription)
+{
+    return db_telemetry_watermark_sample(&port_watermark_db[port_id], port_queued_bytes_db[port_id], subscription);
+}
+
+void db_queue_port_watermark_restart(_In_ uint32_t port_id, _In_ uint32_t subscription)
+{
+    db_telemetry_watermark_restart(&port_watermark_db[port_id], subscription);
+}
+
+/*************************/
+
+static void queue_key_to_str(_In_ sai_object_id_t queue_id, _Out_ char *key_str)
+{
+    uint32_t queueid;
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(queue_id, SAI_OBJECT_TYPE_QUEUE, &queueid)) {
+        snprintf(key_str, MAX_KEY_STR_LEN, "invalid queue id");
+    } else {
+        snprintf(key_str, MAX_KEY_STR_LEN, "queue id %u", queueid);
+    }
+}
+
+/* Attach a queue to its port or to a scheduler group of its port, moving the group child reference */
+static sai_status_t queue_parent_attach(_Inout_ stub_queue_t *queue, _In_ sai_object_id_t parent)
+{
+    sai_object_type_t type = sai_object_type_query(parent);
+    sai_status_t      status;
+
+    if (SAI_OBJECT_TYPE_PORT == type) {
+        if (parent != queue->port) {
+            STUB_LOG_ERR("Queue parent port must be the queue port\n");
+            return SAI_STATUS_INVALID_PARAMETER;
+        }
+    } else if (SAI_OBJECT_TYPE_SCHEDULER_GROUP == type) {
+        if (SAI_STATUS_SUCCESS != (status = db_scheduler_group_attach(parent, queue->port_id, true))) {
+            return status;
+        }
+    } else if (SAI_NULL_OBJECT_ID != parent) {
+        STUB_LOG_ERR("Invalid queue parent scheduler node type %d\n", type);
+        return SAI_STATUS_INVALID_OBJECT_TYPE;
+    }
+
+    if (SAI_OBJECT_TYPE_SCHEDULER_GROUP == sai_object_type_query(queue->parent)) {
+        db_scheduler_group_attach(queue->parent, queue->port_id, false);
+    }
+
+    queue->parent = parent;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Attach a scheduler profile to a queue, moving the profile reference */
+static sai_status_t queue_scheduler_attach(_Inout_ stub_queue_t *queue, _In_ sai_object_id_t scheduler_profile)
+{
+    sai_status_t status;
+    uint32_t     scheduler_id, old_id;
+
+    if (SAI_NULL_OBJECT_ID != scheduler_profile) {
+        if (SAI_STATUS_SUCCESS !=
+            (status = stub_object_to_type(scheduler_profile, SAI_OBJECT_TYPE_SCHEDULER, &scheduler_id))) {
+            return status;
+        }
+        if (SAI_STATUS_SUCCESS != (status = db_scheduler_ref(scheduler_id, true))) {
+            return status;
+        }
+    }
+
+    if ((SAI_NULL_OBJECT_ID != queue->scheduler_profile) &&
+        (SAI_STATUS_SUCCESS == stub_object_to_type(queue->scheduler_profile, SAI_OBJECT_TYPE_SCHEDULER, &old_id))) {
+        db_scheduler_ref(old_id, false);
+    }
+
+    queue->scheduler_profile = scheduler_profile;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Attach a WRED profile to a queue, moving the profile reference */
+static sai_status_t queue_wred_attach(_Inout_ stub_queue_t *queue, _In_ sai_object_id_t wred_profile)
+{
+    sai_status_t status;
+    uint32_t     wred_id = QUEUE_NONE;
+
+    if (SAI_NULL_OBJECT_ID != wred_profile) {
+        if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(wred_profile, SAI_OBJECT_TYPE_WRED, &wred_id))) {
+            return status;
+        }
+        if (SAI_STATUS_SUCCESS != (status = db_wred_ref(wred_id, true))) {
+            return status;
+        }
+    }
+
+    if (QUEUE_NONE != queue->wred_id) {
+        db_wred_ref(queue->wred_id, false);
+    }
+
+    queue->wred_id      = wred_id;
+    queue->wred_profile = wred_profile;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Create queue
+ *
+ * Arguments:
+ *    [out] queue_id - queue id
+ *    [in] switch_id - switch id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_queue(_Out_ sai_object_id_t      *queue_id,
+                               _In_ sai_object_id_t        switch_id,
+                               _In_ uint32_t               attr_count,
+                               _In_ const sai_attribute_t *attr_list)
+{
+    sai_status_t                 status;
+    const sai_attribute_value_t *type, *port, *index, *parent, *wred, *buffer, *scheduler = NULL;
+    uint32_t                     type_index, port_index, index_index, parent_index, wred_index, buffer_index;
+    uint32_t                     scheduler_index, port_id, slot, db_id = 0;
+    stub_queue_t                *queue;
+    char                         list_str[MAX_LIST_VALUE_STR_LEN];
+    char                         key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == queue_id) {
+        STUB_LOG_ERR("NULL queue id param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = check_attribs_metadata(attr_count, attr_list, queue_attribs, queue_vendor_attribs,
+                                         SAI_OPERATION_CREATE))) {
+        STUB_LOG_ERR("Failed attribs check\n");
+        return status;
+    }
+
+    sai_attr_list_to_str(attr_count, attr_list, queue_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create queue, %s\n", list_str);
+
+    db_init_port_queues();
+
+    status = find_attrib_in_list(attr_count, attr_list, SAI_QUEUE_ATTR_TYPE, &type, &type_index);
+    assert(SAI_STATUS_SUCCESS == status);
+    status = find_attrib_in_list(attr_count, attr_list, SAI_QUEUE_ATTR_PORT, &port, &port_index);
+    assert(SAI_STATUS_SUCCESS == status);
+    status = find_attrib_in_list(attr_count, attr_list, SAI_QUEUE_ATTR_INDEX, &index, &index_index);
+    assert(SAI_STATUS_SUCCESS == status);
+    status = find_attrib_in_list(attr_count, attr_list, SAI_QUEUE_ATTR_PARENT_SCHEDULER_NODE, &parent,
+                                 &parent_index);
+    assert(SAI_STATUS_SUCCESS == status);
+
+    if ((type->s32 < SAI_QUEUE_TYPE_ALL) || (type->s32 > SAI_QUEUE_TYPE_MULTICAST)) {
+        STUB_LOG_ERR("Invalid queue type %d\n", type->s32);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + type_index;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(port->oid, SAI_OBJECT_TYPE_PORT, &port_id))) {
+        return status;
+    }
+
+    if (port_id >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid queue port %u\n", port_id);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + port_index;
+    }
+
+    if (index->u8 >= QUEUE_MAX_INDEX) {
+        STUB_LOG_ERR("Invalid queue index %u\n", index->u8);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + index_index;
+    }
+
+    if (SAI_NULL_OBJECT_ID == parent->oid) {
+        STUB_LOG_ERR("NULL queue parent scheduler node\n");
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + parent_index;
+    }
+
+    /* A queue for all traffic takes both the unicast and multicast places of its index */
+    slot = (SAI_QUEUE_TYPE_MULTICAST == type->s32) ? QUEUE_SLOT_MULTICAST : QUEUE_SLOT_UNICAST;
+    if ((QUEUE_NONE != port_queue_db[port_id][slot][index->u8]) ||
+        ((SAI_QUEUE_TYPE_ALL == type->s32) &&
+         (QUEUE_NONE != port_queue_db[port_id][QUEUE_SLOT_MULTICAST][index->u8])) ||
+        ((SAI_QUEUE_TYPE_MULTICAST == type->s32) &&
+         (QUEUE_NONE != port_queue_db[port_id][QUEUE_SLOT_UNICAST][index->u8]) &&
+         (SAI_QUEUE_TYPE_ALL == queue_db[port_queue_db[port_id][QUEUE_SLOT_UNICAST][index->u8]].type))) {
+        STUB_LOG_ERR("Queue type %d index %u already exists on port %u\n", type->s32, index->u8, port_id);
+        return SAI_STATUS_ITEM_ALREADY_EXISTS;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_find_free_queue_index(&db_id))) {
+        return status;
+    }
+
+    queue = &queue_db[db_id];
+    memset(queue, 0, sizeof(*queue));
+    queue->type              = type->s32;
+    queue->port_id           = port_id;
+    queue->index             = index->u8;
+    queue->port           = port->oid;
+    queue->wred_id        = QUEUE_NONE;
+    queue->head           = QUEUE_NONE;
+    queue->tail           = QUEUE_NONE;
+    queue->rate_start_ns  = db_sim_now();
+
+    if (SAI_STATUS_SUCCESS != (status = queue_parent_attach(queue, parent->oid))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_QUEUE_ATTR_SCHEDULER_PROFILE_ID, &scheduler,
+                            &scheduler_index)) {
+        if (SAI_STATUS_SUCCESS != (status = queue_scheduler_attach(queue, scheduler->oid))) {
+            queue_parent_attach(queue, SAI_NULL_OBJECT_ID);
+            return status;
+        }
+    }
+
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_QUEUE_ATTR_WRED_PROFILE_ID, &wred, &wred_index)) {
+        if (SAI_STATUS_SUCCESS != (status = queue_wred_attach(queue, wred->oid))) {
+            queue_scheduler_attach(queue, SAI_NULL_OBJECT_ID);
+            queue_parent_attach(queue, SAI_NULL_OBJECT_ID);
+            return status;
+        }
+    }
+
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_QUEUE_ATTR_BUFFER_PROFILE_ID, &buffer, &buffer_index)) {
+        if (SAI_STATUS_SUCCESS != (status = db_buffer_queue_profile_set(db_id, buffer->oid))) {
+            queue_wred_attach(queue, SAI_NULL_OBJECT_ID);
+            queue_scheduler_attach(queue, SAI_NULL_OBJECT_ID);
+            queue_parent_attach(queue, SAI_NULL_OBJECT_ID);
+            return status;
+        }
+        queue->buffer_profile = buffer->oid;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = stub_create_object(SAI_OBJECT_TYPE_QUEUE, db_id, queue_id))) {
+        db_buffer_queue_profile_set(db_id, SAI_NULL_OBJECT_ID);
+        queue_wred_attach(queue, SAI_NULL_OBJECT_ID);
+        queue_scheduler_attach(queue, SAI_NULL_OBJECT_ID);
+        queue_parent_attach(queue, SAI_NULL_OBJECT_ID);
+        return status;
+    }
+
+    queue->is_valid = true;
+    port_queue_db[port_id][slot][index->u8] = db_id;
+    if (SAI_QUEUE_TYPE_ALL == type->s32) {
+        port_queue_db[port_id][QUEUE_SLOT_MULTICAST][index->u8] = db_id;
+    }
+    db_hqos_invalidate();
+
+    queue_key_to_str(*queue_id, key_str);
+    STUB_LOG_NTC("Created queue %s\n", key_str);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Remove queue
+ *
+ * Arguments:
+ *    [in] queue_id - queue id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_queue(_In_ sai_object_id_t queue_id)
+{
+    char          key_str[MAX_KEY_STR_LEN];
+    sai_status_t  status;
+    uint32_t      db_id, slot, index, next;
+    stub_queue_t *queue;
+
+    STUB_LOG_ENTER();
+
+    queue_key_to_str(queue_id, key_str);
+    STUB_LOG_NTC("Remove queue %s\n", key_str);
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(queue_id, SAI_OBJECT_TYPE_QUEUE, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_queue(db_id, &queue))) {
+        return status;
+    }
+
+    for (index = queue->head; QUEUE_NONE != index; index = next) {
+        next = queue_packet_pool[index].next;
+        db_buffer_egress_release(db_id, queue_packet_pool[index].packet.length);
+        db_buffer_ingress_release(&queue_packet_pool[index].packet);
+        queue_packet_free_push(index);
+    }
+    port_queued_bytes_db[queue->port_id] -= queue->bytes;
+
+    db_buffer_queue_profile_set(db_id, SAI_NULL_OBJECT_ID);
+    queue_wred_attach(queue, SAI_NULL_OBJECT_ID);
+    queue_scheduler_attach(queue, SAI_NULL_OBJECT_ID);
+    queue_parent_attach(queue, SAI_NULL_OBJECT_ID);
+
+    for (slot = 0; slot < QUEUE_SLOTS; slot++) {
+        if (db_id == port_queue_db[queue->port_id][slot][queue->index]) {
+            port_queue_db[queue->port_id][slot][queue->index] = QUEUE_NONE;
+        }
+    }
+
+    queue->is_valid = false;
+    db_hqos_invalidate();
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Set queue attribute
+ *
+ * Arguments:
+ *    [in] queue_id - queue id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_queue_attribute(_In_ sai_object_id_t queue_id, _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = queue_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    queue_key_to_str(queue_id, key_str);
+    return sai_set_attribute(&key, key_str, queue_attribs, queue_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get queue attribute
+ *
+ * Arguments:
+ *    [in] queue_id - queue id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_queue_attribute(_In_ sai_object_id_t     queue_id,
+                                      _In_ uint32_t            attr_count,
+                                      _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = queue_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    queue_key_to_str(queue_id, key_str);
+    return sai_get_attributes(&key, key_str, queue_attribs, queue_vendor_attribs, attr_count, attr_list);
+}
+
+/* Queue attributes [sai_queue_type_t type, sai_object_id_t port, uint8_t index,
+ * sai_object_id_t parent and profiles] */
+sai_status_t stub_queue_attr_get(_In_ const sai_object_key_t   *key,
+                                 _Inout_ sai_attribute_value_t *value,
+                                 _In_ uint32_t                  attr_index,
+                                 _Inout_ vendor_cache_t        *cache,
+                                 void                          *arg)
+{
+    sai_status_t  status;
+    uint32_t      db_id;
+    stub_queue_t *queue;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_QUEUE, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_queue(db_id, &queue))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_QUEUE_ATTR_TYPE:
+        value->s32 = queue->type;
+        break;
+
+    case SAI_QUEUE_ATTR_PORT:
+        value->oid = queue->port;
+        break;
+
+    case SAI_QUEUE_ATTR_INDEX:
+        value->u8 = queue->index;
+        break;
+
+    case SAI_QUEUE_ATTR_PARENT_SCHEDULER_NODE:
+        value->oid = queue->parent;
+        break;
+
+    case SAI_QUEUE_ATTR_WRED_PROFILE_ID:
+        value->oid = queue->wred_profile;
+        break;
+
+    case SAI_QUEUE_ATTR_BUFFER_PROFILE_ID:
+        value->oid = queue->buffer_profile;
+        break;
+
+    case SAI_QUEUE_ATTR_SCHEDULER_PROFILE_ID:
+        value->oid = queue->scheduler_profile;
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid queue attribute %d\n", (int32_t)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Queue attributes [sai_object_id_t parent and profiles] */
+sai_status_t stub_queue_attr_set(_In_ const sai_object_key_t      *key,
+                                 _In_ const sai_attribute_value_t *value,
+                                 void                             *arg)
+{
+    sai_status_t  status;
+    uint32_t      db_id;
+    stub_queue_t *queue;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_QUEUE, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_queue(db_id, &queue))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_QUEUE_ATTR_PARENT_SCHEDULER_NODE:
+        if (value->oid == queue->parent) {
+            break;
+        }
+        if (SAI_NULL_OBJECT_ID == value->oid) {
+            STUB_LOG_ERR("NULL queue parent scheduler node\n");
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        if (SAI_STATUS_SUCCESS != (status = queue_parent_attach(queue, value->oid))) {
+            return status;
+        }
+        db_hqos_invalidate();
+        break;
+
+    case SAI_QUEUE_ATTR_WRED_PROFILE_ID:
+        if (SAI_STATUS_SUCCESS != (status = queue_wred_attach(queue, value->oid))) {
+            return status;
+        }
+        break;
+
+    case SAI_QUEUE_ATTR_BUFFER_PROFILE_ID:
+        if (SAI_STATUS_SUCCESS != (status = db_buffer_queue_profile_set(db_id, value->oid))) {
+            return status;
+        }
+        queue->buffer_profile = value->oid;
+        break;
+
+    case SAI_QUEUE_ATTR_SCHEDULER_PROFILE_ID:
+        if (SAI_STATUS_SUCCESS != (status = queue_scheduler_attach(queue, value->oid))) {
+            return status;
+        }
+        db_hqos_invalidate();
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid queue attribute %d\n", (int32_t)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *   Get queue statistics counters.
+ *
+ * Arguments:
+ *    [in] queue_id - queue id
+ *    [in] counter_ids - specifies the array of counter ids
+ *    [in] number_of_counters - number of counters in the array
+ *    [out] counters - array of resulting counter values.
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_queue_stats(_In_ sai_object_id_t         queue_id,
+                                  _In_ const sai_queue_stat_t *counter_ids,
+                                  _In_ uint32_t                number_of_counters,
+                                  _Out_ uint64_t              *counters)
+{
+    sai_status_t  status;
+    uint32_t      db_id;
+    stub_queue_t *queue;
+    char          key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    queue_key_to_str(queue_id, key_str);
+    STUB_LOG_NTC("Get queue stats %s\n", key_str);
+
+    if (NULL == counter_ids) {
+        STUB_LOG_ERR("NULL counter ids array param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (NULL == counters) {
+        STUB_LOG_ERR("NULL counters array param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(queue_id, SAI_OBJECT_TYPE_QUEUE, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_queue(db_id, &queue))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = queue_stats_check(counter_ids, number_of_counters))) {
+        return status;
+    }
+
+    if (!queue_stats_cache_read(1, &queue_id, counter_ids, number_of_counters, counters)) {
+        queue_stats_read(queue, counter_ids, number_of_counters, counters);
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *   Get statistics counters of several queues.
+ *
+ * Arguments:
+ *    [in] number_of_queues - number of queues in the array
+ *    [in] queue_ids - array of queue ids
+ *    [in] counter_ids - specifies the array of counter ids, read for each queue
+ *    [in] number_of_counters - number of counters in the array
+ *    [out] counters - matrix of resulting counter values, a row per queue
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_queue_stats_bulk(_In_ uint32_t                number_of_queues,
+                                       _In_ const sai_object_id_t  *queue_ids,
+                                       _In_ const sai_queue_stat_t *counter_ids,
+                                       _In_ uint32_t                number_of_counters,
+                                       _Out_ uint64_t              *counters)
+{
+    sai_status_t  status;
+    uint32_t      ii, db_id;
+    stub_queue_t *queue;
+
+    STUB_LOG_ENTER();
+
+    STUB_LOG_NTC("Get queue stats bulk, %u queues %u counters\n", number_of_queues, number_of_counters);
+
+    if (NULL == queue_ids) {
+        STUB_LOG_ERR("NULL queue ids array param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (NULL == counter_ids) {
+        STUB_LOG_ERR("NULL counter ids array param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (NULL == counters) {
+        STUB_LOG_ERR("NULL counters array param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = queue_stats_check(counter_ids, number_of_counters))) {
+        return status;
+    }
+
+    /* Validate all the queues first, nothing is read if any id is wrong */
+    for (ii = 0; ii < number_of_queues; ii++) {
+        if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(queue_ids[ii], SAI_OBJECT_TYPE_QUEUE, &db_id))) {
+            return status;
+        }
+
+        if (SAI_STATUS_SUCCESS != (status = db_get_queue(db_id, &queue))) {
+            return status;
+        }
+    }
+
+    if (queue_stats_cache_read(number_of_queues, queue_ids, counter_ids, number_of_counters, counters)) {
+        STUB_LOG_EXIT();
+        return SAI_STATUS_SUCCESS;
+    }
+
+    /* The simulator is held off while the rows are filled, so they are one snapshot */
+    db_sim_lock();
+    for (ii = 0; ii < number_of_queues; ii++) {
+        stub_object_to_type(queue_ids[ii], SAI_OBJECT_TYPE_QUEUE, &db_id);
+        db_get_queue(db_id, &queue);
+        queue_stats_read(queue, counter_ids, number_of_counters, counters + ii * number_of_counters);
+    }
+    db_sim_unlock();
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *   Clear queue statistics counters.
+ *
+ * Arguments:
+ *    [in] queue_id - queue id
+ *    [in] counter_ids - specifies the array of counter ids
+ *    [in] number_of_counters - number of counters in the array
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_clear_queue_stats(_In_ sai_object_id_t         queue_id,
+                                    _In_ const sai_queue_stat_t *counter_ids,
+                                    _In_ uint32_t                number_of_counters)
+{
+    sai_status_t  status;
+    uint32_t      ii, db_id;
+    stub_queue_t *queue;
+    char          key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    queue_key_to_str(queue_id, key_str);
+    STUB_LOG_NTC("Clear queue stats %s\n", key_str);
+
+    if (NULL == counter_ids) {
+        STUB_LOG_ERR("NULL counter ids array param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(queue_id, SAI_OBJECT_TYPE_QUEUE, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_queue(db_id, &queue))) {
+        return status;
+    }
+
+    for (ii = 0; ii < number_of_counters; ii++) {
+        if (((uint32_t)counter_ids[ii] >= QUEUE_STAT_COUNT) &&
+            (STUB_QUEUE_STAT_TX_BANDWIDTH != (stub_queue_stat_t)counter_ids[ii])) {
+            STUB_LOG_ERR("Invalid queue counter %d\n", counter_ids[ii]);
+            return SAI_STATUS_INVALID_PARAMETER;
+        }
+    }
+
+    db_sim_lock();
+    for (ii = 0; ii < number_of_counters; ii++) {
+        switch (counter_ids[ii]) {
+        /* Occupancy is a gauge, watermarks restart from it */
+        case SAI_QUEUE_STAT_CURR_OCCUPANCY_BYTES:
+        case SAI_QUEUE_STAT_SHARED_CURR_OCCUPANCY_BYTES:
+            break;
+
+        case SAI_QUEUE_STAT_WATERMARK_BYTES:
+        case SAI_QUEUE_STAT_SHARED_WATERMARK_BYTES:
+            queue->watermark = queue->bytes;
+            break;
+
+        case STUB_QUEUE_STAT_TX_BANDWIDTH:
+            queue->rate_bytes    = 0;
+            queue->rate_start_ns = db_sim_now();
+            break;
+
+        default:
+            queue->counters[counter_ids[ii]] = 0;
+            break;
+        }
+    }
+    db_sim_unlock();
+
+    db_counter_refresh();
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+const sai_queue_api_t queue_api = {
+    stub_create_queue,
+    stub_remove_queue,
+    stub_set_queue_attribute,
+    stub_get_queue_attribute,
+    stub_get_queue_stats,
+    stub_clear_queue_stats,
+    stub_get_queue_stats_bulk
+};
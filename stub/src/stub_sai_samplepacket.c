@@ -0,0 +1,631 @@
+/*
+ *  Copyright (C) 2014. Mellanox Technologies, Ltd. ALL RIGHTS RESERVED.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ */
+
+#include "sai.h"
+#include "stub_sai.h"
+#include "assert.h"
+#include "math.h"
+
+#undef  __MODULE__
+#define __MODULE__ SAI_SAMPLEPACKET
+
+static const sai_attribute_entry_t samplepacket_attribs[] = {
+    { SAI_SAMPLEPACKET_ATTR_SAMPLE_RATE, true, true, true, true,
+      "Samplepacket sample rate", SAI_ATTR_VAL_TYPE_U32 },
+    { SAI_SAMPLEPACKET_ATTR_TYPE, false, true, false, true,
+      "Samplepacket type", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_SAMPLEPACKET_ATTR_MODE, false, true, false, true,
+      "Samplepacket mode", SAI_ATTR_VAL_TYPE_S32 },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+sai_status_t stub_samplepacket_attr_get(_In_ const sai_object_key_t   *key,
+                                        _Inout_ sai_attribute_value_t *value,
+                                        _In_ uint32_t                  attr_index,
+                                        _Inout_ vendor_cache_t        *cache,
+                                        void                          *arg);
+sai_status_t stub_samplepacket_rate_set(_In_ const sai_object_key_t      *key,
+                                        _In_ const sai_attribute_value_t *value,
+                                        void                             *arg);
+
+static const sai_vendor_attribute_entry_t samplepacket_vendor_attribs[] = {
+    { SAI_SAMPLEPACKET_ATTR_SAMPLE_RATE,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_samplepacket_attr_get, (void*)SAI_SAMPLEPACKET_ATTR_SAMPLE_RATE,
+      stub_samplepacket_rate_set, NULL },
+    { SAI_SAMPLEPACKET_ATTR_TYPE,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_samplepacket_attr_get, (void*)SAI_SAMPLEPACKET_ATTR_TYPE,
+      NULL, NULL },
+    { SAI_SAMPLEPACKET_ATTR_MODE,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_samplepacket_attr_get, (void*)SAI_SAMPLEPACKET_ATTR_MODE,
+      NULL, NULL },
+};
+
+/* State DB *************/
+
+/*
+ * Each sampler counts down the packets to skip before its next sample. The
+ * skip is drawn from the geometric distribution of the gaps between samples
+ * taken with probability 1/rate, so sampling costs one random draw per
+ * sample rather than per packet, and a burst with no sample in it costs a
+ * single compare.
+ *
+ * Samples are copied to a single producer single consumer queue read by the
+ * host interface. When it is full the sample is dropped and counted, the
+ * data path never waits for the host.
+ */
+#define MAX_SAMPLEPACKET_NUMBER  64
+#define SAMPLEPACKET_DIRECTIONS  2
+#define SAMPLEPACKET_QUEUE_SIZE  4096
+#define SAMPLEPACKET_SEED        0x9E3779B97F4A7C15ULL
+
+typedef struct _stub_sampler_t {
+    uint32_t rate;
+    /* log(1 - 1/rate), for the geometric draw */
+    double   log_keep;
+    /* Packets until the next sample, counting it */
+    uint64_t skip;
+    /* Packets observed, and samples lost on a full queue */
+    uint64_t pool;
+    uint64_t drops;
+    uint64_t random;
+} stub_sampler_t;
+
+typedef struct _stub_samplepacket_t {
+    uint32_t                rate;
+    sai_samplepacket_type_t type;
+    sai_samplepacket_mode_t mode;
+    /* Sampler merging the traffic of all the ports of a shared session */
+    stub_sampler_t          sampler;
+    uint32_t                ref_count;
+    bool                    is_valid;
+} stub_samplepacket_t;
+
+typedef struct _stub_samplepacket_port_t {
+    sai_object_id_t session;
+    /* Own sampler of an exclusive session */
+    stub_sampler_t  own;
+    /* Sampler the port uses, NULL when no session is bound */
+    stub_sampler_t *sampler;
+} stub_samplepacket_port_t;
+
+typedef struct _stub_samplepacket_queue_t {
+    uint32_t head __attribute__((aligned(CACHE_LINE_SIZE)));
+    uint32_t tail __attribute__((aligned(CACHE_LINE_SIZE)));
+    stub_sample_t samples[SAMPLEPACKET_QUEUE_SIZE] __attribute__((aligned(CACHE_LINE_SIZE)));
+} stub_samplepacket_queue_t;
+
+static stub_samplepacket_t       samplepacket_db[MAX_SAMPLEPACKET_NUMBER];
+static stub_samplepacket_port_t  samplepacket_port_db[PORT_NUMBER][SAMPLEPACKET_DIRECTIONS];
+static stub_samplepacket_queue_t samplepacket_queue;
+static uint64_t                  samplepacket_seed = SAMPLEPACKET_SEED;
+
+static sai_status_t db_get_samplepacket(_In_ uint32_t session_id, _Out_ stub_samplepacket_t **session)
+{
+    if ((session_id >= MAX_SAMPLEPACKET_NUMBER) || (!samplepacket_db[session_id].is_valid)) {
+        STUB_LOG_ERR("Invalid samplepacket session ID %u\n", session_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *session = &samplepacket_db[session_id];
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t db_find_free_samplepacket_index(_Out_ uint32_t *free_index)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < MAX_SAMPLEPACKET_NUMBER; ii++) {
+        if (false == samplepacket_db[ii].is_valid) {
+            *free_index = ii;
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+
+    STUB_LOG_ERR("Samplepacket session table full\n");
+    return SAI_STATUS_TABLE_FULL;
+}
+
+/* splitmix64 */
+static uint64_t sampler_random(_Inout_ stub_sampler_t *sampler)
+{
+    uint64_t z = (sampler->random += 0x9E3779B97F4A7C15ULL);
+
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+
+    return z ^ (z >> 31);
+}
+
+/* Packets up to and including the next sample, geometric with mean rate */
+static uint64_t sampler_skip(_Inout_ stub_sampler_t *sampler)
+{
+    double uniform, skip;
+
+    if (sampler->rate <= 1) {
+        return 1;
+    }
+
+    uniform = ((sampler_random(sampler) >> 11) + 1) * (1.0 / 9007199254740992.0);
+    skip    = floor(log(uniform) / sampler->log_keep);
+
+    return (skip < (double)UINT32_MAX) ? 1 + (uint64_t)skip : UINT32_MAX;
+}
+
+static void sampler_rate_set(_Inout_ stub_sampler_t *sampler, _In_ uint32_t rate)
+{
+    sampler->rate     = rate;
+    sampler->log_keep = (rate > 1) ? log1p(-1.0 / rate) : 0;
+    sampler->skip     = sampler_skip(sampler);
+}
+
+static void sampler_init(_Out_ stub_sampler_t *sampler, _In_ uint32_t rate)
+{
+    memset(sampler, 0, sizeof(*sampler));
+    sampler->random = samplepacket_seed;
+    samplepacket_seed += SAMPLEPACKET_SEED;
+    sampler_rate_set(sampler, rate);
+}
+
+static void samplepacket_enqueue(_In_ uint32_t        port_id,
+                                 _In_ bool            ingress,
+                                 _Inout_ stub_sampler_t *sampler,
+                                 _In_ uint64_t        pool,
+                                 _In_ uint32_t        length,
+                                 _In_ const uint8_t  *header)
+{
+    stub_sample_t *sample;
+    uint32_t       tail, head;
+
+    tail = __atomic_load_n(&samplepacket_queue.tail, __ATOMIC_RELAXED);
+    head = __atomic_load_n(&samplepacket_queue.head, __ATOMIC_ACQUIRE);
+    if (tail - head >= SAMPLEPACKET_QUEUE_SIZE) {
+        sampler->drops++;
+        return;
+    }
+
+    sample                = &samplepacket_queue.samples[tail % SAMPLEPACKET_QUEUE_SIZE];
+    sample->port_id       = port_id;
+    sample->ingress       = ingress;
+    sample->length        = length;
+    sample->rate          = sampler->rate;
+    sample->sample_pool   = pool;
+    sample->drops         = sampler->drops;
+    sample->header_length = 0;
+    if (NULL != header) {
+        sample->header_length = (length < SAMPLEPACKET_HEADER_SIZE) ? length : SAMPLEPACKET_HEADER_SIZE;
+        memcpy(sample->header, header, sample->header_length);
+    }
+
+    __atomic_store_n(&samplepacket_queue.tail, tail + 1, __ATOMIC_RELEASE);
+}
+
+/*
+ * Sample a burst of packets received (ingress) or sent (egress) on a port.
+ * headers may be NULL when the packet bytes aren't available, the samples
+ * then only carry the frame length.
+ */
+sai_status_t db_samplepacket_sample(_In_ uint32_t              port_id,
+                                    _In_ bool                  ingress,
+                                    _In_ uint32_t              count,
+                                    _In_ const uint32_t       *lengths,
+                                    _In_ const uint8_t* const *headers)
+{
+    stub_sampler_t *sampler;
+    uint64_t        next;
+
+    if (port_id >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid port %u\n", port_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    sampler = samplepacket_port_db[port_id][ingress ? 0 : 1].sampler;
+    if (NULL == sampler) {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    /* Index in the burst of the next sampled packet */
+    for (next = sampler->skip - 1; next < count; next += sampler_skip(sampler)) {
+        samplepacket_enqueue(port_id, ingress, sampler, sampler->pool + next + 1, lengths[next],
+                             (NULL != headers) ? headers[next] : NULL);
+    }
+
+    sampler->skip  = next - count + 1;
+    sampler->pool += count;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Oldest pending sample, for the host interface. Returns false when there is none */
+bool db_samplepacket_peek(_Out_ const stub_sample_t **sample)
+{
+    uint32_t head, tail;
+
+    head = __atomic_load_n(&samplepacket_queue.head, __ATOMIC_RELAXED);
+    tail = __atomic_load_n(&samplepacket_queue.tail, __ATOMIC_ACQUIRE);
+    if (head == tail) {
+        return false;
+    }
+
+    *sample = &samplepacket_queue.samples[head % SAMPLEPACKET_QUEUE_SIZE];
+
+    return true;
+}
+
+void db_samplepacket_pop()
+{
+    uint32_t head;
+
+    head = __atomic_load_n(&samplepacket_queue.head, __ATOMIC_RELAXED);
+    if (head != __atomic_load_n(&samplepacket_queue.tail, __ATOMIC_ACQUIRE)) {
+        __atomic_store_n(&samplepacket_queue.head, head + 1, __ATOMIC_RELEASE);
+    }
+}
+
+sai_status_t db_samplepacket_port_bind(_In_ uint32_t port_id, _In_ bool ingress, _In_ sai_object_id_t session)
+{
+    stub_samplepacket_port_t *port;
+    stub_samplepacket_t      *new_session = NULL, *old_session = NULL;
+    uint32_t                  session_id;
+
+    if (port_id >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid port %u\n", port_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    port = &samplepacket_port_db[port_id][ingress ? 0 : 1];
+    if (port->session == session) {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    if (SAI_NULL_OBJECT_ID != session) {
+        if ((SAI_STATUS_SUCCESS != stub_object_to_type(session, SAI_OBJECT_TYPE_SAMPLEPACKET, &session_id)) ||
+            (SAI_STATUS_SUCCESS != db_get_samplepacket(session_id, &new_session))) {
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+    }
+
+    if (SAI_NULL_OBJECT_ID != port->session) {
+        assert(SAI_STATUS_SUCCESS == stub_object_to_type(port->session, SAI_OBJECT_TYPE_SAMPLEPACKET, &session_id));
+        assert(SAI_STATUS_SUCCESS == db_get_samplepacket(session_id, &old_session));
+        old_session->ref_count--;
+    }
+
+    port->session = session;
+    port->sampler = NULL;
+
+    if (NULL != new_session) {
+        new_session->ref_count++;
+        if (SAI_SAMPLEPACKET_MODE_SHARED == new_session->mode) {
+            port->sampler = &new_session->sampler;
+        } else {
+            sampler_init(&port->own, new_session->rate);
+            port->sampler = &port->own;
+        }
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t db_samplepacket_port_bound_get(_In_ uint32_t port_id, _In_ bool ingress, _Out_ sai_object_id_t *session)
+{
+    if (port_id >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid port %u\n", port_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *session = samplepacket_port_db[port_id][ingress ? 0 : 1].session;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*************************/
+
+static void samplepacket_key_to_str(_In_ sai_object_id_t session_id, _Out_ char *key_str)
+{
+    uint32_t sessionid;
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(session_id, SAI_OBJECT_TYPE_SAMPLEPACKET, &sessionid)) {
+        snprintf(key_str, MAX_KEY_STR_LEN, "invalid samplepacket session");
+    } else {
+        snprintf(key_str, MAX_KEY_STR_LEN, "samplepacket session %u", sessionid);
+    }
+}
+
+/*
+ * Routine Description:
+ *    Create samplepacket session.
+ *
+ * Arguments:
+ *    [out] session_id - samplepacket session id
+ *    [in] switch_id - switch id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_samplepacket_session(_Out_ sai_object_id_t      *session_id,
+                                              _In_ sai_object_id_t        switch_id,
+                                              _In_ uint32_t               attr_count,
+                                              _In_ const sai_attribute_t *attr_list)
+{
+    stub_samplepacket_t         *session;
+    sai_status_t                 status;
+    const sai_attribute_value_t *rate, *value;
+    uint32_t                     rate_index, index, db_id;
+    sai_samplepacket_type_t      type = SAI_SAMPLEPACKET_TYPE_SLOW_PATH;
+    sai_samplepacket_mode_t      mode = SAI_SAMPLEPACKET_MODE_EXCLUSIVE;
+    char                         list_str[MAX_LIST_VALUE_STR_LEN];
+    char                         key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == session_id) {
+        STUB_LOG_ERR("NULL samplepacket session id param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = check_attribs_metadata(attr_count, attr_list, samplepacket_attribs, samplepacket_vendor_attribs,
+                                         SAI_OPERATION_CREATE))) {
+        STUB_LOG_ERR("Failed attribs check\n");
+        return status;
+    }
+
+    sai_attr_list_to_str(attr_count, attr_list, samplepacket_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create samplepacket session, %s\n", list_str);
+
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_SAMPLEPACKET_ATTR_SAMPLE_RATE, &rate, &rate_index));
+
+    if (0 == rate->u32) {
+        STUB_LOG_ERR("Invalid samplepacket sample rate 0\n");
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + rate_index;
+    }
+
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_SAMPLEPACKET_ATTR_TYPE, &value, &index)) {
+        if (SAI_SAMPLEPACKET_TYPE_SLOW_PATH != value->s32) {
+            STUB_LOG_ERR("Invalid samplepacket type %d\n", value->s32);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + index;
+        }
+        type = value->s32;
+    }
+
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_SAMPLEPACKET_ATTR_MODE, &value, &index)) {
+        if ((SAI_SAMPLEPACKET_MODE_EXCLUSIVE != value->s32) && (SAI_SAMPLEPACKET_MODE_SHARED != value->s32)) {
+            STUB_LOG_ERR("Invalid samplepacket mode %d\n", value->s32);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + index;
+        }
+        mode = value->s32;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_find_free_samplepacket_index(&db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = stub_create_object(SAI_OBJECT_TYPE_SAMPLEPACKET, db_id, session_id))) {
+        return status;
+    }
+
+    session = &samplepacket_db[db_id];
+    memset(session, 0, sizeof(*session));
+    session->rate = rate->u32;
+    session->type = type;
+    session->mode = mode;
+    sampler_init(&session->sampler, session->rate);
+    session->is_valid = true;
+
+    samplepacket_key_to_str(*session_id, key_str);
+    STUB_LOG_NTC("Created samplepacket session %s\n", key_str);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Remove samplepacket session.
+ *
+ * Arguments:
+ *    [in] session_id - samplepacket session id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_samplepacket_session(_In_ sai_object_id_t session_id)
+{
+    stub_samplepacket_t *session;
+    char                 key_str[MAX_KEY_STR_LEN];
+    sai_status_t         status;
+    uint32_t             db_id;
+
+    STUB_LOG_ENTER();
+
+    samplepacket_key_to_str(session_id, key_str);
+    STUB_LOG_NTC("Remove samplepacket session %s\n", key_str);
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(session_id, SAI_OBJECT_TYPE_SAMPLEPACKET, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_samplepacket(db_id, &session))) {
+        return status;
+    }
+
+    if (session->ref_count > 0) {
+        STUB_LOG_ERR("Samplepacket session %u is used by %u ports\n", db_id, session->ref_count);
+        return SAI_STATUS_OBJECT_IN_USE;
+    }
+
+    session->is_valid = false;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Set samplepacket session attribute.
+ *
+ * Arguments:
+ *    [in] session_id - samplepacket session id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_samplepacket_attribute(_In_ sai_object_id_t session_id, _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = session_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    samplepacket_key_to_str(session_id, key_str);
+    return sai_set_attribute(&key, key_str, samplepacket_attribs, samplepacket_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get samplepacket session attributes.
+ *
+ * Arguments:
+ *    [in] session_id - samplepacket session id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_samplepacket_attribute(_In_ sai_object_id_t     session_id,
+                                             _In_ uint32_t            attr_count,
+                                             _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = session_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    samplepacket_key_to_str(session_id, key_str);
+    return sai_get_attributes(&key, key_str, samplepacket_attribs, samplepacket_vendor_attribs, attr_count,
+                              attr_list);
+}
+
+/* Samplepacket attributes [uint32_t sample rate, sai_samplepacket_type_t, sai_samplepacket_mode_t] */
+sai_status_t stub_samplepacket_attr_get(_In_ const sai_object_key_t   *key,
+                                        _Inout_ sai_attribute_value_t *value,
+                                        _In_ uint32_t                  attr_index,
+                                        _Inout_ vendor_cache_t        *cache,
+                                        void                          *arg)
+{
+    stub_samplepacket_t *session;
+    sai_status_t         status;
+    uint32_t             db_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_SAMPLEPACKET, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_samplepacket(db_id, &session))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_SAMPLEPACKET_ATTR_SAMPLE_RATE:
+        value->u32 = session->rate;
+        break;
+
+    case SAI_SAMPLEPACKET_ATTR_TYPE:
+        value->s32 = session->type;
+        break;
+
+    case SAI_SAMPLEPACKET_ATTR_MODE:
+        value->s32 = session->mode;
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid samplepacket attribute %d\n", (int)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Samplepacket sample rate [uint32_t], applies to the samplers of all the ports using the session */
+sai_status_t stub_samplepacket_rate_set(_In_ const sai_object_key_t      *key,
+                                        _In_ const sai_attribute_value_t *value,
+                                        void                             *arg)
+{
+    stub_samplepacket_t      *session;
+    stub_samplepacket_port_t *port;
+    sai_status_t              status;
+    uint32_t                  db_id, port_id, dir;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_SAMPLEPACKET, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_samplepacket(db_id, &session))) {
+        return status;
+    }
+
+    if (0 == value->u32) {
+        STUB_LOG_ERR("Invalid samplepacket sample rate 0\n");
+        return SAI_STATUS_INVALID_ATTR_VALUE_0;
+    }
+
+    session->rate = value->u32;
+    sampler_rate_set(&session->sampler, session->rate);
+
+    for (port_id = 0; port_id < PORT_NUMBER; port_id++) {
+        for (dir = 0; dir < SAMPLEPACKET_DIRECTIONS; dir++) {
+            port = &samplepacket_port_db[port_id][dir];
+            if ((port->session == key->object_id) && (port->sampler == &port->own)) {
+                sampler_rate_set(&port->own, session->rate);
+            }
+        }
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+const sai_samplepacket_api_t samplepacket_api = {
+    stub_create_samplepacket_session,
+    stub_remove_samplepacket_session,
+    stub_set_samplepacket_attribute,
+    stub_get_samplepacket_attribute
+};
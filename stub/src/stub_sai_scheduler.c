@@ -0,0 +1,520 @@
+/*
+ *  Copyright (C) 2014. Mellanox Technologies, Ltd. ALL RIGHTS RESERVED.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ */
+
+#include "sai.h"
+#include "stub_sai.h"
+#include "assert.h"
+#include "inttypes.h"
+
+#undef  __MODULE__
+#define __MODULE__ SAI_SCHEDULER
+
+static const sai_attribute_entry_t scheduler_attribs[] = {
+    { SAI_SCHEDULER_ATTR_SCHEDULING_TYPE, false, true, true, true,
+      "Scheduling type", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_SCHEDULER_ATTR_SCHEDULING_WEIGHT, false, true, true, true,
+      "Scheduling weight", SAI_ATTR_VAL_TYPE_U8 },
+    { SAI_SCHEDULER_ATTR_METER_TYPE, false, true, true, true,
+      "Scheduler meter type", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_SCHEDULER_ATTR_MIN_BANDWIDTH_RATE, false, true, true, true,
+      "Scheduler min bandwidth rate", SAI_ATTR_VAL_TYPE_U64 },
+    { SAI_SCHEDULER_ATTR_MIN_BANDWIDTH_BURST_RATE, false, true, true, true,
+      "Scheduler min bandwidth burst", SAI_ATTR_VAL_TYPE_U64 },
+    { SAI_SCHEDULER_ATTR_MAX_BANDWIDTH_RATE, false, true, true, true,
+      "Scheduler max bandwidth rate", SAI_ATTR_VAL_TYPE_U64 },
+    { SAI_SCHEDULER_ATTR_MAX_BANDWIDTH_BURST_RATE, false, true, true, true,
+      "Scheduler max bandwidth burst", SAI_ATTR_VAL_TYPE_U64 },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+sai_status_t stub_scheduler_attr_get(_In_ const sai_object_key_t   *key,
+                                     _Inout_ sai_attribute_value_t *value,
+                                     _In_ uint32_t                  attr_index,
+                                     _Inout_ vendor_cache_t        *cache,
+                                     void                          *arg);
+sai_status_t stub_scheduler_attr_set(_In_ const sai_object_key_t      *key,
+                                     _In_ const sai_attribute_value_t *value,
+                                     void                             *arg);
+
+static const sai_vendor_attribute_entry_t scheduler_vendor_attribs[] = {
+    { SAI_SCHEDULER_ATTR_SCHEDULING_TYPE,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_scheduler_attr_get, (void*)SAI_SCHEDULER_ATTR_SCHEDULING_TYPE,
+      stub_scheduler_attr_set, (void*)SAI_SCHEDULER_ATTR_SCHEDULING_TYPE },
+    { SAI_SCHEDULER_ATTR_SCHEDULING_WEIGHT,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_scheduler_attr_get, (void*)SAI_SCHEDULER_ATTR_SCHEDULING_WEIGHT,
+      stub_scheduler_attr_set, (void*)SAI_SCHEDULER_ATTR_SCHEDULING_WEIGHT },
+    { SAI_SCHEDULER_ATTR_METER_TYPE,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_scheduler_attr_get, (void*)SAI_SCHEDULER_ATTR_METER_TYPE,
+      stub_scheduler_attr_set, (void*)SAI_SCHEDULER_ATTR_METER_TYPE },
+    { SAI_SCHEDULER_ATTR_MIN_BANDWIDTH_RATE,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_scheduler_attr_get, (void*)SAI_SCHEDULER_ATTR_MIN_BANDWIDTH_RATE,
+      stub_scheduler_attr_set, (void*)SAI_SCHEDULER_ATTR_MIN_BANDWIDTH_RATE },
+    { SAI_SCHEDULER_ATTR_MIN_BANDWIDTH_BURST_RATE,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_scheduler_attr_get, (void*)SAI_SCHEDULER_ATTR_MIN_BANDWIDTH_BURST_RATE,
+      stub_scheduler_attr_set, (void*)SAI_SCHEDULER_ATTR_MIN_BANDWIDTH_BURST_RATE },
+    { SAI_SCHEDULER_ATTR_MAX_BANDWIDTH_RATE,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_scheduler_attr_get, (void*)SAI_SCHEDULER_ATTR_MAX_BANDWIDTH_RATE,
+      stub_scheduler_attr_set, (void*)SAI_SCHEDULER_ATTR_MAX_BANDWIDTH_RATE },
+    { SAI_SCHEDULER_ATTR_MAX_BANDWIDTH_BURST_RATE,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_scheduler_attr_get, (void*)SAI_SCHEDULER_ATTR_MAX_BANDWIDTH_BURST_RATE,
+      stub_scheduler_attr_set, (void*)SAI_SCHEDULER_ATTR_MAX_BANDWIDTH_BURST_RATE },
+};
+
+/* State DB *************/
+#define MAX_SCHEDULER_NUMBER 256
+#define SCHEDULER_MIN_WEIGHT 1
+#define SCHEDULER_MAX_WEIGHT 100
+
+typedef struct _stub_scheduler_t {
+    stub_scheduler_params_t params;
+    uint32_t                ref_count;
+    bool                    is_valid;
+} stub_scheduler_t;
+
+static stub_scheduler_t scheduler_db[MAX_SCHEDULER_NUMBER];
+
+static sai_status_t db_get_scheduler(_In_ uint32_t scheduler_id, _Out_ stub_scheduler_t **scheduler)
+{
+    if ((scheduler_id >= MAX_SCHEDULER_NUMBER) || (!scheduler_db[scheduler_id].is_valid)) {
+        STUB_LOG_ERR("Invalid scheduler profile ID %u\n", scheduler_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *scheduler = &scheduler_db[scheduler_id];
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t db_find_free_scheduler_index(_Out_ uint32_t *free_index)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < MAX_SCHEDULER_NUMBER; ii++) {
+        if (false == scheduler_db[ii].is_valid) {
+            *free_index = ii;
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+
+    STUB_LOG_ERR("Scheduler profile table full\n");
+    return SAI_STATUS_TABLE_FULL;
+}
+
+/* Scheduling of a node without profile : WRR with weight 1, unshaped */
+void db_scheduler_defaults(_Out_ stub_scheduler_params_t *params)
+{
+    memset(params, 0, sizeof(*params));
+    params->type       = SAI_SCHEDULING_TYPE_WRR;
+    params->weight     = SCHEDULER_MIN_WEIGHT;
+    params->meter_type = SAI_METER_TYPE_BYTES;
+}
+
+sai_status_t db_scheduler_get(_In_ uint32_t scheduler_id, _Out_ stub_scheduler_params_t *params)
+{
+    stub_scheduler_t *scheduler;
+    sai_status_t      status;
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_scheduler(scheduler_id, &scheduler))) {
+        return status;
+    }
+
+    *params = scheduler->params;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Count queues, groups and ports using a scheduler profile, so that it isn't removed while in use */
+sai_status_t db_scheduler_ref(_In_ uint32_t scheduler_id, _In_ bool add)
+{
+    stub_scheduler_t *scheduler;
+    sai_status_t      status;
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_scheduler(scheduler_id, &scheduler))) {
+        return status;
+    }
+
+    if (add) {
+        scheduler->ref_count++;
+    } else {
+        assert(scheduler->ref_count > 0);
+        scheduler->ref_count--;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*************************/
+
+static void scheduler_key_to_str(_In_ sai_object_id_t scheduler_id, _Out_ char *key_str)
+{
+    uint32_t schedulerid;
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(scheduler_id, SAI_OBJECT_TYPE_SCHEDULER, &schedulerid)) {
+        snprintf(key_str, MAX_KEY_STR_LEN, "invalid scheduler profile id");
+    } else {
+        snprintf(key_str, MAX_KEY_STR_LEN, "scheduler profile id %u", schedulerid);
+    }
+}
+
+static sai_status_t scheduler_attr_apply(_Inout_ stub_scheduler_params_t *params,
+                                         _In_ sai_attr_id_t               attr_id,
+                                         _In_ const sai_attribute_value_t *value)
+{
+    switch (attr_id) {
+    case SAI_SCHEDULER_ATTR_SCHEDULING_TYPE:
+        if ((value->s32 < SAI_SCHEDULING_TYPE_STRICT) || (value->s32 > SAI_SCHEDULING_TYPE_DWRR)) {
+            STUB_LOG_ERR("Invalid scheduling type %d\n", value->s32);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        params->type = value->s32;
+        break;
+
+    case SAI_SCHEDULER_ATTR_SCHEDULING_WEIGHT:
+        if ((value->u8 < SCHEDULER_MIN_WEIGHT) || (value->u8 > SCHEDULER_MAX_WEIGHT)) {
+            STUB_LOG_ERR("Invalid scheduling weight %u\n", value->u8);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        params->weight = value->u8;
+        break;
+
+    case SAI_SCHEDULER_ATTR_METER_TYPE:
+        if ((SAI_METER_TYPE_PACKETS != value->s32) && (SAI_METER_TYPE_BYTES != value->s32)) {
+            STUB_LOG_ERR("Invalid scheduler meter type %d\n", value->s32);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        params->meter_type = value->s32;
+        break;
+
+    case SAI_SCHEDULER_ATTR_MIN_BANDWIDTH_RATE:
+        params->min_rate = value->u64;
+        break;
+
+    case SAI_SCHEDULER_ATTR_MIN_BANDWIDTH_BURST_RATE:
+        params->min_burst = value->u64;
+        break;
+
+    case SAI_SCHEDULER_ATTR_MAX_BANDWIDTH_RATE:
+        params->max_rate = value->u64;
+        break;
+
+    case SAI_SCHEDULER_ATTR_MAX_BANDWIDTH_BURST_RATE:
+        params->max_burst = value->u64;
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid scheduler attribute %d\n", attr_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t scheduler_rates_check(_In_ const stub_scheduler_params_t *params)
+{
+    if ((0 != params->max_rate) && (params->min_rate > params->max_rate)) {
+        STUB_LOG_ERR("Scheduler min rate %" PRIu64 " above max rate %" PRIu64 "\n", params->min_rate,
+                     params->max_rate);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Create scheduler profile
+ *
+ * Arguments:
+ *    [out] scheduler_id - scheduler profile id
+ *    [in] switch_id - switch id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_scheduler_profile(_Out_ sai_object_id_t      *scheduler_id,
+                                           _In_ sai_object_id_t        switch_id,
+                                           _In_ uint32_t               attr_count,
+                                           _In_ const sai_attribute_t *attr_list)
+{
+    sai_status_t            status;
+    stub_scheduler_params_t params;
+    uint32_t                ii, db_id = 0;
+    char                    list_str[MAX_LIST_VALUE_STR_LEN];
+    char                    key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == scheduler_id) {
+        STUB_LOG_ERR("NULL scheduler profile id param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = check_attribs_metadata(attr_count, attr_list, scheduler_attribs, scheduler_vendor_attribs,
+                                         SAI_OPERATION_CREATE))) {
+        STUB_LOG_ERR("Failed attribs check\n");
+        return status;
+    }
+
+    sai_attr_list_to_str(attr_count, attr_list, scheduler_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create scheduler profile, %s\n", list_str);
+
+    db_scheduler_defaults(&params);
+
+    for (ii = 0; ii < attr_count; ii++) {
+        if (SAI_STATUS_SUCCESS != (status = scheduler_attr_apply(&params, attr_list[ii].id, &attr_list[ii].value))) {
+            return (SAI_STATUS_INVALID_ATTR_VALUE_0 == status) ? SAI_STATUS_INVALID_ATTR_VALUE_0 + ii : status;
+        }
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = scheduler_rates_check(&params))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_find_free_scheduler_index(&db_id))) {
+        return status;
+    }
+
+    scheduler_db[db_id].params    = params;
+    scheduler_db[db_id].ref_count = 0;
+    scheduler_db[db_id].is_valid  = true;
+
+    if (SAI_STATUS_SUCCESS != (status = stub_create_object(SAI_OBJECT_TYPE_SCHEDULER, db_id, scheduler_id))) {
+        scheduler_db[db_id].is_valid = false;
+        return status;
+    }
+    scheduler_key_to_str(*scheduler_id, key_str);
+    STUB_LOG_NTC("Created scheduler profile %s\n", key_str);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Remove scheduler profile
+ *
+ * Arguments:
+ *    [in] scheduler_id - scheduler profile id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_scheduler_profile(_In_ sai_object_id_t scheduler_id)
+{
+    char              key_str[MAX_KEY_STR_LEN];
+    sai_status_t      status;
+    uint32_t          db_id;
+    stub_scheduler_t *scheduler;
+
+    STUB_LOG_ENTER();
+
+    scheduler_key_to_str(scheduler_id, key_str);
+    STUB_LOG_NTC("Remove scheduler profile %s\n", key_str);
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(scheduler_id, SAI_OBJECT_TYPE_SCHEDULER, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_scheduler(db_id, &scheduler))) {
+        return status;
+    }
+
+    if (0 != scheduler->ref_count) {
+        STUB_LOG_ERR("Scheduler profile ID %u is used by %u objects\n", db_id, scheduler->ref_count);
+        return SAI_STATUS_OBJECT_IN_USE;
+    }
+
+    scheduler->is_valid = false;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Set scheduler profile attribute
+ *
+ * Arguments:
+ *    [in] scheduler_id - scheduler profile id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_scheduler_attribute(_In_ sai_object_id_t scheduler_id, _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = scheduler_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    scheduler_key_to_str(scheduler_id, key_str);
+    return sai_set_attribute(&key, key_str, scheduler_attribs, scheduler_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get scheduler profile attribute
+ *
+ * Arguments:
+ *    [in] scheduler_id - scheduler profile id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_scheduler_attribute(_In_ sai_object_id_t     scheduler_id,
+                                          _In_ uint32_t            attr_count,
+                                          _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = scheduler_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    scheduler_key_to_str(scheduler_id, key_str);
+    return sai_get_attributes(&key, key_str, scheduler_attribs, scheduler_vendor_attribs, attr_count, attr_list);
+}
+
+/* Scheduler profile attributes [sai_scheduling_type_t, uint8_t weight, sai_meter_type_t,
+ * uint64_t rates and bursts] */
+sai_status_t stub_scheduler_attr_get(_In_ const sai_object_key_t   *key,
+                                     _Inout_ sai_attribute_value_t *value,
+                                     _In_ uint32_t                  attr_index,
+                                     _Inout_ vendor_cache_t        *cache,
+                                     void                          *arg)
+{
+    sai_status_t      status;
+    uint32_t          db_id;
+    stub_scheduler_t *scheduler;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_SCHEDULER, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_scheduler(db_id, &scheduler))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_SCHEDULER_ATTR_SCHEDULING_TYPE:
+        value->s32 = scheduler->params.type;
+        break;
+
+    case SAI_SCHEDULER_ATTR_SCHEDULING_WEIGHT:
+        value->u8 = scheduler->params.weight;
+        break;
+
+    case SAI_SCHEDULER_ATTR_METER_TYPE:
+        value->s32 = scheduler->params.meter_type;
+        break;
+
+    case SAI_SCHEDULER_ATTR_MIN_BANDWIDTH_RATE:
+        value->u64 = scheduler->params.min_rate;
+        break;
+
+    case SAI_SCHEDULER_ATTR_MIN_BANDWIDTH_BURST_RATE:
+        value->u64 = scheduler->params.min_burst;
+        break;
+
+    case SAI_SCHEDULER_ATTR_MAX_BANDWIDTH_RATE:
+        value->u64 = scheduler->params.max_rate;
+        break;
+
+    case SAI_SCHEDULER_ATTR_MAX_BANDWIDTH_BURST_RATE:
+        value->u64 = scheduler->params.max_burst;
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid scheduler attribute %d\n", (int32_t)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Scheduler profile attributes [sai_scheduling_type_t, uint8_t weight, sai_meter_type_t,
+ * uint64_t rates and bursts] */
+sai_status_t stub_scheduler_attr_set(_In_ const sai_object_key_t      *key,
+                                     _In_ const sai_attribute_value_t *value,
+                                     void                             *arg)
+{
+    sai_status_t            status;
+    uint32_t                db_id;
+    stub_scheduler_t       *scheduler;
+    stub_scheduler_params_t params;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_SCHEDULER, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_scheduler(db_id, &scheduler))) {
+        return status;
+    }
+
+    params = scheduler->params;
+    if (SAI_STATUS_SUCCESS != (status = scheduler_attr_apply(&params, (sai_attr_id_t)(int64_t)arg, value))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = scheduler_rates_check(&params))) {
+        return status;
+    }
+
+    scheduler->params = params;
+    db_hqos_invalidate();
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+const sai_scheduler_api_t scheduler_api = {
+    stub_create_scheduler_profile,
+    stub_remove_scheduler_profile,
+    stub_set_scheduler_attribute,
+    stub_get_scheduler_attribute
+};
@@ -0,0 +1,685 @@
+/*
+ *  Copyright (C) 2014. Mellanox Technologies, Ltd. ALL RIGHTS RESERVED.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ */
+
+#include "sai.h"
+#include "stub_sai.h"
+#include "assert.h"
+
+#undef  __MODULE__
+#define __MODULE__ SAI_SCHEDULER_GROUP
+
+static const sai_attribute_entry_t scheduler_group_attribs[] = {
+    { SAI_SCHEDULER_GROUP_ATTR_CHILD_COUNT, false, false, false, true,
+      "Scheduler group child count", SAI_ATTR_VAL_TYPE_U32 },
+    { SAI_SCHEDULER_GROUP_ATTR_CHILD_LIST, false, false, false, true,
+      "Scheduler group child list", SAI_ATTR_VAL_TYPE_OBJLIST },
+    { SAI_SCHEDULER_GROUP_ATTR_PORT_ID, true, true, false, true,
+      "Scheduler group port", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_SCHEDULER_GROUP_ATTR_LEVEL, true, true, false, true,
+      "Scheduler group level", SAI_ATTR_VAL_TYPE_U8 },
+    { SAI_SCHEDULER_GROUP_ATTR_MAX_CHILDS, true, true, false, true,
+      "Scheduler group max childs", SAI_ATTR_VAL_TYPE_U8 },
+    { SAI_SCHEDULER_GROUP_ATTR_SCHEDULER_PROFILE_ID, true, true, true, true,
+      "Scheduler group scheduler profile", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_SCHEDULER_GROUP_ATTR_PARENT_NODE, true, true, true, true,
+      "Scheduler group parent node", SAI_ATTR_VAL_TYPE_OID },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+sai_status_t stub_scheduler_group_attr_get(_In_ const sai_object_key_t   *key,
+                                           _Inout_ sai_attribute_value_t *value,
+                                           _In_ uint32_t                  attr_index,
+                                           _Inout_ vendor_cache_t        *cache,
+                                           void                          *arg);
+sai_status_t stub_scheduler_group_child_list_get(_In_ const sai_object_key_t   *key,
+                                                 _Inout_ sai_attribute_value_t *value,
+                                                 _In_ uint32_t                  attr_index,
+                                                 _Inout_ vendor_cache_t        *cache,
+                                                 void                          *arg);
+sai_status_t stub_scheduler_group_attr_set(_In_ const sai_object_key_t      *key,
+                                           _In_ const sai_attribute_value_t *value,
+                                           void                             *arg);
+
+static const sai_vendor_attribute_entry_t scheduler_group_vendor_attribs[] = {
+    { SAI_SCHEDULER_GROUP_ATTR_CHILD_COUNT,
+      { false, false, false, true },
+      { false, false, false, true },
+      stub_scheduler_group_attr_get, (void*)SAI_SCHEDULER_GROUP_ATTR_CHILD_COUNT,
+      NULL, NULL },
+    { SAI_SCHEDULER_GROUP_ATTR_CHILD_LIST,
+      { false, false, false, true },
+      { false, false, false, true },
+      stub_scheduler_group_child_list_get, NULL,
+      NULL, NULL },
+    { SAI_SCHEDULER_GROUP_ATTR_PORT_ID,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_scheduler_group_attr_get, (void*)SAI_SCHEDULER_GROUP_ATTR_PORT_ID,
+      NULL, NULL },
+    { SAI_SCHEDULER_GROUP_ATTR_LEVEL,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_scheduler_group_attr_get, (void*)SAI_SCHEDULER_GROUP_ATTR_LEVEL,
+      NULL, NULL },
+    { SAI_SCHEDULER_GROUP_ATTR_MAX_CHILDS,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_scheduler_group_attr_get, (void*)SAI_SCHEDULER_GROUP_ATTR_MAX_CHILDS,
+      NULL, NULL },
+    { SAI_SCHEDULER_GROUP_ATTR_SCHEDULER_PROFILE_ID,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_scheduler_group_attr_get, (void*)SAI_SCHEDULER_GROUP_ATTR_SCHEDULER_PROFILE_ID,
+      stub_scheduler_group_attr_set, (void*)SAI_SCHEDULER_GROUP_ATTR_SCHEDULER_PROFILE_ID },
+    { SAI_SCHEDULER_GROUP_ATTR_PARENT_NODE,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_scheduler_group_attr_get, (void*)SAI_SCHEDULER_GROUP_ATTR_PARENT_NODE,
+      stub_scheduler_group_attr_set, (void*)SAI_SCHEDULER_GROUP_ATTR_PARENT_NODE },
+};
+
+/* State DB *************/
+#define MAX_SCHEDULER_GROUP_NUMBER 2048
+#define SCHEDULER_GROUP_NONE       0xFFFFFFFF
+
+typedef struct _stub_scheduler_group_t {
+    sai_object_id_t group;
+    uint32_t        port_id;
+    sai_object_id_t port;
+    uint8_t         level;
+    uint8_t         max_childs;
+    uint32_t        child_count;
+    sai_object_id_t scheduler_profile;
+    sai_object_id_t parent;
+    bool            is_valid;
+} stub_scheduler_group_t;
+
+static stub_scheduler_group_t scheduler_group_db[MAX_SCHEDULER_GROUP_NUMBER];
+
+static sai_status_t db_get_scheduler_group(_In_ uint32_t group_id, _Out_ stub_scheduler_group_t **group)
+{
+    if ((group_id >= MAX_SCHEDULER_GROUP_NUMBER) || (!scheduler_group_db[group_id].is_valid)) {
+        STUB_LOG_ERR("Invalid scheduler group ID %u\n", group_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *group = &scheduler_group_db[group_id];
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t db_find_free_scheduler_group_index(_Out_ uint32_t *free_index)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < MAX_SCHEDULER_GROUP_NUMBER; ii++) {
+        if (false == scheduler_group_db[ii].is_valid) {
+            *free_index = ii;
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+
+    STUB_LOG_ERR("Scheduler group table full\n");
+    return SAI_STATUS_TABLE_FULL;
+}
+
+/*
+ * Attach a queue or a group as child of a scheduler group, or detach it.
+ * The group must be on the same port as the child, and below its max
+ * childs. A group is not removed while it has children.
+ */
+sai_status_t db_scheduler_group_attach(_In_ sai_object_id_t group, _In_ uint32_t port_id, _In_ bool add)
+{
+    stub_scheduler_group_t *parent;
+    sai_status_t            status;
+    uint32_t                group_id;
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(group, SAI_OBJECT_TYPE_SCHEDULER_GROUP, &group_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_scheduler_group(group_id, &parent))) {
+        return status;
+    }
+
+    if (!add) {
+        assert(parent->child_count > 0);
+        parent->child_count--;
+        return SAI_STATUS_SUCCESS;
+    }
+
+    if (parent->port_id != port_id) {
+        STUB_LOG_ERR("Scheduler group ID %u is on port %u, not on port %u\n", group_id, parent->port_id, port_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (parent->child_count >= parent->max_childs) {
+        STUB_LOG_ERR("Scheduler group ID %u has max %u childs\n", group_id, parent->max_childs);
+        return SAI_STATUS_TABLE_FULL;
+    }
+
+    parent->child_count++;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t db_scheduler_group_port_groups_get(_In_ uint32_t    port_id,
+                                                _Out_ uint32_t  *group_ids,
+                                                _Inout_ uint32_t *count)
+{
+    uint32_t ii, found = 0;
+
+    for (ii = 0; ii < MAX_SCHEDULER_GROUP_NUMBER; ii++) {
+        if ((!scheduler_group_db[ii].is_valid) || (scheduler_group_db[ii].port_id != port_id)) {
+            continue;
+        }
+        if (found == *count) {
+            return SAI_STATUS_BUFFER_OVERFLOW;
+        }
+        group_ids[found++] = ii;
+    }
+
+    *count = found;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+sai_status_t db_scheduler_group_info_get(_In_ uint32_t          group_id,
+                                         _Out_ sai_object_id_t *parent,
+                                         _Out_ sai_object_id_t *scheduler_profile)
+{
+    stub_scheduler_group_t *group;
+    sai_status_t            status;
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_scheduler_group(group_id, &group))) {
+        return status;
+    }
+
+    *parent            = group->parent;
+    *scheduler_profile = group->scheduler_profile;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*************************/
+
+static void scheduler_group_key_to_str(_In_ sai_object_id_t group_id, _Out_ char *key_str)
+{
+    uint32_t groupid;
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(group_id, SAI_OBJECT_TYPE_SCHEDULER_GROUP, &groupid)) {
+        snprintf(key_str, MAX_KEY_STR_LEN, "invalid scheduler group id");
+    } else {
+        snprintf(key_str, MAX_KEY_STR_LEN, "scheduler group id %u", groupid);
+    }
+}
+
+/* Level 0 groups hang from their port, others from a group of the level above on the same port */
+static sai_status_t scheduler_group_parent_check(_In_ const stub_scheduler_group_t *group,
+                                                 _In_ sai_object_id_t               parent)
+{
+    stub_scheduler_group_t *parent_group;
+    sai_status_t            status;
+    uint32_t                parent_id;
+
+    if (0 == group->level) {
+        if (parent != group->port) {
+            STUB_LOG_ERR("Level 0 scheduler group parent must be its port\n");
+            return SAI_STATUS_INVALID_PARAMETER;
+        }
+        return SAI_STATUS_SUCCESS;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_object_to_type(parent, SAI_OBJECT_TYPE_SCHEDULER_GROUP, &parent_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_scheduler_group(parent_id, &parent_group))) {
+        return status;
+    }
+
+    if (parent_group->level + 1 != group->level) {
+        STUB_LOG_ERR("Scheduler group level %u parent level is %u\n", group->level, parent_group->level);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t scheduler_group_profile_attach(_Inout_ stub_scheduler_group_t *group,
+                                                   _In_ sai_object_id_t            scheduler_profile)
+{
+    sai_status_t status;
+    uint32_t     scheduler_id, old_id;
+
+    if (SAI_NULL_OBJECT_ID != scheduler_profile) {
+        if (SAI_STATUS_SUCCESS !=
+            (status = stub_object_to_type(scheduler_profile, SAI_OBJECT_TYPE_SCHEDULER, &scheduler_id))) {
+            return status;
+        }
+        if (SAI_STATUS_SUCCESS != (status = db_scheduler_ref(scheduler_id, true))) {
+            return status;
+        }
+    }
+
+    if ((SAI_NULL_OBJECT_ID != group->scheduler_profile) &&
+        (SAI_STATUS_SUCCESS == stub_object_to_type(group->scheduler_profile, SAI_OBJECT_TYPE_SCHEDULER, &old_id))) {
+        db_scheduler_ref(old_id, false);
+    }
+
+    group->scheduler_profile = scheduler_profile;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Create scheduler group
+ *
+ * Arguments:
+ *    [out] scheduler_group_id - scheduler group id
+ *    [in] switch_id - switch id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_scheduler_group(_Out_ sai_object_id_t      *scheduler_group_id,
+                                         _In_ sai_object_id_t        switch_id,
+                                         _In_ uint32_t               attr_count,
+                                         _In_ const sai_attribute_t *attr_list)
+{
+    sai_status_t                 status;
+    const sai_attribute_value_t *port, *level, *max_childs, *profile, *parent;
+    uint32_t                     port_index, level_index, max_childs_index, profile_index, parent_index;
+    uint32_t                     db_id = 0;
+    stub_scheduler_group_t       group;
+    char                         list_str[MAX_LIST_VALUE_STR_LEN];
+    char                         key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == scheduler_group_id) {
+        STUB_LOG_ERR("NULL scheduler group id param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = check_attribs_metadata(attr_count, attr_list, scheduler_group_attribs,
+                                         scheduler_group_vendor_attribs, SAI_OPERATION_CREATE))) {
+        STUB_LOG_ERR("Failed attribs check\n");
+        return status;
+    }
+
+    sai_attr_list_to_str(attr_count, attr_list, scheduler_group_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create scheduler group, %s\n", list_str);
+
+    status = find_attrib_in_list(attr_count, attr_list, SAI_SCHEDULER_GROUP_ATTR_PORT_ID, &port, &port_index);
+    assert(SAI_STATUS_SUCCESS == status);
+    status = find_attrib_in_list(attr_count, attr_list, SAI_SCHEDULER_GROUP_ATTR_LEVEL, &level, &level_index);
+    assert(SAI_STATUS_SUCCESS == status);
+    status = find_attrib_in_list(attr_count, attr_list, SAI_SCHEDULER_GROUP_ATTR_MAX_CHILDS, &max_childs,
+                                 &max_childs_index);
+    assert(SAI_STATUS_SUCCESS == status);
+    status = find_attrib_in_list(attr_count, attr_list, SAI_SCHEDULER_GROUP_ATTR_SCHEDULER_PROFILE_ID, &profile,
+                                 &profile_index);
+    assert(SAI_STATUS_SUCCESS == status);
+    status = find_attrib_in_list(attr_count, attr_list, SAI_SCHEDULER_GROUP_ATTR_PARENT_NODE, &parent,
+                                 &parent_index);
+    assert(SAI_STATUS_SUCCESS == status);
+
+    memset(&group, 0, sizeof(group));
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(port->oid, SAI_OBJECT_TYPE_PORT, &group.port_id))) {
+        return status;
+    }
+
+    if (group.port_id >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid scheduler group port %u\n", group.port_id);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + port_index;
+    }
+
+    if (level->u8 >= SCHEDULER_GROUP_MAX_LEVELS) {
+        STUB_LOG_ERR("Invalid scheduler group level %u\n", level->u8);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + level_index;
+    }
+
+    if ((0 == max_childs->u8) || (max_childs->u8 > SCHEDULER_GROUP_MAX_CHILDS)) {
+        STUB_LOG_ERR("Invalid scheduler group max childs %u\n", max_childs->u8);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + max_childs_index;
+    }
+
+    group.port       = port->oid;
+    group.level      = level->u8;
+    group.max_childs = max_childs->u8;
+
+    if (SAI_STATUS_SUCCESS != (status = scheduler_group_parent_check(&group, parent->oid))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_find_free_scheduler_group_index(&db_id))) {
+        return status;
+    }
+
+    if ((0 != group.level) &&
+        (SAI_STATUS_SUCCESS != (status = db_scheduler_group_attach(parent->oid, group.port_id, true)))) {
+        return status;
+    }
+    group.parent = parent->oid;
+
+    if (SAI_STATUS_SUCCESS != (status = scheduler_group_profile_attach(&group, profile->oid))) {
+        if (0 != group.level) {
+            db_scheduler_group_attach(parent->oid, group.port_id, false);
+        }
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_create_object(SAI_OBJECT_TYPE_SCHEDULER_GROUP, db_id, scheduler_group_id))) {
+        scheduler_group_profile_attach(&group, SAI_NULL_OBJECT_ID);
+        if (0 != group.level) {
+            db_scheduler_group_attach(parent->oid, group.port_id, false);
+        }
+        return status;
+    }
+
+    group.group                = *scheduler_group_id;
+    group.is_valid             = true;
+    scheduler_group_db[db_id] = group;
+    db_hqos_invalidate();
+
+    scheduler_group_key_to_str(*scheduler_group_id, key_str);
+    STUB_LOG_NTC("Created scheduler group %s\n", key_str);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Remove scheduler group
+ *
+ * Arguments:
+ *    [in] scheduler_group_id - scheduler group id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_scheduler_group(_In_ sai_object_id_t scheduler_group_id)
+{
+    char                    key_str[MAX_KEY_STR_LEN];
+    sai_status_t            status;
+    uint32_t                db_id;
+    stub_scheduler_group_t *group;
+
+    STUB_LOG_ENTER();
+
+    scheduler_group_key_to_str(scheduler_group_id, key_str);
+    STUB_LOG_NTC("Remove scheduler group %s\n", key_str);
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_object_to_type(scheduler_group_id, SAI_OBJECT_TYPE_SCHEDULER_GROUP, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_scheduler_group(db_id, &group))) {
+        return status;
+    }
+
+    if (0 != group->child_count) {
+        STUB_LOG_ERR("Scheduler group ID %u has %u childs\n", db_id, group->child_count);
+        return SAI_STATUS_OBJECT_IN_USE;
+    }
+
+    if (0 != group->level) {
+        db_scheduler_group_attach(group->parent, group->port_id, false);
+    }
+    scheduler_group_profile_attach(group, SAI_NULL_OBJECT_ID);
+
+    group->is_valid = false;
+    db_hqos_invalidate();
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Set scheduler group attribute
+ *
+ * Arguments:
+ *    [in] scheduler_group_id - scheduler group id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_scheduler_group_attribute(_In_ sai_object_id_t        scheduler_group_id,
+                                                _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = scheduler_group_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    scheduler_group_key_to_str(scheduler_group_id, key_str);
+    return sai_set_attribute(&key, key_str, scheduler_group_attribs, scheduler_group_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get scheduler group attribute
+ *
+ * Arguments:
+ *    [in] scheduler_group_id - scheduler group id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_scheduler_group_attribute(_In_ sai_object_id_t     scheduler_group_id,
+                                                _In_ uint32_t            attr_count,
+                                                _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = scheduler_group_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    scheduler_group_key_to_str(scheduler_group_id, key_str);
+    return sai_get_attributes(&key, key_str, scheduler_group_attribs, scheduler_group_vendor_attribs, attr_count,
+                              attr_list);
+}
+
+/* Scheduler group attributes [uint32_t child count, sai_object_id_t port, uint8_t level,
+ * uint8_t max childs, sai_object_id_t profile and parent] */
+sai_status_t stub_scheduler_group_attr_get(_In_ const sai_object_key_t   *key,
+                                           _Inout_ sai_attribute_value_t *value,
+                                           _In_ uint32_t                  attr_index,
+                                           _Inout_ vendor_cache_t        *cache,
+                                           void                          *arg)
+{
+    sai_status_t            status;
+    uint32_t                db_id;
+    stub_scheduler_group_t *group;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_SCHEDULER_GROUP, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_scheduler_group(db_id, &group))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_SCHEDULER_GROUP_ATTR_CHILD_COUNT:
+        value->u32 = group->child_count;
+        break;
+
+    case SAI_SCHEDULER_GROUP_ATTR_PORT_ID:
+        value->oid = group->port;
+        break;
+
+    case SAI_SCHEDULER_GROUP_ATTR_LEVEL:
+        value->u8 = group->level;
+        break;
+
+    case SAI_SCHEDULER_GROUP_ATTR_MAX_CHILDS:
+        value->u8 = group->max_childs;
+        break;
+
+    case SAI_SCHEDULER_GROUP_ATTR_SCHEDULER_PROFILE_ID:
+        value->oid = group->scheduler_profile;
+        break;
+
+    case SAI_SCHEDULER_GROUP_ATTR_PARENT_NODE:
+        value->oid = group->parent;
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid scheduler group attribute %d\n", (int32_t)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Child queues and groups [sai_object_list_t] */
+sai_status_t stub_scheduler_group_child_list_get(_In_ const sai_object_key_t   *key,
+                                                 _Inout_ sai_attribute_value_t *value,
+                                                 _In_ uint32_t                  attr_index,
+                                                 _Inout_ vendor_cache_t        *cache,
+                                                 void                          *arg)
+{
+    sai_status_t            status;
+    uint32_t                db_id, ii, queue_count = 2 * QUEUE_MAX_INDEX, count = 0;
+    uint32_t                queue_ids[2 * QUEUE_MAX_INDEX];
+    sai_object_id_t         children[SCHEDULER_GROUP_MAX_CHILDS], parent, profile;
+    stub_scheduler_group_t *group;
+    uint8_t                 index;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_SCHEDULER_GROUP, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_scheduler_group(db_id, &group))) {
+        return status;
+    }
+
+    for (ii = 0; (ii < MAX_SCHEDULER_GROUP_NUMBER) && (count < SCHEDULER_GROUP_MAX_CHILDS); ii++) {
+        if (scheduler_group_db[ii].is_valid && (scheduler_group_db[ii].level == group->level + 1) &&
+            (scheduler_group_db[ii].parent == group->group)) {
+            children[count++] = scheduler_group_db[ii].group;
+        }
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_queue_port_queues_get(group->port_id, queue_ids, &queue_count))) {
+        return status;
+    }
+
+    for (ii = 0; (ii < queue_count) && (count < SCHEDULER_GROUP_MAX_CHILDS); ii++) {
+        if (SAI_STATUS_SUCCESS != (status = db_queue_info_get(queue_ids[ii], &index, &parent, &profile))) {
+            return status;
+        }
+        if ((parent == group->group) &&
+            (SAI_STATUS_SUCCESS != (status = stub_create_object(SAI_OBJECT_TYPE_QUEUE, queue_ids[ii],
+                                                                &children[count++])))) {
+            return status;
+        }
+    }
+
+    status = stub_fill_objlist(children, count, &value->objlist);
+
+    STUB_LOG_EXIT();
+    return status;
+}
+
+/* Scheduler group attributes [sai_object_id_t profile and parent] */
+sai_status_t stub_scheduler_group_attr_set(_In_ const sai_object_key_t      *key,
+                                           _In_ const sai_attribute_value_t *value,
+                                           void                             *arg)
+{
+    sai_status_t            status;
+    uint32_t                db_id;
+    stub_scheduler_group_t *group;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_SCHEDULER_GROUP, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_scheduler_group(db_id, &group))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_SCHEDULER_GROUP_ATTR_SCHEDULER_PROFILE_ID:
+        if (SAI_STATUS_SUCCESS != (status = scheduler_group_profile_attach(group, value->oid))) {
+            return status;
+        }
+        break;
+
+    case SAI_SCHEDULER_GROUP_ATTR_PARENT_NODE:
+        if (value->oid == group->parent) {
+            break;
+        }
+        if (SAI_STATUS_SUCCESS != (status = scheduler_group_parent_check(group, value->oid))) {
+            return status;
+        }
+        if (0 != group->level) {
+            if (SAI_STATUS_SUCCESS != (status = db_scheduler_group_attach(value->oid, group->port_id, true))) {
+                return status;
+            }
+            db_scheduler_group_attach(group->parent, group->port_id, false);
+        }
+        group->parent = value->oid;
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid scheduler group attribute %d\n", (int32_t)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    db_hqos_invalidate();
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+const sai_scheduler_group_api_t scheduler_group_api = {
+    stub_create_scheduler_group,
+    stub_remove_scheduler_group,
+    stub_set_scheduler_group_attribute,
+    stub_get_scheduler_group_attribute
+};
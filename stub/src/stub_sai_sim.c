@@ -0,0 +1,1017 @@
+/*
+ *  Copyright (C) 2014. Mellanox Technologies, Ltd. ALL RIGHTS RESERVED.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ */
+
+#include "sai.h"
+#include "stub_sai.h"
+#include "assert.h"
+#include "inttypes.h"
+#include "math.h"
+#include "pthread.h"
+#include "sched.h"
+#include "stdio.h"
+
+#undef  __MODULE__
+#define __MODULE__ SAI_SIM
+
+/*
+ * Discrete event simulation of the switch egress datapath.
+ * Traffic sources enqueue packets to the port queues, where WRED and ECN
+ * are applied, and each port drains its queues at its line rate in the
+ * order chosen by its hierarchical scheduler.
+ * Flows are received on an ingress port priority group, and admitted to
+ * its ingress buffer first. A priority group turning XOFF pauses its flows
+ * once the pause frame reached the peer, until it turns XON again.
+ * Replayed pcap packets of control protocols are punted to the CPU queues
+ * first, and only go on to their port when their trap action forwards them.
+ *
+ * Pending events are kept in a calendar queue: a ring of buckets each
+ * holding a time sorted list of the events falling in one bucket width,
+ * scanned in order from the current time. The number of buckets follows
+ * the number of pending events, and the width is resized to the average
+ * separation of the earliest events, so insertion and removal stay O(1)
+ * on average. The width is also recalibrated when removals scan too many
+ * empty buckets, as with a steady number of events it would otherwise
+ * never follow a change of the event rate.
+ */
+
+/* State DB *************/
+#define SIM_NONE                 0xFFFFFFFF
+#define SIM_MAX_EVENTS           65536
+#define SIM_MIN_BUCKETS          16
+#define SIM_MAX_BUCKETS          65536
+#define SIM_DEFAULT_BUCKET_WIDTH 1000
+#define SIM_SAMPLE_EVENTS        25
+#define SIM_SCAN_WINDOW          1024
+#define SIM_MAX_AVERAGE_SCAN     4
+#define SIM_MAX_FLOWS            4096
+#define SIM_MAX_PCAP_SOURCES     16
+/* Bytes of a pcap record kept, for its classification and for punting it */
+#define SIM_PCAP_SNAP_LENGTH     9216
+#define SIM_DEFAULT_SEED         0x9E3779B97F4A7C15ULL
+#define NS_PER_SEC               1000000000ULL
+/* Preamble, start of frame delimiter and inter frame gap */
+#define SIM_WIRE_OVERHEAD        20
+/* Pause frame propagation and peer reaction time, absorbed by the headroom */
+#define SIM_PFC_RESPONSE_NS      1000
+#define SIM_PG_NUMBER            (PORT_NUMBER * BUFFER_PG_PER_PORT)
+
+typedef enum _stub_sim_event_type_t {
+    SIM_EVENT_FLOW_ARRIVAL,
+    SIM_EVENT_PCAP_ARRIVAL,
+    SIM_EVENT_PORT_TX_DONE,
+    SIM_EVENT_PORT_WAKEUP
+} stub_sim_event_type_t;
+
+typedef struct _stub_sim_event_t {
+    uint64_t              time;
+    uint32_t              next;
+    uint32_t              object;
+    stub_sim_event_type_t type;
+} stub_sim_event_t;
+
+typedef struct _stub_sim_calendar_t {
+    uint32_t buckets[SIM_MAX_BUCKETS];
+    uint32_t bucket_count;
+    uint64_t width;
+    uint32_t last_bucket;
+    uint64_t bucket_top;
+    uint64_t last_time;
+    uint32_t event_count;
+    bool     resizing;
+    /* Buckets scanned by the last find, and by the removals of the current window */
+    uint32_t last_scan;
+    uint32_t window_scan;
+    uint32_t window_count;
+} stub_sim_calendar_t;
+
+typedef struct _stub_sim_port_t {
+    bool     busy;
+    uint64_t remainder;
+    /* Earliest pending wakeup, for a port held by its shapers */
+    uint64_t wakeup_ns;
+} stub_sim_port_t;
+
+typedef struct _stub_sim_flow_state_t {
+    stub_sim_flow_t flow;
+    uint64_t        remainder;
+    /* Next flow parked on the same paused priority group */
+    uint32_t        next_parked;
+    bool            is_valid;
+} stub_sim_flow_state_t;
+
+typedef struct _stub_sim_pg_t {
+    bool     paused;
+    /* Time the peer stops sending */
+    uint64_t pause_ns;
+    uint32_t parked;
+} stub_sim_pg_t;
+
+typedef struct _stub_sim_pcap_t {
+    FILE         *file;
+    bool          swapped;
+    bool          nanosecond;
+    uint32_t      port_id;
+    uint64_t      start_ns;
+    uint64_t      first_ns;
+    bool          first_seen;
+    uint64_t      time;
+    uint8_t       queue_index;
+    stub_packet_t packet;
+    uint32_t      captured;
+    uint8_t       data[SIM_PCAP_SNAP_LENGTH];
+} stub_sim_pcap_t;
+
+static stub_sim_event_t      sim_events[SIM_MAX_EVENTS];
+static uint32_t              sim_event_free;
+static uint32_t              sim_event_unused;
+static stub_sim_calendar_t   sim_calendar;
+static stub_sim_port_t       sim_ports[PORT_NUMBER];
+static stub_sim_flow_state_t sim_flows[SIM_MAX_FLOWS];
+static stub_sim_pg_t         sim_pgs[SIM_PG_NUMBER];
+static stub_sim_pcap_t       sim_pcaps[SIM_MAX_PCAP_SOURCES];
+static uint64_t              sim_now;
+static uint64_t              sim_random_state;
+static bool                  sim_initialized;
+/* Held while processing events, handed over between events to the threads waiting for it */
+static pthread_mutex_t       sim_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t              sim_lock_waiters;
+
+static uint64_t sim_random()
+{
+    /* xorshift64* */
+    sim_random_state ^= sim_random_state >> 12;
+    sim_random_state ^= sim_random_state << 25;
+    sim_random_state ^= sim_random_state >> 27;
+
+    return sim_random_state * 0x2545F4914F6CDD1DULL;
+}
+
+static uint32_t sim_event_alloc()
+{
+    uint32_t index;
+
+    if (SIM_NONE != sim_event_free) {
+        index          = sim_event_free;
+        sim_event_free = sim_events[index].next;
+        return index;
+    }
+
+    if (sim_event_unused < SIM_MAX_EVENTS) {
+        return sim_event_unused++;
+    }
+
+    return SIM_NONE;
+}
+
+static void sim_event_release(_In_ uint32_t index)
+{
+    sim_events[index].next = sim_event_free;
+    sim_event_free         = index;
+}
+
+static void calendar_reset(_In_ uint32_t bucket_count, _In_ uint64_t width, _In_ uint64_t start_time)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < bucket_count; ii++) {
+        sim_calendar.buckets[ii] = SIM_NONE;
+    }
+
+    sim_calendar.bucket_count = bucket_count;
+    sim_calendar.width        = width;
+    sim_calendar.last_bucket  = (start_time / width) & (bucket_count - 1);
+    sim_calendar.bucket_top   = (start_time / width + 1) * width;
+    sim_calendar.last_time    = start_time;
+    sim_calendar.event_count  = 0;
+    sim_calendar.last_scan    = 0;
+    sim_calendar.window_scan  = 0;
+    sim_calendar.window_count = 0;
+}
+
+/* Insert an event in its bucket, after the events due at the same time */
+static void calendar_link(_In_ uint32_t index)
+{
+    uint32_t *link;
+    uint64_t  time = sim_events[index].time;
+
+    link = &sim_calendar.buckets[(time / sim_calendar.width) & (sim_calendar.bucket_count - 1)];
+    while ((SIM_NONE != *link) && (sim_events[*link].time <= time)) {
+        link = &sim_events[*link].next;
+    }
+
+    sim_events[index].next = *link;
+    *link                  = index;
+    sim_calendar.event_count++;
+}
+
+/* Find the earliest event, with its bucket and the bucket top time, without removing it */
+static uint32_t calendar_find(_Out_ uint32_t *bucket, _Out_ uint64_t *top)
+{
+    uint32_t mask = sim_calendar.bucket_count - 1;
+    uint32_t ii, head, index = SIM_NONE;
+
+    if (0 == sim_calendar.event_count) {
+        return SIM_NONE;
+    }
+
+    *bucket = sim_calendar.last_bucket;
+    *top    = sim_calendar.bucket_top;
+    for (ii = 0; ii < sim_calendar.bucket_count; ii++) {
+        head = sim_calendar.buckets[*bucket];
+        if ((SIM_NONE != head) && (sim_events[head].time < *top)) {
+            sim_calendar.last_scan = ii;
+            return head;
+        }
+        *bucket = (*bucket + 1) & mask;
+        *top   += sim_calendar.width;
+    }
+
+    /* No event within a year of buckets, jump directly to the earliest one */
+    for (ii = 0; ii < sim_calendar.bucket_count; ii++) {
+        head = sim_calendar.buckets[ii];
+        if ((SIM_NONE != head) && ((SIM_NONE == index) || (sim_events[head].time < sim_events[index].time))) {
+            index   = head;
+            *bucket = ii;
+        }
+    }
+    *top                   = (sim_events[index].time / sim_calendar.width + 1) * sim_calendar.width;
+    sim_calendar.last_scan = 2 * sim_calendar.bucket_count;
+
+    return index;
+}
+
+static void calendar_resize(_In_ uint32_t bucket_count);
+
+static void calendar_unlink(_In_ uint32_t index, _In_ uint32_t bucket, _In_ uint64_t top)
+{
+    assert(sim_calendar.buckets[bucket] == index);
+
+    sim_calendar.buckets[bucket] = sim_events[index].next;
+    sim_calendar.last_bucket     = bucket;
+    sim_calendar.bucket_top      = top;
+    sim_calendar.last_time       = sim_events[index].time;
+    sim_calendar.event_count--;
+
+    if (sim_calendar.resizing) {
+        return;
+    }
+
+    if ((sim_calendar.bucket_count > SIM_MIN_BUCKETS) && (sim_calendar.event_count < sim_calendar.bucket_count / 2)) {
+        calendar_resize(sim_calendar.bucket_count / 2);
+        return;
+    }
+
+    sim_calendar.window_scan += sim_calendar.last_scan;
+    if (++sim_calendar.window_count == SIM_SCAN_WINDOW) {
+        if (sim_calendar.window_scan > SIM_MAX_AVERAGE_SCAN * SIM_SCAN_WINDOW) {
+            calendar_resize(sim_calendar.bucket_count);
+        }
+        sim_calendar.window_scan  = 0;
+        sim_calendar.window_count = 0;
+    }
+}
+
+static uint32_t calendar_pop()
+{
+    uint32_t index, bucket;
+    uint64_t top;
+
+    if (SIM_NONE != (index = calendar_find(&bucket, &top))) {
+        calendar_unlink(index, bucket, top);
+    }
+
+    return index;
+}
+
+static void calendar_insert(_In_ uint32_t index)
+{
+    assert(sim_events[index].time >= sim_calendar.last_time);
+
+    calendar_link(index);
+
+    if ((!sim_calendar.resizing) && (sim_calendar.bucket_count < SIM_MAX_BUCKETS) &&
+        (sim_calendar.event_count > 2 * sim_calendar.bucket_count)) {
+        calendar_resize(sim_calendar.bucket_count * 2);
+    }
+}
+
+/*
+ * Rebuild the calendar with a new number of buckets.
+ * The width is set to three times the average separation of the earliest
+ * events, ignoring separations more than twice the average, so that a
+ * bucket holds a few events around the current time.
+ */
+static void calendar_resize(_In_ uint32_t bucket_count)
+{
+    uint32_t samples[SIM_SAMPLE_EVENTS];
+    uint32_t sample_count = 0, ii, index, all = SIM_NONE, used = 0;
+    uint64_t last_time    = sim_calendar.last_time;
+    uint64_t width        = sim_calendar.width, average, total = 0, separation;
+
+    sim_calendar.resizing = true;
+
+    while ((sample_count < SIM_SAMPLE_EVENTS) && (SIM_NONE != (index = calendar_pop()))) {
+        samples[sample_count++] = index;
+    }
+
+    if (sample_count > 1) {
+        average = (sim_events[samples[sample_count - 1]].time - sim_events[samples[0]].time) / (sample_count - 1);
+        for (ii = 1; ii < sample_count; ii++) {
+            separation = sim_events[samples[ii]].time - sim_events[samples[ii - 1]].time;
+            if (separation <= 2 * average) {
+                total += separation;
+                used++;
+            }
+        }
+        width = (used && total) ? 3 * total / used : 1;
+        if (0 == width) {
+            width = 1;
+        }
+    }
+
+    for (ii = 0; ii < sim_calendar.bucket_count; ii++) {
+        while (SIM_NONE != (index = sim_calendar.buckets[ii])) {
+            sim_calendar.buckets[ii] = sim_events[index].next;
+            sim_events[index].next   = all;
+            all                      = index;
+        }
+    }
+
+    calendar_reset(bucket_count, width, last_time);
+
+    while (SIM_NONE != (index = all)) {
+        all = sim_events[index].next;
+        calendar_link(index);
+    }
+    for (ii = 0; ii < sample_count; ii++) {
+        calendar_link(samples[ii]);
+    }
+
+    sim_calendar.resizing = false;
+}
+
+static sai_status_t sim_schedule(_In_ uint64_t time, _In_ stub_sim_event_type_t type, _In_ uint32_t object)
+{
+    uint32_t index;
+
+    if (SIM_NONE == (index = sim_event_alloc())) {
+        STUB_LOG_ERR("Simulation event table full\n");
+        return SAI_STATUS_TABLE_FULL;
+    }
+
+    sim_events[index].time   = time;
+    sim_events[index].type   = type;
+    sim_events[index].object = object;
+    calendar_insert(index);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Start transmitting the next packet of an idle port, as chosen by the port scheduler */
+static sai_status_t sim_enqueue(_In_ uint32_t port_id, _In_ uint8_t queue_index, _Inout_ stub_packet_t *packet);
+
+/* Send the mirror copies of a packet to their monitor ports, copies carry no ingress buffer */
+static sai_status_t sim_mirror(_In_ uint32_t port_id, _In_ bool ingress, _In_ uint32_t length)
+{
+    stub_mirror_packet_t clones[MIRROR_PORT_SESSIONS];
+    stub_packet_t        packet;
+    sai_status_t         status;
+    uint32_t             count, ii;
+
+    if (SAI_STATUS_SUCCESS != (status = db_mirror_port_clone(0, port_id, ingress, NULL, length, clones, &count))) {
+        return status;
+    }
+
+    memset(&packet, 0, sizeof(packet));
+    packet.color    = SAI_PACKET_COLOR_GREEN;
+    packet.mirrored = true;
+
+    for (ii = 0; ii < count; ii++) {
+        packet.length = clones[ii].header_length + clones[ii].length;
+        if (SAI_STATUS_SUCCESS != (status = sim_enqueue(clones[ii].monitor_port_id, clones[ii].tc, &packet))) {
+            return status;
+        }
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t sim_port_transmit(_In_ uint32_t port_id)
+{
+    stub_sim_port_t *port = &sim_ports[port_id];
+    uint32_t         speed;
+    uint64_t         bits, wakeup_ns;
+    stub_packet_t    packet;
+    sai_status_t     status;
+    bool             dequeued;
+
+    port->busy = false;
+
+    if (SAI_STATUS_SUCCESS != (status = db_hqos_dequeue(port_id, sim_now, &packet, &dequeued, &wakeup_ns))) {
+        return status;
+    }
+
+    if (!dequeued) {
+        /* Traffic is held by shapers, come back when they let it through */
+        if ((UINT64_MAX != wakeup_ns) && ((0 == port->wakeup_ns) || (wakeup_ns < port->wakeup_ns))) {
+            port->wakeup_ns = wakeup_ns;
+            return sim_schedule(wakeup_ns, SIM_EVENT_PORT_WAKEUP, port_id);
+        }
+        return SAI_STATUS_SUCCESS;
+    }
+
+    /* Synthetic and replayed packets are all counted as unicast */
+    if (SAI_STATUS_SUCCESS != (status = db_port_stats_tx(0, port_id, packet.length, PORT_CAST_UNICAST))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_samplepacket_sample(port_id, false, 1, &packet.length, NULL))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_port_speed_get(port_id, &speed))) {
+        return status;
+    }
+
+    /* Speed is in Mbps, keep the remainder so that rounding doesn't drift */
+    bits            = (uint64_t)(packet.length + SIM_WIRE_OVERHEAD) * 8 * 1000 + port->remainder;
+    port->remainder = bits % speed;
+    port->busy      = true;
+
+    /* After the port is busy, so that copies mirrored to this port only queue */
+    if (!packet.mirrored && (SAI_STATUS_SUCCESS != (status = sim_mirror(port_id, false, packet.length)))) {
+        return status;
+    }
+
+    return sim_schedule(sim_now + bits / speed, SIM_EVENT_PORT_TX_DONE, port_id);
+}
+
+static sai_status_t sim_enqueue(_In_ uint32_t port_id, _In_ uint8_t queue_index, _Inout_ stub_packet_t *packet)
+{
+    sai_status_t status;
+    uint32_t     queue_id;
+    bool         accepted;
+
+    if (SAI_STATUS_SUCCESS != (status = db_queue_find(port_id, queue_index, &queue_id))) {
+        STUB_LOG_DBG("No queue %u on port %u, packet dropped\n", queue_index, port_id);
+        return db_port_stats_discard(0, port_id, false);
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_queue_enqueue(queue_id, packet, (uint32_t)sim_random(), &accepted))) {
+        return status;
+    }
+
+    if (!accepted) {
+        return db_port_stats_discard(0, port_id, false);
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_hqos_queue_backlogged(port_id, queue_id, sim_now))) {
+        return status;
+    }
+
+    if (!sim_ports[port_id].busy) {
+        return sim_port_transmit(port_id);
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Time to the next packet of a flow, constant or exponentially distributed around the flow rate */
+static uint64_t sim_flow_gap(_Inout_ stub_sim_flow_state_t *state)
+{
+    uint64_t bits, gap;
+    double   uniform;
+
+    bits             = (uint64_t)state->flow.length * 8 * NS_PER_SEC + state->remainder;
+    gap              = bits / state->flow.rate_bps;
+    state->remainder = bits % state->flow.rate_bps;
+
+    if (state->flow.poisson) {
+        uniform = ((sim_random() >> 11) + 1) * (1.0 / 9007199254740992.0);
+        gap     = (uint64_t)(-log(uniform) * (double)gap);
+    }
+
+    return gap;
+}
+
+static sai_status_t sim_flow_arrival(_In_ uint32_t flow_id)
+{
+    stub_sim_flow_state_t *state = &sim_flows[flow_id];
+    stub_sim_pg_t         *pg;
+    stub_packet_t          packet;
+    sai_status_t           status;
+    uint64_t               next;
+    bool                   admitted, xoff;
+
+    if ((0 != state->flow.stop_ns) && (sim_now >= state->flow.stop_ns)) {
+        state->is_valid = false;
+        return SAI_STATUS_SUCCESS;
+    }
+
+    pg = &sim_pgs[state->flow.ingress_port_id * BUFFER_PG_PER_PORT + state->flow.priority_group];
+    if (pg->paused && (sim_now >= pg->pause_ns)) {
+        state->next_parked = pg->parked;
+        pg->parked         = flow_id;
+        return SAI_STATUS_SUCCESS;
+    }
+
+    packet.length      = state->flow.length;
+    packet.color       = state->flow.color;
+    packet.ecn_capable = state->flow.ecn_capable;
+    packet.ecn_marked  = false;
+    packet.mirrored    = false;
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = db_port_stats_rx(0, state->flow.ingress_port_id, packet.length, PORT_CAST_UNICAST))) {
+        return status;
+    }
+
+    /* Synthetic packets have no bytes, their samples and mirror copies only carry the length */
+    if (SAI_STATUS_SUCCESS != (status = db_samplepacket_sample(state->flow.ingress_port_id, true, 1, &packet.length,
+                                                               NULL))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = sim_mirror(state->flow.ingress_port_id, true, packet.length))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = db_buffer_ingress_admit(state->flow.ingress_port_id, state->flow.priority_group, &packet,
+                                          &admitted, &xoff))) {
+        return status;
+    }
+
+    if (xoff) {
+        pg->paused   = true;
+        pg->pause_ns = sim_now + SIM_PFC_RESPONSE_NS;
+    }
+
+    if (!admitted && (SAI_STATUS_SUCCESS != (status = db_port_stats_discard(0, state->flow.ingress_port_id, true)))) {
+        return status;
+    }
+
+    if (admitted &&
+        (SAI_STATUS_SUCCESS != (status = sim_enqueue(state->flow.port_id, state->flow.queue_index, &packet)))) {
+        return status;
+    }
+
+    next = sim_now + sim_flow_gap(state);
+    if ((0 != state->flow.stop_ns) && (next >= state->flow.stop_ns)) {
+        state->is_valid = false;
+        return SAI_STATUS_SUCCESS;
+    }
+
+    return sim_schedule(next, SIM_EVENT_FLOW_ARRIVAL, flow_id);
+}
+
+/* Resume the flows parked on the priority groups which went back to XON */
+static sai_status_t sim_pfc_resume()
+{
+    stub_sim_pg_t *pg;
+    sai_status_t   status;
+    uint32_t       port_id, flow_id;
+    uint8_t        pg_index;
+
+    while (db_buffer_xon_pop(&port_id, &pg_index)) {
+        pg         = &sim_pgs[port_id * BUFFER_PG_PER_PORT + pg_index];
+        pg->paused = false;
+        while (SIM_NONE != (flow_id = pg->parked)) {
+            pg->parked = sim_flows[flow_id].next_parked;
+            if (SAI_STATUS_SUCCESS != (status = sim_schedule(sim_now, SIM_EVENT_FLOW_ARRIVAL, flow_id))) {
+                return status;
+            }
+        }
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static uint32_t pcap_u32(_In_ const stub_sim_pcap_t *source, _In_ const uint8_t *data)
+{
+    if (source->swapped) {
+        return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | data[3];
+    }
+
+    return ((uint32_t)data[3] << 24) | ((uint32_t)data[2] << 16) | ((uint32_t)data[1] << 8) | data[0];
+}
+
+/*
+ * Read the next pcap record of a source, up to SIM_PCAP_SNAP_LENGTH bytes.
+ * The queue index is the DSCP class selector and the ECN bits tell ECN
+ * capable and marked packets apart. Non IP packets go to queue 0. Replayed
+ * packets aren't received on an ingress port, so they don't take ingress
+ * buffer.
+ */
+static bool pcap_read(_Inout_ stub_sim_pcap_t *source)
+{
+    uint8_t *data = source->data, record[16];
+    uint32_t captured, length, read, l3 = 14, tos = 0;
+    uint16_t ethertype;
+    uint64_t timestamp;
+
+    if (1 != fread(record, sizeof(record), 1, source->file)) {
+        return false;
+    }
+
+    captured = pcap_u32(source, record + 8);
+    length   = pcap_u32(source, record + 12);
+    read     = (captured < sizeof(source->data)) ? captured : sizeof(source->data);
+
+    if ((read != fread(data, 1, read, source->file)) ||
+        ((captured > read) && (0 != fseek(source->file, captured - read, SEEK_CUR)))) {
+        return false;
+    }
+
+    timestamp = (uint64_t)pcap_u32(source, record) * NS_PER_SEC +
+                (uint64_t)pcap_u32(source, record + 4) * (source->nanosecond ? 1 : 1000);
+    if (!source->first_seen) {
+        source->first_ns   = timestamp;
+        source->first_seen = true;
+    }
+    source->time = source->start_ns + ((timestamp > source->first_ns) ? timestamp - source->first_ns : 0);
+    if (source->time < sim_now) {
+        source->time = sim_now;
+    }
+
+    ethertype = (read >= 14) ? ((data[12] << 8) | data[13]) : 0;
+    if (((0x8100 == ethertype) || (0x88A8 == ethertype)) && (read >= 18)) {
+        ethertype = (data[16] << 8) | data[17];
+        l3        = 18;
+    }
+
+    if ((0x0800 == ethertype) && (read >= l3 + 2)) {
+        tos = data[l3 + 1];
+    } else if ((0x86DD == ethertype) && (read >= l3 + 2)) {
+        tos = ((data[l3] & 0x0F) << 4) | (data[l3 + 1] >> 4);
+    }
+
+    source->captured           = read;
+    source->queue_index        = (tos >> 5) % QUEUE_MAX_INDEX;
+    source->packet.length      = length;
+    source->packet.color       = SAI_PACKET_COLOR_GREEN;
+    source->packet.ecn_capable = (0 != (tos & 0x3));
+    source->packet.ecn_marked  = (0x3 == (tos & 0x3));
+
+    return true;
+}
+
+static void pcap_close(_Inout_ stub_sim_pcap_t *source)
+{
+    fclose(source->file);
+    source->file = NULL;
+}
+
+/*
+ * Punt a replayed packet of a control protocol to the CPU, from the core of
+ * the simulator, as its trap says. trapped tells the packets which don't go
+ * on to the port, trapped or dropped.
+ */
+static sai_status_t sim_pcap_trap(_In_ const stub_sim_pcap_t *source, _Out_ bool *trapped)
+{
+    stub_trap_packet_t  packet;
+    sai_packet_action_t action;
+    sai_status_t        status;
+
+    *trapped = false;
+
+    if (!db_trap_classify(source->data, source->captured, &packet.trap_id)) {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_trap_action_get(packet.trap_id, &action))) {
+        return status;
+    }
+
+    *trapped = (SAI_PACKET_ACTION_TRAP == action) || (SAI_PACKET_ACTION_DROP == action) ||
+               (SAI_PACKET_ACTION_DENY == action);
+
+    if ((SAI_PACKET_ACTION_TRAP != action) && (SAI_PACKET_ACTION_LOG != action) &&
+        (SAI_PACKET_ACTION_COPY != action)) {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_mirror_buf_alloc(source->captured, &packet.buf))) {
+        return status;
+    }
+
+    memcpy(packet.buf->data, source->data, source->captured);
+    packet.port_id = source->port_id;
+    packet.length  = source->captured;
+
+    status = db_trap_punt(0, sim_now, 1, &packet, NULL);
+    db_mirror_buf_release(packet.buf);
+
+    return status;
+}
+
+static sai_status_t sim_pcap_arrival(_In_ uint32_t source_id)
+{
+    stub_sim_pcap_t *source = &sim_pcaps[source_id];
+    sai_status_t     status;
+    bool             trapped;
+
+    if (SAI_STATUS_SUCCESS != (status = sim_pcap_trap(source, &trapped))) {
+        return status;
+    }
+
+    if (!trapped &&
+        (SAI_STATUS_SUCCESS != (status = sim_enqueue(source->port_id, source->queue_index, &source->packet)))) {
+        return status;
+    }
+
+    if (!pcap_read(source)) {
+        pcap_close(source);
+        return SAI_STATUS_SUCCESS;
+    }
+
+    return sim_schedule(source->time, SIM_EVENT_PCAP_ARRIVAL, source_id);
+}
+
+static void sim_init()
+{
+    if (!sim_initialized) {
+        db_sim_reset(0);
+    }
+}
+
+/* Drop all sources and pending events and restart the clock, queued packets are kept */
+void db_sim_reset(_In_ uint64_t seed)
+{
+    uint32_t ii, port_id;
+    uint8_t  pg_index;
+
+    for (ii = 0; ii < SIM_MAX_PCAP_SOURCES; ii++) {
+        if (NULL != sim_pcaps[ii].file) {
+            pcap_close(&sim_pcaps[ii]);
+        }
+    }
+
+    memset(sim_flows, 0, sizeof(sim_flows));
+    memset(sim_ports, 0, sizeof(sim_ports));
+    memset(sim_pgs, 0, sizeof(sim_pgs));
+    for (ii = 0; ii < SIM_PG_NUMBER; ii++) {
+        sim_pgs[ii].parked = SIM_NONE;
+    }
+    while (db_buffer_xon_pop(&port_id, &pg_index)) {
+    }
+
+    sim_event_free   = SIM_NONE;
+    sim_event_unused = 0;
+    calendar_reset(SIM_MIN_BUCKETS, SIM_DEFAULT_BUCKET_WIDTH, 0);
+    sim_calendar.resizing = false;
+
+    sim_now          = 0;
+    sim_random_state = seed ? seed : SIM_DEFAULT_SEED;
+    sim_initialized  = true;
+
+    /* Shaper and timer state is kept in simulation time */
+    db_hqos_invalidate();
+}
+
+uint64_t db_sim_now()
+{
+    return sim_now;
+}
+
+/* Add a synthetic traffic flow, starting at its start time or now if later */
+sai_status_t db_sim_flow_add(_In_ const stub_sim_flow_t *flow, _Out_ uint32_t *flow_id)
+{
+    sai_status_t status;
+    uint32_t     ii;
+
+    sim_init();
+
+    if ((flow->port_id >= PORT_NUMBER) || (flow->queue_index >= QUEUE_MAX_INDEX) || (0 == flow->rate_bps) ||
+        (0 == flow->length) || (flow->color > SAI_PACKET_COLOR_RED) || (flow->ingress_port_id >= PORT_NUMBER) ||
+        (flow->priority_group >= BUFFER_PG_PER_PORT)) {
+        STUB_LOG_ERR("Invalid flow port %u queue %u rate %" PRIu64 " length %u color %d ingress port %u pg %u\n",
+                     flow->port_id, flow->queue_index, flow->rate_bps, flow->length, flow->color,
+                     flow->ingress_port_id, flow->priority_group);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    for (ii = 0; ii < SIM_MAX_FLOWS; ii++) {
+        if (!sim_flows[ii].is_valid) {
+            break;
+        }
+    }
+
+    if (SIM_MAX_FLOWS == ii) {
+        STUB_LOG_ERR("Simulation flow table full\n");
+        return SAI_STATUS_TABLE_FULL;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = sim_schedule((flow->start_ns > sim_now) ? flow->start_ns : sim_now, SIM_EVENT_FLOW_ARRIVAL, ii))) {
+        return status;
+    }
+
+    sim_flows[ii].flow      = *flow;
+    sim_flows[ii].remainder = 0;
+    sim_flows[ii].is_valid  = true;
+    *flow_id                = ii;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Replay an Ethernet pcap file on a port, its first packet arriving at the start time */
+sai_status_t db_sim_pcap_add(_In_ const char *path, _In_ uint32_t port_id, _In_ uint64_t start_ns)
+{
+    stub_sim_pcap_t *source;
+    uint8_t          header[24];
+    uint32_t         ii, magic;
+    sai_status_t     status;
+
+    sim_init();
+
+    if (port_id >= PORT_NUMBER) {
+        STUB_LOG_ERR("Invalid port %u\n", port_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    for (ii = 0; ii < SIM_MAX_PCAP_SOURCES; ii++) {
+        if (NULL == sim_pcaps[ii].file) {
+            break;
+        }
+    }
+
+    if (SIM_MAX_PCAP_SOURCES == ii) {
+        STUB_LOG_ERR("Simulation pcap table full\n");
+        return SAI_STATUS_TABLE_FULL;
+    }
+
+    source = &sim_pcaps[ii];
+    memset(source, 0, sizeof(*source));
+
+    if (NULL == (source->file = fopen(path, "rb"))) {
+        STUB_LOG_ERR("Failed to open pcap file %s\n", path);
+        return SAI_STATUS_FAILURE;
+    }
+
+    if (1 != fread(header, sizeof(header), 1, source->file)) {
+        STUB_LOG_ERR("Failed to read pcap file %s header\n", path);
+        pcap_close(source);
+        return SAI_STATUS_FAILURE;
+    }
+
+    magic = ((uint32_t)header[3] << 24) | ((uint32_t)header[2] << 16) | ((uint32_t)header[1] << 8) | header[0];
+    switch (magic) {
+    case 0xA1B2C3D4:
+        break;
+
+    case 0xA1B23C4D:
+        source->nanosecond = true;
+        break;
+
+    case 0xD4C3B2A1:
+        source->swapped = true;
+        break;
+
+    case 0x4D3CB2A1:
+        source->swapped    = true;
+        source->nanosecond = true;
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid pcap file %s magic %x\n", path, magic);
+        pcap_close(source);
+        return SAI_STATUS_FAILURE;
+    }
+
+    /* Link type 1 is Ethernet */
+    if (1 != pcap_u32(source, header + 20)) {
+        STUB_LOG_ERR("Unsupported pcap file %s link type %u\n", path, pcap_u32(source, header + 20));
+        pcap_close(source);
+        return SAI_STATUS_NOT_SUPPORTED;
+    }
+
+    source->port_id  = port_id;
+    source->start_ns = (start_ns > sim_now) ? start_ns : sim_now;
+
+    if (!pcap_read(source)) {
+        pcap_close(source);
+        return SAI_STATUS_SUCCESS;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = sim_schedule(source->time, SIM_EVENT_PCAP_ARRIVAL, ii))) {
+        pcap_close(source);
+        return status;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Let the threads waiting for the simulator lock take it, as a mutex released
+ * and taken again right away would most likely be taken by the simulator.
+ */
+static void sim_lock_yield()
+{
+    if (0 == __atomic_load_n(&sim_lock_waiters, __ATOMIC_RELAXED)) {
+        return;
+    }
+
+    pthread_mutex_unlock(&sim_lock);
+    while (0 != __atomic_load_n(&sim_lock_waiters, __ATOMIC_ACQUIRE)) {
+        sched_yield();
+    }
+    pthread_mutex_lock(&sim_lock);
+}
+
+static sai_status_t sim_run(_In_ uint64_t until_ns, _Out_ uint64_t *event_count)
+{
+    sai_status_t     status;
+    stub_sim_event_t event;
+    uint32_t         index, bucket;
+    uint64_t         top;
+
+    *event_count = 0;
+
+    while ((SIM_NONE != (index = calendar_find(&bucket, &top))) && (sim_events[index].time <= until_ns)) {
+        assert(sim_events[index].time >= sim_now);
+        calendar_unlink(index, bucket, top);
+        event = sim_events[index];
+        sim_event_release(index);
+        sim_now = event.time;
+        (*event_count)++;
+
+        switch (event.type) {
+        case SIM_EVENT_FLOW_ARRIVAL:
+            status = sim_flow_arrival(event.object);
+            break;
+
+        case SIM_EVENT_PCAP_ARRIVAL:
+            status = sim_pcap_arrival(event.object);
+            break;
+
+        case SIM_EVENT_PORT_TX_DONE:
+            status = sim_port_transmit(event.object);
+            break;
+
+        case SIM_EVENT_PORT_WAKEUP:
+            if (event.time == sim_ports[event.object].wakeup_ns) {
+                sim_ports[event.object].wakeup_ns = 0;
+            }
+            status = sim_ports[event.object].busy ? SAI_STATUS_SUCCESS : sim_port_transmit(event.object);
+            break;
+
+        default:
+            STUB_LOG_ERR("Invalid simulation event type %d\n", event.type);
+            return SAI_STATUS_FAILURE;
+        }
+
+        if ((SAI_STATUS_SUCCESS != status) || (SAI_STATUS_SUCCESS != (status = sim_pfc_resume()))) {
+            return status;
+        }
+
+        sim_lock_yield();
+    }
+
+    if (until_ns > sim_now) {
+        sim_now = until_ns;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Process the events due until the given time, and move the clock to it */
+sai_status_t db_sim_run(_In_ uint64_t until_ns, _Out_ uint64_t *event_count)
+{
+    sai_status_t status;
+
+    sim_init();
+
+    pthread_mutex_lock(&sim_lock);
+    status = sim_run(until_ns, event_count);
+    pthread_mutex_unlock(&sim_lock);
+
+    return status;
+}
+
+void db_sim_lock()
+{
+    __atomic_add_fetch(&sim_lock_waiters, 1, __ATOMIC_RELAXED);
+    pthread_mutex_lock(&sim_lock);
+    __atomic_sub_fetch(&sim_lock_waiters, 1, __ATOMIC_RELEASE);
+}
+
+void db_sim_unlock()
+{
+    pthread_mutex_unlock(&sim_lock);
+}
+/*************************/
@@ -0,0 +1,811 @@
+/*
+ *  Copyright (C) 2014. Mellanox Technologies, Ltd. ALL RIGHTS RESERVED.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ */
+
+#include "sai.h"
+#include "stub_sai.h"
+#include "assert.h"
+#include "inttypes.h"
+
+#undef  __MODULE__
+#define __MODULE__ SAI_STP
+
+static const sai_attribute_entry_t stp_attribs[] = {
+    { SAI_STP_ATTR_VLAN_LIST, false, false, false, true,
+      "STP VLAN list", SAI_ATTR_VAL_TYPE_VLANLIST },
+    { SAI_STP_ATTR_PORT_LIST, false, false, false, true,
+      "STP port list", SAI_ATTR_VAL_TYPE_OBJLIST },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+static const sai_attribute_entry_t stp_port_attribs[] = {
+    { SAI_STP_PORT_ATTR_STP, true, true, false, true,
+      "STP port STP ID", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_STP_PORT_ATTR_PORT, true, true, false, true,
+      "STP port port ID", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_STP_PORT_ATTR_STATE, true, true, true, true,
+      "STP port state", SAI_ATTR_VAL_TYPE_S32 },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+sai_status_t stub_stp_attr_get(_In_ const sai_object_key_t   *key,
+                               _Inout_ sai_attribute_value_t *value,
+                               _In_ uint32_t                  attr_index,
+                               _Inout_ vendor_cache_t        *cache,
+                               void                          *arg);
+sai_status_t stub_stp_port_attr_get(_In_ const sai_object_key_t   *key,
+                                    _Inout_ sai_attribute_value_t *value,
+                                    _In_ uint32_t                  attr_index,
+                                    _Inout_ vendor_cache_t        *cache,
+                                    void                          *arg);
+sai_status_t stub_stp_port_state_set(_In_ const sai_object_key_t      *key,
+                                     _In_ const sai_attribute_value_t *value,
+                                     void                             *arg);
+
+static const sai_vendor_attribute_entry_t stp_vendor_attribs[] = {
+    { SAI_STP_ATTR_VLAN_LIST,
+      { false, false, false, true },
+      { false, false, false, true },
+      stub_stp_attr_get, (void*)SAI_STP_ATTR_VLAN_LIST,
+      NULL, NULL },
+    { SAI_STP_ATTR_PORT_LIST,
+      { false, false, false, true },
+      { false, false, false, true },
+      stub_stp_attr_get, (void*)SAI_STP_ATTR_PORT_LIST,
+      NULL, NULL },
+};
+
+static const sai_vendor_attribute_entry_t stp_port_vendor_attribs[] = {
+    { SAI_STP_PORT_ATTR_STP,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_stp_port_attr_get, (void*)SAI_STP_PORT_ATTR_STP,
+      NULL, NULL },
+    { SAI_STP_PORT_ATTR_PORT,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_stp_port_attr_get, (void*)SAI_STP_PORT_ATTR_PORT,
+      NULL, NULL },
+    { SAI_STP_PORT_ATTR_STATE,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_stp_port_attr_get, (void*)SAI_STP_PORT_ATTR_STATE,
+      stub_stp_port_state_set, NULL },
+};
+
+/* State DB *************/
+
+/*
+ * VLANs map to their instance through a direct array, and each instance
+ * keeps its port states packed 2 bits per port: the low bit set when the
+ * port learns, the high bit when it forwards. Checking whether a port
+ * forwards in a VLAN is then one array load and one mask, and a state
+ * change applies to all the VLANs of the instance with a single word store.
+ *
+ * The instance also keeps its VLANs as a bitmap, so a port leaving the
+ * learning or forwarding state flushes its FDB entries in all of them with
+ * a single call, whatever the number of VLANs.
+ *
+ * Instance 0 is the default instance, of all the VLANs not moved elsewhere.
+ * Its ports forward unless set otherwise, ports of other instances block.
+ */
+#define MAX_STP_NUMBER         64
+#define STP_VLAN_NUMBER        4096
+#define STP_VLAN_WORDS         (STP_VLAN_NUMBER / 64)
+#define STP_PORT_STATE_BITS    2
+#define STP_PORTS_PER_WORD     (64 / STP_PORT_STATE_BITS)
+#define STP_STATE_WORDS        ((PORT_NUMBER + STP_PORTS_PER_WORD - 1) / STP_PORTS_PER_WORD)
+#define STP_STATE_LEARN        1ULL
+#define STP_STATE_FORWARD      2ULL
+#define STP_STATE_MASK         3ULL
+/* Every port forwarding */
+#define STP_STATES_FORWARDING  0xFFFFFFFFFFFFFFFFULL
+
+#if PORT_NUMBER > 64
+#error "STP port bitmap too small for the ports"
+#endif
+
+typedef struct _stub_stp_t {
+    /* 2 bits per port */
+    uint64_t states[STP_STATE_WORDS];
+    /* Ports with an STP port object */
+    uint64_t ports;
+    uint64_t vlans[STP_VLAN_WORDS];
+    uint32_t vlan_count;
+    bool     is_valid;
+} stub_stp_t;
+
+static stub_stp_t stp_db[MAX_STP_NUMBER] = {
+    [STP_DEFAULT_INSTANCE] = {
+        .states     = { [0 ... STP_STATE_WORDS - 1] = STP_STATES_FORWARDING },
+        /* VLAN 0 is not a VLAN */
+        .vlans      = { [0] = UINT64_MAX - 1, [1 ... STP_VLAN_WORDS - 1] = UINT64_MAX },
+        .vlan_count = STP_VLAN_NUMBER - 1,
+        .is_valid   = true
+    }
+};
+/* Instance of each VLAN */
+static uint8_t    stp_vlan_db[STP_VLAN_NUMBER];
+
+static sai_status_t db_get_stp(_In_ uint32_t stp_id, _Out_ stub_stp_t **stp)
+{
+    if ((stp_id >= MAX_STP_NUMBER) || (!stp_db[stp_id].is_valid)) {
+        STUB_LOG_ERR("Invalid STP ID %u\n", stp_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *stp = &stp_db[stp_id];
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t db_find_free_stp_index(_Out_ uint32_t *free_index)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < MAX_STP_NUMBER; ii++) {
+        if (false == stp_db[ii].is_valid) {
+            *free_index = ii;
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+
+    STUB_LOG_ERR("STP table full\n");
+    return SAI_STATUS_TABLE_FULL;
+}
+
+/* Instance and port of an STP port */
+static sai_status_t db_get_stp_port(_In_ uint32_t stp_port_id, _Out_ stub_stp_t **stp, _Out_ uint32_t *port_id)
+{
+    *port_id = stp_port_id % PORT_NUMBER;
+
+    if ((SAI_STATUS_SUCCESS != db_get_stp(stp_port_id / PORT_NUMBER, stp)) ||
+        (0 == ((*stp)->ports & (1ULL << *port_id)))) {
+        STUB_LOG_ERR("Invalid STP port ID %u\n", stp_port_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static uint64_t stp_state_to_bits(_In_ sai_stp_port_state_t state)
+{
+    switch (state) {
+    case SAI_STP_PORT_STATE_LEARNING:
+        return STP_STATE_LEARN;
+
+    case SAI_STP_PORT_STATE_FORWARDING:
+        return STP_STATE_LEARN | STP_STATE_FORWARD;
+
+    case SAI_STP_PORT_STATE_BLOCKING:
+    default:
+        return 0;
+    }
+}
+
+static sai_stp_port_state_t stp_bits_to_state(_In_ uint64_t bits)
+{
+    if (bits & STP_STATE_FORWARD) {
+        return SAI_STP_PORT_STATE_FORWARDING;
+    }
+
+    return (bits & STP_STATE_LEARN) ? SAI_STP_PORT_STATE_LEARNING : SAI_STP_PORT_STATE_BLOCKING;
+}
+
+static uint64_t stp_port_bits_get(_In_ const stub_stp_t *stp, _In_ uint32_t port_id)
+{
+    return (stp->states[port_id / STP_PORTS_PER_WORD] >> ((port_id % STP_PORTS_PER_WORD) * STP_PORT_STATE_BITS)) &
+           STP_STATE_MASK;
+}
+
+/*
+ * Set the state bits of a port. Entries learned on the port are flushed in
+ * all the VLANs of the instance when it stops learning.
+ */
+static void stp_port_bits_set(_Inout_ stub_stp_t *stp, _In_ uint32_t port_id, _In_ uint64_t bits)
+{
+    uint64_t *word  = &stp->states[port_id / STP_PORTS_PER_WORD];
+    uint32_t  shift = (port_id % STP_PORTS_PER_WORD) * STP_PORT_STATE_BITS;
+    uint64_t  old   = (*word >> shift) & STP_STATE_MASK;
+
+    __atomic_store_n(word, (*word & ~(STP_STATE_MASK << shift)) | (bits << shift), __ATOMIC_RELEASE);
+
+    if ((old & STP_STATE_LEARN) && !(bits & STP_STATE_LEARN) && (0 != stp->vlan_count)) {
+        db_fdb_flush_vlans(stp->vlans, 1ULL << port_id);
+    }
+}
+
+/* State of ports without an STP port object */
+static uint64_t stp_default_bits(_In_ const stub_stp_t *stp)
+{
+    return (stp == &stp_db[STP_DEFAULT_INSTANCE]) ? (STP_STATE_LEARN | STP_STATE_FORWARD) : 0;
+}
+
+/* Whether a port forwards frames of a VLAN */
+bool db_stp_port_forwarding(_In_ sai_vlan_id_t vlan_id, _In_ uint32_t port_id)
+{
+    const stub_stp_t *stp = &stp_db[stp_vlan_db[vlan_id % STP_VLAN_NUMBER]];
+
+    return (__atomic_load_n(&stp->states[port_id / STP_PORTS_PER_WORD], __ATOMIC_ACQUIRE) >>
+            ((port_id % STP_PORTS_PER_WORD) * STP_PORT_STATE_BITS)) & STP_STATE_FORWARD;
+}
+
+/* Whether a port learns source addresses of frames of a VLAN */
+bool db_stp_port_learning(_In_ sai_vlan_id_t vlan_id, _In_ uint32_t port_id)
+{
+    const stub_stp_t *stp = &stp_db[stp_vlan_db[vlan_id % STP_VLAN_NUMBER]];
+
+    return (__atomic_load_n(&stp->states[port_id / STP_PORTS_PER_WORD], __ATOMIC_ACQUIRE) >>
+            ((port_id % STP_PORTS_PER_WORD) * STP_PORT_STATE_BITS)) & STP_STATE_LEARN;
+}
+
+/* Instance of a VLAN */
+sai_status_t db_stp_vlan_get(_In_ sai_vlan_id_t vlan_id, _Out_ sai_object_id_t *stp_id)
+{
+    if ((0 == vlan_id) || (vlan_id >= STP_VLAN_NUMBER)) {
+        STUB_LOG_ERR("Invalid VLAN %u\n", vlan_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    return stub_create_object(SAI_OBJECT_TYPE_STP, stp_vlan_db[vlan_id], stp_id);
+}
+
+/*
+ * Move a VLAN to an instance. The port states of the VLAN change at once,
+ * and the entries learned in the VLAN are flushed on the ports which do not
+ * learn in the new instance.
+ */
+sai_status_t db_stp_vlan_set(_In_ sai_vlan_id_t vlan_id, _In_ sai_object_id_t stp_id)
+{
+    stub_stp_t  *stp, *old;
+    sai_status_t status;
+    uint64_t     vlans[STP_VLAN_WORDS] = { 0 };
+    uint64_t     flushed = 0;
+    uint32_t     db_id, ii;
+
+    if ((0 == vlan_id) || (vlan_id >= STP_VLAN_NUMBER)) {
+        STUB_LOG_ERR("Invalid VLAN %u\n", vlan_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(stp_id, SAI_OBJECT_TYPE_STP, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_stp(db_id, &stp))) {
+        return status;
+    }
+
+    old = &stp_db[stp_vlan_db[vlan_id]];
+    if (old == stp) {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    old->vlans[vlan_id / 64] &= ~(1ULL << (vlan_id % 64));
+    old->vlan_count--;
+    stp->vlans[vlan_id / 64] |= 1ULL << (vlan_id % 64);
+    stp->vlan_count++;
+    __atomic_store_n(&stp_vlan_db[vlan_id], (uint8_t)db_id, __ATOMIC_RELEASE);
+
+    for (ii = 0; ii < PORT_NUMBER; ii++) {
+        if ((stp_port_bits_get(old, ii) & STP_STATE_LEARN) && !(stp_port_bits_get(stp, ii) & STP_STATE_LEARN)) {
+            flushed |= 1ULL << ii;
+        }
+    }
+
+    if (0 != flushed) {
+        vlans[vlan_id / 64] = 1ULL << (vlan_id % 64);
+        db_fdb_flush_vlans(vlans, flushed);
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*************************/
+
+static void stp_key_to_str(_In_ sai_object_id_t stp_id, _Out_ char *key_str)
+{
+    uint32_t stpid;
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(stp_id, SAI_OBJECT_TYPE_STP, &stpid)) {
+        snprintf(key_str, MAX_KEY_STR_LEN, "invalid STP");
+    } else {
+        snprintf(key_str, MAX_KEY_STR_LEN, "STP %u", stpid);
+    }
+}
+
+static void stp_port_key_to_str(_In_ sai_object_id_t stp_port_id, _Out_ char *key_str)
+{
+    uint32_t stpportid;
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(stp_port_id, SAI_OBJECT_TYPE_STP_PORT, &stpportid)) {
+        snprintf(key_str, MAX_KEY_STR_LEN, "invalid STP port");
+    } else {
+        snprintf(key_str, MAX_KEY_STR_LEN, "STP %u port %u", stpportid / PORT_NUMBER, stpportid % PORT_NUMBER);
+    }
+}
+
+/*
+ * Routine Description:
+ *    Create STP instance, with all ports blocking.
+ *
+ * Arguments:
+ *    [out] stp_id - STP instance id
+ *    [in] switch_id - switch id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_stp(_Out_ sai_object_id_t      *stp_id,
+                             _In_ sai_object_id_t        switch_id,
+                             _In_ uint32_t               attr_count,
+                             _In_ const sai_attribute_t *attr_list)
+{
+    sai_status_t status;
+    uint32_t     db_id;
+    char         list_str[MAX_LIST_VALUE_STR_LEN];
+    char         key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == stp_id) {
+        STUB_LOG_ERR("NULL STP id param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = check_attribs_metadata(attr_count, attr_list, stp_attribs, stp_vendor_attribs,
+                                         SAI_OPERATION_CREATE))) {
+        STUB_LOG_ERR("Failed attribs check\n");
+        return status;
+    }
+
+    sai_attr_list_to_str(attr_count, attr_list, stp_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create STP, %s\n", list_str);
+
+    if (SAI_STATUS_SUCCESS != (status = db_find_free_stp_index(&db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = stub_create_object(SAI_OBJECT_TYPE_STP, db_id, stp_id))) {
+        return status;
+    }
+
+    memset(&stp_db[db_id], 0, sizeof(stp_db[db_id]));
+    stp_db[db_id].is_valid = true;
+
+    stp_key_to_str(*stp_id, key_str);
+    STUB_LOG_NTC("Created %s\n", key_str);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Remove STP instance.
+ *
+ * Arguments:
+ *    [in] stp_id - STP instance id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_stp(_In_ sai_object_id_t stp_id)
+{
+    stub_stp_t  *stp;
+    char         key_str[MAX_KEY_STR_LEN];
+    sai_status_t status;
+    uint32_t     db_id;
+
+    STUB_LOG_ENTER();
+
+    stp_key_to_str(stp_id, key_str);
+    STUB_LOG_NTC("Remove %s\n", key_str);
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(stp_id, SAI_OBJECT_TYPE_STP, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_stp(db_id, &stp))) {
+        return status;
+    }
+
+    if (STP_DEFAULT_INSTANCE == db_id) {
+        STUB_LOG_ERR("Can't remove the default STP instance\n");
+        return SAI_STATUS_OBJECT_IN_USE;
+    }
+
+    if (0 != stp->vlan_count) {
+        STUB_LOG_ERR("STP %u has %u VLANs\n", db_id, stp->vlan_count);
+        return SAI_STATUS_OBJECT_IN_USE;
+    }
+
+    if (0 != stp->ports) {
+        STUB_LOG_ERR("STP %u has %u ports\n", db_id, __builtin_popcountll(stp->ports));
+        return SAI_STATUS_OBJECT_IN_USE;
+    }
+
+    stp->is_valid = false;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Set STP instance attribute.
+ *
+ * Arguments:
+ *    [in] stp_id - STP instance id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_stp_attribute(_In_ sai_object_id_t stp_id, _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = stp_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    stp_key_to_str(stp_id, key_str);
+    return sai_set_attribute(&key, key_str, stp_attribs, stp_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get STP instance attributes.
+ *
+ * Arguments:
+ *    [in] stp_id - STP instance id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_stp_attribute(_In_ sai_object_id_t     stp_id,
+                                    _In_ uint32_t            attr_count,
+                                    _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = stp_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    stp_key_to_str(stp_id, key_str);
+    return sai_get_attributes(&key, key_str, stp_attribs, stp_vendor_attribs, attr_count, attr_list);
+}
+
+/* VLAN list [sai_vlan_list_t], port list [sai_object_list_t] */
+sai_status_t stub_stp_attr_get(_In_ const sai_object_key_t   *key,
+                               _Inout_ sai_attribute_value_t *value,
+                               _In_ uint32_t                  attr_index,
+                               _Inout_ vendor_cache_t        *cache,
+                               void                          *arg)
+{
+    stub_stp_t     *stp;
+    sai_status_t    status;
+    sai_vlan_id_t   vlans[STP_VLAN_NUMBER];
+    sai_object_id_t ports[PORT_NUMBER];
+    uint64_t        bits;
+    uint32_t        db_id, count = 0, ii;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_STP, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_stp(db_id, &stp))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_STP_ATTR_VLAN_LIST:
+        for (ii = 0; ii < STP_VLAN_WORDS; ii++) {
+            for (bits = stp->vlans[ii]; bits; bits &= bits - 1) {
+                vlans[count++] = ii * 64 + __builtin_ctzll(bits);
+            }
+        }
+        status = stub_fill_vlanlist(vlans, count, &value->vlanlist);
+        break;
+
+    case SAI_STP_ATTR_PORT_LIST:
+        for (bits = stp->ports; bits; bits &= bits - 1) {
+            if (SAI_STATUS_SUCCESS !=
+                (status = stub_create_object(SAI_OBJECT_TYPE_STP_PORT, db_id * PORT_NUMBER + __builtin_ctzll(bits),
+                                             &ports[count++]))) {
+                return status;
+            }
+        }
+        status = stub_fill_objlist(ports, count, &value->objlist);
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid STP attribute %d\n", (int)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return status;
+}
+
+/*
+ * Routine Description:
+ *    Create STP port.
+ *
+ * Arguments:
+ *    [out] stp_port_id - STP port id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_stp_port(_Out_ sai_object_id_t      *stp_port_id,
+                                  _In_ uint32_t               attr_count,
+                                  _In_ const sai_attribute_t *attr_list)
+{
+    stub_stp_t                  *stp;
+    sai_status_t                 status;
+    const sai_attribute_value_t *stp_id, *port, *state;
+    uint32_t                     stp_index, port_index, state_index, db_id, port_id;
+    char                         list_str[MAX_LIST_VALUE_STR_LEN];
+    char                         key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == stp_port_id) {
+        STUB_LOG_ERR("NULL STP port id param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = check_attribs_metadata(attr_count, attr_list, stp_port_attribs, stp_port_vendor_attribs,
+                                         SAI_OPERATION_CREATE))) {
+        STUB_LOG_ERR("Failed attribs check\n");
+        return status;
+    }
+
+    sai_attr_list_to_str(attr_count, attr_list, stp_port_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create STP port, %s\n", list_str);
+
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_STP_PORT_ATTR_STP, &stp_id, &stp_index));
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_STP_PORT_ATTR_PORT, &port, &port_index));
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_STP_PORT_ATTR_STATE, &state, &state_index));
+
+    if ((SAI_STATUS_SUCCESS != stub_object_to_type(stp_id->oid, SAI_OBJECT_TYPE_STP, &db_id)) ||
+        (SAI_STATUS_SUCCESS != db_get_stp(db_id, &stp))) {
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + stp_index;
+    }
+
+    if ((SAI_STATUS_SUCCESS != stub_object_to_type(port->oid, SAI_OBJECT_TYPE_PORT, &port_id)) ||
+        (port_id >= PORT_NUMBER)) {
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + port_index;
+    }
+
+    if ((SAI_STP_PORT_STATE_LEARNING != state->s32) && (SAI_STP_PORT_STATE_FORWARDING != state->s32) &&
+        (SAI_STP_PORT_STATE_BLOCKING != state->s32)) {
+        STUB_LOG_ERR("Invalid STP port state %d\n", state->s32);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + state_index;
+    }
+
+    if (stp->ports & (1ULL << port_id)) {
+        STUB_LOG_ERR("Port %u already in STP %u\n", port_id, db_id);
+        return SAI_STATUS_ITEM_ALREADY_EXISTS;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_create_object(SAI_OBJECT_TYPE_STP_PORT, db_id * PORT_NUMBER + port_id, stp_port_id))) {
+        return status;
+    }
+
+    stp->ports |= 1ULL << port_id;
+    stp_port_bits_set(stp, port_id, stp_state_to_bits(state->s32));
+
+    stp_port_key_to_str(*stp_port_id, key_str);
+    STUB_LOG_NTC("Created %s\n", key_str);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Remove STP port, back to the instance default state.
+ *
+ * Arguments:
+ *    [in] stp_port_id - STP port id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_stp_port(_In_ sai_object_id_t stp_port_id)
+{
+    stub_stp_t  *stp;
+    char         key_str[MAX_KEY_STR_LEN];
+    sai_status_t status;
+    uint32_t     db_id, port_id;
+
+    STUB_LOG_ENTER();
+
+    stp_port_key_to_str(stp_port_id, key_str);
+    STUB_LOG_NTC("Remove %s\n", key_str);
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(stp_port_id, SAI_OBJECT_TYPE_STP_PORT, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_stp_port(db_id, &stp, &port_id))) {
+        return status;
+    }
+
+    stp_port_bits_set(stp, port_id, stp_default_bits(stp));
+    stp->ports &= ~(1ULL << port_id);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Set STP port attribute.
+ *
+ * Arguments:
+ *    [in] stp_port_id - STP port id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_stp_port_attribute(_In_ sai_object_id_t stp_port_id, _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = stp_port_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    stp_port_key_to_str(stp_port_id, key_str);
+    return sai_set_attribute(&key, key_str, stp_port_attribs, stp_port_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get STP port attributes.
+ *
+ * Arguments:
+ *    [in] stp_port_id - STP port id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_stp_port_attribute(_In_ sai_object_id_t     stp_port_id,
+                                         _In_ uint32_t            attr_count,
+                                         _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = stp_port_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    stp_port_key_to_str(stp_port_id, key_str);
+    return sai_get_attributes(&key, key_str, stp_port_attribs, stp_port_vendor_attribs, attr_count, attr_list);
+}
+
+/* STP [sai_object_id_t], port [sai_object_id_t], state [sai_stp_port_state_t] */
+sai_status_t stub_stp_port_attr_get(_In_ const sai_object_key_t   *key,
+                                    _Inout_ sai_attribute_value_t *value,
+                                    _In_ uint32_t                  attr_index,
+                                    _Inout_ vendor_cache_t        *cache,
+                                    void                          *arg)
+{
+    stub_stp_t  *stp;
+    sai_status_t status;
+    uint32_t     db_id, port_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_STP_PORT, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_stp_port(db_id, &stp, &port_id))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_STP_PORT_ATTR_STP:
+        status = stub_create_object(SAI_OBJECT_TYPE_STP, db_id / PORT_NUMBER, &value->oid);
+        break;
+
+    case SAI_STP_PORT_ATTR_PORT:
+        status = stub_create_object(SAI_OBJECT_TYPE_PORT, port_id, &value->oid);
+        break;
+
+    case SAI_STP_PORT_ATTR_STATE:
+        value->s32 = stp_bits_to_state(stp_port_bits_get(stp, port_id));
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid STP port attribute %d\n", (int)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return status;
+}
+
+/* STP port state [sai_stp_port_state_t] */
+sai_status_t stub_stp_port_state_set(_In_ const sai_object_key_t      *key,
+                                     _In_ const sai_attribute_value_t *value,
+                                     void                             *arg)
+{
+    stub_stp_t  *stp;
+    sai_status_t status;
+    uint32_t     db_id, port_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_STP_PORT, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_stp_port(db_id, &stp, &port_id))) {
+        return status;
+    }
+
+    if ((SAI_STP_PORT_STATE_LEARNING != value->s32) && (SAI_STP_PORT_STATE_FORWARDING != value->s32) &&
+        (SAI_STP_PORT_STATE_BLOCKING != value->s32)) {
+        STUB_LOG_ERR("Invalid STP port state %d\n", value->s32);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0;
+    }
+
+    stp_port_bits_set(stp, port_id, stp_state_to_bits(value->s32));
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+const sai_stp_api_t stp_api = {
+    stub_create_stp,
+    stub_remove_stp,
+    stub_set_stp_attribute,
+    stub_get_stp_attribute,
+    stub_create_stp_port,
+    stub_remove_stp_port,
+    stub_set_stp_port_attribute,
+    stub_get_stp_port_attribute
+};
@@ -17,6 +17,7 @@
 
 #include "sai.h"
 #include "stub_sai.h"
+#include "assert.h"
 
 #undef  __MODULE__
 #define __MODULE__ SAI_SWITCH
@@ -104,6 +105,11 @@ sai_status_t stub_switch_src_mac_get(_In_ const sai_object_key_t   *key,
                                      _In_ uint32_t                  attr_index,
                                      _Inout_ vendor_cache_t        *cache,
                                      void                          *arg);
+sai_status_t stub_switch_max_learned_get(_In_ const sai_object_key_t   *key,
+                                         _Inout_ sai_attribute_value_t *value,
+                                         _In_ uint32_t                  attr_index,
+                                         _Inout_ vendor_cache_t        *cache,
+                                         void                          *arg);
 sai_status_t stub_switch_aging_time_get(_In_ const sai_object_key_t   *key,
                                         _Inout_ sai_attribute_value_t *value,
                                         _In_ uint32_t                  attr_index,
@@ -124,6 +130,16 @@ sai_status_t stub_switch_ecmp_hash_fields_get(_In_ const sai_object_key_t   *key
                                               _In_ uint32_t                  attr_index,
                                               _Inout_ vendor_cache_t        *cache,
                                               void                          *arg);
+sai_status_t stub_switch_ecmp_groups_number_get(_In_ const sai_object_key_t   *key,
+                                                _Inout_ sai_attribute_value_t *value,
+                                                _In_ uint32_t                  attr_index,
+                                                _Inout_ vendor_cache_t        *cache,
+                                                void                          *arg);
+sai_status_t stub_switch_ecmp_group_dedup_get(_In_ const sai_object_key_t   *key,
+                                              _Inout_ sai_attribute_value_t *value,
+                                              _In_ uint32_t                  attr_index,
+                                              _Inout_ vendor_cache_t        *cache,
+                                              void                          *arg);
 sai_status_t stub_switch_counter_refresh_get(_In_ const sai_object_key_t   *key,
                                              _Inout_ sai_attribute_value_t *value,
                                              _In_ uint32_t                  attr_index,
@@ -150,6 +166,9 @@ sai_status_t stub_switch_mode_set(_In_ const sai_object_key_t      *key,
 sai_status_t stub_switch_default_port_vlan_set(_In_ const sai_object_key_t      *key,
                                                _In_ const sai_attribute_value_t *value,
                                                void                             *arg);
+sai_status_t stub_switch_max_learned_set(_In_ const sai_object_key_t      *key,
+                                         _In_ const sai_attribute_value_t *value,
+                                         void                             *arg);
 sai_status_t stub_switch_aging_time_set(_In_ const sai_object_key_t      *key,
                                         _In_ const sai_attribute_value_t *value,
                                         void                             *arg);
@@ -238,6 +257,12 @@ static const sai_attribute_entry_t        switch_attribs[] = {
       "Switch default trap group", SAI_ATTR_VAL_TYPE_OID },
     { SAI_SWITCH_ATTR_PORT_BREAKOUT, false, false, true, false,
       "Switch port breakout mode", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_SWITCH_ATTR_NUMBER_OF_ECMP_GROUPS, false, false, false, true,
+      "Switch ECMP groups number", SAI_ATTR_VAL_TYPE_U32 },
+    { SAI_SWITCH_ATTR_ECMP_GROUP_DEDUP_RATIO, false, false, false, true,
+      "Switch ECMP group sharing ratio", SAI_ATTR_VAL_TYPE_U32 },
+    { SAI_SWITCH_ATTR_ECMP_GROUP_DEDUP_SAVED, false, false, false, true,
+      "Switch ECMP groups saved by sharing", SAI_ATTR_VAL_TYPE_U32 },
     { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
       "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
 };
@@ -328,10 +353,10 @@ static const sai_vendor_attribute_entry_t switch_vendor_attribs[] = {
       stub_switch_src_mac_get, NULL,
       NULL, NULL },
     { SAI_SWITCH_ATTR_MAX_LEARNED_ADDRESSES,
-      { false, false, false, false },
       { false, false, true, true },
-      NULL, NULL,
-      NULL, NULL },
+      { false, false, true, true },
+      stub_switch_max_learned_get, NULL,
+      stub_switch_max_learned_set, NULL },
     { SAI_SWITCH_ATTR_FDB_AGING_TIME,
       { false, false, true, true },
       { false, false, true, true },
@@ -397,6 +422,21 @@ static const sai_vendor_attribute_entry_t switch_vendor_attribs[] = {
       { false, false, true, false },
       NULL, NULL,
       NULL, NULL },
+    { SAI_SWITCH_ATTR_NUMBER_OF_ECMP_GROUPS,
+      { false, false, false, true },
+      { false, false, false, true },
+      stub_switch_ecmp_groups_number_get, NULL,
+      NULL, NULL },
+    { SAI_SWITCH_ATTR_ECMP_GROUP_DEDUP_RATIO,
+      { false, false, false, true },
+      { false, false, false, true },
+      stub_switch_ecmp_group_dedup_get, (void*)SAI_SWITCH_ATTR_ECMP_GROUP_DEDUP_RATIO,
+      NULL, NULL },
+    { SAI_SWITCH_ATTR_ECMP_GROUP_DEDUP_SAVED,
+      { false, false, false, true },
+      { false, false, false, true },
+      stub_switch_ecmp_group_dedup_get, (void*)SAI_SWITCH_ATTR_ECMP_GROUP_DEDUP_SAVED,
+      NULL, NULL },
 };
 
 
@@ -420,6 +460,8 @@ sai_status_t stub_initialize_switch(_In_ sai_switch_profile_id_t
                                     _In_reads_opt_z_(SAI_MAX_FIRMWARE_PATH_NAME_LEN) char* firmware_path_name,
                                     _In_ sai_switch_notification_t                       * switch_notifications)
 {
+    sai_status_t status;
+
     if (NULL == switch_hardware_id) {
         fprintf(stderr, "NULL switch hardware ID passed to SAI switch initialize\n");
         return SAI_STATUS_INVALID_PARAMETER;
@@ -440,10 +482,24 @@ sai_status_t stub_initialize_switch(_In_ sai_switch_profile_id_t
 
     STUB_LOG_NTC("Initialize switch\n");
 
+    if (SAI_STATUS_SUCCESS != (status = db_profile_load(profile_id))) {
+        return status;
+    }
+
     db_init_vlan();
     db_init_next_hop_group();
+    db_init_fdb();
 
-    return SAI_STATUS_SUCCESS;
+    if (SAI_STATUS_SUCCESS != (status = db_notification_start())) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_trap_start())) {
+        return status;
+    }
+
+    /* Ports are ready, the other objects are initialized in the background, notifying the switch state when done */
+    return db_init_start();
 }
 
 /*
@@ -462,6 +518,11 @@ sai_status_t stub_initialize_switch(_In_ sai_switch_profile_id_t
 void stub_shutdown_switch(_In_ bool warm_restart_hint)
 {
     STUB_LOG_NTC("Shutdown switch\n");
+    db_init_wait();
+    db_telemetry_stop();
+    db_counter_stop();
+    db_trap_stop();
+    db_notification_stop();
     gh_sdk = 0;
 }
 
@@ -483,6 +544,8 @@ sai_status_t stub_connect_switch(_In_ sai_switch_profile_id_t                pro
                                  _In_reads_z_(SAI_MAX_HARDWARE_ID_LEN) char* switch_hardware_id,
                                  _In_ sai_switch_notification_t            * switch_notifications)
 {
+    sai_status_t status;
+
     if (NULL == switch_hardware_id) {
         fprintf(stderr, "NULL switch hardware ID passed to SAI switch connect\n");
         return SAI_STATUS_INVALID_PARAMETER;
@@ -494,6 +557,8 @@ sai_status_t stub_connect_switch(_In_ sai_switch_profile_id_t                pro
         return SAI_STATUS_INVALID_PARAMETER;
     }
 
+    /* The trap thread calls the packet event notification, it is restarted with the new one */
+    db_trap_stop();
     memcpy(&g_notification_callbacks, switch_notifications, sizeof(g_notification_callbacks));
 
     /* Open an handle if not done already on init for init agent */
@@ -503,11 +568,24 @@ sai_status_t stub_connect_switch(_In_ sai_switch_profile_id_t                pro
 #endif
     }
 
+    if (SAI_STATUS_SUCCESS != (status = db_profile_load(profile_id))) {
+        return status;
+    }
+
     db_init_next_hop_group();
 
     STUB_LOG_NTC("Connect switch\n");
 
-    return SAI_STATUS_SUCCESS;
+    if (SAI_STATUS_SUCCESS != (status = db_notification_start())) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_trap_start())) {
+        return status;
+    }
+
+    /* Stages done by the switch initialize are skipped, the switch state is notified to the new callbacks */
+    return db_init_start();
 }
 
 /*
@@ -523,6 +601,9 @@ void stub_disconnect_switch(void)
 {
     STUB_LOG_NTC("Disconnect switch\n");
 
+    db_init_wait();
+    db_trap_stop();
+    db_notification_stop();
     memset(&g_notification_callbacks, 0, sizeof(g_notification_callbacks));
 }
 
@@ -579,6 +660,21 @@ sai_status_t stub_switch_default_port_vlan_set(_In_ const sai_object_key_t
     return SAI_STATUS_SUCCESS;
 }
 
+/* Maximum number of learned MAC addresses [uint32_t]
+ * zero means learning limit disable. (default to zero)
+ */
+sai_status_t stub_switch_max_learned_set(_In_ const sai_object_key_t      *key,
+                                         _In_ const sai_attribute_value_t *value,
+                                         void                             *arg)
+{
+    STUB_LOG_ENTER();
+
+    db_fdb_max_learned_set(value->u32);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
 /* Dynamic FDB entry aging time in seconds [uint32_t]
  *   Zero means aging is disabled.
  *  (default to zero)
@@ -589,6 +685,7 @@ sai_status_t stub_switch_aging_time_set(_In_ const sai_object_key_t      *key,
 {
     STUB_LOG_ENTER();
 
+    db_fdb_aging_time_set(value->u32);
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
 }
@@ -694,6 +791,7 @@ sai_status_t stub_switch_ecmp_hash_fields_set(_In_ const sai_object_key_t      *
  * refresh rate.
  * A NPU may support both or one of the option. It would return
  * error for unsupported options. [uint32_t]
+ * Setting it takes a snapshot of the cached counters right away.
  */
 sai_status_t stub_switch_counter_refresh_set(_In_ const sai_object_key_t      *key,
                                              _In_ const sai_attribute_value_t *value,
@@ -701,6 +799,8 @@ sai_status_t stub_switch_counter_refresh_set(_In_ const sai_object_key_t      *k
 {
     STUB_LOG_ENTER();
 
+    db_counter_refresh_interval_set(value->u32);
+
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
 }
@@ -732,8 +832,14 @@ sai_status_t stub_switch_default_trap_group_set(_In_ const sai_object_key_t
                                                 _In_ const sai_attribute_value_t *value,
                                                 void                             *arg)
 {
+    sai_status_t status;
+
     STUB_LOG_ENTER();
 
+    if (SAI_STATUS_SUCCESS != (status = db_trap_default_group_set(value->oid))) {
+        return status;
+    }
+
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
 }
@@ -840,7 +946,7 @@ sai_status_t stub_switch_fdb_size_get(_In_ const sai_object_key_t   *key,
 {
     STUB_LOG_ENTER();
 
-    value->u32 = 100000;
+    value->u32 = db_fdb_table_size_get();
 
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
@@ -873,7 +979,7 @@ sai_status_t stub_switch_default_stp_get(_In_ const sai_object_key_t   *key,
 
     STUB_LOG_ENTER();
 
-    if (SAI_STATUS_SUCCESS != (status = stub_create_object(SAI_OBJECT_TYPE_STP_INSTANCE, 1, &value->oid))) {
+    if (SAI_STATUS_SUCCESS != (status = stub_create_object(SAI_OBJECT_TYPE_STP, STP_DEFAULT_INSTANCE, &value->oid))) {
         return status;
     }
 
@@ -908,7 +1014,7 @@ sai_status_t stub_switch_oper_status_get(_In_ const sai_object_key_t   *key,
 {
     STUB_LOG_ENTER();
 
-    value->s32 = SAI_SWITCH_OPER_STATUS_UP;
+    value->s32 = db_init_oper_status_get();
 
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
@@ -1011,6 +1117,23 @@ sai_status_t stub_switch_src_mac_get(_In_ const sai_object_key_t   *key,
     return SAI_STATUS_SUCCESS;
 }
 
+/* Maximum number of learned MAC addresses [uint32_t]
+ * zero means learning limit disable. (default to zero)
+ */
+sai_status_t stub_switch_max_learned_get(_In_ const sai_object_key_t   *key,
+                                         _Inout_ sai_attribute_value_t *value,
+                                         _In_ uint32_t                  attr_index,
+                                         _Inout_ vendor_cache_t        *cache,
+                                         void                          *arg)
+{
+    STUB_LOG_ENTER();
+
+    value->u32 = db_fdb_max_learned_get();
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
 /* Dynamic FDB entry aging time in seconds [uint32_t]
  *   Zero means aging is disabled.
  *  (default to zero)
@@ -1023,7 +1146,7 @@ sai_status_t stub_switch_aging_time_get(_In_ const sai_object_key_t   *key,
 {
     STUB_LOG_ENTER();
 
-    value->u32 = 0;
+    value->u32 = db_fdb_aging_time_get();
 
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
@@ -1072,6 +1195,50 @@ sai_status_t stub_switch_ecmp_hash_fields_get(_In_ const sai_object_key_t   *key
     return SAI_STATUS_SUCCESS;
 }
 
+/* ECMP number of group [uint32_t] */
+sai_status_t stub_switch_ecmp_groups_number_get(_In_ const sai_object_key_t   *key,
+                                                _Inout_ sai_attribute_value_t *value,
+                                                _In_ uint32_t                  attr_index,
+                                                _Inout_ vendor_cache_t        *cache,
+                                                void                          *arg)
+{
+    uint32_t group_count, ecmp_group_count, ecmp_group_capacity;
+
+    STUB_LOG_ENTER();
+
+    db_next_hop_group_sharing_get(&group_count, &ecmp_group_count, &ecmp_group_capacity);
+    value->u32 = ecmp_group_capacity;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* ECMP group sharing ratio in hundredths, ECMP groups saved by sharing [uint32_t] */
+sai_status_t stub_switch_ecmp_group_dedup_get(_In_ const sai_object_key_t   *key,
+                                              _Inout_ sai_attribute_value_t *value,
+                                              _In_ uint32_t                  attr_index,
+                                              _Inout_ vendor_cache_t        *cache,
+                                              void                          *arg)
+{
+    uint32_t group_count, ecmp_group_count, ecmp_group_capacity;
+
+    STUB_LOG_ENTER();
+
+    assert((SAI_SWITCH_ATTR_ECMP_GROUP_DEDUP_RATIO == (int64_t)arg) ||
+           (SAI_SWITCH_ATTR_ECMP_GROUP_DEDUP_SAVED == (int64_t)arg));
+
+    db_next_hop_group_sharing_get(&group_count, &ecmp_group_count, &ecmp_group_capacity);
+
+    if (SAI_SWITCH_ATTR_ECMP_GROUP_DEDUP_RATIO == (int64_t)arg) {
+        value->u32 = (0 == ecmp_group_count) ? 100 : (group_count * 100) / ecmp_group_count;
+    } else {
+        value->u32 = group_count - ecmp_group_count;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
 /* The SDK can
  * 1 - Read the counters directly from HW (or)
  * 2 - Cache the counters in SW. Caching is typically done if
@@ -1094,6 +1261,8 @@ sai_status_t stub_switch_counter_refresh_get(_In_ const sai_object_key_t   *key,
 {
     STUB_LOG_ENTER();
 
+    value->u32 = db_counter_refresh_interval_get();
+
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
 }
@@ -1131,8 +1300,14 @@ sai_status_t stub_switch_default_trap_group_get(_In_ const sai_object_key_t   *k
                                                 _Inout_ vendor_cache_t        *cache,
                                                 void                          *arg)
 {
+    sai_status_t status;
+
     STUB_LOG_ENTER();
 
+    if (SAI_STATUS_SUCCESS != (status = db_trap_default_group_get(&value->oid))) {
+        return status;
+    }
+
     STUB_LOG_EXIT();
     return SAI_STATUS_SUCCESS;
 }
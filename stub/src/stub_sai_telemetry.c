@@ -0,0 +1,779 @@
+/*
+ *  Copyright (C) 2014. Mellanox Technologies, Ltd. ALL RIGHTS RESERVED.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ */
+
+#include "sai.h"
+#include "stub_sai.h"
+#include "assert.h"
+#include <errno.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#undef  __MODULE__
+#define __MODULE__ SAI_TELEMETRY
+
+static const sai_attribute_entry_t telemetry_attribs[] = {
+    { SAI_TELEMETRY_SUBSCRIPTION_ATTR_OBJECT_LIST, true, true, false, true,
+      "Telemetry subscription object list", SAI_ATTR_VAL_TYPE_OBJLIST },
+    { SAI_TELEMETRY_SUBSCRIPTION_ATTR_COUNTER_LIST, true, true, false, true,
+      "Telemetry subscription counter list", SAI_ATTR_VAL_TYPE_S32LIST },
+    { SAI_TELEMETRY_SUBSCRIPTION_ATTR_SOCKET_PATH, true, true, false, true,
+      "Telemetry subscription socket path", SAI_ATTR_VAL_TYPE_CHARDATA },
+    { SAI_TELEMETRY_SUBSCRIPTION_ATTR_INTERVAL, false, true, true, true,
+      "Telemetry subscription interval", SAI_ATTR_VAL_TYPE_U32 },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+sai_status_t stub_telemetry_attr_get(_In_ const sai_object_key_t   *key,
+                                     _Inout_ sai_attribute_value_t *value,
+                                     _In_ uint32_t                  attr_index,
+                                     _Inout_ vendor_cache_t        *cache,
+                                     void                          *arg);
+sai_status_t stub_telemetry_interval_set(_In_ const sai_object_key_t      *key,
+                                         _In_ const sai_attribute_value_t *value,
+                                         void                             *arg);
+
+static const sai_vendor_attribute_entry_t telemetry_vendor_attribs[] = {
+    { SAI_TELEMETRY_SUBSCRIPTION_ATTR_OBJECT_LIST,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_telemetry_attr_get, (void*)SAI_TELEMETRY_SUBSCRIPTION_ATTR_OBJECT_LIST,
+      NULL, NULL },
+    { SAI_TELEMETRY_SUBSCRIPTION_ATTR_COUNTER_LIST,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_telemetry_attr_get, (void*)SAI_TELEMETRY_SUBSCRIPTION_ATTR_COUNTER_LIST,
+      NULL, NULL },
+    { SAI_TELEMETRY_SUBSCRIPTION_ATTR_SOCKET_PATH,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_telemetry_attr_get, (void*)SAI_TELEMETRY_SUBSCRIPTION_ATTR_SOCKET_PATH,
+      NULL, NULL },
+    { SAI_TELEMETRY_SUBSCRIPTION_ATTR_INTERVAL,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_telemetry_attr_get, (void*)SAI_TELEMETRY_SUBSCRIPTION_ATTR_INTERVAL,
+      stub_telemetry_interval_set, NULL },
+};
+
+/* State DB *************/
+
+/*
+ * A single thread serves all the subscriptions. It sleeps until the earliest
+ * sample is due, reads the counters of the subscription objects, and sends
+ * them as one record datagram, without blocking, to the subscription socket.
+ * A record which can't be sent, the receiver being slow or not bound yet, is
+ * dropped, and the next record of the subscription is a keyframe.
+ *
+ * The values sent in the last record are kept per subscription, each record
+ * carrying the differences with them. Samples missed while the thread was
+ * late are skipped rather than sent in a burst. Watermarks are kept per
+ * subscription by the objects, and restart once a record is sent, so the
+ * peaks of a dropped record are carried in the next one.
+ */
+#define MAX_TELEMETRY_NUMBER        STUB_TELEMETRY_NUMBER
+#define TELEMETRY_MAX_OBJECTS       256
+#define TELEMETRY_MAX_COUNTERS      32
+#define TELEMETRY_MAX_VALUES        (TELEMETRY_MAX_OBJECTS * TELEMETRY_MAX_COUNTERS)
+#define TELEMETRY_DEFAULT_INTERVAL  100000
+/* A 64 bit value takes at most 10 bytes as a LEB128 varint */
+#define TELEMETRY_VARINT_MAX        10
+#define TELEMETRY_RECORD_MAX        (sizeof(sai_telemetry_record_header_t) + TELEMETRY_MAX_VALUES * TELEMETRY_VARINT_MAX)
+#define TELEMETRY_NEVER             UINT64_MAX
+
+typedef struct _stub_telemetry_t {
+    sai_object_type_t  object_type;
+    sai_object_id_t    objects[TELEMETRY_MAX_OBJECTS];
+    uint32_t           object_count;
+    int32_t            counter_ids[TELEMETRY_MAX_COUNTERS];
+    uint32_t           counter_count;
+    char               path[SAI_TELEMETRY_SOCKET_PATH_SIZE];
+    struct sockaddr_un address;
+    /* Interval in microseconds, and monotonic time of the next sample */
+    uint32_t           interval;
+    uint64_t           next_ns;
+    uint32_t           sequence;
+    /* The receiver missed the last record, the next one is a keyframe */
+    bool               keyframe;
+    /* Values of the last record sent, the next record values are relative to them */
+    uint64_t           values[TELEMETRY_MAX_VALUES];
+    bool               is_valid;
+} stub_telemetry_t;
+
+static stub_telemetry_t telemetry_db[MAX_TELEMETRY_NUMBER];
+/* Record and sample scratch buffers, used under telemetry_lock */
+static uint8_t          telemetry_record[TELEMETRY_RECORD_MAX];
+static uint64_t         telemetry_sample[TELEMETRY_MAX_VALUES];
+/* Unbound datagram socket the records of all the subscriptions are sent from */
+static int              telemetry_fd = -1;
+static pthread_t        telemetry_thread;
+static pthread_mutex_t  telemetry_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t   telemetry_cond;
+static bool             telemetry_running;
+
+static sai_status_t db_get_telemetry(_In_ uint32_t telemetry_id, _Out_ stub_telemetry_t **telemetry)
+{
+    if ((telemetry_id >= MAX_TELEMETRY_NUMBER) || (!telemetry_db[telemetry_id].is_valid)) {
+        STUB_LOG_ERR("Invalid telemetry subscription ID %u\n", telemetry_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *telemetry = &telemetry_db[telemetry_id];
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t db_find_free_telemetry_index(_Out_ uint32_t *free_index)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < MAX_TELEMETRY_NUMBER; ii++) {
+        if (false == telemetry_db[ii].is_valid) {
+            *free_index = ii;
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+
+    STUB_LOG_ERR("Telemetry subscription table full\n");
+    return SAI_STATUS_TABLE_FULL;
+}
+
+static uint64_t telemetry_now(_In_ clockid_t clock)
+{
+    struct timespec now;
+
+    clock_gettime(clock, &now);
+    return (uint64_t)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+/*
+ * Peak of a gauge since the last record of a subscription sent. The peak since
+ * the last sample is folded into the watermarks of all the subscriptions, and
+ * restarts from the current value. Called with the simulator lock held
+ */
+uint64_t db_telemetry_watermark_sample(_Inout_ stub_telemetry_watermark_t *watermark,
+                                       _In_ uint64_t                       current,
+                                       _In_ uint32_t                       subscription)
+{
+    uint32_t ii;
+
+    assert(subscription < MAX_TELEMETRY_NUMBER);
+
+    for (ii = 0; ii < MAX_TELEMETRY_NUMBER; ii++) {
+        if (watermark->peak > watermark->watermarks[ii]) {
+            watermark->watermarks[ii] = watermark->peak;
+        }
+    }
+    watermark->peak = current;
+
+    return watermark->watermarks[subscription];
+}
+
+/* Restart the watermark of a subscription, its record sent. Called with the simulator lock held */
+void db_telemetry_watermark_restart(_Inout_ stub_telemetry_watermark_t *watermark, _In_ uint32_t subscription)
+{
+    assert(subscription < MAX_TELEMETRY_NUMBER);
+
+    /* The peak holds the gauge since the sample, it is folded in on the next one */
+    watermark->watermarks[subscription] = 0;
+}
+
+static sai_status_t telemetry_object_sample(_In_ sai_object_type_t object_type,
+                                            _In_ sai_object_id_t   object_id,
+                                            _In_ uint32_t          subscription,
+                                            _In_ const int32_t    *counter_ids,
+                                            _In_ uint32_t          number_of_counters,
+                                            _Out_ uint64_t        *counters)
+{
+    switch (object_type) {
+    case SAI_OBJECT_TYPE_PORT:
+        return db_port_stats_sample(object_id, subscription, counter_ids, number_of_counters, counters);
+
+    case SAI_OBJECT_TYPE_QUEUE:
+        return db_queue_stats_sample(object_id, subscription, counter_ids, number_of_counters, counters);
+
+    case SAI_OBJECT_TYPE_INGRESS_PRIORITY_GROUP:
+        return db_buffer_pg_stats_sample(object_id, subscription, counter_ids, number_of_counters, counters);
+
+    default:
+        assert(false);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+}
+
+static sai_status_t telemetry_object_restart(_In_ sai_object_type_t object_type,
+                                             _In_ sai_object_id_t   object_id,
+                                             _In_ uint32_t          subscription)
+{
+    switch (object_type) {
+    case SAI_OBJECT_TYPE_PORT:
+        return db_port_watermarks_restart(object_id, subscription);
+
+    case SAI_OBJECT_TYPE_QUEUE:
+        return db_queue_watermarks_restart(object_id, subscription);
+
+    case SAI_OBJECT_TYPE_INGRESS_PRIORITY_GROUP:
+        return db_buffer_pg_watermarks_restart(object_id, subscription);
+
+    default:
+        assert(false);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+}
+
+/* Read the counters of the subscription objects, those of objects removed since the subscription read as 0 */
+static void telemetry_read(_In_ uint32_t telemetry_id, _Out_ uint64_t *values)
+{
+    const stub_telemetry_t *telemetry = &telemetry_db[telemetry_id];
+    uint32_t                ii;
+    uint64_t               *row;
+
+    db_sim_lock();
+    for (ii = 0, row = values; ii < telemetry->object_count; ii++, row += telemetry->counter_count) {
+        if (SAI_STATUS_SUCCESS !=
+            telemetry_object_sample(telemetry->object_type, telemetry->objects[ii], telemetry_id,
+                                    telemetry->counter_ids, telemetry->counter_count, row)) {
+            memset(row, 0, telemetry->counter_count * sizeof(*row));
+        }
+    }
+    db_sim_unlock();
+}
+
+/* Restart the watermarks of the subscription objects, those of objects removed since the subscription are skipped */
+static void telemetry_restart(_In_ uint32_t telemetry_id)
+{
+    const stub_telemetry_t *telemetry = &telemetry_db[telemetry_id];
+    uint32_t                ii;
+
+    db_sim_lock();
+    for (ii = 0; ii < telemetry->object_count; ii++) {
+        telemetry_object_restart(telemetry->object_type, telemetry->objects[ii], telemetry_id);
+    }
+    db_sim_unlock();
+}
+
+static uint8_t* telemetry_varint_put(_Out_ uint8_t *out, _In_ uint64_t value)
+{
+    while (value >= 0x80) {
+        *out++ = (uint8_t)value | 0x80;
+        value >>= 7;
+    }
+    *out++ = (uint8_t)value;
+
+    return out;
+}
+
+/* Sample the subscription counters and send them in a record, called with telemetry_lock held */
+static void telemetry_send(_In_ uint32_t telemetry_id)
+{
+    stub_telemetry_t              *telemetry = &telemetry_db[telemetry_id];
+    sai_telemetry_record_header_t *header    = (sai_telemetry_record_header_t*)telemetry_record;
+    uint8_t                       *out       = telemetry_record + sizeof(*header);
+    uint32_t                       count     = telemetry->object_count * telemetry->counter_count, ii;
+    uint64_t                       delta;
+
+    telemetry_read(telemetry_id, telemetry_sample);
+
+    header->version       = SAI_TELEMETRY_RECORD_VERSION;
+    header->flags         = telemetry->keyframe ? SAI_TELEMETRY_RECORD_FLAG_KEYFRAME : 0;
+    header->sequence      = telemetry->sequence++;
+    header->timestamp     = telemetry_now(CLOCK_REALTIME);
+    header->object_count  = telemetry->object_count;
+    header->counter_count = telemetry->counter_count;
+    stub_create_object(SAI_OBJECT_TYPE_TELEMETRY_SUBSCRIPTION, telemetry_id, &header->subscription_id);
+
+    for (ii = 0; ii < count; ii++) {
+        delta = telemetry_sample[ii] - (telemetry->keyframe ? 0 : telemetry->values[ii]);
+        /* Zigzag, so counters going back after a clear stay small */
+        out = telemetry_varint_put(out, (delta << 1) ^ (uint64_t)((int64_t)delta >> 63));
+    }
+
+    if (0 > sendto(telemetry_fd, telemetry_record, out - telemetry_record, MSG_DONTWAIT,
+                   (const struct sockaddr*)&telemetry->address, sizeof(telemetry->address))) {
+        STUB_LOG_DBG("Telemetry subscription %u record %u dropped, %s\n", telemetry_id, header->sequence,
+                     strerror(errno));
+        telemetry->keyframe = true;
+        return;
+    }
+
+    telemetry_restart(telemetry_id);
+    memcpy(telemetry->values, telemetry_sample, count * sizeof(*telemetry_sample));
+    telemetry->keyframe = false;
+}
+
+static void* telemetry_thread_run(void *arg)
+{
+    struct timespec deadline;
+    uint64_t        now, next;
+    uint32_t        ii;
+
+    pthread_mutex_lock(&telemetry_lock);
+    while (telemetry_running) {
+        now  = telemetry_now(CLOCK_MONOTONIC);
+        next = TELEMETRY_NEVER;
+        for (ii = 0; ii < MAX_TELEMETRY_NUMBER; ii++) {
+            if (!telemetry_db[ii].is_valid) {
+                continue;
+            }
+
+            if (telemetry_db[ii].next_ns <= now) {
+                telemetry_send(ii);
+                telemetry_db[ii].next_ns += telemetry_db[ii].interval * 1000ULL;
+                if (telemetry_db[ii].next_ns <= now) {
+                    telemetry_db[ii].next_ns = now + telemetry_db[ii].interval * 1000ULL;
+                }
+            }
+
+            if (telemetry_db[ii].next_ns < next) {
+                next = telemetry_db[ii].next_ns;
+            }
+        }
+
+        /* Subscription changes wake the thread up to recompute the next sample */
+        if (TELEMETRY_NEVER == next) {
+            pthread_cond_wait(&telemetry_cond, &telemetry_lock);
+        } else {
+            deadline.tv_sec  = next / 1000000000ULL;
+            deadline.tv_nsec = next % 1000000000ULL;
+            pthread_cond_timedwait(&telemetry_cond, &telemetry_lock, &deadline);
+        }
+    }
+    pthread_mutex_unlock(&telemetry_lock);
+
+    return NULL;
+}
+
+/* Start the telemetry thread with the first subscription, called with telemetry_lock held */
+static sai_status_t telemetry_start()
+{
+    pthread_condattr_t attr;
+    int                err;
+
+    if (telemetry_running) {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    if (0 > (telemetry_fd = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0))) {
+        STUB_LOG_ERR("Failed to open telemetry socket, %s\n", strerror(errno));
+        return SAI_STATUS_FAILURE;
+    }
+
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(&telemetry_cond, &attr);
+    pthread_condattr_destroy(&attr);
+
+    telemetry_running = true;
+    if (0 != (err = pthread_create(&telemetry_thread, NULL, telemetry_thread_run, NULL))) {
+        telemetry_running = false;
+        pthread_cond_destroy(&telemetry_cond);
+        close(telemetry_fd);
+        telemetry_fd = -1;
+        STUB_LOG_ERR("Failed to start telemetry thread, %s\n", strerror(err));
+        return SAI_STATUS_FAILURE;
+    }
+
+    STUB_LOG_NTC("Telemetry thread started\n");
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Stop the telemetry thread, ending all the subscriptions */
+void db_telemetry_stop()
+{
+    uint32_t ii;
+
+    pthread_mutex_lock(&telemetry_lock);
+    if (!telemetry_running) {
+        pthread_mutex_unlock(&telemetry_lock);
+        return;
+    }
+
+    telemetry_running = false;
+    pthread_cond_signal(&telemetry_cond);
+    pthread_mutex_unlock(&telemetry_lock);
+
+    pthread_join(telemetry_thread, NULL);
+    pthread_cond_destroy(&telemetry_cond);
+    close(telemetry_fd);
+    telemetry_fd = -1;
+
+    for (ii = 0; ii < MAX_TELEMETRY_NUMBER; ii++) {
+        telemetry_db[ii].is_valid = false;
+    }
+}
+
+/*************************/
+
+static void telemetry_key_to_str(_In_ sai_object_id_t subscription_id, _Out_ char *key_str)
+{
+    uint32_t telemetry_id;
+
+    if (SAI_STATUS_SUCCESS !=
+        stub_object_to_type(subscription_id, SAI_OBJECT_TYPE_TELEMETRY_SUBSCRIPTION, &telemetry_id)) {
+        snprintf(key_str, MAX_KEY_STR_LEN, "invalid telemetry subscription");
+    } else {
+        snprintf(key_str, MAX_KEY_STR_LEN, "telemetry subscription %u", telemetry_id);
+    }
+}
+
+/*
+ * Routine Description:
+ *    Create telemetry subscription.
+ *
+ * Arguments:
+ *    [out] subscription_id - telemetry subscription id
+ *    [in] switch_id - switch id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_telemetry_subscription(_Out_ sai_object_id_t      *subscription_id,
+                                                _In_ sai_object_id_t        switch_id,
+                                                _In_ uint32_t               attr_count,
+                                                _In_ const sai_attribute_t *attr_list)
+{
+    stub_telemetry_t            *telemetry;
+    sai_status_t                 status;
+    const sai_attribute_value_t *objects, *counters, *path, *interval;
+    uint32_t                     objects_index, counters_index, path_index, interval_index, db_id, ii;
+    uint32_t                     interval_us = TELEMETRY_DEFAULT_INTERVAL;
+    sai_object_type_t            object_type;
+    char                         list_str[MAX_LIST_VALUE_STR_LEN];
+    char                         key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == subscription_id) {
+        STUB_LOG_ERR("NULL telemetry subscription id param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = check_attribs_metadata(attr_count, attr_list, telemetry_attribs, telemetry_vendor_attribs,
+                                         SAI_OPERATION_CREATE))) {
+        STUB_LOG_ERR("Failed attribs check\n");
+        return status;
+    }
+
+    sai_attr_list_to_str(attr_count, attr_list, telemetry_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create telemetry subscription, %s\n", list_str);
+
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_TELEMETRY_SUBSCRIPTION_ATTR_OBJECT_LIST, &objects,
+                               &objects_index));
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_TELEMETRY_SUBSCRIPTION_ATTR_COUNTER_LIST, &counters,
+                               &counters_index));
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_TELEMETRY_SUBSCRIPTION_ATTR_SOCKET_PATH, &path,
+                               &path_index));
+
+    if ((0 == objects->objlist.count) || (objects->objlist.count > TELEMETRY_MAX_OBJECTS)) {
+        STUB_LOG_ERR("Invalid telemetry object count %u, should be 1 to %u\n", objects->objlist.count,
+                     TELEMETRY_MAX_OBJECTS);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + objects_index;
+    }
+
+    object_type = sai_object_type_query(objects->objlist.list[0]);
+    if ((SAI_OBJECT_TYPE_PORT != object_type) && (SAI_OBJECT_TYPE_QUEUE != object_type) &&
+        (SAI_OBJECT_TYPE_INGRESS_PRIORITY_GROUP != object_type)) {
+        STUB_LOG_ERR("Invalid telemetry object type %d\n", object_type);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + objects_index;
+    }
+
+    for (ii = 1; ii < objects->objlist.count; ii++) {
+        if (sai_object_type_query(objects->objlist.list[ii]) != object_type) {
+            STUB_LOG_ERR("Telemetry objects of different types\n");
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + objects_index;
+        }
+    }
+
+    if ((0 == counters->s32list.count) || (counters->s32list.count > TELEMETRY_MAX_COUNTERS)) {
+        STUB_LOG_ERR("Invalid telemetry counter count %u, should be 1 to %u\n", counters->s32list.count,
+                     TELEMETRY_MAX_COUNTERS);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + counters_index;
+    }
+
+    if (('\0' == path->chardata[0]) || (NULL == memchr(path->chardata, '\0', SAI_TELEMETRY_SOCKET_PATH_SIZE))) {
+        STUB_LOG_ERR("Invalid telemetry socket path\n");
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + path_index;
+    }
+
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_TELEMETRY_SUBSCRIPTION_ATTR_INTERVAL, &interval,
+                            &interval_index)) {
+        if (0 == interval->u32) {
+            STUB_LOG_ERR("Invalid telemetry interval 0\n");
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + interval_index;
+        }
+        interval_us = interval->u32;
+    }
+
+    pthread_mutex_lock(&telemetry_lock);
+
+    if (SAI_STATUS_SUCCESS != (status = db_find_free_telemetry_index(&db_id))) {
+        pthread_mutex_unlock(&telemetry_lock);
+        return status;
+    }
+
+    telemetry = &telemetry_db[db_id];
+    memset(telemetry, 0, sizeof(*telemetry));
+    telemetry->object_type   = object_type;
+    telemetry->object_count  = objects->objlist.count;
+    telemetry->counter_count = counters->s32list.count;
+    memcpy(telemetry->objects, objects->objlist.list, telemetry->object_count * sizeof(sai_object_id_t));
+    memcpy(telemetry->counter_ids, counters->s32list.list, telemetry->counter_count * sizeof(int32_t));
+
+    /* Objects and counter ids are checked by reading them, the watermarks then restart for the subscription */
+    db_sim_lock();
+    for (ii = 0; ii < telemetry->object_count; ii++) {
+        if (SAI_STATUS_SUCCESS !=
+            (status = telemetry_object_sample(object_type, telemetry->objects[ii], db_id, telemetry->counter_ids,
+                                              telemetry->counter_count, telemetry_sample))) {
+            break;
+        }
+        telemetry_object_restart(object_type, telemetry->objects[ii], db_id);
+    }
+    db_sim_unlock();
+
+    if (SAI_STATUS_SUCCESS != status) {
+        pthread_mutex_unlock(&telemetry_lock);
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = telemetry_start())) {
+        pthread_mutex_unlock(&telemetry_lock);
+        return status;
+    }
+
+    strncpy(telemetry->path, path->chardata, SAI_TELEMETRY_SOCKET_PATH_SIZE - 1);
+    telemetry->address.sun_family = AF_UNIX;
+    strncpy(telemetry->address.sun_path, telemetry->path, sizeof(telemetry->address.sun_path) - 1);
+    telemetry->interval = interval_us;
+    telemetry->next_ns  = telemetry_now(CLOCK_MONOTONIC) + telemetry->interval * 1000ULL;
+    telemetry->keyframe = true;
+    telemetry->is_valid = true;
+    pthread_cond_signal(&telemetry_cond);
+
+    pthread_mutex_unlock(&telemetry_lock);
+
+    stub_create_object(SAI_OBJECT_TYPE_TELEMETRY_SUBSCRIPTION, db_id, subscription_id);
+    telemetry_key_to_str(*subscription_id, key_str);
+    STUB_LOG_NTC("Created %s\n", key_str);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Remove telemetry subscription.
+ *
+ * Arguments:
+ *    [in] subscription_id - telemetry subscription id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_telemetry_subscription(_In_ sai_object_id_t subscription_id)
+{
+    stub_telemetry_t *telemetry;
+    char              key_str[MAX_KEY_STR_LEN];
+    sai_status_t      status;
+    uint32_t          db_id;
+
+    STUB_LOG_ENTER();
+
+    telemetry_key_to_str(subscription_id, key_str);
+    STUB_LOG_NTC("Remove %s\n", key_str);
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_object_to_type(subscription_id, SAI_OBJECT_TYPE_TELEMETRY_SUBSCRIPTION, &db_id))) {
+        return status;
+    }
+
+    pthread_mutex_lock(&telemetry_lock);
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_telemetry(db_id, &telemetry))) {
+        pthread_mutex_unlock(&telemetry_lock);
+        return status;
+    }
+
+    telemetry->is_valid = false;
+
+    pthread_mutex_unlock(&telemetry_lock);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Set telemetry subscription attribute.
+ *
+ * Arguments:
+ *    [in] subscription_id - telemetry subscription id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_telemetry_subscription_attribute(_In_ sai_object_id_t        subscription_id,
+                                                       _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = subscription_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    telemetry_key_to_str(subscription_id, key_str);
+    return sai_set_attribute(&key, key_str, telemetry_attribs, telemetry_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get telemetry subscription attributes.
+ *
+ * Arguments:
+ *    [in] subscription_id - telemetry subscription id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_telemetry_subscription_attribute(_In_ sai_object_id_t     subscription_id,
+                                                       _In_ uint32_t            attr_count,
+                                                       _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = subscription_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    telemetry_key_to_str(subscription_id, key_str);
+    return sai_get_attributes(&key, key_str, telemetry_attribs, telemetry_vendor_attribs, attr_count, attr_list);
+}
+
+/* Telemetry subscription attributes [sai_object_list_t, sai_s32_list_t, char[], uint32_t interval] */
+sai_status_t stub_telemetry_attr_get(_In_ const sai_object_key_t   *key,
+                                     _Inout_ sai_attribute_value_t *value,
+                                     _In_ uint32_t                  attr_index,
+                                     _Inout_ vendor_cache_t        *cache,
+                                     void                          *arg)
+{
+    stub_telemetry_t *telemetry;
+    sai_status_t      status;
+    uint32_t          db_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_TELEMETRY_SUBSCRIPTION, &db_id))) {
+        return status;
+    }
+
+    pthread_mutex_lock(&telemetry_lock);
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_telemetry(db_id, &telemetry))) {
+        pthread_mutex_unlock(&telemetry_lock);
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_TELEMETRY_SUBSCRIPTION_ATTR_OBJECT_LIST:
+        status = stub_fill_objlist(telemetry->objects, telemetry->object_count, &value->objlist);
+        break;
+
+    case SAI_TELEMETRY_SUBSCRIPTION_ATTR_COUNTER_LIST:
+        status = stub_fill_s32list(telemetry->counter_ids, telemetry->counter_count, &value->s32list);
+        break;
+
+    case SAI_TELEMETRY_SUBSCRIPTION_ATTR_SOCKET_PATH:
+        strncpy(value->chardata, telemetry->path, SAI_TELEMETRY_SOCKET_PATH_SIZE);
+        break;
+
+    case SAI_TELEMETRY_SUBSCRIPTION_ATTR_INTERVAL:
+        value->u32 = telemetry->interval;
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid telemetry subscription attribute %d\n", (int)(int64_t)arg);
+        status = SAI_STATUS_INVALID_PARAMETER;
+        break;
+    }
+
+    pthread_mutex_unlock(&telemetry_lock);
+
+    STUB_LOG_EXIT();
+    return status;
+}
+
+/* Telemetry subscription interval [uint32_t], the next sample is due one new interval from now */
+sai_status_t stub_telemetry_interval_set(_In_ const sai_object_key_t      *key,
+                                         _In_ const sai_attribute_value_t *value,
+                                         void                             *arg)
+{
+    stub_telemetry_t *telemetry;
+    sai_status_t      status;
+    uint32_t          db_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_TELEMETRY_SUBSCRIPTION, &db_id))) {
+        return status;
+    }
+
+    if (0 == value->u32) {
+        STUB_LOG_ERR("Invalid telemetry interval 0\n");
+        return SAI_STATUS_INVALID_ATTR_VALUE_0;
+    }
+
+    pthread_mutex_lock(&telemetry_lock);
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_telemetry(db_id, &telemetry))) {
+        pthread_mutex_unlock(&telemetry_lock);
+        return status;
+    }
+
+    telemetry->interval = value->u32;
+    telemetry->next_ns  = telemetry_now(CLOCK_MONOTONIC) + telemetry->interval * 1000ULL;
+    pthread_cond_signal(&telemetry_cond);
+
+    pthread_mutex_unlock(&telemetry_lock);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+const sai_telemetry_api_t telemetry_api = {
+    stub_create_telemetry_subscription,
+    stub_remove_telemetry_subscription,
+    stub_set_telemetry_subscription_attribute,
+    stub_get_telemetry_subscription_attribute
+};
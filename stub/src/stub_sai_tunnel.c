@@ -0,0 +1,1978 @@
+/*
+ *  Copyright (C) 2014. Mellanox Technologies, Ltd. ALL RIGHTS RESERVED.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ */
+
+#include "sai.h"
+#include "stub_sai.h"
+#include "assert.h"
+#include "inttypes.h"
+
+#undef  __MODULE__
+#define __MODULE__ SAI_TUNNEL
+
+static const sai_attribute_entry_t tunnel_map_attribs[] = {
+    { SAI_TUNNEL_MAP_ATTR_TYPE, true, true, false, true,
+      "Tunnel map type", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_TUNNEL_MAP_ATTR_MAP_TO_VALUE_LIST, true, true, false, true,
+      "Tunnel map to value list", SAI_ATTR_VAL_TYPE_TUNNELMAP },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+/* Only IP in IP tunnels are supported, their conditionally mandatory attributes are always mandatory */
+static const sai_attribute_entry_t tunnel_attribs[] = {
+    { SAI_TUNNEL_ATTR_TYPE, true, true, false, true,
+      "Tunnel type", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_TUNNEL_ATTR_UNDERLAY_INTERFACE, true, true, false, true,
+      "Tunnel underlay interface", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_TUNNEL_ATTR_OVERLAY_INTERFACE, true, true, false, true,
+      "Tunnel overlay interface", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_TUNNEL_ATTR_ENCAP_SRC_IP, true, true, false, true,
+      "Tunnel encap source IP", SAI_ATTR_VAL_TYPE_IPADDR },
+    { SAI_TUNNEL_ATTR_ENCAP_TTL_MODE, false, true, false, true,
+      "Tunnel encap TTL mode", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_TUNNEL_ATTR_ENCAP_TTL_VAL, false, true, false, true,
+      "Tunnel encap TTL value", SAI_ATTR_VAL_TYPE_U8 },
+    { SAI_TUNNEL_ATTR_ENCAP_DSCP_MODE, false, true, false, true,
+      "Tunnel encap DSCP mode", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_TUNNEL_ATTR_ENCAP_DSCP_VAL, false, true, false, true,
+      "Tunnel encap DSCP value", SAI_ATTR_VAL_TYPE_U8 },
+    { SAI_TUNNEL_ATTR_ENCAP_GRE_KEY_VALID, false, true, false, true,
+      "Tunnel encap GRE key valid", SAI_ATTR_VAL_TYPE_BOOL },
+    { SAI_TUNNEL_ATTR_ENCAP_GRE_KEY, false, true, false, true,
+      "Tunnel encap GRE key", SAI_ATTR_VAL_TYPE_U32 },
+    { SAI_TUNNEL_ATTR_ENCAP_ECN_MODE, false, true, false, true,
+      "Tunnel encap ECN mode", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_TUNNEL_ATTR_ENCAP_MAPPERS, false, true, false, true,
+      "Tunnel encap mappers", SAI_ATTR_VAL_TYPE_OBJLIST },
+    { SAI_TUNNEL_ATTR_DECAP_ECN_MODE, false, true, false, true,
+      "Tunnel decap ECN mode", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_TUNNEL_ATTR_DECAP_MAPPERS, false, true, false, true,
+      "Tunnel decap mappers", SAI_ATTR_VAL_TYPE_OBJLIST },
+    { SAI_TUNNEL_ATTR_DECAP_TTL_MODE, true, true, false, true,
+      "Tunnel decap TTL mode", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_TUNNEL_ATTR_DECAP_DSCP_MODE, true, true, false, true,
+      "Tunnel decap DSCP mode", SAI_ATTR_VAL_TYPE_S32 },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+static const sai_attribute_entry_t tunnel_term_attribs[] = {
+    { SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_VR_ID, true, true, false, true,
+      "Tunnel term entry virtual router", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_TYPE, true, true, false, true,
+      "Tunnel term entry type", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_DST_IP, true, true, false, true,
+      "Tunnel term entry destination IP", SAI_ATTR_VAL_TYPE_IPADDR },
+    { SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_SRC_IP, false, true, false, true,
+      "Tunnel term entry source IP", SAI_ATTR_VAL_TYPE_IPADDR },
+    { SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_TUNNEL_TYPE, false, true, false, true,
+      "Tunnel term entry tunnel type", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_ACTION_TUNNEL_ID, true, true, false, true,
+      "Tunnel term entry action tunnel", SAI_ATTR_VAL_TYPE_OID },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+sai_status_t stub_tunnel_map_attr_get(_In_ const sai_object_key_t   *key,
+                                      _Inout_ sai_attribute_value_t *value,
+                                      _In_ uint32_t                  attr_index,
+                                      _Inout_ vendor_cache_t        *cache,
+                                      void                          *arg);
+sai_status_t stub_tunnel_attr_get(_In_ const sai_object_key_t   *key,
+                                  _Inout_ sai_attribute_value_t *value,
+                                  _In_ uint32_t                  attr_index,
+                                  _Inout_ vendor_cache_t        *cache,
+                                  void                          *arg);
+sai_status_t stub_tunnel_term_attr_get(_In_ const sai_object_key_t   *key,
+                                       _Inout_ sai_attribute_value_t *value,
+                                       _In_ uint32_t                  attr_index,
+                                       _Inout_ vendor_cache_t        *cache,
+                                       void                          *arg);
+
+static const sai_vendor_attribute_entry_t tunnel_map_vendor_attribs[] = {
+    { SAI_TUNNEL_MAP_ATTR_TYPE,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_tunnel_map_attr_get, (void*)SAI_TUNNEL_MAP_ATTR_TYPE,
+      NULL, NULL },
+    { SAI_TUNNEL_MAP_ATTR_MAP_TO_VALUE_LIST,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_tunnel_map_attr_get, (void*)SAI_TUNNEL_MAP_ATTR_MAP_TO_VALUE_LIST,
+      NULL, NULL },
+};
+
+static const sai_vendor_attribute_entry_t tunnel_vendor_attribs[] = {
+    { SAI_TUNNEL_ATTR_TYPE,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_tunnel_attr_get, (void*)SAI_TUNNEL_ATTR_TYPE,
+      NULL, NULL },
+    { SAI_TUNNEL_ATTR_UNDERLAY_INTERFACE,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_tunnel_attr_get, (void*)SAI_TUNNEL_ATTR_UNDERLAY_INTERFACE,
+      NULL, NULL },
+    { SAI_TUNNEL_ATTR_OVERLAY_INTERFACE,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_tunnel_attr_get, (void*)SAI_TUNNEL_ATTR_OVERLAY_INTERFACE,
+      NULL, NULL },
+    { SAI_TUNNEL_ATTR_ENCAP_SRC_IP,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_tunnel_attr_get, (void*)SAI_TUNNEL_ATTR_ENCAP_SRC_IP,
+      NULL, NULL },
+    { SAI_TUNNEL_ATTR_ENCAP_TTL_MODE,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_tunnel_attr_get, (void*)SAI_TUNNEL_ATTR_ENCAP_TTL_MODE,
+      NULL, NULL },
+    { SAI_TUNNEL_ATTR_ENCAP_TTL_VAL,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_tunnel_attr_get, (void*)SAI_TUNNEL_ATTR_ENCAP_TTL_VAL,
+      NULL, NULL },
+    { SAI_TUNNEL_ATTR_ENCAP_DSCP_MODE,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_tunnel_attr_get, (void*)SAI_TUNNEL_ATTR_ENCAP_DSCP_MODE,
+      NULL, NULL },
+    { SAI_TUNNEL_ATTR_ENCAP_DSCP_VAL,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_tunnel_attr_get, (void*)SAI_TUNNEL_ATTR_ENCAP_DSCP_VAL,
+      NULL, NULL },
+    { SAI_TUNNEL_ATTR_ENCAP_GRE_KEY_VALID,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_tunnel_attr_get, (void*)SAI_TUNNEL_ATTR_ENCAP_GRE_KEY_VALID,
+      NULL, NULL },
+    { SAI_TUNNEL_ATTR_ENCAP_GRE_KEY,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_tunnel_attr_get, (void*)SAI_TUNNEL_ATTR_ENCAP_GRE_KEY,
+      NULL, NULL },
+    { SAI_TUNNEL_ATTR_ENCAP_ECN_MODE,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_tunnel_attr_get, (void*)SAI_TUNNEL_ATTR_ENCAP_ECN_MODE,
+      NULL, NULL },
+    { SAI_TUNNEL_ATTR_ENCAP_MAPPERS,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_tunnel_attr_get, (void*)SAI_TUNNEL_ATTR_ENCAP_MAPPERS,
+      NULL, NULL },
+    { SAI_TUNNEL_ATTR_DECAP_ECN_MODE,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_tunnel_attr_get, (void*)SAI_TUNNEL_ATTR_DECAP_ECN_MODE,
+      NULL, NULL },
+    { SAI_TUNNEL_ATTR_DECAP_MAPPERS,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_tunnel_attr_get, (void*)SAI_TUNNEL_ATTR_DECAP_MAPPERS,
+      NULL, NULL },
+    { SAI_TUNNEL_ATTR_DECAP_TTL_MODE,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_tunnel_attr_get, (void*)SAI_TUNNEL_ATTR_DECAP_TTL_MODE,
+      NULL, NULL },
+    { SAI_TUNNEL_ATTR_DECAP_DSCP_MODE,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_tunnel_attr_get, (void*)SAI_TUNNEL_ATTR_DECAP_DSCP_MODE,
+      NULL, NULL },
+};
+
+static const sai_vendor_attribute_entry_t tunnel_term_vendor_attribs[] = {
+    { SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_VR_ID,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_tunnel_term_attr_get, (void*)SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_VR_ID,
+      NULL, NULL },
+    { SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_TYPE,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_tunnel_term_attr_get, (void*)SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_TYPE,
+      NULL, NULL },
+    { SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_DST_IP,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_tunnel_term_attr_get, (void*)SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_DST_IP,
+      NULL, NULL },
+    { SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_SRC_IP,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_tunnel_term_attr_get, (void*)SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_SRC_IP,
+      NULL, NULL },
+    { SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_TUNNEL_TYPE,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_tunnel_term_attr_get, (void*)SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_TUNNEL_TYPE,
+      NULL, NULL },
+    { SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_ACTION_TUNNEL_ID,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_tunnel_term_attr_get, (void*)SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_ACTION_TUNNEL_ID,
+      NULL, NULL },
+};
+
+/* State DB *************/
+
+/*
+ * Tunnel termination entries are kept in an open addressing hash table with
+ * linear probing, keyed by virtual router, entry type and outer addresses.
+ * A received packet is looked up as P2P, with both outer addresses, then as
+ * P2MP, with the destination only. Slots keep the key hash so probing
+ * compares keys only on a hash match, and removal shifts the following
+ * entries back instead of leaving deleted markers.
+ *
+ * Decap pops the outer header by moving the packet start forward, encap
+ * pushes the outer header into the headroom in front of the packet, so the
+ * packet itself is never copied. The ECN handling of a tunnel, standard or
+ * user defined by its tunnel maps, is compiled into small tables at create.
+ */
+#define MAX_TUNNEL_MAP_NUMBER      32
+#define MAX_TUNNEL_NUMBER          1024
+#define MAX_TUNNEL_TERM_NUMBER     16384
+/* Power of 2, at most half full */
+#define TUNNEL_TERM_HASH_SIZE      (2 * MAX_TUNNEL_TERM_NUMBER)
+#define TUNNEL_MAPPERS             4
+#define TUNNEL_ECN_VALUES          4
+/* Every outer and inner ECN pair */
+#define TUNNEL_MAP_ENTRIES         (TUNNEL_ECN_VALUES * TUNNEL_ECN_VALUES)
+#define TUNNEL_ECN_NOT_ECT         0
+#define TUNNEL_ECN_ECT1            1
+#define TUNNEL_ECN_ECT0            2
+#define TUNNEL_ECN_CE              3
+#define TUNNEL_ECN_DROP            0xFF
+#define TUNNEL_DSCP_MAX            63
+#define TUNNEL_IP_PROTOCOL_IPV4    4
+#define TUNNEL_IP_PROTOCOL_IPV6    41
+#define TUNNEL_IP_PROTOCOL_GRE     47
+#define TUNNEL_ETHERTYPE_IPV4      0x0800
+#define TUNNEL_ETHERTYPE_IPV6      0x86DD
+#define TUNNEL_IPV4_HEADER_SIZE    20
+#define TUNNEL_IPV6_HEADER_SIZE    40
+#define TUNNEL_IPV4_LENGTH_MAX     0xFFFF
+#define TUNNEL_IPV4_FLAG_DF        0x4000
+#define TUNNEL_IPV4_FRAGMENT_MASK  0x3FFF
+#define TUNNEL_GRE_HEADER_SIZE     4
+#define TUNNEL_GRE_FIELD_SIZE      4
+#define TUNNEL_GRE_FLAG_CSUM       0x8000
+#define TUNNEL_GRE_FLAG_KEY        0x2000
+#define TUNNEL_GRE_FLAG_SEQ        0x1000
+
+typedef struct _stub_tunnel_map_t {
+    sai_tunnel_map_type_t type;
+    uint32_t              count;
+    sai_tunnel_map_t      list[TUNNEL_MAP_ENTRIES];
+    uint32_t              ref_count;
+    bool                  is_valid;
+} stub_tunnel_map_t;
+
+typedef struct _stub_tunnel_t {
+    sai_tunnel_type_t           type;
+    sai_object_id_t             underlay_rif;
+    sai_object_id_t             overlay_rif;
+    sai_ip_address_t            src_ip;
+    sai_tunnel_ttl_mode_t       encap_ttl_mode;
+    uint8_t                     encap_ttl;
+    sai_tunnel_dscp_mode_t      encap_dscp_mode;
+    uint8_t                     encap_dscp;
+    bool                        gre_key_valid;
+    uint32_t                    gre_key;
+    sai_tunnel_encap_ecn_mode_t encap_ecn_mode;
+    uint32_t                    encap_mapper_count;
+    sai_object_id_t             encap_mappers[TUNNEL_MAPPERS];
+    sai_tunnel_decap_ecn_mode_t decap_ecn_mode;
+    uint32_t                    decap_mapper_count;
+    sai_object_id_t             decap_mappers[TUNNEL_MAPPERS];
+    sai_tunnel_ttl_mode_t       decap_ttl_mode;
+    sai_tunnel_dscp_mode_t      decap_dscp_mode;
+    /* Outer ECN by inner ECN */
+    uint8_t                     encap_ecn[TUNNEL_ECN_VALUES];
+    /* Inner ECN by outer and inner ECN, TUNNEL_ECN_DROP to drop */
+    uint8_t                     decap_ecn[TUNNEL_ECN_VALUES][TUNNEL_ECN_VALUES];
+    uint16_t                    ip_id;
+    uint32_t                    ref_count;
+    bool                        is_valid;
+} stub_tunnel_t;
+
+/* Hashed and compared as a whole, unused bytes are zero */
+typedef struct _stub_tunnel_term_key_t {
+    uint32_t vr_id;
+    uint8_t  type;
+    uint8_t  family;
+    uint8_t  reserved[2];
+    uint8_t  dst[16];
+    uint8_t  src[16];
+} stub_tunnel_term_key_t;
+
+typedef struct _stub_tunnel_term_t {
+    stub_tunnel_term_key_t key;
+    sai_object_id_t        vr;
+    sai_ip_address_t       dst_ip;
+    sai_ip_address_t       src_ip;
+    /* Type of the tunnel, given for P2P entries */
+    sai_tunnel_type_t      tunnel_type;
+    sai_object_id_t        tunnel;
+    uint32_t               tunnel_db_id;
+    bool                   is_valid;
+} stub_tunnel_term_t;
+
+typedef struct _stub_tunnel_term_slot_t {
+    uint32_t hash;
+    /* Term entry index plus one, 0 for a free slot */
+    uint32_t index;
+} stub_tunnel_term_slot_t;
+
+static stub_tunnel_map_t       tunnel_map_db[MAX_TUNNEL_MAP_NUMBER];
+static stub_tunnel_t           tunnel_db[MAX_TUNNEL_NUMBER];
+static stub_tunnel_term_t      tunnel_term_db[MAX_TUNNEL_TERM_NUMBER];
+static stub_tunnel_term_slot_t tunnel_term_hash[TUNNEL_TERM_HASH_SIZE];
+/* No free term entry below this index */
+static uint32_t                tunnel_term_free_hint;
+
+/* RFC 6040 decapsulation, inner ECN by outer and inner ECN */
+static const uint8_t tunnel_decap_ecn_standard[TUNNEL_ECN_VALUES][TUNNEL_ECN_VALUES] = {
+    /* Outer Not-ECT */
+    { TUNNEL_ECN_NOT_ECT, TUNNEL_ECN_ECT1, TUNNEL_ECN_ECT0, TUNNEL_ECN_CE },
+    /* Outer ECT(1) */
+    { TUNNEL_ECN_NOT_ECT, TUNNEL_ECN_ECT1, TUNNEL_ECN_ECT1, TUNNEL_ECN_CE },
+    /* Outer ECT(0) */
+    { TUNNEL_ECN_NOT_ECT, TUNNEL_ECN_ECT1, TUNNEL_ECN_ECT0, TUNNEL_ECN_CE },
+    /* Outer CE */
+    { TUNNEL_ECN_DROP, TUNNEL_ECN_CE, TUNNEL_ECN_CE, TUNNEL_ECN_CE }
+};
+
+static sai_status_t db_get_tunnel_map(_In_ uint32_t map_id, _Out_ stub_tunnel_map_t **map)
+{
+    if ((map_id >= MAX_TUNNEL_MAP_NUMBER) || (!tunnel_map_db[map_id].is_valid)) {
+        STUB_LOG_ERR("Invalid tunnel map ID %u\n", map_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *map = &tunnel_map_db[map_id];
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t db_find_free_tunnel_map_index(_Out_ uint32_t *free_index)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < MAX_TUNNEL_MAP_NUMBER; ii++) {
+        if (false == tunnel_map_db[ii].is_valid) {
+            *free_index = ii;
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+
+    STUB_LOG_ERR("Tunnel map table full\n");
+    return SAI_STATUS_TABLE_FULL;
+}
+
+static sai_status_t db_get_tunnel(_In_ uint32_t tunnel_id, _Out_ stub_tunnel_t **tunnel)
+{
+    if ((tunnel_id >= MAX_TUNNEL_NUMBER) || (!tunnel_db[tunnel_id].is_valid)) {
+        STUB_LOG_ERR("Invalid tunnel ID %u\n", tunnel_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *tunnel = &tunnel_db[tunnel_id];
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t db_find_free_tunnel_index(_Out_ uint32_t *free_index)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < MAX_TUNNEL_NUMBER; ii++) {
+        if (false == tunnel_db[ii].is_valid) {
+            *free_index = ii;
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+
+    STUB_LOG_ERR("Tunnel table full\n");
+    return SAI_STATUS_TABLE_FULL;
+}
+
+static sai_status_t db_get_tunnel_term(_In_ uint32_t entry_id, _Out_ stub_tunnel_term_t **entry)
+{
+    if ((entry_id >= MAX_TUNNEL_TERM_NUMBER) || (!tunnel_term_db[entry_id].is_valid)) {
+        STUB_LOG_ERR("Invalid tunnel term table entry ID %u\n", entry_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *entry = &tunnel_term_db[entry_id];
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t db_find_free_tunnel_term_index(_Out_ uint32_t *free_index)
+{
+    uint32_t ii;
+
+    for (ii = tunnel_term_free_hint; ii < MAX_TUNNEL_TERM_NUMBER; ii++) {
+        if (false == tunnel_term_db[ii].is_valid) {
+            *free_index           = ii;
+            tunnel_term_free_hint = ii + 1;
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+
+    STUB_LOG_ERR("Tunnel term table full\n");
+    return SAI_STATUS_TABLE_FULL;
+}
+
+static uint16_t tunnel_get16(_In_ const uint8_t *p)
+{
+    return (uint16_t)((p[0] << 8) | p[1]);
+}
+
+static void tunnel_put16(_Out_ uint8_t *p, _In_ uint16_t value)
+{
+    p[0] = value >> 8;
+    p[1] = value & 0xFF;
+}
+
+static uint32_t tunnel_checksum_add(_In_ uint32_t sum, _In_ const uint8_t *p, _In_ uint32_t length)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < length; ii += 2) {
+        sum += tunnel_get16(p + ii);
+    }
+
+    return sum;
+}
+
+static uint16_t tunnel_checksum_fold(_In_ uint32_t sum)
+{
+    while (sum >> 16) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+
+    return (uint16_t)~sum;
+}
+
+/* RFC 1624 checksum update for two 16 bit header words changing */
+static void tunnel_checksum_update(_Inout_ uint8_t *checksum,
+                                   _In_ uint16_t     old_first,
+                                   _In_ uint16_t     new_first,
+                                   _In_ uint16_t     old_second,
+                                   _In_ uint16_t     new_second)
+{
+    uint32_t sum;
+
+    sum  = (uint16_t)~tunnel_get16(checksum);
+    sum += (uint16_t)~old_first + new_first;
+    sum += (uint16_t)~old_second + new_second;
+
+    tunnel_put16(checksum, tunnel_checksum_fold(sum));
+}
+
+static uint32_t tunnel_term_key_hash(_In_ const stub_tunnel_term_key_t *key)
+{
+    uint64_t words[sizeof(*key) / sizeof(uint64_t)];
+    uint64_t hash = 0;
+    uint32_t ii;
+
+    memcpy(words, key, sizeof(words));
+    for (ii = 0; ii < sizeof(words) / sizeof(words[0]); ii++) {
+        hash  = (hash ^ words[ii]) * 0x9E3779B97F4A7C15ULL;
+        hash ^= hash >> 29;
+    }
+
+    return (uint32_t)(hash >> 32);
+}
+
+static void tunnel_term_key_fill(_Out_ stub_tunnel_term_key_t            *key,
+                                 _In_ uint32_t                            vr_id,
+                                 _In_ sai_tunnel_term_table_entry_type_t  type,
+                                 _In_ const sai_ip_address_t             *dst_ip,
+                                 _In_ const sai_ip_address_t             *src_ip)
+{
+    memset(key, 0, sizeof(*key));
+    key->vr_id  = vr_id;
+    key->type   = type;
+    key->family = dst_ip->addr_family;
+
+    if (SAI_IP_ADDR_FAMILY_IPV4 == dst_ip->addr_family) {
+        memcpy(key->dst, &dst_ip->addr.ip4, sizeof(dst_ip->addr.ip4));
+    } else {
+        memcpy(key->dst, dst_ip->addr.ip6, sizeof(dst_ip->addr.ip6));
+    }
+
+    if (NULL == src_ip) {
+        return;
+    }
+
+    if (SAI_IP_ADDR_FAMILY_IPV4 == src_ip->addr_family) {
+        memcpy(key->src, &src_ip->addr.ip4, sizeof(src_ip->addr.ip4));
+    } else {
+        memcpy(key->src, src_ip->addr.ip6, sizeof(src_ip->addr.ip6));
+    }
+}
+
+static stub_tunnel_term_t* tunnel_term_lookup(_In_ const stub_tunnel_term_key_t *key, _In_ uint32_t hash)
+{
+    const stub_tunnel_term_slot_t *slot;
+    uint32_t                       ii;
+
+    for (ii = hash & (TUNNEL_TERM_HASH_SIZE - 1); tunnel_term_hash[ii].index;
+         ii = (ii + 1) & (TUNNEL_TERM_HASH_SIZE - 1)) {
+        slot = &tunnel_term_hash[ii];
+        if ((hash == slot->hash) && (0 == memcmp(&tunnel_term_db[slot->index - 1].key, key, sizeof(*key)))) {
+            return &tunnel_term_db[slot->index - 1];
+        }
+    }
+
+    return NULL;
+}
+
+static void tunnel_term_hash_insert(_In_ uint32_t entry_id)
+{
+    uint32_t hash = tunnel_term_key_hash(&tunnel_term_db[entry_id].key);
+    uint32_t ii;
+
+    for (ii = hash & (TUNNEL_TERM_HASH_SIZE - 1); tunnel_term_hash[ii].index;
+         ii = (ii + 1) & (TUNNEL_TERM_HASH_SIZE - 1)) {
+    }
+
+    tunnel_term_hash[ii].hash  = hash;
+    tunnel_term_hash[ii].index = entry_id + 1;
+}
+
+static void tunnel_term_hash_remove(_In_ uint32_t entry_id)
+{
+    const uint32_t mask = TUNNEL_TERM_HASH_SIZE - 1;
+    uint32_t       free, next, home;
+
+    for (free = tunnel_term_key_hash(&tunnel_term_db[entry_id].key) & mask;
+         tunnel_term_hash[free].index != entry_id + 1; free = (free + 1) & mask) {
+        assert(tunnel_term_hash[free].index);
+    }
+
+    /* Move back each following entry of the run whose home slot is not between the hole and itself */
+    for (next = (free + 1) & mask; tunnel_term_hash[next].index; next = (next + 1) & mask) {
+        home = tunnel_term_hash[next].hash & mask;
+        if (((next - home) & mask) >= ((next - free) & mask)) {
+            tunnel_term_hash[free] = tunnel_term_hash[next];
+            free                   = next;
+        }
+    }
+
+    tunnel_term_hash[free].index = 0;
+}
+
+/* Compile the ECN handling of a tunnel from its modes and tunnel maps */
+static void tunnel_ecn_compile(_Inout_ stub_tunnel_t *tunnel)
+{
+    const stub_tunnel_map_t *map;
+    uint32_t                 map_id, ii, jj;
+
+    for (ii = 0; ii < TUNNEL_ECN_VALUES; ii++) {
+        tunnel->encap_ecn[ii] = ii;
+        for (jj = 0; jj < TUNNEL_ECN_VALUES; jj++) {
+            tunnel->decap_ecn[ii][jj] = (SAI_TUNNEL_DECAP_ECN_MODE_COPY_FROM_OUTER == tunnel->decap_ecn_mode) ?
+                                        ii : tunnel_decap_ecn_standard[ii][jj];
+        }
+    }
+
+    for (ii = 0; (SAI_TUNNEL_ENCAP_ECN_MODE_USER_DEFINED == tunnel->encap_ecn_mode) &&
+         (ii < tunnel->encap_mapper_count); ii++) {
+        assert(SAI_STATUS_SUCCESS == stub_object_to_type(tunnel->encap_mappers[ii], SAI_OBJECT_TYPE_TUNNEL_MAP,
+                                                         &map_id));
+        map = &tunnel_map_db[map_id];
+        for (jj = 0; jj < map->count; jj++) {
+            tunnel->encap_ecn[map->list[jj].key.oecn] = map->list[jj].value.uecn;
+        }
+    }
+
+    for (ii = 0; (SAI_TUNNEL_DECAP_ECN_MODE_USER_DEFINED == tunnel->decap_ecn_mode) &&
+         (ii < tunnel->decap_mapper_count); ii++) {
+        assert(SAI_STATUS_SUCCESS == stub_object_to_type(tunnel->decap_mappers[ii], SAI_OBJECT_TYPE_TUNNEL_MAP,
+                                                         &map_id));
+        map = &tunnel_map_db[map_id];
+        for (jj = 0; jj < map->count; jj++) {
+            tunnel->decap_ecn[map->list[jj].key.uecn][map->list[jj].key.oecn] = map->list[jj].value.oecn;
+        }
+    }
+}
+
+static void tunnel_mappers_ref(_In_ const stub_tunnel_t *tunnel, _In_ int32_t delta)
+{
+    uint32_t map_id, ii;
+
+    for (ii = 0; ii < tunnel->encap_mapper_count; ii++) {
+        assert(SAI_STATUS_SUCCESS == stub_object_to_type(tunnel->encap_mappers[ii], SAI_OBJECT_TYPE_TUNNEL_MAP,
+                                                         &map_id));
+        tunnel_map_db[map_id].ref_count += delta;
+    }
+
+    for (ii = 0; ii < tunnel->decap_mapper_count; ii++) {
+        assert(SAI_STATUS_SUCCESS == stub_object_to_type(tunnel->decap_mappers[ii], SAI_OBJECT_TYPE_TUNNEL_MAP,
+                                                         &map_id));
+        tunnel_map_db[map_id].ref_count += delta;
+    }
+}
+
+/*
+ * Terminate one packet : parse the outer IPv4/IPv6 [GRE] header, find the
+ * term entry, then rewrite the inner header by the decap modes and move the
+ * packet start past the outer header.
+ */
+static stub_tunnel_verdict_t tunnel_decap_packet(_In_ uint32_t                 vr_id,
+                                                 _Inout_ stub_tunnel_packet_t *packet,
+                                                 _Out_ sai_object_id_t        *tunnel_id)
+{
+    stub_tunnel_term_key_t    key;
+    const stub_tunnel_term_t *entry;
+    const stub_tunnel_t      *tunnel;
+    sai_tunnel_type_t         tunnel_type;
+    uint8_t                  *outer = packet->data, *inner;
+    uint32_t                  outer_length, packet_length, inner_length, gre_flags;
+    uint8_t                   protocol, outer_tos, outer_ttl, inner_version, tos, ecn;
+    uint16_t                  old_first, old_second;
+
+    if (packet->length < TUNNEL_IPV4_HEADER_SIZE) {
+        return STUB_TUNNEL_MISS;
+    }
+
+    memset(&key, 0, sizeof(key));
+    key.vr_id = vr_id;
+    key.type  = SAI_TUNNEL_TERM_TABLE_ENTRY_TYPE_P2P;
+
+    switch (outer[0] >> 4) {
+    case 4:
+        outer_length  = (outer[0] & 0xF) * 4;
+        packet_length = tunnel_get16(outer + 2);
+        if ((outer_length < TUNNEL_IPV4_HEADER_SIZE) || (packet_length < outer_length) ||
+            (packet_length > packet->length) || (tunnel_get16(outer + 6) & TUNNEL_IPV4_FRAGMENT_MASK)) {
+            return STUB_TUNNEL_MISS;
+        }
+        outer_tos  = outer[1];
+        outer_ttl  = outer[8];
+        protocol   = outer[9];
+        key.family = SAI_IP_ADDR_FAMILY_IPV4;
+        memcpy(key.src, outer + 12, 4);
+        memcpy(key.dst, outer + 16, 4);
+        break;
+
+    case 6:
+        outer_length  = TUNNEL_IPV6_HEADER_SIZE;
+        packet_length = TUNNEL_IPV6_HEADER_SIZE + tunnel_get16(outer + 4);
+        if ((packet->length < TUNNEL_IPV6_HEADER_SIZE) || (packet_length > packet->length)) {
+            return STUB_TUNNEL_MISS;
+        }
+        outer_tos  = (outer[0] << 4) | (outer[1] >> 4);
+        outer_ttl  = outer[7];
+        protocol   = outer[6];
+        key.family = SAI_IP_ADDR_FAMILY_IPV6;
+        memcpy(key.src, outer + 8, 16);
+        memcpy(key.dst, outer + 24, 16);
+        break;
+
+    default:
+        return STUB_TUNNEL_MISS;
+    }
+
+    switch (protocol) {
+    case TUNNEL_IP_PROTOCOL_IPV4:
+    case TUNNEL_IP_PROTOCOL_IPV6:
+        tunnel_type   = SAI_TUNNEL_TYPE_IPINIP;
+        inner_version = (TUNNEL_IP_PROTOCOL_IPV4 == protocol) ? 4 : 6;
+        break;
+
+    case TUNNEL_IP_PROTOCOL_GRE:
+        if (packet_length < outer_length + TUNNEL_GRE_HEADER_SIZE) {
+            return STUB_TUNNEL_MISS;
+        }
+        /* RFC 2784 with the RFC 2890 key and sequence, no routing and version 0 */
+        gre_flags = tunnel_get16(outer + outer_length);
+        if (gre_flags & ~(TUNNEL_GRE_FLAG_CSUM | TUNNEL_GRE_FLAG_KEY | TUNNEL_GRE_FLAG_SEQ)) {
+            return STUB_TUNNEL_MISS;
+        }
+        switch (tunnel_get16(outer + outer_length + 2)) {
+        case TUNNEL_ETHERTYPE_IPV4:
+            inner_version = 4;
+            break;
+
+        case TUNNEL_ETHERTYPE_IPV6:
+            inner_version = 6;
+            break;
+
+        default:
+            return STUB_TUNNEL_MISS;
+        }
+        outer_length += TUNNEL_GRE_HEADER_SIZE +
+                        ((gre_flags & TUNNEL_GRE_FLAG_CSUM) ? TUNNEL_GRE_FIELD_SIZE : 0) +
+                        ((gre_flags & TUNNEL_GRE_FLAG_KEY) ? TUNNEL_GRE_FIELD_SIZE : 0) +
+                        ((gre_flags & TUNNEL_GRE_FLAG_SEQ) ? TUNNEL_GRE_FIELD_SIZE : 0);
+        if (packet_length < outer_length) {
+            return STUB_TUNNEL_MISS;
+        }
+        tunnel_type = SAI_TUNNEL_TYPE_IPINIP_GRE;
+        break;
+
+    default:
+        return STUB_TUNNEL_MISS;
+    }
+
+    entry = tunnel_term_lookup(&key, tunnel_term_key_hash(&key));
+    if ((NULL == entry) || (entry->tunnel_type != tunnel_type)) {
+        key.type = SAI_TUNNEL_TERM_TABLE_ENTRY_TYPE_P2MP;
+        memset(key.src, 0, sizeof(key.src));
+        entry = tunnel_term_lookup(&key, tunnel_term_key_hash(&key));
+        if ((NULL == entry) || (entry->tunnel_type != tunnel_type)) {
+            return STUB_TUNNEL_MISS;
+        }
+    }
+
+    tunnel       = &tunnel_db[entry->tunnel_db_id];
+    *tunnel_id   = entry->tunnel;
+    inner        = outer + outer_length;
+    inner_length = packet_length - outer_length;
+
+    if ((inner_length < TUNNEL_IPV4_HEADER_SIZE) || ((inner[0] >> 4) != inner_version) ||
+        ((6 == inner_version) && (inner_length < TUNNEL_IPV6_HEADER_SIZE))) {
+        return STUB_TUNNEL_DROP;
+    }
+
+    if (4 == inner_version) {
+        tos = inner[1];
+    } else {
+        tos = (inner[0] << 4) | (inner[1] >> 4);
+    }
+
+    if (TUNNEL_ECN_DROP == (ecn = tunnel->decap_ecn[outer_tos & 0x3][tos & 0x3])) {
+        return STUB_TUNNEL_DROP;
+    }
+
+    tos = ((SAI_TUNNEL_DSCP_MODE_UNIFORM_MODEL == tunnel->decap_dscp_mode) ? (outer_tos & ~0x3) : (tos & ~0x3)) | ecn;
+
+    if (4 == inner_version) {
+        old_first  = tunnel_get16(inner);
+        old_second = tunnel_get16(inner + 8);
+        inner[1]   = tos;
+        if (SAI_TUNNEL_TTL_MODE_UNIFORM_MODEL == tunnel->decap_ttl_mode) {
+            inner[8] = outer_ttl;
+        }
+        tunnel_checksum_update(inner + 10, old_first, tunnel_get16(inner), old_second, tunnel_get16(inner + 8));
+    } else {
+        inner[0] = (inner[0] & 0xF0) | (tos >> 4);
+        inner[1] = (inner[1] & 0x0F) | (tos << 4);
+        if (SAI_TUNNEL_TTL_MODE_UNIFORM_MODEL == tunnel->decap_ttl_mode) {
+            inner[7] = outer_ttl;
+        }
+    }
+
+    packet->data      = inner;
+    packet->length    = inner_length;
+    packet->headroom += outer_length;
+
+    return STUB_TUNNEL_DECAP;
+}
+
+/*
+ * Routine Description:
+ *    Terminate tunnels on a batch of packets received in a virtual router.
+ *
+ * Arguments:
+ *    [in] vr_id - virtual router the packets are routed in
+ *    [in] count - number of packets
+ *    [inout] packets - packets from their outer IP header on, the inner packet on decap
+ *    [out] verdicts - per packet verdict
+ *    [out] tunnel_ids - per packet terminating tunnel, SAI_NULL_OBJECT_ID on miss
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t db_tunnel_decap(_In_ sai_object_id_t          vr_id,
+                             _In_ uint32_t                 count,
+                             _Inout_ stub_tunnel_packet_t *packets,
+                             _Out_ stub_tunnel_verdict_t  *verdicts,
+                             _Out_ sai_object_id_t        *tunnel_ids)
+{
+    sai_status_t status;
+    uint32_t     vr_db_id, ii;
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(vr_id, SAI_OBJECT_TYPE_VIRTUAL_ROUTER, &vr_db_id))) {
+        return status;
+    }
+
+    for (ii = 0; ii < count; ii++) {
+        tunnel_ids[ii] = SAI_NULL_OBJECT_ID;
+        verdicts[ii]   = tunnel_decap_packet(vr_db_id, &packets[ii], &tunnel_ids[ii]);
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Encapsulate a batch of packets into a tunnel, the outer header is
+ *    written into the headroom of each packet.
+ *
+ * Arguments:
+ *    [in] tunnel_id - tunnel
+ *    [in] dst_ip - outer destination, the tunnel remote end
+ *    [in] count - number of packets
+ *    [inout] packets - packets from their IP header on, from the outer header on when done
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error, no packet is changed
+ */
+sai_status_t db_tunnel_encap(_In_ sai_object_id_t          tunnel_id,
+                             _In_ const sai_ip_address_t  *dst_ip,
+                             _In_ uint32_t                 count,
+                             _Inout_ stub_tunnel_packet_t *packets)
+{
+    stub_tunnel_t *tunnel;
+    sai_status_t   status;
+    uint8_t        header[TUNNEL_HEADROOM];
+    uint8_t       *outer, *inner;
+    uint32_t       db_id, ip_length, header_length, sum, ii;
+    uint16_t       ip_id, total_length, fragment;
+    uint8_t        tos, ttl, protocol;
+    bool           ipv4, gre, inner_ipv4;
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(tunnel_id, SAI_OBJECT_TYPE_TUNNEL, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_tunnel(db_id, &tunnel))) {
+        return status;
+    }
+
+    if (dst_ip->addr_family != tunnel->src_ip.addr_family) {
+        STUB_LOG_ERR("Tunnel %u destination family %d doesn't match source\n", db_id, dst_ip->addr_family);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    ipv4          = (SAI_IP_ADDR_FAMILY_IPV4 == dst_ip->addr_family);
+    gre           = (SAI_TUNNEL_TYPE_IPINIP_GRE == tunnel->type);
+    ip_length     = ipv4 ? TUNNEL_IPV4_HEADER_SIZE : TUNNEL_IPV6_HEADER_SIZE;
+    header_length = ip_length + (gre ? TUNNEL_GRE_HEADER_SIZE + (tunnel->gre_key_valid ? TUNNEL_GRE_FIELD_SIZE : 0) :
+                                 0);
+
+    for (ii = 0; ii < count; ii++) {
+        if (packets[ii].headroom < header_length) {
+            STUB_LOG_ERR("Tunnel %u packet %u headroom %u below %u\n", db_id, ii, packets[ii].headroom,
+                         header_length);
+            return SAI_STATUS_BUFFER_OVERFLOW;
+        }
+        if ((packets[ii].length < TUNNEL_IPV4_HEADER_SIZE) ||
+            ((4 != (packets[ii].data[0] >> 4)) && (6 != (packets[ii].data[0] >> 4))) ||
+            ((6 == (packets[ii].data[0] >> 4)) && (packets[ii].length < TUNNEL_IPV6_HEADER_SIZE)) ||
+            (packets[ii].length + header_length - (ipv4 ? 0 : ip_length) > TUNNEL_IPV4_LENGTH_MAX)) {
+            STUB_LOG_ERR("Tunnel %u packet %u isn't an IP packet that fits the tunnel\n", db_id, ii);
+            return SAI_STATUS_INVALID_PARAMETER;
+        }
+    }
+
+    /* Header template, the per packet fields are left zero and added to the checksum per packet */
+    memset(header, 0, header_length);
+    if (ipv4) {
+        header[0] = 0x45;
+        memcpy(header + 12, &tunnel->src_ip.addr.ip4, 4);
+        memcpy(header + 16, &dst_ip->addr.ip4, 4);
+    } else {
+        header[0] = 0x60;
+        memcpy(header + 8, tunnel->src_ip.addr.ip6, 16);
+        memcpy(header + 24, dst_ip->addr.ip6, 16);
+    }
+    if (gre) {
+        if (tunnel->gre_key_valid) {
+            tunnel_put16(header + ip_length, TUNNEL_GRE_FLAG_KEY);
+            tunnel_put16(header + ip_length + 4, tunnel->gre_key >> 16);
+            tunnel_put16(header + ip_length + 6, tunnel->gre_key & 0xFFFF);
+        }
+    }
+    sum   = tunnel_checksum_add(0, header, TUNNEL_IPV4_HEADER_SIZE);
+    ip_id = __atomic_fetch_add(&tunnel->ip_id, (uint16_t)count, __ATOMIC_RELAXED);
+
+    for (ii = 0; ii < count; ii++) {
+        inner      = packets[ii].data;
+        inner_ipv4 = (4 == (inner[0] >> 4));
+        if (inner_ipv4) {
+            tos      = inner[1];
+            ttl      = inner[8];
+            fragment = tunnel_get16(inner + 6) & TUNNEL_IPV4_FLAG_DF;
+        } else {
+            tos      = (inner[0] << 4) | (inner[1] >> 4);
+            ttl      = inner[7];
+            fragment = TUNNEL_IPV4_FLAG_DF;
+        }
+
+        if (SAI_TUNNEL_TTL_MODE_PIPE_MODEL == tunnel->encap_ttl_mode) {
+            ttl = tunnel->encap_ttl;
+        }
+        tos = (((SAI_TUNNEL_DSCP_MODE_PIPE_MODEL == tunnel->encap_dscp_mode) ? tunnel->encap_dscp : (tos >> 2)) << 2) |
+              tunnel->encap_ecn[tos & 0x3];
+        protocol = gre ? TUNNEL_IP_PROTOCOL_GRE : (inner_ipv4 ? TUNNEL_IP_PROTOCOL_IPV4 : TUNNEL_IP_PROTOCOL_IPV6);
+
+        outer = inner - header_length;
+        memcpy(outer, header, header_length);
+        if (ipv4) {
+            total_length = packets[ii].length + header_length;
+            outer[1]     = tos;
+            tunnel_put16(outer + 2, total_length);
+            tunnel_put16(outer + 4, ip_id);
+            tunnel_put16(outer + 6, fragment);
+            outer[8] = ttl;
+            outer[9] = protocol;
+            tunnel_put16(outer + 10, tunnel_checksum_fold(sum + tos + total_length + ip_id + fragment +
+                                                          ((ttl << 8) | protocol)));
+            ip_id++;
+        } else {
+            outer[0] |= tos >> 4;
+            outer[1]  = tos << 4;
+            tunnel_put16(outer + 4, packets[ii].length + header_length - ip_length);
+            outer[6] = protocol;
+            outer[7] = ttl;
+        }
+        if (gre) {
+            tunnel_put16(outer + ip_length + 2, inner_ipv4 ? TUNNEL_ETHERTYPE_IPV4 : TUNNEL_ETHERTYPE_IPV6);
+        }
+
+        packets[ii].data      = outer;
+        packets[ii].length   += header_length;
+        packets[ii].headroom -= header_length;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*************************/
+
+static void tunnel_map_key_to_str(_In_ sai_object_id_t tunnel_map_id, _Out_ char *key_str)
+{
+    uint32_t mapid;
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(tunnel_map_id, SAI_OBJECT_TYPE_TUNNEL_MAP, &mapid)) {
+        snprintf(key_str, MAX_KEY_STR_LEN, "invalid tunnel map");
+    } else {
+        snprintf(key_str, MAX_KEY_STR_LEN, "tunnel map %u", mapid);
+    }
+}
+
+static void tunnel_key_to_str(_In_ sai_object_id_t tunnel_id, _Out_ char *key_str)
+{
+    uint32_t tunnelid;
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(tunnel_id, SAI_OBJECT_TYPE_TUNNEL, &tunnelid)) {
+        snprintf(key_str, MAX_KEY_STR_LEN, "invalid tunnel");
+    } else {
+        snprintf(key_str, MAX_KEY_STR_LEN, "tunnel %u", tunnelid);
+    }
+}
+
+static void tunnel_term_key_to_str(_In_ sai_object_id_t entry_id, _Out_ char *key_str)
+{
+    uint32_t entryid;
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(entry_id, SAI_OBJECT_TYPE_TUNNEL_TERM_TABLE_ENTRY, &entryid)) {
+        snprintf(key_str, MAX_KEY_STR_LEN, "invalid tunnel term table entry");
+    } else {
+        snprintf(key_str, MAX_KEY_STR_LEN, "tunnel term table entry %u", entryid);
+    }
+}
+
+static bool tunnel_ip_valid(_In_ const sai_ip_address_t *ip)
+{
+    return (SAI_IP_ADDR_FAMILY_IPV4 == ip->addr_family) || (SAI_IP_ADDR_FAMILY_IPV6 == ip->addr_family);
+}
+
+/*
+ * Routine Description:
+ *    Create tunnel map.
+ *
+ * Arguments:
+ *    [out] tunnel_map_id - tunnel map id
+ *    [in] switch_id - switch id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_tunnel_map(_Out_ sai_object_id_t      *tunnel_map_id,
+                                    _In_ sai_object_id_t        switch_id,
+                                    _In_ uint32_t               attr_count,
+                                    _In_ const sai_attribute_t *attr_list)
+{
+    stub_tunnel_map_t           *map;
+    sai_status_t                 status;
+    const sai_attribute_value_t *type, *list;
+    uint32_t                     type_index, list_index, db_id, ii;
+    const sai_tunnel_map_t      *entry;
+    char                         list_str[MAX_LIST_VALUE_STR_LEN];
+    char                         key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == tunnel_map_id) {
+        STUB_LOG_ERR("NULL tunnel map id param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = check_attribs_metadata(attr_count, attr_list, tunnel_map_attribs, tunnel_map_vendor_attribs,
+                                         SAI_OPERATION_CREATE))) {
+        STUB_LOG_ERR("Failed attribs check\n");
+        return status;
+    }
+
+    sai_attr_list_to_str(attr_count, attr_list, tunnel_map_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create tunnel map, %s\n", list_str);
+
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_TUNNEL_MAP_ATTR_TYPE, &type, &type_index));
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_TUNNEL_MAP_ATTR_MAP_TO_VALUE_LIST, &list, &list_index));
+
+    if ((SAI_TUNNEL_MAP_TYPE_OECN_TO_UECN != type->s32) && (SAI_TUNNEL_MAP_TYPE_UECN_OECN_TO_OECN != type->s32)) {
+        STUB_LOG_ERR("Tunnel map type %d not supported\n", type->s32);
+        return SAI_STATUS_ATTR_NOT_SUPPORTED_0 + type_index;
+    }
+
+    if (list->tunnelmap.count > TUNNEL_MAP_ENTRIES) {
+        STUB_LOG_ERR("Tunnel map with %u entries, max %u\n", list->tunnelmap.count, TUNNEL_MAP_ENTRIES);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + list_index;
+    }
+
+    for (ii = 0; ii < list->tunnelmap.count; ii++) {
+        entry = &list->tunnelmap.list[ii];
+        if (((SAI_TUNNEL_MAP_TYPE_OECN_TO_UECN == type->s32) &&
+             ((entry->key.oecn >= TUNNEL_ECN_VALUES) || (entry->value.uecn >= TUNNEL_ECN_VALUES))) ||
+            ((SAI_TUNNEL_MAP_TYPE_UECN_OECN_TO_OECN == type->s32) &&
+             ((entry->key.uecn >= TUNNEL_ECN_VALUES) || (entry->key.oecn >= TUNNEL_ECN_VALUES) ||
+              (entry->value.oecn >= TUNNEL_ECN_VALUES)))) {
+            STUB_LOG_ERR("Invalid ECN value in tunnel map entry %u\n", ii);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + list_index;
+        }
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_find_free_tunnel_map_index(&db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = stub_create_object(SAI_OBJECT_TYPE_TUNNEL_MAP, db_id, tunnel_map_id))) {
+        return status;
+    }
+
+    map = &tunnel_map_db[db_id];
+    memset(map, 0, sizeof(*map));
+    map->type  = type->s32;
+    map->count = list->tunnelmap.count;
+    memcpy(map->list, list->tunnelmap.list, map->count * sizeof(map->list[0]));
+    map->is_valid = true;
+
+    tunnel_map_key_to_str(*tunnel_map_id, key_str);
+    STUB_LOG_NTC("Created %s\n", key_str);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Remove tunnel map.
+ *
+ * Arguments:
+ *    [in] tunnel_map_id - tunnel map id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_tunnel_map(_In_ sai_object_id_t tunnel_map_id)
+{
+    stub_tunnel_map_t *map;
+    char               key_str[MAX_KEY_STR_LEN];
+    sai_status_t       status;
+    uint32_t           db_id;
+
+    STUB_LOG_ENTER();
+
+    tunnel_map_key_to_str(tunnel_map_id, key_str);
+    STUB_LOG_NTC("Remove %s\n", key_str);
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(tunnel_map_id, SAI_OBJECT_TYPE_TUNNEL_MAP, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_tunnel_map(db_id, &map))) {
+        return status;
+    }
+
+    if (map->ref_count > 0) {
+        STUB_LOG_ERR("Tunnel map %u is used by %u tunnels\n", db_id, map->ref_count);
+        return SAI_STATUS_OBJECT_IN_USE;
+    }
+
+    map->is_valid = false;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Set tunnel map attribute.
+ *
+ * Arguments:
+ *    [in] tunnel_map_id - tunnel map id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_tunnel_map_attribute(_In_ sai_object_id_t tunnel_map_id, _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = tunnel_map_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    tunnel_map_key_to_str(tunnel_map_id, key_str);
+    return sai_set_attribute(&key, key_str, tunnel_map_attribs, tunnel_map_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get tunnel map attributes.
+ *
+ * Arguments:
+ *    [in] tunnel_map_id - tunnel map id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_tunnel_map_attribute(_In_ sai_object_id_t     tunnel_map_id,
+                                           _In_ uint32_t            attr_count,
+                                           _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = tunnel_map_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    tunnel_map_key_to_str(tunnel_map_id, key_str);
+    return sai_get_attributes(&key, key_str, tunnel_map_attribs, tunnel_map_vendor_attribs, attr_count, attr_list);
+}
+
+/* Tunnel map attributes */
+sai_status_t stub_tunnel_map_attr_get(_In_ const sai_object_key_t   *key,
+                                      _Inout_ sai_attribute_value_t *value,
+                                      _In_ uint32_t                  attr_index,
+                                      _Inout_ vendor_cache_t        *cache,
+                                      void                          *arg)
+{
+    stub_tunnel_map_t *map;
+    sai_status_t       status;
+    uint32_t           db_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_TUNNEL_MAP, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_tunnel_map(db_id, &map))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_TUNNEL_MAP_ATTR_TYPE:
+        value->s32 = map->type;
+        break;
+
+    case SAI_TUNNEL_MAP_ATTR_MAP_TO_VALUE_LIST:
+        status = stub_fill_tunnelmaplist(map->list, map->count, &value->tunnelmap);
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid tunnel map attribute %d\n", (int)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return status;
+}
+
+/* Check the tunnel maps of a mapper list are of the map type the ECN mode needs */
+static sai_status_t tunnel_mappers_check(_In_ const sai_object_list_t *mappers,
+                                         _In_ sai_tunnel_map_type_t    type,
+                                         _Out_ sai_object_id_t        *ids,
+                                         _Out_ uint32_t               *count)
+{
+    stub_tunnel_map_t *map;
+    uint32_t           db_id, ii;
+
+    if (mappers->count > TUNNEL_MAPPERS) {
+        STUB_LOG_ERR("Tunnel with %u mappers, max %u\n", mappers->count, TUNNEL_MAPPERS);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0;
+    }
+
+    for (ii = 0; ii < mappers->count; ii++) {
+        if ((SAI_STATUS_SUCCESS != stub_object_to_type(mappers->list[ii], SAI_OBJECT_TYPE_TUNNEL_MAP, &db_id)) ||
+            (SAI_STATUS_SUCCESS != db_get_tunnel_map(db_id, &map)) || (map->type != type)) {
+            STUB_LOG_ERR("Tunnel mapper %" PRIx64 " isn't a tunnel map of type %d\n", mappers->list[ii], type);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        ids[ii] = mappers->list[ii];
+    }
+
+    *count = mappers->count;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Check an attribute value and store it in the tunnel */
+static sai_status_t tunnel_attr_apply(_Inout_ stub_tunnel_t *tunnel, _In_ const sai_attribute_t *attr)
+{
+    uint32_t rif_id;
+
+    switch (attr->id) {
+    case SAI_TUNNEL_ATTR_UNDERLAY_INTERFACE:
+    case SAI_TUNNEL_ATTR_OVERLAY_INTERFACE:
+        if (SAI_STATUS_SUCCESS != stub_object_to_type(attr->value.oid, SAI_OBJECT_TYPE_ROUTER_INTERFACE, &rif_id)) {
+            STUB_LOG_ERR("Invalid tunnel router interface %" PRIx64 "\n", attr->value.oid);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        if (SAI_TUNNEL_ATTR_UNDERLAY_INTERFACE == attr->id) {
+            tunnel->underlay_rif = attr->value.oid;
+        } else {
+            tunnel->overlay_rif = attr->value.oid;
+        }
+        break;
+
+    case SAI_TUNNEL_ATTR_ENCAP_SRC_IP:
+        if (!tunnel_ip_valid(&attr->value.ipaddr)) {
+            STUB_LOG_ERR("Invalid tunnel source IP family %d\n", attr->value.ipaddr.addr_family);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        tunnel->src_ip = attr->value.ipaddr;
+        break;
+
+    case SAI_TUNNEL_ATTR_ENCAP_TTL_MODE:
+    case SAI_TUNNEL_ATTR_DECAP_TTL_MODE:
+        if ((SAI_TUNNEL_TTL_MODE_UNIFORM_MODEL != attr->value.s32) &&
+            (SAI_TUNNEL_TTL_MODE_PIPE_MODEL != attr->value.s32)) {
+            STUB_LOG_ERR("Invalid tunnel TTL mode %d\n", attr->value.s32);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        if (SAI_TUNNEL_ATTR_ENCAP_TTL_MODE == attr->id) {
+            tunnel->encap_ttl_mode = attr->value.s32;
+        } else {
+            tunnel->decap_ttl_mode = attr->value.s32;
+        }
+        break;
+
+    case SAI_TUNNEL_ATTR_ENCAP_TTL_VAL:
+        tunnel->encap_ttl = attr->value.u8;
+        break;
+
+    case SAI_TUNNEL_ATTR_ENCAP_DSCP_MODE:
+    case SAI_TUNNEL_ATTR_DECAP_DSCP_MODE:
+        if ((SAI_TUNNEL_DSCP_MODE_UNIFORM_MODEL != attr->value.s32) &&
+            (SAI_TUNNEL_DSCP_MODE_PIPE_MODEL != attr->value.s32)) {
+            STUB_LOG_ERR("Invalid tunnel DSCP mode %d\n", attr->value.s32);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        if (SAI_TUNNEL_ATTR_ENCAP_DSCP_MODE == attr->id) {
+            tunnel->encap_dscp_mode = attr->value.s32;
+        } else {
+            tunnel->decap_dscp_mode = attr->value.s32;
+        }
+        break;
+
+    case SAI_TUNNEL_ATTR_ENCAP_DSCP_VAL:
+        if (attr->value.u8 > TUNNEL_DSCP_MAX) {
+            STUB_LOG_ERR("Invalid tunnel DSCP %u\n", attr->value.u8);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        tunnel->encap_dscp = attr->value.u8;
+        break;
+
+    case SAI_TUNNEL_ATTR_ENCAP_GRE_KEY_VALID:
+        tunnel->gre_key_valid = attr->value.booldata;
+        break;
+
+    case SAI_TUNNEL_ATTR_ENCAP_GRE_KEY:
+        tunnel->gre_key = attr->value.u32;
+        break;
+
+    case SAI_TUNNEL_ATTR_ENCAP_ECN_MODE:
+        if ((SAI_TUNNEL_ENCAP_ECN_MODE_STANDARD != attr->value.s32) &&
+            (SAI_TUNNEL_ENCAP_ECN_MODE_USER_DEFINED != attr->value.s32)) {
+            STUB_LOG_ERR("Invalid tunnel encap ECN mode %d\n", attr->value.s32);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        tunnel->encap_ecn_mode = attr->value.s32;
+        break;
+
+    case SAI_TUNNEL_ATTR_DECAP_ECN_MODE:
+        if ((SAI_TUNNEL_DECAP_ECN_MODE_STANDARD != attr->value.s32) &&
+            (SAI_TUNNEL_DECAP_ECN_MODE_COPY_FROM_OUTER != attr->value.s32) &&
+            (SAI_TUNNEL_DECAP_ECN_MODE_USER_DEFINED != attr->value.s32)) {
+            STUB_LOG_ERR("Invalid tunnel decap ECN mode %d\n", attr->value.s32);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        tunnel->decap_ecn_mode = attr->value.s32;
+        break;
+
+    case SAI_TUNNEL_ATTR_ENCAP_MAPPERS:
+        return tunnel_mappers_check(&attr->value.objlist, SAI_TUNNEL_MAP_TYPE_OECN_TO_UECN,
+                                    tunnel->encap_mappers, &tunnel->encap_mapper_count);
+
+    case SAI_TUNNEL_ATTR_DECAP_MAPPERS:
+        return tunnel_mappers_check(&attr->value.objlist, SAI_TUNNEL_MAP_TYPE_UECN_OECN_TO_OECN,
+                                    tunnel->decap_mappers, &tunnel->decap_mapper_count);
+
+    default:
+        break;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Create tunnel.
+ *
+ * Arguments:
+ *    [out] tunnel_id - tunnel id
+ *    [in] switch_id - switch id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_tunnel(_Out_ sai_object_id_t      *tunnel_id,
+                                _In_ sai_object_id_t        switch_id,
+                                _In_ uint32_t               attr_count,
+                                _In_ const sai_attribute_t *attr_list)
+{
+    stub_tunnel_t               *tunnel;
+    sai_status_t                 status;
+    const sai_attribute_value_t *type, *value;
+    uint32_t                     type_index, index, db_id, ii;
+    char                         list_str[MAX_LIST_VALUE_STR_LEN];
+    char                         key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == tunnel_id) {
+        STUB_LOG_ERR("NULL tunnel id param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = check_attribs_metadata(attr_count, attr_list, tunnel_attribs, tunnel_vendor_attribs,
+                                         SAI_OPERATION_CREATE))) {
+        STUB_LOG_ERR("Failed attribs check\n");
+        return status;
+    }
+
+    sai_attr_list_to_str(attr_count, attr_list, tunnel_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create tunnel, %s\n", list_str);
+
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_TUNNEL_ATTR_TYPE, &type, &type_index));
+
+    if ((SAI_TUNNEL_TYPE_IPINIP != type->s32) && (SAI_TUNNEL_TYPE_IPINIP_GRE != type->s32)) {
+        STUB_LOG_ERR("Tunnel type %d not supported\n", type->s32);
+        return SAI_STATUS_ATTR_NOT_SUPPORTED_0 + type_index;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_find_free_tunnel_index(&db_id))) {
+        return status;
+    }
+
+    tunnel = &tunnel_db[db_id];
+    memset(tunnel, 0, sizeof(*tunnel));
+    tunnel->type            = type->s32;
+    tunnel->encap_ttl_mode  = SAI_TUNNEL_TTL_MODE_UNIFORM_MODEL;
+    tunnel->encap_dscp_mode = SAI_TUNNEL_DSCP_MODE_UNIFORM_MODEL;
+    tunnel->encap_ecn_mode  = SAI_TUNNEL_ENCAP_ECN_MODE_STANDARD;
+    tunnel->decap_ecn_mode  = SAI_TUNNEL_DECAP_ECN_MODE_STANDARD;
+
+    for (ii = 0; ii < attr_count; ii++) {
+        if (((SAI_TUNNEL_ATTR_ENCAP_GRE_KEY_VALID == attr_list[ii].id) ||
+             (SAI_TUNNEL_ATTR_ENCAP_GRE_KEY == attr_list[ii].id)) && (SAI_TUNNEL_TYPE_IPINIP_GRE != type->s32)) {
+            STUB_LOG_ERR("Tunnel GRE key attribute on tunnel type %d\n", type->s32);
+            return SAI_STATUS_INVALID_ATTRIBUTE_0 + ii;
+        }
+        if (SAI_STATUS_SUCCESS != (status = tunnel_attr_apply(tunnel, &attr_list[ii]))) {
+            return (SAI_STATUS_INVALID_ATTR_VALUE_0 == status) ? SAI_STATUS_INVALID_ATTR_VALUE_0 + ii : status;
+        }
+    }
+
+    if (((SAI_TUNNEL_TTL_MODE_PIPE_MODEL == tunnel->encap_ttl_mode) &&
+         (SAI_STATUS_SUCCESS !=
+          find_attrib_in_list(attr_count, attr_list, SAI_TUNNEL_ATTR_ENCAP_TTL_VAL, &value, &index))) ||
+        ((SAI_TUNNEL_DSCP_MODE_PIPE_MODEL == tunnel->encap_dscp_mode) &&
+         (SAI_STATUS_SUCCESS !=
+          find_attrib_in_list(attr_count, attr_list, SAI_TUNNEL_ATTR_ENCAP_DSCP_VAL, &value, &index))) ||
+        ((tunnel->gre_key_valid) &&
+         (SAI_STATUS_SUCCESS !=
+          find_attrib_in_list(attr_count, attr_list, SAI_TUNNEL_ATTR_ENCAP_GRE_KEY, &value, &index))) ||
+        ((SAI_TUNNEL_ENCAP_ECN_MODE_USER_DEFINED == tunnel->encap_ecn_mode) &&
+         (SAI_STATUS_SUCCESS !=
+          find_attrib_in_list(attr_count, attr_list, SAI_TUNNEL_ATTR_ENCAP_MAPPERS, &value, &index))) ||
+        ((SAI_TUNNEL_DECAP_ECN_MODE_USER_DEFINED == tunnel->decap_ecn_mode) &&
+         (SAI_STATUS_SUCCESS !=
+          find_attrib_in_list(attr_count, attr_list, SAI_TUNNEL_ATTR_DECAP_MAPPERS, &value, &index)))) {
+        STUB_LOG_ERR("Missing mandatory tunnel attribute for the tunnel modes\n");
+        return SAI_STATUS_MANDATORY_ATTRIBUTE_MISSING;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = stub_create_object(SAI_OBJECT_TYPE_TUNNEL, db_id, tunnel_id))) {
+        return status;
+    }
+
+    tunnel_ecn_compile(tunnel);
+    tunnel_mappers_ref(tunnel, 1);
+    tunnel->is_valid = true;
+
+    tunnel_key_to_str(*tunnel_id, key_str);
+    STUB_LOG_NTC("Created %s\n", key_str);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Remove tunnel.
+ *
+ * Arguments:
+ *    [in] tunnel_id - tunnel id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_tunnel(_In_ sai_object_id_t tunnel_id)
+{
+    stub_tunnel_t *tunnel;
+    char           key_str[MAX_KEY_STR_LEN];
+    sai_status_t   status;
+    uint32_t       db_id;
+
+    STUB_LOG_ENTER();
+
+    tunnel_key_to_str(tunnel_id, key_str);
+    STUB_LOG_NTC("Remove %s\n", key_str);
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(tunnel_id, SAI_OBJECT_TYPE_TUNNEL, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_tunnel(db_id, &tunnel))) {
+        return status;
+    }
+
+    if (tunnel->ref_count > 0) {
+        STUB_LOG_ERR("Tunnel %u is used by %u term table entries\n", db_id, tunnel->ref_count);
+        return SAI_STATUS_OBJECT_IN_USE;
+    }
+
+    tunnel_mappers_ref(tunnel, -1);
+    tunnel->is_valid = false;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Set tunnel attribute.
+ *
+ * Arguments:
+ *    [in] tunnel_id - tunnel id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_tunnel_attribute(_In_ sai_object_id_t tunnel_id, _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = tunnel_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    tunnel_key_to_str(tunnel_id, key_str);
+    return sai_set_attribute(&key, key_str, tunnel_attribs, tunnel_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get tunnel attributes.
+ *
+ * Arguments:
+ *    [in] tunnel_id - tunnel id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_tunnel_attribute(_In_ sai_object_id_t     tunnel_id,
+                                       _In_ uint32_t            attr_count,
+                                       _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = tunnel_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    tunnel_key_to_str(tunnel_id, key_str);
+    return sai_get_attributes(&key, key_str, tunnel_attribs, tunnel_vendor_attribs, attr_count, attr_list);
+}
+
+/* Tunnel attributes */
+sai_status_t stub_tunnel_attr_get(_In_ const sai_object_key_t   *key,
+                                  _Inout_ sai_attribute_value_t *value,
+                                  _In_ uint32_t                  attr_index,
+                                  _Inout_ vendor_cache_t        *cache,
+                                  void                          *arg)
+{
+    stub_tunnel_t *tunnel;
+    sai_status_t   status;
+    uint32_t       db_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_TUNNEL, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_tunnel(db_id, &tunnel))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_TUNNEL_ATTR_TYPE:
+        value->s32 = tunnel->type;
+        break;
+
+    case SAI_TUNNEL_ATTR_UNDERLAY_INTERFACE:
+        value->oid = tunnel->underlay_rif;
+        break;
+
+    case SAI_TUNNEL_ATTR_OVERLAY_INTERFACE:
+        value->oid = tunnel->overlay_rif;
+        break;
+
+    case SAI_TUNNEL_ATTR_ENCAP_SRC_IP:
+        value->ipaddr = tunnel->src_ip;
+        break;
+
+    case SAI_TUNNEL_ATTR_ENCAP_TTL_MODE:
+        value->s32 = tunnel->encap_ttl_mode;
+        break;
+
+    case SAI_TUNNEL_ATTR_ENCAP_TTL_VAL:
+        value->u8 = tunnel->encap_ttl;
+        break;
+
+    case SAI_TUNNEL_ATTR_ENCAP_DSCP_MODE:
+        value->s32 = tunnel->encap_dscp_mode;
+        break;
+
+    case SAI_TUNNEL_ATTR_ENCAP_DSCP_VAL:
+        value->u8 = tunnel->encap_dscp;
+        break;
+
+    case SAI_TUNNEL_ATTR_ENCAP_GRE_KEY_VALID:
+        value->booldata = tunnel->gre_key_valid;
+        break;
+
+    case SAI_TUNNEL_ATTR_ENCAP_GRE_KEY:
+        value->u32 = tunnel->gre_key;
+        break;
+
+    case SAI_TUNNEL_ATTR_ENCAP_ECN_MODE:
+        value->s32 = tunnel->encap_ecn_mode;
+        break;
+
+    case SAI_TUNNEL_ATTR_ENCAP_MAPPERS:
+        status = stub_fill_objlist(tunnel->encap_mappers, tunnel->encap_mapper_count, &value->objlist);
+        break;
+
+    case SAI_TUNNEL_ATTR_DECAP_ECN_MODE:
+        value->s32 = tunnel->decap_ecn_mode;
+        break;
+
+    case SAI_TUNNEL_ATTR_DECAP_MAPPERS:
+        status = stub_fill_objlist(tunnel->decap_mappers, tunnel->decap_mapper_count, &value->objlist);
+        break;
+
+    case SAI_TUNNEL_ATTR_DECAP_TTL_MODE:
+        value->s32 = tunnel->decap_ttl_mode;
+        break;
+
+    case SAI_TUNNEL_ATTR_DECAP_DSCP_MODE:
+        value->s32 = tunnel->decap_dscp_mode;
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid tunnel attribute %d\n", (int)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return status;
+}
+
+/*
+ * Routine Description:
+ *    Create tunnel termination table entry.
+ *
+ * Arguments:
+ *    [out] tunnel_term_table_entry_id - tunnel termination table entry id
+ *    [in] switch_id - switch id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_tunnel_term_table_entry(_Out_ sai_object_id_t      *tunnel_term_table_entry_id,
+                                                 _In_ sai_object_id_t        switch_id,
+                                                 _In_ uint32_t               attr_count,
+                                                 _In_ const sai_attribute_t *attr_list)
+{
+    stub_tunnel_term_t          *entry;
+    stub_tunnel_t               *tunnel;
+    stub_tunnel_term_key_t       term_key;
+    sai_status_t                 status;
+    const sai_attribute_value_t *vr, *type, *dst_ip, *src_ip, *tunnel_type, *action;
+    uint32_t                     vr_index, type_index, dst_index, src_index, tunnel_type_index, action_index;
+    uint32_t                     vr_db_id, tunnel_db_id, db_id;
+    bool                         p2p;
+    char                         list_str[MAX_LIST_VALUE_STR_LEN];
+    char                         key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == tunnel_term_table_entry_id) {
+        STUB_LOG_ERR("NULL tunnel term table entry id param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = check_attribs_metadata(attr_count, attr_list, tunnel_term_attribs, tunnel_term_vendor_attribs,
+                                         SAI_OPERATION_CREATE))) {
+        STUB_LOG_ERR("Failed attribs check\n");
+        return status;
+    }
+
+    sai_attr_list_to_str(attr_count, attr_list, tunnel_term_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create tunnel term table entry, %s\n", list_str);
+
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_VR_ID, &vr, &vr_index));
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_TYPE, &type, &type_index));
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_DST_IP, &dst_ip,
+                               &dst_index));
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_ACTION_TUNNEL_ID, &action,
+                               &action_index));
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(vr->oid, SAI_OBJECT_TYPE_VIRTUAL_ROUTER, &vr_db_id)) {
+        STUB_LOG_ERR("Invalid tunnel term virtual router %" PRIx64 "\n", vr->oid);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + vr_index;
+    }
+
+    if ((SAI_TUNNEL_TERM_TABLE_ENTRY_TYPE_P2P != type->s32) && (SAI_TUNNEL_TERM_TABLE_ENTRY_TYPE_P2MP != type->s32)) {
+        STUB_LOG_ERR("Invalid tunnel term entry type %d\n", type->s32);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + type_index;
+    }
+    p2p = (SAI_TUNNEL_TERM_TABLE_ENTRY_TYPE_P2P == type->s32);
+
+    if (!tunnel_ip_valid(&dst_ip->ipaddr)) {
+        STUB_LOG_ERR("Invalid tunnel term destination IP family %d\n", dst_ip->ipaddr.addr_family);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + dst_index;
+    }
+
+    if ((SAI_STATUS_SUCCESS != stub_object_to_type(action->oid, SAI_OBJECT_TYPE_TUNNEL, &tunnel_db_id)) ||
+        (SAI_STATUS_SUCCESS != db_get_tunnel(tunnel_db_id, &tunnel))) {
+        STUB_LOG_ERR("Invalid tunnel term action tunnel %" PRIx64 "\n", action->oid);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + action_index;
+    }
+
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_SRC_IP, &src_ip, &src_index)) {
+        if (!p2p) {
+            STUB_LOG_ERR("Tunnel term source IP on P2MP entry\n");
+            return SAI_STATUS_INVALID_ATTRIBUTE_0 + src_index;
+        }
+        if (src_ip->ipaddr.addr_family != dst_ip->ipaddr.addr_family) {
+            STUB_LOG_ERR("Tunnel term source IP family %d doesn't match destination\n",
+                         src_ip->ipaddr.addr_family);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + src_index;
+        }
+    } else if (p2p) {
+        STUB_LOG_ERR("Missing mandatory tunnel term source IP on P2P entry\n");
+        return SAI_STATUS_MANDATORY_ATTRIBUTE_MISSING;
+    }
+
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_TUNNEL_TYPE, &tunnel_type,
+                            &tunnel_type_index)) {
+        if (!p2p) {
+            STUB_LOG_ERR("Tunnel term tunnel type on P2MP entry\n");
+            return SAI_STATUS_INVALID_ATTRIBUTE_0 + tunnel_type_index;
+        }
+        if ((sai_tunnel_type_t)tunnel_type->s32 != tunnel->type) {
+            STUB_LOG_ERR("Tunnel term tunnel type %d doesn't match tunnel %u type %d\n", tunnel_type->s32,
+                         tunnel_db_id, tunnel->type);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + tunnel_type_index;
+        }
+    } else if (p2p) {
+        STUB_LOG_ERR("Missing mandatory tunnel term tunnel type on P2P entry\n");
+        return SAI_STATUS_MANDATORY_ATTRIBUTE_MISSING;
+    }
+
+    tunnel_term_key_fill(&term_key, vr_db_id, type->s32, &dst_ip->ipaddr, p2p ? &src_ip->ipaddr : NULL);
+    if (NULL != tunnel_term_lookup(&term_key, tunnel_term_key_hash(&term_key))) {
+        STUB_LOG_ERR("Tunnel term table entry already exists\n");
+        return SAI_STATUS_ITEM_ALREADY_EXISTS;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_find_free_tunnel_term_index(&db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_create_object(SAI_OBJECT_TYPE_TUNNEL_TERM_TABLE_ENTRY, db_id, tunnel_term_table_entry_id))) {
+        return status;
+    }
+
+    entry = &tunnel_term_db[db_id];
+    memset(entry, 0, sizeof(*entry));
+    entry->key          = term_key;
+    entry->vr           = vr->oid;
+    entry->dst_ip       = dst_ip->ipaddr;
+    entry->tunnel_type  = tunnel->type;
+    entry->tunnel       = action->oid;
+    entry->tunnel_db_id = tunnel_db_id;
+    if (p2p) {
+        entry->src_ip = src_ip->ipaddr;
+    }
+    entry->is_valid = true;
+
+    tunnel_term_hash_insert(db_id);
+    tunnel->ref_count++;
+
+    tunnel_term_key_to_str(*tunnel_term_table_entry_id, key_str);
+    STUB_LOG_NTC("Created %s\n", key_str);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Remove tunnel termination table entry.
+ *
+ * Arguments:
+ *    [in] tunnel_term_table_entry_id - tunnel termination table entry id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_tunnel_term_table_entry(_In_ sai_object_id_t tunnel_term_table_entry_id)
+{
+    stub_tunnel_term_t *entry;
+    char                key_str[MAX_KEY_STR_LEN];
+    sai_status_t        status;
+    uint32_t            db_id;
+
+    STUB_LOG_ENTER();
+
+    tunnel_term_key_to_str(tunnel_term_table_entry_id, key_str);
+    STUB_LOG_NTC("Remove %s\n", key_str);
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_object_to_type(tunnel_term_table_entry_id, SAI_OBJECT_TYPE_TUNNEL_TERM_TABLE_ENTRY,
+                                      &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_tunnel_term(db_id, &entry))) {
+        return status;
+    }
+
+    tunnel_term_hash_remove(db_id);
+    tunnel_db[entry->tunnel_db_id].ref_count--;
+    entry->is_valid = false;
+    if (db_id < tunnel_term_free_hint) {
+        tunnel_term_free_hint = db_id;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Set tunnel termination table entry attribute.
+ *
+ * Arguments:
+ *    [in] tunnel_term_table_entry_id - tunnel termination table entry id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_tunnel_term_table_entry_attribute(_In_ sai_object_id_t        tunnel_term_table_entry_id,
+                                                        _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = tunnel_term_table_entry_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    tunnel_term_key_to_str(tunnel_term_table_entry_id, key_str);
+    return sai_set_attribute(&key, key_str, tunnel_term_attribs, tunnel_term_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get tunnel termination table entry attributes.
+ *
+ * Arguments:
+ *    [in] tunnel_term_table_entry_id - tunnel termination table entry id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_tunnel_term_table_entry_attribute(_In_ sai_object_id_t     tunnel_term_table_entry_id,
+                                                        _In_ uint32_t            attr_count,
+                                                        _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = tunnel_term_table_entry_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    tunnel_term_key_to_str(tunnel_term_table_entry_id, key_str);
+    return sai_get_attributes(&key, key_str, tunnel_term_attribs, tunnel_term_vendor_attribs, attr_count,
+                              attr_list);
+}
+
+/* Tunnel termination table entry attributes */
+sai_status_t stub_tunnel_term_attr_get(_In_ const sai_object_key_t   *key,
+                                       _Inout_ sai_attribute_value_t *value,
+                                       _In_ uint32_t                  attr_index,
+                                       _Inout_ vendor_cache_t        *cache,
+                                       void                          *arg)
+{
+    stub_tunnel_term_t *entry;
+    sai_status_t        status;
+    uint32_t            db_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_TUNNEL_TERM_TABLE_ENTRY, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_tunnel_term(db_id, &entry))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_VR_ID:
+        value->oid = entry->vr;
+        break;
+
+    case SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_TYPE:
+        value->s32 = entry->key.type;
+        break;
+
+    case SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_DST_IP:
+        value->ipaddr = entry->dst_ip;
+        break;
+
+    case SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_SRC_IP:
+        value->ipaddr = entry->src_ip;
+        break;
+
+    case SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_TUNNEL_TYPE:
+        value->s32 = entry->tunnel_type;
+        break;
+
+    case SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_ACTION_TUNNEL_ID:
+        value->oid = entry->tunnel;
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid tunnel term table entry attribute %d\n", (int)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+const sai_tunnel_api_t tunnel_api = {
+    stub_create_tunnel_map,
+    stub_remove_tunnel_map,
+    stub_set_tunnel_map_attribute,
+    stub_get_tunnel_map_attribute,
+    stub_create_tunnel,
+    stub_remove_tunnel,
+    stub_set_tunnel_attribute,
+    stub_get_tunnel_attribute,
+    stub_create_tunnel_term_table_entry,
+    stub_remove_tunnel_term_table_entry,
+    stub_set_tunnel_term_table_entry_attribute,
+    stub_get_tunnel_term_table_entry_attribute
+};
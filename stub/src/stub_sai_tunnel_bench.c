@@ -0,0 +1,237 @@
+/*
+ *  Copyright (C) 2014. Mellanox Technologies, Ltd. ALL RIGHTS RESERVED.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ */
+
+#include "sai.h"
+#include "stub_sai.h"
+#include "assert.h"
+#include "stdio.h"
+#include "time.h"
+#include "arpa/inet.h"
+
+/*
+ * Decap throughput of the tunnel termination table. An IPinIP tunnel gets
+ * one P2P termination entry per remote, packets are encapsulated once toward
+ * remotes spread over the table, then decapsulated in bursts of BENCH_BURST,
+ * restoring the outer header before each burst. Prints ns per packet and
+ * Mpps for each table size.
+ */
+
+#define BENCH_BURST      32
+#define BENCH_PACKETS    1024
+#define BENCH_ITERATIONS 20000
+#define BENCH_HEADROOM   64
+#define BENCH_LENGTH     64
+#define BENCH_LOCAL_IP   0x0a000001
+#define BENCH_REMOTE_IP  0x0c000000
+#define BENCH_DST_IP     0x0b000000
+
+static const uint32_t bench_sizes[] = { 1000, 16000 };
+
+static uint8_t              bench_bufs[BENCH_PACKETS][BENCH_HEADROOM + BENCH_LENGTH];
+static stub_tunnel_packet_t bench_packets[BENCH_PACKETS];
+static stub_tunnel_packet_t bench_orig[BENCH_PACKETS];
+static sai_object_id_t      bench_entries[16384];
+
+#define BENCH_CHECK(x)                                                           \
+    do {                                                                         \
+        if (!(x)) {                                                              \
+            fprintf(stderr, "%s:%d: %s failed\n", __FILE__, __LINE__, #x);       \
+            exit(1);                                                             \
+        }                                                                        \
+    } while (0)
+
+static sai_object_id_t bench_object(_In_ sai_object_type_t type, _In_ uint32_t data)
+{
+    sai_object_id_t object_id;
+
+    BENCH_CHECK(SAI_STATUS_SUCCESS == stub_create_object(type, data, &object_id));
+
+    return object_id;
+}
+
+static sai_ip_address_t bench_ip4(_In_ uint32_t addr)
+{
+    sai_ip_address_t ip;
+
+    memset(&ip, 0, sizeof(ip));
+    ip.addr_family = SAI_IP_ADDR_FAMILY_IPV4;
+    ip.addr.ip4    = htonl(addr);
+
+    return ip;
+}
+
+/* Spread the termination destinations over the hash */
+static uint32_t bench_dst_ip(_In_ uint32_t index)
+{
+    return BENCH_DST_IP + (uint32_t)((index * 2654435761u) % 16777216);
+}
+
+static sai_object_id_t bench_tunnel_create()
+{
+    sai_attribute_t attrs[8];
+    sai_object_id_t tunnel_id;
+    uint32_t        count = 0;
+
+    attrs[count].id          = SAI_TUNNEL_ATTR_TYPE;
+    attrs[count++].value.s32 = SAI_TUNNEL_TYPE_IPINIP;
+    attrs[count].id          = SAI_TUNNEL_ATTR_UNDERLAY_INTERFACE;
+    attrs[count++].value.oid = bench_object(SAI_OBJECT_TYPE_ROUTER_INTERFACE, 1);
+    attrs[count].id          = SAI_TUNNEL_ATTR_OVERLAY_INTERFACE;
+    attrs[count++].value.oid = bench_object(SAI_OBJECT_TYPE_ROUTER_INTERFACE, 2);
+    attrs[count].id             = SAI_TUNNEL_ATTR_ENCAP_SRC_IP;
+    attrs[count++].value.ipaddr = bench_ip4(BENCH_LOCAL_IP);
+    attrs[count].id          = SAI_TUNNEL_ATTR_ENCAP_TTL_MODE;
+    attrs[count++].value.s32 = SAI_TUNNEL_TTL_MODE_UNIFORM_MODEL;
+    attrs[count].id          = SAI_TUNNEL_ATTR_ENCAP_DSCP_MODE;
+    attrs[count++].value.s32 = SAI_TUNNEL_DSCP_MODE_UNIFORM_MODEL;
+    attrs[count].id          = SAI_TUNNEL_ATTR_DECAP_TTL_MODE;
+    attrs[count++].value.s32 = SAI_TUNNEL_TTL_MODE_PIPE_MODEL;
+    attrs[count].id          = SAI_TUNNEL_ATTR_DECAP_DSCP_MODE;
+    attrs[count++].value.s32 = SAI_TUNNEL_DSCP_MODE_PIPE_MODEL;
+
+    BENCH_CHECK(SAI_STATUS_SUCCESS == tunnel_api.create_tunnel(&tunnel_id, 0, count, attrs));
+
+    return tunnel_id;
+}
+
+static sai_object_id_t bench_term_create(_In_ sai_object_id_t vr_id, _In_ uint32_t index, _In_ sai_object_id_t tunnel_id)
+{
+    sai_attribute_t attrs[6];
+    sai_object_id_t entry_id;
+
+    attrs[0].id           = SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_VR_ID;
+    attrs[0].value.oid    = vr_id;
+    attrs[1].id           = SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_TYPE;
+    attrs[1].value.s32    = SAI_TUNNEL_TERM_TABLE_ENTRY_TYPE_P2P;
+    attrs[2].id           = SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_DST_IP;
+    attrs[2].value.ipaddr = bench_ip4(bench_dst_ip(index));
+    attrs[3].id           = SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_SRC_IP;
+    attrs[3].value.ipaddr = bench_ip4(BENCH_REMOTE_IP + index);
+    attrs[4].id           = SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_TUNNEL_TYPE;
+    attrs[4].value.s32    = SAI_TUNNEL_TYPE_IPINIP;
+    attrs[5].id           = SAI_TUNNEL_TERM_TABLE_ENTRY_ATTR_ACTION_TUNNEL_ID;
+    attrs[5].value.oid    = tunnel_id;
+
+    BENCH_CHECK(SAI_STATUS_SUCCESS == tunnel_api.create_tunnel_term_table_entry(&entry_id, 0, 6, attrs));
+
+    return entry_id;
+}
+
+static uint16_t bench_checksum(_In_ const uint8_t *data, _In_ uint32_t length)
+{
+    uint32_t sum = 0, ii;
+
+    for (ii = 0; ii < length; ii += 2) {
+        sum += (data[ii] << 8) | data[ii + 1];
+    }
+    while (sum >> 16) {
+        sum = (sum & 0xffff) + (sum >> 16);
+    }
+
+    return ~sum;
+}
+
+/* IPv4 UDP packet 192.168.0.1 -> 192.168.0.2 */
+static void bench_inner_fill(_Out_ uint8_t *data, _In_ uint32_t length)
+{
+    uint16_t checksum;
+
+    memset(data, 0, length);
+    data[0]  = 0x45;
+    data[2]  = length >> 8;
+    data[3]  = length & 0xff;
+    data[6]  = 0x40;
+    data[8]  = 64;
+    data[9]  = 17;
+    data[12] = 192;
+    data[13] = 168;
+    data[15] = 1;
+    data[16] = 192;
+    data[17] = 168;
+    data[19] = 2;
+    checksum = bench_checksum(data, 20);
+    data[10] = checksum >> 8;
+    data[11] = checksum & 0xff;
+}
+
+static void bench_decap(_In_ sai_object_id_t vr_id, _In_ sai_object_id_t tunnel_id, _In_ uint32_t size)
+{
+    stub_tunnel_verdict_t verdicts[BENCH_BURST];
+    sai_object_id_t       tunnel_ids[BENCH_BURST];
+    sai_ip_address_t      dst_ip;
+    struct timespec       start, end;
+    uint64_t              hits = 0;
+    uint32_t              ii, remote, base, src_ip;
+    long                  iter;
+    double                ns;
+
+    for (ii = 0; ii < size; ii++) {
+        bench_entries[ii] = bench_term_create(vr_id, ii, tunnel_id);
+    }
+
+    /* Encap toward the entry destination, then swap the outer source to the entry remote */
+    for (ii = 0; ii < BENCH_PACKETS; ii++) {
+        remote = (ii * 7919) % size;
+        bench_inner_fill(bench_bufs[ii] + BENCH_HEADROOM, BENCH_LENGTH);
+        bench_packets[ii].data     = bench_bufs[ii] + BENCH_HEADROOM;
+        bench_packets[ii].length   = BENCH_LENGTH;
+        bench_packets[ii].headroom = BENCH_HEADROOM;
+
+        dst_ip = bench_ip4(bench_dst_ip(remote));
+        BENCH_CHECK(SAI_STATUS_SUCCESS == db_tunnel_encap(tunnel_id, &dst_ip, 1, &bench_packets[ii]));
+        src_ip = htonl(BENCH_REMOTE_IP + remote);
+        memcpy(bench_packets[ii].data + 12, &src_ip, sizeof(src_ip));
+        bench_orig[ii] = bench_packets[ii];
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (iter = 0; iter < BENCH_ITERATIONS; iter++) {
+        base = (iter * BENCH_BURST) % BENCH_PACKETS;
+        memcpy(&bench_packets[base], &bench_orig[base], BENCH_BURST * sizeof(bench_packets[0]));
+        db_tunnel_decap(vr_id, BENCH_BURST, &bench_packets[base], verdicts, tunnel_ids);
+        for (ii = 0; ii < BENCH_BURST; ii++) {
+            hits += (STUB_TUNNEL_DECAP == verdicts[ii]);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    ns = (end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec);
+    printf("decap %5u entries: %6.1f ns/pkt, %6.1f Mpps, %lu/%ld decapsulated\n",
+           size, ns / (BENCH_ITERATIONS * BENCH_BURST), BENCH_ITERATIONS * BENCH_BURST / ns * 1e3,
+           (unsigned long)hits, (long)BENCH_ITERATIONS * BENCH_BURST);
+
+    for (ii = 0; ii < size; ii++) {
+        BENCH_CHECK(SAI_STATUS_SUCCESS == tunnel_api.remove_tunnel_term_table_entry(bench_entries[ii]));
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    sai_object_id_t vr_id, tunnel_id;
+    uint32_t        ii;
+
+    vr_id     = bench_object(SAI_OBJECT_TYPE_VIRTUAL_ROUTER, 0);
+    tunnel_id = bench_tunnel_create();
+
+    for (ii = 0; ii < sizeof(bench_sizes) / sizeof(bench_sizes[0]); ii++) {
+        bench_decap(vr_id, tunnel_id, bench_sizes[ii]);
+    }
+
+    BENCH_CHECK(SAI_STATUS_SUCCESS == tunnel_api.remove_tunnel(tunnel_id));
+
+    return 0;
+}
@@ -0,0 +1,1472 @@
+/*
+ *  Copyright (C) 2014. Mellanox Technologies, Ltd. ALL RIGHTS RESERVED.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ */
+
+#include "sai.h"
+#include "stub_sai.h"
+#include "assert.h"
+#include "inttypes.h"
+
+#undef  __MODULE__
+#define __MODULE__ SAI_UDF
+
+static const sai_attribute_entry_t udf_attribs[] = {
+    { SAI_UDF_ATTR_MATCH_ID, true, true, false, true,
+      "UDF match ID", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_UDF_ATTR_GROUP_ID, true, true, false, true,
+      "UDF group ID", SAI_ATTR_VAL_TYPE_OID },
+    { SAI_UDF_ATTR_BASE, false, true, true, true,
+      "UDF base", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_UDF_ATTR_OFFSET, true, true, false, true,
+      "UDF offset", SAI_ATTR_VAL_TYPE_U16 },
+    { SAI_UDF_ATTR_HASH_MASK, false, true, true, true,
+      "UDF hash mask", SAI_ATTR_VAL_TYPE_U8LIST },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+static const sai_attribute_entry_t udf_match_attribs[] = {
+    { SAI_UDF_MATCH_ATTR_L2_TYPE, false, true, false, true,
+      "UDF match L2 type", SAI_ATTR_VAL_TYPE_ACLFIELD },
+    { SAI_UDF_MATCH_ATTR_L3_TYPE, false, true, false, true,
+      "UDF match L3 type", SAI_ATTR_VAL_TYPE_ACLFIELD },
+    { SAI_UDF_MATCH_ATTR_GRE_TYPE, false, true, false, true,
+      "UDF match GRE type", SAI_ATTR_VAL_TYPE_ACLFIELD },
+    { SAI_UDF_MATCH_ATTR_PRIORITY, false, true, false, true,
+      "UDF match priority", SAI_ATTR_VAL_TYPE_U8 },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+static const sai_attribute_entry_t udf_group_attribs[] = {
+    { SAI_UDF_GROUP_ATTR_UDF_LIST, false, false, false, true,
+      "UDF group UDF list", SAI_ATTR_VAL_TYPE_OBJLIST },
+    { SAI_UDF_GROUP_ATTR_TYPE, false, true, false, true,
+      "UDF group type", SAI_ATTR_VAL_TYPE_S32 },
+    { SAI_UDF_GROUP_ATTR_LENGTH, true, true, false, true,
+      "UDF group length", SAI_ATTR_VAL_TYPE_U16 },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+sai_status_t stub_udf_attr_get(_In_ const sai_object_key_t   *key,
+                               _Inout_ sai_attribute_value_t *value,
+                               _In_ uint32_t                  attr_index,
+                               _Inout_ vendor_cache_t        *cache,
+                               void                          *arg);
+sai_status_t stub_udf_attr_set(_In_ const sai_object_key_t      *key,
+                               _In_ const sai_attribute_value_t *value,
+                               void                             *arg);
+sai_status_t stub_udf_match_attr_get(_In_ const sai_object_key_t   *key,
+                                     _Inout_ sai_attribute_value_t *value,
+                                     _In_ uint32_t                  attr_index,
+                                     _Inout_ vendor_cache_t        *cache,
+                                     void                          *arg);
+sai_status_t stub_udf_group_attr_get(_In_ const sai_object_key_t   *key,
+                                     _Inout_ sai_attribute_value_t *value,
+                                     _In_ uint32_t                  attr_index,
+                                     _Inout_ vendor_cache_t        *cache,
+                                     void                          *arg);
+
+static const sai_vendor_attribute_entry_t udf_vendor_attribs[] = {
+    { SAI_UDF_ATTR_MATCH_ID,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_udf_attr_get, (void*)SAI_UDF_ATTR_MATCH_ID,
+      NULL, NULL },
+    { SAI_UDF_ATTR_GROUP_ID,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_udf_attr_get, (void*)SAI_UDF_ATTR_GROUP_ID,
+      NULL, NULL },
+    { SAI_UDF_ATTR_BASE,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_udf_attr_get, (void*)SAI_UDF_ATTR_BASE,
+      stub_udf_attr_set, (void*)SAI_UDF_ATTR_BASE },
+    { SAI_UDF_ATTR_OFFSET,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_udf_attr_get, (void*)SAI_UDF_ATTR_OFFSET,
+      NULL, NULL },
+    { SAI_UDF_ATTR_HASH_MASK,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_udf_attr_get, (void*)SAI_UDF_ATTR_HASH_MASK,
+      stub_udf_attr_set, (void*)SAI_UDF_ATTR_HASH_MASK },
+};
+
+static const sai_vendor_attribute_entry_t udf_match_vendor_attribs[] = {
+    { SAI_UDF_MATCH_ATTR_L2_TYPE,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_udf_match_attr_get, (void*)SAI_UDF_MATCH_ATTR_L2_TYPE,
+      NULL, NULL },
+    { SAI_UDF_MATCH_ATTR_L3_TYPE,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_udf_match_attr_get, (void*)SAI_UDF_MATCH_ATTR_L3_TYPE,
+      NULL, NULL },
+    { SAI_UDF_MATCH_ATTR_GRE_TYPE,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_udf_match_attr_get, (void*)SAI_UDF_MATCH_ATTR_GRE_TYPE,
+      NULL, NULL },
+    { SAI_UDF_MATCH_ATTR_PRIORITY,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_udf_match_attr_get, (void*)SAI_UDF_MATCH_ATTR_PRIORITY,
+      NULL, NULL },
+};
+
+static const sai_vendor_attribute_entry_t udf_group_vendor_attribs[] = {
+    { SAI_UDF_GROUP_ATTR_UDF_LIST,
+      { false, false, false, true },
+      { false, false, false, true },
+      stub_udf_group_attr_get, (void*)SAI_UDF_GROUP_ATTR_UDF_LIST,
+      NULL, NULL },
+    { SAI_UDF_GROUP_ATTR_TYPE,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_udf_group_attr_get, (void*)SAI_UDF_GROUP_ATTR_TYPE,
+      NULL, NULL },
+    { SAI_UDF_GROUP_ATTR_LENGTH,
+      { true, false, false, true },
+      { true, false, false, true },
+      stub_udf_group_attr_get, (void*)SAI_UDF_GROUP_ATTR_LENGTH,
+      NULL, NULL },
+};
+
+/* State DB *************/
+
+/*
+ * The match rules are compiled into a decision table: a priority sorted
+ * array of key and mask pairs over the packet tuple (L2 type, L3 type, GRE
+ * type), and per rule an extraction program for every group, giving the
+ * base, offset and hash mask of the UDF the rule has in the group. A packet
+ * is matched against all rules without branching, the highest priority hit
+ * selecting the row it is extracted with. Rows of rules without a UDF in a
+ * group, and the row of packets matching no rule, are not valid for it.
+ *
+ * Any change builds a new table and swaps the pointer, replaced tables are
+ * freed once no core reads with an epoch from before the swap.
+ */
+#define MAX_UDF_NUMBER        256
+#define MAX_UDF_MATCH_NUMBER  32
+#define MAX_UDF_GROUP_NUMBER  16
+#define UDF_BASES             (SAI_UDF_BASE_L4 + 1)
+#define UDF_HASH_WORDS        (UDF_GROUP_LENGTH_MAX / sizeof(uint64_t))
+#define UDF_HASH_MASK_DEFAULT 0xFF
+/* Base of a header the packet does not have, puts any offset past the packet */
+#define UDF_BASE_NONE         0x7FFFFFFF
+#define UDF_HASH_PRIME        0x9E3779B97F4A7C15ULL
+
+/* Packet tuple the match rules are applied to */
+#define UDF_TUPLE_L3_SHIFT    16
+#define UDF_TUPLE_GRE_SHIFT   24
+
+#define UDF_ETHERTYPE_VLAN    0x8100
+#define UDF_ETHERTYPE_QINQ    0x88A8
+#define UDF_ETHERTYPE_IPV4    0x0800
+#define UDF_ETHERTYPE_IPV6    0x86DD
+#define UDF_IP_PROTOCOL_GRE   47
+#define UDF_ETH_HEADER_SIZE   14
+#define UDF_VLAN_TAG_SIZE     4
+#define UDF_IPV4_HEADER_SIZE  20
+#define UDF_IPV6_HEADER_SIZE  40
+#define UDF_GRE_HEADER_SIZE   4
+#define UDF_IPV4_OFFSET_MASK  0x1FFF
+
+typedef struct _stub_udf_match_t {
+    sai_acl_field_data_t l2_type;
+    sai_acl_field_data_t l3_type;
+    sai_acl_field_data_t gre_type;
+    uint8_t              priority;
+    uint32_t             ref_count;
+    bool                 is_valid;
+} stub_udf_match_t;
+
+typedef struct _stub_udf_group_t {
+    sai_udf_group_type_t type;
+    uint16_t             length;
+    uint32_t             ref_count;
+    bool                 is_valid;
+} stub_udf_group_t;
+
+typedef struct _stub_udf_t {
+    sai_object_id_t match;
+    uint32_t        match_db_id;
+    sai_object_id_t group;
+    uint32_t        group_db_id;
+    sai_udf_base_t  base;
+    uint16_t        offset;
+    uint8_t         hash_mask[UDF_GROUP_LENGTH_MAX];
+    bool            is_valid;
+} stub_udf_t;
+
+typedef struct _stub_udf_extract_t {
+    uint32_t base;
+    uint32_t offset;
+    bool     valid;
+    uint64_t hash_mask[UDF_HASH_WORDS];
+} stub_udf_extract_t;
+
+typedef struct _stub_udf_table_t {
+    uint32_t             match_count;
+    /* Match rules by decreasing priority */
+    uint64_t             keys[MAX_UDF_MATCH_NUMBER];
+    uint64_t             masks[MAX_UDF_MATCH_NUMBER];
+    /* Extraction by rule and group, row match_count for packets matching no rule */
+    stub_udf_extract_t   extract[MAX_UDF_MATCH_NUMBER + 1][MAX_UDF_GROUP_NUMBER];
+    /* Length of each group, 0 when the group does not exist */
+    uint16_t             group_length[MAX_UDF_GROUP_NUMBER];
+    uint32_t             hash_group_count;
+    uint8_t              hash_groups[MAX_UDF_GROUP_NUMBER];
+    stub_epoch_retired_t retired;
+} stub_udf_table_t;
+
+static stub_udf_t          udf_db[MAX_UDF_NUMBER];
+static stub_udf_match_t    udf_match_db[MAX_UDF_MATCH_NUMBER];
+static stub_udf_group_t    udf_group_db[MAX_UDF_GROUP_NUMBER];
+static stub_udf_table_t   *udf_table;
+static stub_epoch_domain_t udf_epoch = STUB_EPOCH_DOMAIN_INIT;
+
+/* Read for any base or offset a UDF can not be extracted from */
+static const uint8_t udf_zero[UDF_GROUP_LENGTH_MAX];
+
+/* No rule and no group, until the first UDF object is created */
+static const stub_udf_table_t udf_empty_table;
+
+static sai_status_t db_get_udf(_In_ uint32_t udf_id, _Out_ stub_udf_t **udf)
+{
+    if ((udf_id >= MAX_UDF_NUMBER) || (!udf_db[udf_id].is_valid)) {
+        STUB_LOG_ERR("Invalid UDF ID %u\n", udf_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *udf = &udf_db[udf_id];
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t db_find_free_udf_index(_Out_ uint32_t *free_index)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < MAX_UDF_NUMBER; ii++) {
+        if (false == udf_db[ii].is_valid) {
+            *free_index = ii;
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+
+    STUB_LOG_ERR("UDF table full\n");
+    return SAI_STATUS_TABLE_FULL;
+}
+
+static sai_status_t db_get_udf_match(_In_ uint32_t match_id, _Out_ stub_udf_match_t **match)
+{
+    if ((match_id >= MAX_UDF_MATCH_NUMBER) || (!udf_match_db[match_id].is_valid)) {
+        STUB_LOG_ERR("Invalid UDF match ID %u\n", match_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *match = &udf_match_db[match_id];
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t db_find_free_udf_match_index(_Out_ uint32_t *free_index)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < MAX_UDF_MATCH_NUMBER; ii++) {
+        if (false == udf_match_db[ii].is_valid) {
+            *free_index = ii;
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+
+    STUB_LOG_ERR("UDF match table full\n");
+    return SAI_STATUS_TABLE_FULL;
+}
+
+static sai_status_t db_get_udf_group(_In_ uint32_t group_id, _Out_ stub_udf_group_t **group)
+{
+    if ((group_id >= MAX_UDF_GROUP_NUMBER) || (!udf_group_db[group_id].is_valid)) {
+        STUB_LOG_ERR("Invalid UDF group ID %u\n", group_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *group = &udf_group_db[group_id];
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t db_find_free_udf_group_index(_Out_ uint32_t *free_index)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < MAX_UDF_GROUP_NUMBER; ii++) {
+        if (false == udf_group_db[ii].is_valid) {
+            *free_index = ii;
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+
+    STUB_LOG_ERR("UDF group table full\n");
+    return SAI_STATUS_TABLE_FULL;
+}
+
+static uint64_t udf_match_key(_In_ const stub_udf_match_t *match)
+{
+    return (match->l2_type.enable ? match->l2_type.data.u16 : 0) |
+           ((uint64_t)(match->l3_type.enable ? match->l3_type.data.u8 : 0) << UDF_TUPLE_L3_SHIFT) |
+           ((uint64_t)(match->gre_type.enable ? match->gre_type.data.u16 : 0) << UDF_TUPLE_GRE_SHIFT);
+}
+
+static uint64_t udf_match_mask(_In_ const stub_udf_match_t *match)
+{
+    return (match->l2_type.enable ? match->l2_type.mask.u16 : 0) |
+           ((uint64_t)(match->l3_type.enable ? match->l3_type.mask.u8 : 0) << UDF_TUPLE_L3_SHIFT) |
+           ((uint64_t)(match->gre_type.enable ? match->gre_type.mask.u16 : 0) << UDF_TUPLE_GRE_SHIFT);
+}
+
+static void udf_table_build(_Out_ stub_udf_table_t *table)
+{
+    uint32_t                rows[MAX_UDF_MATCH_NUMBER];
+    uint32_t                row_of_match[MAX_UDF_MATCH_NUMBER];
+    uint32_t                ii, jj, count = 0;
+    const stub_udf_match_t *match;
+    const stub_udf_t       *udf;
+    stub_udf_extract_t     *extract;
+
+    memset(table, 0, sizeof(*table));
+
+    /* Insertion sort by decreasing priority, earlier created rules first among equals */
+    for (ii = 0; ii < MAX_UDF_MATCH_NUMBER; ii++) {
+        if (!udf_match_db[ii].is_valid) {
+            continue;
+        }
+        for (jj = count; (jj > 0) && (udf_match_db[rows[jj - 1]].priority < udf_match_db[ii].priority); jj--) {
+            rows[jj] = rows[jj - 1];
+        }
+        rows[jj] = ii;
+        count++;
+    }
+
+    table->match_count = count;
+    for (ii = 0; ii < count; ii++) {
+        match                   = &udf_match_db[rows[ii]];
+        table->masks[ii]        = udf_match_mask(match);
+        table->keys[ii]         = udf_match_key(match) & table->masks[ii];
+        row_of_match[rows[ii]] = ii;
+    }
+
+    for (ii = 0; ii < MAX_UDF_GROUP_NUMBER; ii++) {
+        if (!udf_group_db[ii].is_valid) {
+            continue;
+        }
+        table->group_length[ii] = udf_group_db[ii].length;
+        if (SAI_UDF_GROUP_TYPE_HASH == udf_group_db[ii].type) {
+            table->hash_groups[table->hash_group_count++] = ii;
+        }
+    }
+
+    for (ii = 0; ii < MAX_UDF_NUMBER; ii++) {
+        udf = &udf_db[ii];
+        if (!udf->is_valid) {
+            continue;
+        }
+        extract         = &table->extract[row_of_match[udf->match_db_id]][udf->group_db_id];
+        extract->base   = udf->base;
+        extract->offset = udf->offset;
+        extract->valid  = true;
+        memcpy(extract->hash_mask, udf->hash_mask, udf_group_db[udf->group_db_id].length);
+    }
+}
+
+static sai_status_t udf_publish()
+{
+    stub_udf_table_t *table, *old;
+
+    if (NULL == (table = malloc(sizeof(*table)))) {
+        STUB_LOG_ERR("Failed to allocate UDF table\n");
+        return SAI_STATUS_NO_MEMORY;
+    }
+
+    udf_table_build(table);
+
+    old = __atomic_exchange_n(&udf_table, table, __ATOMIC_SEQ_CST);
+    if (NULL != old) {
+        stub_epoch_retire(&udf_epoch, old, &old->retired);
+    }
+
+    stub_epoch_reclaim(&udf_epoch);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Table to read, the caller must end the read with udf_read_end */
+static const stub_udf_table_t* udf_read_begin(_In_ uint32_t core)
+{
+    const stub_udf_table_t *table;
+
+    stub_epoch_read_begin(&udf_epoch, core);
+    table = __atomic_load_n(&udf_table, __ATOMIC_SEQ_CST);
+
+    return (NULL != table) ? table : &udf_empty_table;
+}
+
+static void udf_read_end(_In_ uint32_t core)
+{
+    stub_epoch_read_end(&udf_epoch, core);
+}
+
+static uint32_t udf_get16(_In_ const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 8) | p[1];
+}
+
+/*
+ * Parse the headers the match rules and the bases refer to. A single VLAN tag
+ * is skipped, the L4 base of IPv4 fragments and of packets too short for
+ * their IP header is not set.
+ */
+static uint64_t udf_packet_parse(_In_ const stub_udf_packet_t *packet, _Out_ uint32_t *bases)
+{
+    const uint8_t *data   = packet->data;
+    uint32_t       length = packet->length;
+    uint32_t       l2_type, l3_type = 0, gre_type = 0, l3, l4 = UDF_BASE_NONE;
+
+    bases[SAI_UDF_BASE_L2] = 0;
+    bases[SAI_UDF_BASE_L3] = UDF_BASE_NONE;
+    bases[SAI_UDF_BASE_L4] = UDF_BASE_NONE;
+
+    if (length < UDF_ETH_HEADER_SIZE) {
+        return 0;
+    }
+
+    l3      = UDF_ETH_HEADER_SIZE;
+    l2_type = udf_get16(data + l3 - 2);
+    if (((UDF_ETHERTYPE_VLAN == l2_type) || (UDF_ETHERTYPE_QINQ == l2_type)) &&
+        (length >= UDF_ETH_HEADER_SIZE + UDF_VLAN_TAG_SIZE)) {
+        l3     += UDF_VLAN_TAG_SIZE;
+        l2_type = udf_get16(data + l3 - 2);
+    }
+
+    if ((UDF_ETHERTYPE_IPV4 == l2_type) && (length >= l3 + UDF_IPV4_HEADER_SIZE)) {
+        l3_type = data[l3 + 9];
+        if (0 == (udf_get16(data + l3 + 6) & UDF_IPV4_OFFSET_MASK)) {
+            l4 = l3 + (data[l3] & 0xF) * 4;
+        }
+    } else if ((UDF_ETHERTYPE_IPV6 == l2_type) && (length >= l3 + UDF_IPV6_HEADER_SIZE)) {
+        l3_type = data[l3 + 6];
+        l4      = l3 + UDF_IPV6_HEADER_SIZE;
+    }
+
+    if ((UDF_IP_PROTOCOL_GRE == l3_type) && (l4 + UDF_GRE_HEADER_SIZE <= length)) {
+        gre_type = udf_get16(data + l4 + 2);
+    }
+
+    bases[SAI_UDF_BASE_L3] = l3;
+    bases[SAI_UDF_BASE_L4] = l4;
+
+    return l2_type | ((uint64_t)l3_type << UDF_TUPLE_L3_SHIFT) | ((uint64_t)gre_type << UDF_TUPLE_GRE_SHIFT);
+}
+
+/* Row of the highest priority rule the tuple matches, every rule is tested so the loop does not branch */
+static uint32_t udf_table_match(_In_ const stub_udf_table_t *table, _In_ uint64_t tuple)
+{
+    uint32_t row = table->match_count, ii;
+
+    for (ii = table->match_count; ii > 0; ii--) {
+        row = ((tuple & table->masks[ii - 1]) == table->keys[ii - 1]) ? ii - 1 : row;
+    }
+
+    return row;
+}
+
+/* Bytes to extract, the zero buffer when the UDF does not apply or falls past the packet end */
+static const uint8_t* udf_extract_source(_In_ const stub_udf_extract_t *extract,
+                                         _In_ const stub_udf_packet_t  *packet,
+                                         _In_ const uint32_t           *bases,
+                                         _In_ uint32_t                  length,
+                                         _Out_ bool                    *valid)
+{
+    uint32_t offset = bases[extract->base] + extract->offset;
+    bool     fits   = extract->valid & (offset + length <= packet->length);
+
+    *valid = extract->valid;
+    return fits ? packet->data + offset : udf_zero;
+}
+
+static sai_status_t udf_core_check(_In_ uint32_t core)
+{
+    if (core >= STUB_CORES) {
+        STUB_LOG_ERR("Invalid core %u\n", core);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Extract the bytes of a UDF group from a burst of packets, for the ACL key
+ * builder. The hash mask does not apply, bytes past the packet end read 0.
+ */
+sai_status_t db_udf_group_extract(_In_ uint32_t                 core,
+                                  _In_ sai_object_id_t          udf_group_id,
+                                  _In_ uint32_t                 count,
+                                  _In_ const stub_udf_packet_t *packets,
+                                  _Out_ stub_udf_key_t         *keys)
+{
+    const stub_udf_table_t *table;
+    sai_status_t            status;
+    uint32_t                group_id, length, row, ii;
+    uint32_t                bases[UDF_BASES];
+    uint64_t                tuple;
+
+    if (SAI_STATUS_SUCCESS != (status = udf_core_check(core))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(udf_group_id, SAI_OBJECT_TYPE_UDF_GROUP, &group_id))) {
+        return status;
+    }
+
+    if (group_id >= MAX_UDF_GROUP_NUMBER) {
+        STUB_LOG_ERR("Invalid UDF group ID %u\n", group_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    table = udf_read_begin(core);
+
+    if (0 == (length = table->group_length[group_id])) {
+        udf_read_end(core);
+        STUB_LOG_ERR("Invalid UDF group ID %u\n", group_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    for (ii = 0; ii < count; ii++) {
+        tuple = udf_packet_parse(&packets[ii], bases);
+        row   = udf_table_match(table, tuple);
+        memcpy(keys[ii].data,
+               udf_extract_source(&table->extract[row][group_id], &packets[ii], bases, length, &keys[ii].valid),
+               length);
+    }
+
+    udf_read_end(core);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Fold the masked bytes of the hash UDF groups into the flow hash of a burst
+ * of packets, before the ECMP member is selected. Hashes are left unchanged
+ * when there is no hash UDF group.
+ */
+sai_status_t db_udf_hash(_In_ uint32_t                 core,
+                         _In_ uint32_t                 count,
+                         _In_ const stub_udf_packet_t *packets,
+                         _Inout_ uint32_t             *hashes)
+{
+    const stub_udf_table_t   *table;
+    const stub_udf_extract_t *extract;
+    sai_status_t              status;
+    uint32_t                  group_id, row, ii, jj, kk;
+    uint32_t                  bases[UDF_BASES];
+    uint64_t                  words[UDF_HASH_WORDS], hash;
+    bool                      valid;
+
+    if (SAI_STATUS_SUCCESS != (status = udf_core_check(core))) {
+        return status;
+    }
+
+    table = udf_read_begin(core);
+
+    if (0 == table->hash_group_count) {
+        udf_read_end(core);
+        return SAI_STATUS_SUCCESS;
+    }
+
+    for (ii = 0; ii < count; ii++) {
+        row  = udf_table_match(table, udf_packet_parse(&packets[ii], bases));
+        hash = hashes[ii];
+        for (jj = 0; jj < table->hash_group_count; jj++) {
+            group_id = table->hash_groups[jj];
+            extract  = &table->extract[row][group_id];
+            memset(words, 0, sizeof(words));
+            memcpy(words,
+                   udf_extract_source(extract, &packets[ii], bases, table->group_length[group_id], &valid),
+                   table->group_length[group_id]);
+            for (kk = 0; kk < UDF_HASH_WORDS; kk++) {
+                hash  = (hash ^ (words[kk] & extract->hash_mask[kk])) * UDF_HASH_PRIME;
+                hash ^= hash >> 29;
+            }
+        }
+        hashes[ii] = (uint32_t)(hash ^ (hash >> 32));
+    }
+
+    udf_read_end(core);
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*************************/
+
+static void udf_key_to_str(_In_ sai_object_id_t udf_id, _Out_ char *key_str)
+{
+    uint32_t udfid;
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(udf_id, SAI_OBJECT_TYPE_UDF, &udfid)) {
+        snprintf(key_str, MAX_KEY_STR_LEN, "invalid UDF");
+    } else {
+        snprintf(key_str, MAX_KEY_STR_LEN, "UDF %u", udfid);
+    }
+}
+
+static void udf_match_key_to_str(_In_ sai_object_id_t udf_match_id, _Out_ char *key_str)
+{
+    uint32_t matchid;
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(udf_match_id, SAI_OBJECT_TYPE_UDF_MATCH, &matchid)) {
+        snprintf(key_str, MAX_KEY_STR_LEN, "invalid UDF match");
+    } else {
+        snprintf(key_str, MAX_KEY_STR_LEN, "UDF match %u", matchid);
+    }
+}
+
+static void udf_group_key_to_str(_In_ sai_object_id_t udf_group_id, _Out_ char *key_str)
+{
+    uint32_t groupid;
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(udf_group_id, SAI_OBJECT_TYPE_UDF_GROUP, &groupid)) {
+        snprintf(key_str, MAX_KEY_STR_LEN, "invalid UDF group");
+    } else {
+        snprintf(key_str, MAX_KEY_STR_LEN, "UDF group %u", groupid);
+    }
+}
+
+static bool udf_base_valid(_In_ int32_t base)
+{
+    return (SAI_UDF_BASE_L2 == base) || (SAI_UDF_BASE_L3 == base) || (SAI_UDF_BASE_L4 == base);
+}
+
+/*
+ * Routine Description:
+ *    Create UDF.
+ *
+ * Arguments:
+ *    [out] udf_id - UDF id
+ *    [in] switch_id - switch id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_udf(_Out_ sai_object_id_t      *udf_id,
+                             _In_ sai_object_id_t        switch_id,
+                             _In_ uint32_t               attr_count,
+                             _In_ const sai_attribute_t *attr_list)
+{
+    stub_udf_t                  *udf;
+    stub_udf_match_t            *match;
+    stub_udf_group_t            *group;
+    sai_status_t                 status;
+    const sai_attribute_value_t *match_id, *group_id, *base, *offset, *hash_mask;
+    uint32_t                     match_index, group_index, base_index, offset_index, hash_mask_index;
+    uint32_t                     match_db_id, group_db_id, db_id, ii;
+    char                         list_str[MAX_LIST_VALUE_STR_LEN];
+    char                         key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == udf_id) {
+        STUB_LOG_ERR("NULL UDF id param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = check_attribs_metadata(attr_count, attr_list, udf_attribs, udf_vendor_attribs,
+                                         SAI_OPERATION_CREATE))) {
+        STUB_LOG_ERR("Failed attribs check\n");
+        return status;
+    }
+
+    sai_attr_list_to_str(attr_count, attr_list, udf_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create UDF, %s\n", list_str);
+
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_UDF_ATTR_MATCH_ID, &match_id, &match_index));
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_UDF_ATTR_GROUP_ID, &group_id, &group_index));
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_UDF_ATTR_OFFSET, &offset, &offset_index));
+
+    if ((SAI_STATUS_SUCCESS != stub_object_to_type(match_id->oid, SAI_OBJECT_TYPE_UDF_MATCH, &match_db_id)) ||
+        (SAI_STATUS_SUCCESS != db_get_udf_match(match_db_id, &match))) {
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + match_index;
+    }
+
+    if ((SAI_STATUS_SUCCESS != stub_object_to_type(group_id->oid, SAI_OBJECT_TYPE_UDF_GROUP, &group_db_id)) ||
+        (SAI_STATUS_SUCCESS != db_get_udf_group(group_db_id, &group))) {
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + group_index;
+    }
+
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_UDF_ATTR_BASE, &base, &base_index)) {
+        if (!udf_base_valid(base->s32)) {
+            STUB_LOG_ERR("Invalid UDF base %d\n", base->s32);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + base_index;
+        }
+    } else {
+        base = NULL;
+    }
+
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_UDF_ATTR_HASH_MASK, &hash_mask, &hash_mask_index)) {
+        if (hash_mask->u8list.count != group->length) {
+            STUB_LOG_ERR("UDF hash mask of %u bytes, group length %u\n", hash_mask->u8list.count, group->length);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + hash_mask_index;
+        }
+    } else {
+        hash_mask = NULL;
+    }
+
+    /* A rule extracts a single UDF per group */
+    for (ii = 0; ii < MAX_UDF_NUMBER; ii++) {
+        if (udf_db[ii].is_valid && (udf_db[ii].match_db_id == match_db_id) &&
+            (udf_db[ii].group_db_id == group_db_id)) {
+            STUB_LOG_ERR("UDF match %u already has UDF %u in group %u\n", match_db_id, ii, group_db_id);
+            return SAI_STATUS_ITEM_ALREADY_EXISTS;
+        }
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_find_free_udf_index(&db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = stub_create_object(SAI_OBJECT_TYPE_UDF, db_id, udf_id))) {
+        return status;
+    }
+
+    udf = &udf_db[db_id];
+    memset(udf, 0, sizeof(*udf));
+    udf->match       = match_id->oid;
+    udf->match_db_id = match_db_id;
+    udf->group       = group_id->oid;
+    udf->group_db_id = group_db_id;
+    udf->base        = (NULL != base) ? base->s32 : SAI_UDF_BASE_L2;
+    udf->offset      = offset->u16;
+    if (NULL != hash_mask) {
+        memcpy(udf->hash_mask, hash_mask->u8list.list, group->length);
+    } else {
+        memset(udf->hash_mask, UDF_HASH_MASK_DEFAULT, group->length);
+    }
+    udf->is_valid = true;
+
+    if (SAI_STATUS_SUCCESS != (status = udf_publish())) {
+        udf->is_valid = false;
+        return status;
+    }
+
+    match->ref_count++;
+    group->ref_count++;
+
+    udf_key_to_str(*udf_id, key_str);
+    STUB_LOG_NTC("Created %s\n", key_str);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Remove UDF.
+ *
+ * Arguments:
+ *    [in] udf_id - UDF id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_udf(_In_ sai_object_id_t udf_id)
+{
+    stub_udf_t  *udf;
+    char         key_str[MAX_KEY_STR_LEN];
+    sai_status_t status;
+    uint32_t     db_id;
+
+    STUB_LOG_ENTER();
+
+    udf_key_to_str(udf_id, key_str);
+    STUB_LOG_NTC("Remove %s\n", key_str);
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(udf_id, SAI_OBJECT_TYPE_UDF, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_udf(db_id, &udf))) {
+        return status;
+    }
+
+    udf->is_valid = false;
+    if (SAI_STATUS_SUCCESS != (status = udf_publish())) {
+        udf->is_valid = true;
+        return status;
+    }
+
+    udf_match_db[udf->match_db_id].ref_count--;
+    udf_group_db[udf->group_db_id].ref_count--;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Set UDF attribute.
+ *
+ * Arguments:
+ *    [in] udf_id - UDF id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_udf_attribute(_In_ sai_object_id_t udf_id, _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = udf_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    udf_key_to_str(udf_id, key_str);
+    return sai_set_attribute(&key, key_str, udf_attribs, udf_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get UDF attributes.
+ *
+ * Arguments:
+ *    [in] udf_id - UDF id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_udf_attribute(_In_ sai_object_id_t     udf_id,
+                                    _In_ uint32_t            attr_count,
+                                    _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = udf_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    udf_key_to_str(udf_id, key_str);
+    return sai_get_attributes(&key, key_str, udf_attribs, udf_vendor_attribs, attr_count, attr_list);
+}
+
+/* UDF attributes */
+sai_status_t stub_udf_attr_get(_In_ const sai_object_key_t   *key,
+                               _Inout_ sai_attribute_value_t *value,
+                               _In_ uint32_t                  attr_index,
+                               _Inout_ vendor_cache_t        *cache,
+                               void                          *arg)
+{
+    stub_udf_t  *udf;
+    sai_status_t status;
+    uint32_t     db_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_UDF, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_udf(db_id, &udf))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_UDF_ATTR_MATCH_ID:
+        value->oid = udf->match;
+        break;
+
+    case SAI_UDF_ATTR_GROUP_ID:
+        value->oid = udf->group;
+        break;
+
+    case SAI_UDF_ATTR_BASE:
+        value->s32 = udf->base;
+        break;
+
+    case SAI_UDF_ATTR_OFFSET:
+        value->u16 = udf->offset;
+        break;
+
+    case SAI_UDF_ATTR_HASH_MASK:
+        status = stub_fill_u8list(udf->hash_mask, udf_group_db[udf->group_db_id].length, &value->u8list);
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid UDF attribute %d\n", (int)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return status;
+}
+
+/* Base [sai_udf_base_t], hash mask [sai_u8_list_t] */
+sai_status_t stub_udf_attr_set(_In_ const sai_object_key_t      *key,
+                               _In_ const sai_attribute_value_t *value,
+                               void                             *arg)
+{
+    stub_udf_t    *udf;
+    sai_status_t   status;
+    uint32_t       db_id, length;
+    sai_udf_base_t old_base;
+    uint8_t        old_mask[UDF_GROUP_LENGTH_MAX];
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_UDF, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_udf(db_id, &udf))) {
+        return status;
+    }
+
+    length   = udf_group_db[udf->group_db_id].length;
+    old_base = udf->base;
+    memcpy(old_mask, udf->hash_mask, sizeof(old_mask));
+
+    switch ((int64_t)arg) {
+    case SAI_UDF_ATTR_BASE:
+        if (!udf_base_valid(value->s32)) {
+            STUB_LOG_ERR("Invalid UDF base %d\n", value->s32);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        udf->base = value->s32;
+        break;
+
+    case SAI_UDF_ATTR_HASH_MASK:
+        if (value->u8list.count != length) {
+            STUB_LOG_ERR("UDF hash mask of %u bytes, group length %u\n", value->u8list.count, length);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        memcpy(udf->hash_mask, value->u8list.list, length);
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid UDF attribute %d\n", (int)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = udf_publish())) {
+        udf->base = old_base;
+        memcpy(udf->hash_mask, old_mask, sizeof(old_mask));
+        return status;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Create UDF match.
+ *
+ * Arguments:
+ *    [out] udf_match_id - UDF match id
+ *    [in] switch_id - switch id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_udf_match(_Out_ sai_object_id_t      *udf_match_id,
+                                   _In_ sai_object_id_t        switch_id,
+                                   _In_ uint32_t               attr_count,
+                                   _In_ const sai_attribute_t *attr_list)
+{
+    stub_udf_match_t            *match;
+    sai_status_t                 status;
+    const sai_attribute_value_t *l2_type, *l3_type, *gre_type, *priority;
+    uint32_t                     l2_type_index, l3_type_index, gre_type_index, priority_index, db_id;
+    char                         list_str[MAX_LIST_VALUE_STR_LEN];
+    char                         key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == udf_match_id) {
+        STUB_LOG_ERR("NULL UDF match id param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = check_attribs_metadata(attr_count, attr_list, udf_match_attribs, udf_match_vendor_attribs,
+                                         SAI_OPERATION_CREATE))) {
+        STUB_LOG_ERR("Failed attribs check\n");
+        return status;
+    }
+
+    sai_attr_list_to_str(attr_count, attr_list, udf_match_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create UDF match, %s\n", list_str);
+
+    if (SAI_STATUS_SUCCESS != (status = db_find_free_udf_match_index(&db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = stub_create_object(SAI_OBJECT_TYPE_UDF_MATCH, db_id, udf_match_id))) {
+        return status;
+    }
+
+    match = &udf_match_db[db_id];
+    memset(match, 0, sizeof(*match));
+
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_UDF_MATCH_ATTR_L2_TYPE, &l2_type, &l2_type_index)) {
+        match->l2_type = l2_type->aclfield;
+    }
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_UDF_MATCH_ATTR_L3_TYPE, &l3_type, &l3_type_index)) {
+        match->l3_type = l3_type->aclfield;
+    }
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_UDF_MATCH_ATTR_GRE_TYPE, &gre_type, &gre_type_index)) {
+        match->gre_type = gre_type->aclfield;
+    }
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_UDF_MATCH_ATTR_PRIORITY, &priority, &priority_index)) {
+        match->priority = priority->u8;
+    }
+    match->is_valid = true;
+
+    if (SAI_STATUS_SUCCESS != (status = udf_publish())) {
+        match->is_valid = false;
+        return status;
+    }
+
+    udf_match_key_to_str(*udf_match_id, key_str);
+    STUB_LOG_NTC("Created %s\n", key_str);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Remove UDF match.
+ *
+ * Arguments:
+ *    [in] udf_match_id - UDF match id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_udf_match(_In_ sai_object_id_t udf_match_id)
+{
+    stub_udf_match_t *match;
+    char              key_str[MAX_KEY_STR_LEN];
+    sai_status_t      status;
+    uint32_t          db_id;
+
+    STUB_LOG_ENTER();
+
+    udf_match_key_to_str(udf_match_id, key_str);
+    STUB_LOG_NTC("Remove %s\n", key_str);
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(udf_match_id, SAI_OBJECT_TYPE_UDF_MATCH, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_udf_match(db_id, &match))) {
+        return status;
+    }
+
+    if (match->ref_count > 0) {
+        STUB_LOG_ERR("UDF match %u is used by %u UDFs\n", db_id, match->ref_count);
+        return SAI_STATUS_OBJECT_IN_USE;
+    }
+
+    match->is_valid = false;
+    if (SAI_STATUS_SUCCESS != (status = udf_publish())) {
+        match->is_valid = true;
+        return status;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Set UDF match attribute.
+ *
+ * Arguments:
+ *    [in] udf_match_id - UDF match id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_udf_match_attribute(_In_ sai_object_id_t udf_match_id, _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = udf_match_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    udf_match_key_to_str(udf_match_id, key_str);
+    return sai_set_attribute(&key, key_str, udf_match_attribs, udf_match_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get UDF match attributes.
+ *
+ * Arguments:
+ *    [in] udf_match_id - UDF match id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_udf_match_attribute(_In_ sai_object_id_t     udf_match_id,
+                                          _In_ uint32_t            attr_count,
+                                          _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = udf_match_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    udf_match_key_to_str(udf_match_id, key_str);
+    return sai_get_attributes(&key, key_str, udf_match_attribs, udf_match_vendor_attribs, attr_count, attr_list);
+}
+
+/* UDF match attributes */
+sai_status_t stub_udf_match_attr_get(_In_ const sai_object_key_t   *key,
+                                     _Inout_ sai_attribute_value_t *value,
+                                     _In_ uint32_t                  attr_index,
+                                     _Inout_ vendor_cache_t        *cache,
+                                     void                          *arg)
+{
+    stub_udf_match_t *match;
+    sai_status_t      status;
+    uint32_t          db_id;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_UDF_MATCH, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_udf_match(db_id, &match))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_UDF_MATCH_ATTR_L2_TYPE:
+        value->aclfield = match->l2_type;
+        break;
+
+    case SAI_UDF_MATCH_ATTR_L3_TYPE:
+        value->aclfield = match->l3_type;
+        break;
+
+    case SAI_UDF_MATCH_ATTR_GRE_TYPE:
+        value->aclfield = match->gre_type;
+        break;
+
+    case SAI_UDF_MATCH_ATTR_PRIORITY:
+        value->u8 = match->priority;
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid UDF match attribute %d\n", (int)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Create UDF group.
+ *
+ * Arguments:
+ *    [out] udf_group_id - UDF group id
+ *    [in] switch_id - switch id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_udf_group(_Out_ sai_object_id_t      *udf_group_id,
+                                   _In_ sai_object_id_t        switch_id,
+                                   _In_ uint32_t               attr_count,
+                                   _In_ const sai_attribute_t *attr_list)
+{
+    stub_udf_group_t            *group;
+    sai_status_t                 status;
+    const sai_attribute_value_t *type, *length;
+    uint32_t                     type_index, length_index, db_id;
+    char                         list_str[MAX_LIST_VALUE_STR_LEN];
+    char                         key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == udf_group_id) {
+        STUB_LOG_ERR("NULL UDF group id param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = check_attribs_metadata(attr_count, attr_list, udf_group_attribs, udf_group_vendor_attribs,
+                                         SAI_OPERATION_CREATE))) {
+        STUB_LOG_ERR("Failed attribs check\n");
+        return status;
+    }
+
+    sai_attr_list_to_str(attr_count, attr_list, udf_group_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create UDF group, %s\n", list_str);
+
+    assert(SAI_STATUS_SUCCESS ==
+           find_attrib_in_list(attr_count, attr_list, SAI_UDF_GROUP_ATTR_LENGTH, &length, &length_index));
+
+    if ((0 == length->u16) || (length->u16 > UDF_GROUP_LENGTH_MAX)) {
+        STUB_LOG_ERR("UDF group length %u, max %u\n", length->u16, UDF_GROUP_LENGTH_MAX);
+        return SAI_STATUS_INVALID_ATTR_VALUE_0 + length_index;
+    }
+
+    if (SAI_STATUS_SUCCESS ==
+        find_attrib_in_list(attr_count, attr_list, SAI_UDF_GROUP_ATTR_TYPE, &type, &type_index)) {
+        if ((SAI_UDF_GROUP_TYPE_GENERIC != type->s32) && (SAI_UDF_GROUP_TYPE_HASH != type->s32)) {
+            STUB_LOG_ERR("Invalid UDF group type %d\n", type->s32);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0 + type_index;
+        }
+    } else {
+        type = NULL;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_find_free_udf_group_index(&db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = stub_create_object(SAI_OBJECT_TYPE_UDF_GROUP, db_id, udf_group_id))) {
+        return status;
+    }
+
+    group = &udf_group_db[db_id];
+    memset(group, 0, sizeof(*group));
+    group->type     = (NULL != type) ? type->s32 : SAI_UDF_GROUP_TYPE_GENERIC;
+    group->length   = length->u16;
+    group->is_valid = true;
+
+    if (SAI_STATUS_SUCCESS != (status = udf_publish())) {
+        group->is_valid = false;
+        return status;
+    }
+
+    udf_group_key_to_str(*udf_group_id, key_str);
+    STUB_LOG_NTC("Created %s\n", key_str);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Remove UDF group.
+ *
+ * Arguments:
+ *    [in] udf_group_id - UDF group id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_udf_group(_In_ sai_object_id_t udf_group_id)
+{
+    stub_udf_group_t *group;
+    char              key_str[MAX_KEY_STR_LEN];
+    sai_status_t      status;
+    uint32_t          db_id;
+
+    STUB_LOG_ENTER();
+
+    udf_group_key_to_str(udf_group_id, key_str);
+    STUB_LOG_NTC("Remove %s\n", key_str);
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(udf_group_id, SAI_OBJECT_TYPE_UDF_GROUP, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_udf_group(db_id, &group))) {
+        return status;
+    }
+
+    if (group->ref_count > 0) {
+        STUB_LOG_ERR("UDF group %u has %u UDFs\n", db_id, group->ref_count);
+        return SAI_STATUS_OBJECT_IN_USE;
+    }
+
+    group->is_valid = false;
+    if (SAI_STATUS_SUCCESS != (status = udf_publish())) {
+        group->is_valid = true;
+        return status;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Set UDF group attribute.
+ *
+ * Arguments:
+ *    [in] udf_group_id - UDF group id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_udf_group_attribute(_In_ sai_object_id_t udf_group_id, _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = udf_group_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    udf_group_key_to_str(udf_group_id, key_str);
+    return sai_set_attribute(&key, key_str, udf_group_attribs, udf_group_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get UDF group attributes.
+ *
+ * Arguments:
+ *    [in] udf_group_id - UDF group id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_udf_group_attribute(_In_ sai_object_id_t     udf_group_id,
+                                          _In_ uint32_t            attr_count,
+                                          _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = udf_group_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    udf_group_key_to_str(udf_group_id, key_str);
+    return sai_get_attributes(&key, key_str, udf_group_attribs, udf_group_vendor_attribs, attr_count, attr_list);
+}
+
+/* UDF group attributes */
+sai_status_t stub_udf_group_attr_get(_In_ const sai_object_key_t   *key,
+                                     _Inout_ sai_attribute_value_t *value,
+                                     _In_ uint32_t                  attr_index,
+                                     _Inout_ vendor_cache_t        *cache,
+                                     void                          *arg)
+{
+    stub_udf_group_t *group;
+    sai_status_t      status;
+    sai_object_id_t   udfs[MAX_UDF_NUMBER];
+    uint32_t          db_id, count = 0, ii;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_UDF_GROUP, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_udf_group(db_id, &group))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_UDF_GROUP_ATTR_UDF_LIST:
+        for (ii = 0; ii < MAX_UDF_NUMBER; ii++) {
+            if (udf_db[ii].is_valid && (udf_db[ii].group_db_id == db_id)) {
+                if (SAI_STATUS_SUCCESS != (status = stub_create_object(SAI_OBJECT_TYPE_UDF, ii, &udfs[count++]))) {
+                    return status;
+                }
+            }
+        }
+        status = stub_fill_objlist(udfs, count, &value->objlist);
+        break;
+
+    case SAI_UDF_GROUP_ATTR_TYPE:
+        value->s32 = group->type;
+        break;
+
+    case SAI_UDF_GROUP_ATTR_LENGTH:
+        value->u16 = group->length;
+        break;
+
+    default:
+        STUB_LOG_ERR("Invalid UDF group attribute %d\n", (int)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    STUB_LOG_EXIT();
+    return status;
+}
+
+const sai_udf_api_t udf_api = {
+    stub_create_udf,
+    stub_remove_udf,
+    stub_set_udf_attribute,
+    stub_get_udf_attribute,
+    stub_create_udf_match,
+    stub_remove_udf_match,
+    stub_set_udf_match_attribute,
+    stub_get_udf_match_attribute,
+    stub_create_udf_group,
+    stub_remove_udf_group,
+    stub_set_udf_group_attribute,
+    stub_get_udf_group_attribute
+};
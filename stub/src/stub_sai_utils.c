@@ -177,7 +177,13 @@ sai_status_t check_attribs_metadata(_In_ uint32_t                            att
             ((SAI_ATTR_VAL_TYPE_S32LIST == functionality_attr[index].type) &&
              (NULL == attr_list[ii].value.s32list.list)) ||
             ((SAI_ATTR_VAL_TYPE_VLANLIST == functionality_attr[index].type) &&
-             (NULL == attr_list[ii].value.vlanlist.list))) {
+             (NULL == attr_list[ii].value.vlanlist.list)) ||
+            ((SAI_ATTR_VAL_TYPE_QOSMAP == functionality_attr[index].type) &&
+             (NULL == attr_list[ii].value.qosmap.list)) ||
+            ((SAI_ATTR_VAL_TYPE_TUNNELMAP == functionality_attr[index].type) &&
+             (NULL == attr_list[ii].value.tunnelmap.list)) ||
+            ((SAI_ATTR_VAL_TYPE_U8LIST == functionality_attr[index].type) &&
+             (NULL == attr_list[ii].value.u8list.list))) {
             STUB_LOG_ERR("Null list attribute %s at index %d\n",
                          functionality_attr[index].attrib_name,
                          ii);
@@ -599,6 +605,7 @@ sai_status_t sai_value_to_str(_In_ sai_attribute_value_t      value,
         break;
 
     case SAI_ATTR_VAL_TYPE_OBJLIST:
+    case SAI_ATTR_VAL_TYPE_U8LIST:
     case SAI_ATTR_VAL_TYPE_U32LIST:
     case SAI_ATTR_VAL_TYPE_S32LIST:
     case SAI_ATTR_VAL_TYPE_VLANLIST:
@@ -611,6 +618,7 @@ sai_status_t sai_value_to_str(_In_ sai_attribute_value_t      value,
         }
 
         count = (SAI_ATTR_VAL_TYPE_OBJLIST == type) ? value.objlist.count :
+                (SAI_ATTR_VAL_TYPE_U8LIST == type) ? value.u8list.count :
                 (SAI_ATTR_VAL_TYPE_U32LIST == type) ? value.u32list.count :
                 (SAI_ATTR_VAL_TYPE_S32LIST == type) ? value.s32list.count :
                 (SAI_ATTR_VAL_TYPE_VLANLIST == type) ? value.vlanlist.count :
@@ -623,6 +631,8 @@ sai_status_t sai_value_to_str(_In_ sai_attribute_value_t      value,
         for (ii = 0; ii < count; ii++) {
             if (SAI_ATTR_VAL_TYPE_OBJLIST == type) {
                 pos += snprintf(value_str + pos, max_length - pos, " %" PRIx64, value.objlist.list[ii]);
+            } else if (SAI_ATTR_VAL_TYPE_U8LIST == type) {
+                pos += snprintf(value_str + pos, max_length - pos, " %02x", value.u8list.list[ii]);
             } else if (SAI_ATTR_VAL_TYPE_U32LIST == type) {
                 pos += snprintf(value_str + pos, max_length - pos, " %u", value.u32list.list[ii]);
             } else if (SAI_ATTR_VAL_TYPE_S32LIST == type) {
@@ -639,6 +649,13 @@ sai_status_t sai_value_to_str(_In_ sai_attribute_value_t      value,
         snprintf(value_str + pos, max_length - pos, "]");
         break;
 
+    case SAI_ATTR_VAL_TYPE_QOSMAP:
+        snprintf(value_str, max_length, "%u map entries", value.qosmap.count);
+        break;
+
+    case SAI_ATTR_VAL_TYPE_TUNNELMAP:
+        snprintf(value_str, max_length, "%u map entries", value.tunnelmap.count);
+        break;
 
     case SAI_ATTR_VAL_TYPE_ACLFIELD:
     case SAI_ATTR_VAL_TYPE_ACLACTION:
@@ -779,6 +796,11 @@ sai_status_t stub_fill_objlist(sai_object_id_t *data, uint32_t count, sai_object
     return stub_fill_genericlist(sizeof(sai_object_id_t), (void*)data, count, (void*)list);
 }
 
+sai_status_t stub_fill_u8list(uint8_t *data, uint32_t count, sai_u8_list_t *list)
+{
+    return stub_fill_genericlist(sizeof(uint8_t), (void*)data, count, (void*)list);
+}
+
 sai_status_t stub_fill_u32list(uint32_t *data, uint32_t count, sai_u32_list_t *list)
 {
     return stub_fill_genericlist(sizeof(uint32_t), (void*)data, count, (void*)list);
@@ -794,6 +816,62 @@ sai_status_t stub_fill_vlanlist(sai_vlan_id_t *data, uint32_t count, sai_vlan_li
     return stub_fill_genericlist(sizeof(sai_vlan_id_t), (void*)data, count, (void*)list);
 }
 
+sai_status_t stub_fill_qosmaplist(sai_qos_map_t *data, uint32_t count, sai_qos_map_list_t *list)
+{
+    return stub_fill_genericlist(sizeof(sai_qos_map_t), (void*)data, count, (void*)list);
+}
+
+sai_status_t stub_fill_tunnelmaplist(sai_tunnel_map_t *data, uint32_t count, sai_tunnel_map_list_t *list)
+{
+    return stub_fill_genericlist(sizeof(sai_tunnel_map_t), (void*)data, count, (void*)list);
+}
+
+/* Tables loaded after this are not freed before stub_epoch_read_end */
+void stub_epoch_read_begin(_Inout_ stub_epoch_domain_t *domain, _In_ uint32_t core)
+{
+    __atomic_store_n(&domain->readers[core].epoch, __atomic_load_n(&domain->epoch, __ATOMIC_ACQUIRE),
+                     __ATOMIC_SEQ_CST);
+}
+
+void stub_epoch_read_end(_Inout_ stub_epoch_domain_t *domain, _In_ uint32_t core)
+{
+    __atomic_store_n(&domain->readers[core].epoch, 0, __ATOMIC_RELEASE);
+}
+
+/* Retire a table already swapped out, freed by a later reclaim */
+void stub_epoch_retire(_Inout_ stub_epoch_domain_t *domain, _In_ void *object, _Out_ stub_epoch_retired_t *retired)
+{
+    /* Cores reading with a later epoch already see the new table */
+    retired->object = object;
+    retired->epoch  = __atomic_fetch_add(&domain->epoch, 1, __ATOMIC_SEQ_CST);
+    retired->next   = domain->retired;
+    domain->retired = retired;
+}
+
+/* Free the retired tables no core can still read */
+void stub_epoch_reclaim(_Inout_ stub_epoch_domain_t *domain)
+{
+    stub_epoch_retired_t **prev = &domain->retired, *retired;
+    uint64_t               oldest = UINT64_MAX, epoch;
+    uint32_t               core;
+
+    for (core = 0; core < STUB_CORES; core++) {
+        epoch = __atomic_load_n(&domain->readers[core].epoch, __ATOMIC_SEQ_CST);
+        if ((0 != epoch) && (epoch < oldest)) {
+            oldest = epoch;
+        }
+    }
+
+    while (NULL != (retired = *prev)) {
+        if (retired->epoch < oldest) {
+            *prev = retired->next;
+            free(retired->object);
+        } else {
+            prev = &retired->next;
+        }
+    }
+}
+
 #define LOG_ENTRY_SIZE_MAX 1024
 
 #ifndef _WIN32
@@ -40,7 +40,7 @@ static const sai_attribute_entry_t vlan_attribs[] = {
         "Vlan Maximum number of learned MAC addresses", SAI_ATTR_VAL_TYPE_U32
     },
     {   SAI_VLAN_ATTR_STP_INSTANCE, false, false, true, true,
-        "Vlan associated STP instance", SAI_ATTR_VAL_TYPE_U64
+        "Vlan associated STP instance", SAI_ATTR_VAL_TYPE_OID
     },
     {   END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
         "", SAI_ATTR_VAL_TYPE_UNDETERMINED
@@ -489,7 +489,7 @@ sai_status_t stub_vlan_stp_get(_In_ const sai_object_key_t   *key,
 
     STUB_LOG_ENTER();
 
-    if (SAI_STATUS_SUCCESS != (status = stub_create_object(SAI_OBJECT_TYPE_STP_INSTANCE, 1, &value->oid))) {
+    if (SAI_STATUS_SUCCESS != (status = db_stp_vlan_get(key->vlan_id, &value->oid))) {
         return status;
     }
 
@@ -502,11 +502,10 @@ sai_status_t stub_vlan_stp_get(_In_ const sai_object_key_t   *key,
 sai_status_t stub_vlan_stp_set(_In_ const sai_object_key_t *key, _In_ const sai_attribute_value_t *value, void *arg)
 {
     sai_status_t status;
-    uint32_t     stp_id;
 
     STUB_LOG_ENTER();
 
-    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(value->oid, SAI_OBJECT_TYPE_STP_INSTANCE, &stp_id))) {
+    if (SAI_STATUS_SUCCESS != (status = db_stp_vlan_set(key->vlan_id, value->oid))) {
         return status;
     }
 
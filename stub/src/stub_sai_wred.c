@@ -0,0 +1,717 @@
+/*
+ *  Copyright (C) 2014. Mellanox Technologies, Ltd. ALL RIGHTS RESERVED.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License"); you may
+ *    not use this file except in compliance with the License. You may obtain
+ *    a copy of the License at http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    THIS CODE IS PROVIDED ON AN  *AS IS* BASIS, WITHOUT WARRANTIES OR
+ *    CONDITIONS OF ANY KIND, EITHER EXPRESS OR IMPLIED, INCLUDING WITHOUT
+ *    LIMITATION ANY IMPLIED WARRANTIES OR CONDITIONS OF TITLE, FITNESS
+ *    FOR A PARTICULAR PURPOSE, MERCHANTABLITY OR NON-INFRINGEMENT.
+ *
+ *    See the Apache Version 2.0 License for specific language governing
+ *    permissions and limitations under the License.
+ *
+ */
+
+#include "sai.h"
+#include "stub_sai.h"
+#include "assert.h"
+
+#undef  __MODULE__
+#define __MODULE__ SAI_WRED
+
+static const sai_attribute_entry_t wred_attribs[] = {
+    { SAI_WRED_ATTR_GREEN_ENABLE, false, true, true, true,
+      "WRED green enable", SAI_ATTR_VAL_TYPE_BOOL },
+    { SAI_WRED_ATTR_GREEN_MIN_THRESHOLD, false, true, true, true,
+      "WRED green min threshold", SAI_ATTR_VAL_TYPE_U32 },
+    { SAI_WRED_ATTR_GREEN_MAX_THRESHOLD, false, true, true, true,
+      "WRED green max threshold", SAI_ATTR_VAL_TYPE_U32 },
+    { SAI_WRED_ATTR_GREEN_DROP_PROBABILITY, false, true, true, true,
+      "WRED green drop probability", SAI_ATTR_VAL_TYPE_U32 },
+    { SAI_WRED_ATTR_YELLOW_ENABLE, false, true, true, true,
+      "WRED yellow enable", SAI_ATTR_VAL_TYPE_BOOL },
+    { SAI_WRED_ATTR_YELLOW_MIN_THRESHOLD, false, true, true, true,
+      "WRED yellow min threshold", SAI_ATTR_VAL_TYPE_U32 },
+    { SAI_WRED_ATTR_YELLOW_MAX_THRESHOLD, false, true, true, true,
+      "WRED yellow max threshold", SAI_ATTR_VAL_TYPE_U32 },
+    { SAI_WRED_ATTR_YELLOW_DROP_PROBABILITY, false, true, true, true,
+      "WRED yellow drop probability", SAI_ATTR_VAL_TYPE_U32 },
+    { SAI_WRED_ATTR_RED_ENABLE, false, true, true, true,
+      "WRED red enable", SAI_ATTR_VAL_TYPE_BOOL },
+    { SAI_WRED_ATTR_RED_MIN_THRESHOLD, false, true, true, true,
+      "WRED red min threshold", SAI_ATTR_VAL_TYPE_U32 },
+    { SAI_WRED_ATTR_RED_MAX_THRESHOLD, false, true, true, true,
+      "WRED red max threshold", SAI_ATTR_VAL_TYPE_U32 },
+    { SAI_WRED_ATTR_RED_DROP_PROBABILITY, false, true, true, true,
+      "WRED red drop probability", SAI_ATTR_VAL_TYPE_U32 },
+    { SAI_WRED_ATTR_WEIGHT, false, true, true, true,
+      "WRED weight", SAI_ATTR_VAL_TYPE_U8 },
+    { SAI_WRED_ATTR_ECN_MARK_MODE, false, true, true, true,
+      "WRED ECN mark mode", SAI_ATTR_VAL_TYPE_S32 },
+    { END_FUNCTIONALITY_ATTRIBS_ID, false, false, false, false,
+      "", SAI_ATTR_VAL_TYPE_UNDETERMINED }
+};
+
+sai_status_t stub_wred_attr_get(_In_ const sai_object_key_t   *key,
+                                _Inout_ sai_attribute_value_t *value,
+                                _In_ uint32_t                  attr_index,
+                                _Inout_ vendor_cache_t        *cache,
+                                void                          *arg);
+sai_status_t stub_wred_attr_set(_In_ const sai_object_key_t      *key,
+                                _In_ const sai_attribute_value_t *value,
+                                void                             *arg);
+
+static const sai_vendor_attribute_entry_t wred_vendor_attribs[] = {
+    { SAI_WRED_ATTR_GREEN_ENABLE,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_wred_attr_get, (void*)SAI_WRED_ATTR_GREEN_ENABLE,
+      stub_wred_attr_set, (void*)SAI_WRED_ATTR_GREEN_ENABLE },
+    { SAI_WRED_ATTR_GREEN_MIN_THRESHOLD,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_wred_attr_get, (void*)SAI_WRED_ATTR_GREEN_MIN_THRESHOLD,
+      stub_wred_attr_set, (void*)SAI_WRED_ATTR_GREEN_MIN_THRESHOLD },
+    { SAI_WRED_ATTR_GREEN_MAX_THRESHOLD,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_wred_attr_get, (void*)SAI_WRED_ATTR_GREEN_MAX_THRESHOLD,
+      stub_wred_attr_set, (void*)SAI_WRED_ATTR_GREEN_MAX_THRESHOLD },
+    { SAI_WRED_ATTR_GREEN_DROP_PROBABILITY,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_wred_attr_get, (void*)SAI_WRED_ATTR_GREEN_DROP_PROBABILITY,
+      stub_wred_attr_set, (void*)SAI_WRED_ATTR_GREEN_DROP_PROBABILITY },
+    { SAI_WRED_ATTR_YELLOW_ENABLE,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_wred_attr_get, (void*)SAI_WRED_ATTR_YELLOW_ENABLE,
+      stub_wred_attr_set, (void*)SAI_WRED_ATTR_YELLOW_ENABLE },
+    { SAI_WRED_ATTR_YELLOW_MIN_THRESHOLD,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_wred_attr_get, (void*)SAI_WRED_ATTR_YELLOW_MIN_THRESHOLD,
+      stub_wred_attr_set, (void*)SAI_WRED_ATTR_YELLOW_MIN_THRESHOLD },
+    { SAI_WRED_ATTR_YELLOW_MAX_THRESHOLD,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_wred_attr_get, (void*)SAI_WRED_ATTR_YELLOW_MAX_THRESHOLD,
+      stub_wred_attr_set, (void*)SAI_WRED_ATTR_YELLOW_MAX_THRESHOLD },
+    { SAI_WRED_ATTR_YELLOW_DROP_PROBABILITY,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_wred_attr_get, (void*)SAI_WRED_ATTR_YELLOW_DROP_PROBABILITY,
+      stub_wred_attr_set, (void*)SAI_WRED_ATTR_YELLOW_DROP_PROBABILITY },
+    { SAI_WRED_ATTR_RED_ENABLE,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_wred_attr_get, (void*)SAI_WRED_ATTR_RED_ENABLE,
+      stub_wred_attr_set, (void*)SAI_WRED_ATTR_RED_ENABLE },
+    { SAI_WRED_ATTR_RED_MIN_THRESHOLD,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_wred_attr_get, (void*)SAI_WRED_ATTR_RED_MIN_THRESHOLD,
+      stub_wred_attr_set, (void*)SAI_WRED_ATTR_RED_MIN_THRESHOLD },
+    { SAI_WRED_ATTR_RED_MAX_THRESHOLD,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_wred_attr_get, (void*)SAI_WRED_ATTR_RED_MAX_THRESHOLD,
+      stub_wred_attr_set, (void*)SAI_WRED_ATTR_RED_MAX_THRESHOLD },
+    { SAI_WRED_ATTR_RED_DROP_PROBABILITY,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_wred_attr_get, (void*)SAI_WRED_ATTR_RED_DROP_PROBABILITY,
+      stub_wred_attr_set, (void*)SAI_WRED_ATTR_RED_DROP_PROBABILITY },
+    { SAI_WRED_ATTR_WEIGHT,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_wred_attr_get, (void*)SAI_WRED_ATTR_WEIGHT,
+      stub_wred_attr_set, (void*)SAI_WRED_ATTR_WEIGHT },
+    { SAI_WRED_ATTR_ECN_MARK_MODE,
+      { true, false, true, true },
+      { true, false, true, true },
+      stub_wred_attr_get, (void*)SAI_WRED_ATTR_ECN_MARK_MODE,
+      stub_wred_attr_set, (void*)SAI_WRED_ATTR_ECN_MARK_MODE },
+};
+
+/* State DB *************/
+#define MAX_WRED_NUMBER          64
+#define WRED_COLORS              (SAI_PACKET_COLOR_RED + 1)
+#define WRED_MAX_WEIGHT          15
+#define WRED_MAX_PROBABILITY     100
+#define WRED_DEFAULT_PROBABILITY 100
+
+typedef struct _stub_wred_color_t {
+    bool     enable;
+    uint32_t min_threshold;
+    uint32_t max_threshold;
+    uint32_t drop_probability;
+} stub_wred_color_t;
+
+typedef struct _stub_wred_t {
+    stub_wred_color_t   colors[WRED_COLORS];
+    uint8_t             weight;
+    sai_ecn_mark_mode_t ecn_mark_mode;
+    uint32_t            ref_count;
+    bool                is_valid;
+} stub_wred_t;
+
+static stub_wred_t wred_db[MAX_WRED_NUMBER];
+
+static sai_status_t db_get_wred(_In_ uint32_t wred_id, _Out_ stub_wred_t **wred)
+{
+    if ((wred_id >= MAX_WRED_NUMBER) || (!wred_db[wred_id].is_valid)) {
+        STUB_LOG_ERR("Invalid WRED profile ID %u\n", wred_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    *wred = &wred_db[wred_id];
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t db_find_free_wred_index(_Out_ uint32_t *free_index)
+{
+    uint32_t ii;
+
+    for (ii = 0; ii < MAX_WRED_NUMBER; ii++) {
+        if (false == wred_db[ii].is_valid) {
+            *free_index = ii;
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+
+    STUB_LOG_ERR("WRED profile table full\n");
+    return SAI_STATUS_TABLE_FULL;
+}
+
+static bool wred_ecn_enabled(_In_ sai_ecn_mark_mode_t mode, _In_ sai_packet_color_t color)
+{
+    switch (mode) {
+    case SAI_ECN_MARK_MODE_GREEN:
+        return SAI_PACKET_COLOR_GREEN == color;
+
+    case SAI_ECN_MARK_MODE_YELLOW:
+        return SAI_PACKET_COLOR_YELLOW == color;
+
+    case SAI_ECN_MARK_MODE_RED:
+        return SAI_PACKET_COLOR_RED == color;
+
+    case SAI_ECN_MARK_MODE_GREEN_YELLOW:
+        return SAI_PACKET_COLOR_RED != color;
+
+    case SAI_ECN_MARK_MODE_GREEN_RED:
+        return SAI_PACKET_COLOR_YELLOW != color;
+
+    case SAI_ECN_MARK_MODE_YELLOW_RED:
+        return SAI_PACKET_COLOR_GREEN != color;
+
+    case SAI_ECN_MARK_MODE_ALL:
+        return true;
+
+    case SAI_ECN_MARK_MODE_NONE:
+    default:
+        return false;
+    }
+}
+
+/* Get a WRED profile EWMA weight, used by the queue to average its occupancy */
+sai_status_t db_wred_weight_get(_In_ uint32_t wred_id, _Out_ uint8_t *weight)
+{
+    stub_wred_t *wred;
+    sai_status_t status;
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_wred(wred_id, &wred))) {
+        return status;
+    }
+
+    *weight = wred->weight;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/* Count queues using a WRED profile, so that it isn't removed while in use */
+sai_status_t db_wred_ref(_In_ uint32_t wred_id, _In_ bool add)
+{
+    stub_wred_t *wred;
+    sai_status_t status;
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_wred(wred_id, &wred))) {
+        return status;
+    }
+
+    if (add) {
+        wred->ref_count++;
+    } else {
+        assert(wred->ref_count > 0);
+        wred->ref_count--;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Apply a WRED profile to a packet, given the average queue occupancy in
+ * bytes and a uniformly distributed 32 bit random value.
+ * Below the minimum threshold packets are accepted, above the maximum one
+ * they are always hit, and in between they are hit with a probability
+ * growing linearly up to the configured drop probability. A hit packet is
+ * ECN marked when marking is enabled for its color and it is ECN capable,
+ * otherwise it is dropped when WRED is enabled for its color.
+ * A threshold of 0 stands for the maximum buffer size, never reached.
+ */
+sai_status_t db_wred_check(_In_ uint32_t              wred_id,
+                           _In_ sai_packet_color_t    color,
+                           _In_ uint64_t              average_bytes,
+                           _In_ bool                  ecn_capable,
+                           _In_ uint32_t              random,
+                           _Out_ stub_wred_verdict_t *verdict)
+{
+    const stub_wred_color_t *profile;
+    stub_wred_t             *wred;
+    sai_status_t             status;
+    uint64_t                 min_threshold, max_threshold, probability;
+    bool                     mark;
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_wred(wred_id, &wred))) {
+        return status;
+    }
+
+    *verdict = STUB_WRED_ACCEPT;
+    profile  = &wred->colors[color];
+    mark     = ecn_capable && wred_ecn_enabled(wred->ecn_mark_mode, color);
+
+    if (!profile->enable && !mark) {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    min_threshold = (0 == profile->min_threshold) ? UINT64_MAX : profile->min_threshold;
+    max_threshold = (0 == profile->max_threshold) ? UINT64_MAX : profile->max_threshold;
+
+    if (average_bytes < min_threshold) {
+        return SAI_STATUS_SUCCESS;
+    }
+
+    if (average_bytes < max_threshold) {
+        /* Hit probability in 1/2^32 units */
+        probability = (((average_bytes - min_threshold) << 16) / (max_threshold - min_threshold)) *
+                      profile->drop_probability / WRED_MAX_PROBABILITY;
+        if ((random >> 16) >= probability) {
+            return SAI_STATUS_SUCCESS;
+        }
+    }
+
+    *verdict = mark ? STUB_WRED_MARK : STUB_WRED_DROP;
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*************************/
+
+static void wred_key_to_str(_In_ sai_object_id_t wred_id, _Out_ char *key_str)
+{
+    uint32_t wredid;
+
+    if (SAI_STATUS_SUCCESS != stub_object_to_type(wred_id, SAI_OBJECT_TYPE_WRED, &wredid)) {
+        snprintf(key_str, MAX_KEY_STR_LEN, "invalid WRED profile id");
+    } else {
+        snprintf(key_str, MAX_KEY_STR_LEN, "WRED profile id %u", wredid);
+    }
+}
+
+static sai_status_t wred_attr_apply(_Inout_ stub_wred_t                *wred,
+                                    _In_ sai_attr_id_t                  attr_id,
+                                    _In_ const sai_attribute_value_t   *value)
+{
+    stub_wred_color_t *color;
+
+    switch (attr_id) {
+    case SAI_WRED_ATTR_GREEN_ENABLE:
+    case SAI_WRED_ATTR_GREEN_MIN_THRESHOLD:
+    case SAI_WRED_ATTR_GREEN_MAX_THRESHOLD:
+    case SAI_WRED_ATTR_GREEN_DROP_PROBABILITY:
+        color = &wred->colors[SAI_PACKET_COLOR_GREEN];
+        break;
+
+    case SAI_WRED_ATTR_YELLOW_ENABLE:
+    case SAI_WRED_ATTR_YELLOW_MIN_THRESHOLD:
+    case SAI_WRED_ATTR_YELLOW_MAX_THRESHOLD:
+    case SAI_WRED_ATTR_YELLOW_DROP_PROBABILITY:
+        color = &wred->colors[SAI_PACKET_COLOR_YELLOW];
+        break;
+
+    case SAI_WRED_ATTR_RED_ENABLE:
+    case SAI_WRED_ATTR_RED_MIN_THRESHOLD:
+    case SAI_WRED_ATTR_RED_MAX_THRESHOLD:
+    case SAI_WRED_ATTR_RED_DROP_PROBABILITY:
+        color = &wred->colors[SAI_PACKET_COLOR_RED];
+        break;
+
+    case SAI_WRED_ATTR_WEIGHT:
+        if (value->u8 > WRED_MAX_WEIGHT) {
+            STUB_LOG_ERR("Invalid WRED weight %u\n", value->u8);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        wred->weight = value->u8;
+        return SAI_STATUS_SUCCESS;
+
+    case SAI_WRED_ATTR_ECN_MARK_MODE:
+        if ((value->s32 < SAI_ECN_MARK_MODE_NONE) || (value->s32 > SAI_ECN_MARK_MODE_ALL)) {
+            STUB_LOG_ERR("Invalid WRED ECN mark mode %d\n", value->s32);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        wred->ecn_mark_mode = value->s32;
+        return SAI_STATUS_SUCCESS;
+
+    default:
+        STUB_LOG_ERR("Invalid WRED attribute %d\n", attr_id);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    switch (attr_id) {
+    case SAI_WRED_ATTR_GREEN_ENABLE:
+    case SAI_WRED_ATTR_YELLOW_ENABLE:
+    case SAI_WRED_ATTR_RED_ENABLE:
+        color->enable = value->booldata;
+        break;
+
+    case SAI_WRED_ATTR_GREEN_MIN_THRESHOLD:
+    case SAI_WRED_ATTR_YELLOW_MIN_THRESHOLD:
+    case SAI_WRED_ATTR_RED_MIN_THRESHOLD:
+        color->min_threshold = value->u32;
+        break;
+
+    case SAI_WRED_ATTR_GREEN_MAX_THRESHOLD:
+    case SAI_WRED_ATTR_YELLOW_MAX_THRESHOLD:
+    case SAI_WRED_ATTR_RED_MAX_THRESHOLD:
+        color->max_threshold = value->u32;
+        break;
+
+    default:
+        if (value->u32 > WRED_MAX_PROBABILITY) {
+            STUB_LOG_ERR("Invalid WRED drop probability %u\n", value->u32);
+            return SAI_STATUS_INVALID_ATTR_VALUE_0;
+        }
+        color->drop_probability = value->u32;
+        break;
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+static sai_status_t wred_thresholds_check(_In_ const stub_wred_t *wred)
+{
+    uint32_t color;
+
+    for (color = 0; color < WRED_COLORS; color++) {
+        if ((0 != wred->colors[color].max_threshold) &&
+            (wred->colors[color].min_threshold >= wred->colors[color].max_threshold)) {
+            STUB_LOG_ERR("WRED color %u min threshold %u not below max threshold %u\n", color,
+                         wred->colors[color].min_threshold, wred->colors[color].max_threshold);
+            return SAI_STATUS_INVALID_PARAMETER;
+        }
+    }
+
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Create WRED profile
+ *
+ * Arguments:
+ *    [out] wred_id - WRED profile id
+ *    [in] switch_id - switch id
+ *    [in] attr_count - number of attributes
+ *    [in] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_create_wred_profile(_Out_ sai_object_id_t      *wred_id,
+                                      _In_ sai_object_id_t        switch_id,
+                                      _In_ uint32_t               attr_count,
+                                      _In_ const sai_attribute_t *attr_list)
+{
+    sai_status_t status;
+    stub_wred_t  wred;
+    uint32_t     ii, color, db_id = 0;
+    char         list_str[MAX_LIST_VALUE_STR_LEN];
+    char         key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    if (NULL == wred_id) {
+        STUB_LOG_ERR("NULL WRED profile id param\n");
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    if (SAI_STATUS_SUCCESS !=
+        (status = check_attribs_metadata(attr_count, attr_list, wred_attribs, wred_vendor_attribs,
+                                         SAI_OPERATION_CREATE))) {
+        STUB_LOG_ERR("Failed attribs check\n");
+        return status;
+    }
+
+    sai_attr_list_to_str(attr_count, attr_list, wred_attribs, MAX_LIST_VALUE_STR_LEN, list_str);
+    STUB_LOG_NTC("Create WRED profile, %s\n", list_str);
+
+    memset(&wred, 0, sizeof(wred));
+    for (color = 0; color < WRED_COLORS; color++) {
+        wred.colors[color].drop_probability = WRED_DEFAULT_PROBABILITY;
+    }
+    wred.ecn_mark_mode = SAI_ECN_MARK_MODE_NONE;
+
+    for (ii = 0; ii < attr_count; ii++) {
+        if (SAI_STATUS_SUCCESS != (status = wred_attr_apply(&wred, attr_list[ii].id, &attr_list[ii].value))) {
+            return (SAI_STATUS_INVALID_ATTR_VALUE_0 == status) ? SAI_STATUS_INVALID_ATTR_VALUE_0 + ii : status;
+        }
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = wred_thresholds_check(&wred))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_find_free_wred_index(&db_id))) {
+        return status;
+    }
+
+    wred.is_valid   = true;
+    wred_db[db_id]  = wred;
+
+    if (SAI_STATUS_SUCCESS != (status = stub_create_object(SAI_OBJECT_TYPE_WRED, db_id, wred_id))) {
+        wred_db[db_id].is_valid = false;
+        return status;
+    }
+    wred_key_to_str(*wred_id, key_str);
+    STUB_LOG_NTC("Created WRED profile %s\n", key_str);
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Remove WRED profile
+ *
+ * Arguments:
+ *    [in] wred_id - WRED profile id
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_remove_wred_profile(_In_ sai_object_id_t wred_id)
+{
+    char         key_str[MAX_KEY_STR_LEN];
+    sai_status_t status;
+    uint32_t     db_id;
+    stub_wred_t *wred;
+
+    STUB_LOG_ENTER();
+
+    wred_key_to_str(wred_id, key_str);
+    STUB_LOG_NTC("Remove WRED profile %s\n", key_str);
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(wred_id, SAI_OBJECT_TYPE_WRED, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_wred(db_id, &wred))) {
+        return status;
+    }
+
+    if (0 != wred->ref_count) {
+        STUB_LOG_ERR("WRED profile ID %u is used by %u queues\n", db_id, wred->ref_count);
+        return SAI_STATUS_OBJECT_IN_USE;
+    }
+
+    wred->is_valid = false;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/*
+ * Routine Description:
+ *    Set WRED profile attribute
+ *
+ * Arguments:
+ *    [in] wred_id - WRED profile id
+ *    [in] attr - attribute
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_set_wred_attribute(_In_ sai_object_id_t wred_id, _In_ const sai_attribute_t *attr)
+{
+    const sai_object_key_t key = { .object_id = wred_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    wred_key_to_str(wred_id, key_str);
+    return sai_set_attribute(&key, key_str, wred_attribs, wred_vendor_attribs, attr);
+}
+
+/*
+ * Routine Description:
+ *    Get WRED profile attribute
+ *
+ * Arguments:
+ *    [in] wred_id - WRED profile id
+ *    [in] attr_count - number of attributes
+ *    [inout] attr_list - array of attributes
+ *
+ * Return Values:
+ *    SAI_STATUS_SUCCESS on success
+ *    Failure status code on error
+ */
+sai_status_t stub_get_wred_attribute(_In_ sai_object_id_t     wred_id,
+                                     _In_ uint32_t            attr_count,
+                                     _Inout_ sai_attribute_t *attr_list)
+{
+    const sai_object_key_t key = { .object_id = wred_id };
+    char                   key_str[MAX_KEY_STR_LEN];
+
+    STUB_LOG_ENTER();
+
+    wred_key_to_str(wred_id, key_str);
+    return sai_get_attributes(&key, key_str, wred_attribs, wred_vendor_attribs, attr_count, attr_list);
+}
+
+/* WRED profile attributes [bool enable, uint32_t thresholds and probability per color,
+ * uint8_t weight, sai_ecn_mark_mode_t] */
+sai_status_t stub_wred_attr_get(_In_ const sai_object_key_t   *key,
+                                _Inout_ sai_attribute_value_t *value,
+                                _In_ uint32_t                  attr_index,
+                                _Inout_ vendor_cache_t        *cache,
+                                void                          *arg)
+{
+    sai_status_t             status;
+    uint32_t                 db_id;
+    stub_wred_t             *wred;
+    const stub_wred_color_t *color;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_WRED, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_wred(db_id, &wred))) {
+        return status;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_WRED_ATTR_GREEN_ENABLE:
+    case SAI_WRED_ATTR_GREEN_MIN_THRESHOLD:
+    case SAI_WRED_ATTR_GREEN_MAX_THRESHOLD:
+    case SAI_WRED_ATTR_GREEN_DROP_PROBABILITY:
+        color = &wred->colors[SAI_PACKET_COLOR_GREEN];
+        break;
+
+    case SAI_WRED_ATTR_YELLOW_ENABLE:
+    case SAI_WRED_ATTR_YELLOW_MIN_THRESHOLD:
+    case SAI_WRED_ATTR_YELLOW_MAX_THRESHOLD:
+    case SAI_WRED_ATTR_YELLOW_DROP_PROBABILITY:
+        color = &wred->colors[SAI_PACKET_COLOR_YELLOW];
+        break;
+
+    case SAI_WRED_ATTR_RED_ENABLE:
+    case SAI_WRED_ATTR_RED_MIN_THRESHOLD:
+    case SAI_WRED_ATTR_RED_MAX_THRESHOLD:
+    case SAI_WRED_ATTR_RED_DROP_PROBABILITY:
+        color = &wred->colors[SAI_PACKET_COLOR_RED];
+        break;
+
+    case SAI_WRED_ATTR_WEIGHT:
+        value->u8 = wred->weight;
+        STUB_LOG_EXIT();
+        return SAI_STATUS_SUCCESS;
+
+    case SAI_WRED_ATTR_ECN_MARK_MODE:
+        value->s32 = wred->ecn_mark_mode;
+        STUB_LOG_EXIT();
+        return SAI_STATUS_SUCCESS;
+
+    default:
+        STUB_LOG_ERR("Invalid WRED attribute %d\n", (int32_t)(int64_t)arg);
+        return SAI_STATUS_INVALID_PARAMETER;
+    }
+
+    switch ((int64_t)arg) {
+    case SAI_WRED_ATTR_GREEN_ENABLE:
+    case SAI_WRED_ATTR_YELLOW_ENABLE:
+    case SAI_WRED_ATTR_RED_ENABLE:
+        value->booldata = color->enable;
+        break;
+
+    case SAI_WRED_ATTR_GREEN_MIN_THRESHOLD:
+    case SAI_WRED_ATTR_YELLOW_MIN_THRESHOLD:
+    case SAI_WRED_ATTR_RED_MIN_THRESHOLD:
+        value->u32 = color->min_threshold;
+        break;
+
+    case SAI_WRED_ATTR_GREEN_MAX_THRESHOLD:
+    case SAI_WRED_ATTR_YELLOW_MAX_THRESHOLD:
+    case SAI_WRED_ATTR_RED_MAX_THRESHOLD:
+        value->u32 = color->max_threshold;
+        break;
+
+    default:
+        value->u32 = color->drop_probability;
+        break;
+    }
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+/* WRED profile attributes [bool enable, uint32_t thresholds and probability per color,
+ * uint8_t weight, sai_ecn_mark_mode_t] */
+sai_status_t stub_wred_attr_set(_In_ const sai_object_key_t      *key,
+                                _In_ const sai_attribute_value_t *value,
+                                void                             *arg)
+{
+    sai_status_t status;
+    uint32_t     db_id;
+    stub_wred_t *wred;
+    stub_wred_t  updated;
+
+    STUB_LOG_ENTER();
+
+    if (SAI_STATUS_SUCCESS != (status = stub_object_to_type(key->object_id, SAI_OBJECT_TYPE_WRED, &db_id))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = db_get_wred(db_id, &wred))) {
+        return status;
+    }
+
+    updated = *wred;
+    if (SAI_STATUS_SUCCESS != (status = wred_attr_apply(&updated, (sai_attr_id_t)(int64_t)arg, value))) {
+        return status;
+    }
+
+    if (SAI_STATUS_SUCCESS != (status = wred_thresholds_check(&updated))) {
+        return status;
+    }
+
+    *wred = updated;
+
+    STUB_LOG_EXIT();
+    return SAI_STATUS_SUCCESS;
+}
+
+const sai_wred_api_t wred_api = {
+    stub_create_wred_profile,
+    stub_remove_wred_profile,
+    stub_set_wred_attribute,
+    stub_get_wred_attribute
+};
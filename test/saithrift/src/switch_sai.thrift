@@ -198,6 +198,10 @@ service switch_sai_rpc {
                              1: sai_thrift_object_id_t port_id,
                              2: list<sai_thrift_port_stat_counter_t> counter_ids,
                              3: i32 number_of_counters);
+    list<i64> sai_thrift_get_port_stats_bulk(
+                             1: list<sai_thrift_object_id_t> port_ids,
+                             2: list<sai_thrift_port_stat_counter_t> counter_ids,
+                             3: i32 number_of_counters);
     sai_thrift_status_t sai_thrift_clear_port_all_stats(1: sai_thrift_object_id_t port_id)
 
     //fdb API
@@ -306,6 +310,10 @@ service switch_sai_rpc {
                              1: sai_thrift_object_id_t queue_id,
                              2: list<sai_thrift_queue_stat_counter_t> counter_ids,
                              3: i32 number_of_counters);
+    list<i64> sai_thrift_get_queue_stats_bulk(
+                             1: list<sai_thrift_object_id_t> queue_ids,
+                             2: list<sai_thrift_queue_stat_counter_t> counter_ids,
+                             3: i32 number_of_counters);
     sai_thrift_status_t sai_thrift_clear_queue_stats(
                              1: sai_thrift_object_id_t queue_id,
                              2: list<sai_thrift_queue_stat_counter_t> counter_ids,
@@ -322,6 +330,10 @@ service switch_sai_rpc {
                          1: sai_thrift_object_id_t pg_id,
                          2: list<sai_thrift_pg_stat_counter_t> counter_ids,
                          3: i32 number_of_counters);
+    list<i64> sai_thrift_get_pg_stats_bulk(
+                         1: list<sai_thrift_object_id_t> pg_ids,
+                         2: list<sai_thrift_pg_stat_counter_t> counter_ids,
+                         3: i32 number_of_counters);
 
     // WRED API
     sai_thrift_object_id_t sai_thrift_create_wred_profile(1: list<sai_thrift_attribute_t> thrift_attr_list);
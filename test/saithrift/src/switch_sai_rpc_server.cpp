@@ -2034,6 +2034,52 @@ sai_thrift_object_id_t sai_thrift_get_cpu_port_id() {
       return status;
   }
 
+  void sai_thrift_get_port_stats_bulk(
+          std::vector<int64_t> & thrift_counters,
+          const std::vector<sai_thrift_object_id_t> & thrift_port_ids,
+          const std::vector<sai_thrift_port_stat_counter_t> & thrift_counter_ids,
+          const int32_t number_of_counters) {
+      printf("sai_thrift_get_port_stats_bulk\n");
+      sai_status_t status = SAI_STATUS_SUCCESS;
+      sai_port_api_t *port_api;
+      status = sai_api_query(SAI_API_PORT, (void **) &port_api);
+      if (status != SAI_STATUS_SUCCESS) {
+          return;
+      }
+      if ((number_of_counters < 0) || ((uint32_t) number_of_counters > thrift_counter_ids.size())) {
+          return;
+      }
+      sai_object_id_t *port_ids = (sai_object_id_t *) malloc(sizeof(sai_object_id_t) * thrift_port_ids.size());
+      std::vector<sai_thrift_object_id_t>::const_iterator id_it = thrift_port_ids.begin();
+      for(uint32_t i = 0; i < thrift_port_ids.size(); i++, id_it++) {
+          port_ids[i] = (sai_object_id_t) *id_it;
+      }
+      sai_port_stat_counter_t *counter_ids = (sai_port_stat_counter_t *) malloc(sizeof(sai_port_stat_counter_t) * thrift_counter_ids.size());
+      std::vector<int32_t>::const_iterator it = thrift_counter_ids.begin();
+      uint64_t *counters = (uint64_t *) malloc(sizeof(uint64_t) * thrift_port_ids.size() * number_of_counters);
+      for(uint32_t i = 0; i < thrift_counter_ids.size(); i++, it++) {
+          counter_ids[i] = (sai_port_stat_counter_t) *it;
+      }
+
+      /* counters come back as one row of number_of_counters values per object */
+      status = port_api->get_port_stats_bulk(
+                             (uint32_t) thrift_port_ids.size(),
+                             port_ids,
+                             counter_ids,
+                             number_of_counters,
+                             counters);
+
+      if (status == SAI_STATUS_SUCCESS) {
+          for (uint32_t i = 0; i < thrift_port_ids.size() * number_of_counters; i++) {
+              thrift_counters.push_back(counters[i]);
+          }
+      }
+      free(port_ids);
+      free(counter_ids);
+      free(counters);
+      return;
+  }
+
   void sai_thrift_get_port_attribute(sai_thrift_attribute_list_t& thrift_attr_list, const sai_thrift_object_id_t port_id) {
       printf("sai_thrift_get_port_attribute\n");
       sai_status_t status = SAI_STATUS_SUCCESS;
@@ -2158,6 +2204,52 @@ sai_thrift_object_id_t sai_thrift_get_cpu_port_id() {
       return;
    }
 
+  void sai_thrift_get_queue_stats_bulk(
+          std::vector<int64_t> & thrift_counters,
+          const std::vector<sai_thrift_object_id_t> & thrift_queue_ids,
+          const std::vector<sai_thrift_queue_stat_counter_t> & thrift_counter_ids,
+          const int32_t number_of_counters) {
+      printf("sai_thrift_get_queue_stats_bulk\n");
+      sai_status_t status = SAI_STATUS_SUCCESS;
+      sai_queue_api_t *queue_api;
+      status = sai_api_query(SAI_API_QUEUE, (void **) &queue_api);
+      if (status != SAI_STATUS_SUCCESS) {
+          return;
+      }
+      if ((number_of_counters < 0) || ((uint32_t) number_of_counters > thrift_counter_ids.size())) {
+          return;
+      }
+      sai_object_id_t *queue_ids = (sai_object_id_t *) malloc(sizeof(sai_object_id_t) * thrift_queue_ids.size());
+      std::vector<sai_thrift_object_id_t>::const_iterator id_it = thrift_queue_ids.begin();
+      for(uint32_t i = 0; i < thrift_queue_ids.size(); i++, id_it++) {
+          queue_ids[i] = (sai_object_id_t) *id_it;
+      }
+      sai_queue_stat_counter_t *counter_ids = (sai_queue_stat_counter_t *) malloc(sizeof(sai_queue_stat_counter_t) * thrift_counter_ids.size());
+      std::vector<int32_t>::const_iterator it = thrift_counter_ids.begin();
+      uint64_t *counters = (uint64_t *) malloc(sizeof(uint64_t) * thrift_queue_ids.size() * number_of_counters);
+      for(uint32_t i = 0; i < thrift_counter_ids.size(); i++, it++) {
+          counter_ids[i] = (sai_queue_stat_counter_t) *it;
+      }
+
+      /* counters come back as one row of number_of_counters values per object */
+      status = queue_api->get_queue_stats_bulk(
+                             (uint32_t) thrift_queue_ids.size(),
+                             queue_ids,
+                             counter_ids,
+                             number_of_counters,
+                             counters);
+
+      if (status == SAI_STATUS_SUCCESS) {
+          for (uint32_t i = 0; i < thrift_queue_ids.size() * number_of_counters; i++) {
+              thrift_counters.push_back(counters[i]);
+          }
+      }
+      free(queue_ids);
+      free(counter_ids);
+      free(counters);
+      return;
+   }
+
   sai_thrift_status_t sai_thrift_set_queue_attribute(const sai_thrift_object_id_t queue_id, const sai_thrift_attribute_t& thrift_attr) {
       printf("sai_thrift_set_queue_attribute\n");
       sai_status_t status = SAI_STATUS_SUCCESS;
@@ -2332,6 +2424,52 @@ sai_thrift_object_id_t sai_thrift_get_cpu_port_id() {
       return;
    }
 
+  void sai_thrift_get_pg_stats_bulk(
+          std::vector<int64_t> & thrift_counters,
+          const std::vector<sai_thrift_object_id_t> & thrift_pg_ids,
+          const std::vector<sai_thrift_pg_stat_counter_t> & thrift_counter_ids,
+          const int32_t number_of_counters) {
+      printf("sai_thrift_get_pg_stats_bulk\n");
+      sai_status_t status = SAI_STATUS_SUCCESS;
+      sai_buffer_api_t *buffer_api;
+      status = sai_api_query(SAI_API_BUFFERS, (void **) &buffer_api);
+      if (status != SAI_STATUS_SUCCESS) {
+          return;
+      }
+      if ((number_of_counters < 0) || ((uint32_t) number_of_counters > thrift_counter_ids.size())) {
+          return;
+      }
+      sai_object_id_t *pg_ids = (sai_object_id_t *) malloc(sizeof(sai_object_id_t) * thrift_pg_ids.size());
+      std::vector<sai_thrift_object_id_t>::const_iterator id_it = thrift_pg_ids.begin();
+      for(uint32_t i = 0; i < thrift_pg_ids.size(); i++, id_it++) {
+          pg_ids[i] = (sai_object_id_t) *id_it;
+      }
+      sai_ingress_priority_group_stat_counter_t *counter_ids = (sai_ingress_priority_group_stat_counter_t *) malloc(sizeof(sai_ingress_priority_group_stat_counter_t) * thrift_counter_ids.size());
+      std::vector<int32_t>::const_iterator it = thrift_counter_ids.begin();
+      uint64_t *counters = (uint64_t *) malloc(sizeof(uint64_t) * thrift_pg_ids.size() * number_of_counters);
+      for(uint32_t i = 0; i < thrift_counter_ids.size(); i++, it++) {
+          counter_ids[i] = (sai_ingress_priority_group_stat_counter_t) *it;
+      }
+
+      /* counters come back as one row of number_of_counters values per object */
+      status = buffer_api->get_ingress_priority_group_stats_bulk(
+                             (uint32_t) thrift_pg_ids.size(),
+                             pg_ids,
+                             counter_ids,
+                             number_of_counters,
+                             counters);
+
+      if (status == SAI_STATUS_SUCCESS) {
+          for (uint32_t i = 0; i < thrift_pg_ids.size() * number_of_counters; i++) {
+              thrift_counters.push_back(counters[i]);
+          }
+      }
+      free(pg_ids);
+      free(counter_ids);
+      free(counters);
+      return;
+   }
+
   sai_thrift_object_id_t sai_thrift_create_wred_profile(const std::vector<sai_thrift_attribute_t> & thrift_attr_list) {
       printf("sai_thrift_create_wred_profile\n");
       sai_status_t status = SAI_STATUS_SUCCESS;